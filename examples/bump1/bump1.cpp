@@ -79,9 +79,9 @@ public:
         m_light->setPosition(glm::vec3(m_lightRadius, m_lightHeight, 0.0f));
         lightMgr->apply();
 
-        // Shared diffuse texture.
-        auto diffuseTex = Texture::create();
-        diffuseTex->load("assets/brick.png");
+        // Shared diffuse texture, decoded in the background by the texture cache.
+        // Both spheres show a placeholder until it has been uploaded.
+        auto diffuseTex = TextureCache::instance()->load("assets/brick.png");
 
         // ---- Left sphere: standard Phong material ----------------------------
         auto plainMat = Material::create();
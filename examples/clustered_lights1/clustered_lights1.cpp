@@ -0,0 +1,215 @@
+/**
+ * @file clustered_lights1.cpp
+ * @brief Clustered forward lighting benchmark
+ * @ingroup lighting_examples
+ *
+ * Fills a ground plane covered with spheres with a large number of small
+ * point and spot lights (1000 by default, pass 4000 as the first argument for
+ * the heavy scene) and renders them through the clustered lighting path of
+ * LightManager. The lights orbit slowly so that cluster assignment runs on
+ * changing input every frame.
+ *
+ * Average frame time and cluster assignment time are logged every 120 frames
+ * and shown in the UI. The clustered path requires OpenGL 4.3; to reproduce
+ * numbers without a discrete GPU, run on Mesa llvmpipe:
+ *
+ *     LIBGL_ALWAYS_SOFTWARE=1 ./clustered_lights1 4000
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <imgui.h>
+
+#include <ivf/gl.h>
+#include <ivf/nodes.h>
+#include <ivfui/ui.h>
+
+using namespace ivf;
+using namespace ivfui;
+
+class ClusteredLightsWindow : public GLFWSceneWindow {
+private:
+    int m_lightCount{1000};
+    std::vector<PointLightPtr> m_pointLights;
+    std::vector<SpotLightPtr> m_spotLights;
+    std::vector<glm::vec3> m_basePositions;
+
+    double m_time{0.0};
+    double m_frameTimeSum{0.0};
+    double m_assignTimeSum{0.0};
+    int m_frames{0};
+    double m_avgFrameTime{0.0};
+    double m_avgAssignTime{0.0};
+    bool m_animate{true};
+
+public:
+    ClusteredLightsWindow(int width, int height, std::string title, int lightCount)
+        : GLFWSceneWindow(width, height, title), m_lightCount(lightCount)
+    {}
+
+    static std::shared_ptr<ClusteredLightsWindow> create(int width, int height, std::string title, int lightCount)
+    {
+        return std::make_shared<ClusteredLightsWindow>(width, height, title, lightCount);
+    }
+
+    int onSetup() override
+    {
+        auto lightMgr = LightManager::instance();
+        lightMgr->clearLights();
+        lightMgr->setUseShadows(false);
+
+        // A dim directional light so the scene is visible outside the light volumes
+
+        auto dirLight = lightMgr->addDirectionalLight();
+        dirLight->setDiffuseColor(glm::vec3(0.1, 0.1, 0.1));
+        dirLight->setDirection(glm::vec3(-1.0, -1.0, -1.0));
+
+        // Lights are spread over a square area, one spot light for every seven point lights
+
+        float extent = std::sqrt(float(m_lightCount)) * 1.5f;
+
+        for (auto i = 0; i < m_lightCount; i++)
+        {
+            glm::vec3 pos(random(-extent, extent), random(0.3, 1.5), random(-extent, extent));
+            glm::vec3 color(random(0.2, 1.0), random(0.2, 1.0), random(0.2, 1.0));
+
+            m_basePositions.push_back(pos);
+
+            if (i % 8 == 7)
+            {
+                auto spotLight = lightMgr->addSpotLight();
+                spotLight->setDiffuseColor(color);
+                spotLight->setSpecularColor(color);
+                spotLight->setAttenuation(1.0, 0.7, 1.8);
+                spotLight->setDirection(glm::vec3(0.0, -1.0, 0.0));
+                spotLight->setPosition(pos);
+                spotLight->setCutoff(20.0f, 30.0f);
+                m_spotLights.push_back(spotLight);
+            }
+            else
+            {
+                auto pointLight = lightMgr->addPointLight();
+                pointLight->setDiffuseColor(color);
+                pointLight->setSpecularColor(color);
+                pointLight->setAttenuation(1.0, 0.7, 1.8);
+                pointLight->setPosition(pos);
+                m_pointLights.push_back(pointLight);
+            }
+        }
+
+        lightMgr->setUseClusteredLighting(true);
+        lightMgr->apply();
+
+        // Ground plane with a grid of instanced spheres
+
+        auto plane = Plane::create(extent * 2.0, extent * 2.0, 64, 64);
+        auto planeMaterial = Material::create();
+        planeMaterial->setDiffuseColor(glm::vec4(0.6, 0.6, 0.6, 1.0));
+        plane->setMaterial(planeMaterial);
+        this->add(plane);
+
+        auto sphere = Sphere::create(0.3);
+        auto sphereMaterial = Material::create();
+        sphereMaterial->setDiffuseColor(glm::vec4(0.8, 0.8, 0.8, 1.0));
+        sphereMaterial->setShininess(40.0);
+
+        for (auto x = -extent; x <= extent; x += 2.0f)
+            for (auto z = -extent; z <= extent; z += 2.0f)
+            {
+                auto instSphere = InstanceNode::create();
+                instSphere->setNode(sphere);
+                instSphere->setPos(glm::vec3(x, 0.3, z));
+                instSphere->setMaterial(sphereMaterial);
+                this->add(instSphere);
+            }
+
+        cameraManipulator()->setCameraPosition(glm::vec3(0.0, extent * 0.5, extent * 1.2));
+
+        return 0;
+    }
+
+    void onUpdate() override
+    {
+        if (m_animate)
+        {
+            m_time += frameTime();
+
+            // Move the lights on small circles around their base positions
+
+            size_t pointIdx = 0;
+            size_t spotIdx = 0;
+
+            for (auto i = 0; i < m_lightCount; i++)
+            {
+                auto phase = float(m_time) + float(i) * 0.37f;
+                auto pos = m_basePositions[i] + glm::vec3(std::cos(phase), 0.0f, std::sin(phase)) * 0.5f;
+
+                if (i % 8 == 7)
+                    m_spotLights[spotIdx++]->setPosition(pos);
+                else
+                    m_pointLights[pointIdx++]->setPosition(pos);
+            }
+        }
+
+        // Statistics
+
+        m_frameTimeSum += frameTime() * 1000.0;
+        m_assignTimeSum += LightManager::instance()->lightClusters()->assignTime();
+        m_frames++;
+
+        if (m_frames == 120)
+        {
+            m_avgFrameTime = m_frameTimeSum / m_frames;
+            m_avgAssignTime = m_assignTimeSum / m_frames;
+
+            auto clusters = LightManager::instance()->lightClusters();
+
+            logInfofc("ClusteredLights", "{} lights: frame {:.2f} ms, cluster assign {:.3f} ms, max {} lights/cluster",
+                      m_lightCount, m_avgFrameTime, m_avgAssignTime, clusters->maxClusterLights());
+
+            m_frameTimeSum = 0.0;
+            m_assignTimeSum = 0.0;
+            m_frames = 0;
+        }
+    }
+
+    void onDrawUi() override
+    {
+        auto clusters = LightManager::instance()->lightClusters();
+
+        ImGui::SetNextWindowSize({320, 180}, ImGuiCond_FirstUseEver);
+        ImGui::Begin("Clustered Lighting");
+        ImGui::Text("Lights: %d", m_lightCount);
+        ImGui::Text("Frame time: %.2f ms", m_avgFrameTime);
+        ImGui::Text("Cluster assign: %.3f ms", m_avgAssignTime);
+        ImGui::Text("Light references: %zu", clusters->indexCount());
+        ImGui::Text("Max lights/cluster: %u", clusters->maxClusterLights());
+        ImGui::Checkbox("Animate", &m_animate);
+        ImGui::End();
+    }
+};
+
+int main(int argc, char **argv)
+{
+    int lightCount = 1000;
+
+    if (argc > 1)
+        lightCount = std::max(1, std::atoi(argv[1]));
+
+    auto app = GLFWApplication::create();
+
+    app->hint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    app->hint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    app->hint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    app->hint(GLFW_SAMPLES, 4);
+
+    auto window = ClusteredLightsWindow::create(1280, 800, "Clustered lighting", lightCount);
+
+    app->addWindow(window);
+    return app->loop();
+}
@@ -6,6 +6,8 @@
  * @ingroup deformer_examples
  *
  * This example demonstrates the use of deformers to manipulate a 3D mesh.
+ * Press G to compare the GPU evaluation of each GPU-capable deformer with
+ * the CPU evaluation.
  */
 
 #include <cmath>
@@ -19,6 +21,10 @@
 
 #include <ivf/twist_deformer.h>
 #include <ivf/bend_deformer.h>
+#include <ivf/scale_deformer.h>
+#include <ivf/wave_deformer.h>
+#include <ivf/turbulence_deformer.h>
+#include <ivf/deformer_stack.h>
 #include <ivf/deformable_mesh_node.h>
 #include <ivf/deformable_primitive.h>
 
@@ -135,6 +141,44 @@ public:
         return 0;
     }
 
+    void compareGpuDeformers()
+    {
+        // Use an undeformed copy of the box as input
+
+        auto box = RoundedBox::create();
+        box->setSize(glm::vec3(1.0f, 1.0f, 4.0f));
+        box->setSegments(glm::uvec3(10, 10, 40));
+        box->refresh();
+
+        auto turbulence = TurbulenceDeformer::create(1.5f, 0.2f, 4, 0.5f, 1.0f);
+        turbulence->setTime(1.3f);
+
+        auto wave = WaveDeformer::create(0.3f, 1.2f, 1.0f);
+        wave->setTime(0.7f);
+
+        std::vector<std::pair<std::string, std::shared_ptr<Deformer>>> deformers = {
+            {"Twist", m_twistDeformer},
+            {"Bend", m_bendDeformer},
+            {"Scale", ScaleDeformer::create(glm::vec3(0.0f), glm::vec3(1.5f, 0.5f, 1.2f))},
+            {"Wave", wave},
+            {"Turbulence", turbulence}};
+
+        for (auto &[name, deformer] : deformers)
+        {
+            auto stack = DeformerStack::create();
+            stack->setInput(box->mesh()->vertices());
+            stack->addDeformer(deformer);
+
+            float meanError = 0.0f;
+            float maxError = stack->compareGpu(&meanError);
+
+            if (maxError < 0.0f)
+                cout << name << ": GPU evaluation not available" << endl;
+            else
+                cout << name << ": max error = " << maxError << ", mean error = " << meanError << endl;
+        }
+    }
+
     virtual void onUpdate()
     {
         // Update twist parameters from the UI window
@@ -148,6 +192,10 @@ public:
         {
             m_deformableCube->primitive()->mesh()->setWireframe(!m_deformableCube->primitive()->mesh()->wireframe());
         }
+        else if (key == GLFW_KEY_G && action == GLFW_PRESS)
+        {
+            this->compareGpuDeformers();
+        }
         else if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         {
             this->close();
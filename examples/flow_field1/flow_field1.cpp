@@ -6,6 +6,7 @@
  *  - 5 000 particles emitted from a sphere, steered by a curl-noise field
  *  - The field evolves slowly over time — particles form organic, fluid-like streams
  *  - ImGui sliders to tweak field scale, strength, octaves, and time speed live
+ *  - Optional baked mode: the field is precomputed on a grid and interpolated
  *  - Space pauses / resumes the TimeController (particles freeze in place)
  *
  * Controls:
@@ -33,6 +34,7 @@ private:
     float m_strength{3.5f};
     int   m_octaves{2};
     float m_timeScale{0.06f};
+    bool  m_baked{false};
 
 public:
     ExampleWindow(int w, int h, std::string title) : GLFWSceneWindow(w, h, title) {}
@@ -67,6 +69,8 @@ public:
         m_field->setOctaves(m_octaves);
         m_field->setTimeScale(m_timeScale);
         m_field->setOffset(glm::vec3(31.4f, 17.3f, 57.1f)); // avoid near-zero region at noise origin
+        m_field->setBakeRegion(glm::vec3(-12.0f, -4.0f, -12.0f), glm::vec3(12.0f, 4.0f, 12.0f));
+        m_field->setBakeResolution(glm::ivec3(64, 16, 64));
 
         // Particle system — spawn from a large flat box so particles
         // cover diverse noise coordinates and see varied flow directions
@@ -128,6 +132,9 @@ public:
             m_field->setTimeScale(m_timeScale);
         }
 
+        if (ImGui::Checkbox("Baked grid", &m_baked))
+            m_field->setBaked(m_baked);
+
         ImGui::Separator();
         ImGui::Text("Alive : %d / %d", m_ps->aliveCount(), m_ps->maxParticles());
         ImGui::Text("Time  : %.2f s",  TimeController::instance()->elapsed());
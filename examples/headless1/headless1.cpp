@@ -0,0 +1,149 @@
+/**
+ * @file headless1.cpp
+ * @brief Headless rendering example
+ * @ingroup effects_examples
+ *
+ * Renders a shadowed, post-processed scene without a display using the
+ * OSMesa (default) or EGL backend of GLFWApplication. Time advances by a
+ * fixed step of 1/30 s per frame, so every run produces the same images.
+ * After the last frame the image is written to headless1.png and the
+ * average draw time is logged.
+ *
+ *     ./headless1 [frames] [osmesa|egl]
+ *
+ * On a machine without a GPU, run on Mesa llvmpipe:
+ *
+ *     LIBGL_ALWAYS_SOFTWARE=1 ./headless1 120
+ *
+ * Any other example can be run headless through the environment instead:
+ *
+ *     IVF_HEADLESS=1 IVF_MAX_FRAMES=60 IVF_FIXED_TIMESTEP=0.0333 IVF_CAPTURE_DIR=out ./shadows1
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <ivf/gl.h>
+#include <ivf/nodes.h>
+#include <ivfui/ui.h>
+
+#include <ivf/light_manager.h>
+#include <ivf/bloom_effect.h>
+#include <ivf/vignette_effect.h>
+
+using namespace ivf;
+using namespace ivfui;
+
+class HeadlessWindow : public GLFWSceneWindow {
+private:
+    CompositeNodePtr m_boxes;
+    int m_frames;
+
+public:
+    HeadlessWindow(int width, int height, std::string title, int frames)
+        : GLFWSceneWindow(width, height, title), m_frames(frames)
+    {}
+
+    static std::shared_ptr<HeadlessWindow> create(int width, int height, std::string title, int frames)
+    {
+        return std::make_shared<HeadlessWindow>(width, height, title, frames);
+    }
+
+    int onSetup() override
+    {
+        auto lightMgr = LightManager::instance();
+        lightMgr->clearLights();
+        lightMgr->setUseShadows(true);
+
+        auto dirLight = lightMgr->addDirectionalLight();
+        dirLight->setAmbientColor(glm::vec3(0.3, 0.3, 0.3));
+        dirLight->setDiffuseColor(glm::vec3(1.0, 1.0, 1.0));
+        dirLight->setSpecularColor(glm::vec3(1.0, 1.0, 1.0));
+        dirLight->setDirection(glm::vec3(-0.3, -1.0, -0.2));
+        dirLight->setCastShadows(true);
+        dirLight->setShadowMapSize(2048, 2048);
+        lightMgr->apply();
+
+        auto planeMaterial = Material::create();
+        planeMaterial->setDiffuseColor(glm::vec4(0.8, 0.8, 0.8, 1.0));
+
+        auto plane = Plane::create(20.0, 20.0, 10, 10);
+        plane->setMaterial(planeMaterial);
+        this->add(plane);
+
+        auto boxMaterial = Material::create();
+        boxMaterial->setDiffuseColor(glm::vec4(0.9, 0.5, 0.1, 1.0));
+
+        m_boxes = CompositeNode::create();
+
+        for (auto row = -2; row <= 2; row++)
+            for (auto col = -2; col <= 2; col++)
+            {
+                auto box = Box::create(glm::vec3(0.8, 0.8, 0.8));
+                box->setPos(glm::vec3(row * 2.0, 0.0, col * 2.0));
+                box->setMaterial(boxMaterial);
+                m_boxes->add(box);
+            }
+
+        m_boxes->setPos(glm::vec3(0.0, 3.0, 0.0));
+        this->add(m_boxes);
+
+        // Post-processing runs exactly as in a windowed application
+
+        this->setRenderToTexture(true);
+
+        auto bloomEffect = BloomEffect::create();
+        bloomEffect->setThreshold(0.8);
+        bloomEffect->load();
+        this->addEffect(bloomEffect);
+
+        auto vignetteEffect = VignetteEffect::create();
+        vignetteEffect->load();
+        this->addEffect(vignetteEffect);
+
+        this->cameraManipulator()->setCameraPosition(glm::vec3(0.0, 10.0, 20.0));
+
+        return 0;
+    }
+
+    void onUpdate() override
+    {
+        // elapsedTime() is the simulated time, independent of the render speed
+
+        auto t = float(elapsedTime());
+        m_boxes->setEulerAngles(0.0f, t * 45.0f, 0.0f);
+    }
+
+    void onDrawComplete() override
+    {
+        if (drawnFrames() == m_frames - 1)
+            this->saveScreenshot("headless1.png");
+    }
+};
+
+int main(int argc, char **argv)
+{
+    int frames = 60;
+    auto context = HeadlessContext::OSMesa;
+
+    if (argc > 1)
+        frames = std::max(1, std::atoi(argv[1]));
+
+    if (argc > 2 && std::string(argv[2]) == "egl")
+        context = HeadlessContext::EGL;
+
+    auto app = GLFWApplication::createHeadless(context);
+    app->setFixedTimeStep(1.0 / 30.0);
+    app->setMaxFrames(frames);
+
+    app->hint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    app->hint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    app->hint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    auto window = HeadlessWindow::create(1280, 720, "Headless", frames);
+
+    app->addWindow(window);
+    return app->loop();
+}
@@ -0,0 +1,131 @@
+/**
+ * @file noise_bench1.cpp
+ * @brief Throughput benchmark of the ProcUtils noise functions
+ * @ingroup general_examples
+ *
+ * Evaluates every batch noise function of ProcUtils over the same random
+ * coordinates with each instruction set supported by the CPU (scalar, SSE2,
+ * AVX2) and prints the throughput in million samples per second together with
+ * the largest difference to the scalar results. No window is opened.
+ *
+ *     ./noise_bench1 [samples]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ivf/proc_utils.h>
+
+using namespace ivf;
+
+struct Variant {
+    std::string name;
+    std::function<void(std::vector<float> &out)> run;
+};
+
+static const char *levelName(ProcUtils::SimdLevel level)
+{
+    switch (level)
+    {
+    case ProcUtils::SimdLevel::AVX2:
+        return "AVX2";
+    case ProcUtils::SimdLevel::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1 << 20;
+    count = std::max<size_t>(count, 16);
+
+    std::vector<float> x(count), y(count), z(count), w(count);
+    std::vector<float> dx(count), dy(count), dz(count);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        x[i] = dist(rng);
+        y[i] = dist(rng);
+        z[i] = dist(rng);
+        w[i] = dist(rng);
+    }
+
+    std::vector<Variant> variants = {
+        {"noise 2D", [&](auto &out) { ProcUtils::noise(x, y, out); }},
+        {"noise 3D", [&](auto &out) { ProcUtils::noise(x, y, z, out); }},
+        {"noise 2D + derivs", [&](auto &out) { ProcUtils::noiseDeriv(x, y, out, dx, dy); }},
+        {"noise 3D + derivs", [&](auto &out) { ProcUtils::noiseDeriv(x, y, z, out, dx, dy, dz); }},
+        {"value 2D", [&](auto &out) { ProcUtils::valueNoise(x, y, out); }},
+        {"value 3D", [&](auto &out) { ProcUtils::valueNoise(x, y, z, out); }},
+        {"simplex 2D", [&](auto &out) { ProcUtils::simplex(x, y, out); }},
+        {"simplex 3D", [&](auto &out) { ProcUtils::simplex(x, y, z, out); }},
+        {"simplex 4D", [&](auto &out) { ProcUtils::simplex(x, y, z, w, out); }},
+        {"worley 2D", [&](auto &out) { ProcUtils::voronoi(x, y, out, 4.0f); }},
+        {"fbm 2D (4 oct)", [&](auto &out) { ProcUtils::fbm(x, y, out, 4); }},
+        {"fbm 3D (4 oct)", [&](auto &out) { ProcUtils::fbm(x, y, z, out, 4); }},
+        {"turbulence (4 oct)", [&](auto &out) { ProcUtils::turbulence(x, y, out, 4); }},
+    };
+
+    std::vector<ProcUtils::SimdLevel> levels = {ProcUtils::SimdLevel::Scalar};
+
+    if (ProcUtils::supportedSimdLevel() >= ProcUtils::SimdLevel::SSE2)
+        levels.push_back(ProcUtils::SimdLevel::SSE2);
+    if (ProcUtils::supportedSimdLevel() >= ProcUtils::SimdLevel::AVX2)
+        levels.push_back(ProcUtils::SimdLevel::AVX2);
+
+    std::printf("%zu samples per run, best of 5 runs\n\n", count);
+    std::printf("%-20s", "");
+    for (auto level : levels)
+        std::printf("%14s", levelName(level));
+    std::printf("%14s\n", "max diff");
+
+    std::vector<float> reference(count), out(count);
+
+    for (auto &variant : variants)
+    {
+        std::printf("%-20s", variant.name.c_str());
+
+        float maxDiff = 0.0f;
+
+        for (auto level : levels)
+        {
+            ProcUtils::setSimdLevel(level);
+
+            double best = 1e30;
+
+            for (int run = 0; run < 5; run++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                variant.run(out);
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = std::min(best, elapsed);
+            }
+
+            if (level == ProcUtils::SimdLevel::Scalar)
+                reference = out;
+            else
+                for (size_t i = 0; i < count; i++)
+                    maxDiff = std::max(maxDiff, std::abs(out[i] - reference[i]));
+
+            std::printf("%10.1f M/s", count / best * 1e-6);
+        }
+
+        std::printf("%14.2g\n", maxDiff);
+    }
+
+    ProcUtils::setSimdLevel(ProcUtils::supportedSimdLevel());
+
+    return 0;
+}
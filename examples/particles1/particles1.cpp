@@ -7,6 +7,7 @@
  *  - Continuous emission with gravity
  *  - Per-particle color and size interpolation
  *  - Camera-facing (billboard) quads
+ *  - Composable force kernels (vortex, drag)
  *  - ImGui sliders to tweak emitter settings at runtime
  *
  * Call ps->update(dt) in onUpdate() — the scene window does NOT call it
@@ -24,11 +25,14 @@ using namespace ivfui;
 class ParticleWindow : public GLFWSceneWindow {
 private:
     ParticleSystemPtr m_ps;
+    std::shared_ptr<VortexForce> m_vortex;
+    std::shared_ptr<DragForce> m_drag;
     float m_emitRate{200.0f};
     float m_gravity{-4.0f};
     float m_minLife{0.8f}, m_maxLife{2.5f};
     bool m_fog{true};
     float m_fogNear{8.0f}, m_fogFar{30.0f};
+    bool m_useVortex{false}, m_useDrag{false};
 
 public:
     ParticleWindow(int w, int h, std::string title) : GLFWSceneWindow(w, h, title) {}
@@ -57,6 +61,14 @@ public:
         m_ps->start();
         add(m_ps);
 
+        // Forces are evaluated together with gravity in one pass per particle block
+        m_vortex = VortexForce::create({0, 0, 0}, {0, 1, 0}, 8.0f, 0.5f);
+        m_vortex->setEnabled(m_useVortex);
+        m_drag = DragForce::create(0.8f);
+        m_drag->setEnabled(m_useDrag);
+        m_ps->addForce(m_vortex);
+        m_ps->addForce(m_drag);
+
         enableAxis();
         cameraManipulator()->setCameraPosition({0, 3, 12});
         return 0;
@@ -92,6 +104,10 @@ public:
             m_ps->setFogRange(m_fogNear, m_fogFar);
         }
         ImGui::Separator();
+        if (ImGui::Checkbox("Vortex", &m_useVortex)) m_vortex->setEnabled(m_useVortex);
+        ImGui::SameLine();
+        if (ImGui::Checkbox("Drag", &m_useDrag)) m_drag->setEnabled(m_useDrag);
+        ImGui::Separator();
         ImGui::Text("Alive: %d / %d", m_ps->aliveCount(), m_ps->maxParticles());
 
         if (ImGui::Button(m_ps->isPlaying() ? "Stop" : "Start"))
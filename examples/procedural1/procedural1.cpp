@@ -218,6 +218,8 @@ public:
 
     void onDraw()
     {
+        m_currentTexture->update();
+
         glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -256,10 +258,10 @@ public:
                 // Global texture size
                 if (ImGui::InputInt2("Texture Size", m_textureSize))
                 {
-                    m_textureSize[0] = std::max(64, std::min(2048, m_textureSize[0]));
-                    m_textureSize[1] = std::max(64, std::min(2048, m_textureSize[1]));
+                    m_textureSize[0] = std::max(64, std::min(4096, m_textureSize[0]));
+                    m_textureSize[1] = std::max(64, std::min(4096, m_textureSize[1]));
                     m_currentTexture->setSize(m_textureSize[0], m_textureSize[1]);
-                    m_currentTexture->regenerate(); // Regenerate when size changes
+                    m_currentTexture->regenerateAsync(); // Regenerate when size changes
                 }
 
                 ImGui::Spacing();
@@ -458,9 +460,11 @@ public:
                     }
                 }
 
+                // Generated in the background, the previous texture is shown until it is done
+
                 if (needsRegeneration)
                 {
-                    m_currentTexture->regenerate();
+                    m_currentTexture->regenerateAsync();
                 }
 
                 ImGui::Spacing();
@@ -473,6 +477,7 @@ public:
 
                 ImGui::Spacing();
                 ImGui::Text("Current texture: %dx%d", m_currentTexture->width(), m_currentTexture->height());
+                ImGui::Text("Status: %s", m_currentTexture->ready() ? "Ready" : "Generating...");
             }
             ImGui::End();
         }
@@ -6,6 +6,8 @@
  * @ingroup effects_examples
  *
  * Example demonstrating how to use shadow mapping in IVF.
+ * Keys: SPACE toggles shadows, C toggles cascaded shadow maps, D cycles
+ * the shadow debug views.
  */
 
 #include <cmath>
@@ -80,6 +82,10 @@ public:
 
         lightManager->setUseShadows(true);
 
+        // The scene only moves nodes by their transforms, so unchanged shadow maps can be reused
+
+        lightManager->setShadowCaching(true);
+
         // Disable automatic bounding box calculation for the scene
 
         lightManager->setAutoCalcBBox(false);
@@ -204,6 +210,12 @@ public:
         {
             LightManager::instance()->setUseShadows(!LightManager::instance()->useShadows());
         }
+        else if (key == GLFW_KEY_C && action == GLFW_PRESS)
+        {
+            // Toggle between a single scene-fitted map and 4 view-fitted cascades
+
+            m_dirLight0->setCascadeCount(m_dirLight0->cascadeCount() == 1 ? 4 : 1);
+        }
         else if (key == GLFW_KEY_D && action == GLFW_PRESS)
         {
             m_debugShadow++;
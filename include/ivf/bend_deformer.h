@@ -21,6 +21,7 @@ private:
     float m_curvature;     ///< Bend curvature (radians per unit distance)
     float m_startDistance; ///< Distance where bend starts
     float m_endDistance;   ///< Distance where bend ends
+    glm::vec3 m_bendAxis;  ///< Bend direction, perpendicular to the axis
 
 public:
     /**
@@ -69,12 +70,48 @@ public:
      */
     virtual void apply() override;
 
+    /**
+     * @brief Prepare a fused evaluation pass.
+     * @param vertexCount Number of vertices of the pass.
+     * @return True.
+     */
+    virtual bool prepareKernel(GLuint vertexCount) override;
+
+    /**
+     * @brief Bend a block of positions in place.
+     * @param positions Positions of the block.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const override;
+
+    /**
+     * @brief Get the parameters for evaluating the bend in the vertex shader.
+     * @param gpu Receives the shader type and parameters.
+     * @return True.
+     */
+    virtual bool gpuDeformer(GpuDeformer &gpu) const override;
+
+    /**
+     * @brief Transform a bounding box of input positions into a box of the bent positions.
+     * @param bbox Box of the input positions, replaced by the box of the bent positions.
+     * @return True.
+     */
+    virtual bool transformBounds(BoundingBox &bbox) const override;
+
     /**
      * @brief Clone this deformer.
      * @return Unique pointer to a new BendDeformer with the same parameters.
      */
     virtual std::unique_ptr<Deformer> clone() const override;
 
+private:
+    /**
+     * @brief Direction of the bend, perpendicular to the axis.
+     * @return Unit direction vector.
+     */
+    glm::vec3 bendDirection() const;
+
 protected:
     /**
      * @brief Register properties for inspection.
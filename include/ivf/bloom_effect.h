@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ivf/effect.h>
+#include <ivf/downsample_chain.h>
 
 namespace ivf {
 
@@ -11,6 +12,8 @@ namespace ivf {
  * The BloomEffect class implements a bloom effect, which enhances the appearance of bright regions
  * in a scene by making them glow. The effect is controlled by a threshold (to select which pixels
  * are considered "bright") and an intensity (to control the strength of the glow).
+ * The bright pass feeds a dual-Kawase downsample chain whose levels are accumulated again
+ * while upsampling, giving a wide glow at the cost of a few low resolution passes.
  *
  * Inherits from Effect and can be used as part of a rendering pipeline.
  */
@@ -18,6 +21,8 @@ class BloomEffect : public Effect {
 private:
     float m_threshold = 1.0; ///< Brightness threshold for bloom activation.
     float m_intensity = 1.0; ///< Intensity of the bloom effect.
+    int m_quality{1};        ///< Quality preset (BlurQuality as int for the inspector).
+    DownsampleChainPtr m_chain; ///< Downsample chain computing the glow.
 
 public:
     /**
@@ -55,6 +60,29 @@ public:
      */
     float intensity() const;
 
+    /**
+     * @brief Set the quality preset of the downsample chain.
+     * @param quality Quality preset.
+     */
+    void setQuality(BlurQuality quality);
+
+    /**
+     * @brief Get the quality preset of the downsample chain.
+     * @return BlurQuality Quality preset.
+     */
+    BlurQuality quality() const;
+
+    /**
+     * @brief Get the downsample chain used by the effect.
+     * @return DownsampleChainPtr Downsample chain (nullptr before the effect is loaded).
+     */
+    DownsampleChainPtr chain();
+
+    /**
+     * @brief Render the downsample chain and bind its result for the final pass.
+     */
+    void renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO) override;
+
 protected:
     /**
      * @brief Load and initialize the bloom effect resources (e.g., shaders).
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ivf/effect.h>
+#include <ivf/downsample_chain.h>
 
 namespace ivf {
 
@@ -10,12 +11,18 @@ namespace ivf {
  *
  * The BlurEffect class implements a blur effect, which softens the appearance of the scene
  * by averaging neighboring pixels. The strength of the blur is controlled by the blur radius.
+ * The blur is computed on a dual-Kawase downsample chain whose depth follows the radius, so
+ * its cost stays roughly constant instead of growing with the square of the radius.
  *
  * Inherits from Effect and can be used as part of a rendering pipeline.
  */
 class BlurEffect : public Effect {
 private:
-    float m_blurRadius{0.0f}; ///< Radius of the blur effect.
+    float m_blurRadius{0.0f};  ///< Radius of the blur effect.
+    int m_quality{1};          ///< Quality preset (BlurQuality as int for the inspector).
+    DownsampleChainPtr m_chain; ///< Downsample chain computing the blur.
+
+    float blurOffset() const;
 
 public:
     /**
@@ -46,6 +53,29 @@ public:
      */
     float blurRadius();
 
+    /**
+     * @brief Set the quality preset of the downsample chain.
+     * @param quality Quality preset.
+     */
+    void setQuality(BlurQuality quality);
+
+    /**
+     * @brief Get the quality preset of the downsample chain.
+     * @return BlurQuality Quality preset.
+     */
+    BlurQuality quality() const;
+
+    /**
+     * @brief Get the downsample chain used by the effect.
+     * @return DownsampleChainPtr Downsample chain (nullptr before the effect is loaded).
+     */
+    DownsampleChainPtr chain();
+
+    /**
+     * @brief Render the downsample chain and bind its result for the final pass.
+     */
+    void renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO) override;
+
 protected:
     /**
      * @brief Load and initialize the blur effect resources (e.g., shaders).
@@ -7,26 +7,35 @@
 #include <ivf/node.h>
 #include <ivf/composite_node.h>
 #include <ivf/node_visitor.h>
+#include <ivf/program.h>
+#include <ivf/render_target.h>
+#include <ivf/shadow_caster_tracker.h>
+
+#include <glm/glm.hpp>
 
 namespace ivf {
 
 /**
  * @class BufferSelection
- * @brief Implements object selection using an offscreen framebuffer and color picking.
+ * @brief Implements object selection using an offscreen framebuffer and ID picking.
  *
  * BufferSelection provides a mechanism for selecting scene objects by rendering the scene to an
- * offscreen framebuffer, where each object is drawn with a unique color ID. By reading the color
- * value at a specific pixel, the corresponding object can be identified. This is commonly used
- * for mouse picking and selection in 3D editors and viewers.
+ * offscreen R32UI target, where each object writes its object ID (fragment output 1 of the stock
+ * shaders). By reading the ID at a specific pixel, the corresponding object can be identified.
+ * This is commonly used for mouse picking and selection in 3D editors and viewers.
+ *
+ * Hover picking uses beginPick()/endPick(): the ID pass is only rendered when the cursor, the
+ * camera or the scene has changed, and only inside a small scissor window around the cursor. The
+ * picked ID is read back through a pixel buffer object guarded by a fence and becomes available
+ * from pickedNode() a frame later, so picking never stalls the pipeline. nodesInRegion() reduces
+ * the IDs of a region to a per-ID presence mask on the GPU.
  *
- * The class manages the framebuffer, color texture, and depth buffer, and maintains a mapping
- * between object IDs and Node pointers.
+ * The ID and depth attachments are acquired from the RenderTargetPool and exchanged when the
+ * size changes. The class maintains a mapping between object IDs and Node pointers.
  */
 class BufferSelection : public GLBase {
 private:
-    GLuint m_fbo{0};            ///< Framebuffer object for offscreen rendering.
-    GLuint m_colorTexture{0};   ///< Texture storing color IDs for selection.
-    GLuint m_depthRenderBuffer; ///< Renderbuffer for depth information.
+    RenderTargetPtr m_target; ///< Object ID and depth target held from the RenderTargetPool.
 
     int m_width{0};  ///< Width of the selection buffer.
     int m_height{0}; ///< Height of the selection buffer.
@@ -35,6 +44,30 @@ private:
 
     NodeMap m_nodeMap; ///< Mapping from object IDs to Node pointers.
 
+    // Asynchronous picking
+
+    int m_pickRadius{2};            ///< Half size of the scissor window around the cursor.
+    GLuint m_pickPBO{0};            ///< Pixel buffer receiving the picked ID.
+    GLsync m_pickFence{nullptr};    ///< Fence after the pending read, null when idle.
+    unsigned int m_pickedId{0};     ///< Last completed pick result.
+    bool m_pickValid{false};        ///< True when the picked ID matches the last rendered state.
+    int m_pickX{-1};                ///< Cursor x of the last rendered pick.
+    int m_pickY{-1};                ///< Cursor y of the last rendered pick.
+    glm::mat4 m_pickViewProj{0.0f}; ///< View-projection of the last rendered pick.
+    bool m_trackSceneChanges{true}; ///< Walk the scene to detect moved or added nodes.
+    ShadowCasterTracker m_tracker;  ///< Detects scene changes between picks.
+    size_t m_pickPasses{0};         ///< Number of ID passes rendered for picking.
+    size_t m_pickSkips{0};          ///< Number of pick requests satisfied without rendering.
+
+    // GPU region reduction
+
+    ProgramPtr m_reduceProgram; ///< Scatters region IDs into the presence mask.
+    GLuint m_reduceVAO{0};      ///< Empty vertex array for attribute-less drawing.
+
+    void updateTarget();
+    void bindIdTarget();
+    void pollPick();
+
 public:
     /**
      * @brief Constructor.
@@ -74,7 +107,83 @@ public:
     void begin();
 
     /**
-     * @brief Get the object ID at the specified pixel coordinates.
+     * @brief Begin an asynchronous hover pick at a cursor position.
+     *
+     * Collects the result of a previous pick if it has arrived. A new ID pass is only needed
+     * when the cursor, the camera or the scene changed since the last one and no read-back is
+     * in flight. In that case the ID target is bound with a scissor window around the cursor and
+     * true is returned; the caller draws the scene and calls endPick().
+     * @param x Cursor x in window coordinates.
+     * @param y Cursor y in window coordinates (top-down).
+     * @return bool True if the scene must be drawn for picking.
+     */
+    bool beginPick(int x, int y);
+
+    /**
+     * @brief Queue the read-back of the picked ID and unbind the ID target.
+     */
+    void endPick();
+
+    /**
+     * @brief Get the node under the cursor from the most recent completed pick.
+     * @return Node* Picked node, or nullptr for background.
+     */
+    Node *pickedNode();
+
+    /**
+     * @brief Get the object ID from the most recent completed pick.
+     * @return unsigned int Picked ID, 0 for background.
+     */
+    unsigned int pickedId() const;
+
+    /**
+     * @brief Force a new ID pass on the next beginPick(), e.g. after modifying geometry in place.
+     */
+    void invalidate();
+
+    /**
+     * @brief Set the half size of the scissor window rendered around the cursor.
+     * @param radius Radius in pixels.
+     */
+    void setPickRadius(int radius);
+
+    /**
+     * @brief Get the pick window radius.
+     * @return int Radius in pixels.
+     */
+    int pickRadius() const;
+
+    /**
+     * @brief Enable or disable scene change tracking between picks.
+     *
+     * When enabled, every beginPick() walks the scene graph and compares world transforms and
+     * bounding boxes with the previous walk, so animated objects under a resting cursor are
+     * picked correctly. When disabled only cursor and camera changes (and invalidate()) trigger
+     * a new ID pass.
+     * @param flag True to track scene changes.
+     */
+    void setTrackSceneChanges(bool flag);
+
+    /**
+     * @brief Check if scene change tracking is enabled.
+     * @return bool True if enabled.
+     */
+    bool trackSceneChanges() const;
+
+    /**
+     * @brief Get the number of ID passes rendered by beginPick().
+     * @return size_t Pass count.
+     */
+    size_t pickPasses() const;
+
+    /**
+     * @brief Get the number of beginPick() calls that did not need an ID pass.
+     * @return size_t Skip count.
+     */
+    size_t pickSkips() const;
+
+    /**
+     * @brief Get the object ID at the specified pixel coordinates (synchronous read-back).
      * @param x X coordinate in the buffer.
      * @param y Y coordinate in the buffer.
      * @return unsigned int Object ID at the given pixel.
@@ -98,7 +207,8 @@ public:
 
     /**
      * @brief Collect all nodes whose ID appears within a screen-space rectangle.
-     * Must be called between begin() and end().
+     * Must be called between begin() and end(). The IDs are reduced on the GPU to one
+     * presence flag per ID, only the flags are read back.
      * @param x0 Left pixel (inclusive), in screen/window coordinates.
      * @param y0 Top pixel (inclusive).
      * @param x1 Right pixel (inclusive).
@@ -29,13 +29,21 @@ uniform mat4 lightSpaceMatrix;
 
 void main()
 {
-    fragPos = vec3(model * vec4(aPos, 1.0));
-    normal = mat3(model) * aNormal;
+    vec3 position = aPos;
+    vec3 vertexNormal = aNormal;
+
+#ifdef IVF_DEFORMERS
+    // GPU deformers, see deformer_shaders.h
+    deformVertex(position, vertexNormal);
+#endif
+
+    fragPos = vec3(model * vec4(position, 1.0));
+    normal = mat3(model) * vertexNormal;
     color = aColor;
     texCoord = aTex;
 
     if (shadowPass) {
-        gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+        gl_Position = lightSpaceMatrix * model * vec4(position, 1.0);
     } else {
         gl_Position = projection * view * vec4(fragPos, 1.0);
     }
@@ -58,7 +66,8 @@ inline const std::string bump_frag_shader_source = R"(
 
 #define MAX_TEXTURES 8
 
-out vec4 fragColor;
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out uint fragObjectId;
 
 struct Material
 {
@@ -126,6 +135,7 @@ uniform bool useVertexColors;
 uniform bool usePointFalloff  = false;
 uniform bool textRendering    = false;
 uniform bool useFixedTextColor = false;
+uniform bool textSdf          = false;
 
 uniform float point_falloff_a = 0.0;
 uniform float point_falloff_b = 0.0;
@@ -150,6 +160,8 @@ uniform float textureBlendFactors[MAX_TEXTURES];
 #define NR_POINT_LIGHTS 8
 #define NR_DIR_LIGHTS   8
 #define NR_SPOT_LIGHTS  8
+#define NR_SHADOW_LIGHTS 4
+#define MAX_CASCADES    4
 
 uniform PointLight pointLights[NR_POINT_LIGHTS];
 uniform DirLight   dirLights[NR_DIR_LIGHTS];
@@ -171,6 +183,8 @@ uniform int       debugShadow = 0;
 
 uniform sampler2D shadowMaps[NR_DIR_LIGHTS];
 uniform mat4      lightSpaceMatrices[NR_DIR_LIGHTS];
+uniform mat4      cascadeMatrices[NR_SHADOW_LIGHTS * MAX_CASCADES];
+uniform int       cascadeCounts[NR_SHADOW_LIGHTS];
 
 uniform samplerCube envMap;
 uniform bool        useEnvMap       = false;
@@ -178,10 +192,24 @@ uniform float       envReflectivity = 0.0;
 
 vec4 applyTexBlendMode(vec4 textureColor, vec4 baseColor);
 vec4 applyTexBlendModeIndexed(vec4 textureColor, vec4 baseColor, int mode, float factor);
-vec3 calcDirLight(DirLight light, vec3 norm, vec3 viewDir, mat4 lightMat, sampler2D sMap);
+vec3 calcDirLight(DirLight light, vec3 norm, vec3 viewDir, int lightIndex, sampler2D sMap);
 vec3 calcPointLight(PointLight light, vec3 norm, vec3 fragPos, vec3 viewDir);
 vec3 calcSpotLight(SpotLight light, vec3 norm, vec3 fragPos, vec3 viewDir);
-float calculateShadow(vec4 fragPosLightSpace, sampler2D sMap);
+float calculateShadow(int lightIndex, sampler2D sMap);
+float calculateShadowTile(vec3 projCoords, vec2 tileOffset, float tileScale, sampler2D sMap);
+
+// Glyph coverage, distance field glyphs are thresholded at the outline with a pixel-wide edge
+
+float textAlpha()
+{
+    float value = texture(texture0, texCoord).r;
+
+    if (!textSdf)
+        return value;
+
+    float width = max(fwidth(value), 1e-4);
+    return smoothstep(0.5 - width, 0.5 + width, value);
+}
 
 float rand(vec2 co) {
     return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
@@ -256,7 +284,7 @@ void main()
 
     for (int i = 0; i < dirLightCount; i++)
         if (dirLights[i].enabled)
-            result += calcDirLight(dirLights[i], norm, viewDir, lightSpaceMatrices[i], shadowMaps[i]);
+            result += calcDirLight(dirLights[i], norm, viewDir, i, shadowMaps[i]);
 
     for (int i = 0; i < spotLightCount; i++)
         if (spotLights[i].enabled)
@@ -264,11 +292,9 @@ void main()
 
     if (selectionRendering)
     {
-        uint mask = uint(255);
-        uint r = objectId & mask;
-        uint g = (objectId >> uint(8))  & mask;
-        uint b = (objectId >> uint(16)) & mask;
-        fragColor = vec4(float(r) / 255.0, float(g) / 255.0, float(b) / 255.0, 1.0);
+        // Object IDs go to the R32UI selection target on draw buffer 1
+        fragObjectId = objectId;
+        fragColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
     else
     {
@@ -281,9 +307,9 @@ void main()
                 if (textRendering)
                 {
                     if (useFixedTextColor)
-                        fragColor = vec4(textColor.rgb, texture(texture0, texCoord).r);
+                        fragColor = vec4(textColor.rgb, textAlpha());
                     else
-                        fragColor = vec4(result.rgb,   texture(texture0, texCoord).r);
+                        fragColor = vec4(result.rgb,   textAlpha());
                 }
                 else
                 {
@@ -330,7 +356,7 @@ void main()
     }
 }
 
-vec3 calcDirLight(DirLight light, vec3 norm, vec3 viewDir, mat4 lightMat, sampler2D sMap)
+vec3 calcDirLight(DirLight light, vec3 norm, vec3 viewDir, int lightIndex, sampler2D sMap)
 {
     vec3 n = normalize(norm);
     n = dot(n, viewDir) < -0.1 ? -n : n;
@@ -346,10 +372,7 @@ vec3 calcDirLight(DirLight light, vec3 norm, vec3 viewDir, mat4 lightMat, sample
 
     float shadow = 0.0;
     if (useShadows && light.castShadows)
-    {
-        vec4 fragPosLightSpace = lightMat * vec4(fragPos, 1.0);
-        shadow = calculateShadow(fragPosLightSpace, sMap);
-    }
+        shadow = calculateShadow(lightIndex, sMap);
 
     return ambient + (1.0 - shadow * light.shadowStrength) * (diffuse + specular);
 }
@@ -445,17 +468,35 @@ vec4 applyTexBlendModeIndexed(vec4 textureColor, vec4 baseColor, int mode, float
     return mix(baseColor, result, factor);
 }
 
-float calculateShadow(vec4 fragPosLightSpace, sampler2D sMap)
+float calculateShadow(int lightIndex, sampler2D sMap)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
-
-    if (projCoords.x < 0.0 || projCoords.x > 1.0 ||
-        projCoords.y < 0.0 || projCoords.y > 1.0 ||
-        projCoords.z < 0.0 || projCoords.z > 1.0)
+    if (lightIndex >= NR_SHADOW_LIGHTS)
         return 0.0;
 
-    float closestDepth = texture(sMap, projCoords.xy).r;
+    // Single map or 2x2 cascade tiles, see the basic shader.
+    int   count     = cascadeCounts[lightIndex];
+    float tileScale = count > 1 ? 0.5 : 1.0;
+    vec2  border    = 2.0 / (vec2(textureSize(sMap, 0)) * tileScale);
+
+    for (int i = 0; i < count; i++)
+    {
+        vec4 fragPosLightSpace = cascadeMatrices[lightIndex * MAX_CASCADES + i] * vec4(fragPos, 1.0);
+        vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+
+        if (all(greaterThanEqual(projCoords.xy, border)) && all(lessThanEqual(projCoords.xy, 1.0 - border)) &&
+            projCoords.z >= 0.0 && projCoords.z <= 1.0)
+        {
+            vec2 tileOffset = vec2(float(i % 2), float(i / 2)) * tileScale;
+            return calculateShadowTile(projCoords, tileOffset, tileScale, sMap);
+        }
+    }
+
+    return 0.0;
+}
+
+float calculateShadowTile(vec3 projCoords, vec2 tileOffset, float tileScale, sampler2D sMap)
+{
+    projCoords.xy = tileOffset + projCoords.xy * tileScale;
     float currentDepth = projCoords.z;
 
     vec3  n        = normalize(normal);
@@ -31,6 +31,9 @@ public:
     float contrast() const;
     float saturation() const;
 
+    bool isPointwise() const override;
+    std::string pointwiseSource() const override;
+
 protected:
     virtual void doLoad() override;
     virtual void doUpdateParams() override;
@@ -8,12 +8,17 @@
  * auto cm = Cubemap::create();
  * cm->load("right.jpg","left.jpg","top.jpg","bottom.jpg","front.jpg","back.jpg");
  * // or:
- * cm->loadFromDirectory("textures/skybox/"); // loads right/left/top/bottom/front/back.*
+ * cm->loadFromDirectory("textures/skybox/"); // loads cubemap.ktx2/.dds or right/left/top/bottom/front/back.*
+ * // or, from a single KTX2/DDS container (see ivf_texconv --cubemap):
+ * cm->load("textures/skybox.ktx2");
+ * // or, decoded in the background and shared:
+ * auto sky = TextureCache::instance()->loadCubemapFromDirectory("textures/skybox/");
  * @endcode
  */
 
 #include <ivf/glbase.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <memory>
@@ -35,8 +40,13 @@ public:
               std::string_view posZ, std::string_view negZ);
 
     /**
-     * @brief Scan a directory for right/left/top/bottom/front/back files
-     *        with common extensions (.jpg, .png, .hdr).
+     * @brief Load all faces, and any stored mipmap levels, from a KTX2 or DDS cubemap.
+     */
+    bool load(std::string_view filename);
+
+    /**
+     * @brief Load cubemap.ktx2 or cubemap.dds from a directory, or scan it for
+     *        right/left/top/bottom/front/back files with common extensions (.jpg, .png, .hdr).
      */
     bool loadFromDirectory(std::string_view dir);
 
@@ -63,9 +73,12 @@ public:
 
 private:
     GLuint m_id{0};
+    std::uint64_t m_lastUsed{0}; // TextureCache frame of the last bind()
 
-    static bool loadFace(GLenum target, std::string_view path);
     static std::string findFile(std::string_view dir, std::string_view stem);
+    static std::string findContainer(std::string_view dir);
+
+    friend class TextureCache;
 };
 
 using CubemapPtr = std::shared_ptr<Cubemap>;
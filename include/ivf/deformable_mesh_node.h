@@ -14,12 +14,47 @@ namespace ivf {
  * using a stack of Deformer objects. It manages the original vertex data and applies deformers
  * in sequence, supporting both manual and automatic updates. This is useful for animation,
  * morphing, and procedural geometry effects.
+ *
+ * All meshes of the node are deformed, in one pass split across the ThreadPool. The node keeps
+ * the DeformerStack::revision() of the last update and skips evaluation, vertex upload and normal
+ * recomputation while it is unchanged, so static frames cost nothing even with auto-update. A
+ * FunctionDeformer not marked with FunctionDeformer::setCacheable() changes on every update.
+ *
+ * With GPU deformation enabled and a stack of GPU-capable deformers, drawing only passes the
+ * deformer parameters as uniforms to the vertex shader, so animating them costs no vertex
+ * uploads. The meshes keep their original vertices; applyDeformers() then evaluates the stack on
+ * the CPU into deformedVertices() and updates the bounding box, for picking and export. Every new
+ * stack revision is still reported through contentRevision(), so shadows follow the shader.
+ *
+ * After a deformation the bounding box is by default derived in O(1) from the bounds of the
+ * original vertices with DeformerStack::transformBounds(). The box is conservative, so it can be
+ * larger than the deformed mesh. updateExactBounds() rescans the vertices on demand, and
+ * setExactBoundsInterval() rescans every n updates. Stacks with a deformer without a known bound
+ * are always rescanned. As the box need not change when the mesh does, deformations are also
+ * reported through contentRevision(), so cached shadow maps around the node are rendered again.
  */
 class DeformableMeshNode : public MeshNode {
 private:
     std::shared_ptr<DeformerStack> m_deformerStack; ///< Stack of deformers to apply to the mesh.
-    std::shared_ptr<Vertices> m_originalVertices;   ///< Original (undeformed) vertex data.
-    bool m_autoUpdate;                              ///< If true, deformers are applied automatically.
+    std::vector<std::shared_ptr<Vertices>> m_originalVertices; ///< Original (undeformed) vertex data per mesh.
+    std::vector<std::weak_ptr<Mesh>> m_originalMeshes;         ///< Mesh each original was captured from.
+    std::vector<std::shared_ptr<Vertices>> m_deformedVertices; ///< CPU evaluation per mesh for GPU deformation.
+    bool m_autoUpdate;                                         ///< If true, deformers are applied automatically.
+    bool m_gpuDeformation{false};                              ///< If true, deform in the vertex shader when possible.
+    bool m_meshDeformed{false};                                ///< True if the meshes hold CPU-deformed vertices.
+    uint64_t m_meshRevision{0};                                ///< Stack revision in the mesh vertices.
+    uint64_t m_evaluatedRevision{0};                           ///< Stack revision in m_deformedVertices.
+    uint64_t m_boundsRevision{0};                              ///< Stack revision of the bounding box.
+    BoundingBox m_originalBounds;                              ///< Bounds of the original vertices.
+    bool m_analyticBounds{true};                               ///< Derive the bounding box from the deformers.
+    int m_exactBoundsInterval{0};                              ///< Updates between exact rescans, 0 for never.
+    int m_boundsUpdates{0};                                    ///< Analytic updates since the last rescan.
+
+    bool useGpuDeformation() const;
+    void deformMeshes();
+    void evaluateDeformers();
+    void restoreMeshes();
+    void updateDeformedBounds();
 
 public:
     /**
@@ -69,10 +104,80 @@ public:
     bool autoUpdate() const;
 
     /**
-     * @brief Apply all deformers in the stack to the mesh.
+     * @brief Enable or disable deformation in the vertex shader.
+     *
+     * Only used when all enabled deformers are GPU-capable and the current shader program
+     * supports deformers, otherwise the deformers are applied to the mesh on the CPU.
+     * @param gpuDeformation True to deform on the GPU.
+     */
+    void setGpuDeformation(bool gpuDeformation);
+
+    /**
+     * @brief Check if deformation in the vertex shader is enabled.
+     * @return bool True if GPU deformation is enabled.
+     */
+    bool gpuDeformation() const;
+
+    /**
+     * @brief Apply all deformers in the stack to the meshes.
+     *
+     * Does nothing if the stack revision is unchanged since the last update. With GPU deformation
+     * active the meshes are left unchanged and the result is only stored in deformedVertices()
+     * and the bounding box.
      */
     void applyDeformers();
 
+    /**
+     * @brief Make the next update evaluate the deformers even if the stack is unchanged.
+     *
+     * Needed after modifying the original vertices.
+     */
+    void invalidateDeformation();
+
+    /**
+     * @brief Get the vertices of a mesh from the last CPU evaluation for GPU deformation.
+     * @param index Index of the mesh.
+     * @return std::shared_ptr<Vertices> Deformed vertices, or nullptr if not evaluated.
+     */
+    std::shared_ptr<Vertices> deformedVertices(size_t index = 0);
+
+    /**
+     * @brief Enable or disable analytic bounding boxes.
+     * @param analyticBounds True to derive the bounding box from the deformers, false to always rescan.
+     */
+    void setAnalyticBounds(bool analyticBounds);
+
+    /**
+     * @brief Check if analytic bounding boxes are enabled.
+     * @return bool True if enabled.
+     */
+    bool analyticBounds() const;
+
+    /**
+     * @brief Set how often the analytic bounding box is replaced by an exact rescan.
+     * @param interval Number of bounding box updates between rescans, 0 to only rescan on demand.
+     */
+    void setExactBoundsInterval(int interval);
+
+    /**
+     * @brief Get the number of bounding box updates between exact rescans.
+     * @return int Updates between rescans, 0 if only rescanned on demand.
+     */
+    int exactBoundsInterval() const;
+
+    /**
+     * @brief Set the bounding box from the deformed vertices.
+     *
+     * With GPU deformation the stack is evaluated on the CPU first.
+     */
+    void updateExactBounds();
+
+    /**
+     * @brief Get the revision of the drawn deformation.
+     * @return uint64_t Stack revision the next draw shows, 0 if undeformed.
+     */
+    [[nodiscard]] virtual uint64_t contentRevision() const override;
+
     /**
      * @brief Reset the mesh to its original (undeformed) state.
      */
@@ -86,10 +191,17 @@ public:
 
 protected:
     /**
-     * @brief Store the original (undeformed) vertex data.
+     * @brief Store the original (undeformed) vertex data of meshes that are new or have changed size.
      */
     void storeOriginalVertices();
 
+    /**
+     * @brief Store the original vertex data of all meshes again.
+     *
+     * Needed when the meshes have been rebuilt with new geometry, e.g. after refreshing a primitive.
+     */
+    void captureOriginalVertices();
+
     /**
      * @brief Draw the mesh, applying deformers if auto-update is enabled.
      */
@@ -79,7 +79,7 @@ public:
     {
         m_primitive->refresh();
         copyFromPrimitive();
-        storeOriginalVertices();
+        captureOriginalVertices();
     }
 
 private:
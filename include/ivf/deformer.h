@@ -3,6 +3,7 @@
 #include <ivf/base.h>
 #include <ivf/vertices.h>
 #include <ivf/mesh.h>
+#include <ivf/bounding_box.h>
 #include <ivf/property_inspectable.h>
 #include <glm/glm.hpp>
 #include <memory>
@@ -15,6 +16,27 @@ namespace ivf {
 class Mesh;
 class MeshNode;
 
+/**
+ * @brief Deformer types evaluated by the vertex shader snippet in deformer_shaders.h.
+ */
+enum class GpuDeformerType : int {
+    NONE = 0,
+    TWIST = 1,
+    BEND = 2,
+    SCALE = 3,
+    WAVE = 4,
+    TURBULENCE = 5
+};
+
+/**
+ * @struct GpuDeformer
+ * @brief Deformer parameters passed to the vertex shader, laid out as described in deformer_shaders.h.
+ */
+struct GpuDeformer {
+    GpuDeformerType type{GpuDeformerType::NONE}; ///< Deformer function of the shader.
+    glm::vec4 params[4]{};                       ///< Type specific parameters.
+};
+
 /**
  * @class Deformer
  * @brief Base class for mesh deformers.
@@ -22,6 +44,10 @@ class MeshNode;
  * The Deformer class provides an interface for mesh deformation operations.
  * It manages original and deformed vertex data, supports enabling/disabling,
  * blending (weight), and property inspection for animation and editing.
+ *
+ * Every parameter change gives the deformer a new revision(), drawn from a counter shared by all
+ * deformers, so that a newer revision is always larger than any earlier one. Setters of derived
+ * classes call markChanged(), edits through the property inspector are handled by onPropertyChanged().
  */
 class Deformer : public Base, public PropertyInspectable {
 protected:
@@ -29,6 +55,9 @@ protected:
     std::shared_ptr<Vertices> m_deformedVertices; ///< Deformed (output) vertices.
     bool m_enabled;                               ///< Whether the deformer is enabled.
     float m_weight;                               ///< Blend weight for combining deformers.
+    uint64_t m_revision;                          ///< Revision of the deformer parameters.
+    size_t m_inputSlot{0};                        ///< Input evaluated next among those deformed together.
+    size_t m_inputSlotCount{1};                   ///< Number of inputs deformed together.
 
 public:
     /**
@@ -47,6 +76,16 @@ public:
      */
     virtual void setInput(std::shared_ptr<Vertices> vertices);
 
+    /**
+     * @brief Select which of several inputs deformed together the next evaluation refers to.
+     *
+     * Set by DeformerStack before each mesh of a multi-mesh update. Deformers keeping per-vertex
+     * state between updates keep one copy per slot.
+     * @param slot Index of the input.
+     * @param slotCount Number of inputs deformed together.
+     */
+    void setInputSlot(size_t slot, size_t slotCount);
+
     /**
      * @brief Get the output (deformed) vertices.
      * @return Shared pointer to the deformed Vertices.
@@ -60,6 +99,50 @@ public:
      */
     virtual void apply() = 0;
 
+    /**
+     * @brief Prepare a fused evaluation pass over a number of vertices.
+     *
+     * Deformers with a per-vertex kernel return true and are then evaluated with applyKernel() by
+     * DeformerStack, chained with the other deformers of the stack in a single pass over blocks of
+     * vertices. Parameters that are constant over the pass are computed here. The default returns
+     * false and the deformer is evaluated with apply().
+     * @param vertexCount Number of vertices of the pass.
+     * @return True if applyKernel() can be used for this pass.
+     */
+    virtual bool prepareKernel(GLuint vertexCount);
+
+    /**
+     * @brief Deform a block of positions in place.
+     *
+     * Called after prepareKernel() returned true, concurrently from several threads on disjoint
+     * blocks, so implementations must only read the deformer state.
+     * @param positions Positions of the block, deformed in place.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const;
+
+    /**
+     * @brief Get the parameters for evaluating the deformer in the vertex shader.
+     *
+     * Deformers that are analytic functions of the position return true and fill in the
+     * parameters, the default returns false. See DeformerStack::applyGpuUniforms().
+     * @param gpu Receives the shader type and parameters.
+     * @return True if the deformer can be evaluated on the GPU.
+     */
+    virtual bool gpuDeformer(GpuDeformer &gpu) const;
+
+    /**
+     * @brief Transform a bounding box of input positions into a box of the deformed positions.
+     *
+     * The result is conservative: it contains every deformed position of every input inside the box,
+     * but can be larger than the exact bounds. Used by DeformableMeshNode to update its bounding box
+     * without visiting the vertices. The default returns false, for deformers without a known bound.
+     * @param bbox Box of the input positions, replaced by the box of the deformed positions.
+     * @return True if the box was transformed.
+     */
+    virtual bool transformBounds(BoundingBox &bbox) const;
+
     /**
      * @brief Reset the deformer to its initial state.
      */
@@ -89,6 +172,21 @@ public:
      */
     float weight() const;
 
+    /**
+     * @brief Get the revision of the deformer parameters.
+     *
+     * The revision changes whenever a parameter that affects the deformation changes. Deformers
+     * whose result can change without a parameter change return a new revision on every call.
+     * @return uint64_t Current revision.
+     */
+    virtual uint64_t revision() const;
+
+    /**
+     * @brief Get a new revision, larger than all revisions handed out before.
+     * @return uint64_t New revision.
+     */
+    static uint64_t nextRevision();
+
     /**
      * @brief Create a copy of the deformer for animation keyframes.
      * @return Unique pointer to the cloned Deformer.
@@ -96,10 +194,29 @@ public:
     virtual std::unique_ptr<Deformer> clone() const = 0;
 
 protected:
+    /**
+     * @brief Evaluate the kernel over all input vertices into the output vertices.
+     *
+     * Used by the apply() implementations of deformers with a kernel, so that both evaluation paths
+     * give the same result.
+     */
+    void applyWithKernel();
+
+    /**
+     * @brief Give the deformer a new revision after a parameter change.
+     */
+    void markChanged();
+
     /**
      * @brief Register properties for inspection.
      */
     virtual void setupProperties() override;
+
+    /**
+     * @brief Mark the deformer as changed when a property is edited.
+     * @param propertyName Name of the property that changed.
+     */
+    virtual void onPropertyChanged(const std::string &propertyName) override;
 };
 
 }; // namespace ivf
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <string>
+
+namespace ivf {
+
+/**
+ * @file deformer_shaders.h
+ * @brief Contains the GLSL snippet that evaluates deformer stacks in the vertex shader.
+ *
+ * ShaderManager adds the snippet to the basic and bump vertex shaders together with
+ * IVF_DEFORMERS, which makes them call deformVertex() on the attribute position and normal.
+ * A DeformerStack of GPU-capable deformers is passed as one type and four parameter vectors
+ * per deformer (see Deformer::gpuDeformer()). With deformerCount set to 0, the default, the
+ * vertices are left unchanged. The functions mirror the applyKernel() implementations of
+ * the deformers, and DeformerStack::compareGpu() checks that both give the same positions.
+ */
+
+/// Vertex shader snippet with the deformer uniforms, deformPosition() and deformVertex() (OpenGL 3.3+).
+inline const std::string deformer_vert_shader_source = R"(
+#define MAX_DEFORMERS 8
+
+#define DEFORM_TWIST 1
+#define DEFORM_BEND 2
+#define DEFORM_SCALE 3
+#define DEFORM_WAVE 4
+#define DEFORM_TURBULENCE 5
+
+uniform int deformerCount = 0;
+uniform int deformerTypes[MAX_DEFORMERS];
+uniform vec4 deformerParams[MAX_DEFORMERS * 4];
+uniform float deformerNormalStep = 0.01;
+
+// Same as calculateWeight() in utils.cpp
+float deformWeight(float distance, float start, float end, float falloff)
+{
+    if (distance < start)
+        return 1.0;
+    if (distance > end)
+        return 0.0;
+
+    float t = (distance - start) / (end - start);
+    return pow(1.0 - t, falloff);
+}
+
+// Rotation of v around the unit vector axis, as glm::rotate()
+vec3 deformRotate(vec3 v, float angle, vec3 axis)
+{
+    float c = cos(angle);
+    float s = sin(angle);
+    return v * c + cross(axis, v) * s + axis * dot(axis, v) * (1.0 - c);
+}
+
+// Same as TurbulenceDeformer::turbulence()
+float deformTurbulence(vec3 position, int octaves, float persistence, uint seed)
+{
+    float value = 0.0;
+    float amplitude = 1.0;
+    float frequency = 1.0;
+
+    for (int i = 0; i < octaves; ++i)
+    {
+        vec3 p = position * frequency;
+        uint hash = (uint(int(p.x)) * 73856093u) ^ (uint(int(p.y)) * 19349663u) ^ (uint(int(p.z)) * 83492791u);
+        hash = (hash ^ seed) & 0x7fffffffu;
+        float noise = float(hash % 1000u) / 500.0 - 1.0;
+        value += abs(noise) * amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0;
+    }
+    return value;
+}
+
+vec3 deformPosition(vec3 p)
+{
+    for (int i = 0; i < deformerCount; ++i)
+    {
+        vec4 p0 = deformerParams[i * 4];
+        vec4 p1 = deformerParams[i * 4 + 1];
+        vec4 p2 = deformerParams[i * 4 + 2];
+        vec4 p3 = deformerParams[i * 4 + 3];
+
+        int type = deformerTypes[i];
+
+        if (type == DEFORM_TWIST)
+        {
+            // p0 = axis, angle; p1 = center, falloff; p2 = start, end, weight
+            vec3 relativePos = p - p1.xyz;
+            float axisDistance = dot(relativePos, p0.xyz);
+            float weight = deformWeight(abs(axisDistance), p2.x, p2.y, p1.w) * p2.z;
+            if (weight > 0.0)
+                p = mix(p, deformRotate(relativePos, p0.w * weight, p0.xyz) + p1.xyz, weight);
+        }
+        else if (type == DEFORM_BEND)
+        {
+            // p0 = axis, curvature; p1 = center, weight; p2 = bend direction; p3 = start, end
+            vec3 relativePos = p - p1.xyz;
+            float axisDistance = dot(relativePos, p0.xyz);
+            float weight = deformWeight(abs(axisDistance), p3.x, p3.y, 1.0) * p1.w;
+            if (weight > 0.0)
+                p = mix(p, p + p2.xyz * (p0.w * axisDistance * weight), weight);
+        }
+        else if (type == DEFORM_SCALE)
+        {
+            // p0 = center, falloff; p1 = scale, weight
+            vec3 relativePos = p - p0.xyz;
+            float weight = exp(-length(relativePos) * p0.w) * p1.w;
+            if (weight > 0.0)
+                p = relativePos * mix(vec3(1.0), p1.xyz, weight) + p0.xyz;
+        }
+        else if (type == DEFORM_WAVE)
+        {
+            // p0 = direction, frequency; p1 = wave vector, amplitude; p2 = offset, phase shift;
+            // p3 = displacement scale
+            float phase = dot(p + p2.xyz, p0.xyz) * p0.w - p2.w;
+            p += p1.xyz * (sin(phase) * p1.w) * p3.xyz;
+        }
+        else if (type == DEFORM_TURBULENCE)
+        {
+            // p0 = offset, pattern scale; p1 = displacement scale, intensity; p2 = octaves, persistence, seed
+            vec3 animatedPos = (p + p0.xyz) * p0.w;
+            int octaves = int(p2.x);
+            uint seed = floatBitsToUint(p2.z);
+            float turbX = deformTurbulence(animatedPos, octaves, p2.y, seed);
+            float turbY = deformTurbulence(animatedPos + vec3(100.0, 0.0, 0.0), octaves, p2.y, seed);
+            float turbZ = deformTurbulence(animatedPos + vec3(0.0, 100.0, 0.0), octaves, p2.y, seed);
+            p += vec3(turbX, turbY, turbZ) * p1.w * p1.xyz;
+        }
+    }
+    return p;
+}
+
+// Deforms a vertex and corrects its normal from finite differences along two tangents
+void deformVertex(inout vec3 position, inout vec3 vertexNormal)
+{
+    if (deformerCount == 0)
+        return;
+
+    vec3 deformed = deformPosition(position);
+
+    float normalLength = length(vertexNormal);
+    if (normalLength > 0.0)
+    {
+        vec3 n = vertexNormal / normalLength;
+        vec3 tangent = normalize(abs(n.x) < 0.9 ? cross(n, vec3(1.0, 0.0, 0.0)) : cross(n, vec3(0.0, 1.0, 0.0)));
+        vec3 bitangent = cross(n, tangent);
+
+        vec3 du = deformPosition(position + tangent * deformerNormalStep) - deformed;
+        vec3 dv = deformPosition(position + bitangent * deformerNormalStep) - deformed;
+        vec3 corrected = cross(du, dv);
+
+        if (dot(corrected, corrected) > 0.0)
+            vertexNormal = normalize(corrected) * normalLength;
+    }
+
+    position = deformed;
+}
+)";
+
+} // namespace ivf
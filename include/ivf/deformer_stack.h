@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ivf/deformer.h>
+#include <ivf/program.h>
 
 namespace ivf {
 
@@ -12,14 +13,48 @@ namespace ivf {
  * each deformer in order to a set of input vertices. This enables complex deformation effects
  * by combining simple deformers. The stack supports adding, removing, clearing, and accessing
  * deformers, as well as setting input vertices and retrieving the final output.
+ *
+ * With fused evaluation, which is the default, a stack whose enabled deformers all provide a
+ * per-vertex kernel (Deformer::prepareKernel()) is evaluated in a single pass: each block of vertices
+ * is copied from the input, run through all kernels while it is in the cache and written straight to
+ * the output, with the blocks split across the ThreadPool. Other stacks fall back to evaluating the
+ * deformers one after the other. Several vertex sets, such as the meshes of a node, can be deformed
+ * in one pass whose blocks are shared out together.
+ *
+ * revision() combines the revisions of the deformers with changes to the stack itself, so callers
+ * can skip evaluation when it is unchanged since their last update. transformBounds() gives a
+ * conservative bounding box of the output from the box of the input, without visiting the vertices.
+ *
+ * A stack of GPU-capable deformers (Deformer::gpuDeformer()) can instead be evaluated by the vertex
+ * shader, see applyGpuUniforms() and deformer_shaders.h. compareGpu() checks the GPU evaluation
+ * against the CPU evaluation.
  */
 class DeformerStack : public Base {
 private:
+    struct FusedPass {
+        const glm::vec3 *source; ///< Input positions.
+        glm::vec3 *positions;    ///< Output positions.
+        size_t count;            ///< Number of positions.
+    };
+
     std::vector<std::shared_ptr<Deformer>> m_deformers; ///< List of deformers in the stack.
     std::shared_ptr<Vertices> m_inputVertices;          ///< Input vertices for deformation.
     std::shared_ptr<Vertices> m_outputVertices;         ///< Output vertices after deformation.
+    std::vector<Deformer *> m_kernels;                  ///< Enabled deformers of the current fused pass.
+    bool m_fused{true};                                 ///< Evaluate kernels in a single pass when possible.
+    bool m_parallel{true};                              ///< Split fused passes across the ThreadPool.
+    size_t m_blockSize{2048};                           ///< Vertices per block of a fused pass.
+    float m_gpuNormalStep{0.01f};                       ///< Finite difference step of the GPU normals.
+    uint64_t m_revision;                                ///< Revision of the deformer list.
+
+    void selectInputSlot(size_t slot, size_t slotCount);
+    bool prepareKernels(GLuint vertexCount);
+    void applyFused(const std::vector<FusedPass> &passes);
+    void applySequential(Vertices &target);
 
 public:
+    static constexpr int maxGpuDeformers = 8; ///< Deformers the vertex shader snippet evaluates.
+
     /**
      * @brief Default constructor.
      */
@@ -71,6 +106,42 @@ public:
      */
     void apply(); // Apply all deformers in sequence
 
+    /**
+     * @brief Apply all deformers to the input vertices and write the result to other vertices.
+     *
+     * Used to deform mesh positions in place without going through the output vertices.
+     * @param target Vertices receiving the result, with as many rows as the input.
+     */
+    void applyTo(std::shared_ptr<Vertices> target);
+
+    /**
+     * @brief Apply all deformers to several sets of vertices.
+     *
+     * A fused pass evaluates the blocks of all sets together across the ThreadPool. Pairs with
+     * different row counts are skipped. The input set by setInput() is left unchanged.
+     * @param inputs Input vertices of each set.
+     * @param targets Vertices receiving the result of each set.
+     */
+    void applyTo(const std::vector<std::shared_ptr<Vertices>> &inputs,
+                 const std::vector<std::shared_ptr<Vertices>> &targets);
+
+    /**
+     * @brief Get the combined revision of the stack.
+     *
+     * Changes when a deformer is added or removed or a deformer parameter changes.
+     * @return uint64_t Current revision.
+     */
+    uint64_t revision() const;
+
+    /**
+     * @brief Transform a bounding box of input positions through all enabled deformers.
+     *
+     * See Deformer::transformBounds(). Fails if any enabled deformer has no known bound.
+     * @param bbox Box of the input positions, replaced by a conservative box of the output positions.
+     * @return bool True if the box was transformed.
+     */
+    bool transformBounds(BoundingBox &bbox) const;
+
     /**
      * @brief Reset all deformers in the stack to their initial state.
      */
@@ -102,6 +173,94 @@ public:
      * @param weight Blend weight (typically in [0, 1]).
      */
     void setWeight(float weight);
+
+    // Evaluation
+
+    /**
+     * @brief Enable or disable fused evaluation of deformers with kernels.
+     * @param fused True to evaluate in a single pass when possible.
+     */
+    void setFused(bool fused);
+
+    /**
+     * @brief Check if fused evaluation is enabled.
+     * @return bool True if enabled.
+     */
+    bool fused() const;
+
+    /**
+     * @brief Enable or disable splitting fused passes across the ThreadPool.
+     * @param parallel True to evaluate blocks on worker threads.
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * @brief Check if fused passes are split across the ThreadPool.
+     * @return bool True if parallel.
+     */
+    bool parallel() const;
+
+    /**
+     * @brief Set the number of vertices per block of a fused pass.
+     * @param blockSize Vertices per block (at least 1).
+     */
+    void setBlockSize(size_t blockSize);
+
+    /**
+     * @brief Get the number of vertices per block of a fused pass.
+     * @return size_t Vertices per block.
+     */
+    size_t blockSize() const;
+
+    // GPU evaluation
+
+    /**
+     * @brief Check if the stack can be evaluated by the vertex shader.
+     *
+     * True if the stack has between one and maxGpuDeformers enabled deformers and all of them
+     * provide GPU parameters.
+     * @return bool True if GPU capable.
+     */
+    bool gpuCapable() const;
+
+    /**
+     * @brief Set the deformer uniforms of the current program to evaluate the stack in its vertex shader.
+     *
+     * The program must be current and contain the snippet from deformer_shaders.h. The uniforms
+     * are left unchanged if the stack is not GPU capable.
+     * @param program Program receiving the uniforms.
+     * @return bool True if the uniforms were set.
+     */
+    bool applyGpuUniforms(ProgramPtr program) const;
+
+    /**
+     * @brief Turn off GPU deformation in the current program.
+     * @param program Program receiving the uniforms.
+     */
+    static void clearGpuUniforms(ProgramPtr program);
+
+    /**
+     * @brief Set the finite difference step used by the vertex shader to correct normals.
+     * @param step Step in model units.
+     */
+    void setGpuNormalStep(float step);
+
+    /**
+     * @brief Get the finite difference step used by the vertex shader to correct normals.
+     * @return float Step in model units.
+     */
+    float gpuNormalStep() const;
+
+    /**
+     * @brief Compare the GPU evaluation of the stack with the CPU evaluation.
+     *
+     * Evaluates the input vertices with the vertex shader snippet through transform feedback and
+     * compares the positions with applyTo(). Requires a current OpenGL context.
+     * @param meanError Optional, receives the mean distance between the positions.
+     * @return float Largest distance between the positions, negative if the stack is not GPU
+     * capable or the evaluation failed.
+     */
+    float compareGpu(float *meanError = nullptr);
 };
 
 }; // namespace ivf
@@ -5,8 +5,31 @@
 
 #include <glm/glm.hpp>
 
+#include <vector>
+
 namespace ivf {
 
+/// Maximum number of shadow cascades per directional light (MAX_CASCADES in the stock shaders).
+constexpr int MAX_SHADOW_CASCADES = 4;
+
+/// Number of directional lights with shadow maps supported by the stock shaders (NR_SHADOW_LIGHTS).
+constexpr int MAX_SHADOW_LIGHTS = 4;
+
+/**
+ * @struct ShadowCascade
+ * @brief One cascade of a directional light's shadow map (or the whole map when not cascaded).
+ */
+struct ShadowCascade {
+    glm::mat4 lightSpaceMatrix{1.0f}; ///< Light space matrix used to render and sample the cascade.
+    glm::ivec4 viewport{0};           ///< Region (x, y, width, height) of the shadow map used by the cascade.
+    glm::vec3 center{0.0f};           ///< World-space center of the sphere covered by the cascade.
+    float radius{0.0f};               ///< Radius of the covered sphere, including padding.
+    float splitNear{0.0f};            ///< View-space distance where the cascade starts.
+    float splitFar{0.0f};             ///< View-space distance where the cascade ends.
+    bool valid{false};                ///< True once the cascade has been fitted.
+    bool dirty{true};                 ///< True if the cascade must be re-rendered.
+};
+
 /**
  * @class DirectionalLight
  * @brief Represents a directional light source for scene illumination and shadow mapping.
@@ -19,6 +42,17 @@ class DirectionalLight : public Light {
 private:
     glm::vec3 m_direction; ///< Direction vector of the light.
 
+    int m_cascadeCount{1};             ///< Number of cascades (1 = single map fitted to the scene).
+    float m_shadowDistance{50.0f};     ///< View distance covered by the cascades.
+    float m_cascadeSplitLambda{0.75f}; ///< Blend between uniform (0) and logarithmic (1) splits.
+    float m_cascadePadding{0.15f};     ///< Extra cascade radius allowing camera motion without refitting.
+
+    std::vector<ShadowCascade> m_cascades; ///< Fitted cascades.
+    glm::vec3 m_fittedDirection{0.0f};     ///< Light direction the cascades were fitted for.
+    glm::ivec2 m_fittedMapSize{0};         ///< Shadow map size the cascades were laid out for.
+    GLuint m_fittedDepthTexture{0};        ///< Shadow map texture the cascades were rendered to.
+    BoundingBox m_fittedSceneBBox;         ///< Scene bounds covered by the cascade depth ranges.
+
 public:
     /**
      * @brief Default constructor.
@@ -50,6 +84,80 @@ public:
      */
     virtual glm::mat4 calculateLightSpaceMatrix(BoundingBox &sceneBBox) override;
 
+    /**
+     * @brief Set the number of shadow cascades.
+     *
+     * With a single cascade the shadow map covers the whole scene bounding box. With 2 to
+     * MAX_SHADOW_CASCADES cascades the view frustum up to shadowDistance() is split into slices,
+     * each rendered into a quarter of the shadow map.
+     * @param count Number of cascades (1 - MAX_SHADOW_CASCADES).
+     */
+    void setCascadeCount(int count);
+
+    /**
+     * @brief Get the number of shadow cascades.
+     * @return int Cascade count.
+     */
+    int cascadeCount() const;
+
+    /**
+     * @brief Set the view distance covered by the shadow cascades.
+     * @param distance Distance from the camera.
+     */
+    void setShadowDistance(float distance);
+
+    /**
+     * @brief Get the view distance covered by the shadow cascades.
+     * @return float Distance.
+     */
+    float shadowDistance() const;
+
+    /**
+     * @brief Set the cascade split scheme.
+     * @param lambda 0 for uniform splits, 1 for logarithmic splits.
+     */
+    void setCascadeSplitLambda(float lambda);
+
+    /**
+     * @brief Get the cascade split scheme.
+     * @return float Split lambda.
+     */
+    float cascadeSplitLambda() const;
+
+    /**
+     * @brief Set how much larger than needed each cascade is fitted.
+     *
+     * A cascade is only refitted (and re-rendered) when the camera slice it covers leaves the padded
+     * volume, so larger padding means fewer shadow passes at the cost of shadow resolution.
+     * @param padding Relative radius padding (e.g. 0.15 = 15%).
+     */
+    void setCascadePadding(float padding);
+
+    /**
+     * @brief Get the cascade padding.
+     * @return float Relative padding.
+     */
+    float cascadePadding() const;
+
+    /**
+     * @brief Fit the shadow cascades to the camera and scene, marking refitted cascades dirty.
+     * @param view Camera view matrix.
+     * @param projection Camera projection matrix.
+     * @param sceneBBox Bounding box of the shadow casters.
+     */
+    void updateShadowCascades(const glm::mat4 &view, const glm::mat4 &projection, BoundingBox &sceneBBox);
+
+    /**
+     * @brief Force all cascades to be refitted and re-rendered.
+     */
+    void invalidateShadowCascades();
+
+    /**
+     * @brief Get the shadow cascades.
+     * @return std::vector<ShadowCascade>& Cascades.
+     */
+    std::vector<ShadowCascade> &shadowCascades();
+
     /**
      * @brief Apply the light's parameters to the rendering context.
      */
@@ -27,6 +27,18 @@ public:
      */
     static std::shared_ptr<DitheringEffect> create();
 
+    /**
+     * @brief Check if the effect is point-wise.
+     * @return bool Always true, the effect can be fused with neighbouring point-wise effects.
+     */
+    bool isPointwise() const override;
+
+    /**
+     * @brief Get the GLSL snippet of the effect.
+     * @return std::string Snippet source.
+     */
+    std::string pointwiseSource() const override;
+
 protected:
     /**
      * @brief Load and initialize the dithering effect resources (e.g., shaders).
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <ivf/program.h>
+#include <ivf/render_target_pool.h>
+
+#include <memory>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @enum BlurQuality
+ * @brief Quality presets of a DownsampleChain, trading texture taps for speed.
+ */
+enum class BlurQuality {
+    Low,    ///< Dual-Kawase downsample and upsample only (5 + 8 taps per level).
+    Medium, ///< Adds a separable 9-tap Gaussian on the smallest level.
+    High    ///< Adds a separable 9-tap Gaussian on every downsampled level.
+};
+
+/**
+ * @class DownsampleChain
+ * @brief Dual-Kawase mip chain used by the blur and bloom effects.
+ *
+ * The source image is repeatedly downsampled to half resolution and then upsampled again to half
+ * the source resolution. Since every level has a quarter of the pixels of the previous one, the
+ * total cost is a small multiple of a single half resolution pass, independent of the blur radius,
+ * whereas a direct kernel at full resolution grows with the square of the radius.
+ *
+ * Intermediate levels are acquired from the RenderTargetPool and released as soon as the upsample
+ * pass has consumed them. The half resolution result is kept until the next render() or release()
+ * so the owner can sample it in its final full resolution pass.
+ */
+class DownsampleChain {
+private:
+    ProgramPtr m_downProgram;     ///< Kawase downsample (with optional bright pass).
+    ProgramPtr m_upProgram;       ///< Kawase upsample (with optional accumulation).
+    ProgramPtr m_gaussianProgram; ///< Separable Gaussian.
+
+    BlurQuality m_quality{BlurQuality::Medium}; ///< Current quality preset.
+    RenderTargetPtr m_result;                   ///< Half resolution result of the last render().
+    int m_passCount{0};                         ///< Passes rendered by the last render().
+    int m_levelCount{0};                        ///< Levels used by the last render().
+
+    void drawPass(RenderTargetPtr target, ProgramPtr program, GLuint sourceTexture, GLuint quadVAO);
+    void gaussian(RenderTargetPtr target, GLuint quadVAO);
+
+public:
+    DownsampleChain();
+    virtual ~DownsampleChain();
+
+    /**
+     * @brief Factory method to create a shared pointer to a DownsampleChain instance.
+     * @return std::shared_ptr<DownsampleChain> New DownsampleChain instance.
+     */
+    static std::shared_ptr<DownsampleChain> create();
+
+    /**
+     * @brief Compile the chain programs (shared between all chains).
+     */
+    void load();
+
+    /**
+     * @brief Set the quality preset.
+     * @param quality Quality preset.
+     */
+    void setQuality(BlurQuality quality);
+
+    /**
+     * @brief Get the quality preset.
+     * @return BlurQuality Quality preset.
+     */
+    BlurQuality quality() const;
+
+    /**
+     * @brief Compute the number of levels giving approximately the requested blur radius.
+     * @param radius Blur radius in full resolution pixels.
+     * @return int Level count (at least 1).
+     */
+    static int levelsForRadius(float radius);
+
+    /**
+     * @brief Run the downsample and upsample passes.
+     *
+     * Leaves the framebuffer binding, viewport and current program changed; the caller restores
+     * its own state.
+     *
+     * @param sourceTexture Full resolution input.
+     * @param width Input width.
+     * @param height Input height.
+     * @param levels Requested number of downsample levels (limited by the input size).
+     * @param quadVAO Vertex array of a full-screen quad.
+     * @param offset Tap offset scale, 1 for the standard kernel.
+     * @param threshold Bright pass threshold applied in the first downsample, negative to disable.
+     * @param accumulate Add each downsampled level back during upsampling (bloom) instead of a plain blur.
+     * @return GLuint Texture holding the half resolution result.
+     */
+    GLuint render(GLuint sourceTexture, int width, int height, int levels, GLuint quadVAO, float offset = 1.0f,
+                  float threshold = -1.0f, bool accumulate = false);
+
+    /**
+     * @brief Return the result of the last render() to the pool.
+     */
+    void release();
+
+    /**
+     * @brief Get the number of passes rendered by the last render().
+     * @return int Pass count.
+     */
+    int passCount() const;
+
+    /**
+     * @brief Get the number of levels used by the last render().
+     * @return int Level count.
+     */
+    int levelCount() const;
+};
+
+/**
+ * @typedef DownsampleChainPtr
+ * @brief Shared pointer type for DownsampleChain.
+ */
+typedef std::shared_ptr<DownsampleChain> DownsampleChainPtr;
+
+}; // namespace ivf
@@ -5,6 +5,14 @@
 
 namespace ivf {
 
+/**
+ * @brief Texture unit for images prepared by Effect::renderPasses() and read in the final pass.
+ *
+ * Units 0 and 1 hold the pass input and the previous frame, units 1-4 are used by shadow maps
+ * and default textures during scene rendering.
+ */
+constexpr int EFFECT_AUX_TEXTURE_UNIT = 6;
+
 /**
  * @class Effect
  * @brief Base class for post-processing and rendering effects.
@@ -21,6 +29,9 @@ private:
     int m_height{0};    ///< Height of the effect's render target.
     std::string m_name; ///< Name of the effect (optional).
 
+    ProgramPtr m_paramProgram; ///< Program targeted by doUpdateParams().
+    std::string m_paramPrefix; ///< Uniform prefix used by doUpdateParams().
+
 public:
     /**
      * @brief Default constructor.
@@ -97,9 +108,59 @@ public:
      */
     ProgramPtr program();
 
+    /**
+     * @brief Check if the effect only depends on the color of the current pixel.
+     *
+     * Point-wise effects provide a GLSL snippet through pointwiseSource() and can be
+     * fused with neighbouring point-wise effects into a single post-processing pass.
+     *
+     * @return bool True if the effect is point-wise.
+     */
+    virtual bool isPointwise() const;
+
+    /**
+     * @brief Get the GLSL snippet of a point-wise effect (see post_shaders.h for the format).
+     * @return std::string Snippet source, empty for regular effects.
+     */
+    virtual std::string pointwiseSource() const;
+
+    /**
+     * @brief Set the effect parameters on another program, e.g. a fused program.
+     * @param program Program that is currently in use.
+     * @param prefix Prefix of this effect's uniform names in the program.
+     */
+    void applyParams(ProgramPtr program, const std::string &prefix);
+
+    /**
+     * @brief Render intermediate passes needed before the effect's final full-screen pass.
+     *
+     * Called by PostProcessor for multi-pass effects such as blur and bloom. Implementations bind
+     * their results to EFFECT_AUX_TEXTURE_UNIT; the post-processor restores its framebuffer,
+     * viewport and texture bindings afterwards.
+     *
+     * @param sourceTexture Input of the effect.
+     * @param width Input width.
+     * @param height Input height.
+     * @param quadVAO Vertex array of a full-screen quad.
+     */
+    virtual void renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO);
+
 protected:
     ProgramPtr m_program; ///< Shader program used by the effect.
 
+    /**
+     * @brief Get the program parameters are currently written to.
+     * @return ProgramPtr The effect's own program or the program passed to applyParams().
+     */
+    ProgramPtr paramProgram();
+
+    /**
+     * @brief Get the name of a uniform in the program parameters are currently written to.
+     * @param name Uniform name as declared in the effect's snippet.
+     * @return std::string Uniform name including the current prefix.
+     */
+    std::string paramName(const std::string &name) const;
+
     /**
      * @brief Load effect-specific resources (to be overridden by derived classes).
      */
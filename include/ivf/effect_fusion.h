@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ivf/effect.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @class EffectFusion
+ * @brief Generates and caches fragment programs that run several point-wise effects in one pass.
+ *
+ * Every post-processing pass reads and writes a full-resolution RGBA16F target. Effects that only
+ * transform the color of the current pixel (vignette, tint, grading, ...) do not need their own
+ * pass: their snippets are concatenated into one program whose main() reads the source texture once
+ * and applies the effects in order. A chain of N point-wise effects then costs one pass instead of N.
+ *
+ * Generated programs are cached by chain signature (the concatenated snippets), so reordering or
+ * toggling effects only compiles a program the first time a combination is seen.
+ */
+class EffectFusion {
+private:
+    std::unordered_map<std::string, ProgramPtr> m_programs; ///< Fused programs by chain signature.
+    int m_compileCount{0};                                  ///< Number of programs compiled.
+
+public:
+    EffectFusion();
+
+    /**
+     * @brief Factory method to create a shared pointer to an EffectFusion instance.
+     * @return std::shared_ptr<EffectFusion> New EffectFusion instance.
+     */
+    static std::shared_ptr<EffectFusion> create();
+
+    /**
+     * @brief Get the uniform prefix of an effect in a generated program.
+     * @param index Position of the effect in the chain.
+     * @param count Number of effects in the chain.
+     * @return std::string Prefix, empty for a single effect so standalone uniform names are unchanged.
+     */
+    static std::string paramPrefix(size_t index, size_t count);
+
+    /**
+     * @brief Generate a fragment shader applying the given point-wise snippets in order.
+     * @param snippets Snippet sources (see post_shaders.h).
+     * @return std::string Complete GLSL 3.30 fragment shader source.
+     */
+    static std::string fragmentSource(const std::vector<std::string> &snippets);
+
+    /**
+     * @brief Get the fused program for a chain of point-wise effects, compiling it on first use.
+     * @param chain Point-wise effects in application order.
+     * @return ProgramPtr Fused program, or nullptr if it failed to compile.
+     */
+    ProgramPtr program(const std::vector<EffectPtr> &chain);
+
+    /**
+     * @brief Remove all cached programs.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of cached programs.
+     * @return size_t Program count.
+     */
+    size_t cachedPrograms() const;
+
+    /**
+     * @brief Get the number of programs compiled since creation.
+     * @return int Compile count.
+     */
+    int compileCount() const;
+};
+
+/**
+ * @typedef EffectFusionPtr
+ * @brief Shared pointer type for EffectFusion.
+ */
+typedef std::shared_ptr<EffectFusion> EffectFusionPtr;
+
+}; // namespace ivf
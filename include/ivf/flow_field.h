@@ -6,11 +6,16 @@
  */
 
 #include <memory>
+#include <span>
+#include <vector>
+#include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <ivf/particle_system.h>
 
 namespace ivf {
 
+class FlowFieldForce;
+
 /**
  * @class FlowField
  * @brief Curl-noise vector field for fluid-like particle and deformer steering.
@@ -25,7 +30,7 @@ namespace ivf {
  * field->setScale(0.4f);
  * field->setStrength(3.0f);
  * field->setOctaves(2);
- * field->applyToParticleSystem(ps);   // installs update function
+ * field->applyToParticleSystem(ps);   // adds a FlowFieldForce
  *
  * // in onUpdate():
  * field->setTime(TimeController::instance()->elapsed());
@@ -36,6 +41,18 @@ namespace ivf {
  * @code
  * glm::vec3 vel = field->sampleVelocity(particle.position);
  * @endcode
+ *
+ * In baked mode the field is precomputed on a grid over a region and sampled
+ * with trilinear interpolation, which replaces dozens of noise evaluations per
+ * sample with a few memory reads. Three time slices are kept: the two the
+ * current time lies between (lerped) and the next one, which setTime() fills in
+ * a few grid layers at a time so that it is complete when it is needed.
+ * @code
+ * field->setBakeRegion({-10, -5, -10}, {10, 5, 10});
+ * field->setBakeResolution({48, 24, 48});
+ * field->setBaked(true);
+ * field->sampleVelocities(positions, velocities);
+ * @endcode
  */
 class FlowField : public std::enable_shared_from_this<FlowField> {
 private:
@@ -48,42 +65,81 @@ private:
     float m_time{0.0f};        // current animated time
     glm::vec3 m_offset{0.0f}; // world-space offset into the noise domain
 
+    // Baked mode
+    bool       m_baked{false};
+    bool       m_bakeDirty{true};
+    glm::vec3  m_bakeMin{-10.0f}, m_bakeMax{10.0f};  // world-space grid bounds
+    glm::ivec3 m_bakeRes{32, 32, 32};                // grid nodes per axis
+    float      m_bakeInterval{1.0f};                 // field time between slices
+    std::vector<glm::vec3> m_slices[3];              // current, next and pending slice
+    float      m_sliceTime{0.0f};                    // time of m_slices[0]
+    int        m_pendingLayers{0};                   // z layers of m_slices[2] computed so far
+    GLuint     m_texture{0};
+
+    glm::vec3 evaluate(glm::vec3 pos, float time) const;
+    void bakeLayers(std::vector<glm::vec3>& slice, float time, int zBegin, int zEnd) const;
+    void updateBake();
+    glm::vec3 sampleBaked(glm::vec3 pos, float frac) const;
+
 public:
     FlowField() = default;
+    ~FlowField();
 
     static std::shared_ptr<FlowField> create();
 
     // ---- Configuration ---------------------------------------------------
 
     /** Spatial scale. Smaller values → broader, slower features. */
-    void setScale(float s)      { m_scale      = s; }
+    void setScale(float s)      { m_scale      = s; m_bakeDirty = true; }
     float scale() const         { return m_scale; }
 
     /** Velocity magnitude multiplier. */
-    void setStrength(float s)   { m_strength   = s; }
+    void setStrength(float s)   { m_strength   = s; m_bakeDirty = true; }
     float strength() const      { return m_strength; }
 
     /** fBm octave count. More octaves → finer vortex detail. */
-    void setOctaves(int n)      { m_octaves    = std::max(1, n); }
+    void setOctaves(int n)      { m_octaves    = std::max(1, n); m_bakeDirty = true; }
     int  octaves() const        { return m_octaves; }
 
-    void setLacunarity(float l) { m_lacunarity = l; }
-    void setGain(float g)       { m_gain       = g; }
+    void setLacunarity(float l) { m_lacunarity = l; m_bakeDirty = true; }
+    void setGain(float g)       { m_gain       = g; m_bakeDirty = true; }
 
     /** Controls how quickly the field rotates over time. */
-    void setTimeScale(float s)  { m_timeScale  = s; }
+    void setTimeScale(float s)  { m_timeScale  = s; m_bakeDirty = true; }
     float timeScale() const     { return m_timeScale; }
 
     /** World-space translation into the noise domain. */
-    void setOffset(glm::vec3 o) { m_offset     = o; }
+    void setOffset(glm::vec3 o) { m_offset     = o; m_bakeDirty = true; }
     glm::vec3 offset() const    { return m_offset; }
 
     // ---- Time ------------------------------------------------------------
 
-    /** Set current time directly (e.g. from TimeController::elapsed()). */
-    void setTime(float t)       { m_time       = t; }
+    /** Set current time directly (e.g. from TimeController::elapsed()). Advances the baked slices. */
+    void setTime(float t);
     float time() const          { return m_time; }
 
+    // ---- Baked mode -------------------------------------------------------
+
+    /** Enable sampling from a precomputed grid in sampleVelocities(). */
+    void setBaked(bool b)       { m_baked = b; m_bakeDirty = true; }
+    bool baked() const          { return m_baked; }
+
+    /** World-space region covered by the grid. Samples outside it are evaluated exactly. */
+    void setBakeRegion(glm::vec3 min, glm::vec3 max) { m_bakeMin = min; m_bakeMax = max; m_bakeDirty = true; }
+    glm::vec3 bakeMin() const   { return m_bakeMin; }
+    glm::vec3 bakeMax() const   { return m_bakeMax; }
+
+    /** Grid nodes per axis (at least 2). */
+    void setBakeResolution(glm::ivec3 res) { m_bakeRes = glm::max(res, glm::ivec3(2)); m_bakeDirty = true; }
+    glm::ivec3 bakeResolution() const { return m_bakeRes; }
+
+    /** Field time between baked slices; shorter intervals follow fast-evolving fields more closely. */
+    void setBakeInterval(float t) { m_bakeInterval = std::max(t, 1e-3f); m_bakeDirty = true; }
+    float bakeInterval() const  { return m_bakeInterval; }
+
+    /** Recompute all slices at the current time. Called automatically after changes. */
+    void bake();
+
     // ---- Sampling --------------------------------------------------------
 
     /**
@@ -100,21 +156,72 @@ public:
      */
     glm::vec2 sampleVelocity2D(float x, float z) const;
 
+    /**
+     * @brief Sample the flow velocity at many positions.
+     *
+     * Uses the baked grid (trilinear in space, linear in time) when baked mode
+     * is enabled, otherwise evaluates the noise per position. Thread-safe
+     * between setTime() calls.
+     */
+    void sampleVelocities(std::span<const glm::vec3> positions, std::span<glm::vec3> velocities) const;
+
+    // ---- GPU access --------------------------------------------------------
+
+    /**
+     * @brief Upload the baked field at the current time to a 3D texture (RGB16F).
+     *
+     * Texel centers map to the grid nodes, so consumers sample at
+     * (pos - bakeMin) / (bakeMax - bakeMin) * (res - 1) / res + 0.5 / res.
+     * Requires a current OpenGL context; does nothing unless baked mode is enabled.
+     */
+    void updateTexture();
+
+    /** 3D texture created by updateTexture(), 0 before the first upload. */
+    GLuint texture() const      { return m_texture; }
+
     // ---- Particle system integration ------------------------------------
 
     /**
-     * @brief Install a curl-noise steering function on a ParticleSystem.
+     * @brief Add a curl-noise steering force to a ParticleSystem.
      *
      * Each living particle's velocity is blended toward the local curl-noise
-     * velocity at rate `blendRate` (units: 1/second). Call field->setTime() each
-     * frame before ps->update() for time-animated flow.
+     * velocity at rate `blendRate` (units: 1/second). The force runs with the
+     * system's other forces after gravity; set the gravity to zero for pure flow.
+     * Call field->setTime() each frame before ps->update() for time-animated flow.
      *
      * @param ps        The particle system to steer.
      * @param blendRate How quickly particles align with the flow (5 = fast, 0.5 = sluggish).
+     * @return The added force, e.g. for ps->removeForce().
      */
-    void applyToParticleSystem(std::shared_ptr<ParticleSystem> ps, float blendRate = 5.0f);
+    std::shared_ptr<FlowFieldForce> applyToParticleSystem(std::shared_ptr<ParticleSystem> ps, float blendRate = 5.0f);
 };
 
 using FlowFieldPtr = std::shared_ptr<FlowField>;
 
+/**
+ * @class FlowFieldForce
+ * @brief Particle force blending velocities toward a FlowField.
+ *
+ * Holds the field weakly; the field is locked once per particle block rather
+ * than per particle, and the force does nothing once the field is destroyed.
+ */
+class FlowFieldForce : public ParticleForce {
+private:
+    std::weak_ptr<const FlowField> m_field;
+    float m_blendRate;
+
+public:
+    FlowFieldForce(std::shared_ptr<const FlowField> field, float blendRate = 5.0f)
+        : m_field(field), m_blendRate(blendRate) {}
+    static std::shared_ptr<FlowFieldForce> create(std::shared_ptr<const FlowField> field, float blendRate = 5.0f);
+
+    void setBlendRate(float r)                                   { m_blendRate = r; }
+    [[nodiscard]] float blendRate() const                        { return m_blendRate; }
+    [[nodiscard]] std::shared_ptr<const FlowField> field() const { return m_field.lock(); }
+
+    void apply(const ParticleBatch& batch, float dt) const override;
+};
+
+using FlowFieldForcePtr = std::shared_ptr<FlowFieldForce>;
+
 } // namespace ivf
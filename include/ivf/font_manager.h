@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include <tuple>
 
 #include <glad/glad.h>
 
@@ -10,6 +11,8 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <ivf/glyph_atlas.h>
+
 namespace ivf {
 
 /**
@@ -20,6 +23,9 @@ namespace ivf {
  * FreeType font faces. It ensures that font resources are managed efficiently and
  * provides methods to load new faces, retrieve the current face, and access faces by name.
  * This class is implemented as a singleton.
+ *
+ * Glyphs for rendering are kept in GlyphAtlas textures owned by the FontManager, one per face,
+ * pixel size and glyph type, and shared by all text nodes using them.
  */
 class FontManager {
 private:
@@ -31,6 +37,12 @@ private:
     std::map<std::string, FT_Face> m_faces; ///< Map of font face names to FT_Face handles.
     FT_Face m_currentFace;                  ///< Currently active font face.
 
+    std::map<std::tuple<FT_Face, int, bool>, GlyphAtlasPtr> m_atlases; ///< Shared glyph atlases.
+    unsigned int m_atlasRevision{0}; ///< Incremented when atlases are released.
+
+    GlyphAtlasPtr faceAtlas(FT_Face face, int pixelSize, bool sdf);
+    void dropAtlases(FT_Face face);
+
 public:
     /**
      * @brief Get the singleton instance of the FontManager.
@@ -88,6 +100,43 @@ public:
      * @return FT_Face Handle to the requested font face.
      */
     FT_Face face(const std::string name);
+
+    /**
+     * @brief Get the shared glyph atlas of the current face.
+     * @param pixelSize Glyph size in pixels.
+     * @param sdf True for signed distance field glyphs.
+     * @return GlyphAtlasPtr Atlas, nullptr if no face is loaded.
+     */
+    GlyphAtlasPtr atlas(int pixelSize, bool sdf = false);
+
+    /**
+     * @brief Get the shared glyph atlas of a named face.
+     * @param name Name of the font face.
+     * @param pixelSize Glyph size in pixels.
+     * @param sdf True for signed distance field glyphs.
+     * @return GlyphAtlasPtr Atlas, nullptr if the face is not loaded.
+     */
+    GlyphAtlasPtr atlas(const std::string name, int pixelSize, bool sdf = false);
+
+    /**
+     * @brief Release all glyph atlases. Text using them rebuilds its glyphs on the next draw.
+     */
+    void clearAtlases();
+
+    /**
+     * @brief Get the atlas revision, incremented when atlases are released.
+     *
+     * Text nodes compare it with the revision their atlas was looked up at and look up a new
+     * atlas when it has changed, see clearAtlases() and loadFace().
+     * @return unsigned int Atlas revision.
+     */
+    unsigned int atlasRevision() const;
+
+    /**
+     * @brief Get the number of glyph atlases.
+     * @return size_t Atlas count.
+     */
+    size_t atlasCount() const;
 };
 
 /**
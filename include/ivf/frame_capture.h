@@ -0,0 +1,255 @@
+#pragma once
+
+#include <ivf/glbase.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @enum CaptureFormat
+ * @brief Output format of captured frames.
+ */
+enum class CaptureFormat {
+    PNG, ///< One PNG file per frame.
+    QOI, ///< One QOI file per frame (much faster to encode than PNG).
+    Raw  ///< Top-down RGB8 frames appended to a single file or pipe.
+};
+
+/**
+ * @class FrameCapture
+ * @brief Asynchronous frame recorder using a ring of pixel buffer objects and encoder threads.
+ *
+ * capture() issues a glReadPixels into the next pixel buffer object of a ring and places a fence
+ * after it, so the copy runs asynchronously on the GPU. Buffers whose fence has signaled (with the
+ * default ring of three, typically the frame captured two frames earlier) are mapped, copied and
+ * handed to encoder threads, which flip, encode and write the frames. The render thread never
+ * waits: if the ring or the encoder queue is full, the frame is dropped and counted.
+ *
+ * Raw output goes to a single file, or to a command when the path starts with '|' (e.g.
+ * "|ffmpeg -f rawvideo -pix_fmt rgb24 -s 1280x720 -i - out.mp4"). Raw frames are written by one
+ * encoder thread to keep them in order.
+ *
+ * All methods must be called from the thread owning the OpenGL context.
+ */
+class FrameCapture : public GLBase {
+private:
+    struct Slot {
+        GLuint pbo{0};         ///< Pixel pack buffer.
+        GLsync fence{nullptr}; ///< Fence placed after the read, null when the slot is free.
+        size_t capacity{0};    ///< Allocated buffer size in bytes.
+        int width{0};          ///< Width of the pending frame.
+        int height{0};         ///< Height of the pending frame.
+        int copies{1};         ///< Number of output frames the pending frame stands for.
+    };
+
+    struct Job {
+        std::vector<unsigned char> pixels; ///< Bottom-up RGB8 pixels.
+        int width{0};                      ///< Frame width.
+        int height{0};                     ///< Frame height.
+        int index{0};                      ///< Output index of the first copy.
+        int copies{1};                     ///< Number of output frames to write.
+    };
+
+    std::vector<Slot> m_slots; ///< PBO ring.
+    size_t m_next{0};          ///< Next slot to read into.
+    size_t m_oldest{0};        ///< Oldest slot that may be pending.
+    int m_ringSize{3};         ///< Number of slots in the ring.
+
+    std::deque<Job> m_queue;             ///< Frames waiting for an encoder.
+    std::mutex m_mutex;                  ///< Protects the queue and statistics.
+    std::condition_variable m_condition; ///< Signals new jobs or shutdown.
+    std::condition_variable m_drained;   ///< Signals that a job was taken from the queue.
+    std::vector<std::thread> m_workers;  ///< Encoder threads.
+    int m_workerCount{0};                ///< Requested encoder threads (0 = automatic).
+    size_t m_maxQueueDepth{8};           ///< Frames queued before new frames are dropped.
+    bool m_stopping{false};              ///< True while the encoders shut down.
+    bool m_allowDrops{true};             ///< Drop frames instead of waiting when full.
+    bool m_verifyQOI{false};             ///< Decode QOI frames again and compare with the pixels.
+
+    bool m_active{false};                       ///< True between start() and stop().
+    CaptureFormat m_format{CaptureFormat::PNG}; ///< Output format.
+    std::string m_path;                         ///< Output directory, raw file or pipe command.
+    std::FILE *m_rawFile{nullptr};              ///< Raw output stream.
+    bool m_rawPipe{false};                      ///< True if m_rawFile was opened with popen().
+    int m_nextIndex{0};                         ///< Output index of the next queued frame.
+
+    size_t m_capturedFrames{0}; ///< Frames queued for encoding.
+    size_t m_droppedFrames{0};  ///< Frames dropped because the ring or queue was full.
+    size_t m_writtenFrames{0};  ///< Frames written by the encoders.
+    size_t m_peakQueueDepth{0}; ///< Highest queue depth seen.
+
+    void collect(bool wait);
+    void enqueue(Slot &slot);
+    void workerLoop();
+    void write(Job &job);
+
+public:
+    FrameCapture();
+    virtual ~FrameCapture();
+
+    /**
+     * @brief Factory method to create a shared pointer to a FrameCapture instance.
+     * @return std::shared_ptr<FrameCapture> New FrameCapture instance.
+     */
+    static std::shared_ptr<FrameCapture> create();
+
+    /**
+     * @brief Start recording.
+     * @param path Output directory for PNG/QOI (must exist), or file or '|command' for raw output.
+     * @param format Output format.
+     * @return bool True if recording started.
+     */
+    bool start(const std::string &path, CaptureFormat format = CaptureFormat::PNG);
+
+    /**
+     * @brief Stop recording, read back pending frames and wait until all queued frames are written.
+     */
+    void stop();
+
+    /**
+     * @brief Check if recording is active.
+     * @return bool True between start() and stop().
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Capture the lower-left region of the current read framebuffer.
+     *
+     * Also hands completed read-backs of earlier frames to the encoders.
+     * @param width Region width in pixels.
+     * @param height Region height in pixels.
+     * @param copies Number of consecutive output frames this frame stands for.
+     */
+    void capture(int width, int height, int copies = 1);
+
+    /**
+     * @brief Set the number of pixel buffer objects in the ring (takes effect on start()).
+     * @param size Ring size, at least 2.
+     */
+    void setRingSize(int size);
+
+    /**
+     * @brief Get the ring size.
+     * @return int Number of pixel buffer objects.
+     */
+    int ringSize() const;
+
+    /**
+     * @brief Set the number of encoder threads (takes effect on start()).
+     * @param count Thread count, 0 for half the hardware threads (at most 4).
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * @brief Get the requested number of encoder threads.
+     * @return int Thread count, 0 if automatic.
+     */
+    int workerCount() const;
+
+    /**
+     * @brief Set the number of frames that may wait for an encoder before new frames are dropped.
+     * @param depth Maximum queue depth.
+     */
+    void setMaxQueueDepth(size_t depth);
+
+    /**
+     * @brief Get the maximum queue depth.
+     * @return size_t Maximum queue depth.
+     */
+    size_t maxQueueDepth() const;
+
+    /**
+     * @brief Choose between dropping frames and waiting when the ring or queue is full.
+     *
+     * Waiting keeps every frame, which is what offline and headless rendering want, at the cost
+     * of stalling the render loop when the encoders cannot keep up.
+     * @param flag True to drop frames (default), false to wait.
+     */
+    void setAllowDrops(bool flag);
+
+    /**
+     * @brief Check if frames are dropped when full.
+     * @return bool True if frames are dropped.
+     */
+    bool allowDrops() const;
+
+    /**
+     * @brief Decode every QOI frame again and log an error if it differs from the captured pixels.
+     *
+     * A debugging aid that roughly doubles the encoding cost. Set before start().
+     * @param flag True to verify the encoded frames.
+     */
+    void setVerifyQOI(bool flag);
+
+    /**
+     * @brief Check if QOI frames are verified.
+     * @return bool True if verified.
+     */
+    bool verifyQOI() const;
+
+    /**
+     * @brief Get the number of frames currently waiting for an encoder.
+     * @return size_t Queue depth.
+     */
+    size_t queueDepth();
+
+    /**
+     * @brief Get the highest queue depth since start().
+     * @return size_t Peak queue depth.
+     */
+    size_t peakQueueDepth();
+
+    /**
+     * @brief Get the number of frames queued for encoding since start().
+     * @return size_t Captured frames.
+     */
+    size_t capturedFrames();
+
+    /**
+     * @brief Get the number of frames dropped since start().
+     * @return size_t Dropped frames.
+     */
+    size_t droppedFrames();
+
+    /**
+     * @brief Get the number of frames written since start().
+     * @return size_t Written frames.
+     */
+    size_t writtenFrames();
+
+    /**
+     * @brief Encode RGB8 pixels as a QOI image.
+     * @param pixels Top-down RGB8 pixels.
+     * @param width Image width.
+     * @param height Image height.
+     * @return std::vector<unsigned char> Encoded file contents.
+     */
+    static std::vector<unsigned char> encodeQOI(const unsigned char *pixels, int width, int height);
+
+    /**
+     * @brief Decode a QOI image to RGB8 pixels, dropping alpha.
+     * @param data Encoded file contents.
+     * @param pixels Receives the top-down RGB8 pixels.
+     * @param width Receives the image width.
+     * @param height Receives the image height.
+     * @return bool True if the data was a complete QOI image.
+     */
+    static bool decodeQOI(const std::vector<unsigned char> &data, std::vector<unsigned char> &pixels, int &width,
+                          int &height);
+};
+
+/**
+ * @typedef FrameCapturePtr
+ * @brief Shared pointer type for FrameCapture.
+ */
+typedef std::shared_ptr<FrameCapture> FrameCapturePtr;
+
+}; // namespace ivf
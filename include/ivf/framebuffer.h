@@ -2,6 +2,7 @@
 
 #include <ivf/gl.h>
 #include <ivf/texture.h>
+#include <ivf/render_target.h>
 
 namespace ivf {
 
@@ -13,17 +14,14 @@ namespace ivf {
  * framebuffer objects (FBOs), including support for multisampling, color and depth attachments,
  * and rendering to textures. It provides methods for resizing, binding, drawing, and checking
  * framebuffer status, making it suitable for advanced rendering techniques and post-processing.
+ *
+ * The attachments are render targets held from the RenderTargetPool. They are exchanged lazily in
+ * begin() when the size or sample settings have changed, so resize() itself does not allocate.
  */
 class FrameBuffer : public GLBase {
 private:
-    GLuint m_frameBuffer;             ///< Main framebuffer object.
-    GLuint m_multisampledFrameBuffer; ///< Multisampled framebuffer object.
-
-    GLuint m_depthBuffer;             ///< Depth buffer attachment.
-    GLuint m_multisampledDepthBuffer; ///< Multisampled depth buffer attachment.
-
-    GLuint m_colorTexture;             ///< Color texture attachment.
-    GLuint m_multisampledColorTexture; ///< Multisampled color texture attachment.
+    RenderTargetPtr m_target;             ///< Single-sampled target (resolve target when multisampling).
+    RenderTargetPtr m_multisampledTarget; ///< Multisampled target.
 
     GLuint m_quadVAO; ///< Vertex array object for screen quad.
     GLuint m_quadVBO; ///< Vertex buffer object for screen quad.
@@ -34,6 +32,8 @@ private:
     int m_width;  ///< Framebuffer width in pixels.
     int m_height; ///< Framebuffer height in pixels.
 
+    void updateTargets();
+
 public:
     /**
      * @brief Constructor.
@@ -66,14 +66,14 @@ public:
     void initialize();
 
     /**
-     * @brief Resize the framebuffer and its attachments.
+     * @brief Resize the framebuffer (the attachments are reallocated on the next begin()).
      * @param width New width in pixels.
      * @param height New height in pixels.
      */
     void resize(int width, int height);
 
     /**
-     * @brief Release all framebuffer resources.
+     * @brief Return the attachments to the pool and delete the screen quad.
      */
     void drop();
 
@@ -87,33 +87,6 @@ public:
      */
     void unbind();
 
-    /**
-     * @brief Attach a color texture to the framebuffer.
-     * @param texture Reference to the texture ID.
-     */
-    void attachColorTexture(GLuint &texture);
-
-    /**
-     * @brief Attach a depth buffer to the framebuffer.
-     * @param buffer Reference to the buffer ID.
-     */
-    void attachDepthBuffer(GLuint &buffer);
-
-    /**
-     * @brief Attach a multisampled color texture to the framebuffer.
-     */
-    void attachMultisampledColorTexture();
-
-    /**
-     * @brief Attach a multisampled depth buffer to the framebuffer.
-     */
-    void attachMultisampledDepthBuffer();
-
-    /**
-     * @brief Attach a multisampled stencil buffer to the framebuffer.
-     */
-    void attachMultisampledStencilBuffer();
-
     /**
      * @brief Enable or disable multisampling.
      * @param multisample True to enable, false to disable.
@@ -17,6 +17,14 @@ namespace ivf {
  * displacement function to each vertex. The function can be customized to produce effects
  * such as waves, ripples, turbulence, spirals, twirls, and gravity wells. Supports scaling,
  * offset, local/world space, and time-based animation.
+ *
+ * The function may read state captured from outside, e.g. an animation clock, so by default the
+ * deformer reports a new revision() on every query and is evaluated on every update. Functions that
+ * only depend on the position and the deformer parameters can be marked with setCacheable(), so
+ * that unchanged frames skip the evaluation.
+ *
+ * The function is called serially unless it is marked with setThreadSafe(), which lets a fused
+ * DeformerStack call it from several ThreadPool workers at once.
  */
 class FunctionDeformer : public Deformer {
 public:
@@ -31,6 +39,8 @@ private:
     glm::vec3 m_offset;                          ///< Offset added to input coordinates.
     bool m_useLocalSpace;                        ///< Whether to apply function in local or world space.
     float m_time;                                ///< Time parameter for animated functions.
+    bool m_cacheable{false};                     ///< Whether the result only changes with the parameters.
+    bool m_threadSafe{false};                    ///< Whether the function may be called concurrently.
 
 public:
     /**
@@ -117,11 +127,63 @@ public:
      */
     float time() const;
 
+    /**
+     * @brief Declare whether the function only depends on the position and the deformer parameters.
+     *
+     * Cacheable deformers keep their revision until a setter is called, so deformed meshes are only
+     * evaluated again after a change. Functions reading other state must stay non-cacheable or be
+     * followed by DeformableMeshNode::invalidateDeformation() when that state changes.
+     * @param cacheable True if the result only changes with the parameters.
+     */
+    void setCacheable(bool cacheable);
+
+    /**
+     * @brief Check if the function only depends on the position and the deformer parameters.
+     * @return bool True if cacheable.
+     */
+    bool cacheable() const;
+
+    /**
+     * @brief Get the revision of the deformer parameters.
+     * @return uint64_t Current revision if cacheable, otherwise a new revision on every call.
+     */
+    virtual uint64_t revision() const override;
+
+    /**
+     * @brief Declare whether the function may be called from several threads at once.
+     *
+     * Thread safe functions are evaluated in the fused, parallel pass of DeformerStack. They must
+     * not modify shared state, e.g. a captured random generator or counter.
+     * @param threadSafe True if the function may be called concurrently.
+     */
+    void setThreadSafe(bool threadSafe);
+
+    /**
+     * @brief Check if the function may be called from several threads at once.
+     * @return bool True if thread safe.
+     */
+    bool threadSafe() const;
+
     /**
      * @brief Apply the displacement function to the mesh vertices.
      */
     virtual void apply() override;
 
+    /**
+     * @brief Prepare a fused evaluation pass.
+     * @param vertexCount Number of vertices of the pass.
+     * @return True if the function is thread safe, otherwise apply() is used.
+     */
+    virtual bool prepareKernel(GLuint vertexCount) override;
+
+    /**
+     * @brief Displace a block of positions in place.
+     * @param positions Positions of the block.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const override;
+
     /**
      * @brief Clone the deformer (for animation keyframes, etc.).
      * @return std::unique_ptr<Deformer> Cloned deformer.
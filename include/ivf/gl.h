@@ -22,11 +22,15 @@
 #include <ivf/transform_manager.h>
 #include <ivf/texture_manager.h>
 #include <ivf/utils.h>
+#include <ivf/gl_diagnostics.h>
+#include <ivf/thread_pool.h>
+#include <ivf/light_clusters.h>
 #include <ivf/light_manager.h>
 #include <ivf/normal_factory.h>
 #include <ivf/texture.h>
 #include <ivf/material.h>
 #include <ivf/font_manager.h>
+#include <ivf/glyph_atlas.h>
 #include <ivf/selection_manager.h>
 #include <ivf/buffer_selection.h>
 #include <ivf/camera.h>
@@ -0,0 +1,292 @@
+#pragma once
+
+/**
+ * @file gl_diagnostics.h
+ * @brief OpenGL diagnostics using KHR_debug output callbacks and optional per-call error queries.
+ */
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @def IVF_GL_DIAGNOSTICS
+ * @brief Defined when per-call OpenGL diagnostics (GL_ERR checks, debug groups) are compiled in.
+ *
+ * Enabled automatically in debug builds. Define IVF_GL_DIAGNOSTICS (CMake option of the same name)
+ * to force it on in other configurations, or IVF_NO_GL_DIAGNOSTICS to force it off. When it is not
+ * defined GL_ERR() expands to the bare OpenGL call.
+ */
+#if defined(_DEBUG) && !defined(IVF_NO_GL_DIAGNOSTICS) && !defined(IVF_GL_DIAGNOSTICS)
+#define IVF_GL_DIAGNOSTICS
+#endif
+
+namespace ivf {
+
+/**
+ * @enum GLDiagnosticsMode
+ * @brief Runtime diagnostics mode.
+ */
+enum class GLDiagnosticsMode {
+    Off,          ///< No error reporting at all.
+    DebugOutput,  ///< Errors reported asynchronously through the KHR_debug message callback.
+    ErrorQueries, ///< Legacy glGetError() round-trips around every GL_ERR() statement.
+};
+
+/**
+ * @enum GLDebugSeverity
+ * @brief Minimum severity of debug messages that are reported.
+ */
+enum class GLDebugSeverity {
+    Notification, ///< Report everything, including driver notifications.
+    Low,          ///< Report low, medium and high severity messages.
+    Medium,       ///< Report medium and high severity messages.
+    High          ///< Report only high severity messages.
+};
+
+/**
+ * @class GLDiagnostics
+ * @brief Singleton class for OpenGL error reporting.
+ *
+ * GLDiagnostics installs a glDebugMessageCallback() hook when the context supports KHR_debug
+ * (OpenGL 4.3+), filters messages by severity and message id, and tags every reported message with
+ * the innermost diagnostics context pushed with pushContext() or GLDebugScope. When debug output is
+ * not available it falls back to glGetError() queries in GL_ERR().
+ *
+ * validateFrame() requests a one-shot validation frame: during the next beginFrame()/endFrame()
+ * pair debug output is made synchronous and error queries are enabled, after which the previous
+ * settings are restored and a summary is logged.
+ *
+ * With asynchronous debug output the driver may invoke the callback from its own thread. The
+ * filters and the context stack read by the callback are guarded by a mutex and the counters are
+ * atomic. Messages can arrive after the offending call has returned, so the context tag is only
+ * exact with synchronous output.
+ */
+class GLDiagnostics {
+private:
+    GLDiagnosticsMode m_mode;                  ///< Requested diagnostics mode.
+    GLDebugSeverity m_minSeverity;             ///< Minimum reported severity.
+    std::set<GLuint> m_ignoredIds;             ///< Message ids that are never reported.
+    std::vector<std::string> m_contextStack;   ///< Stack of context tags.
+    mutable std::mutex m_mutex;                ///< Guards the state read by the debug callback.
+    std::vector<bool> m_contextGroups;         ///< True for tags that pushed a GL debug group.
+    bool m_installed{false};                   ///< True when install() has run on a context.
+    bool m_debugOutputAvailable{false};        ///< True if the context supports KHR_debug.
+    bool m_synchronous{false};                 ///< Synchronous debug output (exact call sites).
+    bool m_validateNextFrame{false};           ///< One-shot validation requested.
+    bool m_validatingFrame{false};             ///< Current frame is a validation frame.
+    std::atomic<std::size_t> m_messageCount{0};      ///< Reported messages since start.
+    std::atomic<std::size_t> m_frameMessageCount{0}; ///< Reported messages in the current frame.
+    std::atomic<std::size_t> m_suppressedCount{0};   ///< Messages dropped by filters since start.
+
+    static bool m_errorQueries;                ///< Fast flag checked by GL_ERR().
+    static GLDiagnostics *m_instance;          ///< Singleton instance pointer.
+
+    GLDiagnostics(); ///< Private constructor for singleton pattern.
+
+    void applyMode();
+    void applyFilters();
+    void handleMessage(GLenum source, GLenum type, GLuint id, GLenum severity, const char *message);
+
+    static void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                       [[maybe_unused]] GLsizei length, const GLchar *message,
+                                       const void *userParam);
+
+public:
+    /**
+     * @brief Get the singleton instance of GLDiagnostics.
+     * @return GLDiagnostics* Pointer to the singleton instance.
+     */
+    static GLDiagnostics *instance();
+
+    /**
+     * @brief Create the singleton instance of GLDiagnostics (if not already created).
+     * @return GLDiagnostics* Pointer to the singleton instance.
+     */
+    static GLDiagnostics *create();
+
+    /**
+     * @brief Destroy the singleton instance.
+     */
+    static void drop();
+
+    /**
+     * @brief Check if GL_ERR() should issue glGetError() queries.
+     *
+     * Only consulted in builds with IVF_GL_DIAGNOSTICS defined.
+     * @return bool True if error queries are active.
+     */
+    static bool errorQueriesEnabled()
+    {
+        return m_errorQueries;
+    }
+
+    /**
+     * @brief Install the debug callback on the current OpenGL context.
+     *
+     * Must be called after the OpenGL function pointers have been loaded.
+     */
+    void install();
+
+    /**
+     * @brief Check if the current context supports KHR_debug output.
+     * @return bool True if debug output is available.
+     */
+    bool debugOutputAvailable() const;
+
+    /**
+     * @brief Set the diagnostics mode.
+     *
+     * DebugOutput falls back to ErrorQueries if the context lacks KHR_debug.
+     * @param mode Diagnostics mode.
+     */
+    void setMode(GLDiagnosticsMode mode);
+
+    /**
+     * @brief Get the requested diagnostics mode.
+     * @return GLDiagnosticsMode Current mode.
+     */
+    GLDiagnosticsMode mode() const;
+
+    /**
+     * @brief Set the minimum severity of reported messages.
+     * @param severity Minimum severity.
+     */
+    void setMinSeverity(GLDebugSeverity severity);
+
+    /**
+     * @brief Get the minimum severity of reported messages.
+     * @return GLDebugSeverity Minimum severity.
+     */
+    GLDebugSeverity minSeverity() const;
+
+    /**
+     * @brief Never report messages with the given id (e.g. noisy driver performance hints).
+     * @param id Driver message id.
+     */
+    void ignoreMessageId(GLuint id);
+
+    /**
+     * @brief Remove all ignored message ids.
+     */
+    void clearIgnoredIds();
+
+    /**
+     * @brief Enable or disable synchronous debug output.
+     *
+     * Synchronous output reports messages from within the offending call at a performance cost.
+     * @param flag True for synchronous output.
+     */
+    void setSynchronous(bool flag);
+
+    /**
+     * @brief Check if synchronous debug output is enabled.
+     * @return bool True if synchronous.
+     */
+    bool synchronous() const;
+
+    /**
+     * @brief Push a context tag that is attached to reported messages.
+     * @param name Context name (e.g. "ShadowPass").
+     */
+    void pushContext(const std::string &name);
+
+    /**
+     * @brief Pop the innermost context tag.
+     */
+    void popContext();
+
+    /**
+     * @brief Get the innermost context tag.
+     * @return std::string Context name, or an empty string.
+     */
+    std::string currentContext() const;
+
+    /**
+     * @brief Request a one-shot validation of the next frame.
+     */
+    void validateFrame();
+
+    /**
+     * @brief Check if the current frame is a validation frame.
+     * @return bool True while validating.
+     */
+    bool isValidatingFrame() const;
+
+    /**
+     * @brief Mark the start of a frame. Called by the window before rendering.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Mark the end of a frame. Called by the window before swapping buffers.
+     */
+    void endFrame();
+
+    /**
+     * @brief Get the number of reported messages since start.
+     * @return std::size_t Message count.
+     */
+    std::size_t messageCount() const;
+
+    /**
+     * @brief Get the number of reported messages in the current frame.
+     * @return std::size_t Message count.
+     */
+    std::size_t frameMessageCount() const;
+
+    /**
+     * @brief Get the number of messages dropped by filters since start.
+     * @return std::size_t Suppressed message count.
+     */
+    std::size_t suppressedCount() const;
+};
+
+/**
+ * @typedef GLDiagnosticsPtr
+ * @brief Pointer type for GLDiagnostics singleton.
+ */
+typedef GLDiagnostics *GLDiagnosticsPtr;
+
+/**
+ * @class GLDebugScope
+ * @brief RAII helper that pushes a diagnostics context (and GL debug group) for its lifetime.
+ *
+ * Compiles to nothing when IVF_GL_DIAGNOSTICS is not defined.
+ */
+class GLDebugScope {
+public:
+#ifdef IVF_GL_DIAGNOSTICS
+    explicit GLDebugScope(const std::string &name)
+    {
+        GLDiagnostics::instance()->pushContext(name);
+    }
+
+    ~GLDebugScope()
+    {
+        GLDiagnostics::instance()->popContext();
+    }
+#else
+    template <typename T> explicit GLDebugScope(const T &)
+    {}
+#endif
+
+    GLDebugScope(const GLDebugScope &) = delete;
+    GLDebugScope &operator=(const GLDebugScope &) = delete;
+};
+
+}; // namespace ivf
+
+#define IVF_GL_SCOPE_CONCAT_INNER(a, b) a##b
+#define IVF_GL_SCOPE_CONCAT(a, b) IVF_GL_SCOPE_CONCAT_INNER(a, b)
+
+/**
+ * @def IVF_GL_SCOPE(name)
+ * @brief Tag OpenGL diagnostics messages in the enclosing block with @p name.
+ */
+#define IVF_GL_SCOPE(name) ivf::GLDebugScope IVF_GL_SCOPE_CONCAT(_ivfGlScope, __LINE__)(name)
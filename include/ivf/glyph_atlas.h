@@ -0,0 +1,174 @@
+#pragma once
+
+#include <ivf/glbase.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace ivf {
+
+/**
+ * @struct GlyphInfo
+ * @brief Placement and metrics of a glyph in a GlyphAtlas, in atlas pixels.
+ */
+struct GlyphInfo {
+    glm::ivec2 atlasPos{0}; ///< Atlas position of the first (top) bitmap row.
+    glm::ivec2 size{0};     ///< Size of the glyph bitmap (including the SDF spread).
+    glm::ivec2 bearing{0};  ///< Offset from the pen position to the left/top of the bitmap.
+    float advance{0.0f};    ///< Horizontal offset to the next glyph.
+    float height{0.0f};     ///< Height of the glyph outline, without padding.
+};
+
+/**
+ * @class GlyphAtlas
+ * @brief Growable single-channel texture holding the rasterized glyphs of one face and pixel size.
+ *
+ * Glyphs are rasterized on first use and packed into shelves (rows of glyphs sharing a height).
+ * When the atlas is full its texture is enlarged, up to maxSize() in each direction; existing
+ * glyphs keep their pixel positions, but their texture coordinates change, which is signaled by
+ * an increased generation(). Atlases are shared by all text using the same face and size and are
+ * obtained from FontManager::atlas().
+ *
+ * With signed distance field glyphs (requires FreeType 2.11 or later) the texture stores the
+ * distance to the outline instead of coverage, 0.5 being the edge, so that text stays sharp at any
+ * scale from a moderate pixel size.
+ */
+class GlyphAtlas : public GLBase {
+private:
+    FT_Face m_face;  ///< Face the glyphs are rasterized from.
+    int m_pixelSize; ///< Nominal pixel size of the glyphs.
+    bool m_sdf;      ///< True if glyphs are rendered as signed distance fields.
+
+    GLuint m_texture{0};                 ///< Atlas texture (GL_R8).
+    int m_width{512};                    ///< Atlas width in pixels.
+    int m_height{512};                   ///< Atlas height in pixels.
+    int m_maxSize{4096};                 ///< Largest width or height the atlas grows to.
+    std::vector<unsigned char> m_pixels; ///< CPU copy of the atlas, used when growing.
+
+    int m_shelfX{0};      ///< Next free x position on the current shelf.
+    int m_shelfY{0};      ///< Bottom of the current shelf.
+    int m_shelfHeight{0}; ///< Height of the current shelf.
+
+    std::unordered_map<char32_t, GlyphInfo> m_glyphs; ///< Rasterized glyphs by code point.
+    unsigned int m_generation{0};                     ///< Incremented when the texture is resized.
+
+    bool allocate(int width, int height, glm::ivec2 &pos);
+    bool grow();
+
+public:
+    /**
+     * @brief Constructor.
+     * @param face FreeType face to rasterize glyphs from.
+     * @param pixelSize Nominal glyph size in pixels.
+     * @param sdf True to store signed distance fields instead of coverage.
+     */
+    GlyphAtlas(FT_Face face, int pixelSize, bool sdf = false);
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~GlyphAtlas();
+
+    /**
+     * @brief Factory method to create a shared pointer to a GlyphAtlas instance.
+     * @param face FreeType face to rasterize glyphs from.
+     * @param pixelSize Nominal glyph size in pixels.
+     * @param sdf True to store signed distance fields instead of coverage.
+     * @return std::shared_ptr<GlyphAtlas> New GlyphAtlas instance.
+     */
+    static std::shared_ptr<GlyphAtlas> create(FT_Face face, int pixelSize, bool sdf = false);
+
+    /**
+     * @brief Get a glyph, rasterizing and packing it if needed.
+     * @param codepoint Unicode code point.
+     * @return const GlyphInfo* Glyph placement and metrics, nullptr if the face has no such glyph.
+     */
+    const GlyphInfo *glyph(char32_t codepoint);
+
+    /**
+     * @brief Bind the atlas texture to the active texture unit.
+     */
+    void bind();
+
+    /**
+     * @brief Get the atlas texture.
+     * @return GLuint Texture name, 0 before the first glyph is added.
+     */
+    GLuint texture() const;
+
+    /**
+     * @brief Get the atlas width.
+     * @return int Width in pixels.
+     */
+    int width() const;
+
+    /**
+     * @brief Get the atlas height.
+     * @return int Height in pixels.
+     */
+    int height() const;
+
+    /**
+     * @brief Set the largest width or height the atlas may grow to.
+     * @param size Size in pixels.
+     */
+    void setMaxSize(int size);
+
+    /**
+     * @brief Get the largest atlas size.
+     * @return int Size in pixels.
+     */
+    int maxSize() const;
+
+    /**
+     * @brief Get the nominal glyph pixel size.
+     * @return int Pixel size.
+     */
+    int pixelSize() const;
+
+    /**
+     * @brief Check if the atlas stores signed distance fields.
+     * @return bool True for distance field glyphs.
+     */
+    bool sdf() const;
+
+    /**
+     * @brief Get the number of glyphs in the atlas.
+     * @return size_t Glyph count.
+     */
+    size_t glyphCount() const;
+
+    /**
+     * @brief Get the resize counter; texture coordinates computed for an older value are stale.
+     * @return unsigned int Generation.
+     */
+    unsigned int generation() const;
+
+    /**
+     * @brief Check if the FreeType library supports signed distance field rendering.
+     * @return bool True if available.
+     */
+    static bool sdfSupported();
+
+    /**
+     * @brief Decode a UTF-8 string to code points. Invalid sequences become U+FFFD.
+     * @param text UTF-8 encoded text.
+     * @return std::u32string Code points.
+     */
+    static std::u32string decodeUtf8(const std::string &text);
+};
+
+/**
+ * @typedef GlyphAtlasPtr
+ * @brief Shared pointer type for GlyphAtlas.
+ */
+typedef std::shared_ptr<GlyphAtlas> GlyphAtlasPtr;
+
+}; // namespace ivf
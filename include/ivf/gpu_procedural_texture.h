@@ -20,12 +20,17 @@ namespace ivf {
  * This class uses render-to-texture (RTT) to generate procedural patterns
  * using fragment shaders. The generated texture can be used like any normal
  * texture in the rendering pipeline.
+ *
+ * Generation renders into a transient target acquired from the RenderTargetPool and copies the
+ * result into this texture, so textures of equal size share one framebuffer instead of each
+ * keeping its own. The texture storage is only reallocated when the size changes.
  */
 class GPUProceduralTexture : public Texture {
 protected:
     int m_width{512};                      ///< Texture width in pixels.
     int m_height{512};                     ///< Texture height in pixels.
-    GLuint m_fbo{0};                       ///< Framebuffer object for rendering.
+    int m_allocatedWidth{0};               ///< Width of the allocated texture storage.
+    int m_allocatedHeight{0};              ///< Height of the allocated texture storage.
     GLuint m_quadVAO{0};                   ///< Vertex array object for fullscreen quad.
     GLuint m_quadVBO{0};                   ///< Vertex buffer object for quad vertices.
     GLuint m_quadEBO{0};                   ///< Element buffer object for quad indices.
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <ivf/glbase.h>
+#include <ivf/point_light.h>
+#include <ivf/spot_light.h>
+#include <ivf/program.h>
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ivf {
+
+/**
+ * @struct ClusterLightData
+ * @brief GPU representation of a point or spot light in the clustered light buffer (std430).
+ */
+struct ClusterLightData {
+    glm::vec4 positionRange;    ///< xyz world position, w influence range.
+    glm::vec4 directionType;    ///< xyz spot direction, w type (0 = point, 1 = spot).
+    glm::vec4 diffuseConstant;  ///< rgb diffuse color, a constant attenuation.
+    glm::vec4 specularLinear;   ///< rgb specular color, a linear attenuation.
+    glm::vec4 ambientQuadratic; ///< rgb ambient color, a quadratic attenuation.
+    glm::vec4 spotCutoff;       ///< x cos(inner cutoff), y cos(outer cutoff).
+};
+
+/**
+ * @class LightClusters
+ * @brief Clustered forward lighting: assigns point and spot lights to view-space froxel clusters.
+ *
+ * The view frustum is divided into a grid of clusters (tiles in screen space times exponential
+ * depth slices). Every frame the lights are converted to a compact buffer, each light's bounding
+ * sphere is mapped to the range of clusters it overlaps, and per-cluster light lists are built in
+ * parallel on the ThreadPool (one task per depth slice). The result is uploaded to three shader
+ * storage buffers that the clustered variant of the basic shader reads:
+ *
+ * - binding 0: ClusterLightData array
+ * - binding 1: per-cluster (offset, count) pairs
+ * - binding 2: light index list
+ *
+ * Requires OpenGL 4.3 (shader storage buffers).
+ */
+class LightClusters : public GLBase {
+private:
+    glm::uvec3 m_dims{16, 9, 24};        ///< Cluster grid dimensions (x tiles, y tiles, depth slices).
+    float m_attenuationThreshold{0.004f}; ///< Attenuation below which a light is considered out of range.
+    float m_near{0.1f};                  ///< Near plane extracted from the projection.
+    float m_far{100.0f};                 ///< Far plane extracted from the projection.
+    bool m_perspective{true};            ///< True for perspective projections (log depth slicing).
+
+    std::vector<ClusterLightData> m_lights; ///< Packed lights.
+    std::vector<glm::uvec2> m_grid;         ///< Per-cluster (offset, count).
+    std::vector<GLuint> m_indices;          ///< Light index lists.
+
+    GLuint m_lightSSBO{0};           ///< Light buffer.
+    GLuint m_gridSSBO{0};            ///< Cluster grid buffer.
+    GLuint m_indexSSBO{0};           ///< Light index buffer.
+    size_t m_lightCapacity{0};       ///< Allocated light buffer size in bytes.
+    size_t m_gridCapacity{0};        ///< Allocated grid buffer size in bytes.
+    size_t m_indexCapacity{0};       ///< Allocated index buffer size in bytes.
+
+    double m_assignTime{0.0};        ///< Duration of the last assign() call in milliseconds.
+    GLuint m_maxClusterLights{0};    ///< Highest light count in a single cluster in the last assign().
+
+    int depthSlice(float depth) const;
+
+    static void uploadBuffer(GLuint &buffer, size_t &capacity, const void *data, size_t size);
+
+public:
+    LightClusters();
+    virtual ~LightClusters();
+
+    /**
+     * @brief Factory method to create a shared pointer to a LightClusters instance.
+     * @return std::shared_ptr<LightClusters> New LightClusters instance.
+     */
+    static std::shared_ptr<LightClusters> create();
+
+    /**
+     * @brief Check if the current context supports clustered lighting (OpenGL 4.3+).
+     * @return bool True if supported.
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Set the cluster grid dimensions.
+     * @param x Number of horizontal tiles.
+     * @param y Number of vertical tiles.
+     * @param z Number of depth slices.
+     */
+    void setGridSize(unsigned int x, unsigned int y, unsigned int z);
+
+    /**
+     * @brief Get the cluster grid dimensions.
+     * @return glm::uvec3 Grid dimensions.
+     */
+    glm::uvec3 gridSize() const;
+
+    /**
+     * @brief Set the attenuation threshold used to derive a finite range for each light.
+     * @param threshold Attenuation (relative to the light's peak intensity) treated as zero.
+     */
+    void setAttenuationThreshold(float threshold);
+
+    /**
+     * @brief Get the attenuation threshold.
+     * @return float Threshold.
+     */
+    float attenuationThreshold() const;
+
+    /**
+     * @brief Compute the distance at which a light's attenuation falls below the threshold.
+     * @param constant Constant attenuation.
+     * @param linear Linear attenuation.
+     * @param quadratic Quadratic attenuation.
+     * @param intensity Peak color intensity of the light.
+     * @param threshold Attenuation threshold.
+     * @return float Range, or a negative value if the light never falls below the threshold.
+     */
+    static float lightRange(float constant, float linear, float quadratic, float intensity, float threshold);
+
+    /**
+     * @brief Pack the enabled lights into the light buffer.
+     * @param pointLights Point lights.
+     * @param spotLights Spot lights.
+     */
+    void setLights(const std::vector<PointLightPtr> &pointLights, const std::vector<SpotLightPtr> &spotLights);
+
+    /**
+     * @brief Assign the packed lights to clusters for the given camera (CPU, parallel).
+     * @param view View matrix.
+     * @param projection Projection matrix.
+     */
+    void assign(const glm::mat4 &view, const glm::mat4 &projection);
+
+    /**
+     * @brief Upload lights, grid and index lists to the shader storage buffers.
+     */
+    void upload();
+
+    /**
+     * @brief Bind the storage buffers and set the cluster uniforms on a program.
+     * @param program Program using the clustered lighting path.
+     * @param viewport Viewport (x, y, width, height) the clusters map to.
+     */
+    void bind(ProgramPtr program, const glm::ivec4 &viewport);
+
+    /**
+     * @brief Get the number of packed lights.
+     * @return size_t Light count.
+     */
+    size_t lightCount() const;
+
+    /**
+     * @brief Get the total number of light references over all clusters.
+     * @return size_t Index count.
+     */
+    size_t indexCount() const;
+
+    /**
+     * @brief Get the highest light count in a single cluster.
+     * @return GLuint Light count.
+     */
+    GLuint maxClusterLights() const;
+
+    /**
+     * @brief Get the duration of the last assign() in milliseconds.
+     * @return double Duration.
+     */
+    double assignTime() const;
+
+    /**
+     * @brief Get the per-cluster (offset, count) table of the last assign().
+     * @return const std::vector<glm::uvec2>& Grid.
+     */
+    const std::vector<glm::uvec2> &grid() const;
+
+    /**
+     * @brief Get the light index lists of the last assign().
+     * @return const std::vector<GLuint>& Indices.
+     */
+    const std::vector<GLuint> &indices() const;
+};
+
+/**
+ * @typedef LightClustersPtr
+ * @brief Shared pointer type for LightClusters.
+ */
+typedef std::shared_ptr<LightClusters> LightClustersPtr;
+
+}; // namespace ivf
@@ -7,6 +7,8 @@
 #include <ivf/point_light.h>
 #include <ivf/spot_light.h>
 #include <ivf/composite_node.h>
+#include <ivf/light_clusters.h>
+#include <ivf/shadow_caster_tracker.h>
 
 #include <string>
 #include <vector>
@@ -57,9 +59,22 @@ private:
     BoundingBox m_sceneBBox;    ///< Scene bounding box for shadow mapping.
     int m_debugShadow{0};       ///< Debug flag for shadow rendering.
 
+    // Shadow map caching
+    ShadowCasterTracker m_casterTracker; ///< Detects moved shadow casters between frames.
+    bool m_shadowCaching{false};         ///< Whether unchanged shadow maps are reused.
+    bool m_shadowsInvalid{true};         ///< Forces all shadow maps to be re-rendered next frame.
+    int m_shadowPassesRendered{0};       ///< Shadow passes rendered in the last frame.
+    int m_shadowPassesSkipped{0};        ///< Shadow passes reused from the cache in the last frame.
+
+    // Clustered forward lighting
+    bool m_useClusteredLighting{false}; ///< Whether point/spot lights use the clustered path.
+    LightClustersPtr m_lightClusters;   ///< Cluster assignment and light buffers.
+
     LightManager();                  ///< Private constructor for singleton pattern.
     static LightManager *m_instance; ///< Singleton instance pointer.
 
+    void applyShadowMaps();
+
 public:
     /**
      * @brief Get the singleton instance of the LightManager.
@@ -206,12 +221,82 @@ public:
      */
     void apply();
 
+    /**
+     * @brief Enable or disable clustered forward lighting for point and spot lights.
+     *
+     * When enabled, the basic shader is replaced by its clustered variant which reads lights from
+     * storage buffers instead of the fixed-size uniform arrays, lifting the 8 point / 8 spot light
+     * limit. Requires OpenGL 4.3; the call is ignored with a warning otherwise.
+     * @param flag True to enable, false to return to the uniform-array path.
+     */
+    void setUseClusteredLighting(bool flag);
+
+    /**
+     * @brief Check if clustered forward lighting is enabled.
+     * @return bool True if enabled.
+     */
+    bool useClusteredLighting() const;
+
+    /**
+     * @brief Get the light cluster object (grid settings and statistics).
+     * @return LightClustersPtr Light clusters.
+     */
+    LightClustersPtr lightClusters();
+
+    /**
+     * @brief Assign lights to clusters for the current camera and upload the light buffers.
+     *
+     * Called once per frame before the scene is drawn. Does nothing unless clustered lighting is
+     * enabled.
+     */
+    void updateClusters();
+
     /**
      * @brief Render shadow maps for all lights in the scene.
+     *
+     * With shadow caching enabled, a shadow map (or cascade) is only re-rendered when a node
+     * inside its volume moved, the light changed, or the camera moved far enough to require
+     * refitting a cascade.
      * @param scene Shared pointer to the scene's composite node.
      */
     void renderShadowMaps(CompositeNodePtr scene);
 
+    /**
+     * @brief Enable or disable reuse of unchanged shadow maps between frames.
+     *
+     * Changes are detected from the transforms, bounding boxes and content revisions of the
+     * transform nodes in the scene. Geometry updated in place without a content revision, such as
+     * DynamicMesh, LineTrace or ParticleSystem, is not seen and needs invalidateShadowMaps() after
+     * each update, so caching is off by default.
+     * @param flag True to enable caching, false to render all shadow maps every frame (default).
+     */
+    void setShadowCaching(bool flag);
+
+    /**
+     * @brief Check if shadow map caching is enabled.
+     * @return bool True if enabled.
+     */
+    bool shadowCaching() const;
+
+    /**
+     * @brief Force all shadow maps to be re-rendered in the next frame.
+     *
+     * Needed after changes the caster tracking cannot see, such as geometry modified in place.
+     */
+    void invalidateShadowMaps();
+
+    /**
+     * @brief Get the number of shadow passes rendered in the last frame.
+     * @return int Rendered passes.
+     */
+    int shadowPassesRendered() const;
+
+    /**
+     * @brief Get the number of shadow passes skipped (reused from the cache) in the last frame.
+     * @return int Skipped passes.
+     */
+    int shadowPassesSkipped() const;
+
     /**
      * @brief Set the diffuse color for materials.
      * @param color Diffuse color (glm::vec3).
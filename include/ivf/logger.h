@@ -46,6 +46,10 @@ public:
 
     void setLogLevel(LogLevel level);
     LogLevel logLevel() const;
+
+    // True if messages of the level are written. The formatted methods check this before formatting,
+    // so that filtered messages cost no formatting; check it before building costly log output.
+    bool isEnabled(LogLevel level) const { return m_logLevel != LogLevel::None && level >= m_logLevel; }
     void setConsoleOutput(bool enable);
     bool consoleOutput() const;
     bool setFileOutput(const std::string &filePath);
@@ -73,42 +77,58 @@ public:
     // Formatted logging methods (without context)
     template<typename... Args>
     void debugf(std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Debug))
+            return;
         writeLog(LogLevel::Debug, std::format(fmt, std::forward<Args>(args)...), "");
     }
     
     template<typename... Args>
     void infof(std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Info))
+            return;
         writeLog(LogLevel::Info, std::format(fmt, std::forward<Args>(args)...), "");
     }
     
     template<typename... Args>
     void warningf(std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Warning))
+            return;
         writeLog(LogLevel::Warning, std::format(fmt, std::forward<Args>(args)...), "");
     }
     
     template<typename... Args>
     void errorf(std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Error))
+            return;
         writeLog(LogLevel::Error, std::format(fmt, std::forward<Args>(args)...), "");
     }
     
     // Formatted logging methods with context (context FIRST - recommended API)
     template<typename... Args>
     void debugfc(const std::string& context, std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Debug))
+            return;
         writeLog(LogLevel::Debug, std::format(fmt, std::forward<Args>(args)...), context);
     }
     
     template<typename... Args>
     void infofc(const std::string& context, std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Info))
+            return;
         writeLog(LogLevel::Info, std::format(fmt, std::forward<Args>(args)...), context);
     }
     
     template<typename... Args>
     void warningfc(const std::string& context, std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Warning))
+            return;
         writeLog(LogLevel::Warning, std::format(fmt, std::forward<Args>(args)...), context);
     }
     
     template<typename... Args>
     void errorfc(const std::string& context, std::format_string<Args...> fmt, Args&&... args) {
+        if (!isEnabled(LogLevel::Error))
+            return;
         writeLog(LogLevel::Error, std::format(fmt, std::forward<Args>(args)...), context);
     }
 };
@@ -77,12 +77,25 @@ private:
     GLenum m_depthFunc;             ///< Depth test function.
     GLfloat m_lineWidth;            ///< Line width for wireframe rendering.
     GLenum m_usage{GL_STATIC_DRAW}; ///< OpenGL buffer usage hint.
+    bool m_buffersPending{false};   ///< True if end() deferred the creation of the OpenGL buffers.
+
+    static thread_local bool m_deferBuffers; ///< Defer buffer creation on the current thread.
 
     /**
      * @brief Internal method to set up the OpenGL primitive type.
      */
     void setupPrim();
 
+    /**
+     * @brief Internal method to look up the attribute locations of the current shader program.
+     */
+    void setupAttribIds();
+
+    /**
+     * @brief Internal method to create the OpenGL buffers from the mesh data.
+     */
+    void setupBuffers();
+
 public:
     /**
      * @brief Constructor.
@@ -351,11 +364,56 @@ public:
      */
     void triQuad(GLdouble w, GLdouble h, GLdouble offset, GLdouble vx, GLdouble vy, GLdouble vz);
 
+    /**
+     * @brief Copy tightly packed arrays into the mesh instead of adding one vertex at a time.
+     *
+     * Called between begin() and end(). Each array must hold data for all vertices (3, 3, 2 and 4
+     * floats per vertex) or all index rows of the primitive. Null arrays are left unchanged.
+     * @param verts Vertex positions.
+     * @param normals Vertex normals.
+     * @param texCoords Texture coordinates.
+     * @param colors RGBA vertex colors.
+     * @param indices Index data.
+     */
+    void setArrays(const GLfloat *verts, const GLfloat *normals = nullptr, const GLfloat *texCoords = nullptr,
+                   const GLfloat *colors = nullptr, const GLuint *indices = nullptr);
+
     /**
      * @brief End mesh definition.
+     *
+     * Generates normals if enabled and creates the OpenGL buffers, unless buffer creation is
+     * deferred on the calling thread (see setDeferBufferCreation()).
      */
     void end();
 
+    /**
+     * @brief Create the OpenGL buffers of a mesh whose end() deferred them.
+     *
+     * Must be called on the thread owning the OpenGL context. Does nothing if no buffers are pending.
+     */
+    void createBuffers();
+
+    /**
+     * @brief Check if the OpenGL buffers are still to be created by createBuffers().
+     * @return bool True if the buffers are pending; such meshes are not drawn.
+     */
+    bool buffersPending() const;
+
+    /**
+     * @brief Defer OpenGL buffer creation by end() on the calling thread.
+     *
+     * Lets worker threads build meshes: the meshes only hold their vertex data and no GL calls are
+     * made until createBuffers() is called on the thread owning the OpenGL context.
+     * @param flag True to defer buffer creation on this thread.
+     */
+    static void setDeferBufferCreation(bool flag);
+
+    /**
+     * @brief Check if end() defers OpenGL buffer creation on the calling thread.
+     * @return bool True if deferred.
+     */
+    static bool deferBufferCreation();
+
     /**
      * @brief Update the vertex buffer with new vertex data.
      */
@@ -443,6 +501,24 @@ public:
      */
     std::shared_ptr<Indices> indices();
 
+    /**
+     * @brief Get the vertex colors array.
+     * @return std::shared_ptr<Colors> Colors array.
+     */
+    std::shared_ptr<Colors> colors();
+
+    /**
+     * @brief Get the texture coordinates array.
+     * @return std::shared_ptr<TexCoords> Texture coordinates array.
+     */
+    std::shared_ptr<TexCoords> texCoords();
+
+    /**
+     * @brief Get the OpenGL primitive type.
+     * @return GLuint Primitive type (e.g., GL_TRIANGLES).
+     */
+    GLuint primType() const;
+
     ivf::MaterialPtr material() const;
     void setMaterial(ivf::MaterialPtr material);
     /**
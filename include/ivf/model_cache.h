@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ivf {
+
+struct ModelData;
+
+/**
+ * @struct ModelCacheStats
+ * @brief Counters of ModelCache activity since the cache was created or resetStats() was called.
+ */
+struct ModelCacheStats {
+    size_t hits{0};          ///< Models loaded from a cache file.
+    size_t misses{0};        ///< Models imported with assimp, including stale cache files.
+    size_t stale{0};         ///< Misses caused by a cache file of a changed source file.
+    size_t writes{0};        ///< Cache files written.
+    size_t invalidations{0}; ///< Cache files removed by invalidate() and clear().
+    size_t bytesMapped{0};   ///< Size of the cache files loaded.
+    size_t bytesWritten{0};  ///< Size of the cache files written.
+    double hitSeconds{0.0};  ///< Time spent loading models from cache files.
+    double missSeconds{0.0}; ///< Time spent importing models, including writing their cache files.
+};
+
+/**
+ * @class ModelCache
+ * @brief Singleton managing binary cache files of models imported by ModelLoader.
+ *
+ * The first time a model is loaded, ModelLoader imports it with assimp and writes the node
+ * hierarchy, transforms, materials and tightly packed vertex and index arrays to a cache file.
+ * Later loads of the same file memory-map the cache file and copy the arrays straight into the
+ * mesh buffers, skipping the import, which is typically an order of magnitude slower.
+ *
+ * Cache files are keyed by the canonical path of the model file and the assimp import flags, and
+ * store the size and modification time of the model file. A cache file of a modified model is
+ * ignored and replaced on the next load; invalidate() removes the files of a model explicitly.
+ * Failing to write a cache file only disables caching of that model.
+ *
+ * Usage:
+ * @code
+ * ModelCache::instance()->setDirectory("cache/models");
+ * auto model = ModelLoader::loadModel("assets/teapot.obj"); // imported and cached
+ * auto again = ModelLoader::loadModel("assets/teapot.obj"); // loaded from the cache file
+ * auto &stats = ModelCache::instance()->stats();
+ * @endcode
+ */
+class ModelCache {
+private:
+    bool m_enabled{true};                         ///< Read and write cache files.
+    std::string m_directory{".ivf_cache/models"}; ///< Directory of the cache files.
+    ModelCacheStats m_stats;                      ///< Activity counters.
+    bool m_writeWarned{false};                    ///< True after warning about a failed write.
+
+    static ModelCache *m_instance; ///< Singleton instance pointer.
+
+    ModelCache();
+
+    std::string cacheFile(const std::string &canonical, unsigned int importFlags) const;
+    std::string filePrefix(const std::string &canonical) const;
+
+    /**
+     * @brief Read the cache file of a model if it is valid and up to date.
+     * @param path Model file.
+     * @param importFlags Assimp post processing flags.
+     * @param data Model with mesh arrays pointing into the mapped cache file.
+     * @return bool False on a cache miss.
+     */
+    bool read(const std::string &path, unsigned int importFlags, ModelData &data);
+
+    /**
+     * @brief Write the cache file of an imported model.
+     * @param path Model file.
+     * @param importFlags Assimp post processing flags.
+     * @param data Imported model.
+     * @return bool True if the file was written.
+     */
+    bool write(const std::string &path, unsigned int importFlags, const ModelData &data);
+
+    friend class ModelLoader;
+
+public:
+    virtual ~ModelCache();
+
+    /**
+     * @brief Get the singleton instance.
+     * @return ModelCache* Pointer to the singleton instance.
+     */
+    static ModelCache *instance();
+
+    /**
+     * @brief Create the singleton instance (if not already created).
+     * @return ModelCache* Pointer to the singleton instance.
+     */
+    static ModelCache *create();
+
+    /**
+     * @brief Destroy the singleton instance. Cache files are kept.
+     */
+    static void drop();
+
+    /**
+     * @brief Enable or disable reading and writing cache files.
+     * @param flag True to enable (default).
+     */
+    void setEnabled(bool flag);
+
+    /**
+     * @brief Check if cache files are read and written.
+     * @return bool True if enabled.
+     */
+    bool enabled() const;
+
+    /**
+     * @brief Set the directory of the cache files, created when the first file is written.
+     * @param directory Directory path (default ".ivf_cache/models", relative to the working directory).
+     */
+    void setDirectory(const std::string &directory);
+
+    /**
+     * @brief Get the directory of the cache files.
+     * @return const std::string& Directory path.
+     */
+    const std::string &directory() const;
+
+    /**
+     * @brief Check if a model has an up to date cache file.
+     * @param path Model file.
+     * @param importFlags Assimp post processing flags, see ModelLoader::defaultImportFlags.
+     * @return bool True if the next load of the model reads the cache file.
+     */
+    bool isCached(const std::string &path, unsigned int importFlags) const;
+
+    /**
+     * @brief Remove the cache files of a model, for all import flags.
+     * @param path Model file.
+     * @return size_t Number of files removed.
+     */
+    size_t invalidate(const std::string &path);
+
+    /**
+     * @brief Remove all cache files from the cache directory.
+     * @return size_t Number of files removed.
+     */
+    size_t clear();
+
+    /**
+     * @brief Get the total size of the cache files.
+     * @return size_t Size in bytes.
+     */
+    size_t diskUsage() const;
+
+    /**
+     * @brief Get the activity counters.
+     * @return const ModelCacheStats& Counters.
+     */
+    const ModelCacheStats &stats() const;
+
+    /**
+     * @brief Reset the activity counters.
+     */
+    void resetStats();
+};
+
+/**
+ * @typedef ModelCachePtr
+ * @brief Pointer type for ModelCache.
+ */
+typedef ModelCache *ModelCachePtr;
+
+} // namespace ivf
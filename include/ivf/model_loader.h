@@ -3,25 +3,66 @@
 #include <ivf/mesh_node.h>
 #include <ivf/composite_node.h>
 #include <assimp/scene.h>
+#include <assimp/postprocess.h>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ivf {
 
+struct ModelData;
+struct ModelMesh;
+struct ModelMaterial;
+
+/**
+ * @struct ModelLoadTimings
+ * @brief Time spent in the phases of the last ModelLoader::loadModel() call.
+ */
+struct ModelLoadTimings {
+    double readSeconds{0.0};    ///< Reading the file with assimp, or mapping and validating the cache file.
+    double flattenSeconds{0.0}; ///< Flattening the node hierarchy.
+    double convertSeconds{0.0}; ///< Converting meshes and materials on the worker threads.
+    double cacheSeconds{0.0};   ///< Writing the cache file.
+    double buildSeconds{0.0};   ///< Creating nodes, meshes and GL buffers on the calling thread.
+    double totalSeconds{0.0};   ///< Whole load.
+    size_t meshes{0};           ///< Number of meshes.
+    size_t vertices{0};         ///< Number of vertices of all meshes.
+    size_t triangles{0};        ///< Number of triangles of all meshes.
+    bool fromCache{false};      ///< True if the model was read from a ModelCache file.
+};
+
 class ModelLoader {
 private:
-    static void processNode(const aiScene *scene, aiNode *node, std::shared_ptr<CompositeNode> compNode,
-                            aiMatrix4x4 parentTransform);
-    static void processAiMesh(const aiScene *scene, aiMesh *aiMesh, std::shared_ptr<MeshNode> meshNode);
-    static void processMaterial(aiMaterial *aiMat, std::shared_ptr<Mesh> mesh);
-    static void processMaterial(aiMaterial *aiMat, std::shared_ptr<MeshNode> node);
+    static ModelLoadTimings m_lastTimings;
+
+    static unsigned int countMeshes(const aiNode *node, std::unordered_map<const aiNode *, unsigned int> &counts);
+    static void processNode(const aiScene *scene, const aiNode *node, int parent, aiMatrix4x4 parentTransform,
+                            const std::unordered_map<const aiNode *, unsigned int> &subtreeMeshes, ModelData &data,
+                            std::vector<const aiMesh *> &sources);
+    static void processAiMesh(const aiScene *scene, const aiMesh *aiMesh, ModelMesh &mesh);
+    static void processMaterial(const aiMaterial *aiMat, ModelMaterial &material);
+
+    static void importModel(const std::string &path, unsigned int importFlags, ModelData &data);
+    static std::shared_ptr<CompositeNode> buildModel(const ModelData &data);
 
 public:
+    // Assimp post processing flags used by loadModel() unless others are given
+    static constexpr unsigned int defaultImportFlags =
+        aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals;
+
     // Prevent instantiation since this is a utility class
     ModelLoader() = delete;
     ~ModelLoader() = delete;
 
-    // Main model loading function
-    static std::shared_ptr<CompositeNode> loadModel(const std::string &path);
+    // Main model loading function. Imported models are stored in the ModelCache and later loads of
+    // an unchanged file with the same flags read the cache file instead of importing it again.
+    // Meshes and materials are converted in parallel on the ThreadPool; nodes and GL buffers are
+    // created on the calling thread, which must own the OpenGL context.
+    static std::shared_ptr<CompositeNode> loadModel(const std::string &path,
+                                                    unsigned int importFlags = defaultImportFlags);
+
+    // Phase timings of the last loadModel() call
+    static const ModelLoadTimings &lastTimings();
 };
 
 } // namespace ivf
@@ -25,6 +25,9 @@ public:
     float glowStrength() const;
     glm::vec3 phosphorColor() const;
 
+    bool isPointwise() const override;
+    std::string pointwiseSource() const override;
+
 protected:
     virtual void doLoad() override;
     virtual void doUpdateParams() override;
@@ -37,6 +37,7 @@
 #include <ivf/dynamic_mesh.h>
 #include <ivf/particle_system.h>
 #include <ivf/cubemap.h>
+#include <ivf/texture_cache.h>
 #include <ivf/skybox.h>
 #include <ivf/billboard.h>
 #include <ivf/behaviors.h>
@@ -45,4 +46,5 @@
 #include <ivf/pbr_material.h>
 #include <ivf/pbr_mesh_node.h>
 #include <ivf/scene_serializer.h>
+#include <ivf/scene_loader.h>
 #include <ivf/scene_timeline.h>
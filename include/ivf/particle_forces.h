@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file particle_forces.h
+ * @brief Declares ParticleBatch and the composable force kernels used by ParticleSystem.
+ */
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <span>
+
+namespace ivf {
+
+/**
+ * @brief Spans over the fields of a contiguous block of live particles.
+ *
+ * Handed to force kernels and batch update functions. Blocks are small enough
+ * (a few hundred particles) to stay in L1 cache while every kernel runs over them.
+ */
+struct ParticleBatch {
+    std::span<float> posX, posY, posZ;
+    std::span<float> velX, velY, velZ;
+    std::span<float> life;           // remaining lifetime in seconds, <= 0 kills the particle
+    std::span<const float> lifeSpan; // full lifetime
+    size_t first{0};                 // index of the first particle of the block in the system
+
+    [[nodiscard]] size_t size() const { return posX.size(); }
+};
+
+/**
+ * @brief Base class for force kernels applied to particle velocities.
+ *
+ * apply() is called once per block, concurrently for different blocks on
+ * ThreadPool workers, so implementations must not modify shared state.
+ */
+class ParticleForce {
+private:
+    bool m_enabled{true};
+
+public:
+    virtual ~ParticleForce() = default;
+
+    void setEnabled(bool b)            { m_enabled = b; }
+    [[nodiscard]] bool enabled() const { return m_enabled; }
+
+    /** Update the velocities of a block of particles. */
+    virtual void apply(const ParticleBatch& batch, float dt) const = 0;
+};
+
+using ParticleForcePtr = std::shared_ptr<ParticleForce>;
+
+/**
+ * @brief Constant acceleration, e.g. additional gravity or wind.
+ */
+class GravityForce : public ParticleForce {
+private:
+    glm::vec3 m_acceleration;
+
+public:
+    explicit GravityForce(glm::vec3 acceleration = {0.0f, -9.8f, 0.0f}) : m_acceleration(acceleration) {}
+    static std::shared_ptr<GravityForce> create(glm::vec3 acceleration = {0.0f, -9.8f, 0.0f});
+
+    void setAcceleration(glm::vec3 a)            { m_acceleration = a; }
+    [[nodiscard]] glm::vec3 acceleration() const { return m_acceleration; }
+
+    void apply(const ParticleBatch& batch, float dt) const override;
+};
+
+/**
+ * @brief Linear drag, velocities decay by exp(-coefficient * dt).
+ */
+class DragForce : public ParticleForce {
+private:
+    float m_coefficient;
+
+public:
+    explicit DragForce(float coefficient = 0.5f) : m_coefficient(coefficient) {}
+    static std::shared_ptr<DragForce> create(float coefficient = 0.5f);
+
+    void setCoefficient(float c)            { m_coefficient = c; }
+    [[nodiscard]] float coefficient() const { return m_coefficient; }
+
+    void apply(const ParticleBatch& batch, float dt) const override;
+};
+
+/**
+ * @brief Inverse-square attraction toward (or, with negative strength, repulsion from) a point.
+ *
+ * The softening radius limits the acceleration close to the center.
+ */
+class AttractorForce : public ParticleForce {
+private:
+    glm::vec3 m_center;
+    float m_strength;
+    float m_softening;
+
+public:
+    AttractorForce(glm::vec3 center = {0.0f, 0.0f, 0.0f}, float strength = 5.0f, float softening = 0.5f)
+        : m_center(center), m_strength(strength), m_softening(softening) {}
+    static std::shared_ptr<AttractorForce> create(glm::vec3 center = {0.0f, 0.0f, 0.0f}, float strength = 5.0f,
+                                                  float softening = 0.5f);
+
+    void setCenter(glm::vec3 c)            { m_center = c; }
+    void setStrength(float s)              { m_strength = s; }
+    void setSoftening(float r)             { m_softening = r; }
+    [[nodiscard]] glm::vec3 center() const { return m_center; }
+    [[nodiscard]] float strength() const   { return m_strength; }
+    [[nodiscard]] float softening() const  { return m_softening; }
+
+    void apply(const ParticleBatch& batch, float dt) const override;
+};
+
+/**
+ * @brief Swirl around an axis through a point, falling off with the distance from the axis.
+ */
+class VortexForce : public ParticleForce {
+private:
+    glm::vec3 m_center;
+    glm::vec3 m_axis;
+    float m_strength;
+    float m_radius;
+
+public:
+    VortexForce(glm::vec3 center = {0.0f, 0.0f, 0.0f}, glm::vec3 axis = {0.0f, 1.0f, 0.0f}, float strength = 5.0f,
+                float radius = 1.0f);
+    static std::shared_ptr<VortexForce> create(glm::vec3 center = {0.0f, 0.0f, 0.0f},
+                                               glm::vec3 axis = {0.0f, 1.0f, 0.0f}, float strength = 5.0f,
+                                               float radius = 1.0f);
+
+    void setCenter(glm::vec3 c)            { m_center = c; }
+    void setAxis(glm::vec3 a);
+    void setStrength(float s)              { m_strength = s; }
+    void setRadius(float r)                { m_radius = r; }
+    [[nodiscard]] glm::vec3 center() const { return m_center; }
+    [[nodiscard]] glm::vec3 axis() const   { return m_axis; }
+    [[nodiscard]] float strength() const   { return m_strength; }
+    [[nodiscard]] float radius() const     { return m_radius; }
+
+    void apply(const ParticleBatch& batch, float dt) const override;
+};
+
+} // namespace ivf
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <ivf/node.h>
+#include <ivf/particle_forces.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 #include <memory>
@@ -19,6 +21,16 @@ class Texture;
  * camera-facing quads. The system integrates into the scene graph like any
  * other Node — just add it to the scene.
  *
+ * Particle state is kept as structure-of-arrays with all live particles packed
+ * at the front, so spawning appends and dying swaps the last live particle
+ * into the freed slot — both O(1). The built-in integration runs as branch-free
+ * loops over the arrays (vectorized by the compiler) split across ThreadPool
+ * workers, and only the live range is streamed to the instance buffer.
+ *
+ * Forces (ParticleForce kernels) and an optional batch update function are
+ * evaluated in one fused pass over small blocks of particles, so all kernels
+ * work on cache-resident data.
+ *
  * @code
  * auto ps = ParticleSystem::create(5000);
  * ps->setEmitRate(200);
@@ -46,13 +58,21 @@ public:
     };
 
     using UpdateFn = std::function<void(Particle& p, float dt)>;
+    using BatchUpdateFn = std::function<void(const ParticleBatch& batch, float dt)>;
 
 private:
-    // Simulation state
-    std::vector<Particle> m_pool;
+    // Simulation state, structure of arrays; [0, m_aliveCount) holds the live particles
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_velX, m_velY, m_velZ;
+    std::vector<float> m_life;     // remaining lifetime in seconds
+    std::vector<float> m_lifeSpan; // full lifetime (for interpolation)
     int m_maxParticles;
     int m_aliveCount{0};
 
+    // Worker threading; systems smaller than one grain are updated on the calling thread
+    bool   m_parallel{true};
+    size_t m_grainSize{16384};
+
     // Emitter settings
     float m_emitRate{50.0f};        // particles per second
     float m_emitAccumulator{0.0f};
@@ -78,6 +98,8 @@ private:
     glm::vec3 m_fogColor{0.0f, 0.0f, 0.0f};
 
     UpdateFn m_updateFn;
+    BatchUpdateFn m_batchUpdateFn;
+    std::vector<ParticleForcePtr> m_forces;
 
     // GPU resources
     GLuint m_vao{0}, m_quadVBO{0}, m_instanceVBO{0};
@@ -90,12 +112,16 @@ private:
         float     size;
         glm::vec4 color;
     };
-    std::vector<InstanceData> m_instanceData;
 
     std::mt19937 m_rng{std::random_device{}()};
 
     void initGPU();
     void spawnParticle();
+    void removeDead();
+    void integrate(size_t begin, size_t end, float dt);
+    ParticleBatch batch(size_t begin, size_t end);
+    void callUpdateFunction(float dt);
+    void packInstances(InstanceData* dst, size_t begin, size_t end) const;
     float randRange(float lo, float hi);
     glm::vec3 randVec3(glm::vec3 lo, glm::vec3 hi);
 
@@ -141,10 +167,33 @@ public:
     void stop()  { m_playing = false; }
     [[nodiscard]] bool isPlaying() const { return m_playing; }
 
+    // ---- Forces --------------------------------------------------------
+
+    // Applied to the velocities in the order added, after gravity
+    void addForce(ParticleForcePtr force);
+    void removeForce(ParticleForcePtr force);
+    void clearForces() { m_forces.clear(); }
+    [[nodiscard]] const std::vector<ParticleForcePtr>& forces() const { return m_forces; }
+
+    // ---- Custom batch update -------------------------------------------
+
+    // Called for every block after the forces and before positions are advanced.
+    // Blocks are processed concurrently, the function must be thread safe.
+    void setBatchUpdateFunction(BatchUpdateFn fn) { m_batchUpdateFn = std::move(fn); }
+
     // ---- Custom per-particle update ------------------------------------
 
+    // Replaces the built-in integration, forces and batch update. Called serially
+    // for every live particle through a temporary Particle (slow path).
     void setUpdateFunction(UpdateFn fn) { m_updateFn = std::move(fn); }
 
+    // ---- Threading -----------------------------------------------------
+
+    void setParallel(bool b)    { m_parallel = b; }
+    void setGrainSize(size_t n) { m_grainSize = std::max<size_t>(n, 1); }
+    [[nodiscard]] bool   parallel() const  { return m_parallel; }
+    [[nodiscard]] size_t grainSize() const { return m_grainSize; }
+
     // ---- Per-frame update + draw (called by Node::draw) ----------------
 
     void update(float dt);
@@ -37,7 +37,8 @@ void main()
 inline const std::string pbr_frag_shader_source = R"(
 #version 330 core
 
-out vec4 fragColor;
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out uint fragObjectId;
 
 // ---- Inputs ----------------------------------------------------------------
 in vec3 fragPos;
@@ -212,11 +213,9 @@ void main()
     // Selection pass
     if (selectionRendering)
     {
-        uint mask = uint(255);
-        uint r = objectId & mask;
-        uint g = (objectId >> uint(8)) & mask;
-        uint b = (objectId >> uint(16)) & mask;
-        fragColor = vec4(float(r)/255.0, float(g)/255.0, float(b)/255.0, 1.0);
+        // Object IDs go to the R32UI selection target on draw buffer 1
+        fragObjectId = objectId;
+        fragColor = vec4(0.0, 0.0, 0.0, 1.0);
         return;
     }
 
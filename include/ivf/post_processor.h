@@ -4,6 +4,9 @@
 
 #include <ivf/gl.h>
 #include <ivf/texture.h>
+#include <ivf/effect.h>
+#include <ivf/effect_fusion.h>
+#include <ivf/render_target.h>
 
 namespace ivf {
 
@@ -12,15 +15,21 @@ namespace ivf {
  * @brief Manages post-processing effects using framebuffer objects and shader programs.
  *
  * The PostProcessor class handles the application of post-processing effects to rendered images.
- * It manages framebuffer objects, textures, and a sequence of shader programs (effects) that can
- * be applied in order. The class supports initialization, resizing, effect management, and
- * rendering the final output.
+ * It manages a sequence of shader programs (effects) that can be applied in order. Its targets
+ * come from the RenderTargetPool: the ping-pong targets are acquired for the duration of apply()
+ * only, the previous-frame targets are held and exchanged lazily when the size changes.
  *
  * Texture unit conventions exposed to effect shaders:
  *   - unit 0 : the current source image, sampled via `uniform sampler2D screenTexture`.
  *   - unit 1 : the previous frame's final composite, sampled via `uniform sampler2D previousFrame`.
  *              This is what enables temporal/feedback effects (feedback, trails, motion blur).
  *              Effects that do not declare `previousFrame` simply ignore it.
+ *   - unit 6 : intermediate results of multi-pass effects (EFFECT_AUX_TEXTURE_UNIT), prepared in
+ *              Effect::renderPasses() before the effect's final pass.
+ *
+ * Consecutive enabled point-wise effects (Effect::isPointwise()) added through
+ * addEffect(EffectPtr) are fused into a single pass using a program generated by
+ * EffectFusion, saving one full-screen read and write per fused effect.
  */
 class PostProcessor : public GLBase {
 private:
@@ -28,17 +37,21 @@ private:
     int m_height; ///< Height of the render target.
     float m_time; ///< Current time (for time-based effects).
 
-    GLuint m_fboA, m_fboB;         ///< Framebuffer objects for ping-pong rendering.
-    GLuint m_textureA, m_textureB; ///< Textures attached to the FBOs.
-
-    GLuint m_historyFBO;     ///< Framebuffer used to capture the final composite for the next frame.
-    GLuint m_historyTex[2];  ///< Double-buffered previous-frame textures (read one, write the other).
-    int m_historyIndex;      ///< Index of the texture holding the most recent composite.
+    RenderTargetPtr m_history[2]; ///< Previous-frame composites (read one, write the other).
+    int m_historyIndex;           ///< Index of the target holding the most recent composite.
 
     GLuint m_quadVAO; ///< Vertex array object for the screen quad.
     GLuint m_quadVBO; ///< Vertex buffer object for the screen quad.
 
+    void updateHistory();
+
     std::vector<ProgramPtr> m_fxPrograms; ///< List of shader programs (effects).
+    std::vector<EffectPtr> m_fxEffects;   ///< Effects owning the programs (nullptr for plain programs).
+
+    EffectFusionPtr m_fusion;   ///< Cache of fused point-wise programs.
+    bool m_fuseEffects{true};   ///< Fuse consecutive point-wise effects.
+    int m_passCount{0};         ///< Passes rendered by the last apply().
+    int m_fusedEffectCount{0};  ///< Effects rendered in fused passes by the last apply().
 
 public:
     /**
@@ -59,6 +72,39 @@ public:
      */
     void addEffect(ProgramPtr fxProgram);
 
+    /**
+     * @brief Add a post-processing effect.
+     *
+     * Unlike addEffect(ProgramPtr), the effect can take part in fused passes when it is point-wise.
+     *
+     * @param effect Shared pointer to the effect.
+     */
+    void addEffect(EffectPtr effect);
+
+    /**
+     * @brief Enable or disable fusing of consecutive point-wise effects.
+     * @param flag True to fuse effects (default).
+     */
+    void setEffectFusion(bool flag);
+
+    /**
+     * @brief Check if point-wise effects are fused.
+     * @return bool True if fusion is enabled.
+     */
+    bool effectFusion() const;
+
+    /**
+     * @brief Get the number of passes rendered by the last apply() (excluding the final blit).
+     * @return int Pass count.
+     */
+    int passCount() const;
+
+    /**
+     * @brief Get the number of effects rendered in fused passes by the last apply().
+     * @return int Effect count.
+     */
+    int fusedEffectCount() const;
+
     /**
      * @brief Remove all post-processing effects.
      */
@@ -70,14 +116,14 @@ public:
     void initialize();
 
     /**
-     * @brief Resize the post-processor's render target.
+     * @brief Resize the post-processor's render target (reallocated on the next apply()).
      * @param width New width.
      * @param height New height.
      */
     void resize(int width, int height);
 
     /**
-     * @brief Release all resources used by the post-processor.
+     * @brief Return all render targets held by the post-processor to the pool.
      */
     void drop();
 
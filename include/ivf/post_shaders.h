@@ -16,6 +16,12 @@ namespace ivf {
  * post-processing effects such as vignette, chromatic aberration, film grain, blur, tint,
  * bloom, dithering, pixelation, and edge detection. These shaders are intended for use
  * with OpenGL 3.3+ and can be loaded at runtime for custom rendering pipelines.
+ *
+ * Point-wise effects (*_pointwise_source) are not complete shaders but snippets that
+ * EffectFusion assembles into fragment programs. A snippet defines
+ * `vec3 $apply(vec3 color, vec2 uv)` and may declare uniforms and helpers; every `$` is
+ * replaced with a per-effect prefix so several snippets can share one program. The
+ * `time` and `screenTexture` uniforms are declared by the generated program.
  */
 
 inline const std::string render_to_texture_vert_shader_source_330 = R"(
@@ -44,32 +50,17 @@ void main()
     FragColor = vec4(col, 1.0);
 })";
 
-inline const std::string vignette_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
-
-uniform sampler2D screenTexture;
-uniform float time;
-uniform float vignetteSize;
-uniform float vignetteSmoothness;
+inline const std::string vignette_pointwise_source = R"(
+uniform float $vignetteSize;
+uniform float $vignetteSmoothness;
 
-// Vignette effect
-vec3 applyVignette(vec3 color, vec2 texCoord) {
-    vec2 position = (texCoord - 0.5) * 2.0;
+vec3 $apply(vec3 color, vec2 uv)
+{
+    vec2 position = (uv - 0.5) * 2.0;
     float len = length(position);
 
-    float vignette = smoothstep(vignetteSize, vignetteSize - vignetteSmoothness, len);
+    float vignette = smoothstep($vignetteSize, $vignetteSize - $vignetteSmoothness, len);
     return color * vignette;
-}
-
-void main()
-{
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    
-    // Apply vignette effect
-    col = applyVignette(col, TexCoords);
-    FragColor = vec4(col, 1.0);
 })";
 
 inline const std::string chromatic_frag_shader_source = R"(
@@ -101,29 +92,19 @@ void main()
     FragColor = vec4(col, 1.0);
 })";
 
-inline const std::string filmgrain_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
-uniform sampler2D screenTexture;
-uniform float time;
-uniform float noiseIntensity;
-uniform float grainBlending;
+inline const std::string filmgrain_pointwise_source = R"(
+uniform float $noiseIntensity;
+uniform float $grainBlending;
 
-float random(vec2 st) {
+float $random(vec2 st)
+{
     return fract(sin(dot(st.xy, vec2(12.9898,78.233))) * 43758.5453123);
 }
 
-vec3 applyFilmGrain(vec3 color, vec2 texCoord, float time) {
-    float noise = random(texCoord + time) * noiseIntensity;
-    return color + noise * grainBlending;
-}
-
-void main()
+vec3 $apply(vec3 color, vec2 uv)
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    col = applyFilmGrain(col, TexCoords, time);
-    FragColor = vec4(col, 1.0);
+    float noise = $random(uv + time) * $noiseIntensity;
+    return color + noise * $grainBlending;
 })";
 
 inline const std::string blur_frag_shader_source = R"(
@@ -132,126 +113,190 @@ out vec4 FragColor;
 in vec2 TexCoords;
 
 uniform sampler2D screenTexture;
+uniform sampler2D blurTexture;  // half resolution result of the downsample chain (unit 2)
 uniform float time;
 
-uniform float blurRadius;
-
-// Gaussian blur
-vec3 applyBlur(sampler2D tex, vec2 texCoord) {
-    vec2 texelSize = 1.0 / textureSize(tex, 0);
-    vec3 result = vec3(0.0);
-    float total = 0.0;
-    
-    for(float x = -blurRadius; x <= blurRadius; x++) {
-        for(float y = -blurRadius; y <= blurRadius; y++) {
-            vec2 offset = vec2(x, y) * texelSize;
-            float weight = exp(-(x*x + y*y) / (2.0 * blurRadius * blurRadius));
-            result += texture(tex, texCoord + offset).rgb * weight;
-            total += weight;
-        }
-    }
-    
-    return result / total;
+uniform float blurMix;          // fades the blur in for radii below one pixel
+uniform float blurOffset;
+
+// Final dual-Kawase upsample straight into the full resolution target
+vec3 upsample(sampler2D tex, vec2 uv, float offset) {
+    vec2 h = offset * 0.5 / vec2(textureSize(tex, 0));
+    vec3 sum = texture(tex, uv + vec2(-h.x * 2.0, 0.0)).rgb;
+    sum += texture(tex, uv + vec2(-h.x, h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(0.0, h.y * 2.0)).rgb;
+    sum += texture(tex, uv + vec2(h.x, h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(h.x * 2.0, 0.0)).rgb;
+    sum += texture(tex, uv + vec2(h.x, -h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(0.0, -h.y * 2.0)).rgb;
+    sum += texture(tex, uv + vec2(-h.x, -h.y)).rgb * 2.0;
+    return sum / 12.0;
 }
 
 void main()
 {
     vec3 col = texture(screenTexture, TexCoords).rgb;
-    
-    // Apply vignette effect
-    col = applyBlur(screenTexture, TexCoords);
+
+    if (blurMix > 0.0)
+        col = mix(col, upsample(blurTexture, TexCoords, blurOffset), blurMix);
+
     FragColor = vec4(col, 1.0);
 })";
 
-inline const std::string tint_frag_shader_source = R"(
+inline const std::string tint_pointwise_source = R"(
+uniform vec3 $tintColor;
+uniform float $tintStrength;
+uniform vec3 $grayScaleWeights;
+
+vec3 $apply(vec3 color, vec2 uv)
+{
+    float gray = dot(color, $grayScaleWeights);
+    vec3 tintedColor = vec3(gray) * $tintColor;
+    return mix(color, tintedColor, $tintStrength);
+})";
+
+inline const std::string fade_pointwise_source = R"(
+uniform vec3 $fadeColor;
+uniform float $fadeAmount;
+
+vec3 $apply(vec3 color, vec2 uv)
+{
+    return mix(color, $fadeColor, clamp($fadeAmount, 0.0, 1.0));
+})";
+
+inline const std::string bloom_frag_shader_source = R"(
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoords;
+
 uniform sampler2D screenTexture;
+uniform sampler2D bloomTexture; // half resolution result of the bloom chain (unit 2)
 uniform float time;
-uniform vec3 tintColor;
-uniform float tintStrength;
-uniform vec3 grayScaleWeights;
-
-vec3 applyColorTint(vec3 color) {
-    float gray = dot(color, grayScaleWeights);
-    vec3 tintedColor = vec3(gray) * tintColor;
-    return mix(color, tintedColor, tintStrength);
+uniform float bloomScale;       // intensity normalized by the number of accumulated levels
+
+vec3 upsample(sampler2D tex, vec2 uv) {
+    vec2 h = 0.5 / vec2(textureSize(tex, 0));
+    vec3 sum = texture(tex, uv + vec2(-h.x * 2.0, 0.0)).rgb;
+    sum += texture(tex, uv + vec2(-h.x, h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(0.0, h.y * 2.0)).rgb;
+    sum += texture(tex, uv + vec2(h.x, h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(h.x * 2.0, 0.0)).rgb;
+    sum += texture(tex, uv + vec2(h.x, -h.y)).rgb * 2.0;
+    sum += texture(tex, uv + vec2(0.0, -h.y * 2.0)).rgb;
+    sum += texture(tex, uv + vec2(-h.x, -h.y)).rgb * 2.0;
+    return sum / 12.0;
 }
 
 void main()
 {
     vec3 col = texture(screenTexture, TexCoords).rgb;
-    col = applyColorTint(col);
+    col += upsample(bloomTexture, TexCoords) * bloomScale;
     FragColor = vec4(col, 1.0);
 })";
 
-inline const std::string fade_frag_shader_source = R"(
+inline const std::string kawase_down_frag_shader_source = R"(
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoords;
+
 uniform sampler2D screenTexture;
-uniform float time;
-uniform vec3 fadeColor;
-uniform float fadeAmount;
+uniform float offset;
+uniform float threshold; // bright pass threshold, negative to disable
+uniform float knee;      // width of the soft threshold transition
+
+vec3 brightPass(vec3 color) {
+    if (threshold < 0.0)
+        return color;
+
+    float brightness = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-5);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 1e-5);
+    return color * contribution;
+}
 
+// Dual-Kawase downsample: five bilinear taps, each averaging a 2x2 texel block
 void main()
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    col = mix(col, fadeColor, clamp(fadeAmount, 0.0, 1.0));
-    FragColor = vec4(col, 1.0);
+    vec2 o = offset / vec2(textureSize(screenTexture, 0));
+    vec3 sum = brightPass(texture(screenTexture, TexCoords).rgb) * 4.0;
+    sum += brightPass(texture(screenTexture, TexCoords - o).rgb);
+    sum += brightPass(texture(screenTexture, TexCoords + o).rgb);
+    sum += brightPass(texture(screenTexture, TexCoords + vec2(o.x, -o.y)).rgb);
+    sum += brightPass(texture(screenTexture, TexCoords - vec2(o.x, -o.y)).rgb);
+    FragColor = vec4(sum / 8.0, 1.0);
 })";
 
-inline const std::string bloom_frag_shader_source = R"(
+inline const std::string kawase_up_frag_shader_source = R"(
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoords;
 
 uniform sampler2D screenTexture;
-uniform float time;
-uniform float threshold;
-uniform float intensity;
-
-vec3 applyBloom(sampler2D tex, vec2 texCoord) {
-    vec3 color = texture(tex, texCoord).rgb;
-    float brightness = dot(color, vec3(0.2126, 0.7152, 0.0722));
-    vec3 brightPass = color * step(threshold, brightness);
-    return color + brightPass * intensity;
-}
+uniform sampler2D baseTexture; // same resolution level of the downsample chain
+uniform float offset;
+uniform float baseWeight;      // > 0 accumulates the level (bloom), 0 for a plain blur
 
+// Dual-Kawase upsample: eight bilinear taps on a tent around the target texel
 void main()
 {
-    vec3 col = applyBloom(screenTexture, TexCoords);
+    vec2 h = offset * 0.5 / vec2(textureSize(screenTexture, 0));
+    vec3 sum = texture(screenTexture, TexCoords + vec2(-h.x * 2.0, 0.0)).rgb;
+    sum += texture(screenTexture, TexCoords + vec2(-h.x, h.y)).rgb * 2.0;
+    sum += texture(screenTexture, TexCoords + vec2(0.0, h.y * 2.0)).rgb;
+    sum += texture(screenTexture, TexCoords + vec2(h.x, h.y)).rgb * 2.0;
+    sum += texture(screenTexture, TexCoords + vec2(h.x * 2.0, 0.0)).rgb;
+    sum += texture(screenTexture, TexCoords + vec2(h.x, -h.y)).rgb * 2.0;
+    sum += texture(screenTexture, TexCoords + vec2(0.0, -h.y * 2.0)).rgb;
+    sum += texture(screenTexture, TexCoords + vec2(-h.x, -h.y)).rgb * 2.0;
+    vec3 col = sum / 12.0;
+
+    if (baseWeight > 0.0)
+        col += texture(baseTexture, TexCoords).rgb * baseWeight;
+
     FragColor = vec4(col, 1.0);
 })";
 
-inline const std::string dither_frag_shader_source = R"(
+inline const std::string separable_gaussian_frag_shader_source = R"(
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoords;
 
-uniform float time;
-
 uniform sampler2D screenTexture;
-uniform float ditherMatrix[16] = float[](
+uniform vec2 direction; // (1, 0) horizontal, (0, 1) vertical
+
+// 9-tap Gaussian using linear filtering, 5 fetches per direction
+const float offsets[3] = float[](0.0, 1.3846153846, 3.2307692308);
+const float weights[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main()
+{
+    vec2 texel = direction / vec2(textureSize(screenTexture, 0));
+    vec3 sum = texture(screenTexture, TexCoords).rgb * weights[0];
+
+    for (int i = 1; i < 3; i++)
+    {
+        sum += texture(screenTexture, TexCoords + texel * offsets[i]).rgb * weights[i];
+        sum += texture(screenTexture, TexCoords - texel * offsets[i]).rgb * weights[i];
+    }
+
+    FragColor = vec4(sum, 1.0);
+})";
+
+inline const std::string dither_pointwise_source = R"(
+const float $ditherMatrix[16] = float[](
     0.0/16.0, 8.0/16.0, 2.0/16.0, 10.0/16.0,
     12.0/16.0, 4.0/16.0, 14.0/16.0, 6.0/16.0,
     3.0/16.0, 11.0/16.0, 1.0/16.0, 9.0/16.0,
     15.0/16.0, 7.0/16.0, 13.0/16.0, 5.0/16.0
 );
 
-vec3 applyDithering(vec3 color, vec2 pos) {
+vec3 $apply(vec3 color, vec2 uv)
+{
     int x = int(mod(gl_FragCoord.x, 4.0));
     int y = int(mod(gl_FragCoord.y, 4.0));
-    float threshold = ditherMatrix[y * 4 + x];
+    float threshold = $ditherMatrix[y * 4 + x];
     return step(threshold, color);
-}
-
-void main()
-{
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    col = applyDithering(col, gl_FragCoord.xy);
-    FragColor = vec4(col, 1.0);
 })";
 
 inline const std::string pixelate_frag_shader_source = R"(
@@ -404,112 +449,82 @@ void main()
     FragColor = vec4(r, g, b, 1.0);
 })";
 
-inline const std::string scanline_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
+inline const std::string scanline_pointwise_source = R"(
+uniform float $lineSpacing;
+uniform float $lineIntensity;
+uniform float $scrollSpeed;
 
-uniform sampler2D screenTexture;
-uniform float time;
-uniform float lineSpacing;
-uniform float lineIntensity;
-uniform float scrollSpeed;
-
-void main()
+vec3 $apply(vec3 color, vec2 uv)
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    float scanline = sin((gl_FragCoord.y / lineSpacing + time * scrollSpeed) * 3.14159) * 0.5 + 0.5;
-    col *= 1.0 - lineIntensity * (1.0 - scanline);
-    FragColor = vec4(col, 1.0);
+    float scanline = sin((gl_FragCoord.y / $lineSpacing + time * $scrollSpeed) * 3.14159) * 0.5 + 0.5;
+    return color * (1.0 - $lineIntensity * (1.0 - scanline));
 })";
 
-inline const std::string posterize_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
-
-uniform sampler2D screenTexture;
-uniform float time;
-uniform float levels;
+inline const std::string posterize_pointwise_source = R"(
+uniform float $levels;
 
-void main()
+vec3 $apply(vec3 color, vec2 uv)
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    col = floor(col * levels) / levels;
-    FragColor = vec4(col, 1.0);
+    return floor(color * $levels) / $levels;
 })";
 
-inline const std::string color_grading_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
-
-uniform sampler2D screenTexture;
-uniform float time;
-uniform vec3 shadows;
-uniform vec3 midtones;
-uniform vec3 highlights;
-uniform float contrast;
-uniform float saturation;
+inline const std::string color_grading_pointwise_source = R"(
+uniform vec3 $shadows;
+uniform vec3 $midtones;
+uniform vec3 $highlights;
+uniform float $contrast;
+uniform float $saturation;
 
-void main()
+vec3 $apply(vec3 color, vec2 uv)
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-
     // Contrast
-    col = (col - 0.5) * contrast + 0.5;
+    vec3 col = (color - 0.5) * $contrast + 0.5;
 
     // Saturation
     float lum = dot(col, vec3(0.2126, 0.7152, 0.0722));
-    col = mix(vec3(lum), col, saturation);
+    col = mix(vec3(lum), col, $saturation);
 
     // Zone-based color lift
     float s = clamp(1.0 - lum * 2.0, 0.0, 1.0);       // shadows zone
     float h = clamp((lum - 0.5) * 2.0, 0.0, 1.0);      // highlights zone
     float m = 1.0 - s - h;                               // midtones zone
-    col += s * (shadows - 0.5) * 0.5
-         + m * (midtones - 0.5) * 0.5
-         + h * (highlights - 0.5) * 0.5;
+    col += s * ($shadows - 0.5) * 0.5
+         + m * ($midtones - 0.5) * 0.5
+         + h * ($highlights - 0.5) * 0.5;
 
-    FragColor = vec4(clamp(col, 0.0, 1.0), 1.0);
+    return clamp(col, 0.0, 1.0);
 })";
 
-inline const std::string night_vision_frag_shader_source = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoords;
+inline const std::string night_vision_pointwise_source = R"(
+uniform float $noiseIntensity;
+uniform float $glowStrength;
+uniform vec3 $phosphorColor;
 
-uniform sampler2D screenTexture;
-uniform float time;
-uniform float noiseIntensity;
-uniform float glowStrength;
-uniform vec3 phosphorColor;
-
-float rand(vec2 co) {
+float $rand(vec2 co)
+{
     return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
 }
 
-void main()
+vec3 $apply(vec3 color, vec2 uv)
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
-    float lum = dot(col, vec3(0.2126, 0.7152, 0.0722));
+    float lum = dot(color, vec3(0.2126, 0.7152, 0.0722));
 
     // Animated noise
-    float noise = rand(TexCoords + fract(time * 0.1)) * noiseIntensity;
+    float noise = $rand(uv + fract(time * 0.1)) * $noiseIntensity;
     lum = clamp(lum + noise, 0.0, 1.0);
 
     // Phosphor tint
-    vec3 tinted = lum * phosphorColor;
+    vec3 tinted = lum * $phosphorColor;
 
     // Soft glow
-    tinted += phosphorColor * lum * lum * glowStrength;
+    tinted += $phosphorColor * lum * lum * $glowStrength;
 
     // Radial vignette
-    vec2 pos = (TexCoords - 0.5) * 2.0;
+    vec2 pos = (uv - 0.5) * 2.0;
     float vignette = smoothstep(1.4, 0.6, length(pos));
     tinted *= vignette;
 
-    FragColor = vec4(clamp(tinted, 0.0, 1.0), 1.0);
+    return clamp(tinted, 0.0, 1.0);
 })";
 
 inline const std::string feedback_frag_shader_source = R"(
@@ -17,6 +17,9 @@ public:
     void setLevels(float levels);
     float levels() const;
 
+    bool isPointwise() const override;
+    std::string pointwiseSource() const override;
+
 protected:
     virtual void doLoad() override;
     virtual void doUpdateParams() override;
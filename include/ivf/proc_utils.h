@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <cmath>
+#include <span>
 #include <glm/glm.hpp>
 
 namespace ivf {
@@ -17,6 +18,11 @@ namespace ivf {
  *
  * This namespace provides various noise functions and pattern generators
  * that can be used to create procedural textures.
+ *
+ * Most noise functions also have a batch form taking spans of coordinates.
+ * These evaluate 4 (SSE2) or 8 (AVX2) samples per instruction, selected at
+ * runtime for the CPU, and return the same values as the scalar functions up
+ * to rounding. The spans of a call must have the same length.
  */
 namespace ProcUtils {
 
@@ -159,6 +165,248 @@ float clamp01(float value);
  */
 float remap(float value, float inMin, float inMax, float outMin, float outMax);
 
+/**
+ * @brief 3D gradient noise, the 3D counterpart of noise(x, y).
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @return float Noise value in approximately [-1, 1].
+ */
+float noise(float x, float y, float z);
+
+/**
+ * @brief 2D gradient noise with its analytic derivatives.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return glm::vec3 Noise value (same as noise(x, y)), d/dx and d/dy.
+ */
+glm::vec3 noiseDeriv(float x, float y);
+
+/**
+ * @brief 3D gradient noise with its analytic derivatives.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @return glm::vec4 Noise value (same as noise(x, y, z)), d/dx, d/dy and d/dz.
+ */
+glm::vec4 noiseDeriv(float x, float y, float z);
+
+/**
+ * @brief 2D value noise, smoothly interpolated random values at integer points.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return float Noise value in [-1, 1].
+ */
+float valueNoise(float x, float y);
+
+/**
+ * @brief 3D value noise.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @return float Noise value in [-1, 1].
+ */
+float valueNoise(float x, float y, float z);
+
+/**
+ * @brief 2D simplex noise.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return float Noise value in approximately [-1, 1].
+ */
+float simplex(float x, float y);
+
+/**
+ * @brief 3D simplex noise.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @return float Noise value in approximately [-1, 1].
+ */
+float simplex(float x, float y, float z);
+
+/**
+ * @brief 4D simplex noise, e.g. 3D noise animated over time.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @param w W coordinate.
+ * @return float Noise value in approximately [-1, 1].
+ */
+float simplex(float x, float y, float z, float w);
+
+/**
+ * @brief 3D fractional Brownian motion using noise(x, y, z).
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @param octaves Number of noise layers to combine.
+ * @param persistence Amplitude multiplier for each octave.
+ * @param lacunarity Frequency multiplier for each octave.
+ * @return float Combined noise value.
+ */
+float fbm(float x, float y, float z, int octaves = 4, float persistence = 0.5f, float lacunarity = 2.0f);
+
+// ---- Batch evaluation ------------------------------------------------------
+
+/**
+ * @enum SimdLevel
+ * @brief Instruction sets used by the batch noise functions.
+ */
+enum class SimdLevel {
+    Scalar, ///< One sample at a time.
+    SSE2,   ///< 4 samples per instruction.
+    AVX2    ///< 8 samples per instruction.
+};
+
+/**
+ * @brief Get the instruction set used by the batch functions.
+ * @return SimdLevel Active level, by default the best one supported by the CPU.
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief Get the best instruction set supported by the CPU and the build.
+ * @return SimdLevel Supported level.
+ */
+SimdLevel supportedSimdLevel();
+
+/**
+ * @brief Select the instruction set used by the batch functions, e.g. for comparisons.
+ * @param level Requested level, lowered to supportedSimdLevel() if not available.
+ */
+void setSimdLevel(SimdLevel level);
+
+/**
+ * @brief Batch form of noise(x, y).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Noise values.
+ */
+void noise(std::span<const float> x, std::span<const float> y, std::span<float> out);
+
+/**
+ * @brief Batch form of noise(x, y, z).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param out Noise values.
+ */
+void noise(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out);
+
+/**
+ * @brief Batch form of noiseDeriv(x, y).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Noise values.
+ * @param dx Derivatives along x.
+ * @param dy Derivatives along y.
+ */
+void noiseDeriv(std::span<const float> x, std::span<const float> y, std::span<float> out, std::span<float> dx,
+                std::span<float> dy);
+
+/**
+ * @brief Batch form of noiseDeriv(x, y, z).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param out Noise values.
+ * @param dx Derivatives along x.
+ * @param dy Derivatives along y.
+ * @param dz Derivatives along z.
+ */
+void noiseDeriv(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out,
+                std::span<float> dx, std::span<float> dy, std::span<float> dz);
+
+/**
+ * @brief Batch form of valueNoise(x, y).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Noise values.
+ */
+void valueNoise(std::span<const float> x, std::span<const float> y, std::span<float> out);
+
+/**
+ * @brief Batch form of valueNoise(x, y, z).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param out Noise values.
+ */
+void valueNoise(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                std::span<float> out);
+
+/**
+ * @brief Batch form of simplex(x, y).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Noise values.
+ */
+void simplex(std::span<const float> x, std::span<const float> y, std::span<float> out);
+
+/**
+ * @brief Batch form of simplex(x, y, z).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param out Noise values.
+ */
+void simplex(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out);
+
+/**
+ * @brief Batch form of simplex(x, y, z, w).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param w W coordinates.
+ * @param out Noise values.
+ */
+void simplex(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+             std::span<const float> w, std::span<float> out);
+
+/**
+ * @brief Batch form of voronoi(x, y, cellSize).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Distances to the nearest cell center.
+ * @param cellSize Size of Voronoi cells.
+ */
+void voronoi(std::span<const float> x, std::span<const float> y, std::span<float> out, float cellSize = 1.0f);
+
+/**
+ * @brief Batch form of fbm(x, y, octaves, persistence, lacunarity).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Combined noise values.
+ * @param octaves Number of noise layers to combine.
+ * @param persistence Amplitude multiplier for each octave.
+ * @param lacunarity Frequency multiplier for each octave.
+ */
+void fbm(std::span<const float> x, std::span<const float> y, std::span<float> out, int octaves = 4,
+         float persistence = 0.5f, float lacunarity = 2.0f);
+
+/**
+ * @brief Batch form of fbm(x, y, z, octaves, persistence, lacunarity).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param out Combined noise values.
+ * @param octaves Number of noise layers to combine.
+ * @param persistence Amplitude multiplier for each octave.
+ * @param lacunarity Frequency multiplier for each octave.
+ */
+void fbm(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out,
+         int octaves = 4, float persistence = 0.5f, float lacunarity = 2.0f);
+
+/**
+ * @brief Batch form of turbulence(x, y, octaves).
+ * @param x X coordinates.
+ * @param y Y coordinates.
+ * @param out Turbulence values.
+ * @param octaves Number of octaves.
+ */
+void turbulence(std::span<const float> x, std::span<const float> y, std::span<float> out, int octaves = 4);
+
 } // namespace ProcUtils
 
 } // namespace ivf
@@ -8,6 +8,10 @@
 #include <ivf/texture.h>
 #include <ivf/proc_utils.h>
 #include <glm/glm.hpp>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
 #include <vector>
 
 namespace ivf {
@@ -18,20 +22,63 @@ namespace ivf {
  *
  * ProceduralTexture extends the Texture class to support CPU-side generation
  * of texture data using mathematical functions and noise algorithms.
+ *
+ * Derived classes describe their pattern with a row kernel (see makeKernel()) that
+ * fills a horizontal run of pixels per call. The image is split into square tiles
+ * that are generated concurrently, so a kernel never pays a virtual call per pixel
+ * and large textures scale with the number of cores.
+ *
+ * regenerate() generates and uploads on the calling thread (using the ThreadPool).
+ * regenerateAsync() generates on background threads instead; update() must then be
+ * called once per frame from the thread owning the GL context, it uploads the result
+ * through a pixel buffer object as soon as it is done and sets the ready() flag.
  */
 class ProceduralTexture : public Texture {
+public:
+    /**
+     * @brief Kernel generating a run of pixels of one row.
+     *
+     * Called as kernel(x, y, count, out) to write the colors of pixels (x, y) ..
+     * (x + count - 1, y) to out[0] .. out[count - 1]. Kernels are called concurrently
+     * from worker threads and should only use state captured when they were created.
+     */
+    using RowKernel = std::function<void(int x, int y, int count, glm::vec4 *out)>;
+
 protected:
-    int m_width{512};                            ///< Texture width in pixels.
-    int m_height{512};                           ///< Texture height in pixels.
-    int m_channels{4};                           ///< Number of color channels (3=RGB, 4=RGBA).
-    std::vector<unsigned char> m_data;           ///< Generated texture data.
-    bool m_needsRegeneration{true};              ///< Flag indicating if texture needs regeneration.
+    int m_width{512};                  ///< Texture width in pixels.
+    int m_height{512};                 ///< Texture height in pixels.
+    int m_channels{4};                 ///< Number of color channels (3=RGB, 4=RGBA).
+    std::vector<unsigned char> m_data; ///< Generated texture data.
+    bool m_needsRegeneration{true};    ///< Flag indicating if texture needs regeneration.
+    int m_tileSize{64};                ///< Width and height of a generation tile in pixels.
+
+    /**
+     * @brief Generate the procedural texture data into m_data.
+     *
+     * The default implementation runs the kernel from makeKernel() over all tiles
+     * in parallel. Derived classes may override it, it is only used by regenerate().
+     */
+    virtual void generate();
 
     /**
-     * @brief Generate the procedural texture data.
-     * Must be implemented by derived classes.
+     * @brief Create the row kernel used to generate the texture.
+     *
+     * The default implementation calls getPixel() for every pixel. Since it reads
+     * the parameters of the texture while running, derived classes should override
+     * this with a kernel capturing a copy of their parameters, which is also faster.
+     * Derived classes using the default kernel with regenerateAsync() must call
+     * cancelGeneration() in their destructor, as getPixel() is unavailable once the
+     * derived part has been destroyed.
+     * @return RowKernel Kernel for the current parameters.
      */
-    virtual void generate() = 0;
+    virtual RowKernel makeKernel();
+
+    /**
+     * @brief Stop a running background generation and wait for its threads to finish.
+     *
+     * The result of the stopped generation is discarded.
+     */
+    void cancelGeneration();
 
     /**
      * @brief Get a pixel value at normalized coordinates.
@@ -49,6 +96,23 @@ protected:
      */
     void setPixel(int x, int y, const glm::vec4 &color);
 
+private:
+    GLuint m_pbo{0};           ///< Pixel unpack buffer used by upload().
+    int m_uploadedWidth{0};    ///< Width of the allocated GL texture storage.
+    int m_uploadedHeight{0};   ///< Height of the allocated GL texture storage.
+    int m_uploadedChannels{0}; ///< Channel count of the allocated GL texture storage.
+    bool m_ready{false};       ///< True when the uploaded texture matches the last requested generation.
+
+    std::future<void> m_job;                               ///< Running background generation.
+    std::shared_ptr<std::atomic<bool>> m_jobCancel;        ///< Cancellation flag of the running job.
+    std::shared_ptr<std::vector<unsigned char>> m_jobData; ///< Pixels written by the running job.
+    int m_jobWidth{0};                                     ///< Width generated by the running job.
+    int m_jobHeight{0};                                    ///< Height generated by the running job.
+    int m_jobChannels{0};                                  ///< Channel count generated by the running job.
+    bool m_jobRestart{false};                              ///< Start a new job when the running one stops.
+
+    void startJob();
+
 public:
     /**
      * @brief Constructor.
@@ -56,7 +120,7 @@ public:
     ProceduralTexture();
 
     /**
-     * @brief Virtual destructor.
+     * @brief Virtual destructor. Waits for a running background generation to stop.
      */
     virtual ~ProceduralTexture();
 
@@ -85,14 +149,57 @@ public:
      */
     void setChannels(int channels);
 
+    /**
+     * @brief Set the size of the square tiles the image is split into for generation.
+     * @param size Tile width and height in pixels.
+     */
+    void setTileSize(int size);
+
+    /**
+     * @brief Get the generation tile size.
+     * @return int Tile width and height in pixels.
+     */
+    int tileSize() const { return m_tileSize; }
+
     /**
      * @brief Regenerate and upload the texture to the GPU.
-     * Call this after changing parameters to update the texture.
+     * Call this after changing parameters to update the texture. Blocks until the
+     * texture is generated; a running background generation is cancelled.
      */
     void regenerate();
 
     /**
-     * @brief Upload the generated data to OpenGL.
+     * @brief Start regenerating the texture on background threads.
+     *
+     * Returns immediately, the previous texture contents stay in use until update()
+     * uploads the new ones. Calling this while a generation is running cancels it and
+     * starts over with the current parameters, so it can be called for every edit.
+     */
+    void regenerateAsync();
+
+    /**
+     * @brief Upload the result of a finished background generation.
+     *
+     * Must be called regularly (e.g. once per frame) from the thread owning the GL
+     * context when regenerateAsync() is used.
+     * @return bool True if a new texture was uploaded.
+     */
+    bool update();
+
+    /**
+     * @brief Check if the texture holds the result of the last requested generation.
+     * @return bool True when generated and uploaded.
+     */
+    bool ready() const;
+
+    /**
+     * @brief Check if a background generation is running.
+     * @return bool True while generating.
+     */
+    bool generating() const;
+
+    /**
+     * @brief Upload the generated data to OpenGL through a pixel buffer object.
      */
     void upload();
 
@@ -100,6 +207,12 @@ public:
      * @brief Mark the texture as needing regeneration.
      */
     void setNeedsRegeneration(bool flag = true);
+
+    /**
+     * @brief Check if parameters have changed since the texture was last generated.
+     * @return bool True if regeneration is needed.
+     */
+    bool needsRegeneration() const { return m_needsRegeneration; }
 };
 
 /**
@@ -118,12 +231,12 @@ using ProceduralTexturePtr = std::shared_ptr<ProceduralTexture>;
  */
 class CheckerboardTexture : public ProceduralTexture {
 private:
-    int m_checkerSize{32};                       ///< Size of each checker in pixels.
+    int m_checkerSize{32};                      ///< Size of each checker in pixels.
     glm::vec4 m_color1{1.0f, 1.0f, 1.0f, 1.0f}; ///< First checker color (white).
     glm::vec4 m_color2{0.0f, 0.0f, 0.0f, 1.0f}; ///< Second checker color (black).
 
 protected:
-    void generate() override;
+    RowKernel makeKernel() override;
     glm::vec4 getPixel(float u, float v) override;
 
 public:
@@ -164,15 +277,15 @@ using CheckerboardTexturePtr = std::shared_ptr<CheckerboardTexture>;
  */
 class PerlinNoiseTexture : public ProceduralTexture {
 private:
-    float m_scale{4.0f};                         ///< Noise scale.
-    int m_octaves{4};                            ///< Number of noise octaves.
-    float m_persistence{0.5f};                   ///< Amplitude decay per octave.
-    float m_lacunarity{2.0f};                    ///< Frequency increase per octave.
-    glm::vec4 m_colorLow{0.0f, 0.0f, 0.0f, 1.0f}; ///< Color for low noise values.
+    float m_scale{4.0f};                           ///< Noise scale.
+    int m_octaves{4};                              ///< Number of noise octaves.
+    float m_persistence{0.5f};                     ///< Amplitude decay per octave.
+    float m_lacunarity{2.0f};                      ///< Frequency increase per octave.
+    glm::vec4 m_colorLow{0.0f, 0.0f, 0.0f, 1.0f};  ///< Color for low noise values.
     glm::vec4 m_colorHigh{1.0f, 1.0f, 1.0f, 1.0f}; ///< Color for high noise values.
 
 protected:
-    void generate() override;
+    RowKernel makeKernel() override;
     glm::vec4 getPixel(float u, float v) override;
 
 public:
@@ -232,19 +345,19 @@ using PerlinNoiseTexturePtr = std::shared_ptr<PerlinNoiseTexture>;
 class GradientTexture : public ProceduralTexture {
 public:
     enum class GradientType {
-        Linear,  ///< Linear gradient.
-        Radial   ///< Radial gradient from center.
+        Linear, ///< Linear gradient.
+        Radial  ///< Radial gradient from center.
     };
 
 private:
     GradientType m_type{GradientType::Linear};
     glm::vec4 m_colorStart{0.0f, 0.0f, 0.0f, 1.0f}; ///< Start color.
     glm::vec4 m_colorEnd{1.0f, 1.0f, 1.0f, 1.0f};   ///< End color.
-    float m_angle{0.0f};                             ///< Gradient angle (radians, for linear).
-    glm::vec2 m_center{0.5f, 0.5f};                  ///< Center point (for radial).
+    float m_angle{0.0f};                            ///< Gradient angle (radians, for linear).
+    glm::vec2 m_center{0.5f, 0.5f};                 ///< Center point (for radial).
 
 protected:
-    void generate() override;
+    RowKernel makeKernel() override;
     glm::vec4 getPixel(float u, float v) override;
 
 public:
@@ -297,13 +410,13 @@ using GradientTexturePtr = std::shared_ptr<GradientTexture>;
  */
 class MarbleTexture : public ProceduralTexture {
 private:
-    float m_scale{1.0f};                         ///< Pattern scale.
-    int m_octaves{4};                            ///< Number of noise octaves.
+    float m_scale{1.0f};                        ///< Pattern scale.
+    int m_octaves{4};                           ///< Number of noise octaves.
     glm::vec4 m_color1{0.9f, 0.9f, 0.9f, 1.0f}; ///< Light marble color.
     glm::vec4 m_color2{0.3f, 0.3f, 0.3f, 1.0f}; ///< Dark marble color.
 
 protected:
-    void generate() override;
+    RowKernel makeKernel() override;
     glm::vec4 getPixel(float u, float v) override;
 
 public:
@@ -350,13 +463,13 @@ using MarbleTexturePtr = std::shared_ptr<MarbleTexture>;
  */
 class WoodTexture : public ProceduralTexture {
 private:
-    float m_scale{1.0f};                         ///< Pattern scale.
-    float m_rings{10.0f};                        ///< Number of rings.
+    float m_scale{1.0f};                        ///< Pattern scale.
+    float m_rings{10.0f};                       ///< Number of rings.
     glm::vec4 m_color1{0.6f, 0.4f, 0.2f, 1.0f}; ///< Light wood color.
     glm::vec4 m_color2{0.3f, 0.2f, 0.1f, 1.0f}; ///< Dark wood color.
 
 protected:
-    void generate() override;
+    RowKernel makeKernel() override;
     glm::vec4 getPixel(float u, float v) override;
 
 public:
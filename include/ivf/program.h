@@ -31,6 +31,7 @@ protected:
     std::vector<std::shared_ptr<Shader>> m_shaders; ///< Attached shaders.
     GLuint m_id;                                    ///< OpenGL program object ID.
     bool m_enabled;                                 ///< Whether the program is currently enabled.
+    std::vector<std::string> m_feedbackVaryings;    ///< Outputs captured with transform feedback.
 
 public:
     /**
@@ -66,6 +67,14 @@ public:
      */
     size_t shaderCount();
 
+    /**
+     * @brief Set the vertex shader outputs captured with transform feedback, in buffer order.
+     *
+     * Takes effect at the next link(). The outputs are written interleaved to one buffer.
+     * @param varyings Names of the outputs.
+     */
+    void setFeedbackVaryings(const std::vector<std::string> &varyings);
+
     /**
      * @brief Link the attached shaders into a complete program.
      * @return bool True if linking succeeded.
@@ -218,6 +227,20 @@ public:
      */
     void uniformVec3f(GLint id, float v0, float v1, float v2);
 
+    /**
+     * @brief Set a vec2 uniform by name using a glm::vec2.
+     * @param name Uniform variable name.
+     * @param v Vector value.
+     */
+    void uniformVec2(std::string_view name, const glm::vec2 v);
+
+    /**
+     * @brief Set a vec2 uniform by location using a glm::vec2.
+     * @param id Uniform location.
+     * @param v Vector value.
+     */
+    void uniformVec2(GLint id, const glm::vec2 v);
+
     /**
      * @brief Set a vec3 uniform by name using a glm::vec3.
      * @param name Uniform variable name.
@@ -268,6 +291,14 @@ public:
      */
     void uniformIntArray(std::string_view name, int count, const int *values);
 
+    /**
+     * @brief Set a vec4 array uniform by name.
+     * @param name Uniform variable name.
+     * @param count Number of elements.
+     * @param values Pointer to the array of glm::vec4.
+     */
+    void uniformVec4Array(std::string_view name, int count, const glm::vec4 *values);
+
     /**
      * @brief Set a mat4 array uniform by name.
      * @param name Uniform variable name.
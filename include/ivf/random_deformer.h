@@ -17,6 +17,8 @@ namespace ivf {
  * and deformation modes (absolute, additive, directional, radial, surface normal). It provides
  * configuration for noise intensity, frequency, offset, direction, center, time, seed, and fractal parameters.
  * The deformer caches per-vertex noise for consistency and supports animated and procedural effects.
+ * Each input slot (see Deformer::setInputSlot()) has a cache of its own, so the meshes of a node get
+ * noise from their own positions. Fused evaluation is only used for a single input.
  */
 class RandomDeformer : public Deformer {
 public:
@@ -66,8 +68,14 @@ private:
     mutable std::normal_distribution<float> m_gaussianDist;
 
     // Per-vertex noise cache for consistency
-    mutable std::vector<glm::vec3> m_noiseCache;
-    mutable bool m_cacheValid;
+    struct NoiseCache {
+        std::vector<glm::vec3> noise; ///< Noise per vertex.
+        bool valid{false};            ///< False if the noise must be generated again.
+        glm::vec3 bound{0.0f};        ///< Largest absolute noise component.
+        float length{0.0f};           ///< Largest noise length.
+    };
+
+    std::vector<NoiseCache> m_caches; ///< Noise cache per input slot.
 
 public:
     /**
@@ -244,6 +252,29 @@ public:
      * @brief Apply the deformation to the input vertices.
      */
     virtual void apply() override;
+
+    /**
+     * @brief Prepare a fused evaluation pass.
+     * @param vertexCount Number of vertices of the pass.
+     * @return True for a single input whose noise cache has been generated for vertexCount vertices.
+     */
+    virtual bool prepareKernel(GLuint vertexCount) override;
+
+    /**
+     * @brief Displace a block of positions in place.
+     * @param positions Positions of the block.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const override;
+
+    /**
+     * @brief Transform a bounding box of input positions into a box of the displaced positions.
+     * @param bbox Box of the input positions, replaced by the box of the displaced positions.
+     * @return True if the noise has been generated for all inputs.
+     */
+    virtual bool transformBounds(BoundingBox &bbox) const override;
+
     /**
      * @brief Create a copy of the deformer for animation keyframes.
      * @return Unique pointer to the cloned Deformer.
@@ -274,6 +305,12 @@ protected:
      * @brief Register properties for inspection.
      */
     virtual void setupProperties() override;
+
+    /**
+     * @brief Invalidate the noise cache when a property is edited.
+     * @param propertyName Name of the property that changed.
+     */
+    virtual void onPropertyChanged(const std::string &propertyName) override;
 };
 
 /**
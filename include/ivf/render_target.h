@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ivf/glbase.h>
+
+#include <memory>
+#include <string>
+
+namespace ivf {
+
+/**
+ * @struct RenderTargetDesc
+ * @brief Size, formats and sample count of a render target; the key of the RenderTargetPool.
+ */
+struct RenderTargetDesc {
+    int width{0};                   ///< Width in pixels.
+    int height{0};                  ///< Height in pixels.
+    GLenum colorFormat{GL_RGBA16F}; ///< Internal format of the color texture, GL_NONE for depth-only targets.
+    GLenum depthFormat{GL_NONE};    ///< Internal format of the depth attachment, GL_NONE for no depth.
+    int samples{0};                 ///< Sample count, 0 for single-sampled targets.
+    bool depthTexture{false};       ///< Store depth in a sampleable texture instead of a renderbuffer.
+
+    bool operator==(const RenderTargetDesc &other) const;
+
+    /**
+     * @brief Get the estimated memory use of a target with this description.
+     * @return size_t Size in bytes.
+     */
+    size_t byteSize() const;
+
+    /**
+     * @brief Get a readable name of the target class (formats and sample count, without size).
+     * @return std::string Class name, e.g. "RGBA16F+D24 x4".
+     */
+    std::string className() const;
+};
+
+/**
+ * @class RenderTarget
+ * @brief Framebuffer object with an optional color texture and depth attachment.
+ *
+ * Render targets are normally not created directly but acquired from the RenderTargetPool, which
+ * reuses targets with a matching RenderTargetDesc between passes and frames. Color textures use
+ * linear filtering and clamp to edge; owners needing other sampling state set it after acquiring.
+ */
+class RenderTarget : public GLBase {
+private:
+    RenderTargetDesc m_desc;      ///< Size and formats.
+    GLuint m_fbo{0};              ///< Framebuffer object.
+    GLuint m_texture{0};          ///< Color attachment.
+    GLuint m_depthTexture{0};     ///< Depth attachment when stored as a texture.
+    GLuint m_depthRenderbuffer{0}; ///< Depth attachment when stored as a renderbuffer.
+
+public:
+    /**
+     * @brief Constructor. Allocates the framebuffer and its attachments.
+     * @param desc Size and formats.
+     */
+    RenderTarget(const RenderTargetDesc &desc);
+
+    /**
+     * @brief Destructor. Releases the OpenGL objects.
+     */
+    virtual ~RenderTarget();
+
+    /**
+     * @brief Factory method to create a shared pointer to a RenderTarget instance.
+     * @param desc Size and formats.
+     * @return std::shared_ptr<RenderTarget> New RenderTarget instance.
+     */
+    static std::shared_ptr<RenderTarget> create(const RenderTargetDesc &desc);
+
+    /**
+     * @brief Bind the framebuffer and set the viewport to cover it.
+     */
+    void bind();
+
+    /**
+     * @brief Get the framebuffer object.
+     * @return GLuint Framebuffer id.
+     */
+    GLuint fbo() const;
+
+    /**
+     * @brief Get the color texture (GL_TEXTURE_2D_MULTISAMPLE for multisampled targets).
+     * @return GLuint Texture id, 0 for depth-only targets.
+     */
+    GLuint texture() const;
+
+    /**
+     * @brief Get the depth texture.
+     * @return GLuint Texture id, 0 unless the description requests a depth texture.
+     */
+    GLuint depthTexture() const;
+
+    /**
+     * @brief Get the description the target was created with.
+     * @return const RenderTargetDesc& Description.
+     */
+    const RenderTargetDesc &desc() const;
+
+    /**
+     * @brief Get the width.
+     * @return int Width in pixels.
+     */
+    int width() const;
+
+    /**
+     * @brief Get the height.
+     * @return int Height in pixels.
+     */
+    int height() const;
+
+    /**
+     * @brief Get the internal format of the color texture.
+     * @return GLenum Internal format.
+     */
+    GLenum format() const;
+};
+
+/**
+ * @typedef RenderTargetPtr
+ * @brief Shared pointer type for RenderTarget.
+ */
+typedef std::shared_ptr<RenderTarget> RenderTargetPtr;
+
+}; // namespace ivf
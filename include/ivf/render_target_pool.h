@@ -0,0 +1,169 @@
+#pragma once
+
+#include <ivf/render_target.h>
+
+#include <string>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @struct RenderTargetClassStats
+ * @brief Memory use of all pooled targets sharing formats and sample count.
+ */
+struct RenderTargetClassStats {
+    std::string name;  ///< Class name, see RenderTargetDesc::className().
+    size_t targets{0}; ///< Allocated targets (acquired and free).
+    size_t acquired{0}; ///< Targets currently handed out.
+    size_t bytes{0};   ///< Estimated memory use in bytes.
+};
+
+/**
+ * @class RenderTargetPool
+ * @brief Singleton pool of render targets keyed by size, formats and sample count.
+ *
+ * Passes that need an offscreen target acquire one matching a RenderTargetDesc, render into it and
+ * release it as soon as its contents have been consumed. Released targets are handed out again to
+ * later acquire() calls with the same description, so memory is shared between passes whose
+ * lifetimes do not overlap (post-processing ping-pong buffers, downsample chains, generator
+ * targets). Long-lived targets (the scene framebuffer, shadow maps, history buffers) are acquired
+ * once and only exchanged when their owner needs a different size, which makes resizing a lazy
+ * reallocation on next use.
+ *
+ * Released targets that have not been reused for a few frames are deleted by endFrame(), so
+ * targets of an old window size do not stay allocated. Release only transfers ownership back to
+ * the pool; commands already issued that read the target are ordered before any later rendering
+ * into it by OpenGL.
+ */
+class RenderTargetPool {
+private:
+    struct Entry {
+        RenderTargetPtr target;  ///< Released target.
+        unsigned int frame{0};   ///< Frame in which the target was released.
+    };
+
+    std::vector<Entry> m_free;               ///< Released targets available for reuse.
+    std::vector<RenderTargetPtr> m_acquired; ///< Targets currently handed out.
+    size_t m_allocations{0};                 ///< Targets created since the pool was created.
+    unsigned int m_frame{0};                 ///< Frame counter advanced by endFrame().
+    unsigned int m_maxIdleFrames{3};         ///< Frames a released target is kept before deletion.
+
+    static RenderTargetPool *m_instance; ///< Singleton instance pointer.
+
+    RenderTargetPool();
+
+public:
+    virtual ~RenderTargetPool();
+
+    /**
+     * @brief Get the singleton instance.
+     * @return RenderTargetPool* Pointer to the singleton instance.
+     */
+    static RenderTargetPool *instance();
+
+    /**
+     * @brief Create the singleton instance (if not already created).
+     * @return RenderTargetPool* Pointer to the singleton instance.
+     */
+    static RenderTargetPool *create();
+
+    /**
+     * @brief Destroy the singleton instance and all pooled targets.
+     */
+    static void drop();
+
+    /**
+     * @brief Get a render target, reusing a released one with the same description if possible.
+     * @param desc Size, formats and sample count.
+     * @return RenderTargetPtr Render target owned by the caller until released.
+     */
+    RenderTargetPtr acquire(const RenderTargetDesc &desc);
+
+    /**
+     * @brief Get a single-sampled color target without depth.
+     * @param width Width in pixels.
+     * @param height Height in pixels.
+     * @param format Internal format of the color texture.
+     * @return RenderTargetPtr Render target owned by the caller until released.
+     */
+    RenderTargetPtr acquire(int width, int height, GLenum format = GL_RGBA16F);
+
+    /**
+     * @brief Return a render target to the pool.
+     * @param target Target obtained from acquire().
+     */
+    void release(RenderTargetPtr target);
+
+    /**
+     * @brief Exchange a long-lived target for one matching a new description if it differs.
+     * @param target Currently held target (may be nullptr), replaced in place.
+     * @param desc Required description.
+     * @return bool True if a different target was acquired (its contents are undefined).
+     */
+    bool reacquire(RenderTargetPtr &target, const RenderTargetDesc &desc);
+
+    /**
+     * @brief Advance the frame counter and delete released targets idle for too long.
+     */
+    void endFrame();
+
+    /**
+     * @brief Set the number of frames a released target is kept for reuse.
+     * @param frames Frame count.
+     */
+    void setMaxIdleFrames(unsigned int frames);
+
+    /**
+     * @brief Get the number of frames a released target is kept for reuse.
+     * @return unsigned int Frame count.
+     */
+    unsigned int maxIdleFrames() const;
+
+    /**
+     * @brief Delete all released targets.
+     */
+    void clear();
+
+    /**
+     * @brief Get the memory use per target class.
+     * @return std::vector<RenderTargetClassStats> Statistics, largest class first.
+     */
+    std::vector<RenderTargetClassStats> report() const;
+
+    /**
+     * @brief Write the memory use per target class to the log.
+     */
+    void logReport() const;
+
+    /**
+     * @brief Get the estimated memory use of all pooled targets.
+     * @return size_t Size in bytes.
+     */
+    size_t totalBytes() const;
+
+    /**
+     * @brief Get the number of released targets kept for reuse.
+     * @return size_t Target count.
+     */
+    size_t freeCount() const;
+
+    /**
+     * @brief Get the number of targets currently handed out.
+     * @return size_t Target count.
+     */
+    size_t acquiredCount() const;
+
+    /**
+     * @brief Get the number of targets created since the pool was created.
+     * @return size_t Allocation count.
+     */
+    size_t allocationCount() const;
+};
+
+/**
+ * @typedef RenderTargetPoolPtr
+ * @brief Pointer type for RenderTargetPool.
+ */
+typedef RenderTargetPool *RenderTargetPoolPtr;
+
+}; // namespace ivf
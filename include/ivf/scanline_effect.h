@@ -24,6 +24,9 @@ public:
     float lineIntensity() const;
     float scrollSpeed() const;
 
+    bool isPointwise() const override;
+    std::string pointwiseSource() const override;
+
 protected:
     virtual void doLoad() override;
     virtual void doUpdateParams() override;
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <ivf/composite_node.h>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string_view>
+
+namespace ivf {
+
+struct SceneLoadJob;
+
+/**
+ * @struct SceneLoadProgress
+ * @brief Progress of a SceneLoader.
+ */
+struct SceneLoadProgress {
+    size_t nodes{0};          ///< Nodes in the scene file, known when the file has been read.
+    size_t nodesBuilt{0};     ///< Nodes created with their geometry.
+    size_t meshes{0};         ///< Meshes needing OpenGL buffers, known when all nodes are linked.
+    size_t meshesUploaded{0}; ///< Meshes whose OpenGL buffers have been created.
+    bool done{false};         ///< True when loading has finished or failed.
+    bool failed{false};       ///< True if the scene could not be loaded.
+
+    /**
+     * @brief Get the overall progress, node creation and buffer creation counting half each.
+     * @return float Fraction from 0 to 1.
+     */
+    float fraction() const;
+
+    bool operator==(const SceneLoadProgress &) const = default;
+};
+
+/**
+ * @class SceneLoader
+ * @brief Loads a scene file in the background and creates its OpenGL buffers over several frames.
+ *
+ * The scene file is read and its nodes and geometry are created on background threads, separate
+ * from the ThreadPool, while the render thread keeps drawing. update(), called once per frame on the thread owning the OpenGL
+ * context, links the nodes into the scene graph when they are ready and then creates the OpenGL
+ * buffers of at most uploadBudget() bytes of mesh data per frame. root() is available as soon as
+ * the nodes are linked; meshes are drawn once their buffers exist, so the scene fills in
+ * progressively. Node types not registered as thread safe with SceneSerializer::registerType()
+ * are created by update().
+ *
+ * Usage:
+ * @code
+ * auto loader = SceneLoader::create("assets/city.ivfscene");
+ * loader->setProgressCallback([](const SceneLoadProgress &progress) { showProgress(progress.fraction()); });
+ *
+ * // Once per frame, e.g. in onUpdate()
+ * if (loader)
+ * {
+ *     bool linked = loader->root() != nullptr;
+ *     bool done = loader->update();
+ *
+ *     if (!linked && loader->root())
+ *         scene->add(loader->root()); // meshes appear as their buffers are created
+ *
+ *     if (done)
+ *         loader = nullptr;
+ * }
+ * @endcode
+ */
+class SceneLoader {
+private:
+    std::unique_ptr<SceneLoadJob> m_job;                       ///< Scene data, released when done.
+    std::future<void> m_reading;                               ///< Background reading and node creation.
+    CompositeNodePtr m_root;                                   ///< Root of the linked scene.
+    bool m_linked{false};                                      ///< True when the nodes are linked.
+    size_t m_nextMesh{0};                                      ///< Next mesh needing buffers.
+    size_t m_uploadBudget{4 * 1024 * 1024};                    ///< Mesh bytes per update().
+    SceneLoadProgress m_progress;                              ///< Current progress.
+    SceneLoadProgress m_reported;                              ///< Progress passed to the callback.
+    std::function<void(const SceneLoadProgress &)> m_callback; ///< Progress callback.
+
+    void link();
+    void fail(const std::string &message);
+    void report();
+
+public:
+    /**
+     * @brief Constructor, starts loading.
+     * @param path JSON or binary scene file.
+     */
+    SceneLoader(std::string_view path);
+
+    /**
+     * @brief Destructor, waits for the background work to stop.
+     */
+    virtual ~SceneLoader();
+
+    /**
+     * @brief Factory method, starts loading.
+     * @param path JSON or binary scene file.
+     * @return std::shared_ptr<SceneLoader> New loader.
+     */
+    static std::shared_ptr<SceneLoader> create(std::string_view path);
+
+    /**
+     * @brief Link the loaded nodes and create OpenGL buffers within the upload budget.
+     *
+     * Call once per frame on the thread owning the OpenGL context.
+     * @return bool True when loading has finished or failed.
+     */
+    bool update();
+
+    /**
+     * @brief Block until the scene is loaded, creating all remaining buffers.
+     * @return CompositeNodePtr Root node, or nullptr if loading failed.
+     */
+    CompositeNodePtr finish();
+
+    /**
+     * @brief Get the root node of the scene.
+     * @return CompositeNodePtr Root node, nullptr until the nodes are linked or if loading failed.
+     */
+    CompositeNodePtr root() const;
+
+    /**
+     * @brief Set the mesh data whose buffers are created per update(). At least one mesh is created.
+     * @param bytes Size in bytes.
+     */
+    void setUploadBudget(size_t bytes);
+
+    /**
+     * @brief Get the mesh data whose buffers are created per update().
+     * @return size_t Size in bytes.
+     */
+    size_t uploadBudget() const;
+
+    /**
+     * @brief Set a callback receiving the progress when it has changed, called by update() and finish().
+     * @param callback Progress callback.
+     */
+    void setProgressCallback(std::function<void(const SceneLoadProgress &)> callback);
+
+    /**
+     * @brief Get the current progress.
+     * @return const SceneLoadProgress& Progress.
+     */
+    const SceneLoadProgress &progress() const;
+
+    /**
+     * @brief Check if loading has finished or failed.
+     * @return bool True when done.
+     */
+    bool done() const;
+
+    /**
+     * @brief Check if the scene could not be loaded.
+     * @return bool True on failure.
+     */
+    bool failed() const;
+};
+
+/**
+ * @typedef SceneLoaderPtr
+ * @brief Shared pointer type for SceneLoader.
+ */
+typedef std::shared_ptr<SceneLoader> SceneLoaderPtr;
+
+} // namespace ivf
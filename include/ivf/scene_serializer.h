@@ -8,6 +8,13 @@
  * geometry parameters (e.g., Sphere radius, Box size) are round-tripped via
  * the PropertyInspectable interface, so any node that registers its geometry
  * parameters as properties can be fully serialised without special-casing.
+ * The meshes of plain MeshNodes are stored with their vertex and index arrays.
+ *
+ * Scenes can also be stored in a compact binary format (.ivfscene).  Binary
+ * files are memory-mapped on load and their vertex and index arrays are copied
+ * straight into the mesh buffers, which is much faster than parsing JSON for
+ * scenes with large meshes.  JSON and binary files hold the same information
+ * and convertToBinary()/convertToJson() translate between them without loss.
  *
  * Usage:
  * @code
@@ -20,6 +27,10 @@
  * // Load (returns a new CompositeNode; add it to your scene)
  * auto loaded = SceneSerializer::load("my_scene.json");
  * if (loaded) scene->add(loaded);
+ *
+ * // Binary files, load() detects the format
+ * SceneSerializer::saveBinary(scene->sceneRoot(), "my_scene.ivfscene");
+ * auto fast = SceneSerializer::load("my_scene.ivfscene");
  * @endcode
  */
 
@@ -30,6 +41,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -38,6 +50,13 @@
 
 namespace ivf {
 
+namespace SceneBinary {
+class Writer;
+class Reader;
+} // namespace SceneBinary
+
+struct SceneLoadJob;
+
 /**
  * @class SceneSerializer
  * @brief Stateless utility class for JSON scene serialisation/deserialisation.
@@ -57,25 +76,75 @@ public:
     static bool save(CompositeNodePtr root, std::string_view path);
 
     /**
-     * @brief Load a scene graph from a JSON file.
-     * @param path File path to read.
+     * @brief Load a scene graph from a JSON or binary file.
+     *
+     * Nodes and their geometry are created in parallel on the ThreadPool, and the OpenGL buffers
+     * of all meshes are created afterwards on the calling thread, which must own the OpenGL
+     * context. Use SceneLoader to load in the background and spread buffer creation over frames.
+     * @param path File path to read; binary files are recognised by their signature.
      * @return Loaded root CompositeNode, or nullptr on failure.
      */
     static CompositeNodePtr load(std::string_view path);
 
+    // ---- Binary files ------------------------------------------------------
+
+    /**
+     * @brief Save the scene graph rooted at @p root to a binary scene file.
+     * @param root Root composite node.
+     * @param path File path to write.
+     * @return true on success.
+     */
+    static bool saveBinary(CompositeNodePtr root, std::string_view path);
+
+    /**
+     * @brief Load a scene graph from a binary scene file.
+     * @param path File path to read.
+     * @return Loaded root CompositeNode, or nullptr on failure.
+     */
+    static CompositeNodePtr loadBinary(std::string_view path);
+
+    /**
+     * @brief Check if a file is a binary scene file.
+     * @param path File path.
+     * @return true if the file starts with the binary scene signature.
+     */
+    static bool isBinary(std::string_view path);
+
+    /**
+     * @brief Convert a JSON scene file to a binary scene file without loss.
+     *
+     * No nodes are created, so the conversion needs no registered types or
+     * OpenGL context.  Fields without a binary encoding are stored as JSON text.
+     * @param jsonPath JSON file to read.
+     * @param binaryPath Binary file to write.
+     * @return true on success.
+     */
+    static bool convertToBinary(std::string_view jsonPath, std::string_view binaryPath);
+
+    /**
+     * @brief Convert a binary scene file to a JSON scene file without loss.
+     * @param binaryPath Binary file to read.
+     * @param jsonPath JSON file to write.
+     * @return true on success.
+     */
+    static bool convertToJson(std::string_view binaryPath, std::string_view jsonPath);
+
     // ---- Type registry -----------------------------------------------------
 
     /**
      * @brief Register a node type for deserialisation.
-     * @param typeName  The string stored in the "type" JSON field.
-     * @param factory   Zero-argument factory returning a NodePtr.
+     * @param typeName   The string stored in the "type" JSON field.
+     * @param factory    Zero-argument factory returning a NodePtr.
+     * @param threadSafe True if the node and its property changes make no OpenGL calls except
+     *                   through Mesh, so that loading can create it on a worker thread.
      *
      * Example:
      * @code
-     * SceneSerializer::registerType("Sphere", []{ return Sphere::create(); });
+     * SceneSerializer::registerType("Sphere", []{ return Sphere::create(); }, true);
      * @endcode
      */
-    static void registerType(std::string_view typeName, std::function<NodePtr()> factory);
+    static void registerType(std::string_view typeName, std::function<NodePtr()> factory,
+                             bool threadSafe = false);
 
     /**
      * @brief Register all node types declared in ivf/nodes.h.
@@ -86,6 +155,7 @@ public:
 private:
     static nlohmann::json    serializeNode(NodePtr node);
     static NodePtr           deserializeNode(const nlohmann::json& j);
+    static NodePtr           createNode(const nlohmann::json& j);
 
     static void serializeTransform(TransformNodePtr tn, nlohmann::json& j);
     static void deserializeTransform(TransformNodePtr tn, const nlohmann::json& j);
@@ -96,6 +166,24 @@ private:
     static void serializeProperties(NodePtr node, nlohmann::json& j);
     static void deserializeProperties(NodePtr node, const nlohmann::json& j);
 
+    static void serializeMeshes(NodePtr node, nlohmann::json& j);
+    static void deserializeMeshes(NodePtr node, const nlohmann::json& j);
+
+    static void    writeBinaryNode(NodePtr node, int parent, SceneBinary::Writer& writer);
+    static NodePtr readBinaryNode(const SceneBinary::Reader& reader, std::uint32_t index);
+
+    static std::string typeName(NodePtr node);
+
+    // Loading in phases: reading and node creation may run on worker threads, linking the
+    // nodes must run on the thread owning the OpenGL context.
+    static bool             readScene(SceneLoadJob& job);
+    static void             buildNodes(SceneLoadJob& job);
+    static CompositeNodePtr linkNodes(SceneLoadJob& job);
+    static NodePtr          buildNode(SceneLoadJob& job, size_t index);
+    static CompositeNodePtr loadScene(SceneLoadJob& job);
+
+    friend class SceneLoader;
+
     static std::map<std::string, std::function<NodePtr()>>& typeRegistry();
 };
 
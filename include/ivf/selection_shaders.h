@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+namespace ivf {
+
+/**
+ * @file selection_shaders.h
+ * @brief GLSL sources used by BufferSelection.
+ *
+ * The ID reduction program collects the set of object IDs in a region of the R32UI selection
+ * target on the GPU. It is drawn as one point per region pixel without vertex buffers: each point
+ * fetches its ID and is scattered to the texel of a presence mask that corresponds to that ID,
+ * where it writes 1. Reading back the mask (one byte per ID) replaces reading back and scanning
+ * every pixel of the region.
+ */
+
+inline const std::string id_reduce_vert_shader_source = R"(
+#version 330 core
+
+uniform usampler2D idTexture;
+uniform ivec4 region;     // x, y, width, height in texels
+uniform ivec2 maskSize;   // presence mask size in texels
+
+void main()
+{
+    ivec2 texel = region.xy + ivec2(gl_VertexID % region.z, gl_VertexID / region.z);
+    uint id = texelFetch(idTexture, texel, 0).r;
+
+    // Background (0) and IDs outside the mask are moved outside the clip volume
+
+    if (id == 0u || int(id) >= maskSize.x * maskSize.y)
+    {
+        gl_Position = vec4(2.0, 2.0, 0.0, 1.0);
+        return;
+    }
+
+    vec2 maskTexel = vec2(int(id) % maskSize.x, int(id) / maskSize.x) + 0.5;
+    gl_Position = vec4(maskTexel / vec2(maskSize) * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+inline const std::string id_reduce_frag_shader_source = R"(
+#version 330 core
+
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = vec4(1.0);
+}
+)";
+
+}; // namespace ivf
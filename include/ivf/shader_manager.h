@@ -91,6 +91,14 @@ public:
      */
     ProgramPtr loadBasicShader();
 
+    /**
+     * @brief Load the clustered forward lighting variant of the basic shader (OpenGL 4.3+).
+     * Registered under the name "basic", replacing the regular basic shader, and made current.
+     * Point and spot lights are read from the storage buffers written by LightClusters.
+     * @return ProgramPtr Shared pointer to the clustered basic shader program.
+     */
+    ProgramPtr loadClusteredBasicShader();
+
     /**
      * @brief Load the PBR (physically-based rendering) shader program.
      * Registered under the name "pbr". Does not change the current program.
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <ivf/bounding_box.h>
+#include <ivf/composite_node.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ivf {
+
+/**
+ * @class ShadowCasterTracker
+ * @brief Tracks world-space transforms of scene nodes between frames to find regions needing new shadows.
+ *
+ * Every call to update() walks the scene graph once, accumulating the scene bounding box (replacing a
+ * separate ExtentVisitor pass) and comparing each node's world transform, local bounding box and
+ * TransformNode::contentRevision() with the values recorded in the previous call. Nodes that moved,
+ * changed shape, appeared, disappeared or became invisible contribute their old and new world
+ * bounding boxes to the list of dirty regions. Shadow maps whose volume does not intersect any
+ * dirty region can be reused as-is.
+ *
+ * Geometry modified in place by nodes that do not report a content revision is not detected and
+ * needs an explicit LightManager::invalidateShadowMaps().
+ */
+class ShadowCasterTracker {
+private:
+    struct Entry {
+        glm::mat4 worldMatrix{1.0f}; ///< World transform at the last update.
+        BoundingBox localBBox;       ///< Local bounding box at the last update.
+        BoundingBox worldBBox;       ///< World bounding box at the last update.
+        uint64_t revision{0};        ///< Content revision at the last update.
+        unsigned int frame{0};       ///< Update counter value when last seen.
+    };
+
+    std::unordered_map<const Node *, Entry> m_entries; ///< Tracked nodes.
+    std::vector<BoundingBox> m_dirtyRegions;            ///< Regions changed in the last update.
+    BoundingBox m_sceneBBox;                            ///< Scene bounds from the last update.
+    unsigned int m_frame{0};                            ///< Update counter.
+
+    void visitNode(Node *node, const glm::mat4 &parentMatrix);
+    void track(const TransformNode *node, const glm::mat4 &worldMatrix, const BoundingBox &localBBox);
+
+public:
+    ShadowCasterTracker();
+
+    /**
+     * @brief Walk the scene and record changes since the previous update.
+     * @param scene Scene root.
+     */
+    void update(CompositeNodePtr scene);
+
+    /**
+     * @brief Forget all tracked nodes; the next update reports the whole scene as dirty.
+     */
+    void reset();
+
+    /**
+     * @brief Get the world-space regions that changed in the last update.
+     * @return const std::vector<BoundingBox>& Dirty regions.
+     */
+    const std::vector<BoundingBox> &dirtyRegions() const;
+
+    /**
+     * @brief Get the scene bounding box computed in the last update.
+     * @return BoundingBox Scene bounds.
+     */
+    BoundingBox sceneBoundingBox() const;
+
+    /**
+     * @brief Get the number of tracked nodes.
+     * @return size_t Node count.
+     */
+    size_t nodeCount() const;
+};
+
+}; // namespace ivf
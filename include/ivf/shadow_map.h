@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ivf/glbase.h>
+#include <ivf/render_target.h>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -15,11 +16,13 @@ namespace ivf {
  * and depth texture used for shadow mapping in real-time rendering. It provides methods to
  * initialize, resize, bind/unbind the shadow map, and set or retrieve the light space matrix
  * used for shadow projection.
+ *
+ * The depth target is acquired from the RenderTargetPool, so shadow maps of equal size share the
+ * pool's memory accounting and a released map can be reused by the next one created.
  */
 class ShadowMap : public GLBase {
 private:
-    GLuint m_fbo{0};              ///< Framebuffer object for shadow rendering.
-    GLuint m_depthTexture{0};     ///< Depth texture for storing shadow map.
+    RenderTargetPtr m_target;     ///< Depth-only target held from the RenderTargetPool.
     int m_width{1024};            ///< Width of the shadow map (default 1024).
     int m_height{1024};           ///< Height of the shadow map (default 1024).
     glm::mat4 m_lightSpaceMatrix; ///< Light space transformation matrix.
@@ -46,7 +49,7 @@ public:
     static std::shared_ptr<ShadowMap> create(int width = 1024, int height = 1024);
 
     /**
-     * @brief Initialize the shadow map resources (FBO and depth texture).
+     * @brief Acquire the depth target from the pool and set up its sampling parameters.
      */
     void initialize();
 
@@ -62,11 +65,35 @@ public:
      */
     void bind();
 
+    /**
+     * @brief Bind the shadow map for rendering into a sub-region (e.g. one cascade tile).
+     *
+     * Sets the viewport and enables a matching scissor rectangle so that clears only affect the
+     * region. The caller is responsible for disabling the scissor test afterwards.
+     * @param x Left edge in texels.
+     * @param y Bottom edge in texels.
+     * @param width Region width in texels.
+     * @param height Region height in texels.
+     */
+    void bindRegion(int x, int y, int width, int height);
+
     /**
      * @brief Unbind the shadow map (restore previous framebuffer).
      */
     void unbind();
 
+    /**
+     * @brief Get the width of the shadow map.
+     * @return int Width in texels.
+     */
+    int width() const;
+
+    /**
+     * @brief Get the height of the shadow map.
+     * @return int Height in texels.
+     */
+    int height() const;
+
     /**
      * @brief Get the OpenGL depth texture ID.
      * @return GLuint Depth texture ID.
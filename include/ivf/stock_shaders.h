@@ -36,19 +36,27 @@ uniform mat4 lightSpaceMatrix;
 
 void main()
 {
-    fragPos = vec3(model * vec4(aPos, 1.0));
+    vec3 position = aPos;
+    vec3 vertexNormal = aNormal;
+
+#ifdef IVF_DEFORMERS
+    // GPU deformers, see deformer_shaders.h
+    deformVertex(position, vertexNormal);
+#endif
+
+    fragPos = vec3(model * vec4(position, 1.0));
     mat3 normalMatrix = transpose(inverse(mat3(model)));
     // Transform normal to world space
     // and then to view space
-    //normal = normalMatrix * aNormal;
-    normal = mat3(model) * aNormal; 
+    //normal = normalMatrix * vertexNormal;
+    normal = mat3(model) * vertexNormal; 
 
     color = aColor;
     texCoord = aTex;
     
     if (shadowPass) {
         // When rendering shadow map, just output position in light space
-        gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+        gl_Position = lightSpaceMatrix * model * vec4(position, 1.0);
     } else {
         // Normal rendering path
         gl_Position = projection * view * vec4(fragPos, 1.0);
@@ -77,7 +85,8 @@ inline const std::string basic_frag_shader_source = R"(
 // Multitexturing support
 #define MAX_TEXTURES 8
 
-out vec4 fragColor;
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out uint fragObjectId;
 
 struct Material 
 {
@@ -154,6 +163,7 @@ uniform bool useVertexColors;
 uniform bool usePointFalloff = false;
 uniform bool textRendering = false;
 uniform bool useFixedTextColor = false;
+uniform bool textSdf = false;
 
 uniform float point_falloff_a = 0.0;
 uniform float point_falloff_b = 0.0;
@@ -174,6 +184,8 @@ uniform float textureBlendFactors[MAX_TEXTURES];
 #define NR_POINT_LIGHTS 8
 #define NR_DIR_LIGHTS 4
 #define NR_SPOT_LIGHTS 8
+#define NR_SHADOW_LIGHTS 4
+#define MAX_CASCADES 4
 
 uniform PointLight pointLights[NR_POINT_LIGHTS];
 uniform DirLight dirLights[NR_DIR_LIGHTS];
@@ -194,6 +206,8 @@ uniform int debugShadow = 0;
 
 uniform sampler2D shadowMaps[NR_DIR_LIGHTS];
 uniform mat4 lightSpaceMatrices[NR_DIR_LIGHTS];
+uniform mat4 cascadeMatrices[NR_SHADOW_LIGHTS * MAX_CASCADES];
+uniform int cascadeCounts[NR_SHADOW_LIGHTS];
 
 uniform samplerCube envMap;
 uniform bool useEnvMap = false;
@@ -201,10 +215,117 @@ uniform float envReflectivity = 0.0;
 
 vec4 applyTexBlendMode(vec4 textureColor, vec4 baseColor);
 vec4 applyTexBlendModeIndexed(vec4 textureColor, vec4 baseColor, int mode, float factor);
-vec3 calcDirLight(DirLight light, vec3 normal, vec3 viewDir, mat4 lightMat, sampler2D sMap);
+vec3 calcDirLight(DirLight light, vec3 normal, vec3 viewDir, int lightIndex, sampler2D sMap);
 vec3 calcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 vec3 calcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-float calculateShadow(vec4 fragPosLightSpace, sampler2D sMap);
+float calculateShadow(int lightIndex, sampler2D sMap);
+float calculateShadowTile(vec3 projCoords, vec2 tileOffset, float tileScale, sampler2D sMap);
+
+#ifdef IVF_CLUSTERED_LIGHTING
+
+// Clustered forward lighting. Point and spot lights are read from storage buffers filled by
+// LightClusters; each fragment only loops over the lights assigned to its view-space cluster.
+
+struct ClusterLight
+{
+    vec4 positionRange;
+    vec4 directionType;
+    vec4 diffuseConstant;
+    vec4 specularLinear;
+    vec4 ambientQuadratic;
+    vec4 spotCutoff;
+};
+
+layout(std430, binding = 0) readonly buffer ClusterLightBuffer { ClusterLight clusterLights[]; };
+layout(std430, binding = 1) readonly buffer ClusterGridBuffer { uvec2 clusterGrid[]; };
+layout(std430, binding = 2) readonly buffer ClusterIndexBuffer { uint clusterLightIndices[]; };
+
+uniform mat4 view;
+uniform vec3 clusterDims;
+uniform vec4 clusterViewport;
+uniform vec4 clusterDepth; // near, far, log(far/near), perspective
+
+vec3 calcClusteredLights(vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec2 tile = (gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw;
+    float depth = -(view * vec4(fragPos, 1.0)).z;
+    float slice = clusterDepth.w > 0.5
+        ? log(max(depth, clusterDepth.x) / clusterDepth.x) / clusterDepth.z
+        : (depth - clusterDepth.x) / (clusterDepth.y - clusterDepth.x);
+
+    ivec3 dims = ivec3(clusterDims);
+    ivec3 cell = clamp(ivec3(floor(vec3(tile, slice) * clusterDims)), ivec3(0), dims - 1);
+    uvec2 range = clusterGrid[(cell.z * dims.y + cell.y) * dims.x + cell.x];
+
+    vec3 result = vec3(0.0);
+
+    for (uint i = 0u; i < range.y; i++)
+    {
+        ClusterLight cl = clusterLights[clusterLightIndices[range.x + i]];
+
+        // Smoothly fade the light out at its cluster range so the cut-off is not visible.
+
+        float window = 1.0;
+        if (cl.positionRange.w >= 0.0)
+        {
+            float dist = length(cl.positionRange.xyz - fragPos);
+            if (dist >= cl.positionRange.w)
+                continue;
+            float r = dist / max(cl.positionRange.w, 0.0001);
+            window = clamp(1.0 - r * r * r * r, 0.0, 1.0);
+            window *= window;
+        }
+
+        if (cl.directionType.w < 0.5)
+        {
+            PointLight light;
+            light.enabled = true;
+            light.position = cl.positionRange.xyz;
+            light.constant = cl.diffuseConstant.a;
+            light.linear = cl.specularLinear.a;
+            light.quadratic = cl.ambientQuadratic.a;
+            light.ambientColor = cl.ambientQuadratic.rgb;
+            light.diffuseColor = cl.diffuseConstant.rgb;
+            light.specularColor = cl.specularLinear.rgb;
+            light.shadowStrength = 0.0;
+            result += window * calcPointLight(light, normal, fragPos, viewDir);
+        }
+        else
+        {
+            SpotLight light;
+            light.enabled = true;
+            light.position = cl.positionRange.xyz;
+            light.direction = cl.directionType.xyz;
+            light.cutOff = cl.spotCutoff.x;
+            light.outerCutOff = cl.spotCutoff.y;
+            light.constant = cl.diffuseConstant.a;
+            light.linear = cl.specularLinear.a;
+            light.quadratic = cl.ambientQuadratic.a;
+            light.ambientColor = cl.ambientQuadratic.rgb;
+            light.diffuseColor = cl.diffuseConstant.rgb;
+            light.specularColor = cl.specularLinear.rgb;
+            light.shadowStrength = 0.0;
+            result += window * calcSpotLight(light, normal, fragPos, viewDir);
+        }
+    }
+
+    return result;
+}
+
+#endif
+
+// Glyph coverage, distance field glyphs are thresholded at the outline with a pixel-wide edge
+
+float textAlpha()
+{
+    float value = texture(texture0, texCoord).r;
+
+    if (!textSdf)
+        return value;
+
+    float width = max(fwidth(value), 1e-4);
+    return smoothstep(0.5 - width, 0.5 + width, value);
+}
 
 float rand(vec2 co){
   return fract(sin(dot(co.xy ,vec2(12.9898,78.233))) * 43758.5453);
@@ -267,39 +388,39 @@ void main()
 
     if (useLighting)
     {
+#ifdef IVF_CLUSTERED_LIGHTING
+        result += calcClusteredLights(norm, fragPos, viewDir);
+#else
         for(int i = 0; i < pointLightCount; i++)
         {
             if (pointLights[i].enabled)
                 result += calcPointLight(pointLights[i], norm, fragPos, viewDir);
         }
+#endif
 
         if (dirLightCount > 0 && dirLights[0].enabled)
-            result += calcDirLight(dirLights[0], norm, viewDir, lightSpaceMatrices[0], shadowMaps[0]);
+            result += calcDirLight(dirLights[0], norm, viewDir, 0, shadowMaps[0]);
         if (dirLightCount > 1 && dirLights[1].enabled)
-            result += calcDirLight(dirLights[1], norm, viewDir, lightSpaceMatrices[1], shadowMaps[1]);
+            result += calcDirLight(dirLights[1], norm, viewDir, 1, shadowMaps[1]);
         if (dirLightCount > 2 && dirLights[2].enabled)
-            result += calcDirLight(dirLights[2], norm, viewDir, lightSpaceMatrices[2], shadowMaps[2]);
+            result += calcDirLight(dirLights[2], norm, viewDir, 2, shadowMaps[2]);
         if (dirLightCount > 3 && dirLights[3].enabled)
-            result += calcDirLight(dirLights[3], norm, viewDir, lightSpaceMatrices[3], shadowMaps[3]);
+            result += calcDirLight(dirLights[3], norm, viewDir, 3, shadowMaps[3]);
 
+#ifndef IVF_CLUSTERED_LIGHTING
         for(int i = 0; i < spotLightCount; i++)
         {
             if (spotLights[i].enabled)
                 result += calcSpotLight(spotLights[i], norm, fragPos, viewDir);
         }
+#endif
     }
 
     if (selectionRendering) 
     {
-        uint mask = uint(255);
-        uint r = objectId & mask;
-        uint g = (objectId >> uint(8)) & mask;
-        uint b = (objectId >> uint(16)) & mask;
-    
-        fragColor = vec4(float(r) / 255.0, 
-                         float(g) / 255.0, 
-                         float(b) / 255.0, 
-                         1.0);
+        // Object IDs go to the R32UI selection target on draw buffer 1
+        fragObjectId = objectId;
+        fragColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
     else
     {
@@ -313,12 +434,12 @@ void main()
                 {
                     if (useFixedTextColor) 
                     {
-                        vec4 texSample = vec4(textColor.rgb, texture(texture0, texCoord).r);
+                        vec4 texSample = vec4(textColor.rgb, textAlpha());
                         fragColor = texSample;
                     }
                     else 
                     {
-                        vec4 texSample = vec4(result.rgb, texture(texture0, texCoord).r);
+                        vec4 texSample = vec4(result.rgb, textAlpha());
                         fragColor = texSample;
                     }
                 } 
@@ -374,7 +495,7 @@ void main()
     }
 }
 
-vec3 calcDirLight(DirLight light, vec3 normal, vec3 viewDir, mat4 lightMat, sampler2D sMap)
+vec3 calcDirLight(DirLight light, vec3 normal, vec3 viewDir, int lightIndex, sampler2D sMap)
 {
     vec3 norm = safeNormalize(normal, vec3(0.0, 0.0, 1.0));
     
@@ -391,10 +512,7 @@ vec3 calcDirLight(DirLight light, vec3 normal, vec3 viewDir, mat4 lightMat, samp
     vec3 specular = light.specularColor * spec * material.specularColor;
     float shadow = 0.0;
     if(useShadows && light.castShadows)
-    {
-        vec4 fragPosLightSpace = lightMat * vec4(fragPos, 1.0);
-        shadow = calculateShadow(fragPosLightSpace, sMap);
-    }
+        shadow = calculateShadow(lightIndex, sMap);
     
     return (ambient + (1.0 - shadow * light.shadowStrength) * (diffuse + specular));
 }
@@ -532,19 +650,37 @@ vec4 applyTexBlendModeIndexed(vec4 textureColor, vec4 baseColor, int mode, float
     return mix(baseColor, result, factor);
 }
 
-float calculateShadow(vec4 fragPosLightSpace, sampler2D sMap)
+float calculateShadow(int lightIndex, sampler2D sMap)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    
-    projCoords = projCoords * 0.5 + 0.5;
-    
-    if(projCoords.x < 0.0 || projCoords.x > 1.0 || 
-       projCoords.y < 0.0 || projCoords.y > 1.0 ||
-       projCoords.z < 0.0 || projCoords.z > 1.0) {
+    if (lightIndex >= NR_SHADOW_LIGHTS)
         return 0.0;
+
+    // A single map covers the whole texture, cascades are laid out as 2x2 tiles.
+    // The first cascade containing the fragment (with room for the PCF kernel) is used.
+
+    int count = cascadeCounts[lightIndex];
+    float tileScale = count > 1 ? 0.5 : 1.0;
+    vec2 border = 2.0 / (vec2(textureSize(sMap, 0)) * tileScale);
+
+    for (int i = 0; i < count; i++)
+    {
+        vec4 fragPosLightSpace = cascadeMatrices[lightIndex * MAX_CASCADES + i] * vec4(fragPos, 1.0);
+        vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+
+        if (all(greaterThanEqual(projCoords.xy, border)) && all(lessThanEqual(projCoords.xy, 1.0 - border)) &&
+            projCoords.z >= 0.0 && projCoords.z <= 1.0)
+        {
+            vec2 tileOffset = vec2(float(i % 2), float(i / 2)) * tileScale;
+            return calculateShadowTile(projCoords, tileOffset, tileScale, sMap);
+        }
     }
-    
-    float closestDepth = texture(sMap, projCoords.xy).r; 
+
+    return 0.0;
+}
+
+float calculateShadowTile(vec3 projCoords, vec2 tileOffset, float tileScale, sampler2D sMap)
+{
+    projCoords.xy = tileOffset + projCoords.xy * tileScale;
     
     float currentDepth = projCoords.z;
     
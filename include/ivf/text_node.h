@@ -1,26 +1,15 @@
 #pragma once
 
 #include <ivf/transform_node.h>
+#include <ivf/glyph_atlas.h>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include <map>
 #include <string>
 
 namespace ivf {
 
-/**
- * @struct CharacterInfo
- * @brief Stores glyph texture and metrics for a single character.
- */
-struct CharacterInfo {
-    GLuint textureID;          ///< ID handle of the glyph texture
-    glm::ivec2 glyphSize;      ///< Size of glyph
-    glm::ivec2 glyphBearing;   ///< Offset from baseline to left/top of glyph
-    unsigned int glyphAdvance; ///< Horizontal offset to advance to next glyph
-};
-
 /**
  * @enum TextAlignX
  * @brief Horizontal text alignment options.
@@ -45,15 +34,24 @@ enum class TextAlignY {
  * @class TextNode
  * @brief TransformNode for rendering 2D/3D text with alignment and color options.
  *
- * The TextNode class manages and renders text using glyph textures, supporting
- * alignment, scaling, and color options. It provides methods to set the text string,
- * size, alignment, and color, and to query the rendered text's width and height.
- * Inherits from TransformNode for positioning and transformation in the scene.
+ * The TextNode class renders UTF-8 text using glyphs from a GlyphAtlas shared through the
+ * FontManager, supporting alignment, scaling, and color options. The quads of all characters are
+ * built into one vertex buffer when the text or layout changes and drawn with a single call.
+ * Signed distance field glyphs (the default when FreeType supports them) keep text sharp at any
+ * size. Inherits from TransformNode for positioning and transformation in the scene.
  */
 class TextNode : public TransformNode {
 private:
-    std::string m_text;                        ///< Text string to render.
-    std::map<GLchar, CharacterInfo> m_charMap; ///< Glyph info for each character.
+    std::string m_text;                ///< Text string to render.
+    std::u32string m_codepoints;       ///< Decoded text.
+    std::string m_fontName;            ///< Font face name, empty for the current face.
+    GlyphAtlasPtr m_atlas;             ///< Glyph atlas used by the vertex buffer.
+    unsigned int m_atlasGeneration{0}; ///< Atlas generation the texture coordinates were built for.
+    unsigned int m_atlasRevision{0};   ///< FontManager atlas revision the atlas was looked up at.
+    bool m_sdf;                        ///< Use signed distance field glyphs.
+    bool m_dirty{true};                ///< Vertex buffer needs to be rebuilt.
+    GLsizei m_indexCount{0};           ///< Number of indices in the vertex buffer.
+    size_t m_capacity{0};              ///< Number of glyph quads the buffers can hold.
 
     GLuint m_vertexAttrId; ///< Vertex attribute location.
     GLuint m_texAttrId;    ///< Texture coordinate attribute location.
@@ -64,12 +62,13 @@ private:
     GLuint m_useFixedTextColorId; ///< Shader uniform for fixed text color.
     GLuint m_textColorId;         ///< Shader uniform for text color.
     GLuint m_useTextureId;        ///< Shader uniform for texture usage.
+    GLuint m_textSdfId;           ///< Shader uniform for distance field glyphs.
 
     bool m_textRendering;     ///< Whether text rendering is enabled.
     bool m_useFixedTextColor; ///< Whether to use a fixed text color.
     glm::vec3 m_textColor;    ///< Text color.
 
-    int m_maxPixels; ///< Maximum pixel size for text rendering.
+    int m_maxPixels; ///< Glyph pixel size in the atlas.
     float m_scale;   ///< Text scale factor.
 
     TextAlignX m_textAlignX; ///< Horizontal alignment.
@@ -86,14 +85,19 @@ private:
     GLuint m_indexVBO;  ///< Index buffer object.
 
     /**
-     * @brief Update the character map (glyph textures and metrics).
+     * @brief Prepare OpenGL buffers for text rendering.
      */
-    void updateCharMap();
+    void prepareBuffers();
 
     /**
-     * @brief Prepare OpenGL buffers for text rendering.
+     * @brief Get the glyph atlas matching the font, pixel size and glyph type.
      */
-    void prepareBuffers();
+    void updateAtlas();
+
+    /**
+     * @brief Rebuild the glyph quads of the whole text into the vertex buffers.
+     */
+    void updateGeometry();
 
     /**
      * @brief Update the computed text width and height.
@@ -106,6 +110,11 @@ public:
      */
     TextNode();
 
+    /**
+     * @brief Destructor.
+     */
+    virtual ~TextNode();
+
     /**
      * @brief Factory method to create a shared pointer to a TextNode instance.
      * @return std::shared_ptr<TextNode> New TextNode instance.
@@ -160,6 +169,42 @@ public:
      */
     TextAlignY alignY();
 
+    /**
+     * @brief Set the font face used by this node.
+     * @param name Face name given to FontManager::loadFace(), empty for the current face.
+     */
+    void setFont(const std::string name);
+
+    /**
+     * @brief Get the font face name.
+     * @return std::string Face name, empty for the current face.
+     */
+    std::string font();
+
+    /**
+     * @brief Enable or disable signed distance field glyphs.
+     * @param flag True for distance field glyphs (ignored if FreeType does not support them).
+     */
+    void setSdf(bool flag);
+
+    /**
+     * @brief Check if signed distance field glyphs are used.
+     * @return bool True for distance field glyphs.
+     */
+    bool sdf();
+
+    /**
+     * @brief Set the pixel size glyphs are rasterized at in the atlas.
+     * @param pixels Glyph size in pixels. The rendered size is set with setSize().
+     */
+    void setPixelSize(int pixels);
+
+    /**
+     * @brief Get the pixel size glyphs are rasterized at.
+     * @return int Glyph size in pixels.
+     */
+    int pixelSize();
+
     /**
      * @brief Get the computed width of the rendered text.
      * @return float Text width.
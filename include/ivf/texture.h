@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -19,6 +20,9 @@ namespace ivf {
  * It supports loading image data from files, setting texture parameters (format, filtering, wrapping),
  * and configuring blend modes for advanced rendering. The class provides methods to bind/unbind
  * the texture and query or set its properties.
+ *
+ * load() and loadHDR() decode and upload synchronously. TextureCache::load() shares textures
+ * between users of the same file and streams them in without blocking the render thread.
  */
 class Texture : public GLBase {
 private:
@@ -37,6 +41,9 @@ private:
     TextureBlendMode m_blendMode; ///< Blend mode for this texture.
     float m_blendFactor;          ///< Blend factor for blending.
     float m_anisotropy{0.0f};     ///< Max anisotropy level (0 = disabled).
+    std::uint64_t m_lastUsed{0};  ///< TextureCache frame of the last bind().
+
+    friend class TextureCache;
 
 public:
     /**
@@ -62,7 +69,10 @@ public:
 
     /**
      * @brief Load texture data from an image file.
-     * @param filename Path to the image file.
+     *
+     * KTX2 and DDS files are uploaded with their stored mipmap levels and compression; mipmaps are
+     * generated only for images without stored levels.
+     * @param filename Path to the image file or KTX2/DDS container.
      * @return bool True if loading succeeded.
      */
     bool load(std::string_view filename);
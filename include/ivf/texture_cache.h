@@ -0,0 +1,248 @@
+#pragma once
+
+#include <ivf/cubemap.h>
+#include <ivf/texture.h>
+#include <ivf/texture_image.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @class TextureCache
+ * @brief Singleton cache of file textures, decoded asynchronously and streamed to the GPU.
+ *
+ * Textures are keyed by the canonical path of their file(s) and the TextureLoadOptions, so loading
+ * the same file twice returns the same texture. load() returns immediately with a texture showing a
+ * one pixel placeholder; the file is decoded on the cache's decode threads and the pixels are
+ * uploaded by update(), which must be called once per frame on the thread owning the OpenGL
+ * context (GLFWSceneWindow does this). Uploads go through a pixel buffer object in bands of rows
+ * into a separate texture object that replaces the placeholder when complete; at most
+ * uploadBudget() bytes are copied per frame so that large images do not cause frame hitches.
+ * KTX2 and DDS containers with block-compressed data or stored mipmap levels are uploaded one level
+ * of one face per step instead; prefer them (see ivf_texconv) to cut decode time and video memory.
+ *
+ * Uploaded textures are accounted against memoryBudget(). When the budget is exceeded, the least
+ * recently bound textures are evicted: textures nobody else references are dropped from the cache,
+ * referenced ones fall back to the placeholder and are streamed in again when they are next bound.
+ * Textures bound in the current or previous frame are never evicted.
+ *
+ * Usage:
+ * @code
+ * auto texture = TextureCache::instance()->load("assets/planks.png");
+ * auto environment = TextureCache::instance()->loadHDR("assets/studio.hdr");
+ * auto sky = TextureCache::instance()->loadCubemapFromDirectory("assets/skybox");
+ * @endcode
+ */
+class TextureCache {
+private:
+    struct Entry;
+    struct Job;
+
+    std::unordered_map<std::string, std::shared_ptr<Entry>> m_entries; ///< Cached textures by key.
+    std::deque<std::shared_ptr<Job>> m_uploads;                        ///< Decoded images waiting for upload.
+    size_t m_inFlight{0};                                              ///< Jobs queued, decoding or uploading.
+    size_t m_evicted{0};                                               ///< Entries waiting for reuse to reload.
+
+    std::vector<std::thread> m_workers;             ///< Decode threads, started on first load.
+    std::deque<std::shared_ptr<Job>> m_decodeQueue; ///< Jobs waiting for decoding.
+    std::deque<std::shared_ptr<Job>> m_decoded;     ///< Jobs finished by the decode threads.
+    std::mutex m_mutex;                             ///< Protects the decode queues.
+    std::condition_variable m_condition;            ///< Signals new decode jobs or shutdown.
+    std::condition_variable m_decodedCondition;     ///< Signals finished decode jobs.
+    bool m_stopping{false};                         ///< True when the decode threads shut down.
+
+    GLuint m_pbo{0};                           ///< Pixel unpack buffer used for streaming uploads.
+    size_t m_uploadBudget{8 * 1024 * 1024};    ///< Bytes uploaded per frame.
+    size_t m_memoryBudget{1024 * 1024 * 1024}; ///< Video memory budget for cached textures.
+    size_t m_memoryUsage{0};                   ///< Estimated video memory of resident textures.
+    size_t m_uploadedBytes{0};                 ///< Bytes uploaded in the last update().
+    size_t m_evictionCount{0};                 ///< Textures evicted since the cache was created.
+    bool m_overBudgetWarned{false};            ///< True after warning about a too small budget.
+
+    std::array<unsigned char, 4> m_placeholderColor{128, 128, 128, 255}; ///< Color of placeholder textures.
+
+    static std::uint64_t m_frame;    ///< Frame counter advanced by update().
+    static TextureCache *m_instance; ///< Singleton instance pointer.
+
+    TextureCache();
+
+    static GLuint &storage(Entry &entry);
+    static std::uint64_t lastUsed(const Entry &entry);
+    static bool referenced(const Entry &entry);
+
+    void addEntry(const std::shared_ptr<Entry> &entry);
+    void startWorkers();
+    void workerLoop();
+    void requestLoad(const std::shared_ptr<Entry> &entry);
+    void collectDecoded();
+    void processUploads(size_t budget);
+    size_t uploadRows(Job &job, size_t budget);
+    size_t uploadLevels(Job &job, size_t budget);
+    void completeUpload(Job &job);
+    void setPlaceholder(Entry &entry);
+    void reloadUsed();
+    void evict();
+
+public:
+    virtual ~TextureCache();
+
+    /**
+     * @brief Get the singleton instance.
+     * @return TextureCache* Pointer to the singleton instance.
+     */
+    static TextureCache *instance();
+
+    /**
+     * @brief Create the singleton instance (if not already created).
+     * @return TextureCache* Pointer to the singleton instance.
+     */
+    static TextureCache *create();
+
+    /**
+     * @brief Stop the decode threads and destroy the singleton instance.
+     *
+     * Textures still referenced elsewhere stay valid but are no longer streamed.
+     */
+    static void drop();
+
+    /**
+     * @brief Get a cached texture, starting to load it if it is not cached.
+     * @param filename Image file.
+     * @param options Decode options.
+     * @return TexturePtr Texture, showing a placeholder until the image has been uploaded.
+     */
+    TexturePtr load(std::string_view filename, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Get a cached HDR texture, loaded like Texture::loadHDR() (GL_RGB16F, flipped, no mipmaps).
+     * @param filename Radiance .hdr or other float-capable image.
+     * @return TexturePtr Texture, showing a placeholder until the image has been uploaded.
+     */
+    TexturePtr loadHDR(std::string_view filename);
+
+    /**
+     * @brief Get a cached cubemap, starting to load it if it is not cached.
+     * @param paths Face images (right, left, top, bottom, front, back).
+     * @param options Decode options.
+     * @return CubemapPtr Cubemap, showing a placeholder until the faces have been uploaded.
+     */
+    CubemapPtr loadCubemap(const std::array<std::string, 6> &paths, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Get a cached cubemap stored in a single KTX2 or DDS container.
+     * @param filename Cubemap container, see Cubemap::load(std::string_view).
+     * @param options Decode options.
+     * @return CubemapPtr Cubemap, showing a placeholder until the faces have been uploaded.
+     */
+    CubemapPtr loadCubemap(std::string_view filename, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Get a cached cubemap from cubemap.ktx2/.dds or the right/left/top/bottom/front/back images of a directory.
+     * @param dir Directory, see Cubemap::loadFromDirectory().
+     * @param options Decode options.
+     * @return CubemapPtr Cubemap, showing a placeholder until the faces have been uploaded.
+     */
+    CubemapPtr loadCubemapFromDirectory(std::string_view dir, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Upload decoded images within the upload budget and evict textures over the memory budget.
+     *
+     * Call once per frame on the thread owning the OpenGL context.
+     */
+    void update();
+
+    /**
+     * @brief Block until all pending loads are decoded and uploaded, ignoring the upload budget.
+     */
+    void finish();
+
+    /**
+     * @brief Drop all cached textures. Textures referenced elsewhere stay valid.
+     */
+    void clear();
+
+    /**
+     * @brief Set the number of bytes uploaded per frame. At least one row is uploaded per frame.
+     * @param bytes Size in bytes.
+     */
+    void setUploadBudget(size_t bytes);
+
+    /**
+     * @brief Get the number of bytes uploaded per frame.
+     * @return size_t Size in bytes.
+     */
+    size_t uploadBudget() const;
+
+    /**
+     * @brief Set the video memory budget for cached textures.
+     * @param bytes Size in bytes, 0 to disable eviction.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Get the video memory budget for cached textures.
+     * @return size_t Size in bytes.
+     */
+    size_t memoryBudget() const;
+
+    /**
+     * @brief Set the color shown by textures until their image has been uploaded.
+     * @param color RGBA color.
+     */
+    void setPlaceholderColor(const glm::vec4 &color);
+
+    /**
+     * @brief Get the estimated video memory used by resident textures.
+     * @return size_t Size in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Get the number of bytes uploaded by the last update().
+     * @return size_t Size in bytes.
+     */
+    size_t uploadedBytes() const;
+
+    /**
+     * @brief Get the number of cached textures, including those still loading.
+     * @return size_t Texture count.
+     */
+    size_t entryCount() const;
+
+    /**
+     * @brief Get the number of textures waiting to be decoded or uploaded.
+     * @return size_t Texture count.
+     */
+    size_t pendingCount() const;
+
+    /**
+     * @brief Get the number of textures evicted since the cache was created.
+     * @return size_t Eviction count.
+     */
+    size_t evictionCount() const;
+
+    /**
+     * @brief Get the frame counter used to track texture use, advanced by update().
+     * @return std::uint64_t Frame number.
+     */
+    static std::uint64_t frame() { return m_frame; }
+};
+
+/**
+ * @typedef TextureCachePtr
+ * @brief Pointer type for TextureCache.
+ */
+typedef TextureCache *TextureCachePtr;
+
+}; // namespace ivf
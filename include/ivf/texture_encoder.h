@@ -0,0 +1,104 @@
+#pragma once
+
+/**
+ * @file texture_encoder.h
+ * @brief Block compression and mipmap generation for KTX2 textures.
+ */
+
+#include <ivf/texture_image.h>
+
+#include <string_view>
+
+namespace ivf {
+
+/**
+ * @namespace TextureEncoder
+ * @brief Functions converting decoded images to GPU-ready textures.
+ *
+ * Used offline by the ivf_texconv tool to turn PNG, JPG and HDR images into KTX2 files with
+ * precomputed mipmaps and block-compressed data, which TextureImage, Texture, Cubemap and
+ * TextureCache load without decoding or generating mipmaps at runtime. Blocks are encoded in
+ * parallel on the ThreadPool.
+ *
+ * @code
+ * auto image = TextureImage::load("planks.png");
+ * auto encoded = TextureEncoder::encode(image, {});
+ * encoded.saveKtx2("planks.ktx2");
+ * @endcode
+ */
+namespace TextureEncoder {
+
+/**
+ * @enum Format
+ * @brief Output format of encode().
+ */
+enum class Format {
+    Auto,   ///< Chosen by chooseFormat().
+    BC1,    ///< RGB, 4 bits per pixel (S3TC DXT1).
+    BC3,    ///< RGBA, 8 bits per pixel (S3TC DXT5).
+    BC4,    ///< Single channel, 4 bits per pixel (RGTC1).
+    BC5,    ///< Two channels, 8 bits per pixel (RGTC2).
+    BC7,    ///< RGBA, 8 bits per pixel, higher quality than BC1/BC3 (BPTC, OpenGL 4.2).
+    RGBA8,  ///< Uncompressed 8 bit RGBA.
+    RGBA16F ///< Uncompressed half float RGBA, for HDR images.
+};
+
+/**
+ * @struct Options
+ * @brief Encoding options.
+ */
+struct Options {
+    Format format{Format::Auto}; ///< Output format.
+    bool srgb{false};            ///< sRGB colors: filter mipmaps in linear space, store BC1/BC3/BC7 as sRGB.
+    bool normalMap{false};       ///< Renormalize the vectors of filtered mipmap levels.
+    bool mipmaps{true};          ///< Store a full mipmap chain.
+};
+
+/**
+ * @brief Choose the output format for an image.
+ *
+ * HDR images are stored as RGBA16F, one and two channel images as BC4 and BC5, images with
+ * transparent pixels as BC3 and everything else, including normal maps, as BC1. The shaders read
+ * the z component of normal maps, so BC5, which stores only x and y, is not chosen for them. BC7
+ * is never chosen as it is not available on OpenGL 4.1 (macOS).
+ * @param image Decoded image.
+ * @param options Encoding options.
+ * @return Format Output format, options.format unless it is Format::Auto.
+ */
+Format chooseFormat(const TextureImage &image, const Options &options);
+
+/**
+ * @brief Get the name of a format, as accepted by parseFormat().
+ * @param format Format.
+ * @return const char* Lower case name, e.g. "bc1".
+ */
+const char *formatName(Format format);
+
+/**
+ * @brief Parse a format name.
+ * @param name Name such as "bc7", "rgba16f" or "auto" (case insensitive).
+ * @param format Parsed format.
+ * @return bool False if the name is unknown.
+ */
+bool parseFormat(std::string_view name, Format &format);
+
+/**
+ * @brief Generate the mipmap chain of an uncompressed image with a box filter.
+ * @param image Uncompressed image with a single level.
+ * @param srgb Filter sRGB encoded colors in linear space.
+ * @param normalMap Renormalize the vectors of filtered levels.
+ * @return TextureImage RGBA float image with all levels down to 1x1.
+ */
+TextureImage generateMipmaps(const TextureImage &image, bool srgb = false, bool normalMap = false);
+
+/**
+ * @brief Encode an uncompressed image.
+ * @param image Uncompressed image with a single level, a 2D texture or a cubemap.
+ * @param options Encoding options.
+ * @return TextureImage Encoded image, invalid with error set if the input cannot be encoded.
+ */
+TextureImage encode(const TextureImage &image, const Options &options = {});
+
+} // namespace TextureEncoder
+
+} // namespace ivf
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <ivf/glbase.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @struct TextureLoadOptions
+ * @brief How an image file is decoded and uploaded; part of the TextureCache key.
+ *
+ * KTX2 and DDS containers are loaded as stored: hdr does not apply to them, flipY only to
+ * uncompressed data and mipmaps are only generated if the container has a single level. Bake the
+ * orientation of compressed textures with ivf_texconv --flip.
+ */
+struct TextureLoadOptions {
+    bool hdr{false};    ///< Decode to floats and store as GL_RGB16F.
+    bool flipY{false};  ///< Reverse the row order, so that the first row is the bottom of the image.
+    bool mipmaps{true}; ///< Generate mipmaps after the upload.
+
+    bool operator==(const TextureLoadOptions &other) const = default;
+
+    /**
+     * @brief Options used for HDR environment images (float, flipped, no mipmaps).
+     * @return TextureLoadOptions Options.
+     */
+    static TextureLoadOptions hdrImage();
+};
+
+/**
+ * @struct TextureImage
+ * @brief Decoded image data of a 2D texture or of the six faces of a cubemap.
+ *
+ * Images are read with stb_image (PNG, JPG, HDR, ...) or from KTX2 and DDS containers, which may
+ * hold block-compressed data (BC1, BC3, BC4, BC5, BC7) and precomputed mipmap levels.
+ *
+ * Decoding does not touch OpenGL state or log and may run on any thread; failures are described by
+ * error. upload() must be called on the thread owning the context. Uncompressed rows are tightly
+ * packed. Levels follow each other, largest first, and within a level the faces follow each other
+ * in the order +X, -X, +Y, -Y, +Z, -Z.
+ */
+struct TextureImage {
+    int width{0};                           ///< Width of the base level in pixels.
+    int height{0};                          ///< Height of the base level in pixels (of one face).
+    int channels{0};                        ///< Components per pixel (1-4).
+    int faces{0};                           ///< 1 for 2D textures, 6 for cubemaps, 0 if decoding failed.
+    int levels{1};                          ///< Mipmap levels stored in pixels.
+    GLenum componentType{GL_UNSIGNED_BYTE}; ///< GL_UNSIGNED_BYTE, GL_HALF_FLOAT or GL_FLOAT.
+    GLenum compressedFormat{0};             ///< Internal format of block-compressed data, 0 if uncompressed.
+    std::vector<unsigned char> pixels;      ///< Data of all levels and faces.
+    std::string error;                      ///< Reason decoding failed, empty on success.
+
+    [[nodiscard]] bool valid() const { return faces > 0 && !pixels.empty(); }
+
+    /** True for block-compressed data. */
+    [[nodiscard]] bool compressed() const { return compressedFormat != 0; }
+
+    /** True for floating point components. */
+    [[nodiscard]] bool hdr() const { return componentType != GL_UNSIGNED_BYTE; }
+
+    /** True if mipmaps can be generated with glGenerateMipmap(), i.e. none are stored. */
+    [[nodiscard]] bool canGenerateMipmaps() const { return !this->compressed() && levels == 1; }
+
+    /** Width of a mipmap level. */
+    [[nodiscard]] int levelWidth(int level) const;
+
+    /** Height of a mipmap level. */
+    [[nodiscard]] int levelHeight(int level) const;
+
+    /** Size of one face of a mipmap level in bytes. */
+    [[nodiscard]] size_t levelSize(int level) const;
+
+    /** Offset of one face of a mipmap level in pixels. */
+    [[nodiscard]] size_t levelOffset(int level, int face = 0) const;
+
+    /** Size of an uncompressed pixel in bytes. */
+    [[nodiscard]] size_t pixelBytes() const;
+
+    /** Size of one row of the base level in bytes (uncompressed data). */
+    [[nodiscard]] size_t rowBytes() const;
+
+    /** Size of one face of the base level in bytes. */
+    [[nodiscard]] size_t faceBytes() const;
+
+    /** Pixel format passed to glTexImage2D(). */
+    [[nodiscard]] GLenum format() const;
+
+    /** Component type passed to glTexImage2D(). */
+    [[nodiscard]] GLenum type() const;
+
+    /** Internal format of the texture. */
+    [[nodiscard]] GLint internalFormat() const;
+
+    /**
+     * @brief Estimate the video memory used by the uploaded texture.
+     * @param mipmaps True if a mipmap chain is generated for images without stored levels.
+     * @return size_t Size in bytes.
+     */
+    [[nodiscard]] size_t gpuBytes(bool mipmaps) const;
+
+    /**
+     * @brief Upload all levels and faces to the texture bound to @p target.
+     *
+     * For cubemaps @p target is ignored and the faces are uploaded to the cube map face targets.
+     * If levels are stored, GL_TEXTURE_MAX_LEVEL is set to the last of them.
+     * @param target Texture target, normally GL_TEXTURE_2D.
+     * @param level Mipmap level of the base level.
+     * @return bool False if the compressed format is not supported by the OpenGL implementation.
+     */
+    bool upload(GLenum target = GL_TEXTURE_2D, GLint level = 0) const;
+
+    /**
+     * @brief Save the image as a KTX2 file.
+     * @param filename Output path.
+     * @return bool True if the file was written.
+     */
+    bool saveKtx2(std::string_view filename) const;
+
+    /**
+     * @brief Decode an image file.
+     * @param filename Path to the image or KTX2/DDS container.
+     * @param options Decode options.
+     * @return TextureImage Decoded image, invalid with error set on failure.
+     */
+    static TextureImage load(std::string_view filename, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Decode the six faces of a cubemap (right, left, top, bottom, front, back).
+     *
+     * OpenGL's cubemap face coordinates are left-handed relative to the right-handed convention
+     * used by the scene, so faces are mirrored horizontally to make labeled skybox images read
+     * naturally. All faces must have the same size and channel count. Compressed cubemaps are
+     * stored in a single container (ivf_texconv --cubemap, which mirrors the faces) and loaded
+     * with load().
+     * @param paths Face image paths.
+     * @param options Decode options.
+     * @return TextureImage Decoded faces, invalid with error set on failure.
+     */
+    static TextureImage loadCubemap(const std::array<std::string, 6> &paths, const TextureLoadOptions &options = {});
+
+    /**
+     * @brief Check if the current OpenGL implementation supports a compressed format.
+     * @param format Compressed internal format.
+     * @return bool True if supported.
+     */
+    static bool formatSupported(GLenum format);
+};
+
+} // namespace ivf
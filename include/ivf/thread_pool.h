@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ivf {
+
+/**
+ * @class ThreadPool
+ * @brief Singleton pool of worker threads for CPU-side data-parallel work.
+ *
+ * The pool is used by subsystems that split independent work (light clustering, particle updates,
+ * texture generation, ...) over the available cores. OpenGL calls must never be made from worker
+ * threads; only the thread owning the context may touch GL state.
+ *
+ * Usage:
+ * @code
+ * ThreadPool::instance()->parallelFor(0, count, [&](size_t begin, size_t end) {
+ *     for (size_t i = begin; i < end; i++)
+ *         data[i] = compute(i);
+ * });
+ *
+ * auto future = ThreadPool::instance()->submit([] { decodeImage(); });
+ * @endcode
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> m_workers;            ///< Worker threads.
+    std::deque<std::function<void()>> m_tasks;     ///< Pending tasks.
+    std::mutex m_mutex;                            ///< Protects the task queue.
+    std::condition_variable m_condition;           ///< Signals new tasks or shutdown.
+    bool m_stopping{false};                        ///< True when the pool is shutting down.
+
+    static ThreadPool *m_instance; ///< Singleton instance pointer.
+
+    ThreadPool(std::size_t workerCount);
+
+    void workerLoop();
+
+    bool runPendingTask();
+
+public:
+    virtual ~ThreadPool();
+
+    /**
+     * @brief Get the singleton instance, creating one worker per hardware thread minus one.
+     * @return ThreadPool* Pointer to the singleton instance.
+     */
+    static ThreadPool *instance();
+
+    /**
+     * @brief Create the singleton instance with a specific worker count.
+     * @param workerCount Number of worker threads (0 = hardware concurrency minus one).
+     * @return ThreadPool* Pointer to the singleton instance.
+     */
+    static ThreadPool *create(std::size_t workerCount = 0);
+
+    /**
+     * @brief Stop all workers and destroy the singleton instance.
+     */
+    static void drop();
+
+    /**
+     * @brief Get the number of worker threads.
+     * @return std::size_t Worker count.
+     */
+    std::size_t workerCount() const;
+
+    /**
+     * @brief Queue a task for execution on a worker thread.
+     * @param task Callable to run.
+     * @return std::future<void> Future that becomes ready when the task has finished.
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * @brief Split [begin, end) into chunks and run them in parallel, blocking until all are done.
+     *
+     * The calling thread participates in the work. Small ranges (at most one grain) run inline.
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param fn Callable invoked as fn(chunkBegin, chunkEnd).
+     * @param grain Minimum number of indices per chunk.
+     */
+    void parallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)> &fn,
+                     std::size_t grain = 1);
+};
+
+/**
+ * @typedef ThreadPoolPtr
+ * @brief Pointer type for ThreadPool singleton.
+ */
+typedef ThreadPool *ThreadPoolPtr;
+
+}; // namespace ivf
@@ -66,6 +66,18 @@ public:
      */
     glm::vec3 grayScaleWeights() const;
 
+    /**
+     * @brief Check if the effect is point-wise.
+     * @return bool Always true, the effect can be fused with neighbouring point-wise effects.
+     */
+    bool isPointwise() const override;
+
+    /**
+     * @brief Get the GLSL snippet of the effect.
+     * @return std::string Snippet source.
+     */
+    std::string pointwiseSource() const override;
+
 protected:
     /**
      * @brief Load effect-specific resources (shaders, etc.).
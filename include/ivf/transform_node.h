@@ -178,6 +178,15 @@ public:
      */
     [[nodiscard]] virtual BoundingBox worldBoundingBox() const;
 
+    /**
+     * @brief Get the revision of geometry modified in place.
+     *
+     * Changes whenever the drawn geometry changes without a change of transform or bounding box,
+     * so that ShadowCasterTracker can mark the region of the node as dirty.
+     * @return uint64_t Content revision, 0 for static geometry.
+     */
+    [[nodiscard]] virtual uint64_t contentRevision() const;
+
     /**
      * @brief Set the local bounding box for this node.
      * @param bbox The local bounding box.
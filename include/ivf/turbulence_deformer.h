@@ -136,6 +136,35 @@ public:
      */
     virtual std::unique_ptr<Deformer> clone() const override;
 
+    /**
+     * @brief Prepare a fused evaluation pass.
+     * @param vertexCount Number of vertices of the pass.
+     * @return True.
+     */
+    virtual bool prepareKernel(GLuint vertexCount) override;
+
+    /**
+     * @brief Displace a block of positions in place.
+     * @param positions Positions of the block.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const override;
+
+    /**
+     * @brief Get the parameters for evaluating the turbulence in the vertex shader.
+     * @param gpu Receives the shader type and parameters.
+     * @return True.
+     */
+    virtual bool gpuDeformer(GpuDeformer &gpu) const override;
+
+    /**
+     * @brief Transform a bounding box of input positions into a box of the displaced positions.
+     * @param bbox Box of the input positions, replaced by the box of the displaced positions.
+     * @return True.
+     */
+    virtual bool transformBounds(BoundingBox &bbox) const override;
+
 private:
     /**
      * @brief Update the internal displacement function based on current parameters.
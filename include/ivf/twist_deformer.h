@@ -110,6 +110,35 @@ public:
      */
     virtual void apply() override;
 
+    /**
+     * @brief Prepare a fused evaluation pass.
+     * @param vertexCount Number of vertices of the pass.
+     * @return True.
+     */
+    virtual bool prepareKernel(GLuint vertexCount) override;
+
+    /**
+     * @brief Twist a block of positions in place.
+     * @param positions Positions of the block.
+     * @param first Index of the first vertex of the block.
+     * @param count Number of vertices in the block.
+     */
+    virtual void applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const override;
+
+    /**
+     * @brief Get the parameters for evaluating the twist in the vertex shader.
+     * @param gpu Receives the shader type and parameters.
+     * @return True.
+     */
+    virtual bool gpuDeformer(GpuDeformer &gpu) const override;
+
+    /**
+     * @brief Transform a bounding box of input positions into a box of the twisted positions.
+     * @param bbox Box of the input positions, replaced by the box of the twisted positions.
+     * @return True if the falloff is not negative.
+     */
+    virtual bool transformBounds(BoundingBox &bbox) const override;
+
     /**
      * @brief Clone this deformer.
      * @return Unique pointer to a new TwistDeformer with the same parameters.
@@ -9,6 +9,7 @@
 #include <string>
 #include <source_location>
 #include <ivf/transform_manager.h>
+#include <ivf/gl_diagnostics.h>
 
 namespace ivf {
 
@@ -161,7 +162,7 @@ void clearError();
  */
 GLenum checkPrintError(const std::string context, const std::string file = "", const long line = 0);
 
-#ifdef _DEBUG
+#ifdef IVF_GL_DIAGNOSTICS
 
 /**
  * @brief Execute a callable and check for OpenGL errors with automatic source location tracking.
@@ -177,6 +178,10 @@ GLenum checkPrintError(const std::string context, const std::string file = "", c
  */
 template <typename F>
 inline void checkError(F&& func, const std::source_location& location = std::source_location::current()) {
+    if (!GLDiagnostics::errorQueriesEnabled()) {
+        func();
+        return;
+    }
     clearError();
     func();
     checkPrintError("OpenGL call", location.file_name(), location.line());
@@ -192,7 +197,8 @@ inline void checkError(F&& func, const std::source_location& location = std::sou
  * ivf::errorEnd("Texture setup");
  */
 inline void checkErrorBegin() {
-    clearError();
+    if (GLDiagnostics::errorQueriesEnabled())
+        clearError();
 }
 
 /**
@@ -201,7 +207,8 @@ inline void checkErrorBegin() {
  * @param location Source location (automatically captured).
  */
 inline void checkErrorEnd(const std::string& name, const std::source_location& location = std::source_location::current()) {
-    checkPrintError(name, location.file_name(), location.line());
+    if (GLDiagnostics::errorQueriesEnabled())
+        checkPrintError(name, location.file_name(), location.line());
 }
 
 #else
@@ -224,11 +231,14 @@ inline void checkErrorEnd(const std::string&, const std::source_location& = std:
 // Legacy Macro Compatibility Layer
 // ============================================================================
 
-#ifdef _DEBUG
+#ifdef IVF_GL_DIAGNOSTICS
 
 /**
  * @def GL_ERR(stmt)
- * @brief Legacy macro to execute an OpenGL statement and check for errors in debug builds.
+ * @brief Legacy macro to execute an OpenGL statement and check for errors in diagnostics builds.
+ *
+ * The glGetError() round-trips are only issued when ivf::GLDiagnostics is in ErrorQueries mode
+ * (or validating a frame). In DebugOutput mode errors arrive through the debug callback instead.
  * @param stmt OpenGL statement to execute.
  * @deprecated Use ivf::checkError() with a lambda instead for better type safety.
  * 
@@ -240,9 +250,11 @@ inline void checkErrorEnd(const std::string&, const std::source_location& = std:
  * ivf::checkError([&]{ glBindBuffer(GL_ARRAY_BUFFER, vbo); });
  */
 #define GL_ERR(stmt)                                                           \
-    ivf::clearError();                                                         \
+    if (ivf::GLDiagnostics::errorQueriesEnabled())                             \
+        ivf::clearError();                                                     \
     stmt;                                                                      \
-    ivf::checkPrintError(#stmt, __FILE__, __LINE__);
+    if (ivf::GLDiagnostics::errorQueriesEnabled())                             \
+        ivf::checkPrintError(#stmt, __FILE__, __LINE__);
 
 /**
  * @def GL_ERR_BEGIN
@@ -272,7 +284,7 @@ inline void checkErrorEnd(const std::string&, const std::source_location& = std:
 
 #else
 
-// Release mode: macros become no-ops
+// Release mode: macros compile down to the bare OpenGL call
 #define GL_ERR(stmt) stmt;
 #define GL_ERR_BEGIN
 #define GL_ERR_END(name)
@@ -17,6 +17,15 @@
 
 namespace ivfui {
 
+/**
+ * @enum HeadlessContext
+ * @brief Context creation API used when running without a display.
+ */
+enum class HeadlessContext {
+    OSMesa, ///< Mesa off-screen rendering into client memory.
+    EGL     ///< EGL on the surfaceless platform.
+};
+
 /**
  * @class GLFWApplication
  * @brief Manages the main application loop and multiple GLFW windows.
@@ -25,16 +34,43 @@ namespace ivfui {
  * multiple GLFW windows, handling the main event loop, and integrating with
  * the ivfui windowing system. It supports adding windows, polling events,
  * and setting GLFW window hints.
+ *
+ * In headless mode GLFW is initialized on its null platform and windows get
+ * an OSMesa or EGL context instead of a native window (requires GLFW 3.4).
+ * The scene, lighting, post-processing and capture code runs unchanged. A
+ * headless run is usually combined with a fixed timestep and a frame limit so
+ * that it produces the same images every time and then exits. All of these
+ * can be set from the environment, which lets any example run unmodified on a
+ * display-less machine:
+ *
+ * - IVF_HEADLESS: 1 or osmesa for OSMesa, egl for EGL.
+ * - IVF_MAX_FRAMES: number of frames to draw before closing each window.
+ * - IVF_FIXED_TIMESTEP: simulated seconds per frame.
+ * - IVF_CAPTURE_DIR: existing directory to write frame_NNNNNN.png files to.
+ *
+ * When frames are limited, loop() logs the average draw time of every window
+ * on exit.
  */
 class GLFWApplication {
 private:
     std::vector<GLFWWindowPtr> m_windows; ///< List of managed GLFW windows.
 
+    bool m_headless{false};                                     ///< Running on the GLFW null platform.
+    HeadlessContext m_headlessContext{HeadlessContext::OSMesa}; ///< Headless context creation API.
+    int m_maxFrames{0};                                         ///< Frame limit applied to windows.
+    double m_fixedTimeStep{0.0};                                ///< Fixed timestep applied to windows.
+    std::string m_captureDir;                                   ///< Frame capture directory.
+
+    void readEnvironment();
+    void configureWindows();
+
 public:
     /**
      * @brief Default constructor. Initializes the application.
+     * @param headless Initialize GLFW without a display (also enabled by IVF_HEADLESS).
+     * @param context Context creation API for headless mode.
      */
-    GLFWApplication();
+    GLFWApplication(bool headless = false, HeadlessContext context = HeadlessContext::OSMesa);
 
     /**
      * @brief Destructor. Cleans up application resources.
@@ -47,6 +83,13 @@ public:
      */
     static std::shared_ptr<GLFWApplication> create();
 
+    /**
+     * @brief Factory method to create an application without a display.
+     * @param context Context creation API.
+     * @return std::shared_ptr<GLFWApplication> New GLFWApplication instance.
+     */
+    static std::shared_ptr<GLFWApplication> createHeadless(HeadlessContext context = HeadlessContext::OSMesa);
+
     /**
      * @brief Add a window to the application.
      * @param window Shared pointer to the GLFWWindow to add.
@@ -70,6 +113,50 @@ public:
      * @param value Value for the hint.
      */
     void hint(int hint, int value);
+
+    /**
+     * @brief Check if the application runs without a display.
+     * @return bool True in headless mode.
+     */
+    bool isHeadless() const;
+
+    /**
+     * @brief Close every window after a number of frames.
+     * @param frames Frame limit, 0 for no limit.
+     */
+    void setMaxFrames(int frames);
+
+    /**
+     * @brief Get the frame limit applied to the windows.
+     * @return int Frame limit, 0 if unlimited.
+     */
+    int maxFrames() const;
+
+    /**
+     * @brief Run every window with a fixed timestep (see GLFWWindow::setFixedTimeStep()).
+     * @param step Seconds per frame, 0 for wall-clock timing.
+     */
+    void setFixedTimeStep(double step);
+
+    /**
+     * @brief Get the fixed timestep applied to the windows.
+     * @return double Seconds per frame, 0 if wall-clock timing is used.
+     */
+    double fixedTimeStep() const;
+
+    /**
+     * @brief Capture every frame of every window to a directory.
+     *
+     * With several windows, each one writes to a numbered subdirectory.
+     * @param directory Existing output directory, empty to disable capture.
+     */
+    void setCaptureDirectory(const std::string &directory);
+
+    /**
+     * @brief Get the capture directory.
+     * @return const std::string& Directory, empty if capture is disabled.
+     */
+    const std::string &captureDirectory() const;
 };
 
 /**
@@ -14,6 +14,7 @@
 #include <string>
 
 #include <ivfui/ui_manager.h>
+#include <ivf/frame_capture.h>
 
 namespace ivfui {
 
@@ -72,8 +73,17 @@ private:
     bool        m_recording{false};
     std::string m_recordPath;
     int         m_recordFps{60};
-    int         m_recordFrameIdx{0};
     double      m_recordAccum{0.0};
+    ivf::FrameCapturePtr m_frameCapture; ///< Asynchronous read-back and encoding of recorded frames.
+
+    // Fixed timestep / frame limit
+    double m_fixedTimeStep{0.0};  ///< Simulated seconds per frame, 0 for wall-clock timing.
+    double m_simTime{0.0};        ///< Simulated time accumulated in fixed-timestep mode.
+    int m_maxFrames{0};           ///< Close the window after this many frames, 0 for no limit.
+    int m_drawnFrames{0};         ///< Number of completed draw() calls.
+    bool m_finishFrames{false};   ///< Wait for the GPU at the end of each frame.
+    double m_drawTime{0.0};       ///< Wall-clock duration of the last draw() in seconds.
+    double m_drawTimeSum{0.0};    ///< Sum of all draw() durations in seconds.
 
     void captureFrame(const std::string& path);
 
@@ -293,10 +303,73 @@ public:
 
     /**
      * @brief Get the elapsed time since window creation (seconds).
+     *
+     * In fixed-timestep mode this is the simulated time, i.e. the number of frames times the step.
      * @return double Elapsed time.
      */
     double elapsedTime() const;
 
+    /**
+     * @brief Advance time by a fixed step per frame instead of the wall-clock delta.
+     *
+     * frameTime() then always returns the step and the GLFW timer is set to the simulated time at
+     * the start of every frame, so code reading glfwGetTime() directly animates deterministically
+     * regardless of how long a frame takes to render. Pass 0 to return to wall-clock timing.
+     * @param step Seconds per frame.
+     */
+    void setFixedTimeStep(double step);
+
+    /**
+     * @brief Get the fixed timestep.
+     * @return double Seconds per frame, 0 if wall-clock timing is used.
+     */
+    double fixedTimeStep() const;
+
+    /**
+     * @brief Close the window after a number of frames have been drawn.
+     * @param frames Frame limit, 0 for no limit.
+     */
+    void setMaxFrames(int frames);
+
+    /**
+     * @brief Get the frame limit.
+     * @return int Frame limit, 0 if unlimited.
+     */
+    int maxFrames() const;
+
+    /**
+     * @brief Wait for the GPU to finish at the end of each frame.
+     *
+     * Makes drawTime() include GPU work on contexts without a blocking buffer swap, such as
+     * headless software rasterizers.
+     * @param flag True to call glFinish() after every frame.
+     */
+    void setFinishFrames(bool flag);
+
+    /**
+     * @brief Check if frames are finished synchronously.
+     * @return bool True if glFinish() is called after every frame.
+     */
+    bool finishFrames() const;
+
+    /**
+     * @brief Get the wall-clock duration of the last draw() call (seconds).
+     * @return double Draw time.
+     */
+    double drawTime() const;
+
+    /**
+     * @brief Get the average wall-clock duration of all draw() calls (seconds).
+     * @return double Average draw time.
+     */
+    double averageDrawTime() const;
+
+    /**
+     * @brief Get the number of completed draw() calls.
+     * @return int Frame count.
+     */
+    int drawnFrames() const;
+
     /**
      * @brief Get the UI renderer for this window.
      * @return UiRendererPtr Shared pointer to the UI renderer.
@@ -310,17 +383,30 @@ public:
     void saveScreenshot(const std::string& path);
 
     /**
-     * @brief Start saving sequential PNG frames to a directory.
-     * @param directory Output directory (must exist). Frames named frame_000000.png, etc.
-     * @param fps Target capture rate (frames per second of captured content).
+     * @brief Start saving sequential frames to a directory.
+     *
+     * Frames are read back asynchronously and encoded on worker threads by frameCapture(), so
+     * recording does not stall rendering. Frames the encoders cannot keep up with are dropped
+     * unless frameCapture()->setAllowDrops(false) is set.
+     * @param directory Output directory (must exist). Frames named frame_000000.png, etc. For raw
+     * output a file, or a command to pipe the frames to prefixed with '|'.
+     * @param fps Target capture rate (frames per second of captured content), 0 to capture every frame.
+     * @param format Output format.
      */
-    void startRecording(const std::string& directory, int fps = 60);
+    void startRecording(const std::string& directory, int fps = 60,
+                        ivf::CaptureFormat format = ivf::CaptureFormat::PNG);
 
     /**
-     * @brief Stop recording frames.
+     * @brief Stop recording frames and wait until all captured frames are written.
      */
     void stopRecording();
 
+    /**
+     * @brief Get the frame recorder, for configuration and queue/drop statistics.
+     * @return ivf::FrameCapturePtr Frame recorder.
+     */
+    ivf::FrameCapturePtr frameCapture() const;
+
     /**
      * @brief Check if recording is active.
      */
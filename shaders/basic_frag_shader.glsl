@@ -14,7 +14,8 @@
 #define TEX_BLEND_OVERLAY 4
 #define TEX_BLEND_DECAL 5
 
-out vec4 fragColor;
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out uint fragObjectId;
 
 struct Material 
 {
@@ -88,6 +89,7 @@ uniform bool useVertexColors;
 uniform bool usePointFalloff = false;
 uniform bool textRendering = false;
 uniform bool useFixedTextColor = false;
+uniform bool textSdf = false;
 
 uniform float point_falloff_a = 0.0;
 uniform float point_falloff_b = 0.0;
@@ -159,6 +161,19 @@ float calculateShadow(vec4 fragPosLightSpace, sampler2D sMap)
     return currentDepth - bias > closestDepth ? 1.0 : 0.0;
 }
 
+// Glyph coverage, distance field glyphs are thresholded at the outline with a pixel-wide edge
+
+float textAlpha()
+{
+    float value = texture(texture0, texCoord).r;
+
+    if (!textSdf)
+        return value;
+
+    float width = max(fwidth(value), 1e-4);
+    return smoothstep(0.5 - width, 0.5 + width, value);
+}
+
 float rand(vec2 co){
   return fract(sin(dot(co.xy ,vec2(12.9898,78.233))) * 43758.5453);
 }
@@ -233,15 +248,9 @@ void main()
 
     if (selectionRendering) 
     {
-        uint mask = uint(255);  // 0xFF
-        uint r = objectId & mask;
-        uint g = (objectId >> uint(8)) & mask;
-        uint b = (objectId >> uint(16)) & mask;
-    
-        fragColor = vec4(float(r) / 255.0, 
-                         float(g) / 255.0, 
-                         float(b) / 255.0, 
-                         1.0);
+        // Object IDs go to the R32UI selection target on draw buffer 1
+        fragObjectId = objectId;
+        fragColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
     else
     {
@@ -255,12 +264,12 @@ void main()
                 {
                     if (useFixedTextColor)
                     {
-                        vec4 texSample = vec4(textColor.rgb, texture(texture0, texCoord).r);
+                        vec4 texSample = vec4(textColor.rgb, textAlpha());
                         fragColor = texSample;
                     }
                     else
                     {
-                        vec4 texSample = vec4(result.rgb, texture(texture0, texCoord).r);
+                        vec4 texSample = vec4(result.rgb, textAlpha());
                         fragColor = texSample;
                     }
                 }
@@ -1,10 +1,13 @@
 #include <ivf/bend_deformer.h>
 #include <ivf/utils.h>
 
+#include <algorithm>
+
 using namespace ivf;
 
 BendDeformer::BendDeformer(const glm::vec3 &axis, const glm::vec3 &center)
-    : m_axis(glm::normalize(axis)), m_center(center), m_curvature(0.0f), m_startDistance(0.0f), m_endDistance(10.0f)
+    : m_axis(glm::normalize(axis)), m_center(center), m_curvature(0.0f), m_startDistance(0.0f), m_endDistance(10.0f),
+      m_bendAxis(0.0f)
 {}
 
 std::shared_ptr<BendDeformer> BendDeformer::create(const glm::vec3 &axis, const glm::vec3 &center)
@@ -15,22 +18,26 @@ std::shared_ptr<BendDeformer> BendDeformer::create(const glm::vec3 &axis, const
 void BendDeformer::setAxis(const glm::vec3 &axis)
 {
     m_axis = glm::normalize(axis);
+    markChanged();
 }
 
 void BendDeformer::setCenter(const glm::vec3 &center)
 {
     m_center = center;
+    markChanged();
 }
 
 void BendDeformer::setCurvature(float curvature)
 {
     m_curvature = curvature;
+    markChanged();
 }
 
 void BendDeformer::setDistanceRange(float start, float end)
 {
     m_startDistance = start;
     m_endDistance = end;
+    markChanged();
 }
 
 void BendDeformer::apply()
@@ -38,14 +45,28 @@ void BendDeformer::apply()
     if (!m_enabled || !m_originalVertices || !m_deformedVertices)
         return;
 
+    applyWithKernel();
+}
+
+glm::vec3 BendDeformer::bendDirection() const
+{
     // Create a perpendicular vector to the axis for bending direction
     glm::vec3 bendAxis =
         (std::abs(glm::dot(m_axis, glm::vec3(1, 0, 0))) < 0.9f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
-    bendAxis = glm::normalize(glm::cross(m_axis, bendAxis));
+    return glm::normalize(glm::cross(m_axis, bendAxis));
+}
 
-    for (GLuint i = 0; i < m_originalVertices->rows(); ++i)
+bool BendDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    m_bendAxis = bendDirection();
+    return true;
+}
+
+void BendDeformer::applyKernel(glm::vec3 *positions, [[maybe_unused]] GLuint first, GLuint count) const
+{
+    for (GLuint i = 0; i < count; ++i)
     {
-        glm::vec3 originalPos = m_originalVertices->vertex(i);
+        glm::vec3 originalPos = positions[i];
         glm::vec3 relativePos = originalPos - m_center;
 
         float axisDistance = glm::dot(relativePos, m_axis);
@@ -56,19 +77,39 @@ void BendDeformer::apply()
         {
             // Apply bending transformation
             float bendAmount = m_curvature * axisDistance * weight;
-            glm::vec3 offset = bendAxis * bendAmount;
+            glm::vec3 offset = m_bendAxis * bendAmount;
             glm::vec3 deformedPos = originalPos + offset;
 
-            glm::vec3 finalPos = glm::mix(originalPos, deformedPos, weight);
-            m_deformedVertices->setVertex(i, finalPos.x, finalPos.y, finalPos.z);
-        }
-        else
-        {
-            m_deformedVertices->setVertex(i, originalPos.x, originalPos.y, originalPos.z);
+            positions[i] = glm::mix(originalPos, deformedPos, weight);
         }
     }
 }
 
+bool BendDeformer::transformBounds(BoundingBox &bbox) const
+{
+    // Positions move along the bend direction by at most curvature * distance along the axis,
+    // with the distance limited to the range where the weight is non-zero
+    float maxDistance = 0.0f;
+    for (auto &corner : bbox.corners())
+        maxDistance = std::max(maxDistance, std::abs(glm::dot(corner - m_center, m_axis)));
+
+    maxDistance = std::clamp(std::max(m_startDistance, m_endDistance), 0.0f, maxDistance);
+
+    glm::vec3 displacement = glm::abs(bendDirection()) * std::abs(m_curvature) * maxDistance * m_weight * m_weight;
+    bbox.setBounds(bbox.min() - displacement, bbox.max() + displacement);
+    return true;
+}
+
+bool BendDeformer::gpuDeformer(GpuDeformer &gpu) const
+{
+    gpu.type = GpuDeformerType::BEND;
+    gpu.params[0] = glm::vec4(m_axis, m_curvature);
+    gpu.params[1] = glm::vec4(m_center, m_weight);
+    gpu.params[2] = glm::vec4(bendDirection(), 0.0f);
+    gpu.params[3] = glm::vec4(m_startDistance, m_endDistance, 0.0f, 0.0f);
+    return true;
+}
+
 std::unique_ptr<Deformer> BendDeformer::clone() const
 {
     auto cloned = std::make_unique<BendDeformer>(m_axis, m_center);
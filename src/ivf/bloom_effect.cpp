@@ -2,6 +2,8 @@
 
 #include <ivf/post_shaders.h>
 
+#include <algorithm>
+
 using namespace ivf;
 
 ivf::BloomEffect::BloomEffect() : Effect(), m_threshold(1.0), m_intensity(1.0)
@@ -34,20 +36,60 @@ float ivf::BloomEffect::intensity() const
     return m_intensity;
 }
 
+
+void ivf::BloomEffect::setQuality(BlurQuality quality)
+{
+    m_quality = static_cast<int>(quality);
+}
+
+BlurQuality ivf::BloomEffect::quality() const
+{
+    return static_cast<BlurQuality>(std::clamp(m_quality, 0, 2));
+}
+
+DownsampleChainPtr ivf::BloomEffect::chain()
+{
+    return m_chain;
+}
+
+void ivf::BloomEffect::renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO)
+{
+    if (!m_chain)
+        return;
+
+    m_chain->setQuality(this->quality());
+
+    // Higher presets spread the glow over more levels
+
+    auto levels = 4 + static_cast<int>(this->quality());
+    auto texture = m_chain->render(sourceTexture, width, height, levels, quadVAO, 1.0f, m_threshold, true);
+
+    glActiveTexture(GL_TEXTURE0 + EFFECT_AUX_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
 void ivf::BloomEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, ivf::bloom_frag_shader_source,
                                          "bloom", false);
+    m_chain = DownsampleChain::create();
+    m_chain->load();
 }
 
 void ivf::BloomEffect::doUpdateParams()
 {
-    m_program->uniformFloat("threshold", m_threshold);
-    m_program->uniformFloat("intensity", m_intensity);
+    // Every upsample step adds one level, normalize so the intensity does not depend on the preset
+
+    auto levels = std::max(m_chain ? m_chain->levelCount() : 1, 1);
+
+    m_program->uniformInt("bloomTexture", EFFECT_AUX_TEXTURE_UNIT);
+    m_program->uniformFloat("bloomScale", m_intensity / float(levels));
 }
 
 void ivf::BloomEffect::setupProperties()
 {
     addProperty("threshold", &m_threshold, "Bloom");
     addProperty("intensity", &m_intensity, "Bloom");
+    addProperty("quality", &m_quality, 0, 2, "Bloom");
 }
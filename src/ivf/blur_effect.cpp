@@ -2,6 +2,8 @@
 
 #include <ivf/post_shaders.h>
 
+#include <algorithm>
+
 using namespace ivf;
 
 ivf::BlurEffect::BlurEffect()
@@ -27,18 +29,62 @@ float ivf::BlurEffect::blurRadius()
     return m_blurRadius;
 }
 
+
+void ivf::BlurEffect::setQuality(BlurQuality quality)
+{
+    m_quality = static_cast<int>(quality);
+}
+
+BlurQuality ivf::BlurEffect::quality() const
+{
+    return static_cast<BlurQuality>(std::clamp(m_quality, 0, 2));
+}
+
+DownsampleChainPtr ivf::BlurEffect::chain()
+{
+    return m_chain;
+}
+
+void ivf::BlurEffect::renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO)
+{
+    if (!m_chain || m_blurRadius <= 0.0f)
+        return;
+
+    m_chain->setQuality(this->quality());
+
+    auto levels = DownsampleChain::levelsForRadius(m_blurRadius);
+    auto texture = m_chain->render(sourceTexture, width, height, levels, quadVAO, this->blurOffset());
+
+    glActiveTexture(GL_TEXTURE0 + EFFECT_AUX_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+float ivf::BlurEffect::blurOffset() const
+{
+    // Scale the taps so the radius changes continuously between level counts
+
+    auto levels = DownsampleChain::levelsForRadius(m_blurRadius);
+    return std::clamp(m_blurRadius * 1.5f / float(2 << levels), 0.5f, 2.0f);
+}
+
 void ivf::BlurEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, ivf::blur_frag_shader_source,
                                          "blur", false);
+    m_chain = DownsampleChain::create();
+    m_chain->load();
 }
 
 void ivf::BlurEffect::doUpdateParams()
 {
-    m_program->uniformFloat("blurRadius", m_blurRadius);
+    m_program->uniformInt("blurTexture", EFFECT_AUX_TEXTURE_UNIT);
+    m_program->uniformFloat("blurMix", std::clamp(m_blurRadius, 0.0f, 1.0f));
+    m_program->uniformFloat("blurOffset", this->blurOffset());
 }
 
 void ivf::BlurEffect::setupProperties()
 {
     addProperty("blurRadius", &m_blurRadius, "Blur");
+    addProperty("quality", &m_quality, 0, 2, "Blur");
 }
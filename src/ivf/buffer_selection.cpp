@@ -3,15 +3,27 @@
 #include <ivf/selection_manager.h>
 
 #include <ivf/logger.h>
+#include <ivf/render_target_pool.h>
+#include <ivf/selection_shaders.h>
+#include <ivf/shader_manager.h>
+#include <ivf/transform_manager.h>
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <unordered_set>
 
 using namespace ivf;
 
+namespace {
+
+// Widest presence mask row, masks for more IDs wrap to further rows
+
+constexpr int maxMaskWidth = 4096;
+
+} // namespace
+
 BufferSelection::BufferSelection(CompositeNodePtr scene)
-    : m_fbo(0), m_colorTexture(0), m_scene(scene), m_depthRenderBuffer(0), m_width(0), m_height(0)
+    : m_width(0), m_height(0), m_scene(scene)
 {}
 
 BufferSelection::~BufferSelection()
@@ -23,10 +35,30 @@ void BufferSelection::resize(int width, int height)
 {
     m_width = width;
     m_height = height;
-    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderBuffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+    this->updateTarget();
+}
+
+void BufferSelection::updateTarget()
+{
+    RenderTargetDesc desc;
+    desc.width = m_width;
+    desc.height = m_height;
+    desc.colorFormat = GL_R32UI;
+    desc.depthFormat = GL_DEPTH_COMPONENT24;
+
+    RenderTargetPool::instance()->reacquire(m_target, desc);
+}
+
+void BufferSelection::bindIdTarget()
+{
+    this->updateTarget();
+    glBindFramebuffer(GL_FRAMEBUFFER, m_target->fbo());
+
+    // The stock shaders write the object ID to output 1, the color output is discarded
+
+    GLenum drawBuffers[] = {GL_NONE, GL_COLOR_ATTACHMENT0};
+    glDrawBuffers(2, drawBuffers);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
 }
 
 void BufferSelection::refresh()
@@ -35,15 +67,37 @@ void BufferSelection::refresh()
     MapVisitor mapVisitor;
     m_scene->accept(&mapVisitor);
     m_nodeMap = mapVisitor.takeMap();
+    m_pickValid = false;
     logInfofc("BufferSelection", "BufferSelection::refresh: {} nodes in scene", m_nodeMap.size());
 }
 
 void BufferSelection::clear()
 {
-    glDeleteFramebuffers(1, &m_fbo);
-    glDeleteTextures(1, &m_colorTexture);
-    glDeleteRenderbuffers(1, &m_depthRenderBuffer);
+    RenderTargetPool::instance()->release(m_target);
+    m_target = nullptr;
     m_nodeMap.clear();
+
+    if (m_pickFence)
+    {
+        glDeleteSync(m_pickFence);
+        m_pickFence = nullptr;
+    }
+
+    if (m_pickPBO)
+    {
+        glDeleteBuffers(1, &m_pickPBO);
+        m_pickPBO = 0;
+    }
+
+    if (m_reduceVAO)
+    {
+        glDeleteVertexArrays(1, &m_reduceVAO);
+        m_reduceVAO = 0;
+    }
+
+    m_pickedId = 0;
+    m_pickValid = false;
+    m_tracker.reset();
 }
 
 std::shared_ptr<BufferSelection> BufferSelection::create(CompositeNodePtr scene)
@@ -53,7 +107,7 @@ std::shared_ptr<BufferSelection> BufferSelection::create(CompositeNodePtr scene)
 
 void BufferSelection::initialize(int width, int height)
 {
-    if (m_fbo != 0) {
+    if (m_target) {
         // Already initialized — just update the node map and resize if needed
         if (m_width != width || m_height != height)
             resize(width, height);
@@ -75,18 +129,9 @@ void BufferSelection::initialize(int width, int height)
 
     logInfofc("BufferSelection", "BufferSelection::initialize: {} nodes in scene", m_nodeMap.size());
 
-    glGenFramebuffers(1, &m_fbo);
-    glGenTextures(1, &m_colorTexture);
-    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-
-    glGenRenderbuffers(1, &m_depthRenderBuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderBuffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+    this->updateTarget();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_target->fbo());
 }
 
 Node *BufferSelection::nodeFromId(unsigned int objectId)
@@ -107,18 +152,170 @@ Node *BufferSelection::nodeAtPixel(int x, int y)
 void BufferSelection::begin()
 {
     SelectionManager::instance()->setSelectionRendering(true);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    this->bindIdTarget();
+
+    GLuint zero[4] = {0, 0, 0, 0};
+    GLfloat one = 1.0f;
+
+    glClearBufferuiv(GL_COLOR, 1, zero);
+    glClearBufferfv(GL_DEPTH, 0, &one);
     glEnable(GL_DEPTH_TEST);
 }
 
-unsigned int BufferSelection::idAtPixel(int x, int y)
+void BufferSelection::pollPick()
+{
+    if (!m_pickFence)
+        return;
+
+    GLenum status = glClientWaitSync(m_pickFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+    if (status == GL_TIMEOUT_EXPIRED)
+        return;
+
+    glDeleteSync(m_pickFence);
+    m_pickFence = nullptr;
+
+    if (status == GL_WAIT_FAILED)
+        return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickPBO);
+
+    if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT))
+    {
+        std::memcpy(&m_pickedId, data, sizeof(GLuint));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+bool BufferSelection::beginPick(int x, int y)
 {
-    unsigned char pixel[3];
+    this->pollPick();
+
+    // Only one read-back in flight, the cursor is sampled again once it has arrived
 
-    glReadPixels(x, m_height - y, 1, 1, GL_RGB, GL_UNSIGNED_BYTE, pixel);
+    if (m_pickFence)
+        return false;
+
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+    {
+        m_pickedId = 0;
+        m_pickValid = false;
+        return false;
+    }
+
+    bool sceneChanged = false;
+
+    if (m_trackSceneChanges)
+    {
+        m_tracker.update(m_scene);
+        sceneChanged = !m_tracker.dirtyRegions().empty();
+    }
 
-    uint32_t id = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+    auto transformManager = TransformManager::instance();
+    glm::mat4 viewProj = transformManager->projectionMatrix() * transformManager->viewMatrix();
+
+    if (m_pickValid && !sceneChanged && x == m_pickX && y == m_pickY && viewProj == m_pickViewProj)
+    {
+        m_pickSkips++;
+        return false;
+    }
+
+    m_pickX = x;
+    m_pickY = y;
+    m_pickViewProj = viewProj;
+    m_pickValid = true;
+
+    // Render only a small window around the cursor
+
+    int glY = m_height - 1 - y;
+    int size = 2 * m_pickRadius + 1;
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x - m_pickRadius, glY - m_pickRadius, size, size);
+
+    this->begin();
+
+    m_pickPasses++;
+
+    return true;
+}
+
+void BufferSelection::endPick()
+{
+    if (!m_pickPBO)
+    {
+        glGenBuffers(1, &m_pickPBO);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickPBO);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+    else
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickPBO);
+
+    // The read lands in the pixel buffer, the result is collected by a later beginPick()
+
+    glReadPixels(m_pickX, m_height - 1 - m_pickY, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_pickFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    this->end();
+}
+
+Node *BufferSelection::pickedNode()
+{
+    return nodeFromId(m_pickedId);
+}
+
+unsigned int BufferSelection::pickedId() const
+{
+    return m_pickedId;
+}
+
+void BufferSelection::invalidate()
+{
+    m_pickValid = false;
+}
+
+void BufferSelection::setPickRadius(int radius)
+{
+    m_pickRadius = std::max(radius, 0);
+}
+
+int BufferSelection::pickRadius() const
+{
+    return m_pickRadius;
+}
+
+void BufferSelection::setTrackSceneChanges(bool flag)
+{
+    m_trackSceneChanges = flag;
+
+    if (!flag)
+        m_tracker.reset();
+}
+
+bool BufferSelection::trackSceneChanges() const
+{
+    return m_trackSceneChanges;
+}
+
+size_t BufferSelection::pickPasses() const
+{
+    return m_pickPasses;
+}
+
+size_t BufferSelection::pickSkips() const
+{
+    return m_pickSkips;
+}
+
+unsigned int BufferSelection::idAtPixel(int x, int y)
+{
+    GLuint id = 0;
+
+    glReadPixels(x, m_height - 1 - y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &id);
 
     return id;
 }
@@ -133,21 +330,79 @@ std::vector<Node*> BufferSelection::nodesInRegion(int x0, int y0, int x1, int y1
 
     int rw = rx - lx + 1;
     int rh = by - ty + 1;
-    if (rw <= 0 || rh <= 0) return {};
+    if (rw <= 0 || rh <= 0 || m_nodeMap.empty()) return {};
 
     // Flip Y: OpenGL origin is bottom-left
     int glY = m_height - by - 1;
 
-    std::vector<unsigned char> pixels(rw * rh * 3);
-    glReadPixels(lx, glY, rw, rh, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    if (!m_reduceProgram)
+    {
+        m_reduceProgram = ShaderManager::instance()->program("id_reduce");
+
+        if (!m_reduceProgram)
+            m_reduceProgram =
+                smLoadProgramFromStrings(id_reduce_vert_shader_source, id_reduce_frag_shader_source, "id_reduce", false);
+
+        glGenVertexArrays(1, &m_reduceVAO);
+    }
+
+    if (!m_reduceProgram)
+        return {};
+
+    // One presence texel per ID, drawn as one point per region pixel
+
+    int idCount = static_cast<int>(m_nodeMap.rbegin()->first) + 1;
+    int maskWidth = std::min(idCount, maxMaskWidth);
+    int maskHeight = (idCount + maskWidth - 1) / maskWidth;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    GLint currentProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+
+    auto mask = RenderTargetPool::instance()->acquire(maskWidth, maskHeight, GL_R8);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mask->fbo());
+    glViewport(0, 0, maskWidth, maskHeight);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    m_reduceProgram->use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_target->texture());
+    m_reduceProgram->uniformInt("idTexture", 0);
+    glUniform4i(m_reduceProgram->uniformLoc("region"), lx, glY, rw, rh);
+    glUniform2i(m_reduceProgram->uniformLoc("maskSize"), maskWidth, maskHeight);
+
+    glBindVertexArray(m_reduceVAO);
+    glDrawArrays(GL_POINTS, 0, rw * rh);
+    glBindVertexArray(0);
+
+    std::vector<unsigned char> flags(static_cast<size_t>(maskWidth) * maskHeight);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, maskWidth, maskHeight, GL_RED, GL_UNSIGNED_BYTE, flags.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    RenderTargetPool::instance()->release(mask);
+
+    // Restore the selection pass state
+
+    glUseProgram(currentProgram);
+    this->bindIdTarget();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glEnable(GL_DEPTH_TEST);
 
-    std::unordered_set<unsigned int> seen;
     std::vector<Node*> result;
 
-    for (int i = 0; i < rw * rh; ++i) {
-        unsigned int id = pixels[i*3] | (pixels[i*3+1] << 8) | (pixels[i*3+2] << 16);
-        if (id == 0 || seen.count(id)) continue;
-        seen.insert(id);
+    for (int id = 1; id < idCount; ++id)
+    {
+        if (flags[id] == 0)
+            continue;
+
         Node* n = nodeFromId(id);
         if (n) result.push_back(n);
     }
@@ -157,6 +412,10 @@ std::vector<Node*> BufferSelection::nodesInRegion(int x0, int y0, int x1, int y1
 
 void BufferSelection::end()
 {
+    GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0};
+    glDrawBuffers(1, drawBuffers);
+    glDisable(GL_SCISSOR_TEST);
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
@@ -1,5 +1,6 @@
 #include <ivf/color_grading_effect.h>
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -28,16 +29,17 @@ float ColorGradingEffect::saturation() const { return m_saturation; }
 void ColorGradingEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::color_grading_frag_shader_source, "color_grading", false);
+                                         EffectFusion::fragmentSource({ivf::color_grading_pointwise_source}),
+                                         "color_grading", false);
 }
 
 void ColorGradingEffect::doUpdateParams()
 {
-    m_program->uniformVec3("shadows", m_shadows);
-    m_program->uniformVec3("midtones", m_midtones);
-    m_program->uniformVec3("highlights", m_highlights);
-    m_program->uniformFloat("contrast", m_contrast);
-    m_program->uniformFloat("saturation", m_saturation);
+    paramProgram()->uniformVec3(paramName("shadows"), m_shadows);
+    paramProgram()->uniformVec3(paramName("midtones"), m_midtones);
+    paramProgram()->uniformVec3(paramName("highlights"), m_highlights);
+    paramProgram()->uniformFloat(paramName("contrast"), m_contrast);
+    paramProgram()->uniformFloat(paramName("saturation"), m_saturation);
 }
 
 void ColorGradingEffect::setupProperties()
@@ -48,3 +50,13 @@ void ColorGradingEffect::setupProperties()
     addProperty("contrast", &m_contrast, 0.0f, 3.0f, "Color Grading");
     addProperty("saturation", &m_saturation, 0.0f, 3.0f, "Color Grading");
 }
+
+bool ColorGradingEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ColorGradingEffect::pointwiseSource() const
+{
+    return ivf::color_grading_pointwise_source;
+}
@@ -1,8 +1,8 @@
 #include <ivf/cubemap.h>
 
 #include <ivf/logger.h>
+#include <ivf/texture_cache.h>
 
-#include <stb_image.h>
 #include <glm/glm.hpp>
 
 #include <filesystem>
@@ -29,55 +29,58 @@ std::shared_ptr<Cubemap> Cubemap::create()
     return std::make_shared<Cubemap>();
 }
 
-bool Cubemap::loadFace(GLenum target, std::string_view path)
+bool Cubemap::load(std::string_view posX, std::string_view negX,
+                   std::string_view posY, std::string_view negY,
+                   std::string_view posZ, std::string_view negZ)
 {
-    int w, h, ch;
-    unsigned char* data = stbi_load(std::string(path).c_str(), &w, &h, &ch, 0);
-    if (!data) {
-        logErrorfc("Cubemap", "Cannot load face: {}", path);
-        return false;
-    }
+    glBindTexture(GL_TEXTURE_CUBE_MAP, m_id);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-    // OpenGL's cubemap face coordinates are left-handed relative to the
-    // right-handed camera/world convention used by the scene. Mirror each
-    // source face horizontally so labeled skybox images read naturally.
-    for (int y = 0; y < h; ++y) {
-        auto* row = data + y * w * ch;
-        for (int x = 0; x < w / 2; ++x) {
-            auto* left = row + x * ch;
-            auto* right = row + (w - 1 - x) * ch;
-            for (int c = 0; c < ch; ++c)
-                std::swap(left[c], right[c]);
-        }
-    }
+    auto image = TextureImage::loadCubemap({std::string(posX), std::string(negX), std::string(posY),
+                                            std::string(negY), std::string(posZ), std::string(negZ)});
+    if (!image.valid())
+        logErrorfc("Cubemap", "Cannot load cubemap: {}", image.error);
 
-    GLenum fmt = (ch == 4) ? GL_RGBA : (ch == 3) ? GL_RGB : GL_RED;
-    glTexImage2D(target, 0, fmt, w, h, 0, fmt, GL_UNSIGNED_BYTE, data);
-    stbi_image_free(data);
-    return true;
+    image.upload(GL_TEXTURE_CUBE_MAP);
+
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    return image.valid();
 }
 
-bool Cubemap::load(std::string_view posX, std::string_view negX,
-                   std::string_view posY, std::string_view negY,
-                   std::string_view posZ, std::string_view negZ)
+bool Cubemap::load(std::string_view filename)
 {
+    auto image = TextureImage::load(filename);
+
+    if (image.valid() && image.faces != 6) {
+        logErrorfc("Cubemap", "Cannot load cubemap: {} is not a cubemap", filename);
+        return false;
+    }
+
+    if (!image.valid()) {
+        logErrorfc("Cubemap", "Cannot load cubemap: {}", image.error);
+        return false;
+    }
+
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_id);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
+                    image.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-    bool ok = true;
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X, posX);
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, negX);
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, posY);
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, negY);
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, posZ);
-    ok &= loadFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, negZ);
+    bool uploaded = image.upload(GL_TEXTURE_CUBE_MAP);
 
     glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-    return ok;
+
+    if (!uploaded)
+        logErrorfc("Cubemap", "Cannot load cubemap: {} (compressed format not supported)", filename);
+
+    return uploaded;
 }
 
 std::string Cubemap::findFile(std::string_view dir, std::string_view stem)
@@ -89,8 +92,21 @@ std::string Cubemap::findFile(std::string_view dir, std::string_view stem)
     return {};
 }
 
+std::string Cubemap::findContainer(std::string_view dir)
+{
+    for (auto& ext : {".ktx2", ".dds"}) {
+        auto p = fs::path(dir) / (std::string("cubemap") + ext);
+        if (fs::exists(p)) return p.string();
+    }
+    return {};
+}
+
 bool Cubemap::loadFromDirectory(std::string_view dir)
 {
+    auto container = findContainer(dir);
+    if (!container.empty())
+        return load(container);
+
     return load(
         findFile(dir, "right"),  findFile(dir, "left"),
         findFile(dir, "top"),    findFile(dir, "bottom"),
@@ -158,6 +174,7 @@ bool Cubemap::loadGradient(glm::vec3 topColor, glm::vec3 horizonColor, glm::vec3
 
 void Cubemap::bind(int unit)
 {
+    m_lastUsed = TextureCache::frame();
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_id);
 }
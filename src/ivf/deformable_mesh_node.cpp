@@ -1,6 +1,7 @@
 #include <ivf/deformable_mesh_node.h>
 #include <ivf/utils.h>
 #include <ivf/deformer_stack.h>
+#include <ivf/shader_manager.h>
 
 using namespace ivf;
 
@@ -44,42 +45,217 @@ bool DeformableMeshNode::autoUpdate() const
     return m_autoUpdate;
 }
 
+void DeformableMeshNode::setGpuDeformation(bool gpuDeformation)
+{
+    m_gpuDeformation = gpuDeformation;
+}
+
+bool DeformableMeshNode::gpuDeformation() const
+{
+    return m_gpuDeformation;
+}
+
+bool DeformableMeshNode::useGpuDeformation() const
+{
+    if (!m_gpuDeformation || !m_deformerStack->gpuCapable())
+        return false;
+
+    auto program = ShaderManager::instance()->currentProgram();
+    return program && program->uniformLoc("deformerCount") != -1;
+}
+
 void DeformableMeshNode::applyDeformers()
 {
-    if (!m_meshes.empty() && m_originalVertices)
+    if (m_gpuDeformation && m_deformerStack->gpuCapable())
     {
-        m_deformerStack->setInput(m_originalVertices);
-        m_deformerStack->apply();
+        // The evaluation visits every vertex anyway, so the exact bounds come at little extra cost
+        if (m_deformerStack->revision() != m_evaluatedRevision)
+            updateExactBounds();
+    }
+    else
+        deformMeshes();
+}
+
+void DeformableMeshNode::invalidateDeformation()
+{
+    m_meshRevision = 0;
+    m_evaluatedRevision = 0;
+    m_boundsRevision = 0;
+}
+
+void DeformableMeshNode::setAnalyticBounds(bool analyticBounds)
+{
+    m_analyticBounds = analyticBounds;
+}
+
+bool DeformableMeshNode::analyticBounds() const
+{
+    return m_analyticBounds;
+}
+
+void DeformableMeshNode::setExactBoundsInterval(int interval)
+{
+    m_exactBoundsInterval = std::max(interval, 0);
+}
+
+int DeformableMeshNode::exactBoundsInterval() const
+{
+    return m_exactBoundsInterval;
+}
+
+void DeformableMeshNode::updateExactBounds()
+{
+    m_boundsUpdates = 0;
 
-        auto deformedVertices = m_deformerStack->getOutput();
-        if (deformedVertices)
+    if (!m_gpuDeformation || !m_deformerStack->gpuCapable())
+    {
+        // The mesh vertices hold the deformation
+        updateBoundingBox();
+        return;
+    }
+
+    evaluateDeformers();
+    m_boundsRevision = m_evaluatedRevision;
+
+    if (!autoUpdateBoundingBox())
+        return;
+
+    BoundingBox bbox;
+    for (auto &deformed : m_deformedVertices)
+    {
+        if (!deformed)
+            continue;
+
+        for (GLuint i = 0; i < deformed->rows(); ++i)
+            bbox.add(deformed->vertex(i));
+    }
+    setLocalBoundingBox(bbox);
+}
+
+void DeformableMeshNode::updateDeformedBounds()
+{
+    if (!autoUpdateBoundingBox())
+        return;
+
+    bool exact = !m_analyticBounds || (m_exactBoundsInterval > 0 && ++m_boundsUpdates >= m_exactBoundsInterval);
+
+    if (!exact)
+    {
+        // O(1) conservative box from the bounds of the original vertices
+        BoundingBox bbox = m_originalBounds;
+        if (bbox.isValid() && m_deformerStack->transformBounds(bbox))
         {
-            // Update mesh vertices
-            auto mesh = m_meshes[0]; // Apply to first mesh for simplicity
-            auto meshVertices = mesh->vertices();
-            std::memcpy(meshVertices->data(), deformedVertices->data(), deformedVertices->memSize());
-            mesh->updateVertices();
-            mesh->updateNormals();
-            
-            // Update bounding box after deformation
-            updateBoundingBox();
+            setLocalBoundingBox(bbox);
+            return;
         }
     }
+
+    updateExactBounds();
+}
+
+uint64_t DeformableMeshNode::contentRevision() const
+{
+    // The shader always draws the current parameters, as does the next draw with auto-update
+    if (m_autoUpdate || (m_gpuDeformation && m_deformerStack->gpuCapable()))
+        return m_deformerStack->revision();
+
+    return m_meshRevision;
+}
+
+std::shared_ptr<Vertices> DeformableMeshNode::deformedVertices(size_t index)
+{
+    if (index < m_deformedVertices.size())
+        return m_deformedVertices[index];
+
+    return nullptr;
+}
+
+void DeformableMeshNode::deformMeshes()
+{
+    storeOriginalVertices();
+
+    auto revision = m_deformerStack->revision();
+    if (revision == m_meshRevision)
+        return;
+
+    // Deform straight into the mesh vertices, all meshes in one pass
+
+    std::vector<std::shared_ptr<Vertices>> meshVertices;
+    for (auto &mesh : m_meshes)
+        meshVertices.push_back(mesh->vertices());
+
+    m_deformerStack->applyTo(m_originalVertices, meshVertices);
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        if (meshVertices[i] && m_originalVertices[i] && meshVertices[i]->rows() == m_originalVertices[i]->rows())
+        {
+            m_meshes[i]->updateVertices();
+            m_meshes[i]->updateNormals();
+        }
+    }
+
+    m_meshDeformed = true;
+    m_meshRevision = revision;
+
+    // Update bounding box after deformation
+    updateDeformedBounds();
+    m_boundsRevision = revision;
+}
+
+void DeformableMeshNode::evaluateDeformers()
+{
+    storeOriginalVertices();
+
+    auto revision = m_deformerStack->revision();
+    if (revision == m_evaluatedRevision)
+        return;
+
+    // The shader deforms the meshes, only evaluate for picking, bounds and export
+
+    m_deformedVertices.resize(m_originalVertices.size());
+    for (size_t i = 0; i < m_originalVertices.size(); ++i)
+    {
+        auto &original = m_originalVertices[i];
+        auto &deformed = m_deformedVertices[i];
+        if (!original)
+            deformed = nullptr;
+        else if (!deformed || deformed->rows() != original->rows())
+            deformed = std::make_shared<Vertices>(original->rows());
+    }
+
+    m_deformerStack->applyTo(m_originalVertices, m_deformedVertices);
+    m_evaluatedRevision = revision;
+}
+
+void DeformableMeshNode::restoreMeshes()
+{
+    for (size_t i = 0; i < m_meshes.size() && i < m_originalVertices.size(); ++i)
+    {
+        auto meshVertices = m_meshes[i]->vertices();
+        auto &original = m_originalVertices[i];
+        if (meshVertices && original && meshVertices->rows() == original->rows())
+        {
+            std::memcpy(meshVertices->data(), original->data(), original->memSize());
+            m_meshes[i]->updateVertices();
+            m_meshes[i]->updateNormals();
+        }
+    }
+
+    m_meshDeformed = false;
+    m_meshRevision = 0;
 }
 
 void DeformableMeshNode::resetDeformers()
 {
     m_deformerStack->reset();
-    if (!m_meshes.empty() && m_originalVertices)
+    if (!m_meshes.empty() && !m_originalVertices.empty())
     {
-        auto mesh = m_meshes[0];
-        auto meshVertices = mesh->vertices();
-        std::memcpy(meshVertices->data(), m_originalVertices->data(), m_originalVertices->memSize());
-        mesh->updateVertices();
-        mesh->updateNormals();
-        
+        restoreMeshes();
+
         // Update bounding box after reset
         updateBoundingBox();
+        m_boundsRevision = 0;
     }
 }
 
@@ -91,19 +267,90 @@ void DeformableMeshNode::addMesh(std::shared_ptr<Mesh> mesh)
 
 void DeformableMeshNode::storeOriginalVertices()
 {
-    if (!m_meshes.empty())
+    bool changed = m_originalVertices.size() != m_meshes.size();
+
+    m_originalVertices.resize(m_meshes.size());
+    m_originalMeshes.resize(m_meshes.size());
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        // Originals stay valid as long as the mesh and its vertex count are the same
+
+        auto meshVertices = m_meshes[i]->vertices();
+        auto &original = m_originalVertices[i];
+        bool sameRows = original && meshVertices ? original->rows() == meshVertices->rows()
+                                                 : !original && !meshVertices;
+
+        if (m_originalMeshes[i].lock() == m_meshes[i] && sameRows)
+            continue;
+
+        original = nullptr;
+        if (meshVertices)
+        {
+            original = std::make_shared<Vertices>(meshVertices->rows());
+            std::memcpy(original->data(), meshVertices->data(), meshVertices->memSize());
+        }
+        m_originalMeshes[i] = m_meshes[i];
+        changed = true;
+    }
+
+    if (!changed)
+        return;
+
+    // Bounds the analytic bounding boxes start from
+    m_originalBounds.clear();
+    for (auto &original : m_originalVertices)
     {
-        auto meshVertices = m_meshes[0]->vertices();
-        m_originalVertices = std::make_shared<Vertices>(meshVertices->rows());
-        std::memcpy(m_originalVertices->data(), meshVertices->data(), meshVertices->memSize());
+        if (!original)
+            continue;
+
+        for (GLuint i = 0; i < original->rows(); ++i)
+            m_originalBounds.add(original->vertex(i));
     }
+
+    // New meshes have not been deformed yet
+    invalidateDeformation();
+}
+
+void DeformableMeshNode::captureOriginalVertices()
+{
+    // The meshes hold new, undeformed geometry
+    m_originalVertices.clear();
+    m_originalMeshes.clear();
+    m_meshDeformed = false;
+
+    storeOriginalVertices();
 }
 
 void DeformableMeshNode::doDraw()
 {
+    if (useGpuDeformation())
+    {
+        // The meshes must hold the original vertices when the shader deforms them
+
+        if (m_meshDeformed)
+            restoreMeshes();
+
+        // Only the bounds follow the parameters on the CPU. The mesh vertices stay the same, the
+        // new pose reaches cached shadows through contentRevision()
+        auto revision = m_deformerStack->revision();
+        if (revision != m_boundsRevision)
+        {
+            storeOriginalVertices();
+            updateDeformedBounds();
+            m_boundsRevision = revision;
+        }
+
+        auto program = ShaderManager::instance()->currentProgram();
+        m_deformerStack->applyGpuUniforms(program);
+        MeshNode::doDraw();
+        DeformerStack::clearGpuUniforms(program);
+        return;
+    }
+
     if (m_autoUpdate)
     {
-        applyDeformers();
+        deformMeshes();
     }
     MeshNode::doDraw();
 }
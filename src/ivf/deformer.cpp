@@ -1,10 +1,22 @@
 #include <ivf/deformer.h>
 #include <ivf/utils.h>
 
+#include <algorithm>
+#include <atomic>
+
 using namespace ivf;
 
+// Kernels work on the vertex arrays as positions
+static_assert(sizeof(glm::vec3) == 3 * sizeof(GLfloat));
+
+namespace {
+
+std::atomic<uint64_t> g_revisionCounter{0};
+
+} // namespace
+
 // Base Deformer Implementation
-Deformer::Deformer() : m_enabled(true), m_weight(1.0f)
+Deformer::Deformer() : m_enabled(true), m_weight(1.0f), m_revision(nextRevision())
 {}
 
 void Deformer::setInput(std::shared_ptr<Vertices> vertices)
@@ -19,6 +31,12 @@ void Deformer::setInput(std::shared_ptr<Vertices> vertices)
     }
 }
 
+void Deformer::setInputSlot(size_t slot, size_t slotCount)
+{
+    m_inputSlot = slot;
+    m_inputSlotCount = std::max(slotCount, slot + 1);
+}
+
 std::shared_ptr<Vertices> Deformer::getOutput()
 {
     return m_deformedVertices;
@@ -32,9 +50,41 @@ void Deformer::reset()
     }
 }
 
+bool Deformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    return false;
+}
+
+void Deformer::applyKernel([[maybe_unused]] glm::vec3 *positions, [[maybe_unused]] GLuint first,
+                          [[maybe_unused]] GLuint count) const
+{}
+
+bool Deformer::gpuDeformer([[maybe_unused]] GpuDeformer &gpu) const
+{
+    return false;
+}
+
+bool Deformer::transformBounds([[maybe_unused]] BoundingBox &bbox) const
+{
+    return false;
+}
+
+void Deformer::applyWithKernel()
+{
+    if (!m_originalVertices || !m_deformedVertices)
+        return;
+
+    GLuint count = m_originalVertices->rows();
+    std::memcpy(m_deformedVertices->data(), m_originalVertices->data(), m_originalVertices->memSize());
+
+    if (prepareKernel(count))
+        applyKernel(reinterpret_cast<glm::vec3 *>(m_deformedVertices->data()), 0, count);
+}
+
 void Deformer::setEnabled(bool enabled)
 {
     m_enabled = enabled;
+    markChanged();
 }
 
 bool Deformer::enabled() const
@@ -45,6 +95,7 @@ bool Deformer::enabled() const
 void Deformer::setWeight(float weight)
 {
     m_weight = glm::clamp(weight, 0.0f, 1.0f);
+    markChanged();
 }
 
 float Deformer::weight() const
@@ -52,8 +103,28 @@ float Deformer::weight() const
     return m_weight;
 }
 
+uint64_t Deformer::revision() const
+{
+    return m_revision;
+}
+
+uint64_t Deformer::nextRevision()
+{
+    return ++g_revisionCounter;
+}
+
+void Deformer::markChanged()
+{
+    m_revision = nextRevision();
+}
+
 void ivf::Deformer::setupProperties()
 {
     addProperty("Enabled", &m_enabled, "Deformer");
     addProperty("Weight", &m_weight, 0.0f, 1.0f, "Deformer");
 }
+
+void ivf::Deformer::onPropertyChanged([[maybe_unused]] const std::string &propertyName)
+{
+    markChanged();
+}
@@ -1,9 +1,58 @@
 #include <ivf/deformer_stack.h>
+#include <ivf/deformer_shaders.h>
+#include <ivf/thread_pool.h>
+#include <ivf/vertex_shader.h>
+#include <ivf/logger.h>
 #include <ivf/utils.h>
 
+#include <algorithm>
+
 using namespace ivf;
 
-DeformerStack::DeformerStack() {}
+namespace {
+
+// Evaluates the deformer snippet for each point and captures the positions with transform feedback
+
+const std::string compare_vert_shader_source = R"(
+layout (location = 0) in vec3 aPos;
+
+out vec3 deformedPos;
+
+void main()
+{
+    vec3 position = aPos;
+    vec3 vertexNormal = vec3(0.0);
+    deformVertex(position, vertexNormal);
+    deformedPos = position;
+}
+)";
+
+ProgramPtr compareProgram() {
+    static ProgramPtr program;
+    static bool failed = false;
+
+    if (program || failed) return program;
+
+    auto vertexShader = std::make_shared<VertexShader>();
+    vertexShader->setSource("#version 330 core\n" + ivf::deformer_vert_shader_source + compare_vert_shader_source);
+
+    program = Program::create();
+    program->setName("deformer_compare");
+    program->addShader(vertexShader);
+    program->setFeedbackVaryings({"deformedPos"});
+
+    if (!vertexShader->compile() || !program->link()) {
+        logWarning("Failed to build the deformer comparison program.", "DeformerStack");
+        program = nullptr;
+        failed = true;
+    }
+
+    return program;
+}
+
+} // namespace
+
+DeformerStack::DeformerStack() : m_revision(Deformer::nextRevision()) {}
 
 std::shared_ptr<DeformerStack> DeformerStack::create() {
     return std::make_shared<DeformerStack>();
@@ -11,28 +60,32 @@ std::shared_ptr<DeformerStack> DeformerStack::create() {
 
 void DeformerStack::addDeformer(std::shared_ptr<Deformer> deformer) {
     m_deformers.push_back(deformer);
+    m_revision = Deformer::nextRevision();
 }
 
 void DeformerStack::removeDeformer(std::shared_ptr<Deformer> deformer) {
     auto it = std::find(m_deformers.begin(), m_deformers.end(), deformer);
     if (it != m_deformers.end()) {
         m_deformers.erase(it);
+        m_revision = Deformer::nextRevision();
     }
 }
 
 void DeformerStack::removeDeformer(size_t index) {
     if (index < m_deformers.size()) {
         m_deformers.erase(m_deformers.begin() + index);
+        m_revision = Deformer::nextRevision();
     }
 }
 
 void DeformerStack::clear() {
     m_deformers.clear();
+    m_revision = Deformer::nextRevision();
 }
 
 void DeformerStack::setInput(std::shared_ptr<Vertices> vertices) {
     m_inputVertices = vertices;
-    if (vertices) {
+    if (vertices && (!m_outputVertices || m_outputVertices->rows() != vertices->rows())) {
         m_outputVertices = std::make_shared<Vertices>(vertices->rows());
     }
 }
@@ -42,11 +95,129 @@ std::shared_ptr<Vertices> DeformerStack::getOutput() {
 }
 
 void DeformerStack::apply() {
-    if (!m_inputVertices || !m_outputVertices || m_deformers.empty()) return;
-    
+    applyTo(m_outputVertices);
+}
+
+void DeformerStack::applyTo(std::shared_ptr<Vertices> target) {
+    if (!m_inputVertices || !target || m_deformers.empty()) return;
+    if (target->rows() != m_inputVertices->rows()) return;
+
+    selectInputSlot(0, 1);
+
+    if (m_fused && prepareKernels(m_inputVertices->rows())) {
+        auto source = reinterpret_cast<const glm::vec3*>(m_inputVertices->data());
+        applyFused({{source, reinterpret_cast<glm::vec3*>(target->data()), m_inputVertices->rows()}});
+    } else {
+        applySequential(*target);
+    }
+}
+
+void DeformerStack::applyTo(const std::vector<std::shared_ptr<Vertices>>& inputs,
+                            const std::vector<std::shared_ptr<Vertices>>& targets) {
+    std::vector<size_t> sets;
+    for (size_t i = 0; i < std::min(inputs.size(), targets.size()); i++) {
+        if (inputs[i] && targets[i] && inputs[i]->rows() == targets[i]->rows()) sets.push_back(i);
+    }
+    if (sets.empty()) return;
+
+    bool fusable = m_fused;
+    for (size_t k = 0; k < sets.size() && fusable; k++) {
+        selectInputSlot(k, sets.size());
+        fusable = prepareKernels(inputs[sets[k]]->rows());
+    }
+
+    if (fusable) {
+        std::vector<FusedPass> passes;
+        for (auto i : sets) {
+            passes.push_back({reinterpret_cast<const glm::vec3*>(inputs[i]->data()),
+                              reinterpret_cast<glm::vec3*>(targets[i]->data()), inputs[i]->rows()});
+        }
+        applyFused(passes);
+        return;
+    }
+
+    auto input = m_inputVertices;
+    for (size_t k = 0; k < sets.size(); k++) {
+        selectInputSlot(k, sets.size());
+        m_inputVertices = inputs[sets[k]];
+        applySequential(*targets[sets[k]]);
+    }
+    m_inputVertices = input;
+}
+
+uint64_t DeformerStack::revision() const {
+    uint64_t revision = m_revision;
+    for (auto& deformer : m_deformers) {
+        revision = std::max(revision, deformer->revision());
+    }
+    return revision;
+}
+
+bool DeformerStack::transformBounds(BoundingBox& bbox) const {
+    for (auto& deformer : m_deformers) {
+        if (!deformer->enabled()) continue;
+        if (!deformer->transformBounds(bbox)) return false;
+    }
+    return true;
+}
+
+void DeformerStack::selectInputSlot(size_t slot, size_t slotCount) {
+    for (auto& deformer : m_deformers) {
+        deformer->setInputSlot(slot, slotCount);
+    }
+}
+
+bool DeformerStack::prepareKernels(GLuint vertexCount) {
+    m_kernels.clear();
+    for (auto& deformer : m_deformers) {
+        if (!deformer->enabled()) continue;
+        if (!deformer->prepareKernel(vertexCount)) return false;
+        m_kernels.push_back(deformer.get());
+    }
+    return true;
+}
+
+void DeformerStack::applyFused(const std::vector<FusedPass>& passes) {
+    size_t blockSize = m_blockSize;
+
+    // Blocks of all passes are numbered consecutively, firstBlock[i] is the first block of pass i
+    std::vector<size_t> firstBlock(passes.size() + 1, 0);
+    for (size_t i = 0; i < passes.size(); i++) {
+        firstBlock[i + 1] = firstBlock[i] + (passes[i].count + blockSize - 1) / blockSize;
+    }
+    size_t blocks = firstBlock.back();
+
+    // Each block goes through all kernels while it is in the cache
+    auto evaluate = [&](size_t begin, size_t end) {
+        size_t pass = std::upper_bound(firstBlock.begin(), firstBlock.end(), begin) - firstBlock.begin() - 1;
+
+        for (size_t block = begin; block < end; block++) {
+            while (block >= firstBlock[pass + 1]) pass++;
+
+            auto source = passes[pass].source;
+            auto positions = passes[pass].positions;
+            size_t first = (block - firstBlock[pass]) * blockSize;
+            size_t blockCount = std::min(blockSize, passes[pass].count - first);
+
+            if (positions != source)
+                std::memcpy(positions + first, source + first, blockCount * sizeof(glm::vec3));
+
+            for (auto kernel : m_kernels)
+                kernel->applyKernel(positions + first, GLuint(first), GLuint(blockCount));
+        }
+    };
+
+    if (m_parallel && blocks > 1) {
+        ThreadPool::instance()->parallelFor(0, blocks, evaluate);
+    } else {
+        evaluate(0, blocks);
+    }
+}
+
+void DeformerStack::applySequential(Vertices& target) {
     // Start with input vertices
     auto currentVertices = m_inputVertices;
-    
+
     // Apply each deformer in sequence
     for (auto& deformer : m_deformers) {
         if (deformer->enabled()) {
@@ -55,11 +226,10 @@ void DeformerStack::apply() {
             currentVertices = deformer->getOutput();
         }
     }
-    
+
     // Copy final result to output
-    if (currentVertices) {
-        std::memcpy(m_outputVertices->data(), currentVertices->data(), 
-                   currentVertices->memSize());
+    if (currentVertices && currentVertices.get() != &target) {
+        std::memcpy(target.data(), currentVertices->data(), currentVertices->memSize());
     }
 }
 
@@ -90,4 +260,139 @@ void DeformerStack::setWeight(float weight) {
     for (auto& deformer : m_deformers) {
         deformer->setWeight(weight);
     }
-}
\ No newline at end of file
+}
+
+void DeformerStack::setFused(bool fused) {
+    m_fused = fused;
+}
+
+bool DeformerStack::fused() const {
+    return m_fused;
+}
+
+void DeformerStack::setParallel(bool parallel) {
+    m_parallel = parallel;
+}
+
+bool DeformerStack::parallel() const {
+    return m_parallel;
+}
+
+void DeformerStack::setBlockSize(size_t blockSize) {
+    m_blockSize = std::max<size_t>(blockSize, 1);
+}
+
+size_t DeformerStack::blockSize() const {
+    return m_blockSize;
+}
+
+bool DeformerStack::gpuCapable() const {
+    int count = 0;
+    GpuDeformer gpu;
+    for (auto& deformer : m_deformers) {
+        if (!deformer->enabled()) continue;
+        if (!deformer->gpuDeformer(gpu) || ++count > maxGpuDeformers) return false;
+    }
+    return count > 0;
+}
+
+bool DeformerStack::applyGpuUniforms(ProgramPtr program) const {
+    if (!program || !gpuCapable()) return false;
+
+    int types[maxGpuDeformers]{};
+    glm::vec4 params[maxGpuDeformers * 4]{};
+    int count = 0;
+
+    for (auto& deformer : m_deformers) {
+        if (!deformer->enabled()) continue;
+
+        GpuDeformer gpu;
+        deformer->gpuDeformer(gpu);
+        types[count] = int(gpu.type);
+        std::copy(std::begin(gpu.params), std::end(gpu.params), params + count * 4);
+        count++;
+    }
+
+    program->uniformIntArray("deformerTypes", count, types);
+    program->uniformVec4Array("deformerParams", count * 4, params);
+    program->uniformFloat("deformerNormalStep", m_gpuNormalStep);
+    program->uniformInt("deformerCount", count);
+    return true;
+}
+
+void DeformerStack::clearGpuUniforms(ProgramPtr program) {
+    if (program) program->uniformInt("deformerCount", 0);
+}
+
+void DeformerStack::setGpuNormalStep(float step) {
+    m_gpuNormalStep = step;
+}
+
+float DeformerStack::gpuNormalStep() const {
+    return m_gpuNormalStep;
+}
+
+float DeformerStack::compareGpu(float* meanError) {
+    if (!m_inputVertices || !gpuCapable()) return -1.0f;
+
+    auto program = compareProgram();
+    if (!program) return -1.0f;
+
+    GLuint count = m_inputVertices->rows();
+    if (count == 0) return -1.0f;
+
+    // CPU reference
+    auto expected = std::make_shared<Vertices>(count);
+    applyTo(expected);
+
+    GLint previousProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+    GLuint vao = 0;
+    GLuint buffers[2] = {0, 0};
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(2, buffers);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, m_inputVertices->memSize(), m_inputVertices->data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, buffers[1]);
+    glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, m_inputVertices->memSize(), nullptr, GL_STATIC_READ);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[1]);
+
+    program->use();
+    applyGpuUniforms(program);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, GLsizei(count));
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    std::vector<glm::vec3> result(count);
+    glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, count * sizeof(glm::vec3), result.data());
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glDeleteBuffers(2, buffers);
+    glDeleteVertexArrays(1, &vao);
+    glUseProgram(GLuint(previousProgram));
+
+    auto positions = reinterpret_cast<const glm::vec3*>(expected->data());
+    double sum = 0.0;
+    float maxError = 0.0f;
+    for (GLuint i = 0; i < count; i++) {
+        float error = glm::distance(positions[i], result[i]);
+        maxError = std::max(maxError, error);
+        sum += error;
+    }
+
+    if (meanError) *meanError = float(sum / count);
+
+    return maxError;
+}
@@ -3,12 +3,56 @@
 #include <ivf/light_manager.h>
 #include <ivf/shader_manager.h>
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <iostream>
 #include <string>
 
+#include <glm/gtc/matrix_transform.hpp>
+
 using namespace ivf;
 
+namespace {
+
+// Stable light view basis that works for any light direction
+
+void lightBasis(const glm::vec3 &lightDir, glm::vec3 &right, glm::vec3 &up)
+{
+    // Find the smallest component of the light direction
+    float absX = std::abs(lightDir.x);
+    float absY = std::abs(lightDir.y);
+    float absZ = std::abs(lightDir.z);
+
+    if (absX <= absY && absX <= absZ)
+        right = glm::normalize(glm::cross(glm::vec3(0.0f, 0.0f, 1.0f), lightDir));
+    else if (absY <= absX && absY <= absZ)
+        right = glm::normalize(glm::cross(glm::vec3(1.0f, 0.0f, 0.0f), lightDir));
+    else
+        right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), lightDir));
+
+    up = glm::normalize(glm::cross(lightDir, right));
+}
+
+bool sameBox(const BoundingBox &a, const BoundingBox &b)
+{
+    if (!a.isValid() || !b.isValid())
+        return a.isValid() == b.isValid();
+
+    return a.min() == b.min() && a.max() == b.max();
+}
+
+bool containsBox(const BoundingBox &outer, const BoundingBox &inner)
+{
+    if (!outer.isValid() || !inner.isValid())
+        return false;
+
+    return glm::all(glm::lessThanEqual(outer.min(), inner.min())) &&
+           glm::all(glm::greaterThanEqual(outer.max(), inner.max()));
+}
+
+} // namespace
+
 DirectionalLight::DirectionalLight() : m_direction(glm::vec3(0.0, 0.0, 1.0))
 {
     setLightArrayName("dirLights");
@@ -48,20 +92,7 @@ glm::mat4 ivf::DirectionalLight::calculateLightSpaceMatrix(BoundingBox &sceneBBo
 
     // Create a stable view basis that works for any light direction
     glm::vec3 right, up;
-
-    // Find the smallest component of the light direction
-    float absX = std::abs(lightDir.x);
-    float absY = std::abs(lightDir.y);
-    float absZ = std::abs(lightDir.z);
-
-    if (absX <= absY && absX <= absZ)
-        right = glm::normalize(glm::cross(glm::vec3(0.0f, 0.0f, 1.0f), lightDir));
-    else if (absY <= absX && absY <= absZ)
-        right = glm::normalize(glm::cross(glm::vec3(1.0f, 0.0f, 0.0f), lightDir));
-    else
-        right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), lightDir));
-
-    up = glm::normalize(glm::cross(lightDir, right));
+    lightBasis(lightDir, right, up);
 
     // Create view matrix
     glm::mat4 lightView = glm::lookAt(lightPos, center, up);
@@ -74,6 +105,228 @@ glm::mat4 ivf::DirectionalLight::calculateLightSpaceMatrix(BoundingBox &sceneBBo
     return lightProjection * lightView;
 }
 
+void ivf::DirectionalLight::setCascadeCount(int count)
+{
+    m_cascadeCount = std::clamp(count, 1, MAX_SHADOW_CASCADES);
+}
+
+int ivf::DirectionalLight::cascadeCount() const
+{
+    return m_cascadeCount;
+}
+
+void ivf::DirectionalLight::setShadowDistance(float distance)
+{
+    m_shadowDistance = distance;
+    this->invalidateShadowCascades();
+}
+
+float ivf::DirectionalLight::shadowDistance() const
+{
+    return m_shadowDistance;
+}
+
+void ivf::DirectionalLight::setCascadeSplitLambda(float lambda)
+{
+    m_cascadeSplitLambda = std::clamp(lambda, 0.0f, 1.0f);
+    this->invalidateShadowCascades();
+}
+
+float ivf::DirectionalLight::cascadeSplitLambda() const
+{
+    return m_cascadeSplitLambda;
+}
+
+void ivf::DirectionalLight::setCascadePadding(float padding)
+{
+    m_cascadePadding = std::max(padding, 0.0f);
+    this->invalidateShadowCascades();
+}
+
+float ivf::DirectionalLight::cascadePadding() const
+{
+    return m_cascadePadding;
+}
+
+void ivf::DirectionalLight::updateShadowCascades(const glm::mat4 &view, const glm::mat4 &projection,
+                                                 BoundingBox &sceneBBox)
+{
+    auto map = shadowMap();
+
+    if (!map)
+        return;
+
+    // Any change to the light or its shadow map invalidates the whole layout
+
+    glm::ivec2 mapSize(map->width(), map->height());
+
+    if (m_direction != m_fittedDirection || mapSize != m_fittedMapSize ||
+        map->depthTexture() != m_fittedDepthTexture || m_cascades.size() != size_t(m_cascadeCount))
+    {
+        m_cascades.assign(m_cascadeCount, ShadowCascade());
+        m_fittedDirection = m_direction;
+        m_fittedMapSize = mapSize;
+        m_fittedDepthTexture = map->depthTexture();
+        m_fittedSceneBBox.clear();
+
+        // A single map uses the whole texture, cascades use a 2x2 tile layout
+
+        for (auto i = 0; i < m_cascadeCount; i++)
+        {
+            if (m_cascadeCount == 1)
+                m_cascades[i].viewport = glm::ivec4(0, 0, mapSize.x, mapSize.y);
+            else
+                m_cascades[i].viewport =
+                    glm::ivec4((i % 2) * mapSize.x / 2, (i / 2) * mapSize.y / 2, mapSize.x / 2, mapSize.y / 2);
+        }
+    }
+
+    if (m_cascadeCount == 1)
+    {
+        auto &cascade = m_cascades[0];
+
+        if (!cascade.valid || !sameBox(sceneBBox, m_fittedSceneBBox))
+        {
+            cascade.lightSpaceMatrix = calculateLightSpaceMatrix(sceneBBox);
+            cascade.valid = true;
+            cascade.dirty = true;
+            m_fittedSceneBBox = sceneBBox;
+        }
+        return;
+    }
+
+    // The cascade depth ranges cover the scene with some margin; refit everything if it grows beyond
+
+    if (!containsBox(m_fittedSceneBBox, sceneBBox))
+    {
+        glm::vec3 margin = sceneBBox.size() * 0.1f + glm::vec3(0.01f);
+        m_fittedSceneBBox = BoundingBox(sceneBBox.min() - margin, sceneBBox.max() + margin);
+
+        for (auto &cascade : m_cascades)
+            cascade.valid = false;
+    }
+
+    // View-space frustum corners on the near and far planes
+
+    glm::mat4 invProjection = glm::inverse(projection);
+    glm::mat4 invView = glm::inverse(view);
+
+    glm::vec3 nearCorners[4];
+    glm::vec3 farCorners[4];
+
+    for (auto i = 0; i < 4; i++)
+    {
+        glm::vec2 ndc(i % 2 == 0 ? -1.0f : 1.0f, i < 2 ? -1.0f : 1.0f);
+        glm::vec4 nearCorner = invProjection * glm::vec4(ndc, -1.0f, 1.0f);
+        glm::vec4 farCorner = invProjection * glm::vec4(ndc, 1.0f, 1.0f);
+        nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+        farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+    }
+
+    float nearDist = -nearCorners[0].z;
+    float farDist = -farCorners[0].z;
+    float maxDist = std::min(farDist, m_shadowDistance);
+
+    if (maxDist <= nearDist)
+        maxDist = farDist;
+
+    glm::vec3 lightDir = glm::normalize(m_direction);
+    glm::vec3 right, up;
+    lightBasis(lightDir, right, up);
+
+    float splitNear = nearDist;
+
+    for (auto i = 0; i < m_cascadeCount; i++)
+    {
+        // Practical split scheme, blending logarithmic and uniform splits
+
+        float p = float(i + 1) / float(m_cascadeCount);
+        float logSplit = nearDist * std::pow(maxDist / std::max(nearDist, 1e-4f), p);
+        float uniformSplit = nearDist + (maxDist - nearDist) * p;
+        float splitFar = m_cascadeSplitLambda * logSplit + (1.0f - m_cascadeSplitLambda) * uniformSplit;
+
+        // Bounding sphere of the frustum slice in world space
+
+        float tNear = (splitNear - nearDist) / (farDist - nearDist);
+        float tFar = (splitFar - nearDist) / (farDist - nearDist);
+
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+
+        for (auto k = 0; k < 4; k++)
+        {
+            glm::vec3 ray = farCorners[k] - nearCorners[k];
+            corners[k] = glm::vec3(invView * glm::vec4(nearCorners[k] + ray * tNear, 1.0f));
+            corners[k + 4] = glm::vec3(invView * glm::vec4(nearCorners[k] + ray * tFar, 1.0f));
+            center += corners[k] + corners[k + 4];
+        }
+
+        center /= 8.0f;
+
+        float radius = 0.0f;
+
+        for (auto &corner : corners)
+            radius = std::max(radius, glm::length(corner - center));
+
+        auto &cascade = m_cascades[i];
+
+        // Keep the cascade while the slice stays inside the padded sphere and the
+        // padding has not become excessive (e.g. after zooming in)
+
+        float paddedRadius = radius * (1.0f + m_cascadePadding);
+
+        bool covered = cascade.valid && glm::length(center - cascade.center) + radius <= cascade.radius &&
+                       paddedRadius > cascade.radius * 0.5f;
+
+        if (!covered)
+        {
+            // Snap the center to the shadow map texel grid to avoid shimmering edges
+
+            float texelSize = 2.0f * paddedRadius / float(std::max(cascade.viewport.z, 1));
+            float cx = std::floor(glm::dot(center, right) / texelSize) * texelSize;
+            float cy = std::floor(glm::dot(center, up) / texelSize) * texelSize;
+            glm::vec3 snapped = right * cx + up * cy + lightDir * glm::dot(center, lightDir);
+
+            // Extend the depth range so that casters between the light and the slice are included
+
+            float zMin = -paddedRadius;
+            float zMax = paddedRadius;
+
+            for (auto &corner : m_fittedSceneBBox.corners())
+            {
+                float s = glm::dot(corner - snapped, lightDir);
+                zMin = std::min(zMin, s);
+                zMax = std::max(zMax, s);
+            }
+
+            glm::mat4 lightView = glm::lookAt(snapped, snapped + lightDir, up);
+            glm::mat4 lightProjection =
+                glm::ortho(-paddedRadius, paddedRadius, -paddedRadius, paddedRadius, zMin, zMax);
+
+            cascade.lightSpaceMatrix = lightProjection * lightView;
+            cascade.center = snapped;
+            cascade.radius = paddedRadius;
+            cascade.valid = true;
+            cascade.dirty = true;
+        }
+
+        cascade.splitNear = splitNear;
+        cascade.splitFar = splitFar;
+
+        splitNear = splitFar;
+    }
+}
+
+void ivf::DirectionalLight::invalidateShadowCascades()
+{
+    m_cascades.clear();
+}
+
+std::vector<ShadowCascade> &ivf::DirectionalLight::shadowCascades()
+{
+    return m_cascades;
+}
+
 void ivf::DirectionalLight::apply()
 {
     std::string prefix;
@@ -1,6 +1,7 @@
 #include <ivf/dithering_effect.h>
 
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -16,9 +17,20 @@ std::shared_ptr<DitheringEffect> ivf::DitheringEffect::create()
 
 void ivf::DitheringEffect::doLoad()
 {
-    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, ivf::dither_frag_shader_source,
+    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
+                                         EffectFusion::fragmentSource({ivf::dither_pointwise_source}),
                                          "dithering", false);
 }
 
 void ivf::DitheringEffect::doUpdateParams()
 {}
+
+bool ivf::DitheringEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ivf::DitheringEffect::pointwiseSource() const
+{
+    return ivf::dither_pointwise_source;
+}
@@ -0,0 +1,192 @@
+#include <ivf/downsample_chain.h>
+
+#include <ivf/post_shaders.h>
+#include <ivf/shader_manager.h>
+
+#include <algorithm>
+
+using namespace ivf;
+
+namespace {
+
+ProgramPtr sharedProgram(const std::string &fragSource, const std::string &name)
+{
+    auto program = ShaderManager::instance()->program(name);
+
+    if (!program)
+        program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, fragSource, name, false);
+
+    return program;
+}
+
+} // namespace
+
+DownsampleChain::DownsampleChain()
+{}
+
+DownsampleChain::~DownsampleChain()
+{
+    this->release();
+}
+
+std::shared_ptr<DownsampleChain> DownsampleChain::create()
+{
+    return std::make_shared<DownsampleChain>();
+}
+
+void DownsampleChain::load()
+{
+    m_downProgram = sharedProgram(ivf::kawase_down_frag_shader_source, "kawase_down");
+    m_upProgram = sharedProgram(ivf::kawase_up_frag_shader_source, "kawase_up");
+    m_gaussianProgram = sharedProgram(ivf::separable_gaussian_frag_shader_source, "separable_gaussian");
+}
+
+void DownsampleChain::setQuality(BlurQuality quality)
+{
+    m_quality = quality;
+}
+
+BlurQuality DownsampleChain::quality() const
+{
+    return m_quality;
+}
+
+int DownsampleChain::levelsForRadius(float radius)
+{
+    // Each level roughly doubles the kernel footprint, level 1 covers about two pixels
+
+    int levels = 1;
+
+    while (levels < 8 && float(2 << levels) <= radius * 1.5f)
+        levels++;
+
+    return levels;
+}
+
+void DownsampleChain::drawPass(RenderTargetPtr target, ProgramPtr program, GLuint sourceTexture, GLuint quadVAO)
+{
+    target->bind();
+
+    program->uniformInt("screenTexture", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sourceTexture);
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    m_passCount++;
+}
+
+void DownsampleChain::gaussian(RenderTargetPtr target, GLuint quadVAO)
+{
+    auto pool = RenderTargetPool::instance();
+    auto temp = pool->acquire(target->width(), target->height(), target->format());
+
+    m_gaussianProgram->use();
+    m_gaussianProgram->uniformVec2("direction", glm::vec2(1.0f, 0.0f));
+    this->drawPass(temp, m_gaussianProgram, target->texture(), quadVAO);
+    m_gaussianProgram->uniformVec2("direction", glm::vec2(0.0f, 1.0f));
+    this->drawPass(target, m_gaussianProgram, temp->texture(), quadVAO);
+
+    pool->release(temp);
+}
+
+GLuint DownsampleChain::render(GLuint sourceTexture, int width, int height, int levels, GLuint quadVAO, float offset,
+                               float threshold, bool accumulate)
+{
+    this->release();
+
+    if (!m_downProgram)
+        this->load();
+
+    m_passCount = 0;
+
+    // Stop before levels get smaller than two pixels
+
+    int maxLevels = 0;
+
+    for (int w = width, h = height; w >= 4 && h >= 4 && maxLevels < 8; w /= 2, h /= 2)
+        maxLevels++;
+
+    levels = std::clamp(levels, 1, std::max(maxLevels, 1));
+
+    auto pool = RenderTargetPool::instance();
+    std::vector<RenderTargetPtr> chain;
+
+    // Downsample
+
+    GLuint source = sourceTexture;
+    int w = width;
+    int h = height;
+
+    m_downProgram->use();
+    m_downProgram->uniformFloat("offset", offset);
+    m_downProgram->uniformFloat("knee", std::max(threshold * 0.5f, 1e-3f));
+
+    for (int i = 0; i < levels; i++)
+    {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+
+        auto target = pool->acquire(w, h);
+
+        m_downProgram->use();
+        m_downProgram->uniformFloat("threshold", i == 0 ? threshold : -1.0f);
+        this->drawPass(target, m_downProgram, source, quadVAO);
+
+        if ((m_quality == BlurQuality::High) || (m_quality == BlurQuality::Medium && i == levels - 1))
+            this->gaussian(target, quadVAO);
+
+        chain.push_back(target);
+        source = target->texture();
+    }
+
+    // Upsample, releasing every level as soon as it has been read
+
+    auto current = chain.back();
+
+    m_upProgram->use();
+    m_upProgram->uniformFloat("offset", offset);
+    m_upProgram->uniformFloat("baseWeight", accumulate ? 1.0f : 0.0f);
+    m_upProgram->uniformInt("baseTexture", 1);
+
+    for (int i = levels - 2; i >= 0; i--)
+    {
+        auto target = pool->acquire(chain[i]->width(), chain[i]->height());
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, chain[i]->texture());
+
+        this->drawPass(target, m_upProgram, current->texture(), quadVAO);
+
+        pool->release(current);
+        pool->release(chain[i]);
+        current = target;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+
+    m_result = current;
+    m_levelCount = levels;
+
+    return m_result->texture();
+}
+
+void DownsampleChain::release()
+{
+    if (m_result)
+    {
+        RenderTargetPool::instance()->release(m_result);
+        m_result = nullptr;
+    }
+}
+
+int DownsampleChain::passCount() const
+{
+    return m_passCount;
+}
+
+int DownsampleChain::levelCount() const
+{
+    return m_levelCount;
+}
@@ -65,7 +65,11 @@ void ivf::Effect::use()
         m_program->uniformFloat("time", m_time);
         m_program->uniformInt("width", m_width);
         m_program->uniformInt("height", m_height);
+
+        m_paramProgram = m_program;
+        m_paramPrefix.clear();
         doUpdateParams();
+        m_paramProgram = nullptr;
     }
 }
 
@@ -73,3 +77,35 @@ ProgramPtr ivf::Effect::program()
 {
     return m_program;
 }
+
+bool ivf::Effect::isPointwise() const
+{
+    return false;
+}
+
+std::string ivf::Effect::pointwiseSource() const
+{
+    return std::string();
+}
+
+void ivf::Effect::applyParams(ProgramPtr program, const std::string &prefix)
+{
+    m_paramProgram = program;
+    m_paramPrefix = prefix;
+    doUpdateParams();
+    m_paramProgram = nullptr;
+    m_paramPrefix.clear();
+}
+
+void ivf::Effect::renderPasses(GLuint sourceTexture, int width, int height, GLuint quadVAO)
+{}
+
+ProgramPtr ivf::Effect::paramProgram()
+{
+    return m_paramProgram != nullptr ? m_paramProgram : m_program;
+}
+
+std::string ivf::Effect::paramName(const std::string &name) const
+{
+    return m_paramPrefix + name;
+}
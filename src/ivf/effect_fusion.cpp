@@ -0,0 +1,126 @@
+#include <ivf/effect_fusion.h>
+
+#include <ivf/post_shaders.h>
+#include <ivf/shader_manager.h>
+#include <ivf/logger.h>
+
+#include <functional>
+
+using namespace ivf;
+
+namespace {
+
+std::string replacePrefix(const std::string &snippet, const std::string &prefix)
+{
+    std::string result;
+    result.reserve(snippet.size() + prefix.size() * 16);
+
+    for (auto c : snippet)
+    {
+        if (c == '$')
+            result += prefix;
+        else
+            result += c;
+    }
+
+    return result;
+}
+
+} // namespace
+
+EffectFusion::EffectFusion()
+{}
+
+std::shared_ptr<EffectFusion> EffectFusion::create()
+{
+    return std::make_shared<EffectFusion>();
+}
+
+std::string EffectFusion::paramPrefix(size_t index, size_t count)
+{
+    if (count < 2)
+        return std::string();
+
+    return "fx" + std::to_string(index) + "_";
+}
+
+std::string EffectFusion::fragmentSource(const std::vector<std::string> &snippets)
+{
+    std::string source = "#version 330 core\n"
+                         "out vec4 FragColor;\n"
+                         "in vec2 TexCoords;\n"
+                         "\n"
+                         "uniform sampler2D screenTexture;\n"
+                         "uniform float time;\n";
+
+    for (size_t i = 0; i < snippets.size(); i++)
+    {
+        source += "\n";
+        source += replacePrefix(snippets[i], paramPrefix(i, snippets.size()));
+        source += "\n";
+    }
+
+    source += "\nvoid main()\n{\n    vec3 col = texture(screenTexture, TexCoords).rgb;\n";
+
+    for (size_t i = 0; i < snippets.size(); i++)
+        source += "    col = " + paramPrefix(i, snippets.size()) + "apply(col, TexCoords);\n";
+
+    source += "    FragColor = vec4(col, 1.0);\n}\n";
+
+    return source;
+}
+
+ProgramPtr EffectFusion::program(const std::vector<EffectPtr> &chain)
+{
+    std::vector<std::string> snippets;
+    snippets.reserve(chain.size());
+
+    std::string signature;
+
+    for (auto &effect : chain)
+    {
+        snippets.push_back(effect->pointwiseSource());
+        signature += snippets.back();
+        signature += '\x1f';
+    }
+
+    auto it = m_programs.find(signature);
+
+    if (it != m_programs.end())
+        return it->second;
+
+    auto name = "fused_" + std::to_string(std::hash<std::string>{}(signature));
+    auto program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
+                                            EffectFusion::fragmentSource(snippets), name, false);
+    m_compileCount++;
+
+    // Failed programs are cached as well so a broken combination is not recompiled every frame
+
+    if (smCompileLinkErrors())
+    {
+        logWarning("Failed to compile fused program for " + std::to_string(chain.size()) + " effects.",
+                   "EffectFusion");
+        program = nullptr;
+    }
+    else
+        logInfofc("EffectFusion", "Compiled fused program {} ({} effects).", name, chain.size());
+
+    m_programs[signature] = program;
+
+    return program;
+}
+
+void EffectFusion::clear()
+{
+    m_programs.clear();
+}
+
+size_t EffectFusion::cachedPrograms() const
+{
+    return m_programs.size();
+}
+
+int EffectFusion::compileCount() const
+{
+    return m_compileCount;
+}
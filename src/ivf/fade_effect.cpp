@@ -1,6 +1,7 @@
 #include <ivf/fade_effect.h>
 
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -36,14 +37,14 @@ float ivf::FadeEffect::fadeAmount() const
 
 void ivf::FadeEffect::doLoad()
 {
-    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, ivf::fade_frag_shader_source,
-                                         "fade", false);
+    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
+                                         EffectFusion::fragmentSource({ivf::fade_pointwise_source}), "fade", false);
 }
 
 void ivf::FadeEffect::doUpdateParams()
 {
-    m_program->uniformVec3("fadeColor", m_fadeColor);
-    m_program->uniformFloat("fadeAmount", m_fadeAmount);
+    paramProgram()->uniformVec3(paramName("fadeColor"), m_fadeColor);
+    paramProgram()->uniformFloat(paramName("fadeAmount"), m_fadeAmount);
 }
 
 void ivf::FadeEffect::setupProperties()
@@ -51,3 +52,13 @@ void ivf::FadeEffect::setupProperties()
     addProperty("Fade color", &m_fadeColor, "Fade");
     addProperty("Fade amount", &m_fadeAmount, "Fade");
 }
+
+bool ivf::FadeEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ivf::FadeEffect::pointwiseSource() const
+{
+    return ivf::fade_pointwise_source;
+}
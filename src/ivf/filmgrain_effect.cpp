@@ -1,6 +1,7 @@
 #include <ivf/filmgrain_effect.h>
 
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -37,13 +38,14 @@ float ivf::FilmgrainEffect::grainBlending() const
 void ivf::FilmgrainEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::filmgrain_frag_shader_source, "filmgrain", false);
+                                         EffectFusion::fragmentSource({ivf::filmgrain_pointwise_source}),
+                                         "filmgrain", false);
 }
 
 void ivf::FilmgrainEffect::doUpdateParams()
 {
-    m_program->uniformFloat("noiseIntensity", m_noiseIntensity);
-    m_program->uniformFloat("grainBlending", m_grainBlending);
+    paramProgram()->uniformFloat(paramName("noiseIntensity"), m_noiseIntensity);
+    paramProgram()->uniformFloat(paramName("grainBlending"), m_grainBlending);
 }
 
 void ivf::FilmgrainEffect::setupProperties()
@@ -51,3 +53,13 @@ void ivf::FilmgrainEffect::setupProperties()
     addProperty("noiseIntensity", &m_noiseIntensity, "Film Grain");
     addProperty("grainBlending", &m_grainBlending, "Film Grain");
 }
+
+bool ivf::FilmgrainEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ivf::FilmgrainEffect::pointwiseSource() const
+{
+    return ivf::filmgrain_pointwise_source;
+}
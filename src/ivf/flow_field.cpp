@@ -1,5 +1,6 @@
 #include <ivf/flow_field.h>
 #include <ivf/math_utils.h>
+#include <ivf/thread_pool.h>
 #include <algorithm>
 #include <cmath>
 
@@ -10,13 +11,19 @@ std::shared_ptr<FlowField> FlowField::create()
     return std::make_shared<FlowField>();
 }
 
-glm::vec3 FlowField::sampleVelocity(glm::vec3 pos) const
+FlowField::~FlowField()
+{
+    if (m_texture)
+        glDeleteTextures(1, &m_texture);
+}
+
+glm::vec3 FlowField::evaluate(glm::vec3 pos, float time) const
 {
     // Transform to noise domain
     float px = (pos.x + m_offset.x) * m_scale;
     float py = (pos.y + m_offset.y) * m_scale;
     float pz = (pos.z + m_offset.z) * m_scale;
-    float t  = m_time * m_timeScale;
+    float t  = time * m_timeScale;
 
     // Accumulate fBm-layered curl noise
     glm::vec3 result(0.0f);
@@ -37,6 +44,11 @@ glm::vec3 FlowField::sampleVelocity(glm::vec3 pos) const
     return result * m_strength;
 }
 
+glm::vec3 FlowField::sampleVelocity(glm::vec3 pos) const
+{
+    return evaluate(pos, m_time);
+}
+
 glm::vec2 FlowField::sampleVelocity2D(float x, float z) const
 {
     float px = (x + m_offset.x) * m_scale;
@@ -61,19 +73,195 @@ glm::vec2 FlowField::sampleVelocity2D(float x, float z) const
     return result * m_strength;
 }
 
-void FlowField::applyToParticleSystem(std::shared_ptr<ParticleSystem> ps, float blendRate)
+// ---- Baked mode ------------------------------------------------------------
+
+void FlowField::setTime(float t)
 {
-    auto weakField = std::weak_ptr<FlowField>(shared_from_this());
+    m_time = t;
 
-    ps->setUpdateFunction([weakField, blendRate](ParticleSystem::Particle &p, float dt) {
-        auto field = weakField.lock();
-        if (!field) {
-            p.position += p.velocity * dt;
-            return;
-        }
-        glm::vec3 flowVel = field->sampleVelocity(p.position);
-        float rate = std::min(1.0f, blendRate * dt);
-        p.velocity = glm::mix(p.velocity, flowVel, rate);
-        p.position += p.velocity * dt;  // custom updateFn replaces the else-branch in ParticleSystem::update
+    if (m_baked)
+        updateBake();
+}
+
+void FlowField::bakeLayers(std::vector<glm::vec3>& slice, float time, int zBegin, int zEnd) const
+{
+    glm::vec3 step = (m_bakeMax - m_bakeMin) / glm::vec3(m_bakeRes - 1);
+
+    ThreadPool::instance()->parallelFor(size_t(zBegin), size_t(zEnd), [&](size_t begin, size_t end) {
+        for (size_t z = begin; z < end; ++z)
+            for (int y = 0; y < m_bakeRes.y; ++y) {
+                size_t row = (z * m_bakeRes.y + y) * m_bakeRes.x;
+                for (int x = 0; x < m_bakeRes.x; ++x)
+                    slice[row + x] = evaluate(m_bakeMin + step * glm::vec3(x, y, float(z)), time);
+            }
     });
 }
+
+void FlowField::bake()
+{
+    size_t count = size_t(m_bakeRes.x) * m_bakeRes.y * m_bakeRes.z;
+
+    for (auto& slice : m_slices)
+        slice.assign(count, glm::vec3(0.0f));
+
+    m_sliceTime = m_time;
+    bakeLayers(m_slices[0], m_sliceTime, 0, m_bakeRes.z);
+    bakeLayers(m_slices[1], m_sliceTime + m_bakeInterval, 0, m_bakeRes.z);
+    m_pendingLayers = 0;
+    m_bakeDirty = false;
+}
+
+void FlowField::updateBake()
+{
+    // Large jumps (or time running backwards) start over from the current time
+    if (m_bakeDirty || m_time < m_sliceTime || m_time >= m_sliceTime + 2.0f * m_bakeInterval) {
+        bake();
+        return;
+    }
+
+    // Crossed into the next interval: finish the pending slice and rotate
+    if (m_time >= m_sliceTime + m_bakeInterval) {
+        bakeLayers(m_slices[2], m_sliceTime + 2.0f * m_bakeInterval, m_pendingLayers, m_bakeRes.z);
+        std::swap(m_slices[0], m_slices[1]);
+        std::swap(m_slices[1], m_slices[2]);
+        m_sliceTime += m_bakeInterval;
+        m_pendingLayers = 0;
+    }
+
+    // Spread the pending slice over the interval, staying a layer ahead of the clock
+    float frac = (m_time - m_sliceTime) / m_bakeInterval;
+    int target = std::min(m_bakeRes.z, int(std::ceil(frac * m_bakeRes.z)) + 1);
+
+    if (target > m_pendingLayers) {
+        bakeLayers(m_slices[2], m_sliceTime + 2.0f * m_bakeInterval, m_pendingLayers, target);
+        m_pendingLayers = target;
+    }
+}
+
+glm::vec3 FlowField::sampleBaked(glm::vec3 pos, float frac) const
+{
+    glm::vec3 g = (pos - m_bakeMin) / (m_bakeMax - m_bakeMin) * glm::vec3(m_bakeRes - 1);
+
+    int x0 = std::min(int(g.x), m_bakeRes.x - 2);
+    int y0 = std::min(int(g.y), m_bakeRes.y - 2);
+    int z0 = std::min(int(g.z), m_bakeRes.z - 2);
+    float fx = g.x - x0, fy = g.y - y0, fz = g.z - z0;
+
+    size_t sx = 1, sy = size_t(m_bakeRes.x), sz = size_t(m_bakeRes.x) * m_bakeRes.y;
+    size_t i000 = size_t(z0) * sz + size_t(y0) * sy + size_t(x0);
+
+    // Trilinear in both time slices, then linear in time
+    auto trilinear = [&](const std::vector<glm::vec3>& v) {
+        glm::vec3 c00 = glm::mix(v[i000], v[i000 + sx], fx);
+        glm::vec3 c10 = glm::mix(v[i000 + sy], v[i000 + sy + sx], fx);
+        glm::vec3 c01 = glm::mix(v[i000 + sz], v[i000 + sz + sx], fx);
+        glm::vec3 c11 = glm::mix(v[i000 + sz + sy], v[i000 + sz + sy + sx], fx);
+        return glm::mix(glm::mix(c00, c10, fy), glm::mix(c01, c11, fy), fz);
+    };
+
+    return glm::mix(trilinear(m_slices[0]), trilinear(m_slices[1]), frac);
+}
+
+void FlowField::sampleVelocities(std::span<const glm::vec3> positions, std::span<glm::vec3> velocities) const
+{
+    size_t n = std::min(positions.size(), velocities.size());
+
+    if (!m_baked || m_bakeDirty || m_slices[0].empty()) {
+        for (size_t i = 0; i < n; ++i)
+            velocities[i] = evaluate(positions[i], m_time);
+        return;
+    }
+
+    float frac = glm::clamp((m_time - m_sliceTime) / m_bakeInterval, 0.0f, 1.0f);
+
+    for (size_t i = 0; i < n; ++i) {
+        const glm::vec3& p = positions[i];
+        bool inside = p.x >= m_bakeMin.x && p.y >= m_bakeMin.y && p.z >= m_bakeMin.z &&
+                      p.x <= m_bakeMax.x && p.y <= m_bakeMax.y && p.z <= m_bakeMax.z;
+        velocities[i] = inside ? sampleBaked(p, frac) : evaluate(p, m_time);
+    }
+}
+
+void FlowField::updateTexture()
+{
+    if (!m_baked || m_bakeDirty || m_slices[0].empty())
+        return;
+
+    float frac = glm::clamp((m_time - m_sliceTime) / m_bakeInterval, 0.0f, 1.0f);
+
+    std::vector<glm::vec3> field(m_slices[0].size());
+    for (size_t i = 0; i < field.size(); ++i)
+        field[i] = glm::mix(m_slices[0][i], m_slices[1][i], frac);
+
+    bool create = m_texture == 0;
+    if (create)
+        glGenTextures(1, &m_texture);
+
+    glBindTexture(GL_TEXTURE_3D, m_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    GLint width = 0, height = 0, depth = 0;
+    if (!create) {
+        glGetTexLevelParameteriv(GL_TEXTURE_3D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_3D, 0, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(GL_TEXTURE_3D, 0, GL_TEXTURE_DEPTH, &depth);
+    }
+
+    if (glm::ivec3(width, height, depth) != m_bakeRes) {
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB16F, m_bakeRes.x, m_bakeRes.y, m_bakeRes.z, 0, GL_RGB, GL_FLOAT,
+                     field.data());
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    } else {
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, m_bakeRes.x, m_bakeRes.y, m_bakeRes.z, GL_RGB, GL_FLOAT,
+                        field.data());
+    }
+
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+// ---- Particle system integration --------------------------------------------
+
+std::shared_ptr<FlowFieldForce> FlowField::applyToParticleSystem(std::shared_ptr<ParticleSystem> ps, float blendRate)
+{
+    auto force = FlowFieldForce::create(shared_from_this(), blendRate);
+    ps->addForce(force);
+    return force;
+}
+
+std::shared_ptr<FlowFieldForce> FlowFieldForce::create(std::shared_ptr<const FlowField> field, float blendRate)
+{
+    return std::make_shared<FlowFieldForce>(field, blendRate);
+}
+
+void FlowFieldForce::apply(const ParticleBatch &b, float dt) const
+{
+    auto field = m_field.lock();
+    if (!field)
+        return;
+
+    float rate = std::min(1.0f, m_blendRate * dt);
+
+    // Sample in sub-blocks through the batch interface (baked grid when enabled)
+    constexpr size_t k_chunk = 64;
+    glm::vec3 positions[k_chunk];
+    glm::vec3 flow[k_chunk];
+
+    for (size_t begin = 0; begin < b.size(); begin += k_chunk) {
+        size_t n = std::min(k_chunk, b.size() - begin);
+
+        for (size_t i = 0; i < n; ++i)
+            positions[i] = glm::vec3(b.posX[begin + i], b.posY[begin + i], b.posZ[begin + i]);
+
+        field->sampleVelocities({positions, n}, {flow, n});
+
+        for (size_t i = 0; i < n; ++i) {
+            b.velX[begin + i] += (flow[i].x - b.velX[begin + i]) * rate;
+            b.velY[begin + i] += (flow[i].y - b.velY[begin + i]) * rate;
+            b.velZ[begin + i] += (flow[i].z - b.velZ[begin + i]) * rate;
+        }
+    }
+}
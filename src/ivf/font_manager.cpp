@@ -28,6 +28,8 @@ FontManager::FontManager()
 
 ivf::FontManager::~FontManager()
 {
+    m_atlases.clear();
+
     if (m_freetype != nullptr)
         FT_Done_FreeType(m_freetype);
 }
@@ -50,6 +52,7 @@ void ivf::FontManager::loadFace(const std::string filename, const std::string na
         }
         else
         {
+            this->dropAtlases(it->second);
             FT_Done_Face(it->second);
             it->second = face;
             m_currentFace = face;
@@ -72,4 +75,58 @@ FT_Face ivf::FontManager::face(const std::string name)
         return nullptr;
 }
 
+GlyphAtlasPtr ivf::FontManager::atlas(int pixelSize, bool sdf)
+{
+    return this->faceAtlas(m_currentFace, pixelSize, sdf);
+}
+
+GlyphAtlasPtr ivf::FontManager::atlas(const std::string name, int pixelSize, bool sdf)
+{
+    return this->faceAtlas(this->face(name), pixelSize, sdf);
+}
 
+GlyphAtlasPtr ivf::FontManager::faceAtlas(FT_Face face, int pixelSize, bool sdf)
+{
+    if (face == nullptr)
+        return nullptr;
+
+    auto key = std::make_tuple(face, pixelSize, sdf);
+    auto it = m_atlases.find(key);
+
+    if (it != m_atlases.end())
+        return it->second;
+
+    auto glyphAtlas = GlyphAtlas::create(face, pixelSize, sdf);
+    m_atlases[key] = glyphAtlas;
+
+    return glyphAtlas;
+}
+
+void ivf::FontManager::dropAtlases(FT_Face face)
+{
+    for (auto it = m_atlases.begin(); it != m_atlases.end();)
+    {
+        if (std::get<0>(it->first) == face)
+            it = m_atlases.erase(it);
+        else
+            ++it;
+    }
+
+    m_atlasRevision++;
+}
+
+void ivf::FontManager::clearAtlases()
+{
+    m_atlases.clear();
+    m_atlasRevision++;
+}
+
+unsigned int ivf::FontManager::atlasRevision() const
+{
+    return m_atlasRevision;
+}
+
+size_t ivf::FontManager::atlasCount() const
+{
+    return m_atlases.size();
+}
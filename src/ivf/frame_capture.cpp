@@ -0,0 +1,631 @@
+#include <ivf/frame_capture.h>
+
+#include <ivf/logger.h>
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace ivf;
+
+namespace {
+
+void appendBytes(void *context, void *data, int size)
+{
+    auto buffer = static_cast<std::vector<unsigned char> *>(context);
+    auto bytes = static_cast<unsigned char *>(data);
+    buffer->insert(buffer->end(), bytes, bytes + size);
+}
+
+void writeFile(const std::string &filename, const std::vector<unsigned char> &data)
+{
+    std::ofstream file(filename, std::ios::binary);
+
+    if (!file)
+    {
+        logErrorfc("FrameCapture", "Could not write {}", filename);
+        return;
+    }
+
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+void putBigEndian(std::vector<unsigned char> &out, uint32_t value)
+{
+    out.push_back((value >> 24) & 0xff);
+    out.push_back((value >> 16) & 0xff);
+    out.push_back((value >> 8) & 0xff);
+    out.push_back(value & 0xff);
+}
+
+} // namespace
+
+FrameCapture::FrameCapture()
+{}
+
+FrameCapture::~FrameCapture()
+{
+    this->stop();
+}
+
+std::shared_ptr<FrameCapture> FrameCapture::create()
+{
+    return std::make_shared<FrameCapture>();
+}
+
+bool FrameCapture::start(const std::string &path, CaptureFormat format)
+{
+    this->stop();
+
+    m_path = path;
+    m_format = format;
+
+    if (m_format == CaptureFormat::Raw)
+    {
+        if (!m_path.empty() && m_path[0] == '|')
+        {
+            m_rawFile = popen(m_path.substr(1).c_str(), "w");
+            m_rawPipe = true;
+        }
+        else
+        {
+            m_rawFile = std::fopen(m_path.c_str(), "wb");
+            m_rawPipe = false;
+        }
+
+        if (!m_rawFile)
+        {
+            logErrorfc("FrameCapture", "Could not open raw output {}", m_path);
+            return false;
+        }
+    }
+
+    m_slots.resize(std::max(2, m_ringSize));
+
+    for (auto &slot : m_slots)
+        glGenBuffers(1, &slot.pbo);
+
+    m_next = 0;
+    m_oldest = 0;
+    m_nextIndex = 0;
+    m_capturedFrames = 0;
+    m_droppedFrames = 0;
+    m_writtenFrames = 0;
+    m_peakQueueDepth = 0;
+    m_stopping = false;
+
+    // Raw frames share one stream and must stay in order
+
+    int workers = m_workerCount;
+
+    if (workers <= 0)
+        workers = std::clamp(int(std::thread::hardware_concurrency()) / 2, 1, 4);
+
+    if (m_format == CaptureFormat::Raw)
+        workers = 1;
+
+    for (auto i = 0; i < workers; i++)
+        m_workers.emplace_back(&FrameCapture::workerLoop, this);
+
+    m_active = true;
+
+    logInfofc("FrameCapture", "Recording to {} ({} PBOs, {} encoder threads)", m_path, m_slots.size(), workers);
+
+    return true;
+}
+
+void FrameCapture::stop()
+{
+    if (!m_active)
+        return;
+
+    // Read back everything still in flight, then let the encoders drain the queue
+
+    this->collect(true);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+
+    m_workers.clear();
+
+    for (auto &slot : m_slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+
+        glDeleteBuffers(1, &slot.pbo);
+    }
+
+    m_slots.clear();
+
+    if (m_rawFile)
+    {
+        if (m_rawPipe)
+            pclose(m_rawFile);
+        else
+            std::fclose(m_rawFile);
+
+        m_rawFile = nullptr;
+    }
+
+    m_active = false;
+
+    logInfofc("FrameCapture", "Recording stopped: {} frames written, {} dropped, peak queue depth {}",
+              m_writtenFrames, m_droppedFrames, m_peakQueueDepth);
+}
+
+bool FrameCapture::isActive() const
+{
+    return m_active;
+}
+
+void FrameCapture::capture(int width, int height, int copies)
+{
+    if (!m_active || width <= 0 || height <= 0 || copies <= 0)
+        return;
+
+    this->collect(false);
+
+    // The ring is full when the next slot is still waiting for the GPU
+
+    if (m_slots[m_next].fence)
+    {
+        if (m_allowDrops)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_droppedFrames += copies;
+            return;
+        }
+
+        this->collect(true);
+    }
+
+    auto &slot = m_slots[m_next];
+    size_t size = size_t(width) * height * 3;
+
+    GLint packAlignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+    if (slot.capacity < size)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = width;
+    slot.height = height;
+    slot.copies = copies;
+
+    m_next = (m_next + 1) % m_slots.size();
+}
+
+void FrameCapture::collect(bool wait)
+{
+    // Slots complete in the order they were issued, stop at the first one still in flight
+
+    while (m_slots.size() > 0 && m_slots[m_oldest].fence)
+    {
+        auto &slot = m_slots[m_oldest];
+
+        GLuint64 timeout = wait ? 1000000000 : 0;
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+        while (wait && status == GL_TIMEOUT_EXPIRED)
+            status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+        if (status == GL_TIMEOUT_EXPIRED)
+            return;
+
+        if (status != GL_WAIT_FAILED)
+            this->enqueue(slot);
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        m_oldest = (m_oldest + 1) % m_slots.size();
+    }
+}
+
+void FrameCapture::enqueue(Slot &slot)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_queue.size() >= m_maxQueueDepth)
+        {
+            if (m_allowDrops)
+            {
+                m_droppedFrames += slot.copies;
+                return;
+            }
+
+            m_drained.wait(lock, [this] { return m_queue.size() < m_maxQueueDepth; });
+        }
+    }
+
+    Job job;
+    job.width = slot.width;
+    job.height = slot.height;
+    job.copies = slot.copies;
+    job.pixels.resize(size_t(slot.width) * slot.height * 3);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+    if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, job.pixels.size(), GL_MAP_READ_BIT))
+    {
+        std::memcpy(job.pixels.data(), data, job.pixels.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        job.index = m_nextIndex;
+        m_nextIndex += job.copies;
+        m_capturedFrames += job.copies;
+
+        m_queue.push_back(std::move(job));
+        m_peakQueueDepth = std::max(m_peakQueueDepth, m_queue.size());
+    }
+
+    m_condition.notify_one();
+}
+
+void FrameCapture::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty())
+                return;
+
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        m_drained.notify_all();
+
+        this->write(job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writtenFrames += job.copies;
+        }
+    }
+}
+
+void FrameCapture::write(Job &job)
+{
+    // OpenGL rows are bottom-up, all output formats are top-down
+
+    size_t rowSize = size_t(job.width) * 3;
+    std::vector<unsigned char> pixels(job.pixels.size());
+
+    for (auto y = 0; y < job.height; y++)
+        std::memcpy(&pixels[y * rowSize], &job.pixels[(job.height - 1 - y) * rowSize], rowSize);
+
+    if (m_format == CaptureFormat::Raw)
+    {
+        for (auto i = 0; i < job.copies; i++)
+            std::fwrite(pixels.data(), 1, pixels.size(), m_rawFile);
+
+        std::fflush(m_rawFile);
+        return;
+    }
+
+    std::vector<unsigned char> encoded;
+    const char *extension;
+
+    if (m_format == CaptureFormat::QOI)
+    {
+        encoded = encodeQOI(pixels.data(), job.width, job.height);
+        extension = "qoi";
+
+        if (m_verifyQOI)
+        {
+            std::vector<unsigned char> decoded;
+            int width, height;
+            if (!decodeQOI(encoded, decoded, width, height) || decoded != pixels)
+                logErrorfc("FrameCapture", "QOI round trip of frame {} does not match the captured pixels", job.index);
+        }
+    }
+    else
+    {
+        stbi_write_png_to_func(appendBytes, &encoded, job.width, job.height, 3, pixels.data(), int(rowSize));
+        extension = "png";
+    }
+
+    for (auto i = 0; i < job.copies; i++)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/frame_%06d.%s", job.index + i, extension);
+        writeFile(m_path + name, encoded);
+    }
+}
+
+std::vector<unsigned char> FrameCapture::encodeQOI(const unsigned char *pixels, int width, int height)
+{
+    std::vector<unsigned char> out;
+    out.reserve(14 + size_t(width) * height * 2 + 8);
+
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    putBigEndian(out, uint32_t(width));
+    putBigEndian(out, uint32_t(height));
+    out.push_back(3); // RGB
+    out.push_back(0); // sRGB with linear alpha
+
+    // Index entries are RGBA and start as {0, 0, 0, 0}, like in the decoder
+    unsigned char index[64][4] = {};
+    unsigned char prev[3] = {0, 0, 0};
+    int run = 0;
+    size_t count = size_t(width) * height;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *px = &pixels[i * 3];
+
+        if (px[0] == prev[0] && px[1] == prev[1] && px[2] == prev[2])
+        {
+            run++;
+
+            if (run == 62 || i == count - 1)
+            {
+                out.push_back(0xc0 | (run - 1)); // QOI_OP_RUN
+                run = 0;
+            }
+
+            continue;
+        }
+
+        if (run > 0)
+        {
+            out.push_back(0xc0 | (run - 1));
+            run = 0;
+        }
+
+        // Pixels are opaque: hash = (r * 3 + g * 5 + b * 7 + a * 11) % 64 with a = 255
+
+        int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + 255 * 11) % 64;
+
+        if (index[hash][0] == px[0] && index[hash][1] == px[1] && index[hash][2] == px[2] && index[hash][3] == 255)
+        {
+            out.push_back(hash); // QOI_OP_INDEX
+        }
+        else
+        {
+            std::memcpy(index[hash], px, 3);
+            index[hash][3] = 255;
+
+            int dr = int(px[0]) - prev[0];
+            int dg = int(px[1]) - prev[1];
+            int db = int(px[2]) - prev[2];
+
+            // Differences wrap around, bring them back to [-128, 127]
+
+            dr = (dr + 384) % 256 - 128;
+            dg = (dg + 384) % 256 - 128;
+            db = (db + 384) % 256 - 128;
+
+            int drdg = dr - dg;
+            int dbdg = db - dg;
+
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+            {
+                out.push_back(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)); // QOI_OP_DIFF
+            }
+            else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+            {
+                out.push_back(0x80 | (dg + 32)); // QOI_OP_LUMA
+                out.push_back(((drdg + 8) << 4) | (dbdg + 8));
+            }
+            else
+            {
+                out.push_back(0xfe); // QOI_OP_RGB
+                out.insert(out.end(), px, px + 3);
+            }
+        }
+
+        std::memcpy(prev, px, 3);
+    }
+
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+
+    return out;
+}
+
+bool FrameCapture::decodeQOI(const std::vector<unsigned char> &data, std::vector<unsigned char> &pixels, int &width,
+                             int &height)
+{
+    auto getBigEndian = [&](size_t pos) {
+        return (uint32_t(data[pos]) << 24) | (uint32_t(data[pos + 1]) << 16) | (uint32_t(data[pos + 2]) << 8) |
+               uint32_t(data[pos + 3]);
+    };
+
+    if (data.size() < 14 + 8 || std::memcmp(data.data(), "qoif", 4) != 0)
+        return false;
+
+    width = int(getBigEndian(4));
+    height = int(getBigEndian(8));
+    int channels = data[12];
+    size_t count = size_t(width) * height;
+
+    if (width <= 0 || height <= 0 || (channels != 3 && channels != 4))
+        return false;
+
+    pixels.resize(count * 3);
+
+    unsigned char index[64][4] = {};
+    unsigned char px[4] = {0, 0, 0, 255};
+    size_t pos = 14;
+    size_t end = data.size() - 8;
+    int run = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (run > 0)
+        {
+            run--;
+        }
+        else
+        {
+            if (pos >= end)
+                return false;
+
+            unsigned char op = data[pos++];
+
+            if (op == 0xfe) // QOI_OP_RGB
+            {
+                if (pos + 3 > end)
+                    return false;
+                std::memcpy(px, &data[pos], 3);
+                pos += 3;
+            }
+            else if (op == 0xff) // QOI_OP_RGBA
+            {
+                if (pos + 4 > end)
+                    return false;
+                std::memcpy(px, &data[pos], 4);
+                pos += 4;
+            }
+            else if ((op & 0xc0) == 0x00) // QOI_OP_INDEX
+            {
+                std::memcpy(px, index[op], 4);
+            }
+            else if ((op & 0xc0) == 0x40) // QOI_OP_DIFF
+            {
+                px[0] += ((op >> 4) & 0x03) - 2;
+                px[1] += ((op >> 2) & 0x03) - 2;
+                px[2] += (op & 0x03) - 2;
+            }
+            else if ((op & 0xc0) == 0x80) // QOI_OP_LUMA
+            {
+                if (pos + 1 > end)
+                    return false;
+                int dg = (op & 0x3f) - 32;
+                int b2 = data[pos++];
+                px[0] += dg - 8 + ((b2 >> 4) & 0x0f);
+                px[1] += dg;
+                px[2] += dg - 8 + (b2 & 0x0f);
+            }
+            else // QOI_OP_RUN
+            {
+                run = op & 0x3f;
+            }
+
+            std::memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+
+        std::memcpy(&pixels[i * 3], px, 3);
+    }
+
+    return true;
+}
+
+void FrameCapture::setRingSize(int size)
+{
+    m_ringSize = std::max(2, size);
+}
+
+int FrameCapture::ringSize() const
+{
+    return m_ringSize;
+}
+
+void FrameCapture::setWorkerCount(int count)
+{
+    m_workerCount = count;
+}
+
+int FrameCapture::workerCount() const
+{
+    return m_workerCount;
+}
+
+void FrameCapture::setMaxQueueDepth(size_t depth)
+{
+    m_maxQueueDepth = std::max(size_t(1), depth);
+}
+
+size_t FrameCapture::maxQueueDepth() const
+{
+    return m_maxQueueDepth;
+}
+
+void FrameCapture::setAllowDrops(bool flag)
+{
+    m_allowDrops = flag;
+}
+
+bool FrameCapture::allowDrops() const
+{
+    return m_allowDrops;
+}
+
+void FrameCapture::setVerifyQOI(bool flag)
+{
+    m_verifyQOI = flag;
+}
+
+bool FrameCapture::verifyQOI() const
+{
+    return m_verifyQOI;
+}
+
+size_t FrameCapture::queueDepth()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+size_t FrameCapture::peakQueueDepth()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_peakQueueDepth;
+}
+
+size_t FrameCapture::capturedFrames()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capturedFrames;
+}
+
+size_t FrameCapture::droppedFrames()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_droppedFrames;
+}
+
+size_t FrameCapture::writtenFrames()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writtenFrames;
+}
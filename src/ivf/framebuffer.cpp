@@ -2,15 +2,14 @@
 
 #include <ivf/texture.h>
 #include <ivf/logger.h>
+#include <ivf/render_target_pool.h>
 
 #include <iostream>
 
 using namespace ivf;
 
 FrameBuffer::FrameBuffer(int width, int height)
-    : m_width(width), m_height(height), m_multisample(false), m_samples(4), m_quadVAO(0), m_quadVBO(0),
-      m_multisampledFrameBuffer(0), m_multisampledDepthBuffer(0), m_multisampledColorTexture(0), m_frameBuffer(0),
-      m_depthBuffer(0), m_colorTexture(0)
+    : m_width(width), m_height(height), m_multisample(false), m_samples(4), m_quadVAO(0), m_quadVBO(0)
 {}
 
 FrameBuffer::~FrameBuffer()
@@ -42,119 +41,75 @@ std::shared_ptr<FrameBuffer> FrameBuffer::create(int width, int height)
     return std::make_shared<FrameBuffer>(width, height);
 }
 
-void FrameBuffer::attachColorTexture(GLuint &texture)
-{
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_width, m_height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
-}
-
-void FrameBuffer::attachDepthBuffer(GLuint &buffer)
-{
-    glGenRenderbuffers(1, &buffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, buffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, m_width, m_height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, buffer);
-}
-
-void ivf::FrameBuffer::attachMultisampledColorTexture()
+void ivf::FrameBuffer::initialize()
 {
-    // Multisampled color buffer
-    glGenTextures(1, &m_multisampledColorTexture);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_multisampledColorTexture);
-    glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, m_samples, GL_RGBA16F, m_width, m_height, GL_TRUE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, m_multisampledColorTexture,
-                           0);
+    this->drop();
+    this->initQuad();
+    this->updateTargets();
+    this->unbind();
 }
 
-void ivf::FrameBuffer::attachMultisampledDepthBuffer()
+void ivf::FrameBuffer::updateTargets()
 {
-    // Multisampled depth buffer
-    glGenRenderbuffers(1, &m_multisampledDepthBuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_multisampledDepthBuffer);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_DEPTH_COMPONENT, m_width, m_height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_multisampledDepthBuffer);
-}
+    auto pool = RenderTargetPool::instance();
 
-void ivf::FrameBuffer::initialize()
-{
-    this->drop();
-    this->initQuad();
+    RenderTargetDesc desc;
+    desc.width = m_width;
+    desc.height = m_height;
+    desc.colorFormat = GL_RGBA16F;
 
     if (m_multisample)
     {
-        glGenFramebuffers(1, &m_multisampledFrameBuffer);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_multisampledFrameBuffer);
-
-        this->attachMultisampledColorTexture();
-        this->attachMultisampledDepthBuffer();
-
-        glGenFramebuffers(1, &m_frameBuffer);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
-
-        this->attachColorTexture(m_colorTexture);
-        this->attachDepthBuffer(m_depthBuffer);
-
-        /*
-        glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
-        glGenTextures(1, &m_currentColorTexture);
-        glBindTexture(GL_TEXTURE_2D, m_currentColorTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_width, m_height, 0, GL_RGBA, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_currentColorTexture, 0);
-        */
+        // Render into the multisampled target, resolve into a color-only target
+
+        auto msDesc = desc;
+        msDesc.depthFormat = GL_DEPTH_COMPONENT24;
+        msDesc.samples = m_samples;
+
+        pool->reacquire(m_multisampledTarget, msDesc);
+        pool->reacquire(m_target, desc);
     }
     else
     {
-        glGenFramebuffers(1, &m_frameBuffer);
+        pool->release(m_multisampledTarget);
+        m_multisampledTarget = nullptr;
 
-        this->attachColorTexture(m_colorTexture);
-        this->attachDepthBuffer(m_depthBuffer);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
+        desc.depthFormat = GL_DEPTH_COMPONENT24;
+        pool->reacquire(m_target, desc);
     }
-
-    this->unbind();
 }
 
 void ivf::FrameBuffer::resize(int width, int height)
 {
-    if ((m_width == width) && (m_height == height))
-        return;
-
     m_width = width;
     m_height = height;
-
-    this->initialize();
 }
 
 void ivf::FrameBuffer::drop()
 {
-    glDeleteBuffers(1, &m_quadVBO);
-    glDeleteVertexArrays(1, &m_quadVAO);
-
-    if (m_multisample)
+    if (m_quadVAO != 0)
     {
-        glDeleteTextures(1, &m_multisampledColorTexture);
-        glDeleteRenderbuffers(1, &m_multisampledDepthBuffer);
-        glDeleteFramebuffers(1, &m_multisampledFrameBuffer);
+        glDeleteBuffers(1, &m_quadVBO);
+        glDeleteVertexArrays(1, &m_quadVAO);
+        m_quadVAO = m_quadVBO = 0;
     }
 
-    glDeleteTextures(1, &m_colorTexture);
-    glDeleteRenderbuffers(1, &m_depthBuffer);
-    glDeleteFramebuffers(1, &m_frameBuffer);
+    auto pool = RenderTargetPool::instance();
+
+    pool->release(m_multisampledTarget);
+    pool->release(m_target);
+    m_multisampledTarget = nullptr;
+    m_target = nullptr;
 }
 
 void FrameBuffer::bind()
 {
+    this->updateTargets();
+
     if (m_multisample)
-        glBindFramebuffer(GL_FRAMEBUFFER, m_multisampledFrameBuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_multisampledTarget->fbo());
     else
-        glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_target->fbo());
 }
 
 void FrameBuffer::unbind()
@@ -162,19 +117,14 @@ void FrameBuffer::unbind()
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void ivf::FrameBuffer::attachMultisampledStencilBuffer()
-{}
-
 void ivf::FrameBuffer::setMultisample(bool multisample)
 {
     m_multisample = multisample;
-    this->initialize();
 }
 
 void ivf::FrameBuffer::setSamples(int samples)
 {
     m_samples = samples;
-    this->initialize();
 }
 
 bool ivf::FrameBuffer::multisample()
@@ -198,18 +148,15 @@ void FrameBuffer::checkStatus()
 
 void ivf::FrameBuffer::begin()
 {
-    if (m_multisample)
-        glBindFramebuffer(GL_FRAMEBUFFER, m_multisampledFrameBuffer);
-    else
-        glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
+    this->bind();
 }
 
 void ivf::FrameBuffer::end()
 {
     if (m_multisample)
     {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_multisampledFrameBuffer);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_frameBuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_multisampledTarget->fbo());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_target->fbo());
         glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
     }
 
@@ -226,7 +173,7 @@ void ivf::FrameBuffer::draw()
     glDisable(GL_DEPTH_TEST);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glBindTexture(GL_TEXTURE_2D, this->colorTexture());
 
     smCurrentProgram()->uniformInt("screenTexture", 0);
 
@@ -238,10 +185,10 @@ void ivf::FrameBuffer::draw()
 
 GLuint ivf::FrameBuffer::colorTexture()
 {
-    return m_colorTexture;
+    return m_target ? m_target->texture() : 0;
 }
 
 GLuint ivf::FrameBuffer::id()
 {
-    return m_frameBuffer;
+    return m_target ? m_target->fbo() : 0;
 }
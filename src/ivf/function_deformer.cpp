@@ -1,5 +1,6 @@
 #include <ivf/function_deformer.h>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 using namespace ivf;
@@ -25,16 +26,19 @@ std::shared_ptr<FunctionDeformer> FunctionDeformer::create(const DisplacementFun
 void FunctionDeformer::setFunction(const DisplacementFunction &func)
 {
     m_displacementFunction = func;
+    markChanged();
 }
 
 void FunctionDeformer::setScale(const glm::vec3 &scale)
 {
     m_scale = scale;
+    markChanged();
 }
 
 void FunctionDeformer::setScale(float uniformScale)
 {
     m_scale = glm::vec3(uniformScale);
+    markChanged();
 }
 
 glm::vec3 FunctionDeformer::scale() const
@@ -45,6 +49,7 @@ glm::vec3 FunctionDeformer::scale() const
 void FunctionDeformer::setOffset(const glm::vec3 &offset)
 {
     m_offset = offset;
+    markChanged();
 }
 
 glm::vec3 FunctionDeformer::offset() const
@@ -55,6 +60,7 @@ glm::vec3 FunctionDeformer::offset() const
 void FunctionDeformer::setUseLocalSpace(bool useLocal)
 {
     m_useLocalSpace = useLocal;
+    markChanged();
 }
 
 bool FunctionDeformer::useLocalSpace() const
@@ -65,6 +71,7 @@ bool FunctionDeformer::useLocalSpace() const
 void FunctionDeformer::setTime(float time)
 {
     m_time = time;
+    markChanged();
 }
 
 float FunctionDeformer::time() const
@@ -72,6 +79,33 @@ float FunctionDeformer::time() const
     return m_time;
 }
 
+void FunctionDeformer::setCacheable(bool cacheable)
+{
+    m_cacheable = cacheable;
+    markChanged();
+}
+
+bool FunctionDeformer::cacheable() const
+{
+    return m_cacheable;
+}
+
+void FunctionDeformer::setThreadSafe(bool threadSafe)
+{
+    m_threadSafe = threadSafe;
+}
+
+bool FunctionDeformer::threadSafe() const
+{
+    return m_threadSafe;
+}
+
+uint64_t FunctionDeformer::revision() const
+{
+    // Captured state may have changed since the last query
+    return m_cacheable ? Deformer::revision() : nextRevision();
+}
+
 void FunctionDeformer::apply()
 {
     if (!m_enabled || !m_originalVertices || !m_deformedVertices || !m_displacementFunction)
@@ -79,17 +113,31 @@ void FunctionDeformer::apply()
         return;
     }
 
-    for (GLuint i = 0; i < m_originalVertices->rows(); ++i)
+    // Serial evaluation, prepareKernel() declines the fused pass for functions that are not thread safe
+    GLuint count = m_originalVertices->rows();
+    std::memcpy(m_deformedVertices->data(), m_originalVertices->data(), m_originalVertices->memSize());
+    applyKernel(reinterpret_cast<glm::vec3 *>(m_deformedVertices->data()), 0, count);
+}
+
+bool FunctionDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    return m_threadSafe;
+}
+
+void FunctionDeformer::applyKernel(glm::vec3 *positions, [[maybe_unused]] GLuint first, GLuint count) const
+{
+    if (!m_displacementFunction)
+        return;
+
+    for (GLuint i = 0; i < count; ++i)
     {
-        glm::vec3 originalPos = m_originalVertices->vertex(i);
-        glm::vec3 inputPos = originalPos + m_offset;
+        glm::vec3 inputPos = positions[i] + m_offset;
 
         // Apply the displacement function
         glm::vec3 displacement = m_displacementFunction(inputPos);
         displacement *= m_scale * m_weight;
 
-        glm::vec3 deformedPos = originalPos + displacement;
-        m_deformedVertices->setVertex(i, deformedPos.x, deformedPos.y, deformedPos.z);
+        positions[i] += displacement;
     }
 }
 
@@ -100,6 +148,8 @@ std::unique_ptr<Deformer> FunctionDeformer::clone() const
     cloned->setOffset(m_offset);
     cloned->setUseLocalSpace(m_useLocalSpace);
     cloned->setTime(m_time);
+    cloned->setCacheable(m_cacheable);
+    cloned->setThreadSafe(m_threadSafe);
     cloned->setWeight(m_weight);
     cloned->setEnabled(m_enabled);
     return cloned;
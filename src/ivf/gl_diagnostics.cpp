@@ -0,0 +1,397 @@
+#include <ivf/gl_diagnostics.h>
+
+#include <ivf/logger.h>
+
+using namespace ivf;
+
+GLDiagnostics *GLDiagnostics::m_instance = nullptr;
+
+#ifdef IVF_GL_DIAGNOSTICS
+bool GLDiagnostics::m_errorQueries = true;
+#else
+bool GLDiagnostics::m_errorQueries = false;
+#endif
+
+namespace {
+
+const char *sourceName(GLenum source)
+{
+    switch (source)
+    {
+    case GL_DEBUG_SOURCE_API:
+        return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+        return "Window";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:
+        return "Shader";
+    case GL_DEBUG_SOURCE_THIRD_PARTY:
+        return "ThirdParty";
+    case GL_DEBUG_SOURCE_APPLICATION:
+        return "App";
+    default:
+        return "Other";
+    }
+}
+
+const char *typeName(GLenum type)
+{
+    switch (type)
+    {
+    case GL_DEBUG_TYPE_ERROR:
+        return "Error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+        return "Deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+        return "Undefined";
+    case GL_DEBUG_TYPE_PORTABILITY:
+        return "Portability";
+    case GL_DEBUG_TYPE_PERFORMANCE:
+        return "Performance";
+    case GL_DEBUG_TYPE_MARKER:
+        return "Marker";
+    default:
+        return "Other";
+    }
+}
+
+int severityRank(GLenum severity)
+{
+    switch (severity)
+    {
+    case GL_DEBUG_SEVERITY_HIGH:
+        return int(GLDebugSeverity::High);
+    case GL_DEBUG_SEVERITY_MEDIUM:
+        return int(GLDebugSeverity::Medium);
+    case GL_DEBUG_SEVERITY_LOW:
+        return int(GLDebugSeverity::Low);
+    default:
+        return int(GLDebugSeverity::Notification);
+    }
+}
+
+} // namespace
+
+GLDiagnostics::GLDiagnostics()
+#ifdef IVF_GL_DIAGNOSTICS
+    : m_mode(GLDiagnosticsMode::DebugOutput), m_minSeverity(GLDebugSeverity::Low)
+#else
+    : m_mode(GLDiagnosticsMode::Off), m_minSeverity(GLDebugSeverity::Medium)
+#endif
+{}
+
+GLDiagnostics *GLDiagnostics::instance()
+{
+    if (!m_instance)
+        m_instance = new GLDiagnostics();
+
+    return m_instance;
+}
+
+GLDiagnostics *GLDiagnostics::create()
+{
+    return instance();
+}
+
+void GLDiagnostics::drop()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+void GLDiagnostics::install()
+{
+    m_debugOutputAvailable = (glDebugMessageCallback != nullptr) && (glDebugMessageControl != nullptr);
+
+    if (m_debugOutputAvailable)
+    {
+        GLint flags = 0;
+        glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+        glDebugMessageCallback(&GLDiagnostics::debugCallback, this);
+
+        if ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) == 0)
+            logInfofc("GLDiagnostics", "Context is not a debug context, driver may report fewer messages");
+    }
+    else
+        logInfofc("GLDiagnostics", "KHR_debug not available, using glGetError() queries");
+
+    m_installed = true;
+
+    this->applyFilters();
+    this->applyMode();
+}
+
+bool GLDiagnostics::debugOutputAvailable() const
+{
+    return m_debugOutputAvailable;
+}
+
+void GLDiagnostics::applyMode()
+{
+    bool debugOutput = false;
+    bool errorQueries = false;
+
+    switch (m_mode)
+    {
+    case GLDiagnosticsMode::DebugOutput:
+        debugOutput = m_debugOutputAvailable;
+        errorQueries = !m_debugOutputAvailable;
+        break;
+    case GLDiagnosticsMode::ErrorQueries:
+        errorQueries = true;
+        break;
+    default:
+        break;
+    }
+
+    if (m_validatingFrame)
+    {
+        debugOutput = m_debugOutputAvailable;
+        errorQueries = true;
+    }
+
+    m_errorQueries = errorQueries;
+
+    if (!m_installed || !m_debugOutputAvailable)
+        return;
+
+    if (debugOutput)
+        glEnable(GL_DEBUG_OUTPUT);
+    else
+        glDisable(GL_DEBUG_OUTPUT);
+
+    if (debugOutput && (m_synchronous || m_validatingFrame))
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+}
+
+void GLDiagnostics::applyFilters()
+{
+    if (!m_installed || !m_debugOutputAvailable)
+        return;
+
+    // Let the driver drop messages below the minimum severity so they never reach the callback.
+
+    const GLenum severities[] = {GL_DEBUG_SEVERITY_NOTIFICATION, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_MEDIUM,
+                                 GL_DEBUG_SEVERITY_HIGH};
+
+    for (int i = 0; i < 4; i++)
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severities[i], 0, nullptr,
+                              i >= int(m_minSeverity) ? GL_TRUE : GL_FALSE);
+
+    // Group push/pop notifications are generated by our own context tags.
+
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+
+    if (!m_ignoredIds.empty())
+    {
+        std::vector<GLuint> ids(m_ignoredIds.begin(), m_ignoredIds.end());
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, GLsizei(ids.size()), ids.data(), GL_FALSE);
+    }
+}
+
+void GLDiagnostics::setMode(GLDiagnosticsMode mode)
+{
+    m_mode = mode;
+    this->applyMode();
+}
+
+GLDiagnosticsMode GLDiagnostics::mode() const
+{
+    return m_mode;
+}
+
+void GLDiagnostics::setMinSeverity(GLDebugSeverity severity)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_minSeverity = severity;
+    }
+    this->applyFilters();
+}
+
+GLDebugSeverity GLDiagnostics::minSeverity() const
+{
+    return m_minSeverity;
+}
+
+void GLDiagnostics::ignoreMessageId(GLuint id)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ignoredIds.insert(id);
+    }
+    this->applyFilters();
+}
+
+void GLDiagnostics::clearIgnoredIds()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ignoredIds.clear();
+    }
+    this->applyFilters();
+}
+
+void GLDiagnostics::setSynchronous(bool flag)
+{
+    m_synchronous = flag;
+    this->applyMode();
+}
+
+bool GLDiagnostics::synchronous() const
+{
+    return m_synchronous;
+}
+
+void GLDiagnostics::pushContext(const std::string &name)
+{
+    bool group = m_installed && m_debugOutputAvailable && (m_mode != GLDiagnosticsMode::Off);
+    GLuint depth;
+
+    // The lock is released before the GL call, a synchronous callback runs on this thread.
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_contextStack.push_back(name);
+        depth = GLuint(m_contextStack.size());
+    }
+
+    m_contextGroups.push_back(group);
+
+    if (group)
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, depth, -1, name.c_str());
+}
+
+void GLDiagnostics::popContext()
+{
+    if (m_contextGroups.empty())
+        return;
+
+    bool group = m_contextGroups.back();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_contextStack.pop_back();
+    }
+
+    m_contextGroups.pop_back();
+
+    if (group)
+        glPopDebugGroup();
+}
+
+std::string GLDiagnostics::currentContext() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_contextStack.empty())
+        return "";
+
+    return m_contextStack.back();
+}
+
+void GLDiagnostics::validateFrame()
+{
+    m_validateNextFrame = true;
+}
+
+bool GLDiagnostics::isValidatingFrame() const
+{
+    return m_validatingFrame;
+}
+
+void GLDiagnostics::beginFrame()
+{
+    m_frameMessageCount = 0;
+
+    if (m_validateNextFrame)
+    {
+        m_validateNextFrame = false;
+        m_validatingFrame = true;
+
+        // Flush errors from outside the frame so they are not attributed to it.
+
+        while (glGetError() != GL_NO_ERROR)
+            ;
+
+        this->applyMode();
+        logInfofc("GLDiagnostics", "Validating frame");
+    }
+}
+
+void GLDiagnostics::endFrame()
+{
+    if (!m_validatingFrame)
+        return;
+
+    // Catch errors from calls not wrapped in GL_ERR().
+
+    GLenum err;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        logErrorfc("GLDiagnostics", "Unchecked OpenGL error 0x{:04x} during validated frame", unsigned(err));
+        m_frameMessageCount++;
+    }
+
+    logInfofc("GLDiagnostics", "Frame validation finished, {} message(s) reported", m_frameMessageCount.load());
+
+    m_validatingFrame = false;
+    this->applyMode();
+}
+
+std::size_t GLDiagnostics::messageCount() const
+{
+    return m_messageCount;
+}
+
+std::size_t GLDiagnostics::frameMessageCount() const
+{
+    return m_frameMessageCount;
+}
+
+std::size_t GLDiagnostics::suppressedCount() const
+{
+    return m_suppressedCount;
+}
+
+void GLDiagnostics::handleMessage(GLenum source, GLenum type, GLuint id, GLenum severity, const char *message)
+{
+    // May run on a driver thread when debug output is asynchronous.
+
+    std::string context;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if ((type == GL_DEBUG_TYPE_PUSH_GROUP) || (type == GL_DEBUG_TYPE_POP_GROUP) ||
+            (severityRank(severity) < int(m_minSeverity)) || m_ignoredIds.count(id))
+        {
+            m_suppressedCount++;
+            return;
+        }
+
+        context = m_contextStack.empty() ? "-" : m_contextStack.back();
+    }
+
+    m_messageCount++;
+    m_frameMessageCount++;
+
+    if ((type == GL_DEBUG_TYPE_ERROR) || (severity == GL_DEBUG_SEVERITY_HIGH))
+        logErrorfc("OpenGL", "[{}] {}/{} ({}): {}", context, sourceName(source), typeName(type), id, message);
+    else if (severity == GL_DEBUG_SEVERITY_MEDIUM)
+        logWarningfc("OpenGL", "[{}] {}/{} ({}): {}", context, sourceName(source), typeName(type), id, message);
+    else
+        logDebugfc("OpenGL", "[{}] {}/{} ({}): {}", context, sourceName(source), typeName(type), id, message);
+}
+
+void APIENTRY GLDiagnostics::debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                           [[maybe_unused]] GLsizei length, const GLchar *message,
+                                           const void *userParam)
+{
+    auto diagnostics = static_cast<GLDiagnostics *>(const_cast<void *>(userParam));
+
+    if (diagnostics)
+        diagnostics->handleMessage(source, type, id, severity, message);
+}
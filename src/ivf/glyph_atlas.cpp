@@ -0,0 +1,332 @@
+#include <ivf/glyph_atlas.h>
+
+#include <ivf/logger.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ivf;
+
+namespace {
+
+// FT_RENDER_MODE_SDF was added in FreeType 2.11
+
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+constexpr bool freetypeSdf = true;
+#else
+constexpr bool freetypeSdf = false;
+#endif
+
+// Empty pixels between glyphs, keeps linear filtering from bleeding into neighbours
+
+constexpr int glyphPadding = 1;
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(FT_Face face, int pixelSize, bool sdf)
+    : m_face(face), m_pixelSize(pixelSize), m_sdf(sdf && freetypeSdf)
+{
+    if (sdf && !freetypeSdf)
+        logWarningfc("GlyphAtlas", "Signed distance field glyphs need FreeType 2.11, using coverage glyphs");
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    if (m_texture)
+        glDeleteTextures(1, &m_texture);
+}
+
+std::shared_ptr<GlyphAtlas> GlyphAtlas::create(FT_Face face, int pixelSize, bool sdf)
+{
+    return std::make_shared<GlyphAtlas>(face, pixelSize, sdf);
+}
+
+bool GlyphAtlas::allocate(int width, int height, glm::ivec2 &pos)
+{
+    if (width + glyphPadding > m_width)
+        return false;
+
+    // Start a new shelf when the current one is full
+
+    if (m_shelfX + width + glyphPadding > m_width)
+    {
+        m_shelfY += m_shelfHeight;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+
+    if (m_shelfY + height + glyphPadding > m_height)
+        return false;
+
+    pos = glm::ivec2(m_shelfX, m_shelfY);
+
+    m_shelfX += width + glyphPadding;
+    m_shelfHeight = std::max(m_shelfHeight, height + glyphPadding);
+
+    return true;
+}
+
+bool GlyphAtlas::grow()
+{
+    int width = m_width;
+    int height = m_height;
+
+    if (height < m_maxSize)
+        height *= 2;
+    else if (width < m_maxSize)
+        width *= 2;
+    else
+        return false;
+
+    // Glyphs keep their pixel positions, only the texture coordinates change
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height, 0);
+
+    for (int row = 0; row < m_height; row++)
+        std::memcpy(&pixels[static_cast<size_t>(row) * width], &m_pixels[static_cast<size_t>(row) * m_width],
+                    m_width);
+
+    m_pixels.swap(pixels);
+    m_width = width;
+    m_height = height;
+    m_generation++;
+
+    if (m_texture)
+    {
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_width, m_height, 0, GL_RED, GL_UNSIGNED_BYTE, m_pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    logInfofc("GlyphAtlas", "Glyph atlas ({} px) grown to {}x{}", m_pixelSize, m_width, m_height);
+
+    return true;
+}
+
+const GlyphInfo *GlyphAtlas::glyph(char32_t codepoint)
+{
+    auto it = m_glyphs.find(codepoint);
+
+    if (it != m_glyphs.end())
+        return &it->second;
+
+    if (!m_face)
+        return nullptr;
+
+    FT_Set_Pixel_Sizes(m_face, 0, m_pixelSize);
+
+    FT_UInt glyphIndex = FT_Get_Char_Index(m_face, codepoint);
+
+    // Characters missing from the face are shown as '?'
+
+    if (glyphIndex == 0 && codepoint != '?')
+    {
+        auto fallback = this->glyph('?');
+
+        if (!fallback)
+            return nullptr;
+
+        GlyphInfo info = *fallback;
+        return &m_glyphs.emplace(codepoint, info).first->second;
+    }
+
+    if (FT_Load_Glyph(m_face, glyphIndex, FT_LOAD_DEFAULT))
+    {
+        logErrorfc("GlyphAtlas", "Failed to load glyph U+{:04X}", static_cast<unsigned int>(codepoint));
+        return nullptr;
+    }
+
+    FT_GlyphSlot slot = m_face->glyph;
+
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+    FT_Render_Mode renderMode = m_sdf ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL;
+#else
+    FT_Render_Mode renderMode = FT_RENDER_MODE_NORMAL;
+#endif
+
+    if (FT_Render_Glyph(slot, renderMode))
+    {
+        logErrorfc("GlyphAtlas", "Failed to render glyph U+{:04X}", static_cast<unsigned int>(codepoint));
+        return nullptr;
+    }
+
+    GlyphInfo info;
+    info.size = glm::ivec2(slot->bitmap.width, slot->bitmap.rows);
+    info.bearing = glm::ivec2(slot->bitmap_left, slot->bitmap_top);
+    info.advance = slot->advance.x / 64.0f;
+    info.height = slot->metrics.height / 64.0f;
+
+    // Glyphs without pixels (spaces) only contribute metrics
+
+    if (info.size.x > 0 && info.size.y > 0)
+    {
+        if (m_pixels.empty())
+            m_pixels.assign(static_cast<size_t>(m_width) * m_height, 0);
+
+        bool placed = this->allocate(info.size.x, info.size.y, info.atlasPos);
+
+        while (!placed && this->grow())
+            placed = this->allocate(info.size.x, info.size.y, info.atlasPos);
+
+        if (!placed)
+        {
+            logWarningfc("GlyphAtlas", "Glyph atlas full at {}x{}, U+{:04X} not added", m_width, m_height,
+                         static_cast<unsigned int>(codepoint));
+            info.size = glm::ivec2(0);
+        }
+        else
+        {
+            for (int row = 0; row < info.size.y; row++)
+                std::memcpy(&m_pixels[static_cast<size_t>(info.atlasPos.y + row) * m_width + info.atlasPos.x],
+                            slot->bitmap.buffer + row * slot->bitmap.pitch, info.size.x);
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            if (!m_texture)
+            {
+                glGenTextures(1, &m_texture);
+                glBindTexture(GL_TEXTURE_2D, m_texture);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_width, m_height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                             m_pixels.data());
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            }
+            else
+            {
+                // Upload only the new glyph, rows are read from the CPU copy of the atlas
+
+                glBindTexture(GL_TEXTURE_2D, m_texture);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, info.atlasPos.x, info.atlasPos.y, info.size.x, info.size.y, GL_RED,
+                                GL_UNSIGNED_BYTE,
+                                &m_pixels[static_cast<size_t>(info.atlasPos.y) * m_width + info.atlasPos.x]);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            }
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
+
+    return &m_glyphs.emplace(codepoint, info).first->second;
+}
+
+void GlyphAtlas::bind()
+{
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+}
+
+GLuint GlyphAtlas::texture() const
+{
+    return m_texture;
+}
+
+int GlyphAtlas::width() const
+{
+    return m_width;
+}
+
+int GlyphAtlas::height() const
+{
+    return m_height;
+}
+
+void GlyphAtlas::setMaxSize(int size)
+{
+    m_maxSize = std::max(size, std::max(m_width, m_height));
+}
+
+int GlyphAtlas::maxSize() const
+{
+    return m_maxSize;
+}
+
+int GlyphAtlas::pixelSize() const
+{
+    return m_pixelSize;
+}
+
+bool GlyphAtlas::sdf() const
+{
+    return m_sdf;
+}
+
+size_t GlyphAtlas::glyphCount() const
+{
+    return m_glyphs.size();
+}
+
+unsigned int GlyphAtlas::generation() const
+{
+    return m_generation;
+}
+
+bool GlyphAtlas::sdfSupported()
+{
+    return freetypeSdf;
+}
+
+std::u32string GlyphAtlas::decodeUtf8(const std::string &text)
+{
+    std::u32string result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+
+    while (i < text.size())
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        int length = 0;
+        char32_t codepoint = 0;
+
+        if (c < 0x80)
+        {
+            length = 1;
+            codepoint = c;
+        }
+        else if ((c & 0xE0) == 0xC0)
+        {
+            length = 2;
+            codepoint = c & 0x1F;
+        }
+        else if ((c & 0xF0) == 0xE0)
+        {
+            length = 3;
+            codepoint = c & 0x0F;
+        }
+        else if ((c & 0xF8) == 0xF0)
+        {
+            length = 4;
+            codepoint = c & 0x07;
+        }
+
+        bool valid = length > 0 && i + length <= text.size();
+
+        for (int k = 1; valid && k < length; k++)
+        {
+            unsigned char cc = static_cast<unsigned char>(text[i + k]);
+
+            if ((cc & 0xC0) != 0x80)
+                valid = false;
+            else
+                codepoint = (codepoint << 6) | (cc & 0x3F);
+        }
+
+        if (!valid)
+        {
+            result.push_back(0xFFFD);
+            i++;
+            continue;
+        }
+
+        result.push_back(codepoint);
+        i += length;
+    }
+
+    return result;
+}
@@ -4,6 +4,7 @@
 #include <ivf/vertex_shader.h>
 #include <ivf/fragment_shader.h>
 #include <ivf/logger.h>
+#include <ivf/render_target_pool.h>
 #include <ivf/utils.h>
 
 using namespace ivf;
@@ -68,11 +69,6 @@ void GPUProceduralTexture::createQuad()
 
 void GPUProceduralTexture::cleanup()
 {
-    if (m_fbo != 0) {
-        glDeleteFramebuffers(1, &m_fbo);
-        m_fbo = 0;
-    }
-    
     if (m_quadVAO != 0) {
         glDeleteVertexArrays(1, &m_quadVAO);
         glDeleteBuffers(1, &m_quadVBO);
@@ -127,31 +123,23 @@ void GPUProceduralTexture::regenerate()
     
     GL_ERR_BEGIN;
     
-    // Create/recreate FBO if needed
-    if (m_fbo == 0) {
-        glGenFramebuffers(1, &m_fbo);
-    }
-    
     // Ensure texture is allocated with correct size
     glBindTexture(GL_TEXTURE_2D, this->id());
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    if (m_allocatedWidth != m_width || m_allocatedHeight != m_height) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_allocatedWidth = m_width;
+        m_allocatedHeight = m_height;
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     
-    // Attach texture to FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->id(), 0);
+    // Render into a shared transient target
+    auto pool = RenderTargetPool::instance();
+    auto target = pool->acquire(m_width, m_height, GL_RGBA8);
     
-    // Check FBO status
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        logErrorfc("GPUProceduralTexture", "Framebuffer not complete: {}", status);
-        glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
-        GL_ERR_END("GPUProceduralTexture::regenerate() - FBO error");
-        return;
-    }
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo());
     
     // Set viewport to texture size
     glViewport(0, 0, m_width, m_height);
@@ -181,11 +169,14 @@ void GPUProceduralTexture::regenerate()
     // Restore depth test
     if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
     
-    // Generate mipmaps
+    // Copy the result into this texture and generate mipmaps
     glBindTexture(GL_TEXTURE_2D, this->id());
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_width, m_height);
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     
+    pool->release(target);
+    
     // Restore OpenGL state
     glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
     glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
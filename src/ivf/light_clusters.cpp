@@ -0,0 +1,404 @@
+#include <ivf/light_clusters.h>
+
+#include <ivf/thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace ivf;
+
+namespace {
+
+struct LightExtent {
+    bool visible;
+    glm::ivec3 min;
+    glm::ivec3 max;
+};
+
+} // namespace
+
+LightClusters::LightClusters()
+{}
+
+LightClusters::~LightClusters()
+{
+    if (m_lightSSBO)
+        glDeleteBuffers(1, &m_lightSSBO);
+    if (m_gridSSBO)
+        glDeleteBuffers(1, &m_gridSSBO);
+    if (m_indexSSBO)
+        glDeleteBuffers(1, &m_indexSSBO);
+}
+
+std::shared_ptr<LightClusters> LightClusters::create()
+{
+    return std::make_shared<LightClusters>();
+}
+
+bool LightClusters::isSupported()
+{
+    return GLAD_GL_VERSION_4_3 && (glBindBufferBase != nullptr);
+}
+
+void LightClusters::setGridSize(unsigned int x, unsigned int y, unsigned int z)
+{
+    m_dims = glm::uvec3(std::max(x, 1u), std::max(y, 1u), std::max(z, 1u));
+}
+
+glm::uvec3 LightClusters::gridSize() const
+{
+    return m_dims;
+}
+
+void LightClusters::setAttenuationThreshold(float threshold)
+{
+    m_attenuationThreshold = std::max(threshold, 1e-6f);
+}
+
+float LightClusters::attenuationThreshold() const
+{
+    return m_attenuationThreshold;
+}
+
+float LightClusters::lightRange(float constant, float linear, float quadratic, float intensity, float threshold)
+{
+    // Solve constant + linear * d + quadratic * d^2 = intensity / threshold for d.
+
+    float k = std::max(intensity, 1e-4f) / threshold;
+
+    if (quadratic > 0.0f)
+    {
+        float disc = linear * linear - 4.0f * quadratic * (constant - k);
+        if (disc < 0.0f)
+            return 0.0f;
+        return std::max((-linear + std::sqrt(disc)) / (2.0f * quadratic), 0.0f);
+    }
+    else if (linear > 0.0f)
+        return std::max((k - constant) / linear, 0.0f);
+
+    return -1.0f;
+}
+
+void LightClusters::setLights(const std::vector<PointLightPtr> &pointLights,
+                              const std::vector<SpotLightPtr> &spotLights)
+{
+    m_lights.clear();
+    m_lights.reserve(pointLights.size() + spotLights.size());
+
+    for (auto &light : pointLights)
+    {
+        if (!light->enabled())
+            continue;
+
+        float intensity = std::max(glm::max(light->diffuseColor().r, light->diffuseColor().g),
+                                   std::max(light->diffuseColor().b, 0.0f));
+        intensity = std::max(intensity, glm::max(glm::max(light->specularColor().r, light->specularColor().g),
+                                                 light->specularColor().b));
+
+        float range = lightRange(light->constAttenuation(), light->linearAttenutation(), light->quadraticAttenuation(),
+                                 intensity, m_attenuationThreshold);
+
+        ClusterLightData data;
+        data.positionRange = glm::vec4(light->position(), range);
+        data.directionType = glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
+        data.diffuseConstant = glm::vec4(light->diffuseColor(), light->constAttenuation());
+        data.specularLinear = glm::vec4(light->specularColor(), light->linearAttenutation());
+        data.ambientQuadratic = glm::vec4(light->ambientColor(), light->quadraticAttenuation());
+        data.spotCutoff = glm::vec4(-1.0f, -1.0f, 0.0f, 0.0f);
+        m_lights.push_back(data);
+    }
+
+    for (auto &light : spotLights)
+    {
+        if (!light->enabled())
+            continue;
+
+        float intensity = std::max(glm::max(light->diffuseColor().r, light->diffuseColor().g),
+                                   std::max(light->diffuseColor().b, 0.0f));
+        intensity = std::max(intensity, glm::max(glm::max(light->specularColor().r, light->specularColor().g),
+                                                 light->specularColor().b));
+
+        float range = lightRange(light->constAttenuation(), light->linearAttenutation(), light->quadraticAttenuation(),
+                                 intensity, m_attenuationThreshold);
+
+        ClusterLightData data;
+        data.positionRange = glm::vec4(light->position(), range);
+        data.directionType = glm::vec4(light->direction(), 1.0f);
+        data.diffuseConstant = glm::vec4(light->diffuseColor(), light->constAttenuation());
+        data.specularLinear = glm::vec4(light->specularColor(), light->linearAttenutation());
+        data.ambientQuadratic = glm::vec4(light->ambientColor(), light->quadraticAttenuation());
+        data.spotCutoff = glm::vec4(glm::cos(glm::radians(light->innerCutoff())),
+                                    glm::cos(glm::radians(light->outerCutoff())), 0.0f, 0.0f);
+        m_lights.push_back(data);
+    }
+}
+
+int LightClusters::depthSlice(float depth) const
+{
+    float t;
+
+    if (m_perspective)
+        t = std::log(std::max(depth, m_near) / m_near) / std::log(m_far / m_near);
+    else
+        t = (depth - m_near) / (m_far - m_near);
+
+    return std::clamp(int(std::floor(t * float(m_dims.z))), 0, int(m_dims.z) - 1);
+}
+
+void LightClusters::assign(const glm::mat4 &view, const glm::mat4 &projection)
+{
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    // Extract near/far planes from the projection matrix.
+
+    m_perspective = projection[3][3] == 0.0f;
+
+    if (m_perspective)
+    {
+        m_near = projection[3][2] / (projection[2][2] - 1.0f);
+        m_far = projection[3][2] / (projection[2][2] + 1.0f);
+    }
+    else
+    {
+        m_near = (projection[3][2] + 1.0f) / projection[2][2];
+        m_far = (projection[3][2] - 1.0f) / projection[2][2];
+    }
+
+    if (m_perspective)
+        m_near = std::max(m_near, 1e-4f);
+
+    m_far = std::max(m_far, m_near + 1e-3f);
+
+    const int dimX = int(m_dims.x);
+    const int dimY = int(m_dims.y);
+    const int dimZ = int(m_dims.z);
+    const size_t sliceClusters = size_t(dimX) * size_t(dimY);
+
+    // Phase 1: compute the cluster range covered by each light's bounding sphere.
+
+    std::vector<LightExtent> extents(m_lights.size());
+
+    auto pool = ThreadPool::instance();
+
+    pool->parallelFor(
+        0, m_lights.size(),
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                auto &light = m_lights[i];
+                auto &extent = extents[i];
+
+                glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.positionRange), 1.0f));
+                float radius = light.positionRange.w < 0.0f ? m_far * 2.0f : light.positionRange.w;
+
+                float zMin = -center.z - radius;
+                float zMax = -center.z + radius;
+
+                extent.visible = !((zMax < m_near) || (zMin > m_far));
+
+                if (!extent.visible)
+                    continue;
+
+                extent.min.z = depthSlice(std::max(zMin, m_near));
+                extent.max.z = depthSlice(std::min(zMax, m_far));
+
+                if (m_perspective && (zMin <= m_near))
+                {
+                    // Sphere crosses the near plane, its projection is unbounded.
+
+                    extent.min.x = 0;
+                    extent.min.y = 0;
+                    extent.max.x = dimX - 1;
+                    extent.max.y = dimY - 1;
+                    continue;
+                }
+
+                glm::vec2 ndcMin(1e30f), ndcMax(-1e30f);
+
+                for (int c = 0; c < 8; c++)
+                {
+                    glm::vec3 corner = center + glm::vec3((c & 1) ? radius : -radius, (c & 2) ? radius : -radius,
+                                                          (c & 4) ? radius : -radius);
+                    corner.z = std::min(corner.z, -m_near);
+                    glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+                    glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                    ndcMin = glm::min(ndcMin, ndc);
+                    ndcMax = glm::max(ndcMax, ndc);
+                }
+
+                if ((ndcMax.x < -1.0f) || (ndcMin.x > 1.0f) || (ndcMax.y < -1.0f) || (ndcMin.y > 1.0f))
+                {
+                    extent.visible = false;
+                    continue;
+                }
+
+                extent.min.x = std::clamp(int(std::floor((ndcMin.x * 0.5f + 0.5f) * dimX)), 0, dimX - 1);
+                extent.max.x = std::clamp(int(std::floor((ndcMax.x * 0.5f + 0.5f) * dimX)), 0, dimX - 1);
+                extent.min.y = std::clamp(int(std::floor((ndcMin.y * 0.5f + 0.5f) * dimY)), 0, dimY - 1);
+                extent.max.y = std::clamp(int(std::floor((ndcMax.y * 0.5f + 0.5f) * dimY)), 0, dimY - 1);
+            }
+        },
+        64);
+
+    // Phase 2: build the light lists one depth slice per task. Each slice counts its clusters'
+    // lights, computes local offsets and fills a slice-local index list.
+
+    m_grid.assign(sliceClusters * size_t(dimZ), glm::uvec2(0));
+
+    std::vector<std::vector<GLuint>> sliceIndices(dimZ);
+
+    pool->parallelFor(0, size_t(dimZ), [&](size_t begin, size_t end) {
+        std::vector<GLuint> counts(sliceClusters);
+
+        for (size_t z = begin; z < end; z++)
+        {
+            std::fill(counts.begin(), counts.end(), 0u);
+
+            for (auto &extent : extents)
+            {
+                if (!extent.visible || (int(z) < extent.min.z) || (int(z) > extent.max.z))
+                    continue;
+
+                for (int y = extent.min.y; y <= extent.max.y; y++)
+                    for (int x = extent.min.x; x <= extent.max.x; x++)
+                        counts[size_t(y) * dimX + x]++;
+            }
+
+            GLuint offset = 0;
+            glm::uvec2 *grid = &m_grid[z * sliceClusters];
+
+            for (size_t c = 0; c < sliceClusters; c++)
+            {
+                grid[c] = glm::uvec2(offset, 0);
+                offset += counts[c];
+            }
+
+            auto &indices = sliceIndices[z];
+            indices.resize(offset);
+
+            for (size_t i = 0; i < extents.size(); i++)
+            {
+                auto &extent = extents[i];
+
+                if (!extent.visible || (int(z) < extent.min.z) || (int(z) > extent.max.z))
+                    continue;
+
+                for (int y = extent.min.y; y <= extent.max.y; y++)
+                    for (int x = extent.min.x; x <= extent.max.x; x++)
+                    {
+                        auto &cell = grid[size_t(y) * dimX + x];
+                        indices[cell.x + cell.y] = GLuint(i);
+                        cell.y++;
+                    }
+            }
+        }
+    });
+
+    // Phase 3: concatenate the slice lists and rebase the grid offsets.
+
+    size_t total = 0;
+    for (auto &indices : sliceIndices)
+        total += indices.size();
+
+    m_indices.resize(total);
+    m_maxClusterLights = 0;
+
+    size_t base = 0;
+
+    for (int z = 0; z < dimZ; z++)
+    {
+        auto &indices = sliceIndices[z];
+        std::copy(indices.begin(), indices.end(), m_indices.begin() + base);
+
+        glm::uvec2 *grid = &m_grid[size_t(z) * sliceClusters];
+        for (size_t c = 0; c < sliceClusters; c++)
+        {
+            grid[c].x += GLuint(base);
+            m_maxClusterLights = std::max(m_maxClusterLights, grid[c].y);
+        }
+
+        base += indices.size();
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    m_assignTime = std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+void LightClusters::uploadBuffer(GLuint &buffer, size_t &capacity, const void *data, size_t size)
+{
+    if (buffer == 0)
+        glGenBuffers(1, &buffer);
+
+    // Storage buffers may not be empty, keep at least one element.
+
+    size = std::max<size_t>(size, 16);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+
+    if (size > capacity)
+    {
+        capacity = size + size / 2;
+        glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    if (data)
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void LightClusters::upload()
+{
+    uploadBuffer(m_lightSSBO, m_lightCapacity, m_lights.empty() ? nullptr : m_lights.data(),
+                 m_lights.size() * sizeof(ClusterLightData));
+    uploadBuffer(m_gridSSBO, m_gridCapacity, m_grid.empty() ? nullptr : m_grid.data(),
+                 m_grid.size() * sizeof(glm::uvec2));
+    uploadBuffer(m_indexSSBO, m_indexCapacity, m_indices.empty() ? nullptr : m_indices.data(),
+                 m_indices.size() * sizeof(GLuint));
+}
+
+void LightClusters::bind(ProgramPtr program, const glm::ivec4 &viewport)
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_lightSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_gridSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_indexSSBO);
+
+    if (!program)
+        return;
+
+    program->uniformVec3f("clusterDims", float(m_dims.x), float(m_dims.y), float(m_dims.z));
+    program->uniformVec4f("clusterViewport", float(viewport.x), float(viewport.y), float(viewport.z),
+                          float(viewport.w));
+    program->uniformVec4f("clusterDepth", m_near, m_far, std::log(m_far / m_near), m_perspective ? 1.0f : 0.0f);
+}
+
+size_t LightClusters::lightCount() const
+{
+    return m_lights.size();
+}
+
+size_t LightClusters::indexCount() const
+{
+    return m_indices.size();
+}
+
+GLuint LightClusters::maxClusterLights() const
+{
+    return m_maxClusterLights;
+}
+
+double LightClusters::assignTime() const
+{
+    return m_assignTime;
+}
+
+const std::vector<glm::uvec2> &LightClusters::grid() const
+{
+    return m_grid;
+}
+
+const std::vector<GLuint> &LightClusters::indices() const
+{
+    return m_indices;
+}
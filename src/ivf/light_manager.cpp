@@ -2,10 +2,16 @@
 
 #include <ivf/shader_manager.h>
 #include <ivf/extent_visitor.h>
+#include <ivf/transform_manager.h>
 #include <ivf/shadow_shaders.h>
+#include <ivf/gl_diagnostics.h>
+#include <ivf/logger.h>
 
+#include <algorithm>
 #include <strstream>
 
+#include <glm/gtc/type_ptr.hpp>
+
 using namespace ivf;
 
 LightManager *LightManager::m_instance = 0;
@@ -173,11 +179,16 @@ void ivf::LightManager::setupDefaultColors()
 
 void ivf::LightManager::apply()
 {
-    ShaderManager::instance()->currentProgram()->uniformInt(m_pointLightCountId, m_pointLights.size());
+    // With clustered lighting point and spot lights live in storage buffers (see updateClusters()).
+
+    size_t pointCount = m_useClusteredLighting ? 0 : m_pointLights.size();
+    size_t spotCount = m_useClusteredLighting ? 0 : m_spotLights.size();
+
+    ShaderManager::instance()->currentProgram()->uniformInt(m_pointLightCountId, pointCount);
     ShaderManager::instance()->currentProgram()->uniformInt(m_directionalLightCountId, m_dirLights.size());
-    ShaderManager::instance()->currentProgram()->uniformInt(m_spotLightCountId, m_spotLights.size());
+    ShaderManager::instance()->currentProgram()->uniformInt(m_spotLightCountId, spotCount);
 
-    for (auto i = 0; i < m_pointLights.size(); i++)
+    for (auto i = 0; i < pointCount; i++)
     {
         m_pointLights[i]->setIndex(i);
         m_pointLights[i]->apply();
@@ -189,69 +200,182 @@ void ivf::LightManager::apply()
         m_dirLights[i]->apply();
     }
 
-    for (auto i = 0; i < m_spotLights.size(); i++)
+    for (auto i = 0; i < spotCount; i++)
     {
         m_spotLights[i]->setIndex(i);
         m_spotLights[i]->apply();
     }
 
-    // Set shadow map textures
-    GLuint textureUnit = 1; // Assuming 0 is used for regular textures
+    this->applyShadowMaps();
+}
+
+void LightManager::applyShadowMaps()
+{
+    auto prog = ShaderManager::instance()->currentProgram();
 
-    // Create arrays to pass to shader
-    std::vector<int> shadowMapTextureUnits;
-    std::vector<glm::mat4> lightSpaceMatrices;
+    // Shadow map i is bound to texture unit 1 + i, units 1-4 hold default textures otherwise
 
-    for (auto i = 0; i < m_dirLights.size(); i++)
+    int shadowMapTextureUnits[MAX_SHADOW_LIGHTS];
+    int cascadeCounts[MAX_SHADOW_LIGHTS];
+    glm::mat4 lightSpaceMatrices[MAX_SHADOW_LIGHTS];
+    glm::mat4 cascadeMatrices[MAX_SHADOW_LIGHTS * MAX_SHADOW_CASCADES];
+
+    for (auto i = 0; i < MAX_SHADOW_LIGHTS; i++)
     {
-        if (!m_dirLights[i]->enabled() || !m_dirLights[i]->castsShadows() || !m_dirLights[i]->shadowMap())
+        shadowMapTextureUnits[i] = 1 + i;
+        cascadeCounts[i] = 0;
+        lightSpaceMatrices[i] = glm::mat4(1.0f);
+    }
+
+    for (auto &matrix : cascadeMatrices)
+        matrix = glm::mat4(1.0f);
+
+    bool hasShadows = false;
+
+    for (auto i = 0; i < std::min(m_dirLights.size(), size_t(MAX_SHADOW_LIGHTS)); i++)
+    {
+        auto &light = m_dirLights[i];
+
+        if (!light->enabled() || !light->castsShadows() || !light->shadowMap())
             continue;
 
-        std::string prefix = "dirLights[" + std::to_string(i) + "].";
+        auto &cascades = light->shadowCascades();
 
-        // Activate texture unit and bind shadow map
+        if (cascades.empty())
+            continue;
 
-        glActiveTexture(GL_TEXTURE0 + textureUnit);
-        glBindTexture(GL_TEXTURE_2D, m_dirLights[i]->shadowMap()->depthTexture());
+        glActiveTexture(GL_TEXTURE0 + shadowMapTextureUnits[i]);
+        glBindTexture(GL_TEXTURE_2D, light->shadowMap()->depthTexture());
 
-        // Store texture unit and light space matrix
+        cascadeCounts[i] = int(cascades.size());
 
-        shadowMapTextureUnits.push_back(textureUnit);
-        lightSpaceMatrices.push_back(m_dirLights[i]->shadowMap()->lightSpaceMatrix());
+        for (auto c = 0; c < cascades.size(); c++)
+            cascadeMatrices[i * MAX_SHADOW_CASCADES + c] = cascades[c].lightSpaceMatrix;
 
-        ShaderManager::instance()->currentProgram()->uniformBool(prefix + "castsShadows", true);
-        ShaderManager::instance()->currentProgram()->uniformBool("useShadows", true);
+        lightSpaceMatrices[i] = cascades[0].lightSpaceMatrix;
+        light->shadowMap()->setLightSpaceMatrix(lightSpaceMatrices[i]);
 
-        // Pass light space matrix
+        hasShadows = true;
+    }
 
-        ShaderManager::instance()->currentProgram()->uniformMatrix4(
-            "lightSpaceMatrix", m_dirLights[i]->calculateLightSpaceMatrix(m_sceneBBox));
+    glActiveTexture(GL_TEXTURE0);
 
-        // Only using one shadow map for now, but you could use multiple
+    if (hasShadows)
+    {
+        prog->uniformBool("useShadows", true);
+        prog->uniformIntArray("shadowMaps", MAX_SHADOW_LIGHTS, shadowMapTextureUnits);
+        prog->uniformMatrix4Array("lightSpaceMatrices", MAX_SHADOW_LIGHTS, lightSpaceMatrices);
+        glUniformMatrix4fv(prog->uniformLoc("cascadeMatrices"), MAX_SHADOW_LIGHTS * MAX_SHADOW_CASCADES, GL_FALSE,
+                           glm::value_ptr(cascadeMatrices[0]));
 
-        textureUnit++;
-        // break;
+        // Used by the shadow debug views
+
+        prog->uniformMatrix4("lightSpaceMatrix", lightSpaceMatrices[0]);
     }
 
-    // Set shadow map arrays to shader
-    if (!shadowMapTextureUnits.empty())
+    prog->uniformIntArray("cascadeCounts", MAX_SHADOW_LIGHTS, cascadeCounts);
+}
+
+void LightManager::setUseClusteredLighting(bool flag)
+{
+    if (flag == m_useClusteredLighting)
+        return;
+
+    if (flag && !LightClusters::isSupported())
     {
-        // Set the array of shadow map samplers
-        ShaderManager::instance()->currentProgram()->uniformIntArray("shadowMaps", shadowMapTextureUnits.size(),
-                                                                     shadowMapTextureUnits.data());
+        logWarning("Clustered lighting requires OpenGL 4.3, keeping uniform light arrays.", "LightManager");
+        return;
+    }
 
-        ShaderManager::instance()->currentProgram()->uniformMatrix4Array(
-            "lightSpaceMatrices", lightSpaceMatrices.size(), lightSpaceMatrices.data());
+    m_useClusteredLighting = flag;
+
+    if (m_useClusteredLighting)
+    {
+        if (!m_lightClusters)
+            m_lightClusters = LightClusters::create();
+
+        ShaderManager::instance()->loadClusteredBasicShader();
     }
+    else
+        ShaderManager::instance()->loadBasicShader();
+
+    this->refreshForProgram();
+    this->setupDefaultColors();
+    this->apply();
+}
+
+bool LightManager::useClusteredLighting() const
+{
+    return m_useClusteredLighting;
+}
+
+LightClustersPtr LightManager::lightClusters()
+{
+    if (!m_lightClusters)
+        m_lightClusters = LightClusters::create();
+
+    return m_lightClusters;
+}
+
+void LightManager::updateClusters()
+{
+    if (!m_useClusteredLighting)
+        return;
+
+    IVF_GL_SCOPE("LightClusters");
+
+    auto xfmMgr = TransformManager::instance();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    m_lightClusters->setLights(m_pointLights, m_spotLights);
+    m_lightClusters->assign(xfmMgr->viewMatrix(), xfmMgr->projectionMatrix());
+    m_lightClusters->upload();
+    m_lightClusters->bind(ShaderManager::instance()->currentProgram(),
+                          glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]));
+}
+
+namespace {
+
+// Check if a world-space region overlaps the volume rendered by a shadow cascade
+
+bool regionInCascade(const BoundingBox &region, const ShadowCascade &cascade)
+{
+    if (!region.isValid())
+        return false;
+
+    BoundingBox ndc = region.transform(cascade.lightSpaceMatrix);
+
+    return glm::all(glm::lessThanEqual(ndc.min(), glm::vec3(1.0f))) &&
+           glm::all(glm::greaterThanEqual(ndc.max(), glm::vec3(-1.0f)));
 }
 
+} // namespace
+
 void LightManager::renderShadowMaps(CompositeNodePtr scene)
 {
+    m_shadowPassesRendered = 0;
+    m_shadowPassesSkipped = 0;
+
     if (!m_useShadows)
         return;
 
+    IVF_GL_SCOPE("ShadowPass");
+
     this->apply();
 
+    // One traversal gives both the scene bounds and the regions where casters changed
+
+    m_casterTracker.update(scene);
+
+    BoundingBox sceneBBox = m_autoCalcBBox ? m_casterTracker.sceneBoundingBox() : m_sceneBBox;
+    const auto &dirtyRegions = m_casterTracker.dirtyRegions();
+
+    auto xfmMgr = TransformManager::instance();
+    glm::mat4 viewMatrix = xfmMgr->viewMatrix();
+    glm::mat4 projectionMatrix = xfmMgr->projectionMatrix();
+
     // Save current OpenGL state
 
     GLboolean depthTest;
@@ -260,6 +384,11 @@ void LightManager::renderShadowMaps(CompositeNodePtr scene)
     glGetIntegerv(GL_POLYGON_MODE, polygonMode);
     GLboolean cullFace;
     glGetBooleanv(GL_CULL_FACE, &cullFace);
+    GLboolean scissorTest;
+    glGetBooleanv(GL_SCISSOR_TEST, &scissorTest);
+
+    GLint previousViewport[4];
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
 
     // Set shadow rendering state
 
@@ -267,68 +396,66 @@ void LightManager::renderShadowMaps(CompositeNodePtr scene)
     glDepthFunc(GL_LESS); // Use default depth function
     glCullFace(GL_FRONT); // Can help with shadow acne (or try GL_BACK)
 
-    BoundingBox sceneBBox;
-
-    // Create an extent visitor to calculate scene bounds
-
-    if (m_autoCalcBBox)
-    {
-        ExtentVisitor extentVisitor;
-        scene->accept(&extentVisitor);
-    }
-    else
-    {
-        sceneBBox = m_sceneBBox;
-    }
-
     // Use the current shader (stock shader)
 
     ProgramPtr shader = ShaderManager::instance()->currentProgram();
 
-    // Save current OpenGL state
-
-    GLint previousViewport[4];
-    glGetIntegerv(GL_VIEWPORT, previousViewport);
-
     // For each shadow-casting light:
 
-    for (auto &light : m_dirLights)
+    for (auto i = 0; i < m_dirLights.size(); i++)
     {
-        if (!light->enabled() || !light->castsShadows() || !light->shadowMap())
-            continue;
+        auto &light = m_dirLights[i];
 
-        // Calculate the light space matrix with the current scene bbox
+        if (i >= MAX_SHADOW_LIGHTS || !light->enabled() || !light->castsShadows() || !light->shadowMap())
+        {
+            // Changes are not tracked for inactive lights, start over when they come back
 
-        glm::mat4 lightSpaceMatrix = light->calculateLightSpaceMatrix(sceneBBox);
-        light->shadowMap()->setLightSpaceMatrix(lightSpaceMatrix);
+            light->invalidateShadowCascades();
+            continue;
+        }
+
+        // Fit the cascades, marking refitted ones dirty
 
-        // Bind the shadow map's framebuffer
+        light->updateShadowCascades(viewMatrix, projectionMatrix, sceneBBox);
 
-        light->shadowMap()->bind();
+        for (auto &cascade : light->shadowCascades())
+        {
+            if (!m_shadowCaching || m_shadowsInvalid)
+                cascade.dirty = true;
 
-        // Clear the depth buffer
+            for (auto r = 0; r < dirtyRegions.size() && !cascade.dirty; r++)
+                cascade.dirty = regionInCascade(dirtyRegions[r], cascade);
 
-        glClear(GL_DEPTH_BUFFER_BIT);
+            if (!cascade.dirty)
+            {
+                m_shadowPassesSkipped++;
+                continue;
+            }
 
-        // Set shader to shadow pass mode
+            // Render the cascade into its region of the shadow map
 
-        shader->use();
-        shader->uniformBool("shadowPass", true);
-        shader->uniformMatrix4("lightSpaceMatrix", lightSpaceMatrix);
+            light->shadowMap()->bindRegion(cascade.viewport.x, cascade.viewport.y, cascade.viewport.z,
+                                           cascade.viewport.w);
 
-        // Render the scene
+            glClear(GL_DEPTH_BUFFER_BIT);
 
-        scene->draw();
+            shader->use();
+            shader->uniformBool("shadowPass", true);
+            shader->uniformMatrix4("lightSpaceMatrix", cascade.lightSpaceMatrix);
 
-        // Reset shader mode
+            scene->draw();
 
-        shader->uniformBool("shadowPass", false);
+            shader->uniformBool("shadowPass", false);
 
-        // Unbind the shadow map's framebuffer
+            cascade.dirty = false;
+            m_shadowPassesRendered++;
+        }
 
         light->shadowMap()->unbind();
     }
 
+    m_shadowsInvalid = false;
+
     // Restore viewport
 
     glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
@@ -350,6 +477,41 @@ void LightManager::renderShadowMaps(CompositeNodePtr scene)
         glEnable(GL_CULL_FACE);
     else
         glDisable(GL_CULL_FACE);
+
+    if (scissorTest)
+        glEnable(GL_SCISSOR_TEST);
+    else
+        glDisable(GL_SCISSOR_TEST);
+
+    // Upload the matrices of the cascades fitted this frame
+
+    this->applyShadowMaps();
+}
+
+void LightManager::setShadowCaching(bool flag)
+{
+    m_shadowCaching = flag;
+    m_shadowsInvalid = true;
+}
+
+bool LightManager::shadowCaching() const
+{
+    return m_shadowCaching;
+}
+
+void LightManager::invalidateShadowMaps()
+{
+    m_shadowsInvalid = true;
+}
+
+int LightManager::shadowPassesRendered() const
+{
+    return m_shadowPassesRendered;
+}
+
+int LightManager::shadowPassesSkipped() const
+{
+    return m_shadowPassesSkipped;
 }
 
 void ivf::LightManager::setDiffuseColor(glm::vec3 color)
@@ -414,6 +576,7 @@ void ivf::LightManager::setAlpha(float alpha)
 void ivf::LightManager::setUseShadows(bool flag)
 {
     m_useShadows = flag;
+    m_shadowsInvalid = true;
     ShaderManager::instance()->currentProgram()->uniformBool("useShadows", flag);
 }
 
@@ -425,6 +588,7 @@ bool ivf::LightManager::useShadows() const
 void ivf::LightManager::setAutoCalcBBox(bool flag)
 {
     m_autoCalcBBox = flag;
+    m_shadowsInvalid = true;
 }
 
 bool ivf::LightManager::autoCalcBBox() const
@@ -0,0 +1,35 @@
+#pragma once
+
+// Private header: read-only memory mapping of a file, used to read cache files without copying them.
+
+#include <cstddef>
+#include <string>
+
+namespace ivf {
+
+class MappedFile {
+private:
+    const unsigned char *m_data{nullptr}; // mapped file contents
+    size_t m_size{0};                     // file size in bytes
+#ifdef _WIN32
+    void *m_file{nullptr};    // file handle
+    void *m_mapping{nullptr}; // file mapping handle
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Map a file, replacing any earlier mapping. Returns false if the file cannot be mapped or is empty.
+    bool open(const std::string &filename);
+    void close();
+
+    const unsigned char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+};
+
+} // namespace ivf
@@ -1,5 +1,6 @@
 #include <ivf/mesh.h>
 
+#include <cstring>
 #include <memory>
 #include <iostream>
 
@@ -13,6 +14,8 @@
 using namespace ivf;
 using namespace std;
 
+thread_local bool Mesh::m_deferBuffers = false;
+
 glm::vec3 computeNormal(glm::vec3 const &a, glm::vec3 const &b, glm::vec3 const &c)
 {
     return glm::normalize(glm::cross(c - a, b - a));
@@ -86,6 +89,14 @@ void Mesh::setSize(GLuint vsize, GLuint isize)
     m_colorAttrId = -1;
     m_texCoordAttrId = -1;
 
+    // Looked up by createBuffers() when buffer creation is deferred
+
+    if (!m_deferBuffers)
+        this->setupAttribIds();
+}
+
+void Mesh::setupAttribIds()
+{
     this->setVertexAttrId(ShaderManager::instance()->currentProgram()->attribId("aPos"));
     this->setColorAttrId(ShaderManager::instance()->currentProgram()->attribId("aColor"));
     this->setNormalAttrId(ShaderManager::instance()->currentProgram()->attribId("aNormal"));
@@ -295,6 +306,40 @@ void Mesh::triQuad(GLdouble w, GLdouble h, GLdouble offset, GLdouble vx, GLdoubl
     this->vertex3d(p2);
 }
 
+void Mesh::setArrays(const GLfloat *verts, const GLfloat *normals, const GLfloat *texCoords, const GLfloat *colors,
+                     const GLuint *indices)
+{
+    if (verts != nullptr)
+    {
+        std::memcpy(m_verts->data(), verts, m_verts->memSize());
+        m_vertPos = m_verts->rows();
+    }
+
+    if (normals != nullptr)
+    {
+        std::memcpy(m_normals->data(), normals, m_normals->memSize());
+        m_normalPos = m_normals->rows();
+    }
+
+    if (texCoords != nullptr)
+    {
+        std::memcpy(m_texCoords->data(), texCoords, m_texCoords->memSize());
+        m_texCoordPos = m_texCoords->rows();
+    }
+
+    if (colors != nullptr)
+    {
+        std::memcpy(m_colors->data(), colors, m_colors->memSize());
+        m_colorPos = m_colors->rows();
+    }
+
+    if (indices != nullptr && m_indices != nullptr)
+    {
+        std::memcpy(m_indices->data(), indices, m_indices->memSize());
+        m_indexPos = m_indices->rows();
+    }
+}
+
 void Mesh::end()
 {
     // Compute actual gl arrays
@@ -324,6 +369,27 @@ void Mesh::end()
         }
     }
 
+    if (m_deferBuffers)
+    {
+        m_buffersPending = true;
+        return;
+    }
+
+    this->setupBuffers();
+}
+
+void Mesh::createBuffers()
+{
+    if (!m_buffersPending)
+        return;
+
+    this->setupAttribIds();
+    this->setupBuffers();
+    m_buffersPending = false;
+}
+
+void Mesh::setupBuffers()
+{
     GLenum err;
     ivf::clearError(); // flush any accumulated GL errors from before mesh setup
     m_VAO = std::make_unique<VertexArray>();
@@ -371,8 +437,28 @@ void Mesh::end()
     err = checkPrintError("Mesh", __FILE__, __LINE__);
 }
 
+bool Mesh::buffersPending() const
+{
+    return m_buffersPending;
+}
+
+void Mesh::setDeferBufferCreation(bool flag)
+{
+    m_deferBuffers = flag;
+}
+
+bool Mesh::deferBufferCreation()
+{
+    return m_deferBuffers;
+}
+
 void ivf::Mesh::updateVertices()
 {
+    // Pending buffers are created from the current data
+
+    if (m_buffersPending)
+        return;
+
     // m_VAO->bind();
     m_vertexVBO->updateArray(m_verts.get());
     // m_VAO->unbind();
@@ -397,6 +483,10 @@ void ivf::Mesh::updateNormals()
             m_normals->setNormal(m_indices->at(i, 1), norm);
             m_normals->setNormal(m_indices->at(i, 2), norm);
         }
+
+        if (m_buffersPending)
+            return;
+
         // m_VAO->bind();
         m_normalVBO->updateArray(m_normals.get());
         // m_VAO->unbind();
@@ -405,6 +495,9 @@ void ivf::Mesh::updateNormals()
 
 void Mesh::draw()
 {
+    if (m_buffersPending)
+        return;
+
     if (m_material != nullptr)
         m_material->apply();
 
@@ -460,6 +553,9 @@ void Mesh::draw()
 
 void ivf::Mesh::drawAsPrim(GLuint prim)
 {
+    if (m_buffersPending)
+        return;
+
     m_VAO->bind();
     glDrawArrays(prim, 0, m_glVerts->size());
     m_VAO->unbind();
@@ -520,6 +616,21 @@ std::shared_ptr<Indices> ivf::Mesh::indices()
     return m_indices;
 }
 
+std::shared_ptr<Colors> ivf::Mesh::colors()
+{
+    return m_colors;
+}
+
+std::shared_ptr<TexCoords> ivf::Mesh::texCoords()
+{
+    return m_texCoords;
+}
+
+GLuint ivf::Mesh::primType() const
+{
+    return m_primType;
+}
+
 ivf::MaterialPtr ivf::Mesh::material() const
 {
     return m_material;
@@ -0,0 +1,697 @@
+#include <ivf/model_cache.h>
+
+#include <ivf/logger.h>
+
+#include "mapped_file.h"
+#include "model_data.h"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace ivf;
+
+namespace {
+
+// Cache file layout, all values in native byte order:
+//
+//   FileHeader
+//   canonical path of the model file, padded to 8 bytes
+//   MaterialRecord[materialCount], NodeRecord[nodeCount], MeshRecord[meshCount]
+//   names (stringBytes), padded to 16 bytes
+//   vertex and index arrays, each aligned to 16 bytes
+//
+// Arrays are referenced by their file offset, 0 if absent. Bump formatVersion when the layout or
+// the way models are imported changes, so that older files are replaced.
+
+constexpr std::uint32_t formatVersion = 1;
+constexpr char fileMagic[8] = {'I', 'V', 'F', 'M', 'E', 'S', 'H', '\0'};
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+constexpr const char *fileExtension = ".ivfmesh";
+constexpr size_t blobAlignment = 16;
+constexpr std::uint32_t maxPathLength = 64 * 1024;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t importFlags;
+    std::uint32_t pathLength;
+    std::uint64_t sourceSize;
+    std::int64_t sourceTime;
+    std::uint32_t materialCount;
+    std::uint32_t nodeCount;
+    std::uint32_t meshCount;
+    std::uint32_t stringBytes;
+    std::uint64_t reserved;
+};
+
+struct MaterialRecord {
+    float diffuse[4];
+    float ambient[4];
+    float specular[4];
+    float shininess;
+    std::uint32_t reserved[3];
+};
+
+struct NodeRecord {
+    std::int32_t parent;
+    std::uint32_t composite;
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    float pos[3];
+    float scale[3];
+    float rotAxis[3];
+    float rotAngle;
+    std::uint32_t firstMesh;
+    std::uint32_t meshCount;
+};
+
+struct MeshRecord {
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t material;
+    std::uint32_t vertexCount;
+    std::uint32_t triangleCount;
+    std::uint32_t reserved;
+    std::uint64_t positions;
+    std::uint64_t normals;
+    std::uint64_t texCoords;
+    std::uint64_t colors;
+    std::uint64_t indices;
+};
+
+static_assert(sizeof(FileHeader) == 64);
+static_assert(sizeof(MaterialRecord) == 64);
+static_assert(sizeof(NodeRecord) == 64);
+static_assert(sizeof(MeshRecord) == 64);
+
+struct SourceInfo {
+    std::string canonical;
+    std::uint64_t size{0};
+    std::int64_t time{0};
+};
+
+enum class HeaderState {
+    Valid,
+    Stale,  // written for an older version of the model file
+    Invalid // not a cache file of this model and these flags
+};
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string canonicalPath(const std::string &filename)
+{
+    std::error_code error;
+    auto path = fs::weakly_canonical(fs::path(filename), error);
+
+    if (error)
+        return fs::path(filename).lexically_normal().generic_string();
+
+    return path.generic_string();
+}
+
+bool sourceInfo(const std::string &path, SourceInfo &info)
+{
+    std::error_code error;
+
+    info.size = fs::file_size(path, error);
+
+    if (error)
+        return false;
+
+    auto time = fs::last_write_time(path, error);
+
+    if (error)
+        return false;
+
+    info.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+    info.canonical = canonicalPath(path);
+    return true;
+}
+
+HeaderState checkHeader(const FileHeader &header, std::string_view storedPath, const SourceInfo &source,
+                        unsigned int importFlags)
+{
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 || header.version != formatVersion ||
+        header.byteOrder != byteOrderMark || header.importFlags != importFlags || storedPath != source.canonical)
+        return HeaderState::Invalid;
+
+    if (header.sourceSize != source.size || header.sourceTime != source.time)
+        return HeaderState::Stale;
+
+    return HeaderState::Valid;
+}
+
+// Cache files in a directory, listed before any is removed
+
+std::vector<fs::directory_entry> cacheFiles(const std::string &directory)
+{
+    std::vector<fs::directory_entry> files;
+    std::error_code error;
+
+    for (auto &entry : fs::directory_iterator(directory, error))
+    {
+        std::error_code typeError;
+
+        if (entry.is_regular_file(typeError) && entry.path().extension() == fileExtension)
+            files.push_back(entry);
+    }
+
+    return files;
+}
+
+// Bounds checked access to the mapped file
+
+class FileReader {
+private:
+    const unsigned char *m_data;
+    size_t m_size;
+
+public:
+    FileReader(const unsigned char *data, size_t size) : m_data(data), m_size(size)
+    {}
+
+    bool contains(std::uint64_t offset, std::uint64_t bytes) const
+    {
+        return offset <= m_size && bytes <= m_size - offset;
+    }
+
+    template <typename T> bool record(std::uint64_t offset, T &value) const
+    {
+        if (!this->contains(offset, sizeof(T)))
+            return false;
+
+        std::memcpy(&value, m_data + offset, sizeof(T));
+        return true;
+    }
+
+    // Array of count elements, empty and valid if offset is 0
+    template <typename T> bool array(std::uint64_t offset, std::uint64_t count, std::span<const T> &values) const
+    {
+        if (offset == 0)
+        {
+            values = {};
+            return true;
+        }
+
+        if (offset % alignof(T) != 0 || count > m_size / sizeof(T) || !this->contains(offset, count * sizeof(T)))
+            return false;
+
+        values = std::span<const T>(reinterpret_cast<const T *>(m_data + offset), count);
+        return true;
+    }
+};
+
+bool readString(std::string_view strings, std::uint32_t offset, std::uint32_t length, std::string &value)
+{
+    if (offset > strings.size() || length > strings.size() - offset)
+        return false;
+
+    value = strings.substr(offset, length);
+    return true;
+}
+
+bool readModel(const FileReader &reader, const FileHeader &header, size_t tableOffset, ModelData &data)
+{
+    size_t materialOffset = tableOffset;
+    size_t nodeOffset = materialOffset + size_t(header.materialCount) * sizeof(MaterialRecord);
+    size_t meshOffset = nodeOffset + size_t(header.nodeCount) * sizeof(NodeRecord);
+    size_t stringOffset = meshOffset + size_t(header.meshCount) * sizeof(MeshRecord);
+
+    if (header.nodeCount == 0 || !reader.contains(tableOffset, stringOffset - tableOffset + header.stringBytes))
+        return false;
+
+    std::span<const char> stringData;
+
+    if (!reader.array(stringOffset, header.stringBytes, stringData))
+        return false;
+
+    std::string_view strings(stringData.data(), stringData.size());
+
+    data.materials.resize(header.materialCount);
+
+    for (std::uint32_t i = 0; i < header.materialCount; i++)
+    {
+        MaterialRecord record;
+        reader.record(materialOffset + i * sizeof(MaterialRecord), record);
+
+        auto &material = data.materials[i];
+        std::memcpy(&material.diffuse, record.diffuse, sizeof(record.diffuse));
+        std::memcpy(&material.ambient, record.ambient, sizeof(record.ambient));
+        std::memcpy(&material.specular, record.specular, sizeof(record.specular));
+        material.shininess = record.shininess;
+    }
+
+    data.nodes.resize(header.nodeCount);
+
+    for (std::uint32_t i = 0; i < header.nodeCount; i++)
+    {
+        NodeRecord record;
+        reader.record(nodeOffset + i * sizeof(NodeRecord), record);
+
+        auto &node = data.nodes[i];
+
+        if (!readString(strings, record.nameOffset, record.nameLength, node.name))
+            return false;
+
+        // Parents must be earlier composites, the root the only node without parent
+
+        if (i == 0 ? (record.parent != -1 || !record.composite)
+                   : (record.parent < 0 || std::uint32_t(record.parent) >= i || !data.nodes[record.parent].composite))
+            return false;
+
+        if (std::uint64_t(record.firstMesh) + record.meshCount > header.meshCount)
+            return false;
+
+        node.parent = record.parent;
+        node.composite = record.composite != 0;
+        node.pos = glm::vec3(record.pos[0], record.pos[1], record.pos[2]);
+        node.scale = glm::vec3(record.scale[0], record.scale[1], record.scale[2]);
+        node.rotAxis = glm::vec3(record.rotAxis[0], record.rotAxis[1], record.rotAxis[2]);
+        node.rotAngle = record.rotAngle;
+        node.firstMesh = record.firstMesh;
+        node.meshCount = record.meshCount;
+    }
+
+    data.meshes.resize(header.meshCount);
+
+    for (std::uint32_t i = 0; i < header.meshCount; i++)
+    {
+        MeshRecord record;
+        reader.record(meshOffset + i * sizeof(MeshRecord), record);
+
+        auto &mesh = data.meshes[i];
+
+        if (!readString(strings, record.nameOffset, record.nameLength, mesh.name))
+            return false;
+
+        if (record.material != ModelMesh::noMaterial && record.material >= header.materialCount)
+            return false;
+
+        std::uint64_t vertices = record.vertexCount;
+
+        if ((vertices > 0 && record.positions == 0) || !reader.array(record.positions, vertices * 3, mesh.positions) ||
+            !reader.array(record.normals, vertices * 3, mesh.normals) ||
+            !reader.array(record.texCoords, vertices * 2, mesh.texCoords) ||
+            !reader.array(record.colors, vertices * 4, mesh.colors) ||
+            !reader.array(record.indices, std::uint64_t(record.triangleCount) * 3, mesh.indices))
+            return false;
+
+        // Out of range indices would make the GPU read past the vertex buffers
+
+        for (auto index : mesh.indices)
+            if (index >= record.vertexCount)
+                return false;
+
+        mesh.material = record.material;
+        mesh.vertexCount = record.vertexCount;
+        mesh.triangleCount = record.triangleCount;
+    }
+
+    return true;
+}
+
+} // namespace
+
+ModelCache *ModelCache::m_instance = nullptr;
+
+ModelCache::ModelCache()
+{}
+
+ModelCache::~ModelCache()
+{}
+
+ModelCache *ModelCache::instance()
+{
+    if (!m_instance)
+        m_instance = new ModelCache();
+
+    return m_instance;
+}
+
+ModelCache *ModelCache::create()
+{
+    return instance();
+}
+
+void ModelCache::drop()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+std::string ModelCache::filePrefix(const std::string &canonical) const
+{
+    // 64 bit FNV-1a of the canonical path
+
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (unsigned char c : canonical)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+
+    return std::format("{:016x}_", hash);
+}
+
+std::string ModelCache::cacheFile(const std::string &canonical, unsigned int importFlags) const
+{
+    auto name = std::format("{}{:08x}{}", this->filePrefix(canonical), importFlags, fileExtension);
+    return (fs::path(m_directory) / name).string();
+}
+
+bool ModelCache::read(const std::string &path, unsigned int importFlags, ModelData &data)
+{
+    SourceInfo source;
+
+    if (!sourceInfo(path, source))
+    {
+        m_stats.misses++;
+        return false;
+    }
+
+    auto filename = this->cacheFile(source.canonical, importFlags);
+    auto mapping = std::make_shared<MappedFile>();
+
+    if (!mapping->open(filename))
+    {
+        m_stats.misses++;
+        return false;
+    }
+
+    FileReader reader(mapping->data(), mapping->size());
+    FileHeader header;
+    std::span<const char> storedPath;
+
+    if (!reader.record(0, header) || header.pathLength > maxPathLength ||
+        !reader.array(sizeof(FileHeader), header.pathLength, storedPath))
+    {
+        logWarningfc("ModelCache", "Ignoring invalid cache file {}", filename);
+        m_stats.misses++;
+        return false;
+    }
+
+    auto state = checkHeader(header, std::string_view(storedPath.data(), storedPath.size()), source, importFlags);
+
+    if (state != HeaderState::Valid)
+    {
+        if (state == HeaderState::Stale)
+        {
+            logInfofc("ModelCache", "Cache file of {} is out of date", path);
+            m_stats.stale++;
+        }
+
+        m_stats.misses++;
+        return false;
+    }
+
+    ModelData model;
+
+    if (!readModel(reader, header, alignUp(sizeof(FileHeader) + header.pathLength, 8), model))
+    {
+        logWarningfc("ModelCache", "Ignoring corrupt cache file {}", filename);
+        m_stats.misses++;
+        return false;
+    }
+
+    model.mapping = mapping;
+    data = std::move(model);
+
+    m_stats.hits++;
+    m_stats.bytesMapped += mapping->size();
+    return true;
+}
+
+bool ModelCache::write(const std::string &path, unsigned int importFlags, const ModelData &data)
+{
+    SourceInfo source;
+
+    if (!sourceInfo(path, source))
+        return false;
+
+    // Layout
+
+    std::string strings;
+
+    auto addString = [&strings](const std::string &value, std::uint32_t &offset, std::uint32_t &length) {
+        offset = static_cast<std::uint32_t>(strings.size());
+        length = static_cast<std::uint32_t>(value.size());
+        strings += value;
+    };
+
+    std::vector<NodeRecord> nodes(data.nodes.size());
+    std::vector<MeshRecord> meshes(data.meshes.size());
+    std::vector<MaterialRecord> materials(data.materials.size());
+
+    for (size_t i = 0; i < data.nodes.size(); i++)
+    {
+        auto &node = data.nodes[i];
+        auto &record = nodes[i];
+
+        record = {};
+        addString(node.name, record.nameOffset, record.nameLength);
+        record.parent = node.parent;
+        record.composite = node.composite ? 1 : 0;
+        std::memcpy(record.pos, &node.pos, sizeof(record.pos));
+        std::memcpy(record.scale, &node.scale, sizeof(record.scale));
+        std::memcpy(record.rotAxis, &node.rotAxis, sizeof(record.rotAxis));
+        record.rotAngle = node.rotAngle;
+        record.firstMesh = node.firstMesh;
+        record.meshCount = node.meshCount;
+    }
+
+    for (size_t i = 0; i < data.materials.size(); i++)
+    {
+        auto &material = data.materials[i];
+        auto &record = materials[i];
+
+        record = {};
+        std::memcpy(record.diffuse, &material.diffuse, sizeof(record.diffuse));
+        std::memcpy(record.ambient, &material.ambient, sizeof(record.ambient));
+        std::memcpy(record.specular, &material.specular, sizeof(record.specular));
+        record.shininess = material.shininess;
+    }
+
+    size_t tableOffset = alignUp(sizeof(FileHeader) + source.canonical.size(), 8);
+    size_t tableBytes = materials.size() * sizeof(MaterialRecord) + nodes.size() * sizeof(NodeRecord) +
+                        meshes.size() * sizeof(MeshRecord);
+
+    for (size_t i = 0; i < data.meshes.size(); i++)
+        addString(data.meshes[i].name, meshes[i].nameOffset, meshes[i].nameLength);
+
+    size_t fileSize = alignUp(tableOffset + tableBytes + strings.size(), blobAlignment);
+
+    auto placeBlob = [&fileSize](size_t bytes) -> std::uint64_t {
+        if (bytes == 0)
+            return 0;
+
+        std::uint64_t offset = fileSize;
+        fileSize = alignUp(fileSize + bytes, blobAlignment);
+        return offset;
+    };
+
+    for (size_t i = 0; i < data.meshes.size(); i++)
+    {
+        auto &mesh = data.meshes[i];
+        auto &record = meshes[i];
+
+        record.material = mesh.material;
+        record.vertexCount = mesh.vertexCount;
+        record.triangleCount = mesh.triangleCount;
+        record.reserved = 0;
+        record.positions = placeBlob(mesh.positions.size_bytes());
+        record.normals = placeBlob(mesh.normals.size_bytes());
+        record.texCoords = placeBlob(mesh.texCoords.size_bytes());
+        record.colors = placeBlob(mesh.colors.size_bytes());
+        record.indices = placeBlob(mesh.indices.size_bytes());
+    }
+
+    // Contents
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    header.importFlags = importFlags;
+    header.pathLength = static_cast<std::uint32_t>(source.canonical.size());
+    header.sourceSize = source.size;
+    header.sourceTime = source.time;
+    header.materialCount = static_cast<std::uint32_t>(materials.size());
+    header.nodeCount = static_cast<std::uint32_t>(nodes.size());
+    header.meshCount = static_cast<std::uint32_t>(meshes.size());
+    header.stringBytes = static_cast<std::uint32_t>(strings.size());
+
+    std::vector<unsigned char> buffer(fileSize);
+    auto bytes = buffer.data();
+    size_t offset = tableOffset;
+
+    std::memcpy(bytes, &header, sizeof(header));
+    std::memcpy(bytes + sizeof(header), source.canonical.data(), source.canonical.size());
+
+    std::memcpy(bytes + offset, materials.data(), materials.size() * sizeof(MaterialRecord));
+    offset += materials.size() * sizeof(MaterialRecord);
+    std::memcpy(bytes + offset, nodes.data(), nodes.size() * sizeof(NodeRecord));
+    offset += nodes.size() * sizeof(NodeRecord);
+    std::memcpy(bytes + offset, meshes.data(), meshes.size() * sizeof(MeshRecord));
+    offset += meshes.size() * sizeof(MeshRecord);
+    std::memcpy(bytes + offset, strings.data(), strings.size());
+
+    auto copyBlob = [bytes](std::uint64_t blobOffset, auto values) {
+        if (blobOffset != 0)
+            std::memcpy(bytes + blobOffset, values.data(), values.size_bytes());
+    };
+
+    for (size_t i = 0; i < data.meshes.size(); i++)
+    {
+        copyBlob(meshes[i].positions, data.meshes[i].positions);
+        copyBlob(meshes[i].normals, data.meshes[i].normals);
+        copyBlob(meshes[i].texCoords, data.meshes[i].texCoords);
+        copyBlob(meshes[i].colors, data.meshes[i].colors);
+        copyBlob(meshes[i].indices, data.meshes[i].indices);
+    }
+
+    // Written to a temporary file and renamed, so that an interrupted write leaves no partial file
+
+    auto filename = this->cacheFile(source.canonical, importFlags);
+    auto temporary = filename + ".tmp";
+    std::error_code error;
+
+    fs::create_directories(m_directory, error);
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(bytes), static_cast<std::streamsize>(buffer.size()));
+
+        if (!file)
+            error = std::make_error_code(std::errc::io_error);
+    }
+
+    if (!error)
+        fs::rename(temporary, filename, error);
+
+    if (error)
+    {
+        fs::remove(temporary, error);
+
+        if (!m_writeWarned)
+        {
+            logWarningfc("ModelCache", "Cannot write cache files to {}, models are imported on every load",
+                         m_directory);
+            m_writeWarned = true;
+        }
+
+        return false;
+    }
+
+    m_stats.writes++;
+    m_stats.bytesWritten += buffer.size();
+    return true;
+}
+
+void ModelCache::setEnabled(bool flag)
+{
+    m_enabled = flag;
+}
+
+bool ModelCache::enabled() const
+{
+    return m_enabled;
+}
+
+void ModelCache::setDirectory(const std::string &directory)
+{
+    m_directory = directory;
+    m_writeWarned = false;
+}
+
+const std::string &ModelCache::directory() const
+{
+    return m_directory;
+}
+
+bool ModelCache::isCached(const std::string &path, unsigned int importFlags) const
+{
+    SourceInfo source;
+
+    if (!sourceInfo(path, source))
+        return false;
+
+    std::ifstream file(this->cacheFile(source.canonical, importFlags), std::ios::binary);
+    FileHeader header;
+
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.pathLength > maxPathLength)
+        return false;
+
+    std::string storedPath(header.pathLength, '\0');
+
+    if (!file.read(storedPath.data(), header.pathLength))
+        return false;
+
+    return checkHeader(header, storedPath, source, importFlags) == HeaderState::Valid;
+}
+
+size_t ModelCache::invalidate(const std::string &path)
+{
+    auto prefix = this->filePrefix(canonicalPath(path));
+    size_t removed = 0;
+
+    for (auto &entry : cacheFiles(m_directory))
+    {
+        std::error_code error;
+
+        if (entry.path().filename().string().starts_with(prefix) && fs::remove(entry.path(), error))
+            removed++;
+    }
+
+    m_stats.invalidations += removed;
+    return removed;
+}
+
+size_t ModelCache::clear()
+{
+    size_t removed = 0;
+
+    for (auto &entry : cacheFiles(m_directory))
+    {
+        std::error_code error;
+
+        if (fs::remove(entry.path(), error))
+            removed++;
+    }
+
+    m_stats.invalidations += removed;
+    return removed;
+}
+
+size_t ModelCache::diskUsage() const
+{
+    size_t bytes = 0;
+
+    for (auto &entry : cacheFiles(m_directory))
+    {
+        std::error_code error;
+        auto size = entry.file_size(error);
+
+        if (!error)
+            bytes += static_cast<size_t>(size);
+    }
+
+    return bytes;
+}
+
+const ModelCacheStats &ModelCache::stats() const
+{
+    return m_stats;
+}
+
+void ModelCache::resetStats()
+{
+    m_stats = {};
+}
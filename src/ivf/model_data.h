@@ -0,0 +1,78 @@
+#pragma once
+
+// Private header: imported model in a flat, renderer independent form, produced by ModelLoader from
+// an assimp scene or read from a ModelCache file and turned into nodes by ModelLoader.
+
+#include "mapped_file.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ivf {
+
+struct ModelMaterial {
+    glm::vec4 diffuse{1.0f};
+    glm::vec4 ambient{0.2f, 0.2f, 0.2f, 1.0f};
+    glm::vec4 specular{1.0f};
+    float shininess{32.0f};
+};
+
+// Node of the hierarchy. Parents precede their children and nodes are listed in the order they are
+// added to their parent; nodes[0] is the root composite.
+
+struct ModelNode {
+    std::string name;
+    std::int32_t parent{-1}; // index of the parent composite, -1 for the root
+    bool composite{true};    // CompositeNode, or MeshNode holding meshCount meshes
+    glm::vec3 pos{0.0f};
+    glm::vec3 scale{1.0f};
+    glm::vec3 rotAxis{1.0f, 0.0f, 0.0f};
+    float rotAngle{0.0f}; // degrees, 0 if the node is not rotated
+    std::uint32_t firstMesh{0};
+    std::uint32_t meshCount{0};
+};
+
+// Triangle mesh with tightly packed attributes. The spans point into the owned storage of an
+// imported mesh or into the mapping of a cache file. Absent attributes are empty: normals are then
+// generated and colors default to white.
+
+struct ModelMesh {
+    static constexpr std::uint32_t noMaterial = std::numeric_limits<std::uint32_t>::max();
+
+    std::string name;
+    std::uint32_t material{noMaterial};
+    std::uint32_t vertexCount{0};
+    std::uint32_t triangleCount{0};
+
+    std::span<const float> positions;       // 3 per vertex
+    std::span<const float> normals;         // 3 per vertex
+    std::span<const float> texCoords;       // 2 per vertex
+    std::span<const float> colors;          // 4 per vertex
+    std::span<const std::uint32_t> indices; // 3 per triangle
+
+    std::vector<float> storage;              // attributes of imported meshes
+    std::vector<std::uint32_t> indexStorage; // indices of imported meshes
+
+    ModelMesh() = default;
+    ModelMesh(ModelMesh &&) = default;
+    ModelMesh &operator=(ModelMesh &&) = default;
+
+    // The spans refer to the storage, so copies would dangle
+    ModelMesh(const ModelMesh &) = delete;
+    ModelMesh &operator=(const ModelMesh &) = delete;
+};
+
+struct ModelData {
+    std::vector<ModelNode> nodes;
+    std::vector<ModelMesh> meshes;
+    std::vector<ModelMaterial> materials;
+    std::shared_ptr<MappedFile> mapping; // cache file the mesh spans point into, if any
+};
+
+} // namespace ivf
@@ -1,17 +1,48 @@
 #include <ivf/model_loader.h>
 #include <ivf/composite_node.h>
+#include <ivf/model_cache.h>
 #include <ivf/logger.h>
+#include <ivf/thread_pool.h>
+
+#include "model_data.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <chrono>
 #include <stdexcept>
-#include <iostream>
-#include <iomanip>
 
 using namespace ivf;
 
-void ModelLoader::processNode(const aiScene *scene, aiNode *node, std::shared_ptr<CompositeNode> compNode,
-                              aiMatrix4x4 parentTransform)
+namespace {
+
+// Vertices and faces per parallel block when converting large meshes
+constexpr size_t vertexGrain = 16 * 1024;
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+ModelLoadTimings ModelLoader::m_lastTimings;
+
+unsigned int ModelLoader::countMeshes(const aiNode *node, std::unordered_map<const aiNode *, unsigned int> &counts)
+{
+    // Meshes in the node and all its descendants, computed once per node
+
+    unsigned int count = node->mNumMeshes;
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+        count += countMeshes(node->mChildren[i], counts);
+
+    counts[node] = count;
+    return count;
+}
+
+void ModelLoader::processNode(const aiScene *scene, const aiNode *node, int parent, aiMatrix4x4 parentTransform,
+                              const std::unordered_map<const aiNode *, unsigned int> &subtreeMeshes, ModelData &data,
+                              std::vector<const aiMesh *> &sources)
 {
     // Combine with parent transformation
     aiMatrix4x4 nodeTransform = parentTransform * node->mTransformation;
@@ -21,17 +52,19 @@ void ModelLoader::processNode(const aiScene *scene, aiNode *node, std::shared_pt
     aiQuaternion rotation;
     nodeTransform.Decompose(scaling, rotation, translation);
 
-    logInfofc("ModelLoader",
-               "Processing node: %s | Translation: (%.2f, %.2f, %.2f) | Scale: (%.2f, %.2f, %.2f)",
+    logDebugfc("ModelLoader",
+               "Processing node: {} | Translation: ({:.2f}, {:.2f}, {:.2f}) | Scale: ({:.2f}, {:.2f}, {:.2f})",
                node->mName.C_Str(), translation.x, translation.y, translation.z, scaling.x, scaling.y, scaling.z);
 
-    // Process meshes in current node
+    // Meshes in current node, converted later in parallel
     if (node->mNumMeshes > 0)
     {
-        auto meshNode = MeshNode::create();
-        meshNode->setName(node->mName.C_Str());
-        meshNode->setPos(glm::vec3(translation.x, translation.y, translation.z));
-        meshNode->setScale(glm::vec3(scaling.x, scaling.y, scaling.z));
+        ModelNode meshNode;
+        meshNode.name = node->mName.C_Str();
+        meshNode.parent = parent;
+        meshNode.composite = false;
+        meshNode.pos = glm::vec3(translation.x, translation.y, translation.z);
+        meshNode.scale = glm::vec3(scaling.x, scaling.y, scaling.z);
 
         float angle = 2.0f * acos(rotation.w);
         glm::vec3 axis;
@@ -48,63 +81,51 @@ void ModelLoader::processNode(const aiScene *scene, aiNode *node, std::shared_pt
 
         if (angle > 0.001f)
         {
-            meshNode->setRotAxis(axis);
-            meshNode->setRotAngle(glm::degrees(angle));
+            meshNode.rotAxis = axis;
+            meshNode.rotAngle = glm::degrees(angle);
         }
 
+        meshNode.firstMesh = static_cast<std::uint32_t>(sources.size());
+        meshNode.meshCount = node->mNumMeshes;
+        data.nodes.push_back(meshNode);
+
         for (unsigned int i = 0; i < node->mNumMeshes; i++)
-        {
-            aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-            processAiMesh(scene, mesh, meshNode);
-        }
-        compNode->add(meshNode);
+            sources.push_back(scene->mMeshes[node->mMeshes[i]]);
     }
 
     // Process child nodes
     for (unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        aiNode *childNode = node->mChildren[i];
-
-        // Count total meshes in this child and all its descendants
-        std::function<int(aiNode *)> countMeshes = [&](aiNode *n) -> int {
-            int count = n->mNumMeshes;
-            for (unsigned int j = 0; j < n->mNumChildren; j++)
-            {
-                count += countMeshes(n->mChildren[j]);
-            }
-            return count;
-        };
-
-        int totalMeshesInChild = countMeshes(childNode);
+        const aiNode *childNode = node->mChildren[i];
 
-        if (totalMeshesInChild <= 1)
+        if (subtreeMeshes.at(childNode) <= 1)
         {
             // Child has 0 or 1 mesh - process directly into current composite (no intermediate composite)
-            processNode(scene, childNode, compNode, nodeTransform);
+            processNode(scene, childNode, parent, nodeTransform, subtreeMeshes, data, sources);
         }
         else
         {
             // Child has multiple meshes - create a composite for it
-            std::shared_ptr<CompositeNode> childCompNode = CompositeNode::create();
-            childCompNode->setName(std::string(childNode->mName.C_Str()));
-            compNode->add(childCompNode);
-            processNode(scene, childNode, childCompNode, nodeTransform);
+            ModelNode childCompNode;
+            childCompNode.name = childNode->mName.C_Str();
+            childCompNode.parent = parent;
+            data.nodes.push_back(childCompNode);
+            processNode(scene, childNode, static_cast<int>(data.nodes.size() - 1), nodeTransform, subtreeMeshes, data,
+                        sources);
         }
     }
 }
-void ModelLoader::processAiMesh(const aiScene *scene, aiMesh *aiMesh, std::shared_ptr<MeshNode> meshNode)
+
+void ModelLoader::processAiMesh(const aiScene *scene, const aiMesh *aiMesh, ModelMesh &mesh)
 {
-    logInfo("Processing aiMesh...", "ModelLoader");
-    logInfofc("ModelLoader", "  Mesh name: {}", aiMesh->mName.C_Str());
-    logInfofc("ModelLoader", "  Material index: {}", aiMesh->mMaterialIndex);
-    logInfofc("ModelLoader", "  Vertices: {}", aiMesh->mNumVertices);
-    logInfofc("ModelLoader", "  Faces: {}", aiMesh->mNumFaces);
+    // Runs on worker threads: no logging and no GL calls
 
     // Count triangles
     unsigned int triangleCount = 0;
+    bool trianglesOnly = true;
     for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
     {
-        aiFace face = aiMesh->mFaces[i];
+        const aiFace &face = aiMesh->mFaces[i];
         if (face.mNumIndices == 3)
         {
             triangleCount++;
@@ -117,149 +138,141 @@ void ModelLoader::processAiMesh(const aiScene *scene, aiMesh *aiMesh, std::share
         {
             triangleCount += (face.mNumIndices - 2);
         }
-    }
-
-    logInfofc("ModelLoader", "  Original face count: {}", aiMesh->mNumFaces);
-    logInfofc("ModelLoader", "  Triangle count after conversion: {}", triangleCount);
 
-    // Create mesh
-    meshNode->newMesh(aiMesh->mNumVertices, triangleCount);
-    auto mesh = meshNode->currentMesh();
-
-    if (!mesh)
-    {
-        logError("Failed to create mesh!", "ModelLoader");
-        return;
+        trianglesOnly = trianglesOnly && face.mNumIndices == 3;
     }
 
-    // Handle normal generation based on file format and existing normals
-    bool useAssimpNormals = aiMesh->HasNormals(); // Use original normals except for 3DS
+    // Use original normals if present, otherwise the Mesh generates them
+    bool useAssimpNormals = aiMesh->HasNormals();
+    bool hasTexCoords = aiMesh->HasTextureCoords(0);
+    bool hasColors = aiMesh->HasVertexColors(0);
 
-    mesh->setGenerateNormals(!useAssimpNormals);
+    // Tightly packed attribute arrays: positions, then normals, texture coordinates and colors if
+    // present. Rows of faces that are not triangles stay zero, as with a partially filled Mesh.
 
-    if (useAssimpNormals)
-    {
-        logInfo("  Using original normals from file", "ModelLoader");
-    }
-    else
-    {
-        logInfo("  No normals found or regenerating normals", "ModelLoader");
-    }
+    mesh.name = aiMesh->mName.C_Str();
+    mesh.vertexCount = aiMesh->mNumVertices;
+    mesh.triangleCount = triangleCount;
 
-    mesh->begin(GL_TRIANGLES);
+    if (aiMesh->mMaterialIndex < scene->mNumMaterials)
+        mesh.material = aiMesh->mMaterialIndex;
 
-    // Process vertices
-    for (unsigned int i = 0; i < aiMesh->mNumVertices; i++)
-    {
-        mesh->vertex3f(aiMesh->mVertices[i].x, aiMesh->mVertices[i].y, aiMesh->mVertices[i].z);
+    size_t n = aiMesh->mNumVertices;
 
-        if (aiMesh->HasNormals())
-        {
-            glm::vec3 normal(aiMesh->mNormals[i].x, aiMesh->mNormals[i].y, aiMesh->mNormals[i].z);
+    mesh.storage.resize(n * (3 + (useAssimpNormals ? 3 : 0) + (hasTexCoords ? 2 : 0) + (hasColors ? 4 : 0)));
+    mesh.indexStorage.resize(size_t(triangleCount) * 3);
 
-            // Test both directions:
-            mesh->normal3f(normal.x, normal.y, normal.z); // Original
-            // mesh->normal3f(-normal.x, -normal.y, -normal.z); // Flipped        }
-        }
-        if (aiMesh->HasTextureCoords(0))
-        {
-            mesh->tex2f(aiMesh->mTextureCoords[0][i].x, aiMesh->mTextureCoords[0][i].y);
-        }
+    float *positions = mesh.storage.data();
+    float *normals = positions + n * 3;
+    float *texCoords = normals + (useAssimpNormals ? n * 3 : 0);
+    float *colors = texCoords + (hasTexCoords ? n * 2 : 0);
 
-        if (aiMesh->HasVertexColors(0))
-        {
-            mesh->color4f(aiMesh->mColors[0][i].r, aiMesh->mColors[0][i].g, aiMesh->mColors[0][i].b,
-                          aiMesh->mColors[0][i].a);
-        }
-        else
-        {
-            mesh->color4f(1.0f, 1.0f, 1.0f, 1.0f);
-        }
-    }
-
-    // Process faces with adaptive winding order
-    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
-    {
-        aiFace face = aiMesh->mFaces[i];
-
-        if (face.mNumIndices == 3)
-        {
-            // Get vertices and calculate face normal
-            aiVector3D v0 = aiMesh->mVertices[face.mIndices[0]];
-            aiVector3D v1 = aiMesh->mVertices[face.mIndices[1]];
-            aiVector3D v2 = aiMesh->mVertices[face.mIndices[2]];
-
-            // Calculate face normal using cross product
-            aiVector3D edge1 = v1 - v0;
-            aiVector3D edge2 = v2 - v0;
-            aiVector3D faceNormal = edge1 ^ edge2; // Cross product
-            faceNormal.Normalize();
-
-            // Get vertex normal (if available)
-            if (aiMesh->HasNormals())
+    // Process vertices
+    ThreadPool::instance()->parallelFor(
+        0, n,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
             {
-                aiVector3D vertexNormal = aiMesh->mNormals[face.mIndices[0]];
+                positions[i * 3] = aiMesh->mVertices[i].x;
+                positions[i * 3 + 1] = aiMesh->mVertices[i].y;
+                positions[i * 3 + 2] = aiMesh->mVertices[i].z;
 
-                // Check if face normal and vertex normal agree
-                float dot = faceNormal * vertexNormal; // Dot product
+                if (useAssimpNormals)
+                {
+                    normals[i * 3] = aiMesh->mNormals[i].x;
+                    normals[i * 3 + 1] = aiMesh->mNormals[i].y;
+                    normals[i * 3 + 2] = aiMesh->mNormals[i].z;
+                }
 
-                if (dot > 0)
+                if (hasTexCoords)
                 {
-                    // Normals agree - use original winding
-                    mesh->index3i(face.mIndices[0], face.mIndices[1], face.mIndices[2]);
+                    texCoords[i * 2] = aiMesh->mTextureCoords[0][i].x;
+                    texCoords[i * 2 + 1] = aiMesh->mTextureCoords[0][i].y;
                 }
-                else
+
+                if (hasColors)
                 {
-                    // Normals disagree - flip winding
-                    mesh->index3i(face.mIndices[2], face.mIndices[1], face.mIndices[0]);
+                    colors[i * 4] = aiMesh->mColors[0][i].r;
+                    colors[i * 4 + 1] = aiMesh->mColors[0][i].g;
+                    colors[i * 4 + 2] = aiMesh->mColors[0][i].b;
+                    colors[i * 4 + 3] = aiMesh->mColors[0][i].a;
                 }
             }
-            else
-            {
-                // No vertex normals - use your current global flip
-                mesh->index3i(face.mIndices[2], face.mIndices[1], face.mIndices[0]);
-            }
+        },
+        vertexGrain);
+
+    // Process faces with adaptive winding order
+    std::uint32_t *indices = mesh.indexStorage.data();
+
+    auto processFace = [&](const aiFace &face, std::uint32_t *row) {
+        // Get vertices and calculate face normal
+        aiVector3D v0 = aiMesh->mVertices[face.mIndices[0]];
+        aiVector3D v1 = aiMesh->mVertices[face.mIndices[1]];
+        aiVector3D v2 = aiMesh->mVertices[face.mIndices[2]];
+
+        // Calculate face normal using cross product
+        aiVector3D edge1 = v1 - v0;
+        aiVector3D edge2 = v2 - v0;
+        aiVector3D faceNormal = edge1 ^ edge2; // Cross product
+        faceNormal.Normalize();
+
+        bool flip = true; // No vertex normals - use the global flip
+
+        // Get vertex normal (if available)
+        if (useAssimpNormals)
+        {
+            aiVector3D vertexNormal = aiMesh->mNormals[face.mIndices[0]];
+
+            // Check if face normal and vertex normal agree, flip winding if they disagree
+            float dot = faceNormal * vertexNormal; // Dot product
+            flip = dot <= 0;
         }
-    }
 
-    mesh->end();
+        row[0] = face.mIndices[flip ? 2 : 0];
+        row[1] = face.mIndices[1];
+        row[2] = face.mIndices[flip ? 0 : 2];
+    };
 
-    // Update bounding box after mesh creation
-    meshNode->updateBoundingBox();
-    
-    // Debug: Print local bounding box information
-    auto localBbox = meshNode->localBoundingBox();
-    if (localBbox.isValid())
+    if (trianglesOnly)
     {
-        logInfo("  Local bounding box:", "ModelLoader");
-        logInfofc("ModelLoader", "    Min: ({}, {}, {})", localBbox.min().x, localBbox.min().y, localBbox.min().z);
-        logInfofc("ModelLoader", "    Max: ({}, {}, {})", localBbox.max().x, localBbox.max().y, localBbox.max().z);
-        logInfofc("ModelLoader", "    Size: ({}, {}, {})", localBbox.size().x, localBbox.size().y, localBbox.size().z);
+        // Face i fills index row i, so blocks of faces are independent
+        ThreadPool::instance()->parallelFor(
+            0, aiMesh->mNumFaces,
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    processFace(aiMesh->mFaces[i], indices + i * 3);
+            },
+            vertexGrain);
     }
     else
     {
-        logWarning("  Local bounding box is invalid!", "ModelLoader");
-    }
+        size_t indexPos = 0;
 
-    // Process materials (simplified to avoid potential issues)
-    if (aiMesh->mMaterialIndex >= 0)
-    {
-        try
+        for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
         {
-            aiMaterial *aiMat = scene->mMaterials[aiMesh->mMaterialIndex];
-            processMaterial(aiMat, meshNode);
-            // meshNode->setShowNormals(true, 0.1f); // Enable normal visualization with a length of 0.1
-        } catch (const std::exception &e)
-        {
-            logWarningfc("ModelLoader", "Failed to process material: {}", e.what());
+            if (aiMesh->mFaces[i].mNumIndices == 3)
+            {
+                processFace(aiMesh->mFaces[i], indices + indexPos);
+                indexPos += 3;
+            }
         }
     }
 
-    logInfofc("ModelLoader", "  Mesh processed successfully with {} vertices and {} indices.", mesh->vertPos(),
-              mesh->indexPos());
+    mesh.positions = std::span<const float>(positions, n * 3);
+
+    if (useAssimpNormals)
+        mesh.normals = std::span<const float>(normals, n * 3);
+
+    if (hasTexCoords)
+        mesh.texCoords = std::span<const float>(texCoords, n * 2);
+
+    if (hasColors)
+        mesh.colors = std::span<const float>(colors, n * 4);
+
+    mesh.indices = mesh.indexStorage;
 }
 
-void ModelLoader::processMaterial(aiMaterial *aiMat, std::shared_ptr<MeshNode> node)
+void ModelLoader::processMaterial(const aiMaterial *aiMat, ModelMaterial &material)
 {
     aiColor3D diffuse(1.0f, 1.0f, 1.0f);
     aiColor3D ambient(0.2f, 0.2f, 0.2f);
@@ -273,132 +286,229 @@ void ModelLoader::processMaterial(aiMaterial *aiMat, std::shared_ptr<MeshNode> n
     aiMat->Get(AI_MATKEY_SHININESS, shininess);
     aiMat->Get(AI_MATKEY_OPACITY, opacity);
 
-    // Debug output with higher precision
+    material.diffuse = glm::vec4(diffuse.r, diffuse.g, diffuse.b, opacity);
+    material.ambient = glm::vec4(ambient.r, ambient.g, ambient.b, opacity);
+    material.specular = glm::vec4(specular.r, specular.g, specular.b, opacity);
+    material.shininess = shininess;
+}
 
-    logInfofc("ModelLoader",
-               "Material - Diffuse: ({:.6f}, {:.6f}, {:.6f}), Opacity: {:.6f}", diffuse.r, diffuse.g,
-              diffuse.b, opacity);
+void ModelLoader::importModel(const std::string &path, unsigned int importFlags, ModelData &data)
+{
+    auto &timings = m_lastTimings;
+    auto start = std::chrono::steady_clock::now();
+
+    Assimp::Importer importer;
+
+    importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f);
 
-    logInfofc("ModelLoader", "  Ambient: ({:.6f}, {:.6f}, {:.6f})", ambient.r, ambient.g, ambient.b);
-    logInfofc("ModelLoader", "  Specular: ({:.6f}, {:.6f}, {:.6f})", specular.r, specular.g, specular.b);
-    logInfofc("ModelLoader", "  Shininess: {:.6f}", shininess);
-    logInfofc("ModelLoader", "  Opacity: {:.6f}", opacity);
+    const aiScene *scene = importer.ReadFile(path, importFlags);
 
-    try
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
-        auto material = node->material();
-        if (!material)
-        {
-            material = Material::create();
-            /*
-            material->setDiffuseColor(glm::vec4(0.6, 0.6, 0.6, 1.0));
-            material->setSpecularColor(glm::vec4(1.0, 1.0, 1.0, 1.0));
-            material->setAmbientColor(glm::vec4(0.2, 0.2, 0.2, 1.0));
-            */
-            node->setMaterial(material);
-        }
+        throw std::runtime_error("Failed to load model '" + path + "': " + std::string(importer.GetErrorString()));
+    }
 
-        if (material)
-        {
-            // Ensure full precision colors
-            glm::vec4 diffuseColor(diffuse.r, diffuse.g, diffuse.b, opacity);
-            glm::vec4 ambientColor(ambient.r, ambient.g, ambient.b, opacity);
-            glm::vec4 specularColor(specular.r, specular.g, specular.b, opacity);
+    timings.readSeconds = secondsSince(start);
 
-            material->setDiffuseColor(diffuseColor);
-            material->setAmbientColor(ambientColor);
-            material->setSpecularColor(specularColor);
-            material->setShininess(shininess);
+    logInfofc("ModelLoader", "Successfully loaded model: {}", path);
+    logInfofc("ModelLoader", "  Meshes: {}", scene->mNumMeshes);
+    logInfofc("ModelLoader", "  Materials: {}", scene->mNumMaterials);
 
-            // Ensure material is properly enabled
-            // Debug: Check if colors are being clamped or quantized
+    // Flatten the hierarchy into nodes and a list of the meshes to convert
 
-            logInfofc("ModelLoader", "  Set diffuse: ({:.6f}, {:.6f}, {:.6f}, {:.6f})", diffuseColor.r, diffuseColor.g,
-                      diffuseColor.b, diffuseColor.a);
-        }
-    } catch (const std::exception &e)
+    start = std::chrono::steady_clock::now();
+
+    std::unordered_map<const aiNode *, unsigned int> subtreeMeshes;
+    std::vector<const aiMesh *> sources;
+
+    countMeshes(scene->mRootNode, subtreeMeshes);
+
+    data.nodes.push_back(ModelNode()); // root composite
+    processNode(scene, scene->mRootNode, 0, aiMatrix4x4(), subtreeMeshes, data, sources);
+
+    timings.flattenSeconds = secondsSince(start);
+
+    // Convert meshes and materials on the worker threads. Large meshes are split further into
+    // blocks of vertices and faces by nested parallelFor() calls.
+
+    start = std::chrono::steady_clock::now();
+
+    data.meshes.resize(sources.size());
+    data.materials.resize(scene->mNumMaterials);
+
+    ThreadPool::instance()->parallelFor(0, sources.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            processAiMesh(scene, sources[i], data.meshes[i]);
+    });
+
+    ThreadPool::instance()->parallelFor(0, data.materials.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            processMaterial(scene->mMaterials[i], data.materials[i]);
+    });
+
+    timings.convertSeconds = secondsSince(start);
+
+    // Details of the converted data, only formatted if debug output is enabled
+
+    if (Logger::instance()->isEnabled(LogLevel::Debug))
     {
-        logWarningfc("ModelLoader", "Material creation failed: {}", e.what());
+        for (auto &mesh : data.meshes)
+            logDebugfc("ModelLoader", "  Mesh {}: {} vertices, {} triangles, material {}, {} normals", mesh.name,
+                       mesh.vertexCount, mesh.triangleCount, mesh.material,
+                       mesh.normals.empty() ? "generated" : "original");
+
+        for (auto &material : data.materials)
+            logDebugfc("ModelLoader",
+                       "  Material - Diffuse: ({:.6f}, {:.6f}, {:.6f}), Opacity: {:.6f}, Ambient: ({:.6f}, {:.6f}, "
+                       "{:.6f}), Specular: ({:.6f}, {:.6f}, {:.6f}), Shininess: {:.6f}",
+                       material.diffuse.r, material.diffuse.g, material.diffuse.b, material.diffuse.a,
+                       material.ambient.r, material.ambient.g, material.ambient.b, material.specular.r,
+                       material.specular.g, material.specular.b, material.shininess);
     }
 }
 
-void ModelLoader::processMaterial(aiMaterial *aiMat, std::shared_ptr<Mesh> mesh)
+std::shared_ptr<CompositeNode> ModelLoader::buildModel(const ModelData &data)
 {
-    aiColor3D diffuse(1.0f, 1.0f, 1.0f);
-    aiColor3D ambient(0.2f, 0.2f, 0.2f);
-    aiColor3D specular(1.0f, 1.0f, 1.0f);
-    float shininess = 32.0f;
-    float opacity = 1.0f;
+    std::vector<std::shared_ptr<CompositeNode>> composites(data.nodes.size());
+    std::vector<GLfloat> white;
 
-    aiMat->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse);
-    aiMat->Get(AI_MATKEY_COLOR_AMBIENT, ambient);
-    aiMat->Get(AI_MATKEY_COLOR_SPECULAR, specular);
-    aiMat->Get(AI_MATKEY_SHININESS, shininess);
-    aiMat->Get(AI_MATKEY_OPACITY, opacity);
+    composites[0] = CompositeNode::create();
 
-    // Debug output with higher precision
+    for (size_t i = 1; i < data.nodes.size(); i++)
+    {
+        auto &node = data.nodes[i];
+        auto &parent = composites[node.parent];
 
-    logInfofc("ModelLoader",
-               "Material - Diffuse: ({:.6f}, {:.6f}, {:.6f}), Opacity: {:.6f}", diffuse.r, diffuse.g,
-              diffuse.b, opacity);
+        if (node.composite)
+        {
+            composites[i] = CompositeNode::create();
+            composites[i]->setName(node.name);
+            parent->add(composites[i]);
+            continue;
+        }
 
-    try
-    {
-        auto material = mesh->material();
-        if (!material)
+        auto meshNode = MeshNode::create();
+        meshNode->setName(node.name);
+        meshNode->setPos(node.pos);
+        meshNode->setScale(node.scale);
+
+        if (node.rotAngle != 0.0f)
         {
-            material = Material::create();
-            mesh->setMaterial(material);
+            meshNode->setRotAxis(node.rotAxis);
+            meshNode->setRotAngle(node.rotAngle);
         }
 
-        if (material)
+        for (std::uint32_t j = 0; j < node.meshCount; j++)
         {
-            // Ensure full precision colors
-            glm::vec4 diffuseColor(diffuse.r, diffuse.g, diffuse.b, opacity);
-            glm::vec4 ambientColor(ambient.r, ambient.g, ambient.b, opacity);
-            glm::vec4 specularColor(specular.r, specular.g, specular.b, opacity);
+            auto &modelMesh = data.meshes[node.firstMesh + j];
 
-            material->setDiffuseColor(diffuseColor);
-            material->setAmbientColor(ambientColor);
-            material->setSpecularColor(specularColor);
-            material->setShininess(shininess);
+            meshNode->newMesh(modelMesh.vertexCount, modelMesh.triangleCount);
+            auto mesh = meshNode->currentMesh();
 
-            // Ensure material is properly enabled
-            // Debug: Check if colors are being clamped or quantized
+            if (!mesh)
+            {
+                logError("Failed to create mesh!", "ModelLoader");
+                continue;
+            }
+
+            // Meshes without vertex colors are white
 
-            logInfofc("ModelLoader", "  Set ambient: ({:.6f}, {:.6f}, {:.6f}, {:.6f})", ambientColor.r, ambientColor.g,
-                      ambientColor.b, ambientColor.a);
+            const GLfloat *colors = modelMesh.colors.data();
+
+            if (modelMesh.colors.empty())
+            {
+                white.assign(size_t(modelMesh.vertexCount) * 4, 1.0f);
+                colors = white.data();
+            }
+
+            mesh->setGenerateNormals(modelMesh.normals.empty());
+            mesh->begin(GL_TRIANGLES);
+            mesh->setArrays(modelMesh.positions.data(), modelMesh.normals.empty() ? nullptr : modelMesh.normals.data(),
+                            modelMesh.texCoords.empty() ? nullptr : modelMesh.texCoords.data(), colors,
+                            modelMesh.indices.data());
+            mesh->end();
         }
-    } catch (const std::exception &e)
-    {
-        logWarningfc("ModelLoader", "Material creation failed: {}", e.what());
+
+        // The node shares one material, the last mesh's as when the meshes were processed in turn
+
+        if (node.meshCount > 0)
+        {
+            auto materialIndex = data.meshes[node.firstMesh + node.meshCount - 1].material;
+
+            if (materialIndex != ModelMesh::noMaterial)
+            {
+                auto &modelMaterial = data.materials[materialIndex];
+                auto material = Material::create();
+                material->setDiffuseColor(modelMaterial.diffuse);
+                material->setAmbientColor(modelMaterial.ambient);
+                material->setSpecularColor(modelMaterial.specular);
+                material->setShininess(modelMaterial.shininess);
+                meshNode->setMaterial(material);
+            }
+        }
+
+        meshNode->updateBoundingBox();
+        parent->add(meshNode);
     }
+
+    return composites[0];
 }
 
-std::shared_ptr<CompositeNode> ModelLoader::loadModel(const std::string &path)
+std::shared_ptr<CompositeNode> ModelLoader::loadModel(const std::string &path, unsigned int importFlags)
 {
-    Assimp::Importer importer;
+    auto cache = ModelCache::instance();
+    auto start = std::chrono::steady_clock::now();
+    auto &timings = m_lastTimings;
 
-    importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f);
+    timings = ModelLoadTimings();
 
-    unsigned int postProcessFlags =
-        aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals;
+    ModelData data;
+    bool cached = cache->enabled() && cache->read(path, importFlags, data);
 
-    const aiScene *scene = importer.ReadFile(path, postProcessFlags);
-
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    if (cached)
+        timings.readSeconds = secondsSince(start);
+    else
     {
-        throw std::runtime_error("Failed to load model '" + path + "': " + std::string(importer.GetErrorString()));
+        importModel(path, importFlags, data);
+
+        if (cache->enabled())
+        {
+            auto cacheStart = std::chrono::steady_clock::now();
+            cache->write(path, importFlags, data);
+            timings.cacheSeconds = secondsSince(cacheStart);
+        }
     }
 
-    logInfofc("ModelLoader", "Successfully loaded model: {}", path);
-    logInfofc("ModelLoader", "  Meshes: {}", scene->mNumMeshes);
-    logInfofc("ModelLoader", "  Materials: {}", scene->mNumMaterials);
+    // Nodes, meshes and GL buffers on the calling thread
+
+    auto buildStart = std::chrono::steady_clock::now();
+    auto compositeNode = buildModel(data);
+    timings.buildSeconds = secondsSince(buildStart);
+
+    timings.totalSeconds = secondsSince(start);
+    timings.fromCache = cached;
+    timings.meshes = data.meshes.size();
 
-    auto compositeNode = CompositeNode::create();
-    processNode(scene, scene->mRootNode, compositeNode, aiMatrix4x4());
+    for (auto &mesh : data.meshes)
+    {
+        timings.vertices += mesh.vertexCount;
+        timings.triangles += mesh.triangleCount;
+    }
+
+    if (cache->enabled())
+    {
+        if (cached)
+            cache->m_stats.hitSeconds += timings.totalSeconds;
+        else
+            cache->m_stats.missSeconds += timings.totalSeconds;
+    }
 
-    logInfofc("ModelLoader", "Model loading complete. CompositeNode has {} children.", compositeNode->count());
+    logInfofc("ModelLoader",
+              "Loaded {}{}: {} meshes, {} vertices, {} triangles in {:.3f} s (read {:.3f}, flatten {:.3f}, "
+              "convert {:.3f}, cache {:.3f}, build {:.3f})",
+              path, cached ? " from cache" : "", timings.meshes, timings.vertices, timings.triangles,
+              timings.totalSeconds, timings.readSeconds, timings.flattenSeconds, timings.convertSeconds,
+              timings.cacheSeconds, timings.buildSeconds);
 
     // If the top-level composite only has one child and that child is also a composite,
     // return the child directly to eliminate unnecessary nesting
@@ -407,10 +517,15 @@ std::shared_ptr<CompositeNode> ModelLoader::loadModel(const std::string &path)
         auto firstChild = std::dynamic_pointer_cast<CompositeNode>(compositeNode->at(0));
         if (firstChild)
         {
-            logInfo("Eliminating top-level composite wrapper", "ModelLoader");
+            logDebug("Eliminating top-level composite wrapper", "ModelLoader");
             return firstChild;
         }
     }
 
     return compositeNode;
 }
+
+const ModelLoadTimings &ModelLoader::lastTimings()
+{
+    return m_lastTimings;
+}
@@ -1,5 +1,6 @@
 #include <ivf/night_vision_effect.h>
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -24,14 +25,15 @@ glm::vec3 NightVisionEffect::phosphorColor() const { return m_phosphorColor; }
 void NightVisionEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::night_vision_frag_shader_source, "night_vision", false);
+                                         EffectFusion::fragmentSource({ivf::night_vision_pointwise_source}),
+                                         "night_vision", false);
 }
 
 void NightVisionEffect::doUpdateParams()
 {
-    m_program->uniformFloat("noiseIntensity", m_noiseIntensity);
-    m_program->uniformFloat("glowStrength", m_glowStrength);
-    m_program->uniformVec3("phosphorColor", m_phosphorColor);
+    paramProgram()->uniformFloat(paramName("noiseIntensity"), m_noiseIntensity);
+    paramProgram()->uniformFloat(paramName("glowStrength"), m_glowStrength);
+    paramProgram()->uniformVec3(paramName("phosphorColor"), m_phosphorColor);
 }
 
 void NightVisionEffect::setupProperties()
@@ -40,3 +42,13 @@ void NightVisionEffect::setupProperties()
     addProperty("glowStrength", &m_glowStrength, 0.0f, 2.0f, "Night Vision");
     addProperty("phosphorColor", &m_phosphorColor, "Night Vision");
 }
+
+bool NightVisionEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string NightVisionEffect::pointwiseSource() const
+{
+    return ivf::night_vision_pointwise_source;
+}
@@ -0,0 +1,107 @@
+#include <ivf/particle_forces.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ivf {
+
+// ---- GravityForce ----------------------------------------------------------
+
+std::shared_ptr<GravityForce> GravityForce::create(glm::vec3 acceleration)
+{
+    return std::make_shared<GravityForce>(acceleration);
+}
+
+void GravityForce::apply(const ParticleBatch& b, float dt) const
+{
+    const glm::vec3 dv = m_acceleration * dt;
+    const size_t n = b.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        b.velX[i] += dv.x; b.velY[i] += dv.y; b.velZ[i] += dv.z;
+    }
+}
+
+// ---- DragForce -------------------------------------------------------------
+
+std::shared_ptr<DragForce> DragForce::create(float coefficient)
+{
+    return std::make_shared<DragForce>(coefficient);
+}
+
+void DragForce::apply(const ParticleBatch& b, float dt) const
+{
+    const float factor = std::exp(-m_coefficient * dt);
+    const size_t n = b.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        b.velX[i] *= factor; b.velY[i] *= factor; b.velZ[i] *= factor;
+    }
+}
+
+// ---- AttractorForce --------------------------------------------------------
+
+std::shared_ptr<AttractorForce> AttractorForce::create(glm::vec3 center, float strength, float softening)
+{
+    return std::make_shared<AttractorForce>(center, strength, softening);
+}
+
+void AttractorForce::apply(const ParticleBatch& b, float dt) const
+{
+    const float k = m_strength * dt;
+    const float soft2 = m_softening * m_softening;
+    const size_t n = b.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        float dx = m_center.x - b.posX[i];
+        float dy = m_center.y - b.posY[i];
+        float dz = m_center.z - b.posZ[i];
+        float d2 = dx * dx + dy * dy + dz * dz + soft2;
+        float s  = k / (d2 * std::sqrt(d2));
+        b.velX[i] += dx * s; b.velY[i] += dy * s; b.velZ[i] += dz * s;
+    }
+}
+
+// ---- VortexForce -----------------------------------------------------------
+
+VortexForce::VortexForce(glm::vec3 center, glm::vec3 axis, float strength, float radius)
+    : m_center(center), m_axis(0.0f, 1.0f, 0.0f), m_strength(strength), m_radius(radius)
+{
+    setAxis(axis);
+}
+
+std::shared_ptr<VortexForce> VortexForce::create(glm::vec3 center, glm::vec3 axis, float strength, float radius)
+{
+    return std::make_shared<VortexForce>(center, axis, strength, radius);
+}
+
+void VortexForce::setAxis(glm::vec3 a)
+{
+    float len = glm::length(a);
+    if (len > 0.0f) m_axis = a / len;
+}
+
+void VortexForce::apply(const ParticleBatch& b, float dt) const
+{
+    const glm::vec3 a = m_axis;
+    const float k = m_strength * dt;
+    const float r2 = m_radius * m_radius;
+    const size_t n = b.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        // Offset from the axis
+        float rx = b.posX[i] - m_center.x;
+        float ry = b.posY[i] - m_center.y;
+        float rz = b.posZ[i] - m_center.z;
+        float along = rx * a.x + ry * a.y + rz * a.z;
+        rx -= along * a.x; ry -= along * a.y; rz -= along * a.z;
+
+        // Tangential direction axis x r, scaled down away from the axis
+        float s = k / (rx * rx + ry * ry + rz * rz + r2);
+        b.velX[i] += (a.y * rz - a.z * ry) * s;
+        b.velY[i] += (a.z * rx - a.x * rz) * s;
+        b.velZ[i] += (a.x * ry - a.y * rx) * s;
+    }
+}
+
+} // namespace ivf
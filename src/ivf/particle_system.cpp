@@ -2,6 +2,7 @@
 #include <ivf/texture.h>
 #include <ivf/transform_manager.h>
 #include <ivf/shader_manager.h>
+#include <ivf/thread_pool.h>
 #include <ivf/logger.h>
 
 #include <glad/glad.h>
@@ -90,13 +91,16 @@ static const float k_quad[] = {
     -0.5f,  0.5f,
 };
 
+// Particles per block of the fused update; all kernels run over a block while it is in L1
+static constexpr size_t k_blockSize = 256;
+
 // ---- Ctor / Dtor -----------------------------------------------------------
 
 ParticleSystem::ParticleSystem(int maxParticles)
     : m_maxParticles(maxParticles)
 {
-    m_pool.resize(maxParticles);
-    m_instanceData.resize(maxParticles);
+    for (auto* a : { &m_posX, &m_posY, &m_posZ, &m_velX, &m_velY, &m_velZ, &m_life, &m_lifeSpan })
+        a->resize(maxParticles);
 }
 
 ParticleSystem::~ParticleSystem()
@@ -167,9 +171,9 @@ void ParticleSystem::initGPU()
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
 
-    // Instance VBO (locations 1,2,3) — size updated each frame
+    // Instance VBO (locations 1,2,3) — live range streamed each frame
     glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_maxParticles * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_maxParticles * sizeof(InstanceData)), nullptr, GL_STREAM_DRAW);
 
     // location 1: pos (vec3)
     glEnableVertexAttribArray(1);
@@ -209,38 +213,147 @@ glm::vec3 ParticleSystem::randVec3(glm::vec3 lo, glm::vec3 hi)
 
 void ParticleSystem::spawnParticle()
 {
-    // Find a dead slot
-    for (auto& p : m_pool) {
-        if (p.alive) continue;
-
-        glm::vec3 spawnPos{0,0,0};
-        if (m_emitShape == 0) {
-            spawnPos = m_emitCenter;
-        } else if (m_emitShape == 1) {
-            // Random point inside sphere
-            float theta = randRange(0, glm::two_pi<float>());
-            float phi   = randRange(0, glm::pi<float>());
-            float r     = m_emitRadius * std::cbrt(randRange(0,1));
-            spawnPos = m_emitCenter + glm::vec3(
-                r * std::sin(phi) * std::cos(theta),
-                r * std::cos(phi),
-                r * std::sin(phi) * std::sin(theta));
-        } else {
-            spawnPos = randVec3(m_emitBoxMin, m_emitBoxMax);
+    // Live particles are packed, the first free slot is always at m_aliveCount
+    if (m_aliveCount >= m_maxParticles) return;
+
+    glm::vec3 spawnPos{0,0,0};
+    if (m_emitShape == 0) {
+        spawnPos = m_emitCenter;
+    } else if (m_emitShape == 1) {
+        // Random point inside sphere
+        float theta = randRange(0, glm::two_pi<float>());
+        float phi   = randRange(0, glm::pi<float>());
+        float r     = m_emitRadius * std::cbrt(randRange(0,1));
+        spawnPos = m_emitCenter + glm::vec3(
+            r * std::sin(phi) * std::cos(theta),
+            r * std::cos(phi),
+            r * std::sin(phi) * std::sin(theta));
+    } else {
+        spawnPos = randVec3(m_emitBoxMin, m_emitBoxMax);
+    }
+
+    glm::vec3 vel = randVec3(m_minVel, m_maxVel);
+
+    int i = m_aliveCount++;
+    m_posX[i] = spawnPos.x; m_posY[i] = spawnPos.y; m_posZ[i] = spawnPos.z;
+    m_velX[i] = vel.x;      m_velY[i] = vel.y;      m_velZ[i] = vel.z;
+    m_lifeSpan[i] = randRange(m_minLife, m_maxLife);
+    m_life[i]     = m_lifeSpan[i];
+}
+
+void ParticleSystem::removeDead()
+{
+    // Swap-remove: the last live particle moves into the slot of the dead one
+    int i = 0;
+    while (i < m_aliveCount) {
+        if (m_life[i] > 0.0f) { ++i; continue; }
+
+        int last = --m_aliveCount;
+        m_posX[i] = m_posX[last]; m_posY[i] = m_posY[last]; m_posZ[i] = m_posZ[last];
+        m_velX[i] = m_velX[last]; m_velY[i] = m_velY[last]; m_velZ[i] = m_velZ[last];
+        m_life[i] = m_life[last]; m_lifeSpan[i] = m_lifeSpan[last];
+    }
+}
+
+ParticleBatch ParticleSystem::batch(size_t begin, size_t end)
+{
+    size_t n = end - begin;
+    ParticleBatch b;
+    b.posX = { m_posX.data() + begin, n }; b.posY = { m_posY.data() + begin, n }; b.posZ = { m_posZ.data() + begin, n };
+    b.velX = { m_velX.data() + begin, n }; b.velY = { m_velY.data() + begin, n }; b.velZ = { m_velZ.data() + begin, n };
+    b.life     = { m_life.data() + begin, n };
+    b.lifeSpan = { m_lifeSpan.data() + begin, n };
+    b.first    = begin;
+    return b;
+}
+
+void ParticleSystem::integrate(size_t begin, size_t end, float dt)
+{
+    // Branch-free loops over separate arrays so the compiler can vectorize them
+    float* __restrict px = m_posX.data();
+    float* __restrict py = m_posY.data();
+    float* __restrict pz = m_posZ.data();
+    float* __restrict vx = m_velX.data();
+    float* __restrict vy = m_velY.data();
+    float* __restrict vz = m_velZ.data();
+    float* __restrict life = m_life.data();
+
+    const float gx = m_gravity.x * dt, gy = m_gravity.y * dt, gz = m_gravity.z * dt;
+
+    // Every kernel runs over one block before moving on, keeping the block in L1
+    for (size_t blockBegin = begin; blockBegin < end; blockBegin += k_blockSize) {
+        size_t blockEnd = std::min(end, blockBegin + k_blockSize);
+
+        for (size_t i = blockBegin; i < blockEnd; ++i) {
+            life[i] -= dt;
+            vx[i] += gx; vy[i] += gy; vz[i] += gz;
         }
 
-        p.position = spawnPos;
-        p.velocity = randVec3(m_minVel, m_maxVel);
-        p.maxLife  = randRange(m_minLife, m_maxLife);
-        p.life     = p.maxLife;
-        p.color    = m_startColor;
-        p.size     = m_startSize;
-        p.alive    = true;
-        ++m_aliveCount;
-        return;
+        if (!m_forces.empty() || m_batchUpdateFn) {
+            ParticleBatch b = batch(blockBegin, blockEnd);
+
+            for (const auto& force : m_forces)
+                if (force->enabled()) force->apply(b, dt);
+
+            if (m_batchUpdateFn) m_batchUpdateFn(b, dt);
+        }
+
+        for (size_t i = blockBegin; i < blockEnd; ++i) {
+            px[i] += vx[i] * dt; py[i] += vy[i] * dt; pz[i] += vz[i] * dt;
+        }
+    }
+}
+
+void ParticleSystem::callUpdateFunction(float dt)
+{
+    // Slow path: user callbacks are called serially, they may not be thread safe
+    Particle p;
+    p.alive = true;
+
+    for (int i = 0; i < m_aliveCount; ++i) {
+        m_life[i] -= dt;
+        if (m_life[i] <= 0.0f) continue;
+
+        p.position = { m_posX[i], m_posY[i], m_posZ[i] };
+        p.velocity = { m_velX[i], m_velY[i], m_velZ[i] };
+        p.life     = m_life[i];
+        p.maxLife  = m_lifeSpan[i];
+
+        float t = glm::clamp(1.0f - p.life / p.maxLife, 0.0f, 1.0f);
+        p.color = glm::mix(m_startColor, m_endColor, t);
+        p.size  = glm::mix(m_startSize,  m_endSize,  t);
+
+        m_updateFn(p, dt);
+
+        m_posX[i] = p.position.x; m_posY[i] = p.position.y; m_posZ[i] = p.position.z;
+        m_velX[i] = p.velocity.x; m_velY[i] = p.velocity.y; m_velZ[i] = p.velocity.z;
+        m_life[i] = p.alive ? p.life : 0.0f;
+    }
+}
+
+void ParticleSystem::packInstances(InstanceData* dst, size_t begin, size_t end) const
+{
+    // Color and size follow from the normalized age, they are not stored per particle
+    for (size_t i = begin; i < end; ++i) {
+        float t = glm::clamp(1.0f - m_life[i] / m_lifeSpan[i], 0.0f, 1.0f);
+        dst[i] = { glm::vec3(m_posX[i], m_posY[i], m_posZ[i]),
+                   glm::mix(m_startSize, m_endSize, t),
+                   glm::mix(m_startColor, m_endColor, t) };
     }
 }
 
+// ---- Forces ----------------------------------------------------------------
+
+void ParticleSystem::addForce(ParticleForcePtr force)
+{
+    if (force) m_forces.push_back(std::move(force));
+}
+
+void ParticleSystem::removeForce(ParticleForcePtr force)
+{
+    m_forces.erase(std::remove(m_forces.begin(), m_forces.end(), force), m_forces.end());
+}
+
 // ---- Emit / Update / Draw --------------------------------------------------
 
 void ParticleSystem::emit(int count)
@@ -259,32 +372,16 @@ void ParticleSystem::update(float dt)
         }
     }
 
-    m_aliveCount = 0;
-    for (auto& p : m_pool) {
-        if (!p.alive) continue;
-        p.life -= dt;
-        bool expired = p.life <= 0.0f;
-
-        if (!expired) {
-            if (m_updateFn) {
-                m_updateFn(p, dt);
-            } else {
-                p.velocity += m_gravity * dt;
-                p.position += p.velocity * dt;
-            }
-        }
-
-        float t = glm::clamp(1.0f - p.life / p.maxLife, 0.0f, 1.0f);
-        p.color = glm::mix(m_startColor, m_endColor, t);
-        p.size  = glm::mix(m_startSize,  m_endSize,  t);
-
-        if (expired) {
-            p.alive = false;
-            continue;
-        }
-
-        ++m_aliveCount;
+    if (m_updateFn) {
+        callUpdateFunction(dt);
+    } else if (m_parallel) {
+        ThreadPool::instance()->parallelFor(0, size_t(m_aliveCount),
+            [this, dt](size_t begin, size_t end) { integrate(begin, end, dt); }, m_grainSize);
+    } else {
+        integrate(0, size_t(m_aliveCount), dt);
     }
+
+    removeDead();
 }
 
 void ParticleSystem::doSetup()
@@ -302,18 +399,28 @@ void ParticleSystem::doDraw()
 
     if (m_aliveCount == 0) return;
 
-    // Pack instance data
-    int idx = 0;
-    for (const auto& p : m_pool) {
-        if (!p.alive) continue;
-        m_instanceData[idx++] = { p.position, p.size, p.color };
-        if (idx >= m_maxParticles) break;
-    }
+    // Stream the live range straight into the orphaned instance buffer
+    size_t count = size_t(m_aliveCount);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    GLsizeiptr(idx * sizeof(InstanceData)),
-                    m_instanceData.data());
+    auto* dst = static_cast<InstanceData*>(glMapBufferRange(GL_ARRAY_BUFFER, 0,
+        GLsizeiptr(count * sizeof(InstanceData)), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+    if (!dst) {
+        logError("Failed to map particle instance buffer", "ParticleSystem");
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    if (m_parallel) {
+        ThreadPool::instance()->parallelFor(0, count,
+            [this, dst](size_t begin, size_t end) { packInstances(dst, begin, end); }, m_grainSize);
+    } else {
+        packInstances(dst, 0, count);
+    }
+
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     auto& xfm = *TransformManager::instance();
     glm::mat4 vp = xfm.projectionMatrix() * xfm.viewMatrix();
@@ -340,7 +447,7 @@ void ParticleSystem::doDraw()
     glDepthMask(GL_FALSE);
 
     glBindVertexArray(m_vao);
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, idx);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, GLsizei(count));
     glBindVertexArray(0);
 
     glDepthMask(GL_TRUE);
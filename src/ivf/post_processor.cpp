@@ -5,102 +5,112 @@
 #include <ivf/texture.h>
 #include <ivf/stock_shaders.h>
 #include <ivf/shader_manager.h>
+#include <ivf/gl_diagnostics.h>
+#include <ivf/render_target_pool.h>
 
 namespace ivf {
 
 PostProcessor::PostProcessor(int width, int height)
-    : m_width(width), m_height(height), m_fboA(0), m_fboB(0), m_textureA(0), m_textureB(0), m_historyFBO(0),
-      m_historyTex{0, 0}, m_historyIndex(0), m_quadVAO(0), m_quadVBO(0), m_time(0.0f)
-{}
+    : m_width(width), m_height(height), m_historyIndex(0), m_quadVAO(0), m_quadVBO(0), m_time(0.0f)
+{
+    m_fusion = EffectFusion::create();
+}
 
 PostProcessor::~PostProcessor()
 {
-    glDeleteFramebuffers(1, &m_fboA);
-    glDeleteFramebuffers(1, &m_fboB);
-    glDeleteTextures(1, &m_textureA);
-    glDeleteTextures(1, &m_textureB);
-    glDeleteFramebuffers(1, &m_historyFBO);
-    glDeleteTextures(2, m_historyTex);
+    this->drop();
 }
 
 void PostProcessor::addEffect(ProgramPtr fxProgram)
 {
     m_fxPrograms.push_back(fxProgram);
+    m_fxEffects.push_back(nullptr);
+}
+
+void PostProcessor::addEffect(EffectPtr effect)
+{
+    m_fxPrograms.push_back(effect->program());
+    m_fxEffects.push_back(effect);
 }
 
 void PostProcessor::clearEffects()
 {
     m_fxPrograms.clear();
+    m_fxEffects.clear();
+}
+
+void PostProcessor::setEffectFusion(bool flag)
+{
+    m_fuseEffects = flag;
+}
+
+bool PostProcessor::effectFusion() const
+{
+    return m_fuseEffects;
+}
+
+int PostProcessor::passCount() const
+{
+    return m_passCount;
+}
+
+int PostProcessor::fusedEffectCount() const
+{
+    return m_fusedEffectCount;
 }
 
 void PostProcessor::initialize()
 {
-    glGenFramebuffers(1, &m_fboA);
-    glGenFramebuffers(1, &m_fboB);
-    glGenTextures(1, &m_textureA);
-    glGenTextures(1, &m_textureB);
+    this->updateHistory();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fboA);
-    glBindTexture(GL_TEXTURE_2D, m_textureA);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_width, m_height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textureA, 0);
+    if (m_quadVAO == 0)
+        this->initQuad();
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fboB);
-    glBindTexture(GL_TEXTURE_2D, m_textureB);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_width, m_height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textureB, 0);
+void PostProcessor::updateHistory()
+{
+    // Double-buffered targets retaining the previous frame's final composite (bound to
+    // unit 1 as "previousFrame" for temporal effects). Held across frames and only
+    // exchanged when the size changes.
 
-    // History framebuffer + double-buffered textures used to retain the previous
-    // frame's final composite (bound to unit 1 as "previousFrame" for temporal effects).
+    RenderTargetDesc desc;
+    desc.width = m_width;
+    desc.height = m_height;
+    desc.colorFormat = GL_RGBA16F;
 
-    glGenFramebuffers(1, &m_historyFBO);
-    glGenTextures(2, m_historyTex);
+    auto pool = RenderTargetPool::instance();
 
     for (int i = 0; i < 2; i++)
     {
-        glBindTexture(GL_TEXTURE_2D, m_historyTex[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_width, m_height, 0, GL_RGBA, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        // Clear to black so the first frame has no garbage to feed back.
-        glBindFramebuffer(GL_FRAMEBUFFER, m_historyFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_historyTex[i], 0);
-        glClear(GL_COLOR_BUFFER_BIT);
+        if (pool->reacquire(m_history[i], desc))
+        {
+            // Clear to black so the first frame has no garbage to feed back.
+            const GLfloat black[] = {0.0f, 0.0f, 0.0f, 1.0f};
+            glBindFramebuffer(GL_FRAMEBUFFER, m_history[i]->fbo());
+            glClearBufferfv(GL_COLOR, 0, black);
+            m_historyIndex = 0;
+        }
     }
 
-    m_historyIndex = 0;
-
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    this->initQuad();
 }
 
 void PostProcessor::resize(int width, int height)
 {
-    if ((m_width == width) && (m_height == height))
-        return;
-
+    // Targets are exchanged lazily on the next apply()
     m_width = width;
     m_height = height;
-    this->drop();
-    this->initialize();
 }
 
 void PostProcessor::drop()
 {
-    glDeleteFramebuffers(1, &m_fboA);
-    glDeleteFramebuffers(1, &m_fboB);
-    glDeleteTextures(1, &m_textureA);
-    glDeleteTextures(1, &m_textureB);
-    glDeleteFramebuffers(1, &m_historyFBO);
-    glDeleteTextures(2, m_historyTex);
+    auto pool = RenderTargetPool::instance();
+
+    for (auto &target : m_history)
+    {
+        pool->release(target);
+        target = nullptr;
+    }
 }
 
 std::shared_ptr<PostProcessor> PostProcessor::create(int width, int height)
@@ -134,21 +144,83 @@ void PostProcessor::setTime(float time)
 
 void PostProcessor::apply(GLuint inputTexture)
 {
+    IVF_GL_SCOPE("PostProcessor");
+
     // Only enabled effects participate in the chain. A disabled effect is skipped
     // entirely (Program::use() is a no-op when disabled, so drawing it would re-run
     // the previously bound shader and apply effects multiple times).
-    std::vector<ProgramPtr> active;
+    struct Pass
+    {
+        ProgramPtr program;
+        EffectPtr effect;             ///< Owning effect of a single pass (may be nullptr).
+        std::vector<EffectPtr> fused; ///< Effects whose parameters go to a fused program.
+    };
+
+    std::vector<Pass> active;
     active.reserve(m_fxPrograms.size());
-    for (auto &program : m_fxPrograms)
-        if (program && program->enabled())
-            active.push_back(program);
+
+    m_passCount = 0;
+    m_fusedEffectCount = 0;
+
+    for (size_t i = 0; i < m_fxPrograms.size(); i++)
+    {
+        auto &program = m_fxPrograms[i];
+
+        if (!program || !program->enabled())
+            continue;
+
+        // Collect the run of enabled point-wise effects starting here
+
+        std::vector<EffectPtr> run;
+        size_t runEnd = i;
+
+        if (m_fuseEffects)
+        {
+            for (size_t j = i; j < m_fxPrograms.size(); j++)
+            {
+                if (!m_fxPrograms[j] || !m_fxPrograms[j]->enabled())
+                    continue;
+
+                auto &effect = m_fxEffects[j];
+
+                if (!effect || !effect->isPointwise())
+                    break;
+
+                run.push_back(effect);
+                runEnd = j;
+            }
+        }
+
+        if (run.size() > 1)
+        {
+            auto fusedProgram = m_fusion->program(run);
+
+            if (fusedProgram)
+            {
+                active.push_back({fusedProgram, nullptr, run});
+                m_fusedEffectCount += int(run.size());
+                i = runEnd;
+                continue;
+            }
+        }
+
+        active.push_back({program, m_fxEffects[i], {}});
+    }
+
+    m_passCount = int(active.size());
 
     // Nothing enabled: the scene was already drawn to the screen by the caller.
     if (active.empty())
         return;
 
+    this->updateHistory();
+
     GLuint sourceTexture = inputTexture;
-    GLuint targetFBO = m_fboA;
+
+    // Ping-pong targets only live for the duration of the chain, so the pool can hand
+    // the same memory to other passes (downsample chains, generators) in between.
+    auto pool = RenderTargetPool::instance();
+    RenderTargetPtr pingPong[2];
 
     // The previous frame's composite (read) and where we write this frame's composite.
     const int prev = m_historyIndex;
@@ -160,7 +232,7 @@ void PostProcessor::apply(GLuint inputTexture)
     // Bind the previous frame to unit 1 for the whole chain. Effects that declare a
     // "previousFrame" sampler (feedback, trails, motion blur) read from it; others ignore it.
     glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, m_historyTex[prev]);
+    glBindTexture(GL_TEXTURE_2D, m_history[prev]->texture());
 
     // Apply each enabled effect in sequence
     for (size_t i = 0; i < active.size(); i++)
@@ -169,32 +241,54 @@ void PostProcessor::apply(GLuint inputTexture)
         // retain it as the previous frame for the next call.
         bool isLastEffect = (i == active.size() - 1);
 
+        // Multi-pass effects (blur, bloom) render their intermediate chains first
+        if (active[i].effect)
+        {
+            active[i].effect->renderPasses(sourceTexture, m_width, m_height, m_quadVAO);
+
+            glViewport(0, 0, m_width, m_height);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_history[prev]->texture());
+        }
+
+        RenderTargetPtr target;
+
         if (!isLastEffect)
         {
-            // Ping-pong between FBOs
-            targetFBO = (i % 2 == 0) ? m_fboA : m_fboB;
-            glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+            // Ping-pong between targets
+            auto &pingPongTarget = pingPong[i % 2];
+
+            if (!pingPongTarget)
+                pingPongTarget = pool->acquire(m_width, m_height, GL_RGBA16F);
+
+            target = pingPongTarget;
         }
         else
         {
             // Final pass renders into the history texture for this frame.
-            glBindFramebuffer(GL_FRAMEBUFFER, m_historyFBO);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_historyTex[cur], 0);
+            target = m_history[cur];
         }
 
+        glBindFramebuffer(GL_FRAMEBUFFER, target->fbo());
+
         // Clear the target
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // Use the current effect's shader
-        active[i]->use();
+        // Use the current effect's shader. Fused programs get the parameters of every
+        // effect they contain, each under its own uniform prefix.
+        auto &program = active[i].program;
+        program->use();
+
+        for (size_t k = 0; k < active[i].fused.size(); k++)
+            active[i].fused[k]->applyParams(program, EffectFusion::paramPrefix(k, active[i].fused.size()));
 
         // Bind source texture and set uniforms
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, sourceTexture);
 
-        active[i]->uniformInt("screenTexture", 0);
-        active[i]->uniformInt("previousFrame", 1);
-        active[i]->uniformFloat("time", m_time);
+        program->uniformInt("screenTexture", 0);
+        program->uniformInt("previousFrame", 1);
+        program->uniformFloat("time", m_time);
 
         // Draw full-screen quad
         glBindVertexArray(m_quadVAO);
@@ -203,17 +297,20 @@ void PostProcessor::apply(GLuint inputTexture)
         // Next effect will use this pass's output as input
         if (!isLastEffect)
         {
-            sourceTexture = (targetFBO == m_fboA) ? m_textureA : m_textureB;
+            sourceTexture = target->texture();
         }
     }
 
-    // Blit this frame's composite (now in m_historyTex[cur]) to the screen.
+    pool->release(pingPong[0]);
+    pool->release(pingPong[1]);
+
+    // Blit this frame's composite (now in m_history[cur]) to the screen.
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glClear(GL_COLOR_BUFFER_BIT);
     smApplyProgram("render_to_texture");
     smCurrentProgram()->uniformInt("screenTexture", 0);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_historyTex[cur]);
+    glBindTexture(GL_TEXTURE_2D, m_history[cur]->texture());
     glBindVertexArray(m_quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
@@ -221,4 +318,9 @@ void PostProcessor::apply(GLuint inputTexture)
     m_historyIndex = cur;
 }
 
+GLuint PostProcessor::id()
+{
+    return m_history[m_historyIndex] ? m_history[m_historyIndex]->texture() : 0;
+}
+
 } // namespace ivf
@@ -1,5 +1,6 @@
 #include <ivf/posterize_effect.h>
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -19,15 +20,26 @@ float PosterizeEffect::levels() const { return m_levels; }
 void PosterizeEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::posterize_frag_shader_source, "posterize", false);
+                                         EffectFusion::fragmentSource({ivf::posterize_pointwise_source}),
+                                         "posterize", false);
 }
 
 void PosterizeEffect::doUpdateParams()
 {
-    m_program->uniformFloat("levels", m_levels);
+    paramProgram()->uniformFloat(paramName("levels"), m_levels);
 }
 
 void PosterizeEffect::setupProperties()
 {
     addProperty("levels", &m_levels, 2.0f, 32.0f, "Posterize");
 }
+
+bool PosterizeEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string PosterizeEffect::pointwiseSource() const
+{
+    return ivf::posterize_pointwise_source;
+}
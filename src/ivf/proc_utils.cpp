@@ -1,6 +1,12 @@
 #include <ivf/proc_utils.h>
+#include "proc_utils_simd.h"
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+
+#if defined(IVF_NOISE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using namespace ivf;
 
@@ -8,11 +14,8 @@ namespace {
     // Permutation table for noise generation
     static const int PERM_SIZE = 256;
     static int perm[PERM_SIZE * 2];
-    static bool permInitialized = false;
 
-    void initPerm() {
-        if (permInitialized) return;
-        
+    void buildPerm() {
         // Initialize permutation table with a fixed pattern for consistency
         int p[PERM_SIZE];
         for (int i = 0; i < PERM_SIZE; i++) {
@@ -29,8 +32,13 @@ namespace {
         for (int i = 0; i < PERM_SIZE * 2; i++) {
             perm[i] = p[i % PERM_SIZE];
         }
-        
-        permInitialized = true;
+    }
+
+    void initPerm() {
+        // Noise is evaluated from several threads at once (procedural texture tiles),
+        // the static local makes the one-time initialization thread safe
+        static const bool permInitialized = (buildPerm(), true);
+        (void)permInitialized;
     }
     
     // Gradient vectors for 2D noise
@@ -42,6 +50,97 @@ namespace {
     }
 }
 
+namespace {
+    using namespace ivf::noise_detail;
+
+    bool cpuHasAvx2()
+    {
+#if defined(IVF_NOISE_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // AVX state must also be enabled by the OS
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(IVF_NOISE_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    const NoiseKernels &scalarKernels()
+    {
+        static const NoiseKernels kernels = makeNoiseKernels<ScalarLanes>();
+        return kernels;
+    }
+
+    // Only called for levels up to supportedSimdLevel(), the AVX2 translation unit
+    // must not be entered at all on CPUs without AVX2
+
+    const NoiseKernels *kernelsFor(ProcUtils::SimdLevel level)
+    {
+        switch (level) {
+        case ProcUtils::SimdLevel::AVX2:
+            return avx2Kernels();
+#ifdef IVF_NOISE_X86
+        case ProcUtils::SimdLevel::SSE2: {
+            static const NoiseKernels kernels = makeNoiseKernels<Sse2Lanes>();
+            return &kernels;
+        }
+#endif
+        default:
+            return &scalarKernels();
+        }
+    }
+
+    struct ActiveKernels {
+        std::atomic<ProcUtils::SimdLevel> level;
+        std::atomic<const NoiseKernels *> kernels;
+
+        ActiveKernels()
+            : level(ProcUtils::supportedSimdLevel()), kernels(kernelsFor(level))
+        {
+        }
+    };
+
+    ActiveKernels &active()
+    {
+        static ActiveKernels instance;
+        return instance;
+    }
+
+    const NoiseKernels &kernels()
+    {
+        return *active().kernels.load(std::memory_order_relaxed);
+    }
+
+    size_t batchSize(size_t a, size_t b)
+    {
+        return std::min(a, b);
+    }
+
+    template <typename... Sizes> size_t batchSize(size_t a, size_t b, Sizes... rest)
+    {
+        return batchSize(std::min(a, b), rest...);
+    }
+}
+
+const int *ivf::noise_detail::permTable()
+{
+    initPerm();
+    return perm;
+}
+
 float ProcUtils::hash(int x, int y)
 {
     initPerm();
@@ -211,3 +310,183 @@ float ProcUtils::remap(float value, float inMin, float inMax, float outMin, floa
     float t = (value - inMin) / (inMax - inMin);
     return outMin + t * (outMax - outMin);
 }
+
+// ============================================================================
+// Noise variants
+// ============================================================================
+
+// The scalar variants run the batch kernels for a single sample, so they match
+// the batch functions exactly when those run scalar and up to rounding otherwise.
+
+float ProcUtils::noise(float x, float y, float z)
+{
+    float out;
+    scalarKernels().noise3(&x, &y, &z, &out, 1);
+    return out;
+}
+
+glm::vec3 ProcUtils::noiseDeriv(float x, float y)
+{
+    glm::vec3 result;
+    scalarKernels().noiseDeriv2(&x, &y, &result.x, &result.y, &result.z, 1);
+    return result;
+}
+
+glm::vec4 ProcUtils::noiseDeriv(float x, float y, float z)
+{
+    glm::vec4 result;
+    scalarKernels().noiseDeriv3(&x, &y, &z, &result.x, &result.y, &result.z, &result.w, 1);
+    return result;
+}
+
+float ProcUtils::valueNoise(float x, float y)
+{
+    float out;
+    scalarKernels().value2(&x, &y, &out, 1);
+    return out;
+}
+
+float ProcUtils::valueNoise(float x, float y, float z)
+{
+    float out;
+    scalarKernels().value3(&x, &y, &z, &out, 1);
+    return out;
+}
+
+float ProcUtils::simplex(float x, float y)
+{
+    float out;
+    scalarKernels().simplex2(&x, &y, &out, 1);
+    return out;
+}
+
+float ProcUtils::simplex(float x, float y, float z)
+{
+    float out;
+    scalarKernels().simplex3(&x, &y, &z, &out, 1);
+    return out;
+}
+
+float ProcUtils::simplex(float x, float y, float z, float w)
+{
+    float out;
+    scalarKernels().simplex4(&x, &y, &z, &w, &out, 1);
+    return out;
+}
+
+float ProcUtils::fbm(float x, float y, float z, int octaves, float persistence, float lacunarity)
+{
+    float out;
+    scalarKernels().fbm3(&x, &y, &z, &out, 1, octaves, persistence, lacunarity);
+    return out;
+}
+
+// ============================================================================
+// Batch evaluation
+// ============================================================================
+
+ProcUtils::SimdLevel ProcUtils::supportedSimdLevel()
+{
+    static const SimdLevel level = [] {
+        if (cpuHasAvx2() && avx2Kernels())
+            return SimdLevel::AVX2;
+#ifdef IVF_NOISE_X86
+        return SimdLevel::SSE2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }();
+
+    return level;
+}
+
+ProcUtils::SimdLevel ProcUtils::simdLevel()
+{
+    return active().level.load();
+}
+
+void ProcUtils::setSimdLevel(SimdLevel level)
+{
+    level = std::min(level, supportedSimdLevel());
+
+    active().level.store(level);
+    active().kernels.store(kernelsFor(level));
+}
+
+void ProcUtils::noise(std::span<const float> x, std::span<const float> y, std::span<float> out)
+{
+    kernels().noise2(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()));
+}
+
+void ProcUtils::noise(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                      std::span<float> out)
+{
+    kernels().noise3(x.data(), y.data(), z.data(), out.data(), batchSize(x.size(), y.size(), z.size(), out.size()));
+}
+
+void ProcUtils::noiseDeriv(std::span<const float> x, std::span<const float> y, std::span<float> out,
+                           std::span<float> dx, std::span<float> dy)
+{
+    kernels().noiseDeriv2(x.data(), y.data(), out.data(), dx.data(), dy.data(),
+                          batchSize(x.size(), y.size(), out.size(), dx.size(), dy.size()));
+}
+
+void ProcUtils::noiseDeriv(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                           std::span<float> out, std::span<float> dx, std::span<float> dy, std::span<float> dz)
+{
+    kernels().noiseDeriv3(x.data(), y.data(), z.data(), out.data(), dx.data(), dy.data(), dz.data(),
+                          batchSize(x.size(), y.size(), z.size(), out.size(), dx.size(), dy.size(), dz.size()));
+}
+
+void ProcUtils::valueNoise(std::span<const float> x, std::span<const float> y, std::span<float> out)
+{
+    kernels().value2(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()));
+}
+
+void ProcUtils::valueNoise(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                           std::span<float> out)
+{
+    kernels().value3(x.data(), y.data(), z.data(), out.data(), batchSize(x.size(), y.size(), z.size(), out.size()));
+}
+
+void ProcUtils::simplex(std::span<const float> x, std::span<const float> y, std::span<float> out)
+{
+    kernels().simplex2(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()));
+}
+
+void ProcUtils::simplex(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                        std::span<float> out)
+{
+    kernels().simplex3(x.data(), y.data(), z.data(), out.data(), batchSize(x.size(), y.size(), z.size(), out.size()));
+}
+
+void ProcUtils::simplex(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                        std::span<const float> w, std::span<float> out)
+{
+    kernels().simplex4(x.data(), y.data(), z.data(), w.data(), out.data(),
+                       batchSize(x.size(), y.size(), z.size(), w.size(), out.size()));
+}
+
+void ProcUtils::voronoi(std::span<const float> x, std::span<const float> y, std::span<float> out, float cellSize)
+{
+    kernels().voronoi(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()), cellSize);
+}
+
+void ProcUtils::fbm(std::span<const float> x, std::span<const float> y, std::span<float> out, int octaves,
+                    float persistence, float lacunarity)
+{
+    kernels().fbm2(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()), octaves, persistence,
+                   lacunarity);
+}
+
+void ProcUtils::fbm(std::span<const float> x, std::span<const float> y, std::span<const float> z,
+                    std::span<float> out, int octaves, float persistence, float lacunarity)
+{
+    kernels().fbm3(x.data(), y.data(), z.data(), out.data(), batchSize(x.size(), y.size(), z.size(), out.size()),
+                   octaves, persistence, lacunarity);
+}
+
+void ProcUtils::turbulence(std::span<const float> x, std::span<const float> y, std::span<float> out, int octaves)
+{
+    kernels().turbulence(x.data(), y.data(), out.data(), batchSize(x.size(), y.size(), out.size()), octaves);
+}
@@ -0,0 +1,16 @@
+// Compiled with AVX2 code generation on x86 (see src/ivf/CMakeLists.txt). Nothing in
+// here may run before ProcUtils has checked that the CPU supports AVX2.
+
+#include "proc_utils_simd.h"
+
+using namespace ivf::noise_detail;
+
+const NoiseKernels *ivf::noise_detail::avx2Kernels()
+{
+#if defined(IVF_NOISE_X86) && defined(__AVX2__)
+    static const NoiseKernels kernels = makeNoiseKernels<Avx2Lanes>();
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
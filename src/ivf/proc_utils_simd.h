@@ -0,0 +1,1010 @@
+#pragma once
+
+/**
+ * @file proc_utils_simd.h
+ * @brief Batch noise kernels of ProcUtils (internal to the ivf library).
+ *
+ * Every noise function is written once as a template over a lane type providing
+ * the float/int vector types and the few operations the kernels need (floor,
+ * table lookup, compare and select, ...). Instantiated with ScalarLanes they
+ * evaluate one sample and back the scalar ProcUtils functions; instantiated with
+ * Sse2Lanes or Avx2Lanes they evaluate 4 or 8 samples per instruction.
+ *
+ * This header is included by proc_utils.cpp and by proc_utils_avx2.cpp, which is
+ * compiled with AVX2 code generation. The functions therefore have internal
+ * linkage, so that the linker can never pick an AVX2 compiled copy for code that
+ * runs on CPUs without AVX2.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IVF_NOISE_X86
+#include <immintrin.h>
+#endif
+
+namespace ivf::noise_detail {
+
+/**
+ * @brief Batch noise entry points for one instruction set.
+ */
+struct NoiseKernels {
+    void (*noise2)(const float *x, const float *y, float *out, size_t n);
+    void (*noise3)(const float *x, const float *y, const float *z, float *out, size_t n);
+    void (*noiseDeriv2)(const float *x, const float *y, float *out, float *dx, float *dy, size_t n);
+    void (*noiseDeriv3)(const float *x, const float *y, const float *z, float *out, float *dx, float *dy, float *dz,
+                        size_t n);
+    void (*value2)(const float *x, const float *y, float *out, size_t n);
+    void (*value3)(const float *x, const float *y, const float *z, float *out, size_t n);
+    void (*simplex2)(const float *x, const float *y, float *out, size_t n);
+    void (*simplex3)(const float *x, const float *y, const float *z, float *out, size_t n);
+    void (*simplex4)(const float *x, const float *y, const float *z, const float *w, float *out, size_t n);
+    void (*voronoi)(const float *x, const float *y, float *out, size_t n, float cellSize);
+    void (*fbm2)(const float *x, const float *y, float *out, size_t n, int octaves, float persistence,
+                 float lacunarity);
+    void (*fbm3)(const float *x, const float *y, const float *z, float *out, size_t n, int octaves,
+                 float persistence, float lacunarity);
+    void (*turbulence)(const float *x, const float *y, float *out, size_t n, int octaves);
+};
+
+/** Permutation table shared with the scalar noise functions (512 entries). */
+const int *permTable();
+
+/** Kernels compiled for AVX2, nullptr if the library was built without them. */
+const NoiseKernels *avx2Kernels();
+
+namespace {
+
+// ---- Lane types ------------------------------------------------------------
+
+struct ScalarLanes {
+    using F = float;
+    using I = int32_t;
+    using M = bool;
+
+    static constexpr size_t width = 1;
+
+    static F load(const float *p) { return *p; }
+    static void store(float *p, F v) { *p = v; }
+    static F set(float v) { return v; }
+    static I seti(int32_t v) { return v; }
+    static F floor(F v) { return std::floor(v); }
+    static I toInt(F v) { return static_cast<I>(v); }
+    static F toFloat(I v) { return static_cast<F>(v); }
+    static I lookup(const int *table, I index) { return table[index]; }
+    static M less(F a, F b) { return a < b; }
+    static M lessi(I a, I b) { return a < b; }
+    static M equali(I a, I b) { return a == b; }
+    static F select(M m, F a, F b) { return m ? a : b; }
+    static F sqrt(F v) { return std::sqrt(v); }
+    static F min(F a, F b) { return std::min(a, b); }
+    static F max(F a, F b) { return std::max(a, b); }
+    static F abs(F v) { return std::abs(v); }
+};
+
+#ifdef IVF_NOISE_X86
+
+struct F4 { __m128 v; };
+struct I4 { __m128i v; };
+struct M4 { __m128 v; };
+
+inline F4 operator+(F4 a, F4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline F4 operator-(F4 a, F4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline F4 operator*(F4 a, F4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline F4 operator/(F4 a, F4 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline I4 operator+(I4 a, I4 b) { return {_mm_add_epi32(a.v, b.v)}; }
+inline I4 operator-(I4 a, I4 b) { return {_mm_sub_epi32(a.v, b.v)}; }
+inline I4 operator&(I4 a, I4 b) { return {_mm_and_si128(a.v, b.v)}; }
+
+struct Sse2Lanes {
+    using F = F4;
+    using I = I4;
+    using M = M4;
+
+    static constexpr size_t width = 4;
+
+    static F load(const float *p) { return {_mm_loadu_ps(p)}; }
+    static void store(float *p, F v) { _mm_storeu_ps(p, v.v); }
+    static F set(float v) { return {_mm_set1_ps(v)}; }
+    static I seti(int32_t v) { return {_mm_set1_epi32(v)}; }
+
+    static F floor(F v)
+    {
+        // SSE2 has no floor, truncate and step down where truncation rounded up
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v.v));
+        return {_mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v.v), _mm_set1_ps(1.0f)))};
+    }
+
+    static I toInt(F v) { return {_mm_cvttps_epi32(v.v)}; }
+    static F toFloat(I v) { return {_mm_cvtepi32_ps(v.v)}; }
+
+    static I lookup(const int *table, I index)
+    {
+        alignas(16) int32_t i[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(i), index.v);
+        return {_mm_setr_epi32(table[i[0]], table[i[1]], table[i[2]], table[i[3]])};
+    }
+
+    static M less(F a, F b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    static M lessi(I a, I b) { return {_mm_castsi128_ps(_mm_cmplt_epi32(a.v, b.v))}; }
+    static M equali(I a, I b) { return {_mm_castsi128_ps(_mm_cmpeq_epi32(a.v, b.v))}; }
+    static F select(M m, F a, F b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+    static F sqrt(F v) { return {_mm_sqrt_ps(v.v)}; }
+    static F min(F a, F b) { return {_mm_min_ps(a.v, b.v)}; }
+    static F max(F a, F b) { return {_mm_max_ps(a.v, b.v)}; }
+    static F abs(F v) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), v.v)}; }
+};
+
+#endif
+
+#if defined(IVF_NOISE_X86) && defined(__AVX2__)
+
+struct F8 { __m256 v; };
+struct I8 { __m256i v; };
+struct M8 { __m256 v; };
+
+inline F8 operator+(F8 a, F8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline F8 operator-(F8 a, F8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline F8 operator*(F8 a, F8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline F8 operator/(F8 a, F8 b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline I8 operator+(I8 a, I8 b) { return {_mm256_add_epi32(a.v, b.v)}; }
+inline I8 operator-(I8 a, I8 b) { return {_mm256_sub_epi32(a.v, b.v)}; }
+inline I8 operator&(I8 a, I8 b) { return {_mm256_and_si256(a.v, b.v)}; }
+
+struct Avx2Lanes {
+    using F = F8;
+    using I = I8;
+    using M = M8;
+
+    static constexpr size_t width = 8;
+
+    static F load(const float *p) { return {_mm256_loadu_ps(p)}; }
+    static void store(float *p, F v) { _mm256_storeu_ps(p, v.v); }
+    static F set(float v) { return {_mm256_set1_ps(v)}; }
+    static I seti(int32_t v) { return {_mm256_set1_epi32(v)}; }
+    static F floor(F v) { return {_mm256_floor_ps(v.v)}; }
+    static I toInt(F v) { return {_mm256_cvttps_epi32(v.v)}; }
+    static F toFloat(I v) { return {_mm256_cvtepi32_ps(v.v)}; }
+    static I lookup(const int *table, I index) { return {_mm256_i32gather_epi32(table, index.v, 4)}; }
+    static M less(F a, F b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    static M lessi(I a, I b) { return {_mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v))}; }
+    static M equali(I a, I b) { return {_mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, b.v))}; }
+    static F select(M m, F a, F b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+    static F sqrt(F v) { return {_mm256_sqrt_ps(v.v)}; }
+    static F min(F a, F b) { return {_mm256_min_ps(a.v, b.v)}; }
+    static F max(F a, F b) { return {_mm256_max_ps(a.v, b.v)}; }
+    static F abs(F v) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), v.v)}; }
+};
+
+#endif
+
+// ---- Building blocks -------------------------------------------------------
+
+// Smoothstep fade t * t * (3 - 2t) and its derivative, as in ProcUtils::smoothstep()
+
+template <class L> typename L::F fade(typename L::F t)
+{
+    return t * t * (L::set(3.0f) - L::set(2.0f) * t);
+}
+
+template <class L> typename L::F fadeDeriv(typename L::F t)
+{
+    return L::set(6.0f) * t * (L::set(1.0f) - t);
+}
+
+template <class L> typename L::F lerp(typename L::F a, typename L::F b, typename L::F t)
+{
+    return a + t * (b - a);
+}
+
+template <class L> typename L::F negateIf(typename L::M m, typename L::F v)
+{
+    return L::select(m, L::set(0.0f) - v, v);
+}
+
+template <class L> typename L::M bitSet(typename L::I h, int32_t bit)
+{
+    return L::lessi(L::seti(0), h & L::seti(bit));
+}
+
+// Gradient of the 2D gradient noise, same 8 directions as ProcUtils::noise()
+
+template <class L>
+void gradVec2(typename L::I hash, typename L::F &gx, typename L::F &gy)
+{
+    using I = typename L::I;
+
+    I h = hash & L::seti(7);
+    auto low = L::lessi(h, L::seti(4));
+    auto su = negateIf<L>(bitSet<L>(h, 1), L::set(1.0f));
+    auto sv = negateIf<L>(bitSet<L>(h, 2), L::set(2.0f));
+
+    gx = L::select(low, su, sv);
+    gy = L::select(low, sv, su);
+}
+
+template <class L>
+typename L::F grad2(typename L::I hash, typename L::F x, typename L::F y)
+{
+    using I = typename L::I;
+
+    I h = hash & L::seti(7);
+    auto low = L::lessi(h, L::seti(4));
+    auto u = L::select(low, x, y);
+    auto v = L::select(low, y, x);
+
+    return negateIf<L>(bitSet<L>(h, 1), u) + negateIf<L>(bitSet<L>(h, 2), L::set(2.0f) * v);
+}
+
+// The 12 cube edge gradients of Perlin's improved noise (16 entries, 4 repeated)
+
+template <class L>
+void gradVec3(typename L::I hash, typename L::F &gx, typename L::F &gy, typename L::F &gz)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F one = L::set(1.0f);
+    const F zero = L::set(0.0f);
+
+    I h = hash & L::seti(15);
+    auto uIsX = L::lessi(h, L::seti(8));
+    auto vIsY = L::lessi(h, L::seti(4));
+    auto vIsX = L::equali(h & L::seti(13), L::seti(12));
+
+    F su = negateIf<L>(bitSet<L>(h, 1), one);
+    F sv = negateIf<L>(bitSet<L>(h, 2), one);
+
+    gx = L::select(uIsX, su, L::select(vIsY, zero, L::select(vIsX, sv, zero)));
+    gy = L::select(uIsX, L::select(vIsY, sv, zero), su);
+    gz = L::select(vIsY, zero, L::select(vIsX, zero, sv));
+}
+
+template <class L>
+typename L::F grad3(typename L::I hash, typename L::F x, typename L::F y, typename L::F z)
+{
+    using I = typename L::I;
+
+    I h = hash & L::seti(15);
+    auto u = L::select(L::lessi(h, L::seti(8)), x, y);
+    auto v = L::select(L::lessi(h, L::seti(4)), y, L::select(L::equali(h & L::seti(13), L::seti(12)), x, z));
+
+    return negateIf<L>(bitSet<L>(h, 1), u) + negateIf<L>(bitSet<L>(h, 2), v);
+}
+
+// 32 gradients toward the edges of a 4D hypercube
+
+template <class L>
+typename L::F grad4(typename L::I hash, typename L::F x, typename L::F y, typename L::F z, typename L::F w)
+{
+    using I = typename L::I;
+
+    I h = hash & L::seti(31);
+    auto a = L::select(L::lessi(h, L::seti(24)), x, y);
+    auto b = L::select(L::lessi(h, L::seti(16)), y, z);
+    auto c = L::select(L::lessi(h, L::seti(8)), z, w);
+
+    return negateIf<L>(bitSet<L>(h, 1), a) + negateIf<L>(bitSet<L>(h, 2), b) + negateIf<L>(bitSet<L>(h, 4), c);
+}
+
+// ---- Gradient (Perlin) noise -----------------------------------------------
+
+template <class L>
+typename L::F perlin2(const int *perm, typename L::F x, typename L::F y)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F one = L::set(1.0f);
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F fx = L::floor(x);
+    F fy = L::floor(y);
+    I xi = L::toInt(fx) & mask;
+    I yi = L::toInt(fy) & mask;
+    F xf = x - fx;
+    F yf = y - fy;
+
+    I px0 = L::lookup(perm, xi);
+    I px1 = L::lookup(perm, xi + onei);
+
+    F g1 = grad2<L>(L::lookup(perm, px0 + yi), xf, yf);
+    F g2 = grad2<L>(L::lookup(perm, px1 + yi), xf - one, yf);
+    F g3 = grad2<L>(L::lookup(perm, px0 + yi + onei), xf, yf - one);
+    F g4 = grad2<L>(L::lookup(perm, px1 + yi + onei), xf - one, yf - one);
+
+    F sx = fade<L>(xf);
+    F sy = fade<L>(yf);
+    F ab = lerp<L>(g1, g2, sx);
+    F cd = lerp<L>(g3, g4, sx);
+
+    return lerp<L>(ab, cd, sy);
+}
+
+template <class L>
+typename L::F perlin2Deriv(const int *perm, typename L::F x, typename L::F y, typename L::F &dx,
+                           typename L::F &dy)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F one = L::set(1.0f);
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F fx = L::floor(x);
+    F fy = L::floor(y);
+    I xi = L::toInt(fx) & mask;
+    I yi = L::toInt(fy) & mask;
+    F xf = x - fx;
+    F yf = y - fy;
+
+    I px0 = L::lookup(perm, xi);
+    I px1 = L::lookup(perm, xi + onei);
+
+    F g1x, g1y, g2x, g2y, g3x, g3y, g4x, g4y;
+    gradVec2<L>(L::lookup(perm, px0 + yi), g1x, g1y);
+    gradVec2<L>(L::lookup(perm, px1 + yi), g2x, g2y);
+    gradVec2<L>(L::lookup(perm, px0 + yi + onei), g3x, g3y);
+    gradVec2<L>(L::lookup(perm, px1 + yi + onei), g4x, g4y);
+
+    F g1 = g1x * xf + g1y * yf;
+    F g2 = g2x * (xf - one) + g2y * yf;
+    F g3 = g3x * xf + g3y * (yf - one);
+    F g4 = g4x * (xf - one) + g4y * (yf - one);
+
+    F sx = fade<L>(xf);
+    F sy = fade<L>(yf);
+    F ab = lerp<L>(g1, g2, sx);
+    F cd = lerp<L>(g3, g4, sx);
+
+    // n = ab + sy * (cd - ab), differentiated through the fades and the corner gradients
+
+    F k = g1 - g2 - g3 + g4;
+    dx = lerp<L>(lerp<L>(g1x, g2x, sx), lerp<L>(g3x, g4x, sx), sy) + fadeDeriv<L>(xf) * (g2 - g1 + sy * k);
+    dy = lerp<L>(lerp<L>(g1y, g2y, sx), lerp<L>(g3y, g4y, sx), sy) + fadeDeriv<L>(yf) * (cd - ab);
+
+    return lerp<L>(ab, cd, sy);
+}
+
+template <class L> struct Cell3 {
+    typename L::F xf, yf, zf;
+    typename L::I h000, h100, h010, h110, h001, h101, h011, h111;
+};
+
+template <class L>
+Cell3<L> cell3(const int *perm, typename L::F x, typename L::F y, typename L::F z)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F fx = L::floor(x);
+    F fy = L::floor(y);
+    F fz = L::floor(z);
+    I xi = L::toInt(fx) & mask;
+    I yi = L::toInt(fy) & mask;
+    I zi = L::toInt(fz) & mask;
+
+    I a = L::lookup(perm, xi) + yi;
+    I aa = L::lookup(perm, a) + zi;
+    I ab = L::lookup(perm, a + onei) + zi;
+    I b = L::lookup(perm, xi + onei) + yi;
+    I ba = L::lookup(perm, b) + zi;
+    I bb = L::lookup(perm, b + onei) + zi;
+
+    Cell3<L> c;
+    c.xf = x - fx;
+    c.yf = y - fy;
+    c.zf = z - fz;
+    c.h000 = L::lookup(perm, aa);
+    c.h100 = L::lookup(perm, ba);
+    c.h010 = L::lookup(perm, ab);
+    c.h110 = L::lookup(perm, bb);
+    c.h001 = L::lookup(perm, aa + onei);
+    c.h101 = L::lookup(perm, ba + onei);
+    c.h011 = L::lookup(perm, ab + onei);
+    c.h111 = L::lookup(perm, bb + onei);
+    return c;
+}
+
+template <class L>
+typename L::F trilerp(typename L::F c000, typename L::F c100, typename L::F c010, typename L::F c110,
+                      typename L::F c001, typename L::F c101, typename L::F c011, typename L::F c111,
+                      typename L::F sx, typename L::F sy, typename L::F sz)
+{
+    auto y0 = lerp<L>(lerp<L>(c000, c100, sx), lerp<L>(c010, c110, sx), sy);
+    auto y1 = lerp<L>(lerp<L>(c001, c101, sx), lerp<L>(c011, c111, sx), sy);
+    return lerp<L>(y0, y1, sz);
+}
+
+template <class L>
+typename L::F perlin3(const int *perm, typename L::F x, typename L::F y, typename L::F z)
+{
+    using F = typename L::F;
+
+    const F one = L::set(1.0f);
+    const Cell3<L> c = cell3<L>(perm, x, y, z);
+
+    F x1 = c.xf - one;
+    F y1 = c.yf - one;
+    F z1 = c.zf - one;
+
+    return trilerp<L>(grad3<L>(c.h000, c.xf, c.yf, c.zf), grad3<L>(c.h100, x1, c.yf, c.zf),
+                      grad3<L>(c.h010, c.xf, y1, c.zf), grad3<L>(c.h110, x1, y1, c.zf),
+                      grad3<L>(c.h001, c.xf, c.yf, z1), grad3<L>(c.h101, x1, c.yf, z1),
+                      grad3<L>(c.h011, c.xf, y1, z1), grad3<L>(c.h111, x1, y1, z1), fade<L>(c.xf), fade<L>(c.yf),
+                      fade<L>(c.zf));
+}
+
+template <class L>
+typename L::F perlin3Deriv(const int *perm, typename L::F x, typename L::F y, typename L::F z, typename L::F &dx,
+                           typename L::F &dy, typename L::F &dz)
+{
+    using F = typename L::F;
+
+    const F one = L::set(1.0f);
+    const Cell3<L> c = cell3<L>(perm, x, y, z);
+
+    const F px[2] = {c.xf, c.xf - one};
+    const F py[2] = {c.yf, c.yf - one};
+    const F pz[2] = {c.zf, c.zf - one};
+    const typename L::I h[8] = {c.h000, c.h100, c.h010, c.h110, c.h001, c.h101, c.h011, c.h111};
+
+    // Corner gradients and values, corner k at offset (k & 1, (k >> 1) & 1, k >> 2)
+
+    F gx[8], gy[8], gz[8], g[8];
+
+    for (int k = 0; k < 8; k++)
+    {
+        gradVec3<L>(h[k], gx[k], gy[k], gz[k]);
+        g[k] = gx[k] * px[k & 1] + gy[k] * py[(k >> 1) & 1] + gz[k] * pz[k >> 2];
+    }
+
+    F sx = fade<L>(c.xf);
+    F sy = fade<L>(c.yf);
+    F sz = fade<L>(c.zf);
+
+    // n = k0 + k1 sx + k2 sy + k3 sz + k4 sx sy + k5 sy sz + k6 sz sx + k7 sx sy sz
+
+    F k1 = g[1] - g[0];
+    F k2 = g[2] - g[0];
+    F k3 = g[4] - g[0];
+    F k4 = g[0] - g[1] - g[2] + g[3];
+    F k5 = g[0] - g[2] - g[4] + g[6];
+    F k6 = g[0] - g[1] - g[4] + g[5];
+    F k7 = g[1] + g[2] + g[4] + g[7] - g[0] - g[3] - g[5] - g[6];
+
+    dx = trilerp<L>(gx[0], gx[1], gx[2], gx[3], gx[4], gx[5], gx[6], gx[7], sx, sy, sz) +
+         fadeDeriv<L>(c.xf) * (k1 + k4 * sy + k6 * sz + k7 * sy * sz);
+    dy = trilerp<L>(gy[0], gy[1], gy[2], gy[3], gy[4], gy[5], gy[6], gy[7], sx, sy, sz) +
+         fadeDeriv<L>(c.yf) * (k2 + k5 * sz + k4 * sx + k7 * sz * sx);
+    dz = trilerp<L>(gz[0], gz[1], gz[2], gz[3], gz[4], gz[5], gz[6], gz[7], sx, sy, sz) +
+         fadeDeriv<L>(c.zf) * (k3 + k6 * sx + k5 * sy + k7 * sx * sy);
+
+    return trilerp<L>(g[0], g[1], g[2], g[3], g[4], g[5], g[6], g[7], sx, sy, sz);
+}
+
+// ---- Value noise -----------------------------------------------------------
+
+template <class L> typename L::F hashToUnit(typename L::I h)
+{
+    return L::toFloat(h) / L::set(255.0f);
+}
+
+template <class L>
+typename L::F value2(const int *perm, typename L::F x, typename L::F y)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F fx = L::floor(x);
+    F fy = L::floor(y);
+    I xi = L::toInt(fx) & mask;
+    I yi = L::toInt(fy) & mask;
+
+    I px0 = L::lookup(perm, xi);
+    I px1 = L::lookup(perm, xi + onei);
+
+    F v00 = hashToUnit<L>(L::lookup(perm, px0 + yi));
+    F v10 = hashToUnit<L>(L::lookup(perm, px1 + yi));
+    F v01 = hashToUnit<L>(L::lookup(perm, px0 + yi + onei));
+    F v11 = hashToUnit<L>(L::lookup(perm, px1 + yi + onei));
+
+    F sx = fade<L>(x - fx);
+    F sy = fade<L>(y - fy);
+    F v = lerp<L>(lerp<L>(v00, v10, sx), lerp<L>(v01, v11, sx), sy);
+
+    return v * L::set(2.0f) - L::set(1.0f);
+}
+
+template <class L>
+typename L::F value3(const int *perm, typename L::F x, typename L::F y, typename L::F z)
+{
+    const Cell3<L> c = cell3<L>(perm, x, y, z);
+
+    auto v = trilerp<L>(hashToUnit<L>(c.h000), hashToUnit<L>(c.h100), hashToUnit<L>(c.h010), hashToUnit<L>(c.h110),
+                        hashToUnit<L>(c.h001), hashToUnit<L>(c.h101), hashToUnit<L>(c.h011), hashToUnit<L>(c.h111),
+                        fade<L>(c.xf), fade<L>(c.yf), fade<L>(c.zf));
+
+    return v * L::set(2.0f) - L::set(1.0f);
+}
+
+// ---- Simplex noise ---------------------------------------------------------
+
+// Contribution of one simplex corner, (r2 - |d|^2)^4 * (gradient . d)
+
+template <class L> typename L::F falloff(typename L::F r2, typename L::F d2)
+{
+    auto t = L::max(r2 - d2, L::set(0.0f));
+    t = t * t;
+    return t * t;
+}
+
+// 1 where a >= b, else 0
+
+template <class L> typename L::F stepGE(typename L::F a, typename L::F b)
+{
+    return L::select(L::less(a, b), L::set(0.0f), L::set(1.0f));
+}
+
+template <class L>
+typename L::F simplex2(const int *perm, typename L::F x, typename L::F y)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F skew = L::set(0.366025403f);   // (sqrt(3) - 1) / 2
+    const F unskew = L::set(0.211324865f); // (3 - sqrt(3)) / 6
+    const F one = L::set(1.0f);
+    const F zero = L::set(0.0f);
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F s = (x + y) * skew;
+    F fi = L::floor(x + s);
+    F fj = L::floor(y + s);
+    F t = (fi + fj) * unskew;
+    F x0 = x - (fi - t);
+    F y0 = y - (fj - t);
+
+    // Lower or upper triangle of the skewed cell
+    F i1 = L::select(L::less(y0, x0), one, zero);
+    F j1 = one - i1;
+
+    F x1 = x0 - i1 + unskew;
+    F y1 = y0 - j1 + unskew;
+    F x2 = x0 - one + unskew + unskew;
+    F y2 = y0 - one + unskew + unskew;
+
+    I ii = L::toInt(fi) & mask;
+    I jj = L::toInt(fj) & mask;
+
+    I h0 = L::lookup(perm, ii + L::lookup(perm, jj));
+    I h1 = L::lookup(perm, ii + L::toInt(i1) + L::lookup(perm, jj + L::toInt(j1)));
+    I h2 = L::lookup(perm, ii + onei + L::lookup(perm, jj + onei));
+
+    const F r2 = L::set(0.5f);
+
+    F n0 = falloff<L>(r2, x0 * x0 + y0 * y0) * grad3<L>(h0, x0, y0, zero);
+    F n1 = falloff<L>(r2, x1 * x1 + y1 * y1) * grad3<L>(h1, x1, y1, zero);
+    F n2 = falloff<L>(r2, x2 * x2 + y2 * y2) * grad3<L>(h2, x2, y2, zero);
+
+    return L::set(70.0f) * (n0 + n1 + n2);
+}
+
+template <class L>
+typename L::F simplex3(const int *perm, typename L::F x, typename L::F y, typename L::F z)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F skew = L::set(1.0f / 3.0f);
+    const F unskew = L::set(1.0f / 6.0f);
+    const F one = L::set(1.0f);
+    const F half = L::set(0.5f);
+    const F threeHalves = L::set(1.5f);
+    const I onei = L::seti(1);
+    const I mask = L::seti(255);
+
+    F s = (x + y + z) * skew;
+    F fi = L::floor(x + s);
+    F fj = L::floor(y + s);
+    F fk = L::floor(z + s);
+    F t = (fi + fj + fk) * unskew;
+    F x0 = x - (fi - t);
+    F y0 = y - (fj - t);
+    F z0 = z - (fk - t);
+
+    // Rank the coordinates to find which of the six simplices of the cube contains the point
+
+    F xy = stepGE<L>(x0, y0);
+    F xz = stepGE<L>(x0, z0);
+    F yz = stepGE<L>(y0, z0);
+    F rankX = xy + xz;
+    F rankY = one - xy + yz;
+    F rankZ = one - xz + one - yz;
+
+    F i1 = stepGE<L>(rankX, threeHalves);
+    F j1 = stepGE<L>(rankY, threeHalves);
+    F k1 = stepGE<L>(rankZ, threeHalves);
+    F i2 = stepGE<L>(rankX, half);
+    F j2 = stepGE<L>(rankY, half);
+    F k2 = stepGE<L>(rankZ, half);
+
+    F x1 = x0 - i1 + unskew;
+    F y1 = y0 - j1 + unskew;
+    F z1 = z0 - k1 + unskew;
+    F x2 = x0 - i2 + unskew + unskew;
+    F y2 = y0 - j2 + unskew + unskew;
+    F z2 = z0 - k2 + unskew + unskew;
+    F x3 = x0 - half;
+    F y3 = y0 - half;
+    F z3 = z0 - half;
+
+    I ii = L::toInt(fi) & mask;
+    I jj = L::toInt(fj) & mask;
+    I kk = L::toInt(fk) & mask;
+
+    auto hash = [&](I di, I dj, I dk) {
+        return L::lookup(perm, ii + di + L::lookup(perm, jj + dj + L::lookup(perm, kk + dk)));
+    };
+
+    I h0 = hash(L::seti(0), L::seti(0), L::seti(0));
+    I h1 = hash(L::toInt(i1), L::toInt(j1), L::toInt(k1));
+    I h2 = hash(L::toInt(i2), L::toInt(j2), L::toInt(k2));
+    I h3 = hash(onei, onei, onei);
+
+    const F r2 = L::set(0.6f);
+
+    F n0 = falloff<L>(r2, x0 * x0 + y0 * y0 + z0 * z0) * grad3<L>(h0, x0, y0, z0);
+    F n1 = falloff<L>(r2, x1 * x1 + y1 * y1 + z1 * z1) * grad3<L>(h1, x1, y1, z1);
+    F n2 = falloff<L>(r2, x2 * x2 + y2 * y2 + z2 * z2) * grad3<L>(h2, x2, y2, z2);
+    F n3 = falloff<L>(r2, x3 * x3 + y3 * y3 + z3 * z3) * grad3<L>(h3, x3, y3, z3);
+
+    return L::set(32.0f) * (n0 + n1 + n2 + n3);
+}
+
+template <class L>
+typename L::F simplex4(const int *perm, typename L::F x, typename L::F y, typename L::F z, typename L::F w)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F skew = L::set(0.309016994f);   // (sqrt(5) - 1) / 4
+    const F unskew = L::set(0.138196601f); // (5 - sqrt(5)) / 20
+    const F one = L::set(1.0f);
+    const I mask = L::seti(255);
+
+    F s = (x + y + z + w) * skew;
+    F fi = L::floor(x + s);
+    F fj = L::floor(y + s);
+    F fk = L::floor(z + s);
+    F fl = L::floor(w + s);
+    F t = (fi + fj + fk + fl) * unskew;
+    F x0 = x - (fi - t);
+    F y0 = y - (fj - t);
+    F z0 = z - (fk - t);
+    F w0 = w - (fl - t);
+
+    // Rank the coordinates, the simplex is traversed from the largest to the smallest
+
+    F xy = stepGE<L>(x0, y0);
+    F xz = stepGE<L>(x0, z0);
+    F xw = stepGE<L>(x0, w0);
+    F yz = stepGE<L>(y0, z0);
+    F yw = stepGE<L>(y0, w0);
+    F zw = stepGE<L>(z0, w0);
+
+    F rank[4] = {xy + xz + xw, one - xy + yz + yw, one - xz + one - yz + zw, one - xw + one - yw + one - zw};
+
+    const F p[4] = {x0, y0, z0, w0};
+    const F ff[4] = {fi, fj, fk, fl};
+    I cell[4];
+
+    for (int a = 0; a < 4; a++)
+        cell[a] = L::toInt(ff[a]) & mask;
+
+    const F r2 = L::set(0.6f);
+    F sum = L::set(0.0f);
+
+    // Corners 0..4, corner c has offset 1 along the axes of rank >= 4 - c
+
+    for (int c = 0; c < 5; c++)
+    {
+        F d[4];
+        I o[4];
+        F offset = L::set(static_cast<float>(c)) * unskew;
+
+        for (int a = 0; a < 4; a++)
+        {
+            F step = c == 0 ? L::set(0.0f) : c == 4 ? one : stepGE<L>(rank[a], L::set(3.5f - c));
+            d[a] = p[a] - step + offset;
+            o[a] = L::toInt(step);
+        }
+
+        I h = L::lookup(perm, cell[0] + o[0] +
+                                  L::lookup(perm, cell[1] + o[1] +
+                                                      L::lookup(perm, cell[2] + o[2] +
+                                                                          L::lookup(perm, cell[3] + o[3]))));
+
+        F d2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] + d[3] * d[3];
+        sum = sum + falloff<L>(r2, d2) * grad4<L>(h, d[0], d[1], d[2], d[3]);
+    }
+
+    return L::set(27.0f) * sum;
+}
+
+// ---- Worley noise ----------------------------------------------------------
+
+// Same hash and feature point placement as ProcUtils::voronoi()
+
+template <class L> typename L::F cellHash(const int *perm, typename L::I a, typename L::I b)
+{
+    const auto mask = L::seti(255);
+    return hashToUnit<L>(L::lookup(perm, (L::lookup(perm, a & mask) + b) & mask));
+}
+
+template <class L>
+typename L::F worley(const int *perm, typename L::F x, typename L::F y, typename L::F cellSize)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    F sx = x / cellSize;
+    F sy = y / cellSize;
+    I cx = L::toInt(L::floor(sx));
+    I cy = L::toInt(L::floor(sy));
+
+    F minDist = L::set(1000.0f);
+
+    for (int dy = -1; dy <= 1; dy++)
+    {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            I nx = cx + L::seti(dx);
+            I ny = cy + L::seti(dy);
+
+            F px = L::toFloat(nx) + cellHash<L>(perm, nx, ny);
+            F py = L::toFloat(ny) + cellHash<L>(perm, ny, nx);
+
+            F distX = sx - px;
+            F distY = sy - py;
+
+            minDist = L::min(minDist, L::sqrt(distX * distX + distY * distY));
+        }
+    }
+
+    return minDist;
+}
+
+// ---- Batch drivers ---------------------------------------------------------
+
+// Full vectors with L, the remaining samples one at a time with the same code
+
+template <class L, class Fn> void forEachLane(size_t n, Fn &&fn)
+{
+    size_t i = 0;
+
+    for (; i + L::width <= n; i += L::width)
+        fn(L{}, i);
+
+    for (; i < n; i++)
+        fn(ScalarLanes{}, i);
+}
+
+template <class L> void noise2Batch(const float *x, const float *y, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, perlin2<V>(perm, V::load(x + i), V::load(y + i)));
+    });
+}
+
+template <class L> void noise3Batch(const float *x, const float *y, const float *z, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, perlin3<V>(perm, V::load(x + i), V::load(y + i), V::load(z + i)));
+    });
+}
+
+template <class L>
+void noiseDeriv2Batch(const float *x, const float *y, float *out, float *dx, float *dy, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        typename V::F ddx, ddy;
+        V::store(out + i, perlin2Deriv<V>(perm, V::load(x + i), V::load(y + i), ddx, ddy));
+        V::store(dx + i, ddx);
+        V::store(dy + i, ddy);
+    });
+}
+
+template <class L>
+void noiseDeriv3Batch(const float *x, const float *y, const float *z, float *out, float *dx, float *dy, float *dz,
+                      size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        typename V::F ddx, ddy, ddz;
+        V::store(out + i, perlin3Deriv<V>(perm, V::load(x + i), V::load(y + i), V::load(z + i), ddx, ddy, ddz));
+        V::store(dx + i, ddx);
+        V::store(dy + i, ddy);
+        V::store(dz + i, ddz);
+    });
+}
+
+template <class L> void value2Batch(const float *x, const float *y, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, value2<V>(perm, V::load(x + i), V::load(y + i)));
+    });
+}
+
+template <class L> void value3Batch(const float *x, const float *y, const float *z, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, value3<V>(perm, V::load(x + i), V::load(y + i), V::load(z + i)));
+    });
+}
+
+template <class L> void simplex2Batch(const float *x, const float *y, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, simplex2<V>(perm, V::load(x + i), V::load(y + i)));
+    });
+}
+
+template <class L> void simplex3Batch(const float *x, const float *y, const float *z, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, simplex3<V>(perm, V::load(x + i), V::load(y + i), V::load(z + i)));
+    });
+}
+
+template <class L>
+void simplex4Batch(const float *x, const float *y, const float *z, const float *w, float *out, size_t n)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, simplex4<V>(perm, V::load(x + i), V::load(y + i), V::load(z + i), V::load(w + i)));
+    });
+}
+
+template <class L> void voronoiBatch(const float *x, const float *y, float *out, size_t n, float cellSize)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+        V::store(out + i, worley<V>(perm, V::load(x + i), V::load(y + i), V::set(cellSize)));
+    });
+}
+
+// Octave sums as in ProcUtils::fbm() and ProcUtils::turbulence()
+
+template <class L>
+void fbm2Batch(const float *x, const float *y, float *out, size_t n, int octaves, float persistence,
+               float lacunarity)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+
+        auto px = V::load(x + i);
+        auto py = V::load(y + i);
+        auto total = V::set(0.0f);
+        float frequency = 1.0f;
+        float amplitude = 1.0f;
+        float maxValue = 0.0f;
+
+        for (int o = 0; o < octaves; o++)
+        {
+            auto f = V::set(frequency);
+            total = total + perlin2<V>(perm, px * f, py * f) * V::set(amplitude);
+            maxValue += amplitude;
+            amplitude *= persistence;
+            frequency *= lacunarity;
+        }
+
+        V::store(out + i, total / V::set(maxValue));
+    });
+}
+
+template <class L>
+void fbm3Batch(const float *x, const float *y, const float *z, float *out, size_t n, int octaves, float persistence,
+               float lacunarity)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+
+        auto px = V::load(x + i);
+        auto py = V::load(y + i);
+        auto pz = V::load(z + i);
+        auto total = V::set(0.0f);
+        float frequency = 1.0f;
+        float amplitude = 1.0f;
+        float maxValue = 0.0f;
+
+        for (int o = 0; o < octaves; o++)
+        {
+            auto f = V::set(frequency);
+            total = total + perlin3<V>(perm, px * f, py * f, pz * f) * V::set(amplitude);
+            maxValue += amplitude;
+            amplitude *= persistence;
+            frequency *= lacunarity;
+        }
+
+        V::store(out + i, total / V::set(maxValue));
+    });
+}
+
+template <class L> void turbulenceBatch(const float *x, const float *y, float *out, size_t n, int octaves)
+{
+    const int *perm = permTable();
+    forEachLane<L>(n, [&](auto lanes, size_t i) {
+        using V = decltype(lanes);
+
+        auto px = V::load(x + i);
+        auto py = V::load(y + i);
+        auto total = V::set(0.0f);
+        float frequency = 1.0f;
+        float amplitude = 1.0f;
+
+        for (int o = 0; o < octaves; o++)
+        {
+            auto f = V::set(frequency);
+            total = total + V::abs(perlin2<V>(perm, px * f, py * f)) * V::set(amplitude);
+            amplitude *= 0.5f;
+            frequency *= 2.0f;
+        }
+
+        V::store(out + i, total);
+    });
+}
+
+template <class L> NoiseKernels makeNoiseKernels()
+{
+    NoiseKernels k;
+    k.noise2 = noise2Batch<L>;
+    k.noise3 = noise3Batch<L>;
+    k.noiseDeriv2 = noiseDeriv2Batch<L>;
+    k.noiseDeriv3 = noiseDeriv3Batch<L>;
+    k.value2 = value2Batch<L>;
+    k.value3 = value3Batch<L>;
+    k.simplex2 = simplex2Batch<L>;
+    k.simplex3 = simplex3Batch<L>;
+    k.simplex4 = simplex4Batch<L>;
+    k.voronoi = voronoiBatch<L>;
+    k.fbm2 = fbm2Batch<L>;
+    k.fbm3 = fbm3Batch<L>;
+    k.turbulence = turbulenceBatch<L>;
+    return k;
+}
+
+} // namespace
+
+} // namespace ivf::noise_detail
@@ -1,10 +1,78 @@
 #include <ivf/procedural_texture.h>
+#include <ivf/thread_pool.h>
 #include <ivf/utils.h>
 #include <ivf/logger.h>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 using namespace ivf;
 
+namespace {
+
+// Pixels per batch noise call in the kernels
+constexpr int batchSize = 64;
+
+inline unsigned char toByte(float value)
+{
+    return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+}
+
+// Generate tiles until none are left. Tiles are claimed from a shared counter, so any
+// number of threads can run this concurrently on the same image.
+
+void generateTiles(const ProceduralTexture::RowKernel &kernel, int width, int height, int channels, int tileSize,
+                   unsigned char *data, std::atomic<int> &nextTile, const std::atomic<bool> *cancel)
+{
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+    const int tileCount = tilesX * tilesY;
+
+    std::vector<glm::vec4> row(tileSize);
+
+    for (int tile = nextTile++; tile < tileCount; tile = nextTile++)
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+            return;
+
+        const int x0 = (tile % tilesX) * tileSize;
+        const int y0 = (tile / tilesX) * tileSize;
+        const int count = std::min(tileSize, width - x0);
+        const int y1 = std::min(y0 + tileSize, height);
+
+        for (int y = y0; y < y1; y++)
+        {
+            kernel(x0, y, count, row.data());
+
+            unsigned char *dst = data + (static_cast<size_t>(y) * width + x0) * channels;
+
+            if (channels == 4)
+            {
+                for (int i = 0; i < count; i++, dst += 4)
+                {
+                    dst[0] = toByte(row[i].r);
+                    dst[1] = toByte(row[i].g);
+                    dst[2] = toByte(row[i].b);
+                    dst[3] = toByte(row[i].a);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < count; i++, dst += 3)
+                {
+                    dst[0] = toByte(row[i].r);
+                    dst[1] = toByte(row[i].g);
+                    dst[2] = toByte(row[i].b);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
 // ============================================================================
 // ProceduralTexture Base Class
 // ============================================================================
@@ -16,6 +84,10 @@ ProceduralTexture::ProceduralTexture()
 
 ProceduralTexture::~ProceduralTexture()
 {
+    this->cancelGeneration();
+
+    if (m_pbo)
+        glDeleteBuffers(1, &m_pbo);
 }
 
 void ProceduralTexture::setSize(int width, int height)
@@ -37,6 +109,11 @@ void ProceduralTexture::setChannels(int channels)
     }
 }
 
+void ProceduralTexture::setTileSize(int size)
+{
+    m_tileSize = std::max(size, 8);
+}
+
 void ProceduralTexture::setPixel(int x, int y, const glm::vec4 &color)
 {
     if (x < 0 || x >= m_width || y < 0 || y >= m_height)
@@ -44,29 +121,161 @@ void ProceduralTexture::setPixel(int x, int y, const glm::vec4 &color)
 
     int index = (y * m_width + x) * m_channels;
     
-    m_data[index + 0] = static_cast<unsigned char>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f);
-    m_data[index + 1] = static_cast<unsigned char>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f);
-    m_data[index + 2] = static_cast<unsigned char>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f);
+    m_data[index + 0] = toByte(color.r);
+    m_data[index + 1] = toByte(color.g);
+    m_data[index + 2] = toByte(color.b);
     
     if (m_channels == 4) {
-        m_data[index + 3] = static_cast<unsigned char>(std::clamp(color.a, 0.0f, 1.0f) * 255.0f);
+        m_data[index + 3] = toByte(color.a);
     }
 }
 
+ProceduralTexture::RowKernel ProceduralTexture::makeKernel()
+{
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+
+    // Calls back into the texture, a background job must be cancelled by the derived destructor
+    return [this, width, height](int x, int y, int count, glm::vec4 *out) {
+        float v = static_cast<float>(y) / height;
+        for (int i = 0; i < count; i++)
+            out[i] = this->getPixel(static_cast<float>(x + i) / width, v);
+    };
+}
+
+void ProceduralTexture::generate()
+{
+    auto kernel = this->makeKernel();
+    auto pool = ThreadPool::instance();
+
+    std::atomic<int> nextTile{0};
+
+    pool->parallelFor(0, pool->workerCount() + 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            generateTiles(kernel, m_width, m_height, m_channels, m_tileSize, m_data.data(), nextTile, nullptr);
+    });
+}
+
 void ProceduralTexture::regenerate()
 {
     logInfofc("ProceduralTexture", "Regenerating texture: {}x{}, {} channels", m_width, m_height, m_channels);
+
+    this->cancelGeneration();
     
     // Allocate data buffer
-    m_data.resize(m_width * m_height * m_channels);
+    m_data.resize(static_cast<size_t>(m_width) * m_height * m_channels);
     
     // Generate the texture
+    auto start = std::chrono::steady_clock::now();
+
     generate();
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    logInfofc("ProceduralTexture", "Generated {}x{} texture in {:.1f} ms", m_width, m_height, elapsed);
     
     // Upload to GPU
     upload();
     
     m_needsRegeneration = false;
+    m_ready = true;
+}
+
+void ProceduralTexture::regenerateAsync()
+{
+    m_needsRegeneration = false;
+    m_ready = false;
+
+    // A running job works on outdated parameters, stop it and start over in update()
+
+    if (m_job.valid()) {
+        m_jobCancel->store(true);
+        m_jobRestart = true;
+        return;
+    }
+
+    this->startJob();
+}
+
+void ProceduralTexture::startJob()
+{
+    m_jobWidth = m_width;
+    m_jobHeight = m_height;
+    m_jobChannels = m_channels;
+    m_jobRestart = false;
+    m_jobCancel = std::make_shared<std::atomic<bool>>(false);
+    m_jobData = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(m_width) * m_height * m_channels);
+
+    // The job runs on its own threads rather than the ThreadPool. A frame waiting in
+    // ThreadPool::parallelFor() helps with queued tasks and would otherwise pick up tiles.
+
+    m_job = std::async(std::launch::async, [kernel = this->makeKernel(), data = m_jobData, cancel = m_jobCancel,
+                                            width = m_width, height = m_height, channels = m_channels,
+                                            tileSize = m_tileSize]() {
+        unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        std::atomic<int> nextTile{0};
+        std::vector<std::thread> helpers;
+
+        for (unsigned int i = 1; i < threadCount; i++)
+            helpers.emplace_back([&] {
+                generateTiles(kernel, width, height, channels, tileSize, data->data(), nextTile, cancel.get());
+            });
+
+        generateTiles(kernel, width, height, channels, tileSize, data->data(), nextTile, cancel.get());
+
+        for (auto &helper : helpers)
+            helper.join();
+    });
+}
+
+void ProceduralTexture::cancelGeneration()
+{
+    if (!m_job.valid())
+        return;
+
+    m_jobCancel->store(true);
+    m_job.get();
+    m_jobData.reset();
+    m_jobRestart = false;
+}
+
+bool ProceduralTexture::update()
+{
+    if (!m_job.valid() || m_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    m_job.get();
+
+    if (m_jobRestart) {
+        this->startJob();
+        return false;
+    }
+
+    auto data = std::move(m_jobData);
+
+    // Discard results for a size or format that has been changed while generating
+
+    if (m_jobWidth != m_width || m_jobHeight != m_height || m_jobChannels != m_channels) {
+        m_needsRegeneration = true;
+        return false;
+    }
+
+    m_data.swap(*data);
+
+    upload();
+
+    m_ready = true;
+    return true;
+}
+
+bool ProceduralTexture::ready() const
+{
+    return m_ready;
+}
+
+bool ProceduralTexture::generating() const
+{
+    return m_job.valid();
 }
 
 void ProceduralTexture::upload()
@@ -84,18 +293,54 @@ void ProceduralTexture::upload()
     this->setIntFormat(internalFormat);
     
     GL_ERR_BEGIN;
-    
+
+    // Stage the pixels in a pixel buffer object, the driver copies them to the texture
+    // asynchronously instead of stalling on a client memory transfer. The buffer is
+    // orphaned first so that a transfer still in flight is not waited for.
+
+    if (!m_pbo)
+        glGenBuffers(1, &m_pbo);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, m_data.size(), nullptr, GL_STREAM_DRAW);
+
+    const void *pixels = nullptr;
+
+    void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_data.size(),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (mapped)
+        std::memcpy(mapped, m_data.data(), m_data.size());
+
+    if (!mapped || glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        pixels = m_data.data();
+    }
+
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, this->id());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // RGB rows are not 4-byte aligned for all widths
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     
-    // Upload texture data (note: using same convention as Texture::load())
-    glTexImage2D(GL_TEXTURE_2D, 0, format, m_width, m_height, 0, internalFormat, GL_UNSIGNED_BYTE, m_data.data());
+    // Upload texture data (note: using same convention as Texture::load()). The storage
+    // is only reallocated when the size or format changes.
+    if (m_width != m_uploadedWidth || m_height != m_uploadedHeight || m_channels != m_uploadedChannels) {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, m_width, m_height, 0, internalFormat, GL_UNSIGNED_BYTE, pixels);
+        m_uploadedWidth = m_width;
+        m_uploadedHeight = m_height;
+        m_uploadedChannels = m_channels;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, internalFormat, GL_UNSIGNED_BYTE, pixels);
+    }
     glGenerateMipmap(GL_TEXTURE_2D);
-    
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     
     GL_ERR_END("ProceduralTexture::upload()");
@@ -143,15 +388,20 @@ glm::vec4 CheckerboardTexture::getPixel(float u, float v)
     return (checker > 0.5f) ? m_color1 : m_color2;
 }
 
-void CheckerboardTexture::generate()
+ProceduralTexture::RowKernel CheckerboardTexture::makeKernel()
 {
-    for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            float u = static_cast<float>(x) / m_width;
-            float v = static_cast<float>(y) / m_height;
-            setPixel(x, y, getPixel(u, v));
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    const float size = static_cast<float>(m_checkerSize);
+
+    return [width, height, size, color1 = m_color1, color2 = m_color2](int x, int y, int count, glm::vec4 *out) {
+        // Same expression as getPixel(), so both produce identical checker edges
+        int yi = static_cast<int>(std::floor(static_cast<float>(y) / height * height / size));
+        for (int i = 0; i < count; i++) {
+            int xi = static_cast<int>(std::floor(static_cast<float>(x + i) / width * width / size));
+            out[i] = ((xi + yi) & 1) ? color1 : color2;
         }
-    }
+    };
 }
 
 // ============================================================================
@@ -214,15 +464,30 @@ glm::vec4 PerlinNoiseTexture::getPixel(float u, float v)
     return ProcUtils::mixColors(m_colorLow, m_colorHigh, t);
 }
 
-void PerlinNoiseTexture::generate()
+ProceduralTexture::RowKernel PerlinNoiseTexture::makeKernel()
 {
-    for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            float u = static_cast<float>(x) / m_width;
-            float v = static_cast<float>(y) / m_height;
-            setPixel(x, y, getPixel(u, v));
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+
+    return [width, height, scale = m_scale, octaves = m_octaves, persistence = m_persistence,
+            lacunarity = m_lacunarity, colorLow = m_colorLow,
+            colorHigh = m_colorHigh](int x, int y, int count, glm::vec4 *out) {
+        float v = static_cast<float>(y) / height;
+        float px[batchSize], py[batchSize], noise[batchSize];
+
+        for (int first = 0; first < count; first += batchSize) {
+            int n = std::min(batchSize, count - first);
+            for (int i = 0; i < n; i++) {
+                px[i] = static_cast<float>(x + first + i) / width * scale;
+                py[i] = v * scale;
+            }
+
+            ProcUtils::fbm({px, size_t(n)}, {py, size_t(n)}, {noise, size_t(n)}, octaves, persistence, lacunarity);
+
+            for (int i = 0; i < n; i++)
+                out[first + i] = ProcUtils::mixColors(colorLow, colorHigh, (noise[i] + 1.0f) * 0.5f);
         }
-    }
+    };
 }
 
 // ============================================================================
@@ -281,15 +546,24 @@ glm::vec4 GradientTexture::getPixel(float u, float v)
     return ProcUtils::mixColors(m_colorStart, m_colorEnd, t);
 }
 
-void GradientTexture::generate()
+ProceduralTexture::RowKernel GradientTexture::makeKernel()
 {
-    for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            float u = static_cast<float>(x) / m_width;
-            float v = static_cast<float>(y) / m_height;
-            setPixel(x, y, getPixel(u, v));
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    const float dx = std::cos(m_angle);
+    const float dy = std::sin(m_angle);
+
+    return [width, height, dx, dy, linear = m_type == GradientType::Linear, center = m_center,
+            colorStart = m_colorStart, colorEnd = m_colorEnd](int x, int y, int count, glm::vec4 *out) {
+        float v = static_cast<float>(y) / height;
+        for (int i = 0; i < count; i++) {
+            float u = static_cast<float>(x + i) / width;
+            float cu = u - center.x;
+            float cv = v - center.y;
+            float t = linear ? u * dx + v * dy : std::sqrt(cu * cu + cv * cv);
+            out[i] = ProcUtils::mixColors(colorStart, colorEnd, t);
         }
-    }
+    };
 }
 
 // ============================================================================
@@ -335,15 +609,33 @@ glm::vec4 MarbleTexture::getPixel(float u, float v)
     return ProcUtils::mixColors(m_color1, m_color2, marble);
 }
 
-void MarbleTexture::generate()
+ProceduralTexture::RowKernel MarbleTexture::makeKernel()
 {
-    for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            float u = static_cast<float>(x) / m_width;
-            float v = static_cast<float>(y) / m_height;
-            setPixel(x, y, getPixel(u, v));
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+
+    return [width, height, scale = m_scale, octaves = m_octaves, color1 = m_color1,
+            color2 = m_color2](int x, int y, int count, glm::vec4 *out) {
+        // ProcUtils::marble() with the noise evaluated in batches
+        float v = static_cast<float>(y) / height;
+        float u[batchSize], px[batchSize], py[batchSize], noise[batchSize];
+
+        for (int first = 0; first < count; first += batchSize) {
+            int n = std::min(batchSize, count - first);
+            for (int i = 0; i < n; i++) {
+                u[i] = static_cast<float>(x + first + i) / width;
+                px[i] = u[i] * scale;
+                py[i] = v * scale;
+            }
+
+            ProcUtils::fbm({px, size_t(n)}, {py, size_t(n)}, {noise, size_t(n)}, octaves);
+
+            for (int i = 0; i < n; i++) {
+                float marble = (std::sin((u[i] * scale + noise[i] * 2.0f) * 3.14159f) + 1.0f) * 0.5f;
+                out[first + i] = ProcUtils::mixColors(color1, color2, marble);
+            }
         }
-    }
+    };
 }
 
 // ============================================================================
@@ -393,13 +685,33 @@ glm::vec4 WoodTexture::getPixel(float u, float v)
     return ProcUtils::mixColors(m_color1, m_color2, wood);
 }
 
-void WoodTexture::generate()
+ProceduralTexture::RowKernel WoodTexture::makeKernel()
 {
-    for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            float u = static_cast<float>(x) / m_width;
-            float v = static_cast<float>(y) / m_height;
-            setPixel(x, y, getPixel(u, v));
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+
+    return [width, height, scale = m_scale, rings = m_rings, color1 = m_color1,
+            color2 = m_color2](int x, int y, int count, glm::vec4 *out) {
+        // Centered coordinates, as in getPixel()
+        float cy = (static_cast<float>(y) / height - 0.5f) * 2.0f;
+        float cx[batchSize], px[batchSize], py[batchSize], noise[batchSize];
+
+        // ProcUtils::wood() with the noise evaluated in batches
+        for (int first = 0; first < count; first += batchSize) {
+            int n = std::min(batchSize, count - first);
+            for (int i = 0; i < n; i++) {
+                cx[i] = (static_cast<float>(x + first + i) / width - 0.5f) * 2.0f;
+                px[i] = cx[i] * 5.0f;
+                py[i] = cy * 5.0f;
+            }
+
+            ProcUtils::noise({px, size_t(n)}, {py, size_t(n)}, {noise, size_t(n)});
+
+            for (int i = 0; i < n; i++) {
+                float dist = std::sqrt(cx[i] * cx[i] + cy * cy) * scale;
+                float wood = (std::sin((dist + noise[i] * 0.3f) * rings * 3.14159f) + 1.0f) * 0.5f;
+                out[first + i] = ProcUtils::mixColors(color1, color2, wood);
+            }
         }
-    }
+    };
 }
@@ -39,6 +39,11 @@ size_t Program::shaderCount()
     return m_shaders.size();
 }
 
+void Program::setFeedbackVaryings(const std::vector<std::string> &varyings)
+{
+    m_feedbackVaryings = varyings;
+}
+
 bool Program::link()
 {
     if (m_id != -1)
@@ -51,6 +56,15 @@ bool Program::link()
     for (int i = 0; i < (int)m_shaders.size(); i++)
         glAttachShader(m_id, m_shaders[i]->id());
 
+    if (!m_feedbackVaryings.empty())
+    {
+        std::vector<const GLchar *> varyings;
+        for (auto &varying : m_feedbackVaryings)
+            varyings.push_back(varying.c_str());
+
+        glTransformFeedbackVaryings(m_id, GLsizei(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+
     glLinkProgram(m_id);
 
     GLint result = GL_FALSE;
@@ -187,6 +201,16 @@ void ivf::Program::uniformVec3f(GLint id, float v0, float v1, float v2)
     GL_ERR(glUniform3f(id, v0, v1, v2));
 }
 
+void ivf::Program::uniformVec2(std::string_view name, const glm::vec2 v)
+{
+    GL_ERR(glUniform2f(uniformLoc(name), v.x, v.y));
+}
+
+void ivf::Program::uniformVec2(GLint id, const glm::vec2 v)
+{
+    GL_ERR(glUniform2f(id, v.x, v.y));
+}
+
 void ivf::Program::uniformVec3(std::string_view name, const glm::vec3 v)
 {
     GL_ERR(glUniform3f(uniformLoc(name), v.x, v.y, v.z));
@@ -226,6 +250,15 @@ void ivf::Program::uniformIntArray(std::string_view name, int count, const int *
     }
 }
 
+void ivf::Program::uniformVec4Array(std::string_view name, int count, const glm::vec4 *values)
+{
+    GLint location = glGetUniformLocation(m_id, name.data());
+    if (location != -1)
+    {
+        glUniform4fv(location, count, glm::value_ptr(values[0]));
+    }
+}
+
 void ivf::Program::uniformMatrix4Array(std::string_view name, int count, const glm::mat4 *matrices)
 {
     for (int i = 0; i < count; i++)
@@ -1,13 +1,14 @@
 #include <ivf/random_deformer.h>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
 using namespace ivf;
 
 RandomDeformer::RandomDeformer(NoiseType noiseType, DeformationMode mode)
     : m_noiseType(noiseType), m_mode(mode), m_intensity(1.0f), m_frequency(1.0f), m_offset(0.0f), m_direction(0, 1, 0),
       m_center(0.0f), m_time(0.0f), m_seed(12345), m_octaves(4), m_persistence(0.5f), m_lacunarity(2.0f), m_rng(m_seed),
-      m_uniformDist(-1.0f, 1.0f), m_gaussianDist(0.0f, 1.0f), m_cacheValid(false)
+      m_uniformDist(-1.0f, 1.0f), m_gaussianDist(0.0f, 1.0f)
 {}
 
 std::shared_ptr<RandomDeformer> RandomDeformer::create(NoiseType noiseType, DeformationMode mode)
@@ -29,6 +30,7 @@ RandomDeformer::NoiseType RandomDeformer::noiseType() const
 void RandomDeformer::setDeformationMode(DeformationMode mode)
 {
     m_mode = mode;
+    markChanged();
 }
 
 RandomDeformer::DeformationMode RandomDeformer::deformationMode() const
@@ -84,6 +86,7 @@ glm::vec3 RandomDeformer::offset() const
 void RandomDeformer::setDirection(const glm::vec3 &direction)
 {
     m_direction = glm::normalize(direction);
+    markChanged();
 }
 
 glm::vec3 RandomDeformer::direction() const
@@ -94,6 +97,7 @@ glm::vec3 RandomDeformer::direction() const
 void RandomDeformer::setCenter(const glm::vec3 &center)
 {
     m_center = center;
+    markChanged();
 }
 
 glm::vec3 RandomDeformer::center() const
@@ -162,7 +166,9 @@ float RandomDeformer::lacunarity() const
 
 void RandomDeformer::invalidateCache()
 {
-    m_cacheValid = false;
+    for (auto &cache : m_caches)
+        cache.valid = false;
+    markChanged();
 }
 
 void RandomDeformer::regenerateNoise()
@@ -177,29 +183,51 @@ void RandomDeformer::apply()
 
     GLuint numVertices = m_originalVertices->rows();
 
+    // One cache per input slot, so that every mesh keeps the noise of its own positions
+    m_caches.resize(m_inputSlotCount);
+    auto &cache = m_caches[m_inputSlot];
+
     // Ensure cache is the right size
-    if (m_noiseCache.size() != numVertices)
+    if (cache.noise.size() != numVertices)
     {
-        m_noiseCache.resize(numVertices);
-        m_cacheValid = false;
+        cache.noise.resize(numVertices);
+        cache.valid = false;
     }
 
     // Regenerate noise if cache is invalid
-    if (!m_cacheValid)
+    if (!cache.valid)
     {
+        cache.bound = glm::vec3(0.0f);
+        cache.length = 0.0f;
         for (GLuint i = 0; i < numVertices; ++i)
         {
             glm::vec3 originalPos = m_originalVertices->vertex(i);
-            m_noiseCache[i] = generateNoise(originalPos, i);
+            cache.noise[i] = generateNoise(originalPos, i);
+            cache.bound = glm::max(cache.bound, glm::abs(cache.noise[i]));
+            cache.length = std::max(cache.length, glm::length(cache.noise[i]));
         }
-        m_cacheValid = true;
+        cache.valid = true;
     }
 
     // Apply deformation
-    for (GLuint i = 0; i < numVertices; ++i)
+    std::memcpy(m_deformedVertices->data(), m_originalVertices->data(), m_originalVertices->memSize());
+    applyKernel(reinterpret_cast<glm::vec3 *>(m_deformedVertices->data()), 0, numVertices);
+}
+
+bool RandomDeformer::prepareKernel(GLuint vertexCount)
+{
+    // The noise is generated from the input positions by apply(), which has to run first. The
+    // kernel does not know which pass a block belongs to, so only a single input is fused.
+    return m_inputSlotCount == 1 && m_caches.size() == 1 && m_caches[0].valid &&
+           m_caches[0].noise.size() == vertexCount;
+}
+
+void RandomDeformer::applyKernel(glm::vec3 *positions, GLuint first, GLuint count) const
+{
+    for (GLuint i = 0; i < count; ++i)
     {
-        glm::vec3 originalPos = m_originalVertices->vertex(i);
-        glm::vec3 noise = m_noiseCache[i] * m_weight;
+        glm::vec3 originalPos = positions[i];
+        glm::vec3 noise = m_caches[m_inputSlot].noise[first + i] * m_weight;
         glm::vec3 deformedPos;
 
         switch (m_mode)
@@ -245,10 +273,52 @@ void RandomDeformer::apply()
             break;
         }
 
-        m_deformedVertices->setVertex(i, deformedPos.x, deformedPos.y, deformedPos.z);
+        positions[i] = deformedPos;
     }
 }
 
+bool RandomDeformer::transformBounds(BoundingBox &bbox) const
+{
+    // Bounded by the largest noise of all caches, as the Gaussian noise has no analytic bound.
+    // The box may cover several meshes, each displaced by the noise of its own cache.
+    if (m_caches.empty())
+        return false;
+
+    glm::vec3 noise(0.0f);
+    float noiseLength = 0.0f;
+    for (auto &cache : m_caches)
+    {
+        if (!cache.valid)
+            return false;
+
+        noise = glm::max(noise, cache.bound * m_weight);
+        noiseLength = std::max(noiseLength, cache.length * m_weight);
+    }
+
+    switch (m_mode)
+    {
+    case DeformationMode::ABSOLUTE:
+        bbox.setBounds(-noise, noise);
+        break;
+
+    case DeformationMode::DIRECTIONAL: {
+        glm::vec3 displacement = m_direction * noiseLength;
+        bbox.setBounds(bbox.min() + glm::min(displacement, glm::vec3(0.0f)),
+                       bbox.max() + glm::max(displacement, glm::vec3(0.0f)));
+        break;
+    }
+
+    case DeformationMode::RADIAL:
+        bbox.setBounds(bbox.min() - glm::vec3(noiseLength), bbox.max() + glm::vec3(noiseLength));
+        break;
+
+    default:
+        bbox.setBounds(bbox.min() - noise, bbox.max() + noise);
+        break;
+    }
+    return true;
+}
+
 std::unique_ptr<Deformer> RandomDeformer::clone() const
 {
     auto cloned = std::make_unique<RandomDeformer>(m_noiseType, m_mode);
@@ -465,3 +535,8 @@ void ivf::RandomDeformer::setupProperties()
     this->addProperty("Persistence", &m_persistence, "RandomNoise");
     this->addProperty("Lacunarity", &m_lacunarity, "RandomNoise");
 }
+
+void ivf::RandomDeformer::onPropertyChanged([[maybe_unused]] const std::string &propertyName)
+{
+    invalidateCache();
+}
@@ -0,0 +1,330 @@
+#include <ivf/render_target.h>
+
+#include <ivf/logger.h>
+
+using namespace ivf;
+
+namespace {
+
+void pixelTransferFormat(GLenum internalFormat, GLenum &format, GLenum &type)
+{
+    switch (internalFormat)
+    {
+    case GL_R8:
+        format = GL_RED;
+        type = GL_UNSIGNED_BYTE;
+        break;
+    case GL_R16F:
+    case GL_R32F:
+        format = GL_RED;
+        type = GL_FLOAT;
+        break;
+    case GL_R32UI:
+        format = GL_RED_INTEGER;
+        type = GL_UNSIGNED_INT;
+        break;
+    case GL_RG16F:
+    case GL_RG32F:
+        format = GL_RG;
+        type = GL_FLOAT;
+        break;
+    case GL_RGB:
+    case GL_RGB8:
+        format = GL_RGB;
+        type = GL_UNSIGNED_BYTE;
+        break;
+    case GL_RGB16F:
+    case GL_RGB32F:
+    case GL_R11F_G11F_B10F:
+        format = GL_RGB;
+        type = GL_FLOAT;
+        break;
+    case GL_RGBA:
+    case GL_RGBA8:
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        break;
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+        break;
+    case GL_DEPTH24_STENCIL8:
+        format = GL_DEPTH_STENCIL;
+        type = GL_UNSIGNED_INT_24_8;
+        break;
+    default:
+        format = GL_RGBA;
+        type = GL_FLOAT;
+        break;
+    }
+}
+
+size_t bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_NONE:
+        return 0;
+    case GL_R8:
+        return 1;
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16:
+        return 2;
+    case GL_RGB:
+    case GL_RGB8:
+        return 3;
+    case GL_R32F:
+    case GL_R32UI:
+    case GL_RG16F:
+    case GL_RGBA:
+    case GL_RGBA8:
+    case GL_R11F_G11F_B10F:
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+        return 4;
+    case GL_RGB16F:
+        return 6;
+    case GL_RG32F:
+    case GL_RGBA16F:
+        return 8;
+    case GL_RGB32F:
+        return 12;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+std::string formatName(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_R8:
+        return "R8";
+    case GL_R16F:
+        return "R16F";
+    case GL_R32F:
+        return "R32F";
+    case GL_R32UI:
+        return "R32UI";
+    case GL_RG16F:
+        return "RG16F";
+    case GL_RG32F:
+        return "RG32F";
+    case GL_RGB:
+    case GL_RGB8:
+        return "RGB8";
+    case GL_RGB16F:
+        return "RGB16F";
+    case GL_RGB32F:
+        return "RGB32F";
+    case GL_R11F_G11F_B10F:
+        return "R11G11B10F";
+    case GL_RGBA:
+    case GL_RGBA8:
+        return "RGBA8";
+    case GL_RGBA16F:
+        return "RGBA16F";
+    case GL_RGBA32F:
+        return "RGBA32F";
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT24:
+        return "D24";
+    case GL_DEPTH_COMPONENT16:
+        return "D16";
+    case GL_DEPTH_COMPONENT32F:
+        return "D32F";
+    case GL_DEPTH24_STENCIL8:
+        return "D24S8";
+    default:
+        return "0x" + std::to_string(internalFormat);
+    }
+}
+
+} // namespace
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc &other) const
+{
+    return width == other.width && height == other.height && colorFormat == other.colorFormat &&
+           depthFormat == other.depthFormat && samples == other.samples && depthTexture == other.depthTexture;
+}
+
+size_t RenderTargetDesc::byteSize() const
+{
+    size_t pixels = size_t(width) * size_t(height) * size_t(samples > 0 ? samples : 1);
+    return pixels * (bytesPerPixel(colorFormat) + bytesPerPixel(depthFormat));
+}
+
+std::string RenderTargetDesc::className() const
+{
+    std::string name;
+
+    if (colorFormat != GL_NONE)
+        name = formatName(colorFormat);
+
+    if (depthFormat != GL_NONE)
+    {
+        if (!name.empty())
+            name += "+";
+
+        name += formatName(depthFormat);
+
+        if (depthTexture)
+            name += " tex";
+    }
+
+    if (samples > 0)
+        name += " x" + std::to_string(samples);
+
+    return name;
+}
+
+RenderTarget::RenderTarget(const RenderTargetDesc &desc) : m_desc(desc)
+{
+    GLint previousFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+    if (desc.colorFormat != GL_NONE)
+    {
+        glGenTextures(1, &m_texture);
+
+        if (desc.samples > 0)
+        {
+            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_texture);
+            glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.colorFormat, desc.width,
+                                    desc.height, GL_TRUE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, m_texture, 0);
+        }
+        else
+        {
+            GLenum pixelFormat, pixelType;
+            pixelTransferFormat(desc.colorFormat, pixelFormat, pixelType);
+
+            // Integer textures cannot be filtered
+
+            GLint filter = (pixelFormat == GL_RED_INTEGER) ? GL_NEAREST : GL_LINEAR;
+
+            glBindTexture(GL_TEXTURE_2D, m_texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, desc.colorFormat, desc.width, desc.height, 0, pixelFormat, pixelType,
+                         NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+        }
+    }
+    else
+    {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+
+    if (desc.depthFormat != GL_NONE)
+    {
+        GLenum attachment = (desc.depthFormat == GL_DEPTH24_STENCIL8) ? GL_DEPTH_STENCIL_ATTACHMENT
+                                                                      : GL_DEPTH_ATTACHMENT;
+
+        if (desc.depthTexture && desc.samples == 0)
+        {
+            GLenum pixelFormat, pixelType;
+            pixelTransferFormat(desc.depthFormat, pixelFormat, pixelType);
+
+            glGenTextures(1, &m_depthTexture);
+            glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, desc.depthFormat, desc.width, desc.height, 0, pixelFormat, pixelType,
+                         nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, m_depthTexture, 0);
+        }
+        else
+        {
+            glGenRenderbuffers(1, &m_depthRenderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+
+            if (desc.samples > 0)
+                glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc.samples, desc.depthFormat, desc.width,
+                                                 desc.height);
+            else
+                glRenderbufferStorage(GL_RENDERBUFFER, desc.depthFormat, desc.width, desc.height);
+
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, m_depthRenderbuffer);
+        }
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        logErrorfc("RenderTarget", "Render target {}x{} {} is not complete!", desc.width, desc.height,
+                   desc.className());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+RenderTarget::~RenderTarget()
+{
+    glDeleteFramebuffers(1, &m_fbo);
+
+    if (m_texture != 0)
+        glDeleteTextures(1, &m_texture);
+
+    if (m_depthTexture != 0)
+        glDeleteTextures(1, &m_depthTexture);
+
+    if (m_depthRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+}
+
+std::shared_ptr<RenderTarget> RenderTarget::create(const RenderTargetDesc &desc)
+{
+    return std::make_shared<RenderTarget>(desc);
+}
+
+void RenderTarget::bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_desc.width, m_desc.height);
+}
+
+GLuint RenderTarget::fbo() const
+{
+    return m_fbo;
+}
+
+GLuint RenderTarget::texture() const
+{
+    return m_texture;
+}
+
+GLuint RenderTarget::depthTexture() const
+{
+    return m_depthTexture;
+}
+
+const RenderTargetDesc &RenderTarget::desc() const
+{
+    return m_desc;
+}
+
+int RenderTarget::width() const
+{
+    return m_desc.width;
+}
+
+int RenderTarget::height() const
+{
+    return m_desc.height;
+}
+
+GLenum RenderTarget::format() const
+{
+    return m_desc.colorFormat;
+}
@@ -0,0 +1,197 @@
+#include <ivf/render_target_pool.h>
+
+#include <ivf/logger.h>
+
+#include <algorithm>
+#include <map>
+
+using namespace ivf;
+
+RenderTargetPool *RenderTargetPool::m_instance = nullptr;
+
+RenderTargetPool::RenderTargetPool()
+{}
+
+RenderTargetPool::~RenderTargetPool()
+{}
+
+RenderTargetPool *RenderTargetPool::instance()
+{
+    if (!m_instance)
+        m_instance = new RenderTargetPool();
+
+    return m_instance;
+}
+
+RenderTargetPool *RenderTargetPool::create()
+{
+    return instance();
+}
+
+void RenderTargetPool::drop()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+RenderTargetPtr RenderTargetPool::acquire(const RenderTargetDesc &desc)
+{
+    RenderTargetPtr target;
+
+    // Prefer the most recently released target, it is the most likely to still be cached
+
+    for (auto it = m_free.rbegin(); it != m_free.rend(); ++it)
+    {
+        if (it->target->desc() == desc)
+        {
+            target = it->target;
+            m_free.erase(std::next(it).base());
+            break;
+        }
+    }
+
+    if (!target)
+    {
+        target = RenderTarget::create(desc);
+        m_allocations++;
+    }
+
+    m_acquired.push_back(target);
+
+    return target;
+}
+
+RenderTargetPtr RenderTargetPool::acquire(int width, int height, GLenum format)
+{
+    RenderTargetDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colorFormat = format;
+
+    return this->acquire(desc);
+}
+
+void RenderTargetPool::release(RenderTargetPtr target)
+{
+    if (!target)
+        return;
+
+    auto it = std::find(m_acquired.begin(), m_acquired.end(), target);
+
+    // Released twice or not from this pool, adding it again would hand it out twice
+
+    if (it == m_acquired.end())
+    {
+        logWarning("Released a render target not acquired from the pool", "RenderTargetPool");
+        return;
+    }
+
+    m_acquired.erase(it);
+    m_free.push_back({target, m_frame});
+}
+
+bool RenderTargetPool::reacquire(RenderTargetPtr &target, const RenderTargetDesc &desc)
+{
+    if (target && target->desc() == desc)
+        return false;
+
+    this->release(target);
+    target = this->acquire(desc);
+
+    return true;
+}
+
+void RenderTargetPool::endFrame()
+{
+    m_frame++;
+
+    m_free.erase(std::remove_if(m_free.begin(), m_free.end(),
+                                [this](const Entry &entry) { return m_frame - entry.frame > m_maxIdleFrames; }),
+                 m_free.end());
+}
+
+void RenderTargetPool::setMaxIdleFrames(unsigned int frames)
+{
+    m_maxIdleFrames = frames;
+}
+
+unsigned int RenderTargetPool::maxIdleFrames() const
+{
+    return m_maxIdleFrames;
+}
+
+void RenderTargetPool::clear()
+{
+    m_free.clear();
+}
+
+std::vector<RenderTargetClassStats> RenderTargetPool::report() const
+{
+    std::map<std::string, RenderTargetClassStats> classes;
+
+    for (auto &target : m_acquired)
+    {
+        auto &stats = classes[target->desc().className()];
+        stats.targets++;
+        stats.acquired++;
+        stats.bytes += target->desc().byteSize();
+    }
+
+    for (auto &entry : m_free)
+    {
+        auto &stats = classes[entry.target->desc().className()];
+        stats.targets++;
+        stats.bytes += entry.target->desc().byteSize();
+    }
+
+    std::vector<RenderTargetClassStats> result;
+
+    for (auto &[name, stats] : classes)
+    {
+        result.push_back(stats);
+        result.back().name = name;
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const RenderTargetClassStats &a, const RenderTargetClassStats &b) { return a.bytes > b.bytes; });
+
+    return result;
+}
+
+void RenderTargetPool::logReport() const
+{
+    logInfofc("RenderTargetPool", "{} targets, {:.1f} MB ({} allocations)", m_acquired.size() + m_free.size(),
+              double(this->totalBytes()) / (1024.0 * 1024.0), m_allocations);
+
+    for (auto &stats : this->report())
+        logInfofc("RenderTargetPool", "  {}: {} targets ({} in use), {:.1f} MB", stats.name, stats.targets,
+                  stats.acquired, double(stats.bytes) / (1024.0 * 1024.0));
+}
+
+size_t RenderTargetPool::totalBytes() const
+{
+    size_t bytes = 0;
+
+    for (auto &target : m_acquired)
+        bytes += target->desc().byteSize();
+
+    for (auto &entry : m_free)
+        bytes += entry.target->desc().byteSize();
+
+    return bytes;
+}
+
+size_t RenderTargetPool::freeCount() const
+{
+    return m_free.size();
+}
+
+size_t RenderTargetPool::acquiredCount() const
+{
+    return m_acquired.size();
+}
+
+size_t RenderTargetPool::allocationCount() const
+{
+    return m_allocations;
+}
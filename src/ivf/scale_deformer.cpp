@@ -13,37 +13,74 @@ std::shared_ptr<ScaleDeformer> ScaleDeformer::create(const glm::vec3& center,
 
 void ScaleDeformer::setCenter(const glm::vec3& center) {
     m_center = center;
+    markChanged();
 }
 
 void ScaleDeformer::setScale(const glm::vec3& scale) {
     m_scale = scale;
+    markChanged();
 }
 
 void ScaleDeformer::setFalloff(float falloff) {
     m_falloff = falloff;
+    markChanged();
 }
 
 void ScaleDeformer::apply() {
     if (!m_enabled || !m_originalVertices || !m_deformedVertices) return;
-    
-    for (GLuint i = 0; i < m_originalVertices->rows(); ++i) {
-        glm::vec3 originalPos = m_originalVertices->vertex(i);
-        glm::vec3 relativePos = originalPos - m_center;
-        
+
+    applyWithKernel();
+}
+
+bool ScaleDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount) {
+    return true;
+}
+
+void ScaleDeformer::applyKernel(glm::vec3* positions, [[maybe_unused]] GLuint first, GLuint count) const {
+    for (GLuint i = 0; i < count; ++i) {
+        glm::vec3 relativePos = positions[i] - m_center;
+
         float distance = glm::length(relativePos);
         float weight = std::exp(-distance * m_falloff) * m_weight;
-        
+
         if (weight > 0.0f) {
             glm::vec3 scaledPos = relativePos * glm::mix(glm::vec3(1.0f), m_scale, weight);
-            glm::vec3 deformedPos = scaledPos + m_center;
-            
-            m_deformedVertices->setVertex(i, deformedPos.x, deformedPos.y, deformedPos.z);
-        } else {
-            m_deformedVertices->setVertex(i, originalPos.x, originalPos.y, originalPos.z);
+            positions[i] = scaledPos + m_center;
         }
     }
 }
 
+bool ScaleDeformer::transformBounds(BoundingBox& bbox) const {
+    // A negative falloff gives weights above the deformer weight
+    if (m_falloff < 0.0f) return false;
+
+    // Each relative coordinate is multiplied by a factor between 1 and mix(1, scale, weight)
+    glm::vec3 factorA(1.0f);
+    glm::vec3 factorB = glm::mix(glm::vec3(1.0f), m_scale, m_weight);
+    glm::vec3 lo = bbox.min() - m_center;
+    glm::vec3 hi = bbox.max() - m_center;
+
+    glm::vec3 products[4] = {lo * factorA, lo * factorB, hi * factorA, hi * factorB};
+    glm::vec3 minPos = products[0];
+    glm::vec3 maxPos = products[0];
+    for (auto& product : products) {
+        minPos = glm::min(minPos, product);
+        maxPos = glm::max(maxPos, product);
+    }
+
+    bbox.setBounds(minPos + m_center, maxPos + m_center);
+    return true;
+}
+
+bool ScaleDeformer::gpuDeformer(GpuDeformer& gpu) const {
+    gpu.type = GpuDeformerType::SCALE;
+    gpu.params[0] = glm::vec4(m_center, m_falloff);
+    gpu.params[1] = glm::vec4(m_scale, m_weight);
+    gpu.params[2] = glm::vec4(0.0f);
+    gpu.params[3] = glm::vec4(0.0f);
+    return true;
+}
+
 std::unique_ptr<Deformer> ScaleDeformer::clone() const {
     auto cloned = std::make_unique<ScaleDeformer>(m_center, m_scale);
     cloned->setFalloff(m_falloff);
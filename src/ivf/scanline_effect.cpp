@@ -1,5 +1,6 @@
 #include <ivf/scanline_effect.h>
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -24,14 +25,15 @@ float ScanlineEffect::scrollSpeed() const { return m_scrollSpeed; }
 void ScanlineEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::scanline_frag_shader_source, "scanline", false);
+                                         EffectFusion::fragmentSource({ivf::scanline_pointwise_source}),
+                                         "scanline", false);
 }
 
 void ScanlineEffect::doUpdateParams()
 {
-    m_program->uniformFloat("lineSpacing", m_lineSpacing);
-    m_program->uniformFloat("lineIntensity", m_lineIntensity);
-    m_program->uniformFloat("scrollSpeed", m_scrollSpeed);
+    paramProgram()->uniformFloat(paramName("lineSpacing"), m_lineSpacing);
+    paramProgram()->uniformFloat(paramName("lineIntensity"), m_lineIntensity);
+    paramProgram()->uniformFloat(paramName("scrollSpeed"), m_scrollSpeed);
 }
 
 void ScanlineEffect::setupProperties()
@@ -40,3 +42,13 @@ void ScanlineEffect::setupProperties()
     addProperty("lineIntensity", &m_lineIntensity, 0.0f, 1.0f, "Scanline");
     addProperty("scrollSpeed", &m_scrollSpeed, 0.0f, 10.0f, "Scanline");
 }
+
+bool ScanlineEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ScanlineEffect::pointwiseSource() const
+{
+    return ivf::scanline_pointwise_source;
+}
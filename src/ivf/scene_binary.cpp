@@ -0,0 +1,872 @@
+#include "scene_binary.h"
+
+#include <glad/glad.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace ivf {
+
+namespace SceneBinary {
+
+namespace {
+
+constexpr char fileMagic[8] = {'I', 'V', 'F', 'S', 'C', 'E', 'N', 'E'};
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+constexpr size_t chunkAlignment = 16;
+constexpr std::uint32_t maxChunks = 256;
+
+constexpr char stringsChunk[4] = {'S', 'T', 'R', 'S'};
+constexpr char nodesChunk[4] = {'N', 'O', 'D', 'E'};
+constexpr char propertiesChunk[4] = {'P', 'R', 'O', 'P'};
+constexpr char meshesChunk[4] = {'M', 'E', 'S', 'H'};
+constexpr char dataChunk[4] = {'D', 'A', 'T', 'A'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t chunkCount;
+    std::uint32_t reserved;
+    std::uint64_t fileSize;
+};
+
+struct ChunkRecord {
+    char id[4];
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(FileHeader) == 32);
+static_assert(sizeof(ChunkRecord) == 24);
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool contains(std::uint64_t size, std::uint64_t offset, std::uint64_t bytes)
+{
+    return offset <= size && bytes <= size - offset;
+}
+
+bool validString(std::string_view strings, StringRef ref)
+{
+    return contains(strings.size(), ref.offset, ref.length);
+}
+
+// Array of count elements of T in the DATA chunk
+
+template <typename T> bool validArray(std::span<const unsigned char> data, std::uint64_t offset, std::uint64_t count)
+{
+    return offset % alignof(T) == 0 && count <= data.size() / sizeof(T) &&
+           contains(data.size(), offset, count * sizeof(T));
+}
+
+// JSON values with an exact binary encoding
+
+bool isFloat(const json &value)
+{
+    if (!value.is_number_float())
+        return false;
+
+    auto number = value.get<double>();
+    return std::fabs(number) <= FLT_MAX && static_cast<double>(static_cast<float>(number)) == number;
+}
+
+bool isFloatArray(const json &value, size_t size)
+{
+    if (!value.is_array() || value.size() != size)
+        return false;
+
+    for (const auto &element : value)
+        if (!isFloat(element))
+            return false;
+
+    return true;
+}
+
+bool isUInt32(const json &value)
+{
+    if (value.is_number_unsigned())
+        return value.get<std::uint64_t>() <= std::numeric_limits<std::uint32_t>::max();
+
+    if (value.is_number_integer())
+        return value.get<std::int64_t>() >= 0 &&
+               value.get<std::int64_t>() <= std::numeric_limits<std::uint32_t>::max();
+
+    return false;
+}
+
+bool isInt64(const json &value)
+{
+    if (value.is_number_unsigned())
+        return value.get<std::uint64_t>() <= std::uint64_t(std::numeric_limits<std::int64_t>::max());
+
+    return value.is_number_integer();
+}
+
+void readFloats(const json &value, float *values)
+{
+    for (size_t i = 0; i < value.size(); i++)
+        values[i] = value[i].get<float>();
+}
+
+json floatsToJson(const float *values, size_t count)
+{
+    json array = json::array();
+
+    for (size_t i = 0; i < count; i++)
+        array.push_back(values[i]);
+
+    return array;
+}
+
+bool isTransform(const json &value)
+{
+    if (!value.is_object() || value.size() != 5)
+        return false;
+
+    return value.contains("pos") && isFloatArray(value["pos"], 3) && value.contains("eulerAngles") &&
+           isFloatArray(value["eulerAngles"], 3) && value.contains("scale") && isFloatArray(value["scale"], 3) &&
+           value.contains("rotAxis") && isFloatArray(value["rotAxis"], 3) && value.contains("rotAngle") &&
+           isFloat(value["rotAngle"]);
+}
+
+bool isMaterial(const json &value)
+{
+    if (!value.is_object() || value.size() != 6)
+        return false;
+
+    return value.contains("diffuse") && isFloatArray(value["diffuse"], 4) && value.contains("specular") &&
+           isFloatArray(value["specular"], 4) && value.contains("ambient") && isFloatArray(value["ambient"], 4) &&
+           value.contains("shininess") && isFloat(value["shininess"]) && value.contains("alpha") &&
+           isFloat(value["alpha"]) && value.contains("useLighting") && value["useLighting"].is_boolean();
+}
+
+bool isProperty(const json &value)
+{
+    if (value.is_boolean() || isInt64(value) || value.is_number_float() || value.is_string())
+        return true;
+
+    if (!value.is_array() || value.size() > std::numeric_limits<std::uint32_t>::max())
+        return false;
+
+    for (const auto &element : value)
+        if (!element.is_number_float())
+            return false;
+
+    return true;
+}
+
+bool isProperties(const json &value)
+{
+    if (!value.is_object())
+        return false;
+
+    for (const auto &[name, property] : value.items())
+        if (!isProperty(property))
+            return false;
+
+    return true;
+}
+
+bool isMesh(const json &value)
+{
+    if (!value.is_object() || !value.contains("primType") || !isUInt32(value["primType"]) ||
+        !value.contains("vertices") || !value["vertices"].is_array())
+        return false;
+
+    auto &vertices = value["vertices"];
+
+    if (vertices.size() % 3 != 0 || vertices.size() / 3 > std::numeric_limits<std::uint32_t>::max() ||
+        !isFloatArray(vertices, vertices.size()))
+        return false;
+
+    size_t vertexCount = vertices.size() / 3;
+
+    for (const auto &[key, array] : value.items())
+    {
+        if (key == "primType" || key == "vertices")
+            continue;
+        else if (key == "normals" && isFloatArray(array, vertexCount * 3))
+            continue;
+        else if (key == "texCoords" && isFloatArray(array, vertexCount * 2))
+            continue;
+        else if (key == "colors" && isFloatArray(array, vertexCount * 4))
+            continue;
+        else if (key == "indices" && array.is_array() && array.size() <= std::numeric_limits<std::uint32_t>::max() &&
+                 array.size() % indexColumns(value["primType"].get<std::uint32_t>()) == 0)
+        {
+            for (const auto &index : array)
+                if (!isUInt32(index))
+                    return false;
+
+            continue;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool isMeshes(const json &value)
+{
+    if (!value.is_array())
+        return false;
+
+    for (const auto &mesh : value)
+        if (!isMesh(mesh))
+            return false;
+
+    return true;
+}
+
+bool isChildren(const json &value)
+{
+    if (!value.is_array())
+        return false;
+
+    for (const auto &child : value)
+        if (!child.is_object())
+            return false;
+
+    return true;
+}
+
+std::uint64_t addFloats(Writer &writer, const json &array)
+{
+    std::vector<float> values(array.size());
+    readFloats(array, values.data());
+    return writer.addData(values.data(), values.size() * sizeof(float));
+}
+
+void addProperties(Writer &writer, const json &value, NodeRecord &node)
+{
+    node.firstProperty = static_cast<std::uint32_t>(writer.properties.size());
+
+    for (const auto &[name, property] : value.items())
+    {
+        PropertyRecord record{};
+        record.name = writer.addString(name);
+
+        if (property.is_boolean())
+        {
+            record.kind = PropertyKind::Bool;
+            record.value = property.get<bool>() ? 1 : 0;
+        }
+        else if (property.is_number_integer())
+        {
+            record.kind = PropertyKind::Integer;
+            record.value = static_cast<std::uint64_t>(property.get<std::int64_t>());
+        }
+        else if (property.is_number_float())
+        {
+            auto number = property.get<double>();
+            record.kind = PropertyKind::Float;
+            std::memcpy(&record.value, &number, sizeof(number));
+        }
+        else if (property.is_string())
+        {
+            record.kind = PropertyKind::String;
+            record.value = packString(writer.addString(property.get<std::string>()));
+        }
+        else
+        {
+            std::vector<double> values;
+
+            for (const auto &element : property)
+                values.push_back(element.get<double>());
+
+            record.kind = PropertyKind::FloatArray;
+            record.count = static_cast<std::uint32_t>(values.size());
+            record.value = writer.addData(values.data(), values.size() * sizeof(double));
+        }
+
+        writer.properties.push_back(record);
+    }
+
+    node.propertyCount = static_cast<std::uint32_t>(writer.properties.size()) - node.firstProperty;
+}
+
+void addMeshes(Writer &writer, const json &value, NodeRecord &node)
+{
+    node.firstMesh = static_cast<std::uint32_t>(writer.meshes.size());
+
+    for (const auto &mesh : value)
+    {
+        MeshRecord record{};
+        record.primType = mesh["primType"].get<std::uint32_t>();
+        record.vertexCount = static_cast<std::uint32_t>(mesh["vertices"].size() / 3);
+        record.vertices = addFloats(writer, mesh["vertices"]);
+
+        if (mesh.contains("normals"))
+        {
+            record.flags |= HasNormals;
+            record.normals = addFloats(writer, mesh["normals"]);
+        }
+
+        if (mesh.contains("texCoords"))
+        {
+            record.flags |= HasTexCoords;
+            record.texCoords = addFloats(writer, mesh["texCoords"]);
+        }
+
+        if (mesh.contains("colors"))
+        {
+            record.flags |= HasColors;
+            record.colors = addFloats(writer, mesh["colors"]);
+        }
+
+        if (mesh.contains("indices"))
+        {
+            auto indices = mesh["indices"].get<std::vector<std::uint32_t>>();
+            record.flags |= HasIndices;
+            record.indexCount = static_cast<std::uint32_t>(indices.size());
+            record.indices = writer.addData(indices.data(), indices.size() * sizeof(std::uint32_t));
+        }
+
+        writer.meshes.push_back(record);
+    }
+
+    node.meshCount = static_cast<std::uint32_t>(writer.meshes.size()) - node.firstMesh;
+}
+
+// Nodes are added parents first, the keys without binary encoding are kept in extra
+
+void addNode(Writer &writer, const json &value, std::int32_t parent)
+{
+    NodeRecord node{};
+    node.parent = parent;
+
+    json extra = json::object();
+    const json *children = nullptr;
+
+    for (const auto &[key, field] : value.items())
+    {
+        if (key == "type" && field.is_string())
+        {
+            node.flags |= HasType;
+            node.type = writer.addString(field.get<std::string>());
+        }
+        else if (key == "name" && field.is_string())
+        {
+            node.flags |= HasName;
+            node.name = writer.addString(field.get<std::string>());
+        }
+        else if (key == "visible" && field.is_boolean())
+        {
+            node.flags |= HasVisible;
+            if (field.get<bool>())
+                node.flags |= Visible;
+        }
+        else if (key == "transform" && isTransform(field))
+        {
+            node.flags |= HasTransform;
+            readFloats(field["pos"], node.pos);
+            readFloats(field["eulerAngles"], node.eulerAngles);
+            readFloats(field["scale"], node.scale);
+            readFloats(field["rotAxis"], node.rotAxis);
+            node.rotAngle = field["rotAngle"].get<float>();
+        }
+        else if (key == "material" && isMaterial(field))
+        {
+            node.flags |= HasMaterial;
+            if (field["useLighting"].get<bool>())
+                node.flags |= UseLighting;
+            readFloats(field["diffuse"], node.diffuse);
+            readFloats(field["specular"], node.specular);
+            readFloats(field["ambient"], node.ambient);
+            node.shininess = field["shininess"].get<float>();
+            node.alpha = field["alpha"].get<float>();
+        }
+        else if (key == "properties" && isProperties(field))
+        {
+            node.flags |= HasProperties;
+            addProperties(writer, field, node);
+        }
+        else if (key == "meshes" && isMeshes(field))
+        {
+            node.flags |= HasMeshes;
+            addMeshes(writer, field, node);
+        }
+        else if (key == "children" && isChildren(field))
+        {
+            node.flags |= HasChildren;
+            children = &field;
+        }
+        else
+            extra[key] = field;
+    }
+
+    if (!extra.empty())
+        node.extra = writer.addString(extra.dump());
+
+    auto index = static_cast<std::int32_t>(writer.nodes.size());
+    writer.nodes.push_back(node);
+
+    if (children != nullptr)
+        for (const auto &child : *children)
+            addNode(writer, child, index);
+}
+
+json nodeToJson(const Reader &reader, std::uint32_t index, const std::vector<std::vector<std::uint32_t>> &children,
+                std::string &error)
+{
+    const auto &node = reader.nodes[index];
+    json value = json::object();
+
+    if (node.extra.length > 0)
+    {
+        value = json::parse(reader.string(node.extra), nullptr, false);
+
+        if (value.is_discarded() || !value.is_object())
+        {
+            error = "invalid extra fields of node " + std::to_string(index);
+            return json::object();
+        }
+    }
+
+    if (node.flags & HasType)
+        value["type"] = std::string(reader.string(node.type));
+
+    if (node.flags & HasName)
+        value["name"] = std::string(reader.string(node.name));
+
+    if (node.flags & HasVisible)
+        value["visible"] = (node.flags & Visible) != 0;
+
+    if (node.flags & HasTransform)
+    {
+        auto &transform = value["transform"];
+        transform["pos"] = floatsToJson(node.pos, 3);
+        transform["eulerAngles"] = floatsToJson(node.eulerAngles, 3);
+        transform["scale"] = floatsToJson(node.scale, 3);
+        transform["rotAxis"] = floatsToJson(node.rotAxis, 3);
+        transform["rotAngle"] = node.rotAngle;
+    }
+
+    if (node.flags & HasMaterial)
+    {
+        auto &material = value["material"];
+        material["diffuse"] = floatsToJson(node.diffuse, 4);
+        material["specular"] = floatsToJson(node.specular, 4);
+        material["ambient"] = floatsToJson(node.ambient, 4);
+        material["shininess"] = node.shininess;
+        material["alpha"] = node.alpha;
+        material["useLighting"] = (node.flags & UseLighting) != 0;
+    }
+
+    if (node.flags & HasProperties)
+    {
+        json properties = json::object();
+
+        for (const auto &property : reader.nodeProperties(node))
+        {
+            auto &field = properties[std::string(reader.string(property.name))];
+
+            switch (property.kind)
+            {
+            case PropertyKind::Bool:
+                field = property.value != 0;
+                break;
+            case PropertyKind::Integer:
+                field = static_cast<std::int64_t>(property.value);
+                break;
+            case PropertyKind::Float: {
+                double number;
+                std::memcpy(&number, &property.value, sizeof(number));
+                field = number;
+                break;
+            }
+            case PropertyKind::String:
+                field = std::string(reader.string(unpackString(property.value)));
+                break;
+            case PropertyKind::FloatArray: {
+                auto values = reader.data<double>(property.value);
+                field = json::array();
+
+                for (std::uint32_t i = 0; i < property.count; i++)
+                    field.push_back(values[i]);
+
+                break;
+            }
+            }
+        }
+
+        value["properties"] = std::move(properties);
+    }
+
+    if (node.flags & HasMeshes)
+    {
+        json meshes = json::array();
+
+        for (const auto &mesh : reader.nodeMeshes(node))
+        {
+            json field;
+            field["primType"] = mesh.primType;
+            field["vertices"] = floatsToJson(reader.data<float>(mesh.vertices), size_t(mesh.vertexCount) * 3);
+
+            if (mesh.flags & HasNormals)
+                field["normals"] = floatsToJson(reader.data<float>(mesh.normals), size_t(mesh.vertexCount) * 3);
+
+            if (mesh.flags & HasTexCoords)
+                field["texCoords"] = floatsToJson(reader.data<float>(mesh.texCoords), size_t(mesh.vertexCount) * 2);
+
+            if (mesh.flags & HasColors)
+                field["colors"] = floatsToJson(reader.data<float>(mesh.colors), size_t(mesh.vertexCount) * 4);
+
+            if (mesh.flags & HasIndices)
+            {
+                auto indices = reader.data<std::uint32_t>(mesh.indices);
+                field["indices"] = std::vector<std::uint32_t>(indices, indices + mesh.indexCount);
+            }
+
+            meshes.push_back(std::move(field));
+        }
+
+        value["meshes"] = std::move(meshes);
+    }
+
+    if (node.flags & HasChildren)
+    {
+        json array = json::array();
+
+        for (auto child : children[index])
+            array.push_back(nodeToJson(reader, child, children, error));
+
+        value["children"] = std::move(array);
+    }
+
+    return value;
+}
+
+} // namespace
+
+StringRef Writer::addString(std::string_view value)
+{
+    auto it = m_stringIndex.find(std::string(value));
+
+    if (it != m_stringIndex.end())
+        return it->second;
+
+    StringRef ref{static_cast<std::uint32_t>(m_strings.size()), static_cast<std::uint32_t>(value.size())};
+    m_strings.append(value);
+    m_stringIndex.emplace(std::string(value), ref);
+    return ref;
+}
+
+std::uint64_t Writer::addData(const void *data, size_t bytes)
+{
+    auto offset = alignUp(m_data.size(), chunkAlignment);
+    m_data.resize(offset + bytes);
+
+    if (bytes > 0)
+        std::memcpy(m_data.data() + offset, data, bytes);
+
+    return offset;
+}
+
+bool Writer::save(const std::string &filename, std::string &error) const
+{
+    if (m_strings.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        error = "string table too large";
+        return false;
+    }
+
+    struct Chunk {
+        const char *id;
+        const void *data;
+        size_t size;
+    };
+
+    const Chunk chunks[] = {{stringsChunk, m_strings.data(), m_strings.size()},
+                            {nodesChunk, nodes.data(), nodes.size() * sizeof(NodeRecord)},
+                            {propertiesChunk, properties.data(), properties.size() * sizeof(PropertyRecord)},
+                            {meshesChunk, meshes.data(), meshes.size() * sizeof(MeshRecord)},
+                            {dataChunk, m_data.data(), m_data.size()}};
+
+    constexpr std::uint32_t chunkCount = std::size(chunks);
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    header.chunkCount = chunkCount;
+
+    ChunkRecord directory[chunkCount]{};
+    size_t offset = alignUp(sizeof(FileHeader) + sizeof(directory), chunkAlignment);
+
+    for (std::uint32_t i = 0; i < chunkCount; i++)
+    {
+        std::memcpy(directory[i].id, chunks[i].id, 4);
+        directory[i].offset = offset;
+        directory[i].size = chunks[i].size;
+        offset = alignUp(offset + chunks[i].size, chunkAlignment);
+    }
+
+    header.fileSize = offset;
+
+    std::vector<unsigned char> buffer(offset);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), directory, sizeof(directory));
+
+    for (std::uint32_t i = 0; i < chunkCount; i++)
+        if (chunks[i].size > 0)
+            std::memcpy(buffer.data() + directory[i].offset, chunks[i].data, chunks[i].size);
+
+    // Written to a temporary file and renamed, so that an interrupted write keeps the old file
+
+    auto temporary = filename + ".tmp";
+    std::error_code fsError;
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+        if (!file)
+            fsError = std::make_error_code(std::errc::io_error);
+    }
+
+    if (!fsError)
+        fs::rename(temporary, filename, fsError);
+
+    if (fsError)
+    {
+        std::error_code removeError;
+        fs::remove(temporary, removeError);
+        error = fsError.message();
+        return false;
+    }
+
+    return true;
+}
+
+bool Reader::open(const std::string &filename, std::string &error)
+{
+    auto mapping = std::make_shared<MappedFile>();
+
+    if (!mapping->open(filename))
+    {
+        error = "cannot map file";
+        return false;
+    }
+
+    auto fileData = mapping->data();
+    auto fileSize = mapping->size();
+
+    FileHeader header;
+
+    if (fileSize < sizeof(FileHeader))
+    {
+        error = "not a scene file";
+        return false;
+    }
+
+    std::memcpy(&header, fileData, sizeof(header));
+
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0)
+    {
+        error = "not a scene file";
+        return false;
+    }
+
+    if (header.version != formatVersion || header.byteOrder != byteOrderMark)
+    {
+        error = "unsupported version or byte order";
+        return false;
+    }
+
+    if (header.fileSize != fileSize || header.chunkCount > maxChunks ||
+        !contains(fileSize, sizeof(FileHeader), header.chunkCount * sizeof(ChunkRecord)))
+    {
+        error = "truncated or corrupt file";
+        return false;
+    }
+
+    std::span<const unsigned char> chunks[5];
+    bool found[5] = {};
+    const char *ids[5] = {stringsChunk, nodesChunk, propertiesChunk, meshesChunk, dataChunk};
+
+    for (std::uint32_t i = 0; i < header.chunkCount; i++)
+    {
+        ChunkRecord chunk;
+        std::memcpy(&chunk, fileData + sizeof(FileHeader) + i * sizeof(ChunkRecord), sizeof(chunk));
+
+        if (chunk.offset % chunkAlignment != 0 || !contains(fileSize, chunk.offset, chunk.size))
+        {
+            error = "truncated or corrupt file";
+            return false;
+        }
+
+        // Chunks of later versions are skipped
+
+        for (int j = 0; j < 5; j++)
+        {
+            if (std::memcmp(chunk.id, ids[j], 4) == 0)
+            {
+                chunks[j] = std::span<const unsigned char>(fileData + chunk.offset, chunk.size);
+                found[j] = true;
+            }
+        }
+    }
+
+    if (!(found[0] && found[1] && found[2] && found[3] && found[4]) || chunks[1].size() % sizeof(NodeRecord) != 0 ||
+        chunks[2].size() % sizeof(PropertyRecord) != 0 || chunks[3].size() % sizeof(MeshRecord) != 0 ||
+        chunks[0].size() > std::numeric_limits<std::uint32_t>::max() ||
+        chunks[1].size() / sizeof(NodeRecord) > std::uint64_t(std::numeric_limits<std::int32_t>::max()))
+    {
+        error = "missing or corrupt chunks";
+        return false;
+    }
+
+    m_strings = std::string_view(reinterpret_cast<const char *>(chunks[0].data()), chunks[0].size());
+    m_data = chunks[4];
+    nodes = {reinterpret_cast<const NodeRecord *>(chunks[1].data()), chunks[1].size() / sizeof(NodeRecord)};
+    properties = {reinterpret_cast<const PropertyRecord *>(chunks[2].data()),
+                  chunks[2].size() / sizeof(PropertyRecord)};
+    meshes = {reinterpret_cast<const MeshRecord *>(chunks[3].data()), chunks[3].size() / sizeof(MeshRecord)};
+
+    // Validate every reference, so that loading needs no further checks
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        const auto &node = nodes[i];
+        bool validParent = (i == 0) ? node.parent == -1
+                                    : node.parent >= 0 && size_t(node.parent) < i &&
+                                          (nodes[node.parent].flags & HasChildren) != 0;
+
+        if (!validParent || !validString(m_strings, node.type) || !validString(m_strings, node.name) ||
+            !validString(m_strings, node.extra) ||
+            !contains(properties.size(), node.firstProperty, node.propertyCount) ||
+            !contains(meshes.size(), node.firstMesh, node.meshCount))
+        {
+            error = "corrupt node " + std::to_string(i);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < properties.size(); i++)
+    {
+        const auto &property = properties[i];
+        bool valid = validString(m_strings, property.name);
+
+        if (property.kind == PropertyKind::String)
+            valid = valid && validString(m_strings, unpackString(property.value));
+        else if (property.kind == PropertyKind::FloatArray)
+            valid = valid && validArray<double>(m_data, property.value, property.count);
+        else if (property.kind > PropertyKind::FloatArray)
+            valid = false;
+
+        if (!valid)
+        {
+            error = "corrupt property " + std::to_string(i);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        const auto &mesh = meshes[i];
+        std::uint64_t vertexCount = mesh.vertexCount;
+
+        bool valid = validArray<float>(m_data, mesh.vertices, vertexCount * 3) &&
+                     (!(mesh.flags & HasNormals) || validArray<float>(m_data, mesh.normals, vertexCount * 3)) &&
+                     (!(mesh.flags & HasTexCoords) || validArray<float>(m_data, mesh.texCoords, vertexCount * 2)) &&
+                     (!(mesh.flags & HasColors) || validArray<float>(m_data, mesh.colors, vertexCount * 4));
+
+        if (mesh.flags & HasIndices)
+        {
+            valid = valid && mesh.indexCount % indexColumns(mesh.primType) == 0 &&
+                    validArray<std::uint32_t>(m_data, mesh.indices, mesh.indexCount);
+
+            // Out of range indices would make the GPU read past the vertex buffers
+
+            if (valid)
+            {
+                auto indices = data<std::uint32_t>(mesh.indices);
+                for (std::uint64_t j = 0; j < mesh.indexCount && valid; j++)
+                    valid = indices[j] < vertexCount;
+            }
+        }
+
+        if (!valid)
+        {
+            error = "corrupt mesh " + std::to_string(i);
+            return false;
+        }
+    }
+
+    m_mapping = std::move(mapping);
+    return true;
+}
+
+std::vector<std::vector<std::uint32_t>> Reader::children() const
+{
+    std::vector<std::vector<std::uint32_t>> children(nodes.size());
+
+    for (std::uint32_t i = 1; i < nodes.size(); i++)
+        children[nodes[i].parent].push_back(i);
+
+    return children;
+}
+
+bool isSceneFile(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(fileMagic)];
+
+    if (!file.read(magic, sizeof(magic)))
+        return false;
+
+    return std::memcmp(magic, fileMagic, sizeof(fileMagic)) == 0;
+}
+
+std::uint32_t indexColumns(std::uint32_t primType)
+{
+    if (primType == GL_TRIANGLES)
+        return 3;
+    else if (primType == GL_LINES)
+        return 2;
+    else
+        return 1;
+}
+
+bool fromJson(const json &document, Writer &writer, std::string &error)
+{
+    if (!document.is_object())
+    {
+        error = "scene document is not a JSON object";
+        return false;
+    }
+
+    addNode(writer, document, -1);
+    return true;
+}
+
+bool toJson(const Reader &reader, json &document, std::string &error)
+{
+    if (reader.nodes.empty())
+    {
+        error = "scene file has no nodes";
+        return false;
+    }
+
+    error.clear();
+    document = nodeToJson(reader, 0, reader.children(), error);
+    return error.empty();
+}
+
+} // namespace SceneBinary
+
+} // namespace ivf
@@ -0,0 +1,200 @@
+#pragma once
+
+// Private header: binary scene files (.ivfscene) written and read by SceneSerializer.
+//
+// Layout, all values in native byte order:
+//
+//   FileHeader
+//   ChunkRecord[chunkCount]
+//   chunks, each aligned to 16 bytes
+//
+// Chunks:
+//   STRS  string table, referenced by StringRef
+//   NODE  NodeRecord per node, parents before their children, children in order
+//   PROP  PropertyRecord per node property, grouped by node
+//   MESH  MeshRecord per embedded mesh, grouped by node
+//   DATA  vertex, index and property arrays, each aligned to 16 bytes
+//
+// Records are fixed size and used in place from the memory-mapped file, and the arrays are handed
+// to the mesh buffers without conversion. Unknown chunks are skipped. Node keys of a JSON scene
+// that have no binary encoding are kept as JSON text in NodeRecord::extra, so that JSON scenes
+// convert to binary and back without loss.
+
+#include "mapped_file.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ivf {
+
+namespace SceneBinary {
+
+constexpr std::uint32_t formatVersion = 1;
+
+struct StringRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+enum NodeFlags : std::uint32_t {
+    HasType = 1 << 0,
+    HasName = 1 << 1,
+    HasVisible = 1 << 2,
+    Visible = 1 << 3,
+    HasTransform = 1 << 4,
+    HasMaterial = 1 << 5,
+    UseLighting = 1 << 6,
+    HasProperties = 1 << 7,
+    HasMeshes = 1 << 8,
+    HasChildren = 1 << 9
+};
+
+enum MeshFlags : std::uint32_t {
+    HasNormals = 1 << 0,
+    HasTexCoords = 1 << 1,
+    HasColors = 1 << 2,
+    HasIndices = 1 << 3
+};
+
+enum class PropertyKind : std::uint32_t {
+    Bool,      // value 0 or 1
+    Integer,   // value is an int64
+    Float,     // value is a double
+    String,    // value is a StringRef
+    FloatArray // value is the DATA offset of count doubles
+};
+
+struct NodeRecord {
+    StringRef type;
+    StringRef name;
+    StringRef extra; // JSON object of keys without binary encoding, empty if none
+    std::int32_t parent;
+    std::uint32_t flags;
+    std::uint32_t firstProperty;
+    std::uint32_t propertyCount;
+    std::uint32_t firstMesh;
+    std::uint32_t meshCount;
+    float pos[3];
+    float eulerAngles[3];
+    float scale[3];
+    float rotAxis[3];
+    float rotAngle;
+    float diffuse[4];
+    float specular[4];
+    float ambient[4];
+    float shininess;
+    float alpha;
+    std::uint32_t reserved;
+};
+
+struct PropertyRecord {
+    StringRef name;
+    PropertyKind kind;
+    std::uint32_t count;
+    std::uint64_t value;
+};
+
+struct MeshRecord {
+    std::uint32_t primType;
+    std::uint32_t flags;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount; // all index components, rows times columns
+    std::uint64_t vertices;   // DATA offsets
+    std::uint64_t normals;
+    std::uint64_t texCoords;
+    std::uint64_t colors;
+    std::uint64_t indices;
+    std::uint64_t reserved;
+};
+
+// String values of PropertyRecord
+
+inline StringRef unpackString(std::uint64_t value)
+{
+    return {static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32)};
+}
+
+inline std::uint64_t packString(StringRef ref)
+{
+    return std::uint64_t(ref.offset) | (std::uint64_t(ref.length) << 32);
+}
+
+static_assert(sizeof(NodeRecord) == 160);
+static_assert(sizeof(PropertyRecord) == 24);
+static_assert(sizeof(MeshRecord) == 64);
+
+// Collects records and arrays and writes them as a scene file
+
+class Writer {
+private:
+    std::string m_strings;
+    std::unordered_map<std::string, StringRef> m_stringIndex;
+    std::vector<unsigned char> m_data;
+
+public:
+    std::vector<NodeRecord> nodes;
+    std::vector<PropertyRecord> properties;
+    std::vector<MeshRecord> meshes;
+
+    StringRef addString(std::string_view value);
+    std::uint64_t addData(const void *data, size_t bytes);
+
+    bool save(const std::string &filename, std::string &error) const;
+};
+
+// Memory-mapped scene file, validated when opened
+
+class Reader {
+private:
+    std::shared_ptr<MappedFile> m_mapping;
+    std::string_view m_strings;
+    std::span<const unsigned char> m_data;
+
+public:
+    std::span<const NodeRecord> nodes;
+    std::span<const PropertyRecord> properties;
+    std::span<const MeshRecord> meshes;
+
+    bool open(const std::string &filename, std::string &error);
+
+    std::string_view string(StringRef ref) const { return m_strings.substr(ref.offset, ref.length); }
+
+    template <typename T> const T *data(std::uint64_t offset) const
+    {
+        return reinterpret_cast<const T *>(m_data.data() + offset);
+    }
+
+    std::span<const PropertyRecord> nodeProperties(const NodeRecord &node) const
+    {
+        return properties.subspan(node.firstProperty, node.propertyCount);
+    }
+
+    std::span<const MeshRecord> nodeMeshes(const NodeRecord &node) const
+    {
+        return meshes.subspan(node.firstMesh, node.meshCount);
+    }
+
+    // Child node indices of every node, in order
+    std::vector<std::vector<std::uint32_t>> children() const;
+};
+
+// Check for the file signature
+bool isSceneFile(const std::string &filename);
+
+// Number of index components per primitive of a Mesh with indices
+std::uint32_t indexColumns(std::uint32_t primType);
+
+// Lossless conversion of JSON scene documents, as written by SceneSerializer::save()
+bool fromJson(const nlohmann::json &document, Writer &writer, std::string &error);
+bool toJson(const Reader &reader, nlohmann::json &document, std::string &error);
+
+} // namespace SceneBinary
+
+} // namespace ivf
@@ -0,0 +1,54 @@
+#pragma once
+
+// Private header: state of a scene being loaded by SceneSerializer and SceneLoader.
+
+#include <ivf/composite_node.h>
+#include <ivf/mesh.h>
+
+#include "scene_binary.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ivf {
+
+struct SceneLoadJob {
+    // Node of the flattened scene, parents before their children
+    struct Item {
+        const nlohmann::json *json{nullptr}; // node object of a JSON scene
+        std::uint32_t record{0};             // NodeRecord of a binary scene
+        std::int32_t parent{-1};             // item index of the parent
+        NodePtr node;                        // created node, null if skipped
+        bool built{false};                   // created by buildNodes()
+    };
+
+    std::string path;
+    bool binary{false};
+
+    nlohmann::json document;    // JSON scenes
+    SceneBinary::Reader reader; // binary scenes
+    std::vector<Item> items;
+
+    std::vector<std::shared_ptr<Mesh>> meshes; // meshes of the linked scene waiting for createBuffers()
+
+    std::string error;            // message if the file cannot be read
+    std::exception_ptr exception; // first exception thrown while creating nodes
+    std::mutex mutex;             // protects exception
+
+    std::atomic<size_t> nodeCount{0};  // items, set when the file has been read
+    std::atomic<size_t> nodesBuilt{0}; // items created
+
+    double readSeconds{0.0};
+    double buildSeconds{0.0};
+    double linkSeconds{0.0};
+    double bufferSeconds{0.0};
+};
+
+} // namespace ivf
@@ -0,0 +1,209 @@
+#include <ivf/scene_loader.h>
+
+#include <ivf/logger.h>
+#include <ivf/scene_serializer.h>
+
+#include "scene_binary.h"
+#include "scene_load_job.h"
+
+#include <chrono>
+#include <limits>
+
+using namespace ivf;
+
+namespace {
+
+size_t meshBytes(Mesh &mesh)
+{
+    size_t bytes = mesh.vertices()->memSize() + mesh.normals()->memSize() + mesh.texCoords()->memSize() +
+                   mesh.colors()->memSize();
+
+    if (mesh.indices())
+        bytes += mesh.indices()->memSize();
+
+    return bytes;
+}
+
+} // namespace
+
+float SceneLoadProgress::fraction() const
+{
+    if (done)
+        return 1.0f;
+
+    float nodePart = nodes > 0 ? float(nodesBuilt) / float(nodes) : 0.0f;
+    float meshPart = meshes > 0 ? float(meshesUploaded) / float(meshes) : 0.0f;
+
+    return 0.5f * nodePart + 0.5f * meshPart;
+}
+
+SceneLoader::SceneLoader(std::string_view path) : m_job(std::make_unique<SceneLoadJob>())
+{
+    m_job->path = path;
+    m_job->binary = SceneBinary::isSceneFile(m_job->path);
+
+    // Errors are reported by update(), the loading threads do not log. They are threads of their
+    // own rather than the ThreadPool, where a frame waiting in parallelFor() could pick up the job.
+
+    m_reading = std::async(std::launch::async, [job = m_job.get()] {
+        if (SceneSerializer::readScene(*job))
+            SceneSerializer::buildNodes(*job);
+    });
+}
+
+SceneLoader::~SceneLoader()
+{
+    if (m_reading.valid())
+        m_reading.wait();
+}
+
+std::shared_ptr<SceneLoader> SceneLoader::create(std::string_view path)
+{
+    return std::make_shared<SceneLoader>(path);
+}
+
+void SceneLoader::link()
+{
+    m_reading.get();
+
+    if (!m_job->error.empty())
+    {
+        this->fail(m_job->error);
+        return;
+    }
+
+    try
+    {
+        m_root = SceneSerializer::linkNodes(*m_job);
+    }
+    catch (const std::exception &e)
+    {
+        this->fail(std::string("SceneSerializer: invalid scene file: ") + e.what());
+        return;
+    }
+
+    m_linked = true;
+    m_progress.nodesBuilt = m_job->nodesBuilt;
+    m_progress.meshes = m_job->meshes.size();
+}
+
+void SceneLoader::fail(const std::string &message)
+{
+    logWarning(message, "SceneLoader");
+
+    m_job.reset();
+    m_progress.done = true;
+    m_progress.failed = true;
+}
+
+void SceneLoader::report()
+{
+    if (m_callback && m_progress != m_reported)
+    {
+        m_reported = m_progress;
+        m_callback(m_progress);
+    }
+}
+
+bool SceneLoader::update()
+{
+    if (m_progress.done)
+        return true;
+
+    if (!m_linked)
+    {
+        m_progress.nodes = m_job->nodeCount;
+        m_progress.nodesBuilt = m_job->nodesBuilt;
+
+        if (m_reading.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            this->report();
+            return false;
+        }
+
+        this->link();
+
+        if (m_progress.failed)
+        {
+            this->report();
+            return true;
+        }
+    }
+
+    // Buffers of at least one mesh per frame
+
+    auto start = std::chrono::steady_clock::now();
+    auto &meshes = m_job->meshes;
+    size_t bytes = 0;
+
+    while (m_nextMesh < meshes.size() && (bytes == 0 || bytes < m_uploadBudget))
+    {
+        auto &mesh = meshes[m_nextMesh++];
+        mesh->createBuffers();
+        bytes += meshBytes(*mesh);
+    }
+
+    m_job->bufferSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_progress.meshesUploaded = m_nextMesh;
+
+    if (m_nextMesh == meshes.size())
+    {
+        logInfofc("SceneLoader", "Loaded {} ({} nodes, {} meshes): read {:.3f} s, nodes {:.3f} s, link {:.3f} s, "
+                  "buffers {:.3f} s", m_job->path, m_progress.nodesBuilt, m_progress.meshes, m_job->readSeconds,
+                  m_job->buildSeconds, m_job->linkSeconds, m_job->bufferSeconds);
+
+        m_job.reset();
+        m_progress.done = true;
+    }
+
+    this->report();
+    return m_progress.done;
+}
+
+CompositeNodePtr SceneLoader::finish()
+{
+    if (m_reading.valid())
+        m_reading.wait();
+
+    auto budget = m_uploadBudget;
+    m_uploadBudget = std::numeric_limits<size_t>::max();
+    this->update();
+    m_uploadBudget = budget;
+
+    return m_root;
+}
+
+CompositeNodePtr SceneLoader::root() const
+{
+    return m_root;
+}
+
+void SceneLoader::setUploadBudget(size_t bytes)
+{
+    m_uploadBudget = bytes;
+}
+
+size_t SceneLoader::uploadBudget() const
+{
+    return m_uploadBudget;
+}
+
+void SceneLoader::setProgressCallback(std::function<void(const SceneLoadProgress &)> callback)
+{
+    m_callback = std::move(callback);
+}
+
+const SceneLoadProgress &SceneLoader::progress() const
+{
+    return m_progress;
+}
+
+bool SceneLoader::done() const
+{
+    return m_progress.done;
+}
+
+bool SceneLoader::failed() const
+{
+    return m_progress.failed;
+}
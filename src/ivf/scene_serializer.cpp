@@ -1,9 +1,19 @@
 #include <ivf/scene_serializer.h>
 
 #include <ivf/nodes.h>
+#include <ivf/mesh_node.h>
 #include <ivf/logger.h>
 
+
+#include "scene_binary.h"
+#include "scene_load_job.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <set>
+#include <thread>
 #include <typeindex>
 #include <unordered_map>
 
@@ -16,6 +26,7 @@ using json = nlohmann::json;
 struct Registries {
     std::map<std::string, std::function<NodePtr()>> factories;
     std::unordered_map<std::type_index, std::string> typeNames;
+    std::set<std::string, std::less<>> threadSafe;
 };
 
 static Registries& reg()
@@ -25,13 +36,15 @@ static Registries& reg()
 }
 
 // ---------------------------------------------------------------------------
-void SceneSerializer::registerType(std::string_view typeName, std::function<NodePtr()> factory)
+void SceneSerializer::registerType(std::string_view typeName, std::function<NodePtr()> factory, bool threadSafe)
 {
     std::string name(typeName);
     // Create one dummy instance to capture its type_index for serialisation.
     auto instance = factory();
     reg().typeNames[std::type_index(typeid(*instance))] = name;
     reg().factories[name] = std::move(factory);
+    if (threadSafe) reg().threadSafe.insert(name);
+    else            reg().threadSafe.erase(name);
 }
 
 // ---------------------------------------------------------------------------
@@ -43,21 +56,22 @@ std::map<std::string, std::function<NodePtr()>>& SceneSerializer::typeRegistry()
 // ---------------------------------------------------------------------------
 void SceneSerializer::registerBuiltinTypes()
 {
-    registerType("CompositeNode",    []{ return CompositeNode::create(); });
-    registerType("Sphere",           []{ return Sphere::create(); });
-    registerType("Box",              []{ return Box::create(); });
-    registerType("Cube",             []{ return Cube::create(); });
-    registerType("Cylinder",         []{ return Cylinder::create(); });
-    registerType("CappedCylinder",   []{ return CappedCylinder::create(); });
-    registerType("Cone",             []{ return Cone::create(); });
-    registerType("CappedCone",       []{ return CappedCone::create(); });
-    registerType("Plane",            []{ return Plane::create(); });
-    registerType("Disk",             []{ return Disk::create(); });
-    registerType("Capsule",          []{ return Capsule::create(); });
-    registerType("RoundedBox",       []{ return RoundedBox::create(); });
-    registerType("Tube",             []{ return Tube::create(); });
-    registerType("CappedTube",       []{ return CappedTube::create(); });
-    registerType("Dodecahedron",     []{ return Dodecahedron::create(); });
+    registerType("CompositeNode",    []{ return CompositeNode::create(); }, true);
+    registerType("MeshNode",         []{ return MeshNode::create(); }, true);
+    registerType("Sphere",           []{ return Sphere::create(); }, true);
+    registerType("Box",              []{ return Box::create(); }, true);
+    registerType("Cube",             []{ return Cube::create(); }, true);
+    registerType("Cylinder",         []{ return Cylinder::create(); }, true);
+    registerType("CappedCylinder",   []{ return CappedCylinder::create(); }, true);
+    registerType("Cone",             []{ return Cone::create(); }, true);
+    registerType("CappedCone",       []{ return CappedCone::create(); }, true);
+    registerType("Plane",            []{ return Plane::create(); }, true);
+    registerType("Disk",             []{ return Disk::create(); }, true);
+    registerType("Capsule",          []{ return Capsule::create(); }, true);
+    registerType("RoundedBox",       []{ return RoundedBox::create(); }, true);
+    registerType("Tube",             []{ return Tube::create(); }, true);
+    registerType("CappedTube",       []{ return CappedTube::create(); }, true);
+    registerType("Dodecahedron",     []{ return Dodecahedron::create(); }, true);
 }
 
 // ---------------------------------------------------------------------------
@@ -185,14 +199,94 @@ void SceneSerializer::deserializeProperties(NodePtr node, const json& j)
     node->notifyPropertyChanged(""); // trigger geometry rebuild
 }
 
+// ---------------------------------------------------------------------------
+// Meshes of plain MeshNodes. Derived nodes rebuild theirs from their properties.
+// ---------------------------------------------------------------------------
+template <typename T, typename F> static json fieldToJson(const std::shared_ptr<F>& field)
+{
+    auto data = static_cast<const T*>(field->data());
+    return json(std::vector<T>(data, data + field->size()));
+}
+
+static void addMesh(std::shared_ptr<MeshNode> mn, GLuint primType, GLuint vertexCount, GLuint indexCount,
+                    const GLfloat* vertices, const GLfloat* normals, const GLfloat* texCoords,
+                    const GLfloat* colors, const GLuint* indices)
+{
+    if (vertexCount == 0) return;
+
+    // Meshes without colors are white, as imported models
+    std::vector<GLfloat> white;
+    if (!colors) {
+        white.assign(size_t(vertexCount) * 4, 1.0f);
+        colors = white.data();
+    }
+
+    mn->newMesh(vertexCount, indexCount / SceneBinary::indexColumns(primType), primType);
+    auto mesh = mn->currentMesh();
+    mesh->setGenerateNormals(normals == nullptr);
+    mesh->begin(primType);
+    mesh->setArrays(vertices, normals, texCoords, colors, indices);
+    mesh->end();
+}
+
+void SceneSerializer::serializeMeshes(NodePtr node, json& j)
+{
+    if (!node || typeid(*node) != typeid(MeshNode)) return;
+    auto mn = std::static_pointer_cast<MeshNode>(node);
+    json meshes = json::array();
+    for (auto& mesh : mn->meshes()) {
+        json m;
+        m["primType"]  = mesh->primType();
+        m["vertices"]  = fieldToJson<GLfloat>(mesh->vertices());
+        m["normals"]   = fieldToJson<GLfloat>(mesh->normals());
+        m["texCoords"] = fieldToJson<GLfloat>(mesh->texCoords());
+        m["colors"]    = fieldToJson<GLfloat>(mesh->colors());
+        if (mesh->indices())
+            m["indices"] = fieldToJson<GLuint>(mesh->indices());
+        meshes.push_back(std::move(m));
+    }
+    j["meshes"] = meshes;
+}
+
+void SceneSerializer::deserializeMeshes(NodePtr node, const json& j)
+{
+    if (!node || typeid(*node) != typeid(MeshNode) || !j.contains("meshes") || !j["meshes"].is_array()) return;
+    auto mn = std::static_pointer_cast<MeshNode>(node);
+    for (const auto& m : j["meshes"]) {
+        GLuint primType = m.value("primType", GLuint(GL_TRIANGLES));
+        auto vertices   = m.value("vertices",  std::vector<GLfloat>());
+        auto normals    = m.value("normals",   std::vector<GLfloat>());
+        auto texCoords  = m.value("texCoords", std::vector<GLfloat>());
+        auto colors     = m.value("colors",    std::vector<GLfloat>());
+        auto indices    = m.value("indices",   std::vector<GLuint>());
+
+        // Arrays must cover all vertices, indices whole primitives
+        GLuint vertexCount = GLuint(vertices.size() / 3);
+        GLuint columns     = SceneBinary::indexColumns(primType);
+        auto array = [](const std::vector<GLfloat>& v, size_t size) { return v.size() == size ? v.data() : nullptr; };
+        indices.resize(indices.size() / columns * columns);
+
+        addMesh(mn, primType, vertexCount, GLuint(indices.size()), vertices.data(),
+                array(normals, size_t(vertexCount) * 3), array(texCoords, size_t(vertexCount) * 2),
+                array(colors, size_t(vertexCount) * 4), indices.empty() ? nullptr : indices.data());
+    }
+    mn->updateBoundingBox();
+}
+
+// ---------------------------------------------------------------------------
+std::string SceneSerializer::typeName(NodePtr node)
+{
+    auto it = reg().typeNames.find(std::type_index(typeid(*node)));
+    return (it != reg().typeNames.end()) ? it->second : "Unknown";
+}
+
 // ---------------------------------------------------------------------------
 json SceneSerializer::serializeNode(NodePtr node)
 {
     json j;
 
     // Type name
-    auto it = reg().typeNames.find(std::type_index(typeid(*node)));
-    j["type"] = (it != reg().typeNames.end()) ? it->second : "Unknown";
+    j["type"] = typeName(node);
 
     // Base properties
     j["name"]    = node->name();
@@ -209,6 +303,9 @@ json SceneSerializer::serializeNode(NodePtr node)
     // Node-specific geometry parameters via PropertyInspectable
     serializeProperties(node, j);
 
+    // Mesh data (MeshNode)
+    serializeMeshes(node, j);
+
     // Children (CompositeNode)
     if (auto cn = std::dynamic_pointer_cast<CompositeNode>(node)) {
         json children = json::array();
@@ -222,6 +319,24 @@ json SceneSerializer::serializeNode(NodePtr node)
 
 // ---------------------------------------------------------------------------
 NodePtr SceneSerializer::deserializeNode(const json& j)
+{
+    auto node = createNode(j);
+
+    // Children
+    if (node && j.contains("children") && j["children"].is_array()) {
+        if (auto cn = std::dynamic_pointer_cast<CompositeNode>(node)) {
+            for (const auto& childJ : j["children"]) {
+                auto child = deserializeNode(childJ);
+                if (child) cn->add(child);
+            }
+        }
+    }
+
+    return node;
+}
+
+// ---------------------------------------------------------------------------
+NodePtr SceneSerializer::createNode(const json& j)
 {
     if (!j.contains("type")) return nullptr;
     std::string typeName = j["type"].get<std::string>();
@@ -253,15 +368,8 @@ NodePtr SceneSerializer::deserializeNode(const json& j)
     // Node-specific properties
     deserializeProperties(node, j);
 
-    // Children
-    if (j.contains("children") && j["children"].is_array()) {
-        if (auto cn = std::dynamic_pointer_cast<CompositeNode>(node)) {
-            for (const auto& childJ : j["children"]) {
-                auto child = deserializeNode(childJ);
-                if (child) cn->add(child);
-            }
-        }
-    }
+    // Mesh data
+    deserializeMeshes(node, j);
 
     return node;
 }
@@ -284,24 +392,560 @@ bool SceneSerializer::save(CompositeNodePtr root, std::string_view path)
 // ---------------------------------------------------------------------------
 CompositeNodePtr SceneSerializer::load(std::string_view path)
 {
-    std::string pathStr(path);
-    std::ifstream f{pathStr};
-    if (!f.is_open()) {
-        logWarning("SceneSerializer: cannot open '" + std::string(path) + "' for reading", "SceneSerializer");
+    SceneLoadJob job;
+    job.path   = path;
+    job.binary = SceneBinary::isSceneFile(job.path);
+    return loadScene(job);
+}
+
+// ---------------------------------------------------------------------------
+// Binary scene files
+// ---------------------------------------------------------------------------
+static void storeFloats(const float* values, int count, float* dest)
+{
+    std::memcpy(dest, values, count * sizeof(float));
+}
+
+void SceneSerializer::writeBinaryNode(NodePtr node, int parent, SceneBinary::Writer& writer)
+{
+    using namespace SceneBinary;
+
+    NodeRecord rec{};
+    rec.parent = parent;
+    rec.flags  = HasType | HasName | HasVisible;
+    if (node->visible()) rec.flags |= Visible;
+    rec.type   = writer.addString(typeName(node));
+    rec.name   = writer.addString(node->name());
+
+    // Transform
+    if (auto tn = std::dynamic_pointer_cast<TransformNode>(node)) {
+        rec.flags |= HasTransform;
+        storeFloats(&tn->pos()[0], 3, rec.pos);
+        storeFloats(&tn->eulerAngles()[0], 3, rec.eulerAngles);
+        storeFloats(&tn->scale()[0], 3, rec.scale);
+        storeFloats(&tn->rotAxis()[0], 3, rec.rotAxis);
+        rec.rotAngle = tn->rotAngle();
+    }
+
+    // Material
+    if (auto mat = node->material()) {
+        rec.flags |= HasMaterial;
+        if (mat->useLighting()) rec.flags |= UseLighting;
+        storeFloats(&mat->diffuseColor()[0], 4, rec.diffuse);
+        storeFloats(&mat->specularColor()[0], 4, rec.specular);
+        storeFloats(&mat->ambientColor()[0], 4, rec.ambient);
+        rec.shininess = mat->shininess();
+        rec.alpha     = mat->alpha();
+    }
+
+    // Properties, the same as serializeProperties()
+    rec.firstProperty = uint32_t(writer.properties.size());
+    for (const auto& prop : node->getProperties()) {
+        if (prop.readOnly) continue;
+        PropertyRecord pr{};
+        pr.name = writer.addString(prop.name);
+        bool stored = true;
+        std::visit([&](auto* ptr) {
+            using T = std::remove_pointer_t<decltype(ptr)>;
+            if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+                double number = *ptr;
+                pr.kind = PropertyKind::Float;
+                std::memcpy(&pr.value, &number, sizeof(number));
+            }
+            else if constexpr (std::is_same_v<T, int>) {
+                pr.kind  = PropertyKind::Integer;
+                pr.value = std::uint64_t(std::int64_t(*ptr));
+            }
+            else if constexpr (std::is_same_v<T, bool>) {
+                pr.kind  = PropertyKind::Bool;
+                pr.value = *ptr ? 1 : 0;
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                pr.kind  = PropertyKind::String;
+                pr.value = packString(writer.addString(*ptr));
+            }
+            else if constexpr (std::is_same_v<T, glm::vec3> || std::is_same_v<T, glm::vec4>) {
+                double values[4];
+                for (int i = 0; i < T::length(); i++) values[i] = (*ptr)[i];
+                pr.kind  = PropertyKind::FloatArray;
+                pr.count = T::length();
+                pr.value = writer.addData(values, pr.count * sizeof(double));
+            }
+            else
+                stored = false; // Other types (uvec3, uvec4, etc.) skipped
+        }, prop.value);
+        if (stored) writer.properties.push_back(pr);
+    }
+    rec.propertyCount = uint32_t(writer.properties.size()) - rec.firstProperty;
+    if (rec.propertyCount > 0) rec.flags |= HasProperties;
+
+    // Mesh data, the same as serializeMeshes()
+    if (typeid(*node) == typeid(MeshNode)) {
+        rec.flags |= HasMeshes;
+        rec.firstMesh = uint32_t(writer.meshes.size());
+        for (auto& mesh : std::static_pointer_cast<MeshNode>(node)->meshes()) {
+            MeshRecord mr{};
+            mr.primType    = mesh->primType();
+            mr.flags       = HasNormals | HasTexCoords | HasColors;
+            mr.vertexCount = mesh->vertices()->rows();
+            mr.vertices    = writer.addData(mesh->vertices()->data(), mesh->vertices()->memSize());
+            mr.normals     = writer.addData(mesh->normals()->data(), mesh->normals()->memSize());
+            mr.texCoords   = writer.addData(mesh->texCoords()->data(), mesh->texCoords()->memSize());
+            mr.colors      = writer.addData(mesh->colors()->data(), mesh->colors()->memSize());
+            if (auto indices = mesh->indices()) {
+                mr.flags     |= HasIndices;
+                mr.indexCount = indices->size();
+                mr.indices    = writer.addData(indices->data(), indices->memSize());
+            }
+            writer.meshes.push_back(mr);
+        }
+        rec.meshCount = uint32_t(writer.meshes.size()) - rec.firstMesh;
+    }
+
+    // Children, stored after their parent
+    auto cn = std::dynamic_pointer_cast<CompositeNode>(node);
+    if (cn) rec.flags |= HasChildren;
+
+    int index = int(writer.nodes.size());
+    writer.nodes.push_back(rec);
+
+    if (cn)
+        for (auto& child : cn->nodes())
+            writeBinaryNode(child, index, writer);
+}
+
+// ---------------------------------------------------------------------------
+// Assigns binary properties with the conversions of deserializeProperties()
+static void applyProperties(NodePtr node, const SceneBinary::Reader& reader,
+                            std::span<const SceneBinary::PropertyRecord> records)
+{
+    using namespace SceneBinary;
+
+    for (const auto& prop : node->getProperties()) {
+        if (prop.readOnly) continue;
+
+        // The last property of a name wins, as in a JSON object
+        const PropertyRecord* pr = nullptr;
+        for (const auto& record : records)
+            if (reader.string(record.name) == prop.name) pr = &record;
+        if (!pr) continue;
+
+        double number  = 0.0;
+        bool isNumber  = pr->kind == PropertyKind::Integer || pr->kind == PropertyKind::Float;
+        if (pr->kind == PropertyKind::Integer) number = double(std::int64_t(pr->value));
+        if (pr->kind == PropertyKind::Float)   std::memcpy(&number, &pr->value, sizeof(number));
+
+        auto array = [&](int size) {
+            return (pr->kind == PropertyKind::FloatArray && pr->count >= uint32_t(size))
+                ? reader.data<double>(pr->value) : nullptr;
+        };
+
+        std::visit([&](auto* ptr) {
+            using T = std::remove_pointer_t<decltype(ptr)>;
+            if constexpr (std::is_same_v<T, double>) {
+                if (isNumber) *ptr = number;
+            }
+            else if constexpr (std::is_same_v<T, float>) {
+                if (isNumber) *ptr = float(number);
+            }
+            else if constexpr (std::is_same_v<T, int>) {
+                if (pr->kind == PropertyKind::Integer) *ptr = int(std::int64_t(pr->value));
+                else if (isNumber)                    *ptr = int(number);
+            }
+            else if constexpr (std::is_same_v<T, bool>) {
+                if (pr->kind == PropertyKind::Bool) *ptr = pr->value != 0;
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                if (pr->kind == PropertyKind::String) *ptr = reader.string(unpackString(pr->value));
+            }
+            else if constexpr (std::is_same_v<T, glm::vec3>) {
+                auto v = array(3);
+                *ptr = v ? glm::vec3(v[0], v[1], v[2]) : glm::vec3(0, 0, 0);
+            }
+            else if constexpr (std::is_same_v<T, glm::vec4>) {
+                auto v = array(4);
+                *ptr = v ? glm::vec4(v[0], v[1], v[2], v[3]) : glm::vec4(1, 1, 1, 1);
+            }
+        }, prop.value);
+    }
+    node->notifyPropertyChanged(""); // trigger geometry rebuild
+}
+
+// ---------------------------------------------------------------------------
+NodePtr SceneSerializer::readBinaryNode(const SceneBinary::Reader& reader, std::uint32_t index)
+{
+    using namespace SceneBinary;
+    const auto& rec = reader.nodes[index];
+
+    // Fields without binary encoding, handled as in a JSON file
+    json extra = json::object();
+    if (rec.extra.length > 0) extra = json::parse(reader.string(rec.extra));
+
+    std::string typeName;
+    if (rec.flags & HasType)        typeName = reader.string(rec.type);
+    else if (extra.contains("type")) typeName = extra["type"].get<std::string>();
+    else return nullptr;
+
+    auto it = reg().factories.find(typeName);
+    if (it == reg().factories.end()) {
+        logWarning("SceneSerializer: unknown type '" + typeName + "' — skipped", "SceneSerializer");
         return nullptr;
     }
+
+    NodePtr node = it->second();
+    if (!node) return nullptr;
+
+    // Base properties
+    if (rec.flags & HasName)            node->setName(std::string(reader.string(rec.name)));
+    else if (extra.contains("name"))    node->setName(extra["name"].get<std::string>());
+    if (rec.flags & HasVisible)         node->setVisible((rec.flags & Visible) != 0);
+    else if (extra.contains("visible")) node->setVisible(extra["visible"].get<bool>());
+
+    // Transform
+    if (auto tn = std::dynamic_pointer_cast<TransformNode>(node)) {
+        if (rec.flags & HasTransform) {
+            tn->setPos(glm::vec3(rec.pos[0], rec.pos[1], rec.pos[2]));
+            tn->setEulerAngles(glm::vec3(rec.eulerAngles[0], rec.eulerAngles[1], rec.eulerAngles[2]));
+            tn->setScale(glm::vec3(rec.scale[0], rec.scale[1], rec.scale[2]));
+            tn->setRotAxis(glm::vec3(rec.rotAxis[0], rec.rotAxis[1], rec.rotAxis[2]));
+            tn->setRotAngle(rec.rotAngle);
+        }
+        else
+            deserializeTransform(tn, extra);
+    }
+
+    // Material
+    if (rec.flags & HasMaterial) {
+        auto mat = Material::create();
+        mat->setDiffuseColor(glm::vec4(rec.diffuse[0], rec.diffuse[1], rec.diffuse[2], rec.diffuse[3]));
+        mat->setSpecularColor(glm::vec4(rec.specular[0], rec.specular[1], rec.specular[2], rec.specular[3]));
+        mat->setAmbientColor(glm::vec4(rec.ambient[0], rec.ambient[1], rec.ambient[2], rec.ambient[3]));
+        mat->setShininess(rec.shininess);
+        mat->setAlpha(rec.alpha);
+        mat->setUseLighting((rec.flags & UseLighting) != 0);
+        node->setMaterial(mat);
+    }
+    else if (extra.contains("material")) {
+        auto mat = Material::create();
+        deserializeMaterial(mat, extra);
+        node->setMaterial(mat);
+    }
+
+    // Node-specific properties
+    if (rec.flags & HasProperties)
+        applyProperties(node, reader, reader.nodeProperties(rec));
+    else
+        deserializeProperties(node, extra);
+
+    // Mesh data, copied from the mapped file into the mesh buffers
+    if ((rec.flags & HasMeshes) && typeid(*node) == typeid(MeshNode)) {
+        auto mn = std::static_pointer_cast<MeshNode>(node);
+        for (const auto& mr : reader.nodeMeshes(rec)) {
+            auto array = [&](uint32_t flag, std::uint64_t offset) {
+                return (mr.flags & flag) ? reader.data<GLfloat>(offset) : nullptr;
+            };
+            addMesh(mn, mr.primType, mr.vertexCount, mr.indexCount, reader.data<GLfloat>(mr.vertices),
+                    array(HasNormals, mr.normals), array(HasTexCoords, mr.texCoords), array(HasColors, mr.colors),
+                    (mr.flags & HasIndices) && mr.indexCount > 0 ? reader.data<GLuint>(mr.indices) : nullptr);
+        }
+        mn->updateBoundingBox();
+    }
+    else if (!(rec.flags & HasMeshes))
+        deserializeMeshes(node, extra);
+
+    // Children without binary encoding; the others are linked by linkNodes()
+    auto cn = std::dynamic_pointer_cast<CompositeNode>(node);
+    if (cn && !(rec.flags & HasChildren) && extra.contains("children") && extra["children"].is_array()) {
+        for (const auto& childJ : extra["children"]) {
+            auto child = deserializeNode(childJ);
+            if (child) cn->add(child);
+        }
+    }
+
+    return node;
+}
+
+// ---------------------------------------------------------------------------
+bool SceneSerializer::saveBinary(CompositeNodePtr root, std::string_view path)
+{
+    if (!root) return false;
+    SceneBinary::Writer writer;
+    writeBinaryNode(root, -1, writer);
+
+    std::string error;
+    if (!writer.save(std::string(path), error)) {
+        logWarning("SceneSerializer: cannot write '" + std::string(path) + "': " + error, "SceneSerializer");
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+CompositeNodePtr SceneSerializer::loadBinary(std::string_view path)
+{
+    SceneLoadJob job;
+    job.path   = path;
+    job.binary = true;
+    return loadScene(job);
+}
+
+// ---------------------------------------------------------------------------
+bool SceneSerializer::isBinary(std::string_view path)
+{
+    return SceneBinary::isSceneFile(std::string(path));
+}
+
+// ---------------------------------------------------------------------------
+bool SceneSerializer::convertToBinary(std::string_view jsonPath, std::string_view binaryPath)
+{
+    std::ifstream f{std::string(jsonPath)};
+    if (!f.is_open()) {
+        logWarning("SceneSerializer: cannot open '" + std::string(jsonPath) + "' for reading", "SceneSerializer");
+        return false;
+    }
     json j;
     try { f >> j; } catch (const std::exception& e) {
         logWarning(std::string("SceneSerializer: JSON parse error: ") + e.what(), "SceneSerializer");
-        return nullptr;
+        return false;
+    }
+
+    SceneBinary::Writer writer;
+    std::string error;
+    if (!SceneBinary::fromJson(j, writer, error) || !writer.save(std::string(binaryPath), error)) {
+        logWarning("SceneSerializer: cannot convert '" + std::string(jsonPath) + "': " + error, "SceneSerializer");
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+bool SceneSerializer::convertToJson(std::string_view binaryPath, std::string_view jsonPath)
+{
+    SceneBinary::Reader reader;
+    json j;
+    std::string error;
+    if (!reader.open(std::string(binaryPath), error) || !SceneBinary::toJson(reader, j, error)) {
+        logWarning("SceneSerializer: cannot convert '" + std::string(binaryPath) + "': " + error, "SceneSerializer");
+        return false;
+    }
+
+    std::ofstream f{std::string(jsonPath)};
+    if (!f.is_open()) {
+        logWarning("SceneSerializer: cannot open '" + std::string(jsonPath) + "' for writing", "SceneSerializer");
+        return false;
+    }
+    f << j.dump(2);
+    return f.good();
+}
+
+// ---------------------------------------------------------------------------
+// Loading in phases
+// ---------------------------------------------------------------------------
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void flattenJson(const json& j, int parent, std::vector<SceneLoadJob::Item>& items)
+{
+    if (!j.is_object()) return;
+    int index = int(items.size());
+    SceneLoadJob::Item item;
+    item.json   = &j;
+    item.parent = parent;
+    items.push_back(item);
+    if (j.contains("children") && j["children"].is_array())
+        for (const auto& childJ : j["children"])
+            flattenJson(childJ, index, items);
+}
+
+static void collectPendingMeshes(const NodePtr& node, std::vector<std::shared_ptr<Mesh>>& meshes)
+{
+    if (auto mn = std::dynamic_pointer_cast<MeshNode>(node))
+        for (auto& mesh : mn->meshes())
+            if (mesh->buffersPending()) meshes.push_back(mesh);
+
+    if (auto cn = std::dynamic_pointer_cast<CompositeNode>(node))
+        for (auto& child : cn->nodes())
+            collectPendingMeshes(child, meshes);
+}
+
+// ---------------------------------------------------------------------------
+bool SceneSerializer::readScene(SceneLoadJob& job)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (job.binary) {
+        std::string error;
+        if (job.reader.open(job.path, error) && job.reader.nodes.empty())
+            error = "scene file has no nodes";
+        if (!error.empty()) {
+            job.error = "SceneSerializer: cannot read '" + job.path + "': " + error;
+            return false;
+        }
+        job.items.resize(job.reader.nodes.size());
+        for (size_t i = 0; i < job.items.size(); i++) {
+            job.items[i].record = uint32_t(i);
+            job.items[i].parent = job.reader.nodes[i].parent;
+        }
+    }
+    else {
+        std::ifstream f{job.path};
+        if (!f.is_open()) {
+            job.error = "SceneSerializer: cannot open '" + job.path + "' for reading";
+            return false;
+        }
+        try { f >> job.document; } catch (const std::exception& e) {
+            job.error = std::string("SceneSerializer: JSON parse error: ") + e.what();
+            return false;
+        }
+        flattenJson(job.document, -1, job.items);
+    }
+
+    job.nodeCount   = job.items.size();
+    job.readSeconds = secondsSince(start);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+NodePtr SceneSerializer::buildNode(SceneLoadJob& job, size_t index)
+{
+    const auto& item = job.items[index];
+    return job.binary ? readBinaryNode(job.reader, item.record) : createNode(*item.json);
+}
+
+// ---------------------------------------------------------------------------
+void SceneSerializer::buildNodes(SceneLoadJob& job)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Only registered thread safe types are created here, so that the workers never log or make
+    // GL calls. The others, and binary nodes with fields in JSON text, are left to linkNodes().
+    auto onWorker = [&job](const SceneLoadJob::Item& item) {
+        std::string_view typeName;
+        if (job.binary) {
+            const auto& rec = job.reader.nodes[item.record];
+            if (rec.extra.length > 0 || !(rec.flags & SceneBinary::HasType)) return false;
+            typeName = job.reader.string(rec.type);
+        }
+        else {
+            auto type = item.json->find("type");
+            if (type == item.json->end() || !type->is_string()) return false;
+            typeName = type->get_ref<const std::string&>();
+        }
+        return reg().threadSafe.find(typeName) != reg().threadSafe.end();
+    };
+
+    // Nodes differ widely in cost, so the threads take small batches from a shared counter
+    constexpr size_t batch = 4;
+    std::atomic<size_t> next{0};
+    auto count = job.items.size();
+
+    auto buildBatches = [&] {
+        bool defer = Mesh::deferBufferCreation();
+        Mesh::setDeferBufferCreation(true);
+
+        for (size_t begin; (begin = next.fetch_add(batch)) < count;) {
+            for (size_t i = begin; i < std::min(count, begin + batch); i++) {
+                auto& item = job.items[i];
+                if (!onWorker(item)) continue;
+                try {
+                    item.node  = buildNode(job, i);
+                    item.built = true;
+                    job.nodesBuilt++;
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(job.mutex);
+                    if (!job.exception) job.exception = std::current_exception();
+                }
+            }
+        }
+
+        Mesh::setDeferBufferCreation(defer);
+    };
+
+    // Helper threads of its own rather than the ThreadPool. A frame waiting in
+    // ThreadPool::parallelFor() helps with queued tasks and would stall on a batch of nodes.
+    unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    std::vector<std::thread> helpers;
+
+    for (unsigned int i = 1; i < threadCount; i++)
+        helpers.emplace_back(buildBatches);
+
+    buildBatches();
+
+    for (auto& helper : helpers)
+        helper.join();
+
+    job.buildSeconds = secondsSince(start);
+}
+
+// ---------------------------------------------------------------------------
+CompositeNodePtr SceneSerializer::linkNodes(SceneLoadJob& job)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (job.exception) std::rethrow_exception(job.exception);
+
+    // Remaining nodes on the calling thread, logging unknown types
+    for (size_t i = 0; i < job.items.size(); i++) {
+        auto& item = job.items[i];
+        if (item.built) continue;
+        item.node  = buildNode(job, i);
+        item.built = true;
+        job.nodesBuilt++;
     }
 
-    auto node = deserializeNode(j);
+    // Parents precede their children, so adding in order keeps the child order. Children of
+    // skipped or non-composite nodes are dropped, as by deserializeNode().
+    for (const auto& item : job.items) {
+        if (item.parent < 0 || !item.node) continue;
+        auto cn = std::dynamic_pointer_cast<CompositeNode>(job.items[item.parent].node);
+        if (cn) cn->add(item.node);
+    }
+
+    NodePtr node = job.items.empty() ? nullptr : job.items[0].node;
     auto composite = std::dynamic_pointer_cast<CompositeNode>(node);
     if (!composite) {
         // Wrap a non-composite root in a CompositeNode
         composite = CompositeNode::create();
         if (node) composite->add(node);
     }
+
+    collectPendingMeshes(composite, job.meshes);
+
+    // The nodes hold their own copies of the data
+    job.document = json();
+    job.items.clear();
+
+    job.linkSeconds = secondsSince(start);
     return composite;
 }
+
+// ---------------------------------------------------------------------------
+CompositeNodePtr SceneSerializer::loadScene(SceneLoadJob& job)
+{
+    if (!readScene(job)) {
+        logWarning(job.error, "SceneSerializer");
+        return nullptr;
+    }
+
+    CompositeNodePtr root;
+    try {
+        buildNodes(job);
+        root = linkNodes(job);
+    } catch (const std::exception& e) {
+        logWarning(std::string("SceneSerializer: invalid scene file: ") + e.what(), "SceneSerializer");
+        return nullptr;
+    }
+
+    // GL buffers in one batch on the calling thread
+    auto start = std::chrono::steady_clock::now();
+    for (auto& mesh : job.meshes)
+        mesh->createBuffers();
+    job.bufferSeconds = secondsSince(start);
+
+    logInfofc("SceneSerializer", "Loaded {} ({} nodes, {} meshes): read {:.3f} s, nodes {:.3f} s, link {:.3f} s, "
+              "buffers {:.3f} s", job.path, job.nodesBuilt.load(), job.meshes.size(), job.readSeconds,
+              job.buildSeconds, job.linkSeconds, job.bufferSeconds);
+    return root;
+}
@@ -5,6 +5,7 @@
 #include <ivf/stock_shaders.h>
 #include <ivf/pbr_shaders.h>
 #include <ivf/bump_shaders.h>
+#include <ivf/deformer_shaders.h>
 #include <ivf/post_shaders.h>
 #include <ivf/vertex_shader.h>
 #include <ivf/logger.h>
@@ -25,6 +26,23 @@ namespace {
 
 constexpr GLuint kDefaultCubemapUnit = 15;
 
+// Vertex shader source with the GPU deformer snippet enabled, inserted after the #version line
+
+std::string withDeformers(const std::string &vertexSource)
+{
+    std::string source = vertexSource;
+    auto versionPos = source.find("#version");
+    if (versionPos == std::string::npos)
+        return source;
+
+    auto lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos)
+        return source;
+
+    source.insert(lineEnd + 1, "#define IVF_DEFORMERS\n" + ivf::deformer_vert_shader_source + "\n");
+    return source;
+}
+
 void bindDefaultTexture2D(GLuint unit)
 {
     static GLuint defaultTexture = 0;
@@ -211,7 +229,32 @@ std::shared_ptr<Program> ShaderManager::loadProgramFromStrings(const std::string
 std::shared_ptr<Program> ivf::ShaderManager::loadBasicShader()
 {
     logInfo("Loading basic shader.", "ShaderManager");
-    auto program = loadProgramFromStrings(ivf::basic_vert_shader_source, ivf::basic_frag_shader_source, "basic");
+    auto program =
+        loadProgramFromStrings(withDeformers(ivf::basic_vert_shader_source), ivf::basic_frag_shader_source, "basic");
+    bindDefaultTexture2D(0);
+    bindDefaultTexture2D(1);
+    bindDefaultTexture2D(2);
+    bindDefaultTexture2D(3);
+    bindDefaultTexture2D(4);
+    bindDefaultCubemap(kDefaultCubemapUnit);
+    program->uniformInt("texture0", 0);
+    program->uniformInt("envMap", kDefaultCubemapUnit);
+    return program;
+}
+
+std::shared_ptr<Program> ivf::ShaderManager::loadClusteredBasicShader()
+{
+    logInfo("Loading clustered basic shader.", "ShaderManager");
+
+    // Same source as the basic shader, compiled for GLSL 4.30 with the clustered light loop enabled.
+
+    std::string fragSource = ivf::basic_frag_shader_source;
+    auto versionPos = fragSource.find("#version 400 core");
+    if (versionPos != std::string::npos)
+        fragSource.replace(versionPos, std::string("#version 400 core").size(),
+                           "#version 430 core\n#define IVF_CLUSTERED_LIGHTING");
+
+    auto program = loadProgramFromStrings(withDeformers(ivf::basic_vert_shader_source), fragSource, "basic");
     bindDefaultTexture2D(0);
     bindDefaultTexture2D(1);
     bindDefaultTexture2D(2);
@@ -253,7 +296,8 @@ std::shared_ptr<Program> ivf::ShaderManager::loadBumpShader()
 {
     logInfo("Loading bump shader.", "ShaderManager");
     auto previousProgram = m_currentProgram;
-    auto program = loadProgramFromStrings(ivf::bump_vert_shader_source, ivf::bump_frag_shader_source, "bump", false);
+    auto program = loadProgramFromStrings(withDeformers(ivf::bump_vert_shader_source), ivf::bump_frag_shader_source,
+                                          "bump", false);
 
     bindDefaultTexture2D(0);
     bindDefaultTexture2D(1);
@@ -0,0 +1,125 @@
+#include <ivf/shadow_caster_tracker.h>
+
+#include <ivf/transform_node.h>
+
+using namespace ivf;
+
+namespace {
+
+bool sameBox(const BoundingBox &a, const BoundingBox &b)
+{
+    if (!a.isValid() || !b.isValid())
+        return a.isValid() == b.isValid();
+
+    return a.min() == b.min() && a.max() == b.max();
+}
+
+} // namespace
+
+ShadowCasterTracker::ShadowCasterTracker()
+{}
+
+void ShadowCasterTracker::update(CompositeNodePtr scene)
+{
+    m_frame++;
+    m_dirtyRegions.clear();
+    m_sceneBBox.clear();
+
+    if (scene)
+        this->visitNode(scene.get(), glm::mat4(1.0f));
+
+    // Nodes not seen in this traversal were removed or hidden
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.frame != m_frame)
+        {
+            m_dirtyRegions.push_back(it->second.worldBBox);
+            it = m_entries.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void ShadowCasterTracker::visitNode(Node *node, const glm::mat4 &parentMatrix)
+{
+    if (!node || !node->visible())
+        return;
+
+    if (auto compositeNode = dynamic_cast<CompositeNode *>(node))
+    {
+        glm::mat4 worldMatrix = parentMatrix * compositeNode->localTransform();
+
+        // Only this node's own bounding box, the children are tracked individually
+
+        this->track(compositeNode, worldMatrix, compositeNode->TransformNode::localBoundingBox());
+
+        for (auto &child : compositeNode->nodes())
+            this->visitNode(child.get(), worldMatrix);
+    }
+    else if (auto transformNode = dynamic_cast<TransformNode *>(node))
+    {
+        glm::mat4 worldMatrix = parentMatrix * transformNode->localTransform();
+        this->track(transformNode, worldMatrix, transformNode->localBoundingBox());
+    }
+}
+
+void ShadowCasterTracker::track(const TransformNode *node, const glm::mat4 &worldMatrix,
+                                const BoundingBox &localBBox)
+{
+    uint64_t revision = node->contentRevision();
+    BoundingBox worldBBox;
+
+    if (localBBox.isValid())
+        worldBBox = localBBox.transform(worldMatrix);
+    else
+        worldBBox.add(glm::vec3(worldMatrix[3]));
+
+    m_sceneBBox.add(worldBBox);
+
+    auto it = m_entries.find(node);
+
+    if (it == m_entries.end())
+    {
+        m_entries[node] = {worldMatrix, localBBox, worldBBox, revision, m_frame};
+        m_dirtyRegions.push_back(worldBBox);
+        return;
+    }
+
+    auto &entry = it->second;
+
+    if (entry.worldMatrix != worldMatrix || !sameBox(entry.localBBox, localBBox) || entry.revision != revision)
+    {
+        m_dirtyRegions.push_back(entry.worldBBox);
+        m_dirtyRegions.push_back(worldBBox);
+
+        entry.worldMatrix = worldMatrix;
+        entry.localBBox = localBBox;
+        entry.worldBBox = worldBBox;
+        entry.revision = revision;
+    }
+
+    entry.frame = m_frame;
+}
+
+void ShadowCasterTracker::reset()
+{
+    m_entries.clear();
+    m_dirtyRegions.clear();
+}
+
+const std::vector<BoundingBox> &ShadowCasterTracker::dirtyRegions() const
+{
+    return m_dirtyRegions;
+}
+
+BoundingBox ShadowCasterTracker::sceneBoundingBox() const
+{
+    return m_sceneBBox;
+}
+
+size_t ShadowCasterTracker::nodeCount() const
+{
+    return m_entries.size();
+}
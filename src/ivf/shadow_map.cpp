@@ -1,6 +1,7 @@
 #include <ivf/shadow_map.h>
 
 #include <ivf/logger.h>
+#include <ivf/render_target_pool.h>
 
 #include <iostream>
 
@@ -13,8 +14,7 @@ ShadowMap::ShadowMap(int width, int height) : m_width(width), m_height(height),
 
 ShadowMap::~ShadowMap()
 {
-    glDeleteFramebuffers(1, &m_fbo);
-    glDeleteTextures(1, &m_depthTexture);
+    RenderTargetPool::instance()->release(m_target);
 }
 
 std::shared_ptr<ShadowMap> ShadowMap::create(int width, int height)
@@ -24,32 +24,25 @@ std::shared_ptr<ShadowMap> ShadowMap::create(int width, int height)
 
 void ShadowMap::initialize()
 {
-    // Create depth texture
-    glGenTextures(1, &m_depthTexture);
-    glBindTexture(GL_TEXTURE_2D, m_depthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, m_width, m_height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    // Try these parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    RenderTargetDesc desc;
+    desc.width = m_width;
+    desc.height = m_height;
+    desc.colorFormat = GL_NONE;
+    desc.depthFormat = GL_DEPTH_COMPONENT32F;
+    desc.depthTexture = true;
+
+    if (!RenderTargetPool::instance()->reacquire(m_target, desc))
+        return;
+
+    // Outside the map counts as lit, comparison is done in the shader
+
+    glBindTexture(GL_TEXTURE_2D, m_target->depthTexture());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     float borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
     glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    // Turn OFF comparison mode for debugging
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
-
-    // Create and configure FBO
-    glGenFramebuffers(1, &m_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-
-    // Check framebuffer status
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        logErrorfc("ShadowMap", "Shadow map framebuffer is not complete!");
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void ShadowMap::resize(int width, int height)
@@ -61,30 +54,41 @@ void ShadowMap::resize(int width, int height)
     m_height = height;
 
     this->unbind();
-
-    glDeleteFramebuffers(1, &m_fbo);
-    glDeleteTextures(1, &m_depthTexture);
-
-    // glBindTexture(GL_TEXTURE_2D, m_depthTexture);
-    // glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-
     this->initialize();
 }
 
 void ShadowMap::bind()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_target->fbo());
     glViewport(0, 0, m_width, m_height);
 }
 
+void ShadowMap::bindRegion(int x, int y, int width, int height)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_target->fbo());
+    glViewport(x, y, width, height);
+    glScissor(x, y, width, height);
+    glEnable(GL_SCISSOR_TEST);
+}
+
 void ShadowMap::unbind()
 {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+int ShadowMap::width() const
+{
+    return m_width;
+}
+
+int ShadowMap::height() const
+{
+    return m_height;
+}
+
 GLuint ShadowMap::depthTexture() const
 {
-    return m_depthTexture;
+    return m_target ? m_target->depthTexture() : 0;
 }
 
 void ShadowMap::setLightSpaceMatrix(const glm::mat4 &matrix)
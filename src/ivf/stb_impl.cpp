@@ -0,0 +1,9 @@
+// Implementations of stb_image and stb_image_write, used by TextureImage, FrameCapture and
+// GLFWWindow. They are compiled into ivf so that programs linking only ivf, such as the tools,
+// find them in static builds.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
@@ -6,21 +6,24 @@
 #include <ivf/utils.h>
 #include <ivf/logger.h>
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 using namespace std;
 using namespace ivf;
 
 TextNode::TextNode()
-    : m_text(""), m_VAO(0), m_vertexVBO(0), m_texVBO(0), m_textColor(1.0f, 1.0f, 0.0f), m_textRendering(true),
-      m_useFixedTextColor(false), m_maxPixels(400), m_scale(1.0), m_textAlignX(TextAlignX::LEFT),
-      m_textAlignY(TextAlignY::BOTTOM), m_textHeight(-1.0), m_textWidth(-1.0)
+    : m_text(""), m_sdf(GlyphAtlas::sdfSupported()), m_textRendering(true), m_useFixedTextColor(false),
+      m_textColor(1.0f, 1.0f, 0.0f), m_maxPixels(64), m_scale(1.0), m_textAlignX(TextAlignX::LEFT),
+      m_textAlignY(TextAlignY::BOTTOM), m_textWidth(-1.0), m_textHeight(-1.0), m_VAO(0), m_vertexVBO(0), m_texVBO(0)
 {
     m_textRenderingId = ShaderManager::instance()->currentProgram()->uniformLoc("textRendering");
     m_useFixedTextColorId = ShaderManager::instance()->currentProgram()->uniformLoc("useFixedTextColor");
     m_textColorId = ShaderManager::instance()->currentProgram()->uniformLoc("textColor");
     m_useTextureId = ShaderManager::instance()->currentProgram()->uniformLoc("useTexture");
+    m_textSdfId = ShaderManager::instance()->currentProgram()->uniformLoc("textSdf");
 
     this->setUseMaterial(true);
     this->setUseTexture(false);
@@ -30,11 +33,20 @@ TextNode::TextNode()
     m_normalAttrId = ShaderManager::instance()->currentProgram()->attribId("aNormal");
     m_colorAttrId = ShaderManager::instance()->currentProgram()->attribId("aColor");
 
-    this->updateCharMap();
     this->prepareBuffers();
     this->setName("TextNode");
 }
 
+TextNode::~TextNode()
+{
+    glDeleteBuffers(1, &m_vertexVBO);
+    glDeleteBuffers(1, &m_texVBO);
+    glDeleteBuffers(1, &m_colorVBO);
+    glDeleteBuffers(1, &m_normalVBO);
+    glDeleteBuffers(1, &m_indexVBO);
+    glDeleteVertexArrays(1, &m_VAO);
+}
+
 std::shared_ptr<TextNode> ivf::TextNode::create()
 {
     return std::make_shared<TextNode>();
@@ -43,7 +55,8 @@ std::shared_ptr<TextNode> ivf::TextNode::create()
 void ivf::TextNode::setText(const std::string text)
 {
     m_text = text;
-    updateTextSize();
+    m_codepoints = GlyphAtlas::decodeUtf8(m_text);
+    m_dirty = true;
 }
 
 std::string ivf::TextNode::text()
@@ -54,6 +67,7 @@ std::string ivf::TextNode::text()
 void ivf::TextNode::setSize(const float size)
 {
     m_scale = size;
+    m_dirty = true;
 }
 
 float ivf::TextNode::size()
@@ -64,11 +78,13 @@ float ivf::TextNode::size()
 void ivf::TextNode::setAlignX(const TextAlignX align)
 {
     m_textAlignX = align;
+    m_dirty = true;
 }
 
 void ivf::TextNode::setAlignY(const TextAlignY align)
 {
     m_textAlignY = align;
+    m_dirty = true;
 }
 
 TextAlignX ivf::TextNode::alignX()
@@ -81,114 +97,91 @@ TextAlignY ivf::TextNode::alignY()
     return m_textAlignY;
 }
 
-void ivf::TextNode::updateTextSize()
+void ivf::TextNode::setFont(const std::string name)
 {
-    std::string::const_iterator c;
-
-    m_textWidth = 0.0;
-    m_textHeight = 0.0;
+    m_fontName = name;
+    m_dirty = true;
+}
 
-    for (c = m_text.begin(); c != m_text.end(); c++)
-    {
-        CharacterInfo ch = m_charMap[*c];
-        m_textWidth += (ch.glyphAdvance >> 6);
-        if (ch.glyphSize.y > m_textHeight)
-            m_textHeight = ch.glyphSize.y;
-    }
+std::string ivf::TextNode::font()
+{
+    return m_fontName;
 }
 
-float ivf::TextNode::textWidth()
+void ivf::TextNode::setSdf(bool flag)
 {
-    updateTextSize();
-    return m_textWidth;
+    m_sdf = flag && GlyphAtlas::sdfSupported();
+    m_dirty = true;
 }
 
-float ivf::TextNode::textHeight()
+bool ivf::TextNode::sdf()
 {
-    updateTextSize();
-    return m_textHeight;
+    return m_sdf;
 }
 
-void ivf::TextNode::updateCharMap()
+void ivf::TextNode::setPixelSize(int pixels)
 {
-    if (m_charMap.size() != 0)
-        for (auto &it : m_charMap)
-            glDeleteTextures(1, &it.second.textureID);
+    m_maxPixels = std::max(pixels, 1);
+    m_dirty = true;
+}
 
-    m_charMap.clear();
+int ivf::TextNode::pixelSize()
+{
+    return m_maxPixels;
+}
 
+void ivf::TextNode::updateTextSize()
+{
     m_textWidth = 0.0;
     m_textHeight = 0.0;
 
-    FT_Face face = FontManager::instance()->currentFace();
-
-    FT_Set_Pixel_Sizes(face, 0, m_maxPixels);
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    this->updateAtlas();
 
-    glActiveTexture(GL_TEXTURE0);
+    if (!m_atlas)
+        return;
 
-    for (unsigned char c = 0; c < 128; c++)
+    for (auto c : m_codepoints)
     {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-        {
-            logErrorfc("TextNode", "Failed to load Glyph {}", c);
+        auto glyph = m_atlas->glyph(c);
+
+        if (!glyph)
             continue;
-        }
 
-        unsigned int texture;
-
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED,
-                     GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-
-        /*
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-            );
-        */
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        // now store character for later use
-        CharacterInfo character = {texture, glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                                   glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                                   static_cast<unsigned int>(face->glyph->advance.x)};
-        m_charMap.insert(std::pair<char, CharacterInfo>(c, character));
-        glBindTexture(GL_TEXTURE_2D, 0);
+        m_textWidth += glyph->advance;
+        if (glyph->height > m_textHeight)
+            m_textHeight = glyph->height;
     }
 }
 
-void ivf::TextNode::prepareBuffers()
+float ivf::TextNode::textWidth()
 {
-    // configure VAO/VBO for texture quads
-    // -----------------------------------
-
-    float texCoords[6][2] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f},
-
-                             {0.0f, 0.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}};
+    updateTextSize();
+    return m_textWidth;
+}
 
-    float colors[6][4] = {{1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f},
+float ivf::TextNode::textHeight()
+{
+    updateTextSize();
+    return m_textHeight;
+}
 
-                          {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+void ivf::TextNode::updateAtlas()
+{
+    // Atlases are looked up on every rebuild, released atlases trigger a rebuild in doDraw()
 
-    float normals[6][3] = {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
+    auto fontManager = FontManager::instance();
+    m_atlasRevision = fontManager->atlasRevision();
 
-                           {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}};
+    if (m_fontName.empty())
+        m_atlas = fontManager->atlas(m_maxPixels, m_sdf);
+    else
+        m_atlas = fontManager->atlas(m_fontName, m_maxPixels, m_sdf);
+}
 
-    GLuint indices[6] = {0, 1, 2, 3, 4, 5};
+void ivf::TextNode::prepareBuffers()
+{
+    // configure VAO/VBOs for the glyph quads, storage is allocated in updateGeometry()
+    // -------------------------------------------------------------------------------
 
     glGenVertexArrays(1, &m_VAO);
 
@@ -201,51 +194,37 @@ void ivf::TextNode::prepareBuffers()
     glBindVertexArray(m_VAO);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * 6, indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 3, 0, GL_DYNAMIC_DRAW);
     glVertexAttribPointer(m_vertexAttrId, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
     glEnableVertexAttribArray(m_vertexAttrId);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_texVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 2, texCoords, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(m_texAttrId);
     glVertexAttribPointer(m_texAttrId, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(m_texAttrId);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_colorVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, colors, GL_STATIC_DRAW);
     glVertexAttribPointer(m_colorAttrId, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
     glEnableVertexAttribArray(m_colorAttrId);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_normalVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 3, normals, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(m_normalAttrId);
     glVertexAttribPointer(m_normalAttrId, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
+    glEnableVertexAttribArray(m_normalAttrId);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void ivf::TextNode::doDraw()
+void ivf::TextNode::updateGeometry()
 {
+    this->updateTextSize();
 
-    ShaderManager::instance()->currentProgram()->uniformBool(m_textRenderingId, m_textRendering);
-    ShaderManager::instance()->currentProgram()->uniformBool(m_useFixedTextColorId, m_useFixedTextColor);
-    ShaderManager::instance()->currentProgram()->uniformVec3(m_textColorId, m_textColor);
-    ShaderManager::instance()->currentProgram()->uniformBool(m_useTextureId, true);
+    m_dirty = false;
+    m_indexCount = 0;
 
-    GL_ERR(glActiveTexture(GL_TEXTURE0));
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (!m_atlas)
+        return;
 
-    // iterate through all characters
-    std::string::const_iterator c;
     float x = 0.0f;
     float scale = m_scale / (float)m_maxPixels;
     float dy = 0.0;
@@ -268,48 +247,132 @@ void ivf::TextNode::doDraw()
     if (m_textAlignY == TextAlignY::TOP)
         dy = m_textHeight * scale;
 
-    for (c = m_text.begin(); c != m_text.end(); c++)
+    std::vector<float> vertices;
+    std::vector<float> texCoords;
+    std::vector<GLuint> indices;
+
+    vertices.reserve(m_codepoints.size() * 12);
+    texCoords.reserve(m_codepoints.size() * 8);
+    indices.reserve(m_codepoints.size() * 6);
+
+    // Glyph lookups may grow the atlas, so all glyphs are resolved before texture coordinates are computed
+
+    std::vector<const GlyphInfo *> glyphs;
+    glyphs.reserve(m_codepoints.size());
+
+    for (auto c : m_codepoints)
+        glyphs.push_back(m_atlas->glyph(c));
+
+    float atlasWidth = (float)m_atlas->width();
+    float atlasHeight = (float)m_atlas->height();
+
+    for (auto glyph : glyphs)
     {
-        CharacterInfo ch = m_charMap[*c];
+        if (!glyph)
+            continue;
+
+        if (glyph->size.x > 0 && glyph->size.y > 0)
+        {
+            float xpos = x + glyph->bearing.x * scale;
+            float ypos = -(glyph->size.y - glyph->bearing.y) * scale - dy;
 
-        float xpos = x + ch.glyphBearing.x * scale;
-        float ypos = -(ch.glyphSize.y - ch.glyphBearing.y) * scale - dy;
+            float w = glyph->size.x * scale;
+            float h = glyph->size.y * scale;
 
-        float w = ch.glyphSize.x * scale;
-        float h = ch.glyphSize.y * scale;
+            float u0 = glyph->atlasPos.x / atlasWidth;
+            float u1 = (glyph->atlasPos.x + glyph->size.x) / atlasWidth;
+            float v0 = glyph->atlasPos.y / atlasHeight; // First bitmap row is the top of the glyph
+            float v1 = (glyph->atlasPos.y + glyph->size.y) / atlasHeight;
 
-        float vertices[6][3] = {
-            {xpos, ypos + h, 0.0f}, {xpos, ypos, 0.0f},     {xpos + w, ypos, 0.0f},
+            GLuint base = static_cast<GLuint>(vertices.size() / 3);
 
-            {xpos, ypos + h, 0.0f}, {xpos + w, ypos, 0.0f}, {xpos + w, ypos + h, 0.0f},
-        };
+            vertices.insert(vertices.end(),
+                            {xpos, ypos + h, 0.0f, xpos, ypos, 0.0f, xpos + w, ypos, 0.0f, xpos + w, ypos + h, 0.0f});
+            texCoords.insert(texCoords.end(), {u0, v0, u0, v1, u1, v1, u1, v0});
+            indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
 
-        // render glyph texture over quad
+        x += glyph->advance * scale;
+    }
 
-        GL_ERR(glBindTexture(GL_TEXTURE_2D, ch.textureID));
+    m_atlasGeneration = m_atlas->generation();
+    m_indexCount = static_cast<GLsizei>(indices.size());
 
-        // update content of VBO memory
+    if (m_indexCount == 0)
+        return;
 
-        GL_ERR(glBindVertexArray(m_VAO));
+    size_t quads = indices.size() / 6;
 
-        GL_ERR(glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO));
-        GL_ERR(glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices,
-                            GL_DYNAMIC_DRAW)); // be sure to use glBufferSubData and not glBufferData
-        GL_ERR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    // Normals and colors are constant, they are only rewritten when the buffers grow
 
+    if (quads > m_capacity)
+    {
+        m_capacity = quads;
+
+        std::vector<float> normals(m_capacity * 4 * 3);
+        std::vector<float> colors(m_capacity * 4 * 4, 1.0f);
+
+        for (size_t i = 0; i < m_capacity * 4; i++)
+            normals[i * 3 + 2] = 1.0f;
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_capacity * 4 * 3, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, m_texVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_capacity * 4 * 2, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, m_normalVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * normals.size(), normals.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, m_colorVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * colors.size(), colors.data(), GL_STATIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexVBO);
-        GL_ERR(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0));
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * m_capacity * 6, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * vertices.size(), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, m_texVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * texCoords.size(), texCoords.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        x += (ch.glyphAdvance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th
-                                             // pixels by 64 to get amount of pixels))
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexVBO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(GLuint) * indices.size(), indices.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
 
-        GL_ERR(glBindTexture(GL_TEXTURE_2D, 0));
-        GL_ERR(glBindVertexArray(0));
-    }
+void ivf::TextNode::doDraw()
+{
+    // The atlas may have been released by the FontManager after a face was replaced or cleared
+
+    if (m_dirty || (m_atlasRevision != FontManager::instance()->atlasRevision()) ||
+        (m_atlas && m_atlas->generation() != m_atlasGeneration))
+        this->updateGeometry();
+
+    if (m_indexCount == 0)
+        return;
+
+    ShaderManager::instance()->currentProgram()->uniformBool(m_textRenderingId, m_textRendering);
+    ShaderManager::instance()->currentProgram()->uniformBool(m_useFixedTextColorId, m_useFixedTextColor);
+    ShaderManager::instance()->currentProgram()->uniformVec3(m_textColorId, m_textColor);
+    ShaderManager::instance()->currentProgram()->uniformBool(m_useTextureId, true);
+    ShaderManager::instance()->currentProgram()->uniformBool(m_textSdfId, m_atlas->sdf());
+
+    GL_ERR(glActiveTexture(GL_TEXTURE0));
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // All glyphs are drawn from the shared atlas in one call
+
+    m_atlas->bind();
+
+    GL_ERR(glBindVertexArray(m_VAO));
+    GL_ERR(glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0));
+    GL_ERR(glBindVertexArray(0));
+
+    GL_ERR(glBindTexture(GL_TEXTURE_2D, 0));
 
     ShaderManager::instance()->currentProgram()->uniformBool(m_textRenderingId, false);
     ShaderManager::instance()->currentProgram()->uniformBool(m_useTextureId, false);
+    ShaderManager::instance()->currentProgram()->uniformBool(m_textSdfId, false);
     glDisable(GL_BLEND);
 }
 
@@ -324,13 +387,12 @@ void ivf::TextNode::onPropertyChanged(const std::string &propertyName)
 {
     if (propertyName == "Text")
     {
-        this->updateCharMap();
-        this->updateTextSize();
-        this->prepareBuffers();
+        m_codepoints = GlyphAtlas::decodeUtf8(m_text);
+        m_dirty = true;
     }
     else if (propertyName == "Size")
     {
-        this->updateTextSize();
+        m_dirty = true;
     }
     TransformNode::onPropertyChanged(propertyName);
 }
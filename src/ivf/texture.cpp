@@ -1,6 +1,7 @@
 #include <ivf/texture.h>
 
 #include <ivf/shader_manager.h>
+#include <ivf/texture_cache.h>
 #include <ivf/utils.h>
 #include <ivf/logger.h>
 
@@ -39,6 +40,8 @@ std::shared_ptr<Texture> Texture::create()
 
 void Texture::bind()
 {
+    m_lastUsed = TextureCache::frame();
+
     GL_ERR_BEGIN;
     glActiveTexture(GL_TEXTURE0 + m_texUnit);
     glBindTexture(GL_TEXTURE_2D, m_id);
@@ -58,36 +61,36 @@ bool Texture::load(const std::string_view filename)
 {
     logInfofc("Texture", "Loading texture from file: {}", filename);
 
-    int width, height, nrChannels;
-    unsigned char *data = stbi_load(std::string(filename).c_str(), &width, &height, &nrChannels, 0);
+    auto image = TextureImage::load(filename);
 
-    if (data)
+    if (!image.valid())
     {
-        logInfofc("Texture", "Loaded texture: {} ({}x{}, {} channels)", filename, width, height, nrChannels);
-
-        GLenum fmt;
-        GLint  ifmt;
-        switch (nrChannels) {
-            case 1:  fmt = GL_RED;  ifmt = GL_RED;   break;
-            case 2:  fmt = GL_RG;   ifmt = GL_RG;    break;
-            case 3:  fmt = GL_RGB;  ifmt = GL_RGB;   break;
-            default: fmt = GL_RGBA; ifmt = GL_RGBA;  break;
-        }
-
-        this->bind();
-        GL_ERR_BEGIN;
-        glTexImage2D(GL_TEXTURE_2D, m_level, ifmt, width, height, 0, fmt, m_type, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        GL_ERR_END("Texture::load()");
-        this->unbind();
+        logErrorfc("Texture", "Failed to load texture from file: {} ({})", filename, image.error);
+        return false;
+    }
+
+    if (image.faces != 1)
+    {
+        logErrorfc("Texture", "Failed to load texture from file: {} (cubemap, use Cubemap::load())", filename);
+        return false;
     }
-    else
+
+    this->bind();
+    GL_ERR_BEGIN;
+    bool uploaded = image.upload(GL_TEXTURE_2D, m_level);
+    if (uploaded && image.canGenerateMipmaps())
+        glGenerateMipmap(GL_TEXTURE_2D);
+    GL_ERR_END("Texture::load()");
+    this->unbind();
+
+    if (!uploaded)
     {
-        logErrorfc("Texture", "Failed to load texture from file: {}", filename);
-        stbi_image_free(data);
+        logErrorfc("Texture", "Failed to load texture from file: {} (compressed format not supported)", filename);
         return false;
     }
-    stbi_image_free(data);
+
+    logInfofc("Texture", "Loaded texture: {} ({}x{}, {} channels, {} levels{})", filename, image.width, image.height,
+              image.channels, image.levels, image.compressed() ? ", compressed" : "");
 
     return true;
 }
@@ -114,25 +117,30 @@ void Texture::setAnisotropicFiltering(float level)
 
 bool Texture::loadHDR(std::string_view filename)
 {
-    stbi_set_flip_vertically_on_load(true);
-    int width, height, nrChannels;
-    float* data = stbi_loadf(std::string(filename).c_str(), &width, &height, &nrChannels, 0);
-    stbi_set_flip_vertically_on_load(false);
+    auto image = TextureImage::load(filename, TextureLoadOptions::hdrImage());
 
-    if (!data) {
-        logErrorfc("Texture", "Failed to load HDR: {}", filename);
+    if (!image.valid()) {
+        logErrorfc("Texture", "Failed to load HDR: {} ({})", filename, image.error);
         return false;
     }
 
+    // Stored in the members as well, bind() applies them
+    m_wrapS = m_wrapT = GL_CLAMP_TO_EDGE;
+    m_minFilter = m_magFilter = GL_LINEAR;
+
     glBindTexture(GL_TEXTURE_2D, m_id);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
+    bool uploaded = image.faces == 1 && image.upload(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    stbi_image_free(data);
-    logInfofc("Texture", "Loaded HDR texture: {} ({}x{})", filename, width, height);
+    if (!uploaded) {
+        logErrorfc("Texture", "Failed to load HDR: {} (unsupported format)", filename);
+        return false;
+    }
+
+    logInfofc("Texture", "Loaded HDR texture: {} ({}x{})", filename, image.width, image.height);
     return true;
 }
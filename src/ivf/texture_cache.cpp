@@ -0,0 +1,790 @@
+#include <ivf/texture_cache.h>
+
+#include <ivf/logger.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+
+namespace fs = std::filesystem;
+using namespace ivf;
+
+namespace {
+
+enum class EntryState {
+    Loading,  // queued, decoding or uploading
+    Resident, // uploaded
+    Evicted,  // showing the placeholder until used again
+    Failed    // decoding failed, showing the placeholder
+};
+
+std::string canonicalPath(std::string_view filename)
+{
+    std::error_code error;
+    auto path = fs::weakly_canonical(fs::path(filename), error);
+
+    if (error)
+        return fs::path(filename).lexically_normal().generic_string();
+
+    return path.generic_string();
+}
+
+std::string optionsKey(const TextureLoadOptions &options)
+{
+    std::string key;
+    key += options.hdr ? 'h' : '-';
+    key += options.flipY ? 'f' : '-';
+    key += options.mipmaps ? 'm' : '-';
+    return key;
+}
+
+// Images without stored levels are streamed in bands of rows, stored mipmap chains and compressed
+// images one level of one face at a time
+
+int uploadSteps(const TextureImage &image)
+{
+    return image.canGenerateMipmaps() ? image.height * image.faces : image.levels * image.faces;
+}
+
+} // namespace
+
+struct TextureCache::Entry {
+    std::string key;                  // cache key, canonical path(s) and options
+    std::array<std::string, 6> paths; // image file, or cubemap face files (only the first for containers)
+    bool cubemap{false};
+    TextureLoadOptions options;
+    TexturePtr texture;
+    CubemapPtr cubemapTexture;
+    EntryState state{EntryState::Loading};
+    size_t bytes{0};                  // accounted video memory when resident
+    std::uint64_t evictedFrame{0};
+    bool removed{false};              // dropped from the cache while loading
+};
+
+// Decode threads only touch the copies of paths and options and the image; the entry is only
+// accessed on the GL thread.
+
+struct TextureCache::Job {
+    std::shared_ptr<Entry> entry;
+    std::array<std::string, 6> paths;
+    bool cubemap{false};
+    TextureLoadOptions options;
+    TextureImage image;
+    GLuint staging{0}; // texture receiving the upload, replaces the placeholder when complete
+    int stepsUploaded{0}; // rows or level faces, see uploadSteps()
+};
+
+std::uint64_t TextureCache::m_frame = 0;
+TextureCache *TextureCache::m_instance = nullptr;
+
+TextureCache::TextureCache()
+{}
+
+TextureCache::~TextureCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_decodeQueue.clear();
+    }
+
+    m_condition.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+
+    for (auto &job : m_uploads)
+        if (job->staging)
+            glDeleteTextures(1, &job->staging);
+
+    if (m_pbo)
+        glDeleteBuffers(1, &m_pbo);
+}
+
+TextureCache *TextureCache::instance()
+{
+    if (!m_instance)
+        m_instance = new TextureCache();
+
+    return m_instance;
+}
+
+TextureCache *TextureCache::create()
+{
+    return instance();
+}
+
+void TextureCache::drop()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+GLuint &TextureCache::storage(Entry &entry)
+{
+    return entry.cubemap ? entry.cubemapTexture->m_id : entry.texture->m_id;
+}
+
+std::uint64_t TextureCache::lastUsed(const Entry &entry)
+{
+    return entry.cubemap ? entry.cubemapTexture->m_lastUsed : entry.texture->m_lastUsed;
+}
+
+bool TextureCache::referenced(const Entry &entry)
+{
+    return entry.cubemap ? entry.cubemapTexture.use_count() > 1 : entry.texture.use_count() > 1;
+}
+
+TexturePtr TextureCache::load(std::string_view filename, const TextureLoadOptions &options)
+{
+    auto path = canonicalPath(filename);
+    auto key = "2d:" + optionsKey(options) + ":" + path;
+
+    auto it = m_entries.find(key);
+
+    if (it != m_entries.end())
+        return it->second->texture;
+
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->paths[0] = path;
+    entry->options = options;
+    entry->texture = Texture::create();
+
+    if (!options.mipmaps)
+        entry->texture->setMinFilter(GL_LINEAR);
+
+    if (options.hdr)
+    {
+        entry->texture->setWrapS(GL_CLAMP_TO_EDGE);
+        entry->texture->setWrapT(GL_CLAMP_TO_EDGE);
+    }
+
+    this->addEntry(entry);
+
+    return entry->texture;
+}
+
+TexturePtr TextureCache::loadHDR(std::string_view filename)
+{
+    return this->load(filename, TextureLoadOptions::hdrImage());
+}
+
+CubemapPtr TextureCache::loadCubemap(const std::array<std::string, 6> &paths, const TextureLoadOptions &options)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->key = "cube:" + optionsKey(options);
+    entry->cubemap = true;
+    entry->options = options;
+
+    for (int f = 0; f < 6; f++)
+    {
+        entry->paths[f] = paths[f].empty() ? std::string() : canonicalPath(paths[f]);
+        entry->key += ":" + entry->paths[f];
+    }
+
+    auto it = m_entries.find(entry->key);
+
+    if (it != m_entries.end())
+        return it->second->cubemapTexture;
+
+    entry->cubemapTexture = Cubemap::create();
+
+    this->addEntry(entry);
+
+    return entry->cubemapTexture;
+}
+
+CubemapPtr TextureCache::loadCubemap(std::string_view filename, const TextureLoadOptions &options)
+{
+    auto path = canonicalPath(filename);
+    auto key = "cube:" + optionsKey(options) + ":" + path;
+
+    auto it = m_entries.find(key);
+
+    if (it != m_entries.end())
+        return it->second->cubemapTexture;
+
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->paths[0] = path;
+    entry->cubemap = true;
+    entry->options = options;
+    entry->cubemapTexture = Cubemap::create();
+
+    this->addEntry(entry);
+
+    return entry->cubemapTexture;
+}
+
+CubemapPtr TextureCache::loadCubemapFromDirectory(std::string_view dir, const TextureLoadOptions &options)
+{
+    auto container = Cubemap::findContainer(dir);
+
+    if (!container.empty())
+        return this->loadCubemap(container, options);
+
+    return this->loadCubemap({Cubemap::findFile(dir, "right"), Cubemap::findFile(dir, "left"),
+                              Cubemap::findFile(dir, "top"), Cubemap::findFile(dir, "bottom"),
+                              Cubemap::findFile(dir, "back"), Cubemap::findFile(dir, "front")},
+                             options);
+}
+
+void TextureCache::addEntry(const std::shared_ptr<Entry> &entry)
+{
+    this->setPlaceholder(*entry);
+    m_entries.emplace(entry->key, entry);
+    this->requestLoad(entry);
+}
+
+void TextureCache::setPlaceholder(Entry &entry)
+{
+    // A new texture object releases the storage of all mipmap levels of an evicted texture
+
+    GLuint &id = storage(entry);
+
+    if (id)
+        glDeleteTextures(1, &id);
+
+    glGenTextures(1, &id);
+
+    GLenum target = entry.cubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    glBindTexture(target, id);
+
+    for (int f = 0; f < (entry.cubemap ? 6 : 1); f++)
+        glTexImage2D(entry.cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, m_placeholderColor.data());
+
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target, 0);
+}
+
+void TextureCache::startWorkers()
+{
+    // Decoding takes milliseconds per image. It runs on threads of its own instead of the ThreadPool,
+    // where it would delay the per-frame parallelFor() work queued behind it.
+
+    unsigned int count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+
+    for (unsigned int i = 0; i < count; i++)
+        m_workers.emplace_back(&TextureCache::workerLoop, this);
+}
+
+void TextureCache::workerLoop()
+{
+    for (;;)
+    {
+        std::shared_ptr<Job> job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_decodeQueue.empty(); });
+
+            if (m_stopping)
+                return;
+
+            job = std::move(m_decodeQueue.front());
+            m_decodeQueue.pop_front();
+        }
+
+        if (job->cubemap && !job->paths[1].empty())
+            job->image = TextureImage::loadCubemap(job->paths, job->options);
+        else
+            job->image = TextureImage::load(job->paths[0], job->options);
+
+        // The job is moved so that the last reference to its entry (and texture) is never released here
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decoded.push_back(std::move(job));
+        }
+
+        m_decodedCondition.notify_all();
+    }
+}
+
+void TextureCache::requestLoad(const std::shared_ptr<Entry> &entry)
+{
+    if (m_workers.empty())
+        this->startWorkers();
+
+    auto job = std::make_shared<Job>();
+    job->entry = entry;
+    job->paths = entry->paths;
+    job->cubemap = entry->cubemap;
+    job->options = entry->options;
+
+    entry->state = EntryState::Loading;
+    m_inFlight++;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decodeQueue.push_back(std::move(job));
+    }
+
+    m_condition.notify_one();
+}
+
+void TextureCache::collectDecoded()
+{
+    std::deque<std::shared_ptr<Job>> decoded;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    for (auto &job : decoded)
+    {
+        auto &entry = *job->entry;
+
+        if (entry.removed)
+        {
+            m_inFlight--;
+            continue;
+        }
+
+        const auto &image = job->image;
+        std::string error = image.error;
+
+        if (image.valid() && (image.faces == 6) != entry.cubemap)
+            error = std::format("{} is {}a cubemap", entry.paths[0], entry.cubemap ? "not " : "");
+        else if (image.compressed() && !TextureImage::formatSupported(image.compressedFormat))
+            error = std::format("{} uses a compressed format not supported by the OpenGL driver", entry.paths[0]);
+
+        if (!image.valid() || !error.empty())
+        {
+            logErrorfc("TextureCache", "Failed to load texture: {}", error);
+            entry.state = EntryState::Failed;
+            m_inFlight--;
+            continue;
+        }
+
+        m_uploads.push_back(std::move(job));
+    }
+}
+
+size_t TextureCache::uploadRows(Job &job, size_t budget)
+{
+    const auto &image = job.image;
+    const bool cubemap = image.faces == 6;
+    const GLenum target = cubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+
+    if (!job.staging)
+    {
+        glGenTextures(1, &job.staging);
+        glBindTexture(target, job.staging);
+
+        for (int f = 0; f < image.faces; f++)
+            glTexImage2D(cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : GL_TEXTURE_2D, 0, image.internalFormat(),
+                         image.width, image.height, 0, image.format(), image.type(), nullptr);
+    }
+    else
+        glBindTexture(target, job.staging);
+
+    if (!m_pbo)
+        glGenBuffers(1, &m_pbo);
+
+    const size_t rowBytes = image.rowBytes();
+    const int totalRows = uploadSteps(image);
+    int rows = static_cast<int>(
+        std::min<size_t>(std::max<size_t>(budget / rowBytes, 1), static_cast<size_t>(totalRows - job.stepsUploaded)));
+
+    size_t uploaded = 0;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+
+    while (rows > 0)
+    {
+        // A band never crosses a cubemap face
+
+        int face = job.stepsUploaded / image.height;
+        int y = job.stepsUploaded % image.height;
+        int count = std::min(rows, image.height - y);
+        size_t bytes = count * rowBytes;
+
+        const unsigned char *src = image.pixels.data() + face * image.faceBytes() + y * rowBytes;
+        GLenum faceTarget = cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+
+        // Orphaning the buffer lets the driver hand out new memory instead of waiting for the
+        // previous band to be transferred
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+        if (dst)
+        {
+            std::memcpy(dst, src, bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(faceTarget, 0, 0, y, image.width, count, image.format(), image.type(), nullptr);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexSubImage2D(faceTarget, 0, 0, y, image.width, count, image.format(), image.type(), src);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+        }
+
+        job.stepsUploaded += count;
+        rows -= count;
+        uploaded += bytes;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(target, 0);
+
+    return uploaded;
+}
+
+size_t TextureCache::uploadLevels(Job &job, size_t budget)
+{
+    const auto &image = job.image;
+    const bool cubemap = image.faces == 6;
+    const GLenum target = cubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+
+    if (!job.staging)
+        glGenTextures(1, &job.staging);
+
+    glBindTexture(target, job.staging);
+
+    if (!m_pbo)
+        glGenBuffers(1, &m_pbo);
+
+    size_t uploaded = 0;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+
+    // Whole level faces are uploaded, at least one per call; levels are defined largest first
+
+    while (job.stepsUploaded < uploadSteps(image) && uploaded < budget)
+    {
+        int level = job.stepsUploaded / image.faces;
+        int face = job.stepsUploaded % image.faces;
+        size_t bytes = image.levelSize(level);
+
+        const unsigned char *src = image.pixels.data() + image.levelOffset(level, face);
+        GLenum faceTarget = cubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+        if (dst)
+        {
+            std::memcpy(dst, src, bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            src = nullptr;
+        }
+        else
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (image.compressed())
+            glCompressedTexImage2D(faceTarget, level, image.compressedFormat, image.levelWidth(level),
+                                   image.levelHeight(level), 0, static_cast<GLsizei>(bytes), src);
+        else
+            glTexImage2D(faceTarget, level, image.internalFormat(), image.levelWidth(level), image.levelHeight(level),
+                         0, image.format(), image.type(), src);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+
+        job.stepsUploaded++;
+        uploaded += bytes;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(target, 0);
+
+    return uploaded;
+}
+
+void TextureCache::completeUpload(Job &job)
+{
+    auto &entry = *job.entry;
+    const auto &image = job.image;
+
+    GLenum target = entry.cubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    glBindTexture(target, job.staging);
+
+    // Stored levels are used as they are, whatever the mipmaps option says
+
+    bool mipmapped = image.canGenerateMipmaps() ? entry.options.mipmaps : image.levels > 1;
+
+    if (image.canGenerateMipmaps() && entry.options.mipmaps)
+        glGenerateMipmap(target);
+    else if (!image.canGenerateMipmaps())
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, image.levels - 1);
+
+    // Sampling state is set on the texture object as well, for users binding id() directly
+
+    if (entry.cubemap)
+    {
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        auto &texture = *entry.texture;
+
+        // A texture with a single level is incomplete with a mipmap filter
+
+        if (!mipmapped && texture.m_minFilter != GL_NEAREST && texture.m_minFilter != GL_LINEAR)
+            texture.m_minFilter = GL_LINEAR;
+
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, texture.m_wrapS);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, texture.m_wrapT);
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, texture.m_minFilter);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, texture.m_magFilter);
+    }
+
+    glBindTexture(target, 0);
+
+    // Replace the placeholder
+
+    GLuint &id = storage(entry);
+    glDeleteTextures(1, &id);
+    id = job.staging;
+    job.staging = 0;
+
+    if (entry.cubemap)
+        entry.cubemapTexture->m_lastUsed = m_frame;
+    else
+    {
+        entry.texture->m_lastUsed = m_frame;
+
+        if (entry.texture->m_anisotropy > 0.0f)
+            entry.texture->setAnisotropicFiltering(entry.texture->m_anisotropy);
+    }
+
+    entry.bytes = image.gpuBytes(entry.options.mipmaps);
+    entry.state = EntryState::Resident;
+    m_memoryUsage += entry.bytes;
+
+    logInfofc("TextureCache", "Loaded texture: {} ({}x{}, {} channels, {} levels{}{})", entry.paths[0], image.width,
+              image.height, image.channels, image.levels, image.compressed() ? ", compressed" : "",
+              entry.cubemap ? ", cubemap" : "");
+
+    job.image = TextureImage();
+}
+
+void TextureCache::processUploads(size_t budget)
+{
+    m_uploadedBytes = 0;
+
+    while (!m_uploads.empty() && m_uploadedBytes < budget)
+    {
+        auto &job = *m_uploads.front();
+
+        if (!job.entry->removed)
+            m_uploadedBytes += job.image.canGenerateMipmaps() ? this->uploadRows(job, budget - m_uploadedBytes)
+                                                              : this->uploadLevels(job, budget - m_uploadedBytes);
+
+        if (job.entry->removed)
+        {
+            if (job.staging)
+                glDeleteTextures(1, &job.staging);
+        }
+        else if (job.stepsUploaded < uploadSteps(job.image))
+            continue;
+        else
+            this->completeUpload(job);
+
+        m_uploads.pop_front();
+        m_inFlight--;
+    }
+}
+
+void TextureCache::reloadUsed()
+{
+    if (m_evicted == 0)
+        return;
+
+    for (auto &[key, entry] : m_entries)
+    {
+        if (entry->state == EntryState::Evicted && lastUsed(*entry) >= entry->evictedFrame)
+        {
+            m_evicted--;
+            this->requestLoad(entry);
+        }
+    }
+}
+
+void TextureCache::evict()
+{
+    if (m_memoryBudget == 0 || m_memoryUsage <= m_memoryBudget)
+    {
+        m_overBudgetWarned = false;
+        return;
+    }
+
+    // Candidates are resident textures not used in the current or previous frame; textures nobody
+    // else references go first, then the least recently used ones
+
+    struct Candidate {
+        std::shared_ptr<Entry> entry;
+        bool referenced;
+        std::uint64_t lastUsed;
+    };
+
+    std::vector<Candidate> candidates;
+
+    for (auto &[key, entry] : m_entries)
+    {
+        if (entry->state != EntryState::Resident)
+            continue;
+
+        bool used = referenced(*entry);
+        std::uint64_t frame = lastUsed(*entry);
+
+        if (!used || frame + 1 < m_frame)
+            candidates.push_back({entry, used, frame});
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.referenced != b.referenced ? !a.referenced : a.lastUsed < b.lastUsed;
+    });
+
+    for (auto &candidate : candidates)
+    {
+        if (m_memoryUsage <= m_memoryBudget)
+            break;
+
+        auto &entry = *candidate.entry;
+
+        m_memoryUsage -= entry.bytes;
+        entry.bytes = 0;
+        m_evictionCount++;
+
+        if (!candidate.referenced)
+        {
+            entry.removed = true;
+            m_entries.erase(entry.key);
+        }
+        else
+        {
+            this->setPlaceholder(entry);
+            entry.state = EntryState::Evicted;
+            entry.evictedFrame = m_frame;
+            m_evicted++;
+        }
+    }
+
+    if (m_memoryUsage > m_memoryBudget && !m_overBudgetWarned)
+    {
+        logWarningfc("TextureCache", "Textures in use need {} MiB, more than the budget of {} MiB",
+                     m_memoryUsage >> 20, m_memoryBudget >> 20);
+        m_overBudgetWarned = true;
+    }
+}
+
+void TextureCache::update()
+{
+    m_frame++;
+
+    this->collectDecoded();
+    this->reloadUsed();
+    this->processUploads(m_uploadBudget);
+    this->evict();
+}
+
+void TextureCache::finish()
+{
+    for (;;)
+    {
+        this->collectDecoded();
+        this->processUploads(SIZE_MAX);
+
+        // All remaining jobs are queued or being decoded
+
+        if (m_inFlight == 0)
+            break;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_decodedCondition.wait(lock, [this] { return !m_decoded.empty(); });
+    }
+
+    this->evict();
+}
+
+void TextureCache::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inFlight -= m_decodeQueue.size();
+        m_decodeQueue.clear();
+    }
+
+    for (auto &job : m_uploads)
+        if (job->staging)
+            glDeleteTextures(1, &job->staging);
+
+    m_inFlight -= m_uploads.size();
+    m_uploads.clear();
+
+    // Jobs still being decoded are discarded by collectDecoded()
+
+    for (auto &[key, entry] : m_entries)
+        entry->removed = true;
+
+    m_entries.clear();
+    m_memoryUsage = 0;
+    m_evicted = 0;
+}
+
+void TextureCache::setUploadBudget(size_t bytes)
+{
+    m_uploadBudget = bytes;
+}
+
+size_t TextureCache::uploadBudget() const
+{
+    return m_uploadBudget;
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+size_t TextureCache::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void TextureCache::setPlaceholderColor(const glm::vec4 &color)
+{
+    for (int i = 0; i < 4; i++)
+        m_placeholderColor[i] = static_cast<unsigned char>(std::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+size_t TextureCache::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+size_t TextureCache::uploadedBytes() const
+{
+    return m_uploadedBytes;
+}
+
+size_t TextureCache::entryCount() const
+{
+    return m_entries.size();
+}
+
+size_t TextureCache::pendingCount() const
+{
+    return m_inFlight;
+}
+
+size_t TextureCache::evictionCount() const
+{
+    return m_evictionCount;
+}
@@ -0,0 +1,605 @@
+#include <ivf/texture_encoder.h>
+
+#include <ivf/thread_pool.h>
+
+#include "texture_formats.h"
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <string>
+
+using namespace ivf;
+
+namespace tf = ivf::texture_formats;
+
+namespace {
+
+// Pixels of all faces of one mipmap level
+
+struct Level {
+    int width{0};
+    int height{0};
+    std::vector<glm::vec4> pixels;
+};
+
+float srgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float c)
+{
+    c = std::clamp(c, 0.0f, 1.0f);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// Missing channels read as in OpenGL: 0 for green and blue, 1 for alpha
+
+Level toFloat(const TextureImage &image)
+{
+    Level level;
+    level.width = image.width;
+    level.height = image.height;
+
+    const size_t count = size_t(image.width) * image.height * image.faces;
+    level.pixels.assign(count, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int c = 0; c < image.channels; c++)
+        {
+            size_t index = i * image.channels + c;
+
+            switch (image.componentType)
+            {
+            case GL_FLOAT: {
+                float value;
+                std::memcpy(&value, image.pixels.data() + index * sizeof(float), sizeof(float));
+                level.pixels[i][c] = value;
+                break;
+            }
+            case GL_HALF_FLOAT: {
+                std::uint16_t value;
+                std::memcpy(&value, image.pixels.data() + index * sizeof(value), sizeof(value));
+                level.pixels[i][c] = glm::unpackHalf1x16(value);
+                break;
+            }
+            default:
+                level.pixels[i][c] = image.pixels[index] / 255.0f;
+            }
+        }
+    }
+
+    return level;
+}
+
+Level downsample(const Level &src, int faces, bool normalMap)
+{
+    Level dst;
+    dst.width = std::max(src.width / 2, 1);
+    dst.height = std::max(src.height / 2, 1);
+    dst.pixels.resize(size_t(dst.width) * dst.height * faces);
+
+    const size_t srcFace = size_t(src.width) * src.height;
+    const size_t dstFace = size_t(dst.width) * dst.height;
+
+    ThreadPool::instance()->parallelFor(
+        0, size_t(dst.height) * faces,
+        [&](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; row++)
+            {
+                int face = static_cast<int>(row / dst.height);
+                int y = static_cast<int>(row % dst.height);
+                int y0 = std::min(2 * y, src.height - 1);
+                int y1 = std::min(2 * y + 1, src.height - 1);
+
+                const glm::vec4 *s = src.pixels.data() + face * srcFace;
+                glm::vec4 *d = dst.pixels.data() + face * dstFace + size_t(y) * dst.width;
+
+                for (int x = 0; x < dst.width; x++)
+                {
+                    int x0 = std::min(2 * x, src.width - 1);
+                    int x1 = std::min(2 * x + 1, src.width - 1);
+
+                    glm::vec4 sum = s[y0 * src.width + x0] + s[y0 * src.width + x1] + s[y1 * src.width + x0] +
+                                    s[y1 * src.width + x1];
+                    glm::vec4 value = sum * 0.25f;
+
+                    if (normalMap)
+                    {
+                        glm::vec3 n = glm::vec3(value) * 2.0f - 1.0f;
+                        float length = glm::length(n);
+
+                        if (length > 1e-6f)
+                            value = glm::vec4(n / length * 0.5f + 0.5f, value.a);
+                    }
+
+                    d[x] = value;
+                }
+            }
+        },
+        16);
+
+    return dst;
+}
+
+// Mipmap chain with the values in the encoding of the input; sRGB colors are filtered in linear space
+
+std::vector<Level> mipChain(const TextureImage &image, bool srgb, bool normalMap, bool mipmaps)
+{
+    std::vector<Level> levels;
+    levels.push_back(toFloat(image));
+
+    if (srgb)
+        for (auto &p : levels[0].pixels)
+            p = glm::vec4(srgbToLinear(p.r), srgbToLinear(p.g), srgbToLinear(p.b), p.a);
+
+    while (mipmaps && (levels.back().width > 1 || levels.back().height > 1))
+        levels.push_back(downsample(levels.back(), image.faces, normalMap));
+
+    if (srgb)
+        for (auto &level : levels)
+            for (auto &p : level.pixels)
+                p = glm::vec4(linearToSrgb(p.r), linearToSrgb(p.g), linearToSrgb(p.b), p.a);
+
+    return levels;
+}
+
+unsigned char toByte(float value)
+{
+    return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// BC7 mode 6: one subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices
+
+constexpr std::array<int, 16> bc7Weights{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Bc7Endpoints {
+    std::array<int, 4> e0{};
+    std::array<int, 4> e1{};
+    int p0{0};
+    int p1{0};
+};
+
+// Quantizes an endpoint to 7 bits per channel plus the p-bit giving the smaller error
+
+void quantizeEndpoint(const glm::vec4 &value, std::array<int, 4> &q, int &p)
+{
+    float best = FLT_MAX;
+
+    for (int pbit = 0; pbit < 2; pbit++)
+    {
+        std::array<int, 4> candidate;
+        float error = 0.0f;
+
+        for (int c = 0; c < 4; c++)
+        {
+            candidate[c] = std::clamp(static_cast<int>(std::lround((value[c] - pbit) * 0.5f)), 0, 127);
+            float d = float(candidate[c] * 2 + pbit) - value[c];
+            error += d * d;
+        }
+
+        if (error < best)
+        {
+            best = error;
+            q = candidate;
+            p = pbit;
+        }
+    }
+}
+
+float assignIndices(const std::array<glm::vec4, 16> &pixels, const Bc7Endpoints &ep, std::array<int, 16> &indices)
+{
+    std::array<glm::vec4, 16> palette;
+
+    for (int i = 0; i < 16; i++)
+    {
+        int w = bc7Weights[i];
+
+        for (int c = 0; c < 4; c++)
+        {
+            int a = ep.e0[c] * 2 + ep.p0;
+            int b = ep.e1[c] * 2 + ep.p1;
+            palette[i][c] = float(((64 - w) * a + w * b + 32) >> 6);
+        }
+    }
+
+    float total = 0.0f;
+
+    for (int i = 0; i < 16; i++)
+    {
+        float best = FLT_MAX;
+
+        for (int j = 0; j < 16; j++)
+        {
+            glm::vec4 d = pixels[i] - palette[j];
+            float error = glm::dot(d, d);
+
+            if (error < best)
+            {
+                best = error;
+                indices[i] = j;
+            }
+        }
+
+        total += best;
+    }
+
+    return total;
+}
+
+void encodeBc7Block(unsigned char *dest, const std::array<glm::vec4, 16> &pixels)
+{
+    // Endpoints on the principal axis of the block colors
+
+    glm::vec4 mean(0.0f);
+
+    for (auto &p : pixels)
+        mean += p;
+
+    mean /= 16.0f;
+
+    glm::mat4 covariance(0.0f);
+    glm::vec4 lo(FLT_MAX), hi(-FLT_MAX);
+
+    for (auto &p : pixels)
+    {
+        glm::vec4 d = p - mean;
+        covariance += glm::outerProduct(d, d);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+
+    glm::vec4 axis = hi - lo;
+
+    for (int i = 0; i < 8 && glm::dot(axis, axis) > 1e-6f; i++)
+        axis = glm::normalize(covariance * axis);
+
+    float tmin = 0.0f, tmax = 0.0f;
+
+    if (glm::dot(axis, axis) > 1e-6f)
+    {
+        tmin = FLT_MAX;
+        tmax = -FLT_MAX;
+
+        for (auto &p : pixels)
+        {
+            float t = glm::dot(p - mean, axis);
+            tmin = std::min(tmin, t);
+            tmax = std::max(tmax, t);
+        }
+    }
+
+    Bc7Endpoints best;
+    quantizeEndpoint(glm::clamp(mean + axis * tmin, 0.0f, 255.0f), best.e0, best.p0);
+    quantizeEndpoint(glm::clamp(mean + axis * tmax, 0.0f, 255.0f), best.e1, best.p1);
+
+    std::array<int, 16> indices;
+    float bestError = assignIndices(pixels, best, indices);
+
+    // Least squares refinement of the endpoints for the chosen indices
+
+    for (int iteration = 0; iteration < 2 && bestError > 0.0f; iteration++)
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        glm::vec4 r0(0.0f), r1(0.0f);
+
+        for (int i = 0; i < 16; i++)
+        {
+            float w = bc7Weights[indices[i]] / 64.0f;
+            a += (1.0f - w) * (1.0f - w);
+            b += (1.0f - w) * w;
+            c += w * w;
+            r0 += (1.0f - w) * pixels[i];
+            r1 += w * pixels[i];
+        }
+
+        float det = a * c - b * b;
+
+        if (std::abs(det) < 1e-6f)
+            break;
+
+        Bc7Endpoints candidate;
+        quantizeEndpoint(glm::clamp((c * r0 - b * r1) / det, 0.0f, 255.0f), candidate.e0, candidate.p0);
+        quantizeEndpoint(glm::clamp((a * r1 - b * r0) / det, 0.0f, 255.0f), candidate.e1, candidate.p1);
+
+        std::array<int, 16> candidateIndices;
+        float error = assignIndices(pixels, candidate, candidateIndices);
+
+        if (error >= bestError)
+            break;
+
+        best = candidate;
+        indices = candidateIndices;
+        bestError = error;
+    }
+
+    // The most significant index bit of the first pixel is implicitly 0
+
+    if (indices[0] & 8)
+    {
+        std::swap(best.e0, best.e1);
+        std::swap(best.p0, best.p1);
+
+        for (auto &index : indices)
+            index = 15 - index;
+    }
+
+    std::memset(dest, 0, 16);
+    int position = 0;
+
+    auto write = [&](int value, int bits) {
+        for (int i = 0; i < bits; i++, position++)
+            if (value & (1 << i))
+                dest[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+    };
+
+    write(1 << 6, 7);
+
+    for (int c = 0; c < 4; c++)
+    {
+        write(best.e0[c], 7);
+        write(best.e1[c], 7);
+    }
+
+    write(best.p0, 1);
+    write(best.p1, 1);
+
+    for (int i = 0; i < 16; i++)
+        write(indices[i], i == 0 ? 3 : 4);
+}
+
+const tf::FormatInfo *outputFormat(TextureEncoder::Format format, bool srgb)
+{
+    using TextureEncoder::Format;
+
+    switch (format)
+    {
+    case Format::BC1:
+        return tf::findCompressed(srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+    case Format::BC3:
+        return tf::findCompressed(srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+    case Format::BC4:
+        return tf::findCompressed(GL_COMPRESSED_RED_RGTC1);
+    case Format::BC5:
+        return tf::findCompressed(GL_COMPRESSED_RG_RGTC2);
+    case Format::BC7:
+        return tf::findCompressed(srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM);
+    case Format::RGBA8:
+        return tf::findUncompressed(GL_UNSIGNED_BYTE, 4);
+    case Format::RGBA16F:
+        return tf::findUncompressed(GL_HALF_FLOAT, 4);
+    default:
+        return nullptr;
+    }
+}
+
+void encodeBlocks(TextureEncoder::Format format, const glm::vec4 *src, int width, int height, unsigned char *dest,
+                  size_t blockBytes)
+{
+    using TextureEncoder::Format;
+
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+
+    ThreadPool::instance()->parallelFor(
+        0, blocksY,
+        [&](size_t begin, size_t end) {
+            std::array<glm::vec4, 16> block;
+            std::array<unsigned char, 64> bytes;
+
+            for (size_t by = begin; by < end; by++)
+            {
+                for (int bx = 0; bx < blocksX; bx++)
+                {
+                    // Edge pixels are repeated to fill partial blocks
+
+                    for (int i = 0; i < 16; i++)
+                    {
+                        int x = std::min(bx * 4 + i % 4, width - 1);
+                        int y = std::min(static_cast<int>(by) * 4 + i / 4, height - 1);
+                        block[i] = src[size_t(y) * width + x];
+                    }
+
+                    unsigned char *out = dest + (by * blocksX + bx) * blockBytes;
+
+                    switch (format)
+                    {
+                    case Format::BC4:
+                        for (int i = 0; i < 16; i++)
+                            bytes[i] = toByte(block[i].r);
+                        stb_compress_bc4_block(out, bytes.data());
+                        break;
+                    case Format::BC5:
+                        for (int i = 0; i < 16; i++)
+                        {
+                            bytes[2 * i] = toByte(block[i].r);
+                            bytes[2 * i + 1] = toByte(block[i].g);
+                        }
+                        stb_compress_bc5_block(out, bytes.data());
+                        break;
+                    case Format::BC7:
+                        for (auto &p : block)
+                            p = glm::vec4(toByte(p.r), toByte(p.g), toByte(p.b), toByte(p.a));
+                        encodeBc7Block(out, block);
+                        break;
+                    default:
+                        for (int i = 0; i < 16; i++)
+                            for (int c = 0; c < 4; c++)
+                                bytes[4 * i + c] = toByte(block[i][c]);
+                        stb_compress_dxt_block(out, bytes.data(), format == Format::BC3, STB_DXT_HIGHQUAL);
+                    }
+                }
+            }
+        },
+        4);
+}
+
+} // namespace
+
+TextureEncoder::Format TextureEncoder::chooseFormat(const TextureImage &image, const Options &options)
+{
+    if (options.format != Format::Auto)
+        return options.format;
+
+    if (image.hdr())
+        return Format::RGBA16F;
+
+    if (image.channels == 1)
+        return Format::BC4;
+
+    if (image.channels == 2)
+        return Format::BC5;
+
+    if (image.channels == 4 && !image.compressed())
+        for (size_t i = 3; i < image.pixels.size(); i += 4)
+            if (image.pixels[i] < 255)
+                return Format::BC3;
+
+    return Format::BC1;
+}
+
+const char *TextureEncoder::formatName(Format format)
+{
+    switch (format)
+    {
+    case Format::BC1:
+        return "bc1";
+    case Format::BC3:
+        return "bc3";
+    case Format::BC4:
+        return "bc4";
+    case Format::BC5:
+        return "bc5";
+    case Format::BC7:
+        return "bc7";
+    case Format::RGBA8:
+        return "rgba8";
+    case Format::RGBA16F:
+        return "rgba16f";
+    default:
+        return "auto";
+    }
+}
+
+bool TextureEncoder::parseFormat(std::string_view name, Format &format)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    for (auto candidate : {Format::Auto, Format::BC1, Format::BC3, Format::BC4, Format::BC5, Format::BC7,
+                           Format::RGBA8, Format::RGBA16F})
+    {
+        if (lower == formatName(candidate))
+        {
+            format = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TextureImage TextureEncoder::generateMipmaps(const TextureImage &image, bool srgb, bool normalMap)
+{
+    TextureImage result;
+
+    if (!image.valid() || image.compressed() || image.levels != 1)
+    {
+        result.error = "mipmaps can only be generated for uncompressed images with a single level";
+        return result;
+    }
+
+    auto levels = mipChain(image, srgb, normalMap, true);
+
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = 4;
+    result.faces = image.faces;
+    result.levels = static_cast<int>(levels.size());
+    result.componentType = GL_FLOAT;
+    result.pixels.resize(result.levelOffset(result.levels));
+
+    for (int l = 0; l < result.levels; l++)
+        std::memcpy(result.pixels.data() + result.levelOffset(l), levels[l].pixels.data(),
+                    levels[l].pixels.size() * sizeof(glm::vec4));
+
+    return result;
+}
+
+TextureImage TextureEncoder::encode(const TextureImage &image, const Options &options)
+{
+    TextureImage result;
+
+    if (!image.valid() || image.compressed() || image.levels != 1)
+    {
+        result.error = "only uncompressed images with a single level can be encoded";
+        return result;
+    }
+
+    const Format format = chooseFormat(image, options);
+    const bool srgb = options.srgb && (format == Format::BC1 || format == Format::BC3 || format == Format::BC7);
+    const auto info = outputFormat(format, srgb);
+
+    if (!info)
+    {
+        result.error = std::format("cannot encode to {}", formatName(format));
+        return result;
+    }
+
+    auto levels = mipChain(image, options.srgb, options.normalMap, options.mipmaps);
+
+    result.width = image.width;
+    result.height = image.height;
+    result.channels = info->channels;
+    result.faces = image.faces;
+    result.levels = static_cast<int>(levels.size());
+    result.componentType = info->compressed ? GL_UNSIGNED_BYTE : info->componentType;
+    result.compressedFormat = info->compressed;
+    result.pixels.resize(result.levelOffset(result.levels));
+
+    for (int l = 0; l < result.levels; l++)
+    {
+        const auto &level = levels[l];
+        const size_t facePixels = size_t(level.width) * level.height;
+
+        for (int f = 0; f < result.faces; f++)
+        {
+            const glm::vec4 *src = level.pixels.data() + f * facePixels;
+            unsigned char *dest = result.pixels.data() + result.levelOffset(l, f);
+
+            if (result.compressed())
+                encodeBlocks(format, src, level.width, level.height, dest, info->bytes);
+            else if (format == Format::RGBA16F)
+            {
+                for (size_t i = 0; i < facePixels; i++)
+                {
+                    for (int c = 0; c < 4; c++)
+                    {
+                        std::uint16_t half = glm::packHalf1x16(src[i][c]);
+                        std::memcpy(dest + (i * 4 + c) * sizeof(half), &half, sizeof(half));
+                    }
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < facePixels; i++)
+                    for (int c = 0; c < 4; c++)
+                        dest[i * 4 + c] = toByte(src[i][c]);
+            }
+        }
+    }
+
+    return result;
+}
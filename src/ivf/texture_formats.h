@@ -0,0 +1,114 @@
+#pragma once
+
+// Private header: pixel formats of KTX2/DDS containers, shared by TextureImage and TextureEncoder.
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+
+// S3TC (EXT_texture_compression_s3tc / EXT_texture_sRGB) is an extension, BPTC core since 4.2
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+namespace ivf::texture_formats {
+
+// Data format descriptor color models (Khronos Data Format Specification)
+
+constexpr std::uint8_t dfdModelRGBSDA = 1;
+constexpr std::uint8_t dfdModelBC1A = 128;
+constexpr std::uint8_t dfdModelBC3 = 130;
+constexpr std::uint8_t dfdModelBC4 = 131;
+constexpr std::uint8_t dfdModelBC5 = 132;
+constexpr std::uint8_t dfdModelBC7 = 134;
+
+struct FormatInfo {
+    std::uint32_t vkFormat;   // KTX2 vkFormat
+    std::uint32_t dxgiFormat; // DDS DX10 format, 0 if none
+    GLenum compressed;        // compressed internal format, 0 for uncompressed RGBA
+    GLenum componentType;     // component type of uncompressed formats
+    int channels;             // components
+    int bytes;                // bytes per 4x4 block or per pixel
+    bool srgb;                // sRGB transfer function
+    std::uint8_t dfdModel;    // data format descriptor color model
+};
+
+// clang-format off
+inline constexpr std::array<FormatInfo, 17> formats{{
+    {131,  0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,        0, 3,  8, false, dfdModelBC1A},
+    {132,  0, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,       0, 3,  8, true,  dfdModelBC1A},
+    {133, 71, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,       0, 4,  8, false, dfdModelBC1A},
+    {134, 72, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 0, 4,  8, true,  dfdModelBC1A},
+    {137, 77, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,       0, 4, 16, false, dfdModelBC3},
+    {138, 78, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 0, 4, 16, true,  dfdModelBC3},
+    {139, 80, GL_COMPRESSED_RED_RGTC1,                0, 1,  8, false, dfdModelBC4},
+    {140, 81, GL_COMPRESSED_SIGNED_RED_RGTC1,         0, 1,  8, false, dfdModelBC4},
+    {141, 83, GL_COMPRESSED_RG_RGTC2,                 0, 2, 16, false, dfdModelBC5},
+    {142, 84, GL_COMPRESSED_SIGNED_RG_RGTC2,          0, 2, 16, false, dfdModelBC5},
+    {145, 98, GL_COMPRESSED_RGBA_BPTC_UNORM,          0, 4, 16, false, dfdModelBC7},
+    {146, 99, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,    0, 4, 16, true,  dfdModelBC7},
+    { 37, 28, 0, GL_UNSIGNED_BYTE,                       4,  4, false, dfdModelRGBSDA},
+    { 97, 10, 0, GL_HALF_FLOAT,                          4,  8, false, dfdModelRGBSDA},
+    {109,  2, 0, GL_FLOAT,                               4, 16, false, dfdModelRGBSDA},
+    // Typeless BC1/BC3 DX10 formats, read as UNORM
+    {  0, 70, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,       0, 4,  8, false, dfdModelBC1A},
+    {  0, 76, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,       0, 4, 16, false, dfdModelBC3},
+}};
+// clang-format on
+
+inline const FormatInfo *findVkFormat(std::uint32_t vkFormat)
+{
+    for (auto &format : formats)
+        if (format.vkFormat == vkFormat && vkFormat != 0)
+            return &format;
+    return nullptr;
+}
+
+inline const FormatInfo *findDxgiFormat(std::uint32_t dxgiFormat)
+{
+    for (auto &format : formats)
+        if (format.dxgiFormat == dxgiFormat && dxgiFormat != 0)
+            return &format;
+    return nullptr;
+}
+
+inline const FormatInfo *findCompressed(GLenum compressed)
+{
+    for (auto &format : formats)
+        if (format.compressed == compressed && compressed != 0)
+            return &format;
+    return nullptr;
+}
+
+inline const FormatInfo *findUncompressed(GLenum componentType, int channels)
+{
+    for (auto &format : formats)
+        if (format.compressed == 0 && format.componentType == componentType && format.channels == channels)
+            return &format;
+    return nullptr;
+}
+
+} // namespace ivf::texture_formats
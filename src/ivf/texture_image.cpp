@@ -0,0 +1,827 @@
+#include <ivf/texture_image.h>
+
+#include <ivf/logger.h>
+
+#include "texture_formats.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+using namespace ivf;
+
+namespace tf = ivf::texture_formats;
+
+namespace {
+
+constexpr std::array<unsigned char, 12> ktx2Identifier{0xAB, 'K',  'T',  'X',  ' ',  '2',
+                                                       '0',  0xBB, '\r', '\n', 0x1A, '\n'};
+
+// DDS header flags
+
+constexpr std::uint32_t ddsdMipmapCount = 0x20000;
+constexpr std::uint32_t ddpfFourCC = 0x4;
+constexpr std::uint32_t ddpfRGB = 0x40;
+constexpr std::uint32_t ddsCaps2Cubemap = 0x200;
+constexpr std::uint32_t ddsCaps2AllFaces = 0xFC00;
+constexpr std::uint32_t ddsMiscTextureCube = 0x4;
+
+constexpr std::uint32_t fourCC(char a, char b, char c, char d)
+{
+    return std::uint32_t(std::uint8_t(a)) | std::uint32_t(std::uint8_t(b)) << 8 | std::uint32_t(std::uint8_t(c)) << 16 |
+           std::uint32_t(std::uint8_t(d)) << 24;
+}
+
+std::uint32_t readU32(const std::vector<unsigned char> &data, size_t offset)
+{
+    return std::uint32_t(data[offset]) | std::uint32_t(data[offset + 1]) << 8 | std::uint32_t(data[offset + 2]) << 16 |
+           std::uint32_t(data[offset + 3]) << 24;
+}
+
+std::uint64_t readU64(const std::vector<unsigned char> &data, size_t offset)
+{
+    return std::uint64_t(readU32(data, offset)) | std::uint64_t(readU32(data, offset + 4)) << 32;
+}
+
+void writeU32(std::vector<unsigned char> &data, size_t offset, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        data[offset + i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+void writeU64(std::vector<unsigned char> &data, size_t offset, std::uint64_t value)
+{
+    writeU32(data, offset, static_cast<std::uint32_t>(value));
+    writeU32(data, offset + 4, static_cast<std::uint32_t>(value >> 32));
+}
+
+bool readFile(std::string_view filename, std::vector<unsigned char> &data)
+{
+    std::ifstream file{std::string(filename), std::ios::binary};
+
+    if (!file)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !data.empty();
+}
+
+void setFormat(TextureImage &image, const tf::FormatInfo &format)
+{
+    image.channels = format.channels;
+    image.compressedFormat = format.compressed;
+    image.componentType = format.compressed ? GL_UNSIGNED_BYTE : format.componentType;
+}
+
+// Checks the size of an image read from a container and allocates its pixels
+
+bool allocate(TextureImage &image)
+{
+    if (image.width <= 0 || image.height <= 0 || image.width > 65536 || image.height > 65536)
+    {
+        image.error = std::format("invalid size {}x{}", image.width, image.height);
+        return false;
+    }
+
+    int maxLevels = 1;
+    while ((std::max(image.width, image.height) >> maxLevels) > 0)
+        maxLevels++;
+
+    if (image.levels < 1 || image.levels > maxLevels)
+    {
+        image.error = std::format("invalid level count {}", image.levels);
+        return false;
+    }
+
+    image.pixels.resize(image.levelOffset(image.levels));
+    return true;
+}
+
+bool parseKtx2(const std::vector<unsigned char> &data, TextureImage &image)
+{
+    if (data.size() < 80)
+    {
+        image.error = "truncated KTX2 header";
+        return false;
+    }
+
+    std::uint32_t vkFormat = readU32(data, 12);
+    std::uint32_t depth = readU32(data, 28);
+    std::uint32_t layers = readU32(data, 32);
+    std::uint32_t faceCount = readU32(data, 36);
+    std::uint32_t levelCount = readU32(data, 40);
+    std::uint32_t supercompression = readU32(data, 44);
+
+    if (supercompression != 0)
+    {
+        image.error = "supercompressed KTX2 files are not supported";
+        return false;
+    }
+
+    if (depth > 1 || layers > 1 || (faceCount != 1 && faceCount != 6))
+    {
+        image.error = "only 2D textures and cubemaps are supported";
+        return false;
+    }
+
+    auto format = tf::findVkFormat(vkFormat);
+
+    if (!format)
+    {
+        image.error = std::format("unsupported vkFormat {}", vkFormat);
+        return false;
+    }
+
+    setFormat(image, *format);
+    image.width = static_cast<int>(readU32(data, 20));
+    image.height = static_cast<int>(readU32(data, 24));
+    image.faces = static_cast<int>(faceCount);
+    image.levels = static_cast<int>(std::max(levelCount, 1u));
+
+    if (data.size() < 80 + 24 * size_t(image.levels))
+    {
+        image.error = "truncated KTX2 level index";
+        return false;
+    }
+
+    if (!allocate(image))
+        return false;
+
+    // Faces of a level are stored consecutively, as in TextureImage
+
+    for (int level = 0; level < image.levels; level++)
+    {
+        std::uint64_t offset = readU64(data, 80 + 24 * level);
+        std::uint64_t length = readU64(data, 80 + 24 * level + 8);
+        size_t expected = image.levelSize(level) * image.faces;
+
+        if (length < expected || offset > data.size() || data.size() - offset < expected)
+        {
+            image.error = std::format("level {} out of range", level);
+            return false;
+        }
+
+        std::memcpy(image.pixels.data() + image.levelOffset(level), data.data() + offset, expected);
+    }
+
+    return true;
+}
+
+bool parseDds(const std::vector<unsigned char> &data, TextureImage &image)
+{
+    if (data.size() < 128)
+    {
+        image.error = "truncated DDS header";
+        return false;
+    }
+
+    std::uint32_t flags = readU32(data, 8);
+    std::uint32_t pixelFlags = readU32(data, 80);
+    std::uint32_t code = readU32(data, 84);
+    std::uint32_t caps2 = readU32(data, 112);
+
+    image.height = static_cast<int>(readU32(data, 12));
+    image.width = static_cast<int>(readU32(data, 16));
+    image.levels = (flags & ddsdMipmapCount) ? static_cast<int>(std::max(readU32(data, 28), 1u)) : 1;
+    image.faces = (caps2 & ddsCaps2Cubemap) ? 6 : 1;
+
+    if (image.faces == 6 && (caps2 & ddsCaps2AllFaces) != ddsCaps2AllFaces)
+    {
+        image.error = "cubemaps without all six faces are not supported";
+        return false;
+    }
+
+    size_t dataOffset = 128;
+    const tf::FormatInfo *format = nullptr;
+
+    if ((pixelFlags & ddpfFourCC) && code == fourCC('D', 'X', '1', '0'))
+    {
+        if (data.size() < 148)
+        {
+            image.error = "truncated DDS DX10 header";
+            return false;
+        }
+
+        std::uint32_t dxgiFormat = readU32(data, 128);
+
+        if (readU32(data, 140) > 1)
+        {
+            image.error = "texture arrays are not supported";
+            return false;
+        }
+
+        if (readU32(data, 136) & ddsMiscTextureCube)
+            image.faces = 6;
+
+        format = tf::findDxgiFormat(dxgiFormat);
+        dataOffset = 148;
+
+        if (!format)
+        {
+            image.error = std::format("unsupported DXGI format {}", dxgiFormat);
+            return false;
+        }
+    }
+    else if (pixelFlags & ddpfFourCC)
+    {
+        if (code == fourCC('D', 'X', 'T', '1'))
+            format = tf::findDxgiFormat(71);
+        else if (code == fourCC('D', 'X', 'T', '5'))
+            format = tf::findDxgiFormat(77);
+        else if (code == fourCC('A', 'T', 'I', '1') || code == fourCC('B', 'C', '4', 'U'))
+            format = tf::findDxgiFormat(80);
+        else if (code == fourCC('B', 'C', '4', 'S'))
+            format = tf::findDxgiFormat(81);
+        else if (code == fourCC('A', 'T', 'I', '2') || code == fourCC('B', 'C', '5', 'U'))
+            format = tf::findDxgiFormat(83);
+        else if (code == fourCC('B', 'C', '5', 'S'))
+            format = tf::findDxgiFormat(84);
+
+        if (!format)
+        {
+            image.error =
+                std::format("unsupported DDS format '{}'", std::string(reinterpret_cast<const char *>(&data[84]), 4));
+            return false;
+        }
+    }
+    else if ((pixelFlags & ddpfRGB) && readU32(data, 88) == 32 && readU32(data, 92) == 0x000000FF &&
+             readU32(data, 96) == 0x0000FF00 && readU32(data, 100) == 0x00FF0000 && readU32(data, 104) == 0xFF000000)
+        format = tf::findDxgiFormat(28);
+    else
+    {
+        image.error = "unsupported uncompressed DDS pixel format";
+        return false;
+    }
+
+    setFormat(image, *format);
+
+    if (!allocate(image))
+        return false;
+
+    // DDS stores all levels of a face before the next face
+
+    for (int face = 0; face < image.faces; face++)
+    {
+        for (int level = 0; level < image.levels; level++)
+        {
+            size_t size = image.levelSize(level);
+
+            if (dataOffset > data.size() || data.size() - dataOffset < size)
+            {
+                image.error = std::format("truncated data of face {} level {}", face, level);
+                return false;
+            }
+
+            std::memcpy(image.pixels.data() + image.levelOffset(level, face), data.data() + dataOffset, size);
+            dataOffset += size;
+        }
+    }
+
+    return true;
+}
+
+bool decodeStb(const std::vector<unsigned char> &data, const TextureLoadOptions &options, TextureImage &image)
+{
+    int width = 0, height = 0, channels = 0;
+    void *pixels = nullptr;
+
+    if (options.hdr)
+    {
+        pixels = stbi_loadf_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels, 3);
+        channels = 3;
+    }
+    else
+        pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels, 0);
+
+    if (!pixels)
+    {
+        auto reason = stbi_failure_reason();
+        image.error = reason ? reason : "unknown error";
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.componentType = options.hdr ? GL_FLOAT : GL_UNSIGNED_BYTE;
+    image.faces = 1;
+
+    auto bytes = static_cast<const unsigned char *>(pixels);
+    image.pixels.assign(bytes, bytes + image.faceBytes());
+    stbi_image_free(pixels);
+
+    return true;
+}
+
+void flipRows(unsigned char *data, size_t rowBytes, int rows)
+{
+    std::vector<unsigned char> tmp(rowBytes);
+
+    for (int y = 0; y < rows / 2; y++)
+    {
+        unsigned char *top = data + y * rowBytes;
+        unsigned char *bottom = data + (rows - 1 - y) * rowBytes;
+        std::memcpy(tmp.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, tmp.data(), rowBytes);
+    }
+}
+
+void mirrorRows(unsigned char *data, int width, int rows, size_t pixelBytes)
+{
+    for (int y = 0; y < rows; y++)
+    {
+        unsigned char *row = data + y * width * pixelBytes;
+
+        for (int x = 0; x < width / 2; x++)
+            std::swap_ranges(row + x * pixelBytes, row + (x + 1) * pixelBytes, row + (width - 1 - x) * pixelBytes);
+    }
+}
+
+// Decodes one file into its own TextureImage. stb_image's global flip flag is left untouched, rows
+// are flipped here instead so that decoding on several threads at once is safe. Containers are
+// recognized by their magic bytes, anything else is handed to stb_image.
+
+TextureImage decodeFile(std::string_view filename, const TextureLoadOptions &options)
+{
+    TextureImage image;
+    std::vector<unsigned char> data;
+
+    if (!readFile(filename, data))
+    {
+        image.error = std::format("cannot read {}", filename);
+        return image;
+    }
+
+    bool ok = false;
+
+    if (data.size() >= ktx2Identifier.size() && std::equal(ktx2Identifier.begin(), ktx2Identifier.end(), data.begin()))
+        ok = parseKtx2(data, image);
+    else if (data.size() >= 4 && readU32(data, 0) == fourCC('D', 'D', 'S', ' '))
+        ok = parseDds(data, image);
+    else
+        ok = decodeStb(data, options, image);
+
+    if (!ok)
+    {
+        TextureImage failed;
+        failed.error = std::format("cannot decode {} ({})", filename, image.error);
+        return failed;
+    }
+
+    if (options.flipY && !image.compressed())
+    {
+        for (int level = 0; level < image.levels; level++)
+            for (int face = 0; face < image.faces; face++)
+                flipRows(image.pixels.data() + image.levelOffset(level, face),
+                         image.levelWidth(level) * image.pixelBytes(), image.levelHeight(level));
+    }
+
+    return image;
+}
+
+// KTX2 data format descriptor (basic block) of a format
+
+std::vector<std::uint32_t> dataFormatDescriptor(const tf::FormatInfo &format)
+{
+    struct Sample {
+        std::uint32_t bitOffset;
+        std::uint32_t bitLength;
+        std::uint32_t channel;
+    };
+
+    constexpr std::uint32_t alphaChannel = 15;
+    constexpr std::uint32_t qualifierLinear = 0x10;
+    constexpr std::uint32_t qualifierSigned = 0x40;
+    constexpr std::uint32_t qualifierFloat = 0x80;
+
+    std::vector<Sample> samples;
+
+    switch (format.dfdModel)
+    {
+    case tf::dfdModelBC1A:
+        samples = {{0, 64, format.channels == 4 ? 1u : 0u}};
+        break;
+    case tf::dfdModelBC3:
+        samples = {{0, 64, alphaChannel}, {64, 64, 0}};
+        break;
+    case tf::dfdModelBC4:
+        samples = {{0, 64, 0}};
+        break;
+    case tf::dfdModelBC5:
+        samples = {{0, 64, 0}, {64, 64, 1}};
+        break;
+    case tf::dfdModelBC7:
+        samples = {{0, 128, 0}};
+        break;
+    default: {
+        std::uint32_t bits = format.bytes * 8 / format.channels;
+
+        for (std::uint32_t c = 0; c < std::uint32_t(format.channels); c++)
+            samples.push_back({c * bits, bits, c == 3 ? alphaChannel : c});
+    }
+    }
+
+    const bool block = format.compressed != 0;
+    const bool floating = !block && format.componentType != GL_UNSIGNED_BYTE;
+    const std::uint32_t blockSize = 24 + 16 * static_cast<std::uint32_t>(samples.size());
+
+    std::vector<std::uint32_t> words;
+    words.push_back(4 + blockSize);
+    words.push_back(0); // Khronos vendor, basic descriptor type
+    words.push_back(2 | blockSize << 16);
+    words.push_back(format.dfdModel | 1u << 8 | (format.srgb ? 2u : 1u) << 16); // BT.709 primaries
+    words.push_back(block ? (3u | 3u << 8) : 0u);                                // 4x4 blocks
+    words.push_back(static_cast<std::uint32_t>(format.bytes));
+    words.push_back(0);
+
+    for (auto &sample : samples)
+    {
+        std::uint32_t qualifiers = 0;
+        std::uint32_t lower = 0;
+        std::uint32_t upper = block ? 0xFFFFFFFFu : (1u << sample.bitLength) - 1;
+
+        if (floating)
+        {
+            qualifiers = qualifierFloat | qualifierSigned;
+            lower = 0xBF800000u; // -1.0f
+            upper = 0x3F800000u; // 1.0f
+        }
+
+        if (format.srgb && sample.channel == alphaChannel)
+            qualifiers |= qualifierLinear;
+
+        words.push_back(sample.bitOffset | (sample.bitLength - 1) << 16 | (sample.channel | qualifiers) << 24);
+        words.push_back(0);
+        words.push_back(lower);
+        words.push_back(upper);
+    }
+
+    return words;
+}
+
+void appendKeyValue(std::vector<unsigned char> &kvd, std::string_view key, std::string_view value)
+{
+    std::uint32_t length = static_cast<std::uint32_t>(key.size() + value.size() + 2);
+
+    for (int i = 0; i < 4; i++)
+        kvd.push_back(static_cast<unsigned char>(length >> (8 * i)));
+
+    kvd.insert(kvd.end(), key.begin(), key.end());
+    kvd.push_back(0);
+    kvd.insert(kvd.end(), value.begin(), value.end());
+    kvd.push_back(0);
+
+    while (kvd.size() % 4)
+        kvd.push_back(0);
+}
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+TextureLoadOptions TextureLoadOptions::hdrImage()
+{
+    TextureLoadOptions options;
+    options.hdr = true;
+    options.flipY = true;
+    options.mipmaps = false;
+    return options;
+}
+
+int TextureImage::levelWidth(int level) const
+{
+    return std::max(width >> level, 1);
+}
+
+int TextureImage::levelHeight(int level) const
+{
+    return std::max(height >> level, 1);
+}
+
+size_t TextureImage::levelSize(int level) const
+{
+    size_t w = this->levelWidth(level);
+    size_t h = this->levelHeight(level);
+
+    if (this->compressed())
+    {
+        auto info = tf::findCompressed(compressedFormat);
+        return ((w + 3) / 4) * ((h + 3) / 4) * (info ? info->bytes : 16);
+    }
+
+    return w * h * this->pixelBytes();
+}
+
+size_t TextureImage::levelOffset(int level, int face) const
+{
+    size_t offset = 0;
+
+    for (int l = 0; l < level; l++)
+        offset += this->levelSize(l) * faces;
+
+    return offset + face * this->levelSize(level);
+}
+
+size_t TextureImage::pixelBytes() const
+{
+    switch (componentType)
+    {
+    case GL_FLOAT:
+        return channels * sizeof(float);
+    case GL_HALF_FLOAT:
+        return channels * sizeof(std::uint16_t);
+    default:
+        return channels;
+    }
+}
+
+size_t TextureImage::rowBytes() const
+{
+    return static_cast<size_t>(width) * this->pixelBytes();
+}
+
+size_t TextureImage::faceBytes() const
+{
+    return this->levelSize(0);
+}
+
+GLenum TextureImage::format() const
+{
+    switch (channels)
+    {
+    case 1:
+        return GL_RED;
+    case 2:
+        return GL_RG;
+    case 3:
+        return GL_RGB;
+    default:
+        return GL_RGBA;
+    }
+}
+
+GLenum TextureImage::type() const
+{
+    return componentType;
+}
+
+GLint TextureImage::internalFormat() const
+{
+    if (this->compressed())
+        return static_cast<GLint>(compressedFormat);
+
+    if (!this->hdr())
+        return static_cast<GLint>(this->format());
+
+    switch (channels)
+    {
+    case 1:
+        return GL_R16F;
+    case 2:
+        return GL_RG16F;
+    case 3:
+        return GL_RGB16F;
+    default:
+        return GL_RGBA16F;
+    }
+}
+
+size_t TextureImage::gpuBytes(bool mipmaps) const
+{
+    // Drivers store three component textures with four components
+
+    size_t texel = this->hdr() ? (channels == 3 ? 8 : channels * 2) : (channels == 3 ? 4 : channels);
+    size_t bytes = 0;
+
+    for (int level = 0; level < levels; level++)
+    {
+        if (this->compressed())
+            bytes += this->levelSize(level) * faces;
+        else
+            bytes += size_t(this->levelWidth(level)) * this->levelHeight(level) * texel * faces;
+    }
+
+    return mipmaps && this->canGenerateMipmaps() ? bytes * 4 / 3 : bytes;
+}
+
+bool TextureImage::upload(GLenum target, GLint level) const
+{
+    if (!this->valid())
+        return false;
+
+    if (this->compressed() && !formatSupported(compressedFormat))
+        return false;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (int l = 0; l < levels; l++)
+    {
+        for (int f = 0; f < faces; f++)
+        {
+            GLenum faceTarget = faces == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : target;
+            const unsigned char *data = pixels.data() + this->levelOffset(l, f);
+
+            if (this->compressed())
+                glCompressedTexImage2D(faceTarget, level + l, compressedFormat, this->levelWidth(l),
+                                       this->levelHeight(l), 0, static_cast<GLsizei>(this->levelSize(l)), data);
+            else
+                glTexImage2D(faceTarget, level + l, this->internalFormat(), this->levelWidth(l), this->levelHeight(l),
+                             0, this->format(), this->type(), data);
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Stored chains may stop before 1x1, limit sampling to the levels present
+
+    if (!this->canGenerateMipmaps())
+        glTexParameteri(faces == 6 ? GL_TEXTURE_CUBE_MAP : target, GL_TEXTURE_MAX_LEVEL, level + levels - 1);
+
+    return true;
+}
+
+bool TextureImage::saveKtx2(std::string_view filename) const
+{
+    auto info =
+        this->compressed() ? tf::findCompressed(compressedFormat) : tf::findUncompressed(componentType, channels);
+
+    if (!this->valid() || !info || info->vkFormat == 0)
+    {
+        logErrorfc("TextureImage", "Cannot save {}: format not supported by the KTX2 writer", filename);
+        return false;
+    }
+
+    auto dfd = dataFormatDescriptor(*info);
+
+    std::vector<unsigned char> kvd;
+    appendKeyValue(kvd, "KTXorientation", "rd");
+    appendKeyValue(kvd, "KTXwriter", "ivf2");
+
+    const size_t dfdOffset = 80 + 24 * size_t(levels);
+    const size_t dfdSize = dfd.size() * 4;
+    const size_t kvdOffset = dfdOffset + dfdSize;
+    const size_t alignment = std::max<size_t>(info->bytes, 4);
+
+    // Levels are stored smallest first, as required by the specification
+
+    std::vector<size_t> offsets(levels);
+    size_t end = kvdOffset + kvd.size();
+
+    for (int level = levels - 1; level >= 0; level--)
+    {
+        offsets[level] = alignUp(end, alignment);
+        end = offsets[level] + this->levelSize(level) * faces;
+    }
+
+    std::vector<unsigned char> file(end, 0);
+
+    std::copy(ktx2Identifier.begin(), ktx2Identifier.end(), file.begin());
+    writeU32(file, 12, info->vkFormat);
+    writeU32(file, 16, this->compressed() ? 1 : static_cast<std::uint32_t>(this->pixelBytes() / channels));
+    writeU32(file, 20, static_cast<std::uint32_t>(width));
+    writeU32(file, 24, static_cast<std::uint32_t>(height));
+    writeU32(file, 28, 0); // depth, 0 for 2D textures
+    writeU32(file, 32, 0); // layers, 0 for non-array textures
+    writeU32(file, 36, static_cast<std::uint32_t>(faces));
+    writeU32(file, 40, static_cast<std::uint32_t>(levels));
+    writeU32(file, 44, 0); // no supercompression
+
+    writeU32(file, 48, static_cast<std::uint32_t>(dfdOffset));
+    writeU32(file, 52, static_cast<std::uint32_t>(dfdSize));
+    writeU32(file, 56, static_cast<std::uint32_t>(kvdOffset));
+    writeU32(file, 60, static_cast<std::uint32_t>(kvd.size()));
+    writeU64(file, 64, 0);
+    writeU64(file, 72, 0);
+
+    for (int level = 0; level < levels; level++)
+    {
+        size_t size = this->levelSize(level) * faces;
+        writeU64(file, 80 + 24 * level, offsets[level]);
+        writeU64(file, 80 + 24 * level + 8, size);
+        writeU64(file, 80 + 24 * level + 16, size);
+        std::memcpy(file.data() + offsets[level], pixels.data() + this->levelOffset(level), size);
+    }
+
+    for (size_t i = 0; i < dfd.size(); i++)
+        writeU32(file, dfdOffset + 4 * i, dfd[i]);
+
+    std::copy(kvd.begin(), kvd.end(), file.begin() + kvdOffset);
+
+    std::ofstream out{std::string(filename), std::ios::binary};
+    out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+
+    if (!out)
+    {
+        logErrorfc("TextureImage", "Cannot write {}", filename);
+        return false;
+    }
+
+    return true;
+}
+
+TextureImage TextureImage::load(std::string_view filename, const TextureLoadOptions &options)
+{
+    return decodeFile(filename, options);
+}
+
+TextureImage TextureImage::loadCubemap(const std::array<std::string, 6> &paths, const TextureLoadOptions &options)
+{
+    TextureImage cubemap;
+
+    for (int f = 0; f < 6; f++)
+    {
+        auto face = decodeFile(paths[f], options);
+
+        if (!face.valid())
+            return face;
+
+        if (face.compressed() || face.faces != 1 || face.levels != 1)
+        {
+            TextureImage failed;
+            failed.error = std::format("cubemap face {} is compressed or stores several faces or levels, convert the "
+                                       "faces to a single container with ivf_texconv --cubemap",
+                                       paths[f]);
+            return failed;
+        }
+
+        if (f == 0)
+        {
+            cubemap = std::move(face);
+            cubemap.faces = 6;
+            cubemap.pixels.resize(cubemap.faceBytes() * 6);
+        }
+        else if (face.width != cubemap.width || face.height != cubemap.height || face.channels != cubemap.channels ||
+                 face.componentType != cubemap.componentType)
+        {
+            TextureImage failed;
+            failed.error = std::format("cubemap face {} is {}x{} ({} channels), expected {}x{} ({} channels)",
+                                       paths[f], face.width, face.height, face.channels, cubemap.width,
+                                       cubemap.height, cubemap.channels);
+            return failed;
+        }
+        else
+            std::memcpy(cubemap.pixels.data() + f * cubemap.faceBytes(), face.pixels.data(), face.faceBytes());
+    }
+
+    mirrorRows(cubemap.pixels.data(), cubemap.width, cubemap.height * 6, cubemap.pixelBytes());
+
+    return cubemap;
+}
+
+bool TextureImage::formatSupported(GLenum format)
+{
+    // GL_COMPRESSED_TEXTURE_FORMATS may omit formats, so core and extension formats are added
+    // explicitly. Queried once, on the thread owning the context.
+
+    static std::unordered_set<GLenum> supported;
+    static bool queried = false;
+
+    if (!queried)
+    {
+        queried = true;
+
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+        std::vector<GLint> formats(std::max(count, 0));
+
+        if (count > 0)
+            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+
+        supported.insert(formats.begin(), formats.end());
+
+        std::unordered_set<std::string> extensions;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+        for (GLint i = 0; i < extensionCount; i++)
+            if (auto name = glGetStringi(GL_EXTENSIONS, i))
+                extensions.insert(reinterpret_cast<const char *>(name));
+
+        supported.insert({GL_COMPRESSED_RED_RGTC1, GL_COMPRESSED_SIGNED_RED_RGTC1, GL_COMPRESSED_RG_RGTC2,
+                          GL_COMPRESSED_SIGNED_RG_RGTC2});
+
+        if (GLAD_GL_VERSION_4_2 || extensions.count("GL_ARB_texture_compression_bptc"))
+            supported.insert({GL_COMPRESSED_RGBA_BPTC_UNORM, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM});
+
+        if (extensions.count("GL_EXT_texture_compression_s3tc"))
+        {
+            supported.insert(
+                {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT});
+
+            if (extensions.count("GL_EXT_texture_sRGB") || extensions.count("GL_EXT_texture_compression_s3tc_srgb"))
+                supported.insert({GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+                                  GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT});
+        }
+    }
+
+    return supported.count(format) > 0;
+}
@@ -0,0 +1,163 @@
+#include <ivf/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace ivf;
+
+ThreadPool *ThreadPool::m_instance = nullptr;
+
+ThreadPool::ThreadPool(std::size_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        auto hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+
+    for (std::size_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back([this] { this->workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+ThreadPool *ThreadPool::instance()
+{
+    if (!m_instance)
+        m_instance = new ThreadPool(0);
+
+    return m_instance;
+}
+
+ThreadPool *ThreadPool::create(std::size_t workerCount)
+{
+    if (!m_instance)
+        m_instance = new ThreadPool(workerCount);
+
+    return m_instance;
+}
+
+void ThreadPool::drop()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+std::size_t ThreadPool::workerCount() const
+{
+    return m_workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+            if (m_stopping && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+bool ThreadPool::runPendingTask()
+{
+    std::function<void()> task;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty())
+            return false;
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+    }
+
+    task();
+    return true;
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    auto future = packaged->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace_back([packaged] { (*packaged)(); });
+    }
+
+    m_condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end,
+                             const std::function<void(std::size_t, std::size_t)> &fn, std::size_t grain)
+{
+    if (end <= begin)
+        return;
+
+    grain = std::max<std::size_t>(grain, 1);
+
+    const std::size_t count = end - begin;
+    const std::size_t maxChunks = m_workers.size() + 1;
+    const std::size_t chunks = std::min(maxChunks, (count + grain - 1) / grain);
+
+    if (chunks <= 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    const std::size_t chunkSize = (count + chunks - 1) / chunks;
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks - 1);
+
+    for (std::size_t c = 1; c < chunks; c++)
+    {
+        std::size_t chunkBegin = begin + c * chunkSize;
+        std::size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+
+        if (chunkBegin >= chunkEnd)
+            break;
+
+        futures.push_back(this->submit([&fn, chunkBegin, chunkEnd] { fn(chunkBegin, chunkEnd); }));
+    }
+
+    // The calling thread takes the first chunk and then helps draining the queue, which also
+    // keeps nested parallelFor() calls from deadlocking when all workers are busy.
+
+    fn(begin, std::min(end, begin + chunkSize));
+
+    for (auto &future : futures)
+    {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!this->runPendingTask())
+                future.wait_for(std::chrono::microseconds(50));
+        }
+        future.get();
+    }
+}
@@ -1,6 +1,7 @@
 #include <ivf/tint_effect.h>
 
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -47,15 +48,15 @@ glm::vec3 ivf::TintEffect::grayScaleWeights() const
 
 void ivf::TintEffect::doLoad()
 {
-    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330, ivf::tint_frag_shader_source,
-                                         "tint", false);
+    m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
+                                         EffectFusion::fragmentSource({ivf::tint_pointwise_source}), "tint", false);
 }
 
 void ivf::TintEffect::doUpdateParams()
 {
-    m_program->uniformVec3("tintColor", m_tintColor);
-    m_program->uniformFloat("tintStrength", m_tintStrength);
-    m_program->uniformVec3("grayScaleWeights", m_grayScaleWeights);
+    paramProgram()->uniformVec3(paramName("tintColor"), m_tintColor);
+    paramProgram()->uniformFloat(paramName("tintStrength"), m_tintStrength);
+    paramProgram()->uniformVec3(paramName("grayScaleWeights"), m_grayScaleWeights);
 }
 
 void ivf::TintEffect::setupProperties()
@@ -64,3 +65,13 @@ void ivf::TintEffect::setupProperties()
     addProperty("Tint strength", &m_tintStrength, "Tint");
     addProperty("Gray scale weights", &m_grayScaleWeights, "Tint");
 }
+
+bool ivf::TintEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ivf::TintEffect::pointwiseSource() const
+{
+    return ivf::tint_pointwise_source;
+}
@@ -141,6 +141,11 @@ BoundingBox TransformNode::localBoundingBox() const
     return m_localBbox;
 }
 
+uint64_t TransformNode::contentRevision() const
+{
+    return 0;
+}
+
 BoundingBox TransformNode::worldBoundingBox() const
 {
     if (!m_localBbox.isValid())
@@ -9,6 +9,9 @@ TurbulenceDeformer::TurbulenceDeformer(float scale, float intensity, int octaves
     : m_scale(scale), m_intensity(intensity), m_octaves(octaves), m_persistence(persistence),
       m_animationSpeed(animationSpeed), m_seed(12345)
 {
+    // The function only reads the parameters, all of them changed through setters
+    setCacheable(true);
+    setThreadSafe(true);
     updateFunction();
 }
 
@@ -65,6 +68,7 @@ float TurbulenceDeformer::persistence() const
 void TurbulenceDeformer::setAnimationSpeed(float speed)
 {
     m_animationSpeed = speed;
+    markChanged();
 }
 
 float TurbulenceDeformer::animationSpeed() const
@@ -94,6 +98,54 @@ std::unique_ptr<Deformer> TurbulenceDeformer::clone() const
     return cloned;
 }
 
+bool TurbulenceDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    return true;
+}
+
+void TurbulenceDeformer::applyKernel(glm::vec3 *positions, [[maybe_unused]] GLuint first, GLuint count) const
+{
+    // Same displacement as the function set by updateFunction(), without the call overhead
+    glm::vec3 inputOffset = offset();
+    glm::vec3 displacementScale = FunctionDeformer::scale() * m_weight;
+    glm::vec3 animation(time() * m_animationSpeed);
+
+    for (GLuint i = 0; i < count; ++i)
+    {
+        glm::vec3 animatedPos = positions[i] + inputOffset + animation;
+        float turbX = turbulence(animatedPos * m_scale, m_octaves, m_persistence, m_seed);
+        float turbY = turbulence(animatedPos * m_scale + glm::vec3(100, 0, 0), m_octaves, m_persistence, m_seed);
+        float turbZ = turbulence(animatedPos * m_scale + glm::vec3(0, 100, 0), m_octaves, m_persistence, m_seed);
+        positions[i] += glm::vec3(turbX, turbY, turbZ) * m_intensity * displacementScale;
+    }
+}
+
+bool TurbulenceDeformer::transformBounds(BoundingBox &bbox) const
+{
+    // Each octave adds at most its amplitude to turbulence()
+    float maxTurbulence = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < m_octaves; ++i)
+    {
+        maxTurbulence += amplitude;
+        amplitude *= std::abs(m_persistence);
+    }
+
+    glm::vec3 displacement = glm::abs(maxTurbulence * m_intensity * FunctionDeformer::scale() * m_weight);
+    bbox.setBounds(bbox.min() - displacement, bbox.max() + displacement);
+    return true;
+}
+
+bool TurbulenceDeformer::gpuDeformer(GpuDeformer &gpu) const
+{
+    gpu.type = GpuDeformerType::TURBULENCE;
+    gpu.params[0] = glm::vec4(offset() + glm::vec3(time() * m_animationSpeed), m_scale);
+    gpu.params[1] = glm::vec4(FunctionDeformer::scale() * m_weight, m_intensity);
+    gpu.params[2] = glm::vec4(float(m_octaves), m_persistence, glm::uintBitsToFloat(m_seed), 0.0f);
+    gpu.params[3] = glm::vec4(0.0f);
+    return true;
+}
+
 void TurbulenceDeformer::updateFunction()
 {
     setFunction([this](const glm::vec3 &pos) -> glm::vec3 {
@@ -1,6 +1,9 @@
 #include <ivf/twist_deformer.h>
 #include <ivf/utils.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace ivf;
 
 TwistDeformer::TwistDeformer(const glm::vec3 &axis, const glm::vec3 &center)
@@ -16,6 +19,7 @@ std::shared_ptr<TwistDeformer> TwistDeformer::create(const glm::vec3 &axis, cons
 void TwistDeformer::setAxis(const glm::vec3 &axis)
 {
     m_axis = glm::normalize(axis);
+    markChanged();
 }
 
 glm::vec3 TwistDeformer::axis() const
@@ -26,6 +30,7 @@ glm::vec3 TwistDeformer::axis() const
 void TwistDeformer::setCenter(const glm::vec3 &center)
 {
     m_center = center;
+    markChanged();
 }
 
 glm::vec3 TwistDeformer::center() const
@@ -36,6 +41,7 @@ glm::vec3 TwistDeformer::center() const
 void TwistDeformer::setAngle(float angle)
 {
     m_angle = angle;
+    markChanged();
 }
 
 float TwistDeformer::angle() const
@@ -46,6 +52,7 @@ float TwistDeformer::angle() const
 void TwistDeformer::setFalloff(float falloff)
 {
     m_falloff = falloff;
+    markChanged();
 }
 
 float TwistDeformer::falloff() const
@@ -57,6 +64,7 @@ void TwistDeformer::setDistanceRange(float start, float end)
 {
     m_startDistance = start;
     m_endDistance = end;
+    markChanged();
 }
 
 float TwistDeformer::startDistance() const
@@ -74,9 +82,19 @@ void TwistDeformer::apply()
     if (!m_enabled || !m_originalVertices || !m_deformedVertices)
         return;
 
-    for (GLuint i = 0; i < m_originalVertices->rows(); ++i)
+    applyWithKernel();
+}
+
+bool TwistDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    return true;
+}
+
+void TwistDeformer::applyKernel(glm::vec3 *positions, [[maybe_unused]] GLuint first, GLuint count) const
+{
+    for (GLuint i = 0; i < count; ++i)
     {
-        glm::vec3 originalPos = m_originalVertices->vertex(i);
+        glm::vec3 originalPos = positions[i];
         glm::vec3 relativePos = originalPos - m_center;
 
         // Project onto axis to get distance along axis
@@ -95,18 +113,58 @@ void TwistDeformer::apply()
             glm::vec3 deformedPos = glm::rotate(relativePos, twistAngle, m_axis) + m_center;
 
             // Blend with original position
-            glm::vec3 finalPos = glm::mix(originalPos, deformedPos, weight);
-
-            m_deformedVertices->setVertex(i, finalPos.x, finalPos.y, finalPos.z);
-        }
-        else
-        {
-            // No deformation, keep original
-            m_deformedVertices->setVertex(i, originalPos.x, originalPos.y, originalPos.z);
+            positions[i] = glm::mix(originalPos, deformedPos, weight);
         }
     }
 }
 
+bool TwistDeformer::transformBounds(BoundingBox &bbox) const
+{
+    // A negative falloff gives weights above 1, which extrapolate past the rotated position
+    if (m_falloff < 0.0f)
+        return false;
+
+    // Rotating around the axis keeps the distance along and from the axis, and blending two
+    // such positions stays inside the cylinder around the axis that contains the box. The
+    // positions also move at most by the chord of the largest twist angle, perpendicular to the axis.
+    float minAxial = std::numeric_limits<float>::max();
+    float maxAxial = std::numeric_limits<float>::lowest();
+    float maxRadial2 = 0.0f;
+
+    for (auto &corner : bbox.corners())
+    {
+        glm::vec3 relativePos = corner - m_center;
+        float axial = glm::dot(relativePos, m_axis);
+        minAxial = std::min(minAxial, axial);
+        maxAxial = std::max(maxAxial, axial);
+        maxRadial2 = std::max(maxRadial2, glm::dot(relativePos, relativePos) - axial * axial);
+    }
+
+    float radius = std::sqrt(maxRadial2);
+    glm::vec3 perpendicular = glm::sqrt(glm::max(glm::vec3(1.0f) - m_axis * m_axis, glm::vec3(0.0f)));
+
+    glm::vec3 start = m_center + m_axis * minAxial;
+    glm::vec3 end = m_center + m_axis * maxAxial;
+    glm::vec3 cylinderMin = glm::min(start, end) - radius * perpendicular;
+    glm::vec3 cylinderMax = glm::max(start, end) + radius * perpendicular;
+
+    float maxAngle = std::min(std::abs(m_angle) * m_weight, glm::pi<float>());
+    glm::vec3 displacement = 2.0f * radius * std::sin(maxAngle * 0.5f) * m_weight * perpendicular;
+
+    bbox.setBounds(glm::max(cylinderMin, bbox.min() - displacement), glm::min(cylinderMax, bbox.max() + displacement));
+    return true;
+}
+
+bool TwistDeformer::gpuDeformer(GpuDeformer &gpu) const
+{
+    gpu.type = GpuDeformerType::TWIST;
+    gpu.params[0] = glm::vec4(m_axis, m_angle);
+    gpu.params[1] = glm::vec4(m_center, m_falloff);
+    gpu.params[2] = glm::vec4(m_startDistance, m_endDistance, m_weight, 0.0f);
+    gpu.params[3] = glm::vec4(0.0f);
+    return true;
+}
+
 std::unique_ptr<Deformer> TwistDeformer::clone() const
 {
     auto cloned = std::make_unique<TwistDeformer>(m_axis, m_center);
@@ -1,6 +1,7 @@
 #include <ivf/vignette_effect.h>
 
 #include <ivf/post_shaders.h>
+#include <ivf/effect_fusion.h>
 
 using namespace ivf;
 
@@ -37,13 +38,14 @@ float ivf::VignetteEffect::smoothness()
 void ivf::VignetteEffect::doLoad()
 {
     m_program = smLoadProgramFromStrings(ivf::render_to_texture_vert_shader_source_330,
-                                         ivf::vignette_frag_shader_source, "vignette", false);
+                                         EffectFusion::fragmentSource({ivf::vignette_pointwise_source}),
+                                         "vignette", false);
 }
 
 void ivf::VignetteEffect::doUpdateParams()
 {
-    m_program->uniformFloat("vignetteSize", m_vignetteSize);
-    m_program->uniformFloat("vignetteSmoothness", m_vignetteSmoothness);
+    paramProgram()->uniformFloat(paramName("vignetteSize"), m_vignetteSize);
+    paramProgram()->uniformFloat(paramName("vignetteSmoothness"), m_vignetteSmoothness);
 }
 
 void ivf::VignetteEffect::setupProperties()
@@ -51,3 +53,13 @@ void ivf::VignetteEffect::setupProperties()
     addProperty("Size", &m_vignetteSize, "Vignette");
     addProperty("Smoothness", &m_vignetteSmoothness, "Vignette");
 }
+
+bool ivf::VignetteEffect::isPointwise() const
+{
+    return true;
+}
+
+std::string ivf::VignetteEffect::pointwiseSource() const
+{
+    return ivf::vignette_pointwise_source;
+}
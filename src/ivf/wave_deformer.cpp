@@ -9,6 +9,9 @@ WaveDeformer::WaveDeformer(float amplitude, float frequency, float speed, const
     : m_amplitude(amplitude), m_frequency(frequency), m_speed(speed), m_direction(glm::normalize(direction)),
       m_waveVector(glm::normalize(waveVector))
 {
+    // The function only reads the parameters, all of them changed through setters
+    setCacheable(true);
+    setThreadSafe(true);
     updateFunction();
 }
 
@@ -82,6 +85,45 @@ std::unique_ptr<Deformer> WaveDeformer::clone() const
     return cloned;
 }
 
+bool WaveDeformer::prepareKernel([[maybe_unused]] GLuint vertexCount)
+{
+    return true;
+}
+
+void WaveDeformer::applyKernel(glm::vec3 *positions, [[maybe_unused]] GLuint first, GLuint count) const
+{
+    // Same displacement as the function set by updateFunction(), without the call overhead
+    glm::vec3 inputOffset = offset();
+    glm::vec3 displacementScale = scale() * m_weight;
+    float phaseShift = time() * m_speed;
+
+    for (GLuint i = 0; i < count; ++i)
+    {
+        glm::vec3 inputPos = positions[i] + inputOffset;
+        float phase = glm::dot(inputPos, m_direction) * m_frequency - phaseShift;
+        float wave = std::sin(phase) * m_amplitude;
+        positions[i] += m_waveVector * wave * displacementScale;
+    }
+}
+
+bool WaveDeformer::transformBounds(BoundingBox &bbox) const
+{
+    // The sine is at most 1, so no position moves further than the amplitude along the wave vector
+    glm::vec3 displacement = glm::abs(m_waveVector * m_amplitude * scale() * m_weight);
+    bbox.setBounds(bbox.min() - displacement, bbox.max() + displacement);
+    return true;
+}
+
+bool WaveDeformer::gpuDeformer(GpuDeformer &gpu) const
+{
+    gpu.type = GpuDeformerType::WAVE;
+    gpu.params[0] = glm::vec4(m_direction, m_frequency);
+    gpu.params[1] = glm::vec4(m_waveVector, m_amplitude);
+    gpu.params[2] = glm::vec4(offset(), time() * m_speed);
+    gpu.params[3] = glm::vec4(scale() * m_weight, 0.0f);
+    return true;
+}
+
 void WaveDeformer::updateFunction()
 {
     setFunction([this](const glm::vec3 &pos) -> glm::vec3 {
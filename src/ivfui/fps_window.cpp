@@ -1,6 +1,7 @@
 #include <ivfui/fps_window.h>
 
 #include <ivf/light_manager.h>
+#include <ivf/render_target_pool.h>
 
 using namespace ivfui;
 using namespace ivf;
@@ -18,5 +19,14 @@ std::shared_ptr<FpsWindow> FpsWindow::create()
 void FpsWindow::doDraw()
 {
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
-}
 
+	auto lightMgr = LightManager::instance();
+
+	if (lightMgr->useShadows())
+		ImGui::Text("Shadow passes: %d rendered, %d skipped", lightMgr->shadowPassesRendered(), lightMgr->shadowPassesSkipped());
+
+	auto pool = RenderTargetPool::instance();
+
+	ImGui::Text("Render targets: %zu (%zu in use), %.1f MB", pool->acquiredCount() + pool->freeCount(),
+				pool->acquiredCount(), double(pool->totalBytes()) / (1024.0 * 1024.0));
+}
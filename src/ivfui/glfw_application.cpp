@@ -4,6 +4,9 @@
 
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 
 #include <imgui_impl_glfw.h>
@@ -55,15 +58,40 @@ static void window_close_callback(GLFWwindow *window)
         win->close();
 }
 
-GLFWApplication::GLFWApplication()
+GLFWApplication::GLFWApplication(bool headless, HeadlessContext context)
+    : m_headless(headless), m_headlessContext(context)
 {
-    logInfo("Initializing GLFW", "GLFWApplication");
+    this->readEnvironment();
+
+    if (m_headless)
+    {
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+        logInfo("Initializing GLFW without a display", "GLFWApplication");
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        logWarning("Headless mode requires GLFW 3.4, using an invisible window", "GLFWApplication");
+#endif
+    }
+    else
+        logInfo("Initializing GLFW", "GLFWApplication");
 
     if (!glfwInit())
     {
         logError("Failed to initialize GLFW", "GLFWApplication");
         exit(EXIT_FAILURE);
     }
+
+    if (m_headless)
+    {
+        // Every window created from now on gets an off-screen context
+
+        if (m_headlessContext == HeadlessContext::EGL)
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        else
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
 }
 
 GLFWApplication::~GLFWApplication()
@@ -81,6 +109,70 @@ std::shared_ptr<GLFWApplication> GLFWApplication::create()
     return std::shared_ptr<GLFWApplication>(new GLFWApplication());
 }
 
+std::shared_ptr<GLFWApplication> GLFWApplication::createHeadless(HeadlessContext context)
+{
+    return std::shared_ptr<GLFWApplication>(new GLFWApplication(true, context));
+}
+
+void GLFWApplication::readEnvironment()
+{
+    if (auto value = std::getenv("IVF_HEADLESS"); value && std::string(value) != "0")
+    {
+        m_headless = true;
+
+        if (std::string(value) == "egl")
+            m_headlessContext = HeadlessContext::EGL;
+        else if (std::string(value) == "osmesa")
+            m_headlessContext = HeadlessContext::OSMesa;
+    }
+
+    if (auto value = std::getenv("IVF_MAX_FRAMES"))
+        m_maxFrames = std::max(0, std::atoi(value));
+
+    if (auto value = std::getenv("IVF_FIXED_TIMESTEP"))
+        m_fixedTimeStep = std::max(0.0, std::atof(value));
+
+    if (auto value = std::getenv("IVF_CAPTURE_DIR"))
+        m_captureDir = value;
+}
+
+void GLFWApplication::configureWindows()
+{
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        auto window = m_windows[i];
+
+        if (m_maxFrames > 0)
+            window->setMaxFrames(m_maxFrames);
+
+        if (m_fixedTimeStep > 0.0)
+            window->setFixedTimeStep(m_fixedTimeStep);
+
+        // Without a blocking swap the draw time would not include the rendering itself
+
+        if (m_headless)
+            window->setFinishFrames(true);
+
+        if (!m_captureDir.empty())
+        {
+            auto directory = m_captureDir;
+
+            if (m_windows.size() > 1)
+            {
+                directory += "/" + std::to_string(i);
+                std::filesystem::create_directories(directory);
+            }
+
+            // Headless output is expected to be complete, wait for the encoders instead of dropping
+
+            if (m_headless)
+                window->frameCapture()->setAllowDrops(false);
+
+            window->startRecording(directory, 0);
+        }
+    }
+}
+
 void GLFWApplication::addWindow(GLFWWindowPtr window)
 {
     logInfo("Adding GLFW window to application", "GLFWApplication");
@@ -105,6 +197,8 @@ int GLFWApplication::loop()
 {
     logInfo("Starting main application loop", "GLFWApplication");
 
+    this->configureWindows();
+
     int anyError = 0;
 
     while (true) {
@@ -125,6 +219,14 @@ int GLFWApplication::loop()
 
         this->pollEvents();
     }
+
+    if (m_maxFrames > 0)
+    {
+        for (size_t i = 0; i < m_windows.size(); i++)
+            logInfofc("GLFWApplication", "Window {}: {} frames, average draw time {:.3f} ms", i,
+                      m_windows[i]->drawnFrames(), m_windows[i]->averageDrawTime() * 1000.0);
+    }
+
     return anyError;
 }
 
@@ -138,6 +240,41 @@ void GLFWApplication::hint(int hint, int value)
     glfwWindowHint(hint, value);
 }
 
+bool GLFWApplication::isHeadless() const
+{
+    return m_headless;
+}
+
+void GLFWApplication::setMaxFrames(int frames)
+{
+    m_maxFrames = frames;
+}
+
+int GLFWApplication::maxFrames() const
+{
+    return m_maxFrames;
+}
+
+void GLFWApplication::setFixedTimeStep(double step)
+{
+    m_fixedTimeStep = step;
+}
+
+double GLFWApplication::fixedTimeStep() const
+{
+    return m_fixedTimeStep;
+}
+
+void GLFWApplication::setCaptureDirectory(const std::string &directory)
+{
+    m_captureDir = directory;
+}
+
+const std::string &GLFWApplication::captureDirectory() const
+{
+    return m_captureDir;
+}
+
 void GLFWWindowTracker::addWindow(GLFWWindowPtr window)
 {
     m_windowMap[window->ref()] = window;
@@ -16,6 +16,8 @@ using namespace ivfui;
 #include <ivf/time_controller.h>
 #include <ivf/transform_manager.h>
 #include <ivf/composite_node.h>
+#include <ivf/render_target_pool.h>
+#include <ivf/texture_cache.h>
 
 #include <cmath>
 #include <vector>
@@ -124,7 +126,7 @@ void ivfui::GLFWSceneWindow::addUiWindow(ivfui::UiWindowPtr uiWindow)
 void ivfui::GLFWSceneWindow::addEffect(ivf::EffectPtr effect)
 {
     m_effects.push_back(effect);
-    m_postProcessor->addEffect(effect->program());
+    m_postProcessor->addEffect(effect);
 }
 
 // EffectListProvider interface implementation
@@ -238,7 +240,7 @@ bool GLFWSceneWindow::reorderEffect(int fromIndex, int toIndex)
     {
         if (eff)
         {
-            m_postProcessor->addEffect(eff->program());
+            m_postProcessor->addEffect(eff);
         }
     }
 
@@ -757,6 +759,7 @@ void GLFWSceneWindow::doUpdate()
     TimerManager::instance()->update(dt);
     ShaderWatcher::instance()->update(dt);
     TimeController::instance()->update(frameTime());
+    TextureCache::instance()->update();
     updateSceneBehaviors(m_scene.get(), dt);
     GLFWWindow::doUpdate();  // calls onUpdate()
 }
@@ -797,6 +800,7 @@ void GLFWSceneWindow::doDraw()
 
         smApplyProgram("basic");
         LightManager::instance()->renderShadowMaps(m_scene);
+        LightManager::instance()->updateClusters();
         m_scene->draw();
 
         {
@@ -820,13 +824,22 @@ void GLFWSceneWindow::doDraw()
         for (auto &effect : m_effects)
             effect->use();
 
-        m_postProcessor->setTime(glfwGetTime());
+        m_postProcessor->setTime(elapsedTime());
         m_postProcessor->apply(m_frameBuffer->colorTexture());
 
         // Reset shader to basic
 
         smApplyProgram("basic");
     }
+    else if (m_selectionRendering)
+    {
+        // ID pass: the selection target is cleared by BufferSelection, only the scene is drawn
+
+        GLFWWindow::doDraw();
+
+        smApplyProgram("basic");
+        m_scene->draw();
+    }
     else
     {
         GLFWWindow::doDraw();
@@ -837,6 +850,7 @@ void GLFWSceneWindow::doDraw()
 
         smApplyProgram("basic");
         LightManager::instance()->renderShadowMaps(m_scene);
+        LightManager::instance()->updateClusters();
         m_scene->draw();
 
         {
@@ -884,12 +898,16 @@ void ivfui::GLFWSceneWindow::doDrawComplete()
 {
     if (m_selectionEnabled)
     {
-        m_selectionRendering = true;
+        // The ID pass only runs when the cursor or scene changed, its result arrives a frame later
 
-        m_bufferSelection->begin();
+        if (m_bufferSelection->beginPick(mouseX(), mouseY()))
+        {
+            m_selectionRendering = true;
+            this->drawScene();
+            m_bufferSelection->endPick();
+        }
 
-        this->drawScene();
-        auto m_currentNode = m_bufferSelection->nodeAtPixel(mouseX(), mouseY());
+        auto m_currentNode = m_bufferSelection->pickedNode();
 
         if (m_currentNode != nullptr)
         {
@@ -913,11 +931,13 @@ void ivfui::GLFWSceneWindow::doDrawComplete()
                 m_lastNode = nullptr;
             }
         }
-
-        m_bufferSelection->end();
     }
     m_selectionRendering = false;
 
+    // Pooled render targets idle for too many frames are freed here
+
+    RenderTargetPool::instance()->endFrame();
+
     GLFWWindow::doDrawComplete();
 }
 
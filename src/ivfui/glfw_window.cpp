@@ -1,19 +1,18 @@
 #include <ivfui/glfw_window.h>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
 #undef GLAD_GL_IMPLEMENTATION
 #include <glad/glad.h>
 
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <vector>
 #include <ivfui/glfw_window.h>
 #include <ivf/shader_manager.h>
+#include <ivf/gl_diagnostics.h>
 
 using namespace std;
 using namespace ivfui;
@@ -38,6 +37,8 @@ GLFWWindow::GLFWWindow(int width, int height, const std::string title, GLFWmonit
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT,
+                   ivf::GLDiagnostics::instance()->mode() != ivf::GLDiagnosticsMode::Off ? GLFW_TRUE : GLFW_FALSE);
     m_window = glfwCreateWindow(width, height, title.c_str(), monitor, shared);
 
     if (!m_window)
@@ -51,7 +52,10 @@ GLFWWindow::GLFWWindow(int width, int height, const std::string title, GLFWmonit
     if (!gladLoadGL())
         exit(EXIT_FAILURE);
 
+    ivf::GLDiagnostics::instance()->install();
+
     m_uiRenderer = UiRenderer::create(m_window);
+    m_frameCapture = ivf::FrameCapture::create();
 }
 
 GLFWWindow::~GLFWWindow()
@@ -98,6 +102,8 @@ void GLFWWindow::destroy()
 {
     if (m_window)
     {
+        this->stopRecording();
+
         glfwDestroyWindow(m_window);
         m_window = nullptr;
     }
@@ -242,12 +248,29 @@ void GLFWWindow::draw()
 
     this->makeCurrent();
 
-    // Compute wall-clock frame delta time (time since the previous call to draw()).
-    // This gives a real dt for animations regardless of how fast onDraw() runs.
-    double now = glfwGetTime();
-    if (m_lastFrameTime > 0.0)
-        m_frameTime = now - m_lastFrameTime;
-    m_lastFrameTime = now;
+    ivf::GLDiagnostics::instance()->beginFrame();
+
+    auto drawStart = std::chrono::steady_clock::now();
+
+    if (m_fixedTimeStep > 0.0)
+    {
+        // Fixed timestep: every frame advances the same simulated amount. The GLFW timer is
+        // moved to the simulated time so that direct glfwGetTime() users follow it as well.
+
+        m_frameTime = m_fixedTimeStep;
+        if (m_drawnFrames > 0)
+            m_simTime += m_fixedTimeStep;
+        glfwSetTime(m_simTime);
+    }
+    else
+    {
+        // Compute wall-clock frame delta time (time since the previous call to draw()).
+        // This gives a real dt for animations regardless of how fast onDraw() runs.
+        double now = glfwGetTime();
+        if (m_lastFrameTime > 0.0)
+            m_frameTime = now - m_lastFrameTime;
+        m_lastFrameTime = now;
+    }
 
     auto result = 0;
 
@@ -313,21 +336,44 @@ void GLFWWindow::draw()
         glfwMakeContextCurrent(backup_current_context);
     }
 
-    // Swap buffers
+    ivf::GLDiagnostics::instance()->endFrame();
 
-    this->swapBuffers();
+    // Recording: queue an asynchronous read-back of the finished frame before the swap
 
-    // Recording: capture after swap so the frame is complete
-    if (m_recording) {
-        double interval = (m_recordFps > 0) ? 1.0 / m_recordFps : 0.0;
-        m_recordAccum += m_frameTime;
-        while (m_recording && interval > 0.0 && m_recordAccum >= interval) {
-            char name[64];
-            std::snprintf(name, sizeof(name), "/frame_%06d.png", m_recordFrameIdx++);
-            captureFrame(m_recordPath + name);
-            m_recordAccum -= interval;
+    if (m_recording)
+    {
+        int copies = 1;
+
+        if (m_recordFps > 0)
+        {
+            double interval = 1.0 / m_recordFps;
+            m_recordAccum += m_frameTime;
+            copies = int(m_recordAccum / interval);
+            m_recordAccum -= copies * interval;
+        }
+
+        if (copies > 0)
+        {
+            int w, h;
+            getSize(w, h);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            m_frameCapture->capture(w, h, copies);
         }
     }
+
+    // Swap buffers
+
+    this->swapBuffers();
+
+    if (m_finishFrames)
+        glFinish();
+
+    m_drawTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - drawStart).count();
+    m_drawTimeSum += m_drawTime;
+    m_drawnFrames++;
+
+    if (m_maxFrames > 0 && m_drawnFrames >= m_maxFrames)
+        this->close();
 }
 
 void ivfui::GLFWWindow::drawScene()
@@ -467,7 +513,60 @@ int ivfui::GLFWWindow::frameCount() const
 
 double ivfui::GLFWWindow::elapsedTime() const
 {
-    return glfwGetTime();
+    if (m_fixedTimeStep > 0.0)
+        return m_simTime;
+    else
+        return glfwGetTime();
+}
+
+void ivfui::GLFWWindow::setFixedTimeStep(double step)
+{
+    m_fixedTimeStep = step;
+    m_simTime = 0.0;
+    m_lastFrameTime = 0.0;
+}
+
+double ivfui::GLFWWindow::fixedTimeStep() const
+{
+    return m_fixedTimeStep;
+}
+
+void ivfui::GLFWWindow::setMaxFrames(int frames)
+{
+    m_maxFrames = frames;
+}
+
+int ivfui::GLFWWindow::maxFrames() const
+{
+    return m_maxFrames;
+}
+
+void ivfui::GLFWWindow::setFinishFrames(bool flag)
+{
+    m_finishFrames = flag;
+}
+
+bool ivfui::GLFWWindow::finishFrames() const
+{
+    return m_finishFrames;
+}
+
+double ivfui::GLFWWindow::drawTime() const
+{
+    return m_drawTime;
+}
+
+double ivfui::GLFWWindow::averageDrawTime() const
+{
+    if (m_drawnFrames > 0)
+        return m_drawTimeSum / m_drawnFrames;
+    else
+        return 0.0;
+}
+
+int ivfui::GLFWWindow::drawnFrames() const
+{
+    return m_drawnFrames;
 }
 
 void ivfui::GLFWWindow::clearError()
@@ -564,16 +663,28 @@ void GLFWWindow::saveScreenshot(const std::string& path)
     captureFrame(path);
 }
 
-void GLFWWindow::startRecording(const std::string& directory, int fps)
+void GLFWWindow::startRecording(const std::string& directory, int fps, ivf::CaptureFormat format)
 {
+    this->makeCurrent();
+
     m_recordPath      = directory;
     m_recordFps       = fps;
-    m_recordFrameIdx  = 0;
     m_recordAccum     = 0.0;
-    m_recording       = true;
+    m_recording       = m_frameCapture->start(directory, format);
 }
 
 void GLFWWindow::stopRecording()
 {
+    if (m_recording)
+    {
+        this->makeCurrent();
+        m_frameCapture->stop();
+    }
+
     m_recording = false;
 }
+
+ivf::FrameCapturePtr GLFWWindow::frameCapture() const
+{
+    return m_frameCapture;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file ivf_sceneconv.cpp
+ * @brief Converts scene files between the JSON and binary formats of SceneSerializer.
+ *
+ * JSON files become binary .ivfscene files and binary files become JSON files; the direction is
+ * chosen from the file signature. The conversion is lossless in both directions, so the binary
+ * files can be generated from hand-edited JSON scenes in a build step and converted back for
+ * inspection.
+ *
+ * Usage:
+ * @code
+ * ivf_sceneconv assets/level.json                # assets/level.ivfscene
+ * ivf_sceneconv assets/level.ivfscene            # assets/level.json
+ * ivf_sceneconv -o build/assets a.json b.json    # build/assets/a.ivfscene and build/assets/b.ivfscene
+ * @endcode
+ */
+
+#include <ivf/scene_serializer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace ivf;
+
+namespace {
+
+struct Settings {
+    bool quiet{false};
+    std::string output;
+    std::vector<std::string> inputs;
+};
+
+void printUsage()
+{
+    std::cout << "Usage: ivf_sceneconv [options] <scene>...\n"
+                 "\n"
+                 "Converts JSON scene files to binary .ivfscene files and binary files back to JSON.\n"
+                 "\n"
+                 "Options:\n"
+                 "  -o, --output <path>  Output directory, or output file for a single input\n"
+                 "                       (default: next to the input with a .ivfscene or .json extension)\n"
+                 "  -q, --quiet          Only print errors\n"
+                 "  -h, --help           Show this help\n";
+}
+
+bool parseArguments(int argc, char **argv, Settings &settings)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            std::exit(0);
+        }
+        else if (arg == "-o" || arg == "--output")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << std::format("ivf_sceneconv: {} needs a value\n", arg);
+                return false;
+            }
+            settings.output = argv[++i];
+        }
+        else if (arg == "-q" || arg == "--quiet")
+            settings.quiet = true;
+        else if (arg.starts_with("-"))
+        {
+            std::cerr << std::format("ivf_sceneconv: unknown option '{}'\n", arg);
+            return false;
+        }
+        else
+            settings.inputs.push_back(arg);
+    }
+
+    if (settings.inputs.empty())
+    {
+        printUsage();
+        return false;
+    }
+
+    return true;
+}
+
+std::string outputPath(const Settings &settings, const std::string &input, bool binary, bool single)
+{
+    auto name = fs::path(input).filename().replace_extension(binary ? ".json" : ".ivfscene");
+
+    if (settings.output.empty())
+        return (fs::path(input).parent_path() / name).string();
+
+    fs::path output(settings.output);
+
+    if (single && !fs::is_directory(output) && output.has_extension())
+        return output.string();
+
+    return (output / name).string();
+}
+
+bool convert(const Settings &settings, const std::string &input, bool single)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (!fs::is_regular_file(input))
+    {
+        std::cerr << std::format("ivf_sceneconv: cannot read {}\n", input);
+        return false;
+    }
+
+    bool binary = SceneSerializer::isBinary(input);
+    auto output = outputPath(settings, input, binary, single);
+
+    if (output == input)
+    {
+        std::cerr << std::format("ivf_sceneconv: {} would overwrite its input\n", input);
+        return false;
+    }
+
+    bool ok = binary ? SceneSerializer::convertToJson(input, output) : SceneSerializer::convertToBinary(input, output);
+
+    if (!ok)
+    {
+        std::cerr << std::format("ivf_sceneconv: cannot convert {}\n", input);
+        return false;
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!settings.quiet)
+        std::cout << std::format("{} -> {} ({} KiB -> {} KiB, {:.2f} s)\n", input, output, fs::file_size(input) / 1024,
+                                 fs::file_size(output) / 1024, seconds);
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+
+    if (!parseArguments(argc, argv, settings))
+        return 1;
+
+    bool single = settings.inputs.size() == 1;
+
+    if (!settings.output.empty() && !(single && fs::path(settings.output).has_extension()))
+    {
+        std::error_code error;
+        fs::create_directories(settings.output, error);
+    }
+
+    bool ok = true;
+
+    for (auto &input : settings.inputs)
+        ok = convert(settings, input, single) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file ivf_texconv.cpp
+ * @brief Converts PNG, JPG and HDR images to KTX2 textures with mipmaps and block compression.
+ *
+ * The KTX2 files are loaded by Texture::load(), Cubemap::load() and TextureCache without decoding
+ * or generating mipmaps at runtime, and compressed formats use 4-8 times less video memory.
+ *
+ * Usage:
+ * @code
+ * ivf_texconv assets/planks.png                      # assets/planks.ktx2, format chosen from the image
+ * ivf_texconv -f bc7 --srgb -o out a.png b.png       # out/a.ktx2 and out/b.ktx2
+ * ivf_texconv --normal assets/planks_normal.png      # renormalized mipmaps
+ * ivf_texconv --cubemap -o assets/skybox/cubemap.ktx2 right.jpg left.jpg top.jpg bottom.jpg front.jpg back.jpg
+ * ivf_texconv -c .texcache a.png b.png               # reuse earlier results for unchanged inputs
+ * @endcode
+ *
+ * With --cache, results are stored under a hash of the input files and the options, so repeated
+ * conversions of unchanged assets (e.g. from a build step) only copy the cached file.
+ */
+
+#include <ivf/texture_encoder.h>
+#include <ivf/texture_image.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace ivf;
+
+namespace {
+
+// Bump when the encoder output changes, so that cached files are not reused
+constexpr const char *encoderVersion = "ivf_texconv 1";
+
+struct Settings {
+    TextureEncoder::Options encoder;
+    bool flipY{false};
+    bool hdr{false};
+    bool cubemap{false};
+    bool quiet{false};
+    std::string output;
+    std::string cache;
+    std::vector<std::string> inputs;
+};
+
+void printUsage()
+{
+    std::cout << "Usage: ivf_texconv [options] <image>...\n"
+                 "\n"
+                 "Converts images to KTX2 textures with mipmaps and block compression.\n"
+                 "\n"
+                 "Options:\n"
+                 "  -o, --output <path>  Output directory, or output file for a single input or --cubemap\n"
+                 "                       (default: next to the input with a .ktx2 extension)\n"
+                 "  -c, --cache <dir>    Reuse results for unchanged inputs from a content-hash cache\n"
+                 "  -f, --format <name>  auto, bc1, bc3, bc4, bc5, bc7, rgba8 or rgba16f (default: auto)\n"
+                 "      --srgb           Colors are sRGB: filter mipmaps in linear space, store BC1/BC3/BC7 as sRGB\n"
+                 "      --normal         Normal map: renormalize the vectors of mipmap levels\n"
+                 "      --flip           Store the rows bottom up\n"
+                 "      --hdr            Decode as float (default for .hdr files)\n"
+                 "      --no-mips        Store only the base level\n"
+                 "      --cubemap        Six inputs (right, left, top, bottom, front, back) form one cubemap,\n"
+                 "                       written to cubemap.ktx2 next to the first input by default\n"
+                 "  -q, --quiet          Only print errors\n"
+                 "  -h, --help           Show this help\n";
+}
+
+bool parseArguments(int argc, char **argv, Settings &settings)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        auto value = [&](std::string &target) {
+            if (i + 1 >= argc)
+            {
+                std::cerr << std::format("ivf_texconv: {} needs a value\n", arg);
+                return false;
+            }
+            target = argv[++i];
+            return true;
+        };
+
+        if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            std::exit(0);
+        }
+        else if (arg == "-o" || arg == "--output")
+        {
+            if (!value(settings.output))
+                return false;
+        }
+        else if (arg == "-c" || arg == "--cache")
+        {
+            if (!value(settings.cache))
+                return false;
+        }
+        else if (arg == "-f" || arg == "--format")
+        {
+            std::string name;
+
+            if (!value(name))
+                return false;
+
+            if (!TextureEncoder::parseFormat(name, settings.encoder.format))
+            {
+                std::cerr << std::format("ivf_texconv: unknown format '{}'\n", name);
+                return false;
+            }
+        }
+        else if (arg == "--srgb")
+            settings.encoder.srgb = true;
+        else if (arg == "--normal")
+            settings.encoder.normalMap = true;
+        else if (arg == "--flip")
+            settings.flipY = true;
+        else if (arg == "--hdr")
+            settings.hdr = true;
+        else if (arg == "--no-mips")
+            settings.encoder.mipmaps = false;
+        else if (arg == "--cubemap")
+            settings.cubemap = true;
+        else if (arg == "-q" || arg == "--quiet")
+            settings.quiet = true;
+        else if (arg.starts_with("-"))
+        {
+            std::cerr << std::format("ivf_texconv: unknown option '{}'\n", arg);
+            return false;
+        }
+        else
+            settings.inputs.push_back(arg);
+    }
+
+    if (settings.inputs.empty())
+    {
+        printUsage();
+        return false;
+    }
+
+    if (settings.cubemap && settings.inputs.size() != 6)
+    {
+        std::cerr << "ivf_texconv: --cubemap needs six face images\n";
+        return false;
+    }
+
+    return true;
+}
+
+// 64 bit FNV-1a
+
+void hashBytes(std::uint64_t &hash, const void *data, size_t size)
+{
+    auto bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+bool hashFile(std::uint64_t &hash, const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    std::vector<char> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    std::uint64_t size = data.size();
+
+    hashBytes(hash, &size, sizeof(size));
+    hashBytes(hash, data.data(), data.size());
+    return true;
+}
+
+std::string outputPath(const Settings &settings, const std::string &input, bool single)
+{
+    fs::path name = settings.cubemap ? fs::path("cubemap.ktx2") : fs::path(input).stem().concat(".ktx2");
+
+    if (settings.output.empty())
+        return (fs::path(input).parent_path() / name).string();
+
+    fs::path output(settings.output);
+
+    if (single && output.extension() == ".ktx2")
+        return output.string();
+
+    return (output / name).string();
+}
+
+bool convert(const Settings &settings, const std::vector<std::string> &inputs, const std::string &output)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    TextureLoadOptions loadOptions;
+    loadOptions.flipY = settings.flipY;
+    loadOptions.hdr = settings.hdr || fs::path(inputs[0]).extension() == ".hdr";
+    loadOptions.mipmaps = false;
+
+    // Cached result, keyed by the inputs and everything affecting the output
+
+    std::string cached;
+
+    if (!settings.cache.empty())
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        auto key = std::format("{}|{}|{}{}{}{}{}{}", encoderVersion,
+                               TextureEncoder::formatName(settings.encoder.format), settings.encoder.srgb,
+                               settings.encoder.normalMap, settings.encoder.mipmaps, loadOptions.flipY,
+                               loadOptions.hdr, settings.cubemap);
+        hashBytes(hash, key.data(), key.size());
+
+        for (auto &input : inputs)
+        {
+            if (!hashFile(hash, input))
+            {
+                std::cerr << std::format("ivf_texconv: cannot read {}\n", input);
+                return false;
+            }
+        }
+
+        cached = (fs::path(settings.cache) / std::format("{:016x}.ktx2", hash)).string();
+
+        if (fs::exists(cached))
+        {
+            std::error_code error;
+            fs::copy_file(cached, output, fs::copy_options::overwrite_existing, error);
+
+            if (error)
+            {
+                std::cerr << std::format("ivf_texconv: cannot write {} ({})\n", output, error.message());
+                return false;
+            }
+
+            if (!settings.quiet)
+                std::cout << std::format("{} -> {} (cached)\n", inputs[0], output);
+
+            return true;
+        }
+    }
+
+    TextureImage image;
+
+    if (settings.cubemap)
+        image = TextureImage::loadCubemap({inputs[0], inputs[1], inputs[2], inputs[3], inputs[4], inputs[5]},
+                                          loadOptions);
+    else
+        image = TextureImage::load(inputs[0], loadOptions);
+
+    if (!image.valid())
+    {
+        std::cerr << std::format("ivf_texconv: {}\n", image.error);
+        return false;
+    }
+
+    auto format = TextureEncoder::chooseFormat(image, settings.encoder);
+    auto options = settings.encoder;
+    options.format = format;
+
+    auto encoded = TextureEncoder::encode(image, options);
+
+    if (!encoded.valid())
+    {
+        std::cerr << std::format("ivf_texconv: {}: {}\n", inputs[0], encoded.error);
+        return false;
+    }
+
+    // Written to the cache first and renamed, so that an interrupted run leaves no partial file
+
+    if (!cached.empty())
+    {
+        std::error_code error;
+        fs::create_directories(settings.cache, error);
+
+        auto temporary = cached + ".tmp";
+
+        if (!encoded.saveKtx2(temporary))
+            return false;
+
+        fs::rename(temporary, cached, error);
+
+        if (!error)
+            fs::copy_file(cached, output, fs::copy_options::overwrite_existing, error);
+
+        if (error)
+        {
+            std::cerr << std::format("ivf_texconv: cannot write {} ({})\n", output, error.message());
+            return false;
+        }
+    }
+    else if (!encoded.saveKtx2(output))
+        return false;
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!settings.quiet)
+        std::cout << std::format("{} -> {} ({}, {}x{}, {} levels, {} KiB, {:.2f} s)\n", inputs[0], output,
+                                 TextureEncoder::formatName(format), encoded.width, encoded.height, encoded.levels,
+                                 encoded.pixels.size() / 1024, seconds);
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+
+    if (!parseArguments(argc, argv, settings))
+        return 1;
+
+    if (!settings.output.empty() && fs::path(settings.output).extension() != ".ktx2")
+    {
+        std::error_code error;
+        fs::create_directories(settings.output, error);
+    }
+
+    bool ok = true;
+
+    if (settings.cubemap)
+        ok = convert(settings, settings.inputs, outputPath(settings, settings.inputs[0], true));
+    else
+    {
+        bool single = settings.inputs.size() == 1;
+
+        for (auto &input : settings.inputs)
+            ok = convert(settings, {input}, outputPath(settings, input, single)) && ok;
+    }
+
+    return ok ? 0 : 1;
+}